@@ -33,7 +33,10 @@
 #define __tracktable_AssembleTrajectories_h
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/MemoryResource.h>
 #include <tracktable/Core/Timestamp.h>
+#include <tracktable/Analysis/ReorderBuffer.h>
+#include <tracktable/Analysis/StreamingSimplification.h>
 #include <tracktable/Analysis/detail/AssembleTrajectoriesIterator.h>
 
 namespace tracktable {
@@ -68,6 +71,11 @@ namespace tracktable {
  * We can also set a third parameter (minimum_trajectory_length) that
  * silently rejects trajectories that do not contain enough points to
  * be interesting.
+ *
+ * If the input is only roughly sorted (for example, when several
+ * receivers' feeds are merged), set a maximum lateness.  Points are
+ * then passed through a ReorderBuffer that puts them back in time
+ * order before assembly, and points later than that are dropped.
  */
 
 
@@ -115,6 +123,15 @@ public:
       this->SeparationTime = other.SeparationTime;
       this->PointBegin = other.PointBegin;
       this->PointEnd = other.PointEnd;
+      this->MinimumTrajectoryLength = other.MinimumTrajectoryLength;
+      this->CleanupInterval = other.CleanupInterval;
+      this->SimplificationTolerance = other.SimplificationTolerance;
+      this->SimplificationMetricUsed = other.SimplificationMetricUsed;
+      this->SimplificationWindow = other.SimplificationWindow;
+      this->Resource = other.Resource;
+      this->HoistConstantProperties = other.HoistConstantProperties;
+      this->MaximumLateness = other.MaximumLateness;
+      this->ReorderBufferSize = other.ReorderBufferSize;
     }
 
   /// Destructor
@@ -131,6 +148,15 @@ public:
       this->SeparationTime = other.SeparationTime;
       this->PointBegin = other.PointBegin;
       this->PointEnd = other.PointEnd;
+      this->MinimumTrajectoryLength = other.MinimumTrajectoryLength;
+      this->CleanupInterval = other.CleanupInterval;
+      this->SimplificationTolerance = other.SimplificationTolerance;
+      this->SimplificationMetricUsed = other.SimplificationMetricUsed;
+      this->SimplificationWindow = other.SimplificationWindow;
+      this->Resource = other.Resource;
+      this->HoistConstantProperties = other.HoistConstantProperties;
+      this->MaximumLateness = other.MaximumLateness;
+      this->ReorderBufferSize = other.ReorderBufferSize;
       return *this;
     }
 
@@ -146,7 +172,13 @@ public:
       return (this->SeparationDistance == other.SeparationDistance &&
               this->SeparationTime == other.SeparationTime &&
               this->PointBegin == other.PointBegin &&
-              this->PointEnd == other.PointEnd);
+              this->PointEnd == other.PointEnd &&
+              this->SimplificationTolerance == other.SimplificationTolerance &&
+              this->SimplificationMetricUsed == other.SimplificationMetricUsed &&
+              this->SimplificationWindow == other.SimplificationWindow &&
+              this->HoistConstantProperties == other.HoistConstantProperties &&
+              this->MaximumLateness == other.MaximumLateness &&
+              this->ReorderBufferSize == other.ReorderBufferSize);
     }
 
   /** Check whether two AssembleTrajectories are unequal.
@@ -172,7 +204,11 @@ public:
                       boost::numeric_cast<int>(this->MinimumTrajectoryLength),
                       this->SeparationDistance,
                       this->SeparationTime,
-                      this->CleanupInterval);
+                      this->CleanupInterval,
+                      this->simplifier(),
+                      this->Resource,
+                      this->HoistConstantProperties,
+                      this->reorder_buffer());
     }
 
  /** Return an iterator to detect when parsing has ended.
@@ -189,7 +225,11 @@ public:
                       boost::numeric_cast<int>(this->MinimumTrajectoryLength),
                       this->SeparationDistance,
                       this->SeparationTime,
-                      this->CleanupInterval);
+                      this->CleanupInterval,
+                      this->simplifier(),
+                      this->Resource,
+                      this->HoistConstantProperties,
+                      this->reorder_buffer());
     }
 
   /** Set the start and end points of the trajectory
@@ -269,6 +309,151 @@ public:
       return this->CleanupInterval;
     }
 
+  /** Simplify trajectories while they are being assembled
+   *
+   * Points are passed through a StreamingSimplifier as they are
+   * added, so trajectories come out already simplified and the
+   * trajectories in progress never hold more than the simplifier's
+   * window of unneeded points.  A tolerance of 0 (the default) turns
+   * simplification off.
+   *
+   * @param [in] tolerance  Largest error allowed for a dropped point
+   */
+  void set_simplification_tolerance(double tolerance)
+    {
+      this->SimplificationTolerance = tolerance;
+    }
+
+  /** Set how simplification measures error
+   *
+   * @param [in] metric Error measure for simplification
+   */
+  void set_simplification_metric(SimplificationMetric metric)
+    {
+      this->SimplificationMetricUsed = metric;
+    }
+
+  /** Set the largest number of points held since the last kept point
+   *
+   * @param [in] window Window size for simplification
+   */
+  void set_simplification_window(std::size_t window)
+    {
+      this->SimplificationWindow = window;
+    }
+
+  /**
+   * @return Tolerance for simplification during assembly (0 if off)
+   */
+  double simplification_tolerance() const
+    {
+      return this->SimplificationTolerance;
+    }
+
+  /**
+   * @return Error measure for simplification during assembly
+   */
+  SimplificationMetric simplification_metric() const
+    {
+      return this->SimplificationMetricUsed;
+    }
+
+  /**
+   * @return Window size for simplification during assembly
+   */
+  std::size_t simplification_window() const
+    {
+      return this->SimplificationWindow;
+    }
+
+  /** Build trajectories in a particular memory resource
+   *
+   * Trajectories under construction, and the copies handed out by
+   * the iterator, draw their points and property maps from
+   * `resource`.  Use an arena when you will process a batch of
+   * trajectories and then throw them all away.  The resource must
+   * outlive every iterator and every trajectory taken from them.
+   *
+   * @param [in] resource Resource to use, or nullptr for the calling thread's current resource
+   */
+  void set_memory_resource(tracktable::memory_resource* resource)
+    {
+      this->Resource = resource;
+    }
+
+  /**
+   * @return Memory resource for assembled trajectories (nullptr if none was set)
+   */
+  tracktable::memory_resource* memory_resource() const
+    {
+      return this->Resource;
+    }
+
+  /** Share point properties that are the same on every point
+   *
+   * When this is on, each finished trajectory keeps one copy of the
+   * point properties that never change along it.  See
+   * Trajectory::hoist_constant_properties().
+   *
+   * @param [in] onoff Hoisting on / off
+   */
+  void set_hoist_constant_properties(bool onoff)
+    {
+      this->HoistConstantProperties = onoff;
+    }
+
+  /**
+   * @return Whether constant point properties are hoisted
+   */
+  bool hoist_constant_properties() const
+    {
+      return this->HoistConstantProperties;
+    }
+
+  /** Accept input points that arrive up to this late
+   *
+   * Points are held in a ReorderBuffer until nothing earlier can
+   * still arrive, then assembled in time order.  Points that arrive
+   * later than this are dropped; the iterator's
+   * `late_point_count()` and `dropped_point_count()` report how many
+   * points were reordered and dropped.  A lateness of 0 (the default)
+   * assumes the input is already sorted.
+   *
+   * @param [in] lateness Longest a point can be delayed and still be used
+   */
+  void set_maximum_lateness(Duration const& lateness)
+    {
+      this->MaximumLateness = lateness;
+    }
+
+  /**
+   * @return Longest a point can be delayed and still be used
+   */
+  Duration maximum_lateness() const
+    {
+      return this->MaximumLateness;
+    }
+
+  /** Cap the number of points held for reordering
+   *
+   * When the buffer is full the oldest point is assembled early.  See
+   * ReorderBuffer.
+   *
+   * @param [in] num_points Largest number of points to hold; 0 for no limit
+   */
+  void set_reorder_buffer_size(std::size_t num_points)
+    {
+      this->ReorderBufferSize = num_points;
+    }
+
+  /**
+   * @return Largest number of points held for reordering (0 if unlimited)
+   */
+  std::size_t reorder_buffer_size() const
+    {
+      return this->ReorderBufferSize;
+    }
+
 protected:
   /** Set the default values for a trajectory
    *
@@ -278,6 +463,13 @@ protected:
    *    - SeparationTime = Duration(minutes(30))
    *    - MinimumTrajectoryLength = 2
    *    - CleanupInterval = 10000
+   *    - SimplificationTolerance = 0 (no simplification)
+   *    - SimplificationMetric = synchronized Euclidean distance
+   *    - SimplificationWindow = 64
+   *    - No memory resource (use the calling thread's current one)
+   *    - HoistConstantProperties = false
+   *    - MaximumLateness = 0 (input is already sorted)
+   *    - ReorderBufferSize = 0 (no limit)
    */
   virtual void set_default_configuration()
     {
@@ -285,6 +477,26 @@ protected:
       this->SeparationTime = Duration(minutes(30));
       this->MinimumTrajectoryLength = 2;
       this->CleanupInterval = 10000;
+      this->SimplificationTolerance = 0;
+      this->SimplificationMetricUsed = SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE;
+      this->SimplificationWindow = 64;
+      this->Resource = nullptr;
+      this->HoistConstantProperties = false;
+      this->MaximumLateness = seconds(0);
+      this->ReorderBufferSize = 0;
+    }
+
+  StreamingSimplifier<trajectory_type> simplifier() const
+    {
+      return StreamingSimplifier<trajectory_type>(this->SimplificationTolerance,
+                                                  this->SimplificationMetricUsed,
+                                                  this->SimplificationWindow);
+    }
+
+  ReorderBuffer<point_type> reorder_buffer() const
+    {
+      return ReorderBuffer<point_type>(this->MaximumLateness,
+                                       this->ReorderBufferSize);
     }
 
 private:
@@ -294,6 +506,13 @@ private:
   double SeparationDistance;
   std::size_t MinimumTrajectoryLength;
   int CleanupInterval;
+  double SimplificationTolerance;
+  SimplificationMetric SimplificationMetricUsed;
+  std::size_t SimplificationWindow;
+  tracktable::memory_resource* Resource;
+  bool HoistConstantProperties;
+  Duration MaximumLateness;
+  std::size_t ReorderBufferSize;
 };
 
 } // close namespace tracktable
@@ -0,0 +1,668 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/BatchGeomath.h - Distance, bearing, speed and
+ * turn angle over whole arrays of points
+ *
+ * tracktable::distance(), bearing(), speed_between() and
+ * signed_turn_angle() each look at one or two points and go through
+ * the domain's algorithm traits every time.  The functions here
+ * compute the same quantities for arrays of raw coordinates: the
+ * domain is picked once, at compile time, and the inner loops are
+ * plain arithmetic over contiguous doubles with no branches so that
+ * the compiler can vectorize them.
+ *
+ * Points are stored row-major.  Point i of a D-dimensional array
+ * occupies coordinates[i*D] through coordinates[i*D + D - 1]; for
+ * terrestrial points that is (longitude, latitude) in degrees.
+ * Timestamps are seconds measured from any common origin.
+ *
+ * Units match the scalar algorithms:
+ *
+ *   terrestrial: distances in km, speeds in km/hr, bearings and turn
+ *                angles in degrees
+ *   cartesian2d: distances in units, speeds in units/sec, bearings
+ *                and turn angles in radians
+ *   cartesian3d: distances in units, speeds in units/sec (bearings
+ *                and turn angles are not defined)
+ *
+ * ecef_coordinates() converts whole terrestrial trajectories (or
+ * collections of them) to Earth-centered, Earth-fixed coordinates in
+ * the same way.
+ */
+
+#ifndef __tracktable_BatchGeomath_h
+#define __tracktable_BatchGeomath_h
+
+#include <tracktable/Core/Conversions.h>
+#include <tracktable/Core/FloatingPointComparison.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Core/Timestamp.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Cartesian3D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <boost/mpl/assert.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace tracktable { namespace batch {
+
+/** Array kernels for one point domain.
+ *
+ * Specializations provide `dimension`, `has_bearing` and the static
+ * functions distances(), segment_lengths(), segment_speeds() and,
+ * where `has_bearing` is true, bearings(), segment_bearings() and
+ * signed_turn_angles().  Use the free functions below rather than
+ * calling these directly.
+ */
+
+template<typename DomainT>
+struct geomath_kernels
+{
+  BOOST_MPL_ASSERT_MSG(
+    sizeof(DomainT)==0,
+    BATCH_GEOMATH_NOT_DEFINED_FOR_THIS_DOMAIN,
+    (types<DomainT>)
+    );
+};
+
+// ----------------------------------------------------------------------
+
+/// Turn per-segment lengths into speeds.  Segments that take (almost)
+/// no time have speed 0, as in speed_between().
+inline void lengths_to_speeds(std::size_t num_segments,
+                              double const* timestamps,
+                              double scale,
+                              double min_duration,
+                              double* lengths)
+{
+  for (std::size_t i = 0; i < num_segments; ++i)
+    {
+    double duration = timestamps[i+1] - timestamps[i];
+    double safe_duration = (std::abs(duration) < min_duration) ? 1.0 : duration;
+    double speed = scale * lengths[i] / safe_duration;
+    lengths[i] = (std::abs(duration) < min_duration) ? 0.0 : speed;
+    }
+}
+
+// ----------------------------------------------------------------------
+
+template<>
+struct geomath_kernels<traits::domains::terrestrial>
+{
+  static const std::size_t dimension = 2;
+  static const bool has_bearing = true;
+
+  /// Great-circle (haversine) distance in km between from[i] and to[i]
+  static void distances(std::size_t num_points,
+                        double const* from, double const* to,
+                        double* result)
+    {
+      using conversions::constants::RADIANS_PER_DEGREE;
+      using conversions::constants::EARTH_RADIUS_IN_KM;
+
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        double lat1 = RADIANS_PER_DEGREE * from[2*i+1];
+        double lat2 = RADIANS_PER_DEGREE * to[2*i+1];
+        double half_dlat = 0.5 * (lat2 - lat1);
+        double half_dlon = 0.5 * RADIANS_PER_DEGREE * (to[2*i] - from[2*i]);
+        double sin_dlat = std::sin(half_dlat);
+        double sin_dlon = std::sin(half_dlon);
+        double a = sin_dlat * sin_dlat + std::cos(lat1) * std::cos(lat2) * sin_dlon * sin_dlon;
+        result[i] = 2.0 * EARTH_RADIUS_IN_KM * std::asin(std::sqrt(std::min(a, 1.0)));
+        }
+    }
+
+  /// Initial bearing in degrees in [0, 360) from from[i] to to[i]
+  static void bearings(std::size_t num_points,
+                       double const* from, double const* to,
+                       double* result)
+    {
+      using conversions::constants::RADIANS_PER_DEGREE;
+
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        double lat1 = RADIANS_PER_DEGREE * from[2*i+1];
+        double lat2 = RADIANS_PER_DEGREE * to[2*i+1];
+        double dlon = RADIANS_PER_DEGREE * (to[2*i] - from[2*i]);
+        result[i] = bearing_from_terms(std::sin(dlon), std::cos(dlon),
+                                       std::sin(lat1), std::cos(lat1),
+                                       std::sin(lat2), std::cos(lat2));
+        }
+    }
+
+  /// Distance in km from point i to point i+1 of a path
+  static void segment_lengths(std::size_t num_points, double const* points, double* result)
+    {
+      using conversions::constants::RADIANS_PER_DEGREE;
+      using conversions::constants::EARTH_RADIUS_IN_KM;
+
+      if (num_points < 2) return;
+
+      // Every interior point belongs to two segments; take its cosine
+      // once instead of twice.
+      std::vector<double> cos_lat(num_points);
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        cos_lat[i] = std::cos(RADIANS_PER_DEGREE * points[2*i+1]);
+        }
+
+      for (std::size_t i = 0; i + 1 < num_points; ++i)
+        {
+        double half_dlat = 0.5 * RADIANS_PER_DEGREE * (points[2*i+3] - points[2*i+1]);
+        double half_dlon = 0.5 * RADIANS_PER_DEGREE * (points[2*i+2] - points[2*i]);
+        double sin_dlat = std::sin(half_dlat);
+        double sin_dlon = std::sin(half_dlon);
+        double a = sin_dlat * sin_dlat + cos_lat[i] * cos_lat[i+1] * sin_dlon * sin_dlon;
+        result[i] = 2.0 * EARTH_RADIUS_IN_KM * std::asin(std::sqrt(std::min(a, 1.0)));
+        }
+    }
+
+  /// Bearing in degrees from point i to point i+1 of a path
+  static void segment_bearings(std::size_t num_points, double const* points, double* result)
+    {
+      using conversions::constants::RADIANS_PER_DEGREE;
+
+      if (num_points < 2) return;
+
+      std::vector<double> sin_lat(num_points), cos_lat(num_points);
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        double lat = RADIANS_PER_DEGREE * points[2*i+1];
+        sin_lat[i] = std::sin(lat);
+        cos_lat[i] = std::cos(lat);
+        }
+
+      for (std::size_t i = 0; i + 1 < num_points; ++i)
+        {
+        double dlon = RADIANS_PER_DEGREE * (points[2*i+2] - points[2*i]);
+        result[i] = bearing_from_terms(std::sin(dlon), std::cos(dlon),
+                                       sin_lat[i], cos_lat[i],
+                                       sin_lat[i+1], cos_lat[i+1]);
+        }
+    }
+
+  /// Speed in km/hr from point i to point i+1 of a path
+  static void segment_speeds(std::size_t num_points, double const* points,
+                             double const* timestamps, double* result)
+    {
+      if (num_points < 2) return;
+      segment_lengths(num_points, points, result);
+      lengths_to_speeds(num_points - 1, timestamps,
+                        conversions::constants::SECONDS_PER_HOUR,
+                        settings::ZERO_ABSOLUTE_TOLERANCE, result);
+    }
+
+  /// Signed turn in degrees in [-180, 180] at point i+1 of a path.
+  /// Positive turns are clockwise (to the right).
+  static void signed_turn_angles(std::size_t num_points, double const* points, double* result)
+    {
+      if (num_points < 3) return;
+
+      std::vector<double> headings(num_points - 1);
+      segment_bearings(num_points, points, headings.data());
+      for (std::size_t i = 0; i + 2 < num_points; ++i)
+        {
+        double turn = headings[i+1] - headings[i];
+        turn -= (turn > 180.0) ? 360.0 : 0.0;
+        turn += (turn < -180.0) ? 360.0 : 0.0;
+        result[i] = turn;
+        }
+    }
+
+private:
+  static inline double bearing_from_terms(double sin_dlon, double cos_dlon,
+                                          double sin_lat1, double cos_lat1,
+                                          double sin_lat2, double cos_lat2)
+    {
+      double bearing = std::atan2(sin_dlon * cos_lat2,
+                                  cos_lat1 * sin_lat2 - sin_lat1 * cos_lat2 * cos_dlon);
+      return std::fmod(conversions::degrees(bearing) + 360.0, 360.0);
+    }
+};
+
+// ----------------------------------------------------------------------
+
+template<>
+struct geomath_kernels<traits::domains::cartesian2d>
+{
+  static const std::size_t dimension = 2;
+  static const bool has_bearing = true;
+
+  static void distances(std::size_t num_points,
+                        double const* from, double const* to,
+                        double* result)
+    {
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        double dx = to[2*i] - from[2*i];
+        double dy = to[2*i+1] - from[2*i+1];
+        result[i] = std::sqrt(dx * dx + dy * dy);
+        }
+    }
+
+  /// Direction in radians of the vector from from[i] to to[i]
+  static void bearings(std::size_t num_points,
+                       double const* from, double const* to,
+                       double* result)
+    {
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        result[i] = std::atan2(to[2*i+1] - from[2*i+1], to[2*i] - from[2*i]);
+        }
+    }
+
+  static void segment_lengths(std::size_t num_points, double const* points, double* result)
+    {
+      if (num_points < 2) return;
+      distances(num_points - 1, points, points + 2, result);
+    }
+
+  static void segment_bearings(std::size_t num_points, double const* points, double* result)
+    {
+      if (num_points < 2) return;
+      bearings(num_points - 1, points, points + 2, result);
+    }
+
+  /// Speed in units/sec from point i to point i+1 of a path
+  static void segment_speeds(std::size_t num_points, double const* points,
+                             double const* timestamps, double* result)
+    {
+      if (num_points < 2) return;
+      segment_lengths(num_points, points, result);
+      lengths_to_speeds(num_points - 1, timestamps, 1.0, 0.001, result);
+    }
+
+  /// Signed angle in radians in [-pi, pi] between segment i and
+  /// segment i+1 of a path.  Positive turns are counterclockwise.
+  static void signed_turn_angles(std::size_t num_points, double const* points, double* result)
+    {
+      for (std::size_t i = 0; i + 2 < num_points; ++i)
+        {
+        double ax = points[2*i+2] - points[2*i];
+        double ay = points[2*i+3] - points[2*i+1];
+        double bx = points[2*i+4] - points[2*i+2];
+        double by = points[2*i+5] - points[2*i+3];
+        result[i] = std::atan2(ax * by - ay * bx, ax * bx + ay * by);
+        }
+    }
+};
+
+// ----------------------------------------------------------------------
+
+template<>
+struct geomath_kernels<traits::domains::cartesian3d>
+{
+  static const std::size_t dimension = 3;
+  static const bool has_bearing = false;
+
+  static void distances(std::size_t num_points,
+                        double const* from, double const* to,
+                        double* result)
+    {
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        double dx = to[3*i] - from[3*i];
+        double dy = to[3*i+1] - from[3*i+1];
+        double dz = to[3*i+2] - from[3*i+2];
+        result[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+
+  static void segment_lengths(std::size_t num_points, double const* points, double* result)
+    {
+      if (num_points < 2) return;
+      distances(num_points - 1, points, points + 3, result);
+    }
+
+  static void segment_speeds(std::size_t num_points, double const* points,
+                             double const* timestamps, double* result)
+    {
+      if (num_points < 2) return;
+      segment_lengths(num_points, points, result);
+      lengths_to_speeds(num_points - 1, timestamps, 1.0, 0.001, result);
+    }
+};
+
+// ----------------------------------------------------------------------
+
+/** Distance between corresponding points of two arrays.
+ *
+ * @param [in] num_points Number of points in each array
+ * @param [in] from       First array of points
+ * @param [in] to         Second array of points
+ * @param [out] result    num_points distances
+ */
+
+template<typename DomainT>
+void distances(std::size_t num_points, double const* from, double const* to, double* result)
+{
+  geomath_kernels<DomainT>::distances(num_points, from, to, result);
+}
+
+/** Bearing from each point in one array to the corresponding point in another.
+ *
+ * @param [in] num_points Number of points in each array
+ * @param [in] from       Origins
+ * @param [in] to         Destinations
+ * @param [out] result    num_points bearings
+ */
+
+template<typename DomainT>
+void bearings(std::size_t num_points, double const* from, double const* to, double* result)
+{
+  geomath_kernels<DomainT>::bearings(num_points, from, to, result);
+}
+
+/** Length of every segment of a path.
+ *
+ * @param [in] num_points Number of points in the path
+ * @param [in] points     Points in path order
+ * @param [out] result    num_points - 1 lengths
+ */
+
+template<typename DomainT>
+void segment_lengths(std::size_t num_points, double const* points, double* result)
+{
+  geomath_kernels<DomainT>::segment_lengths(num_points, points, result);
+}
+
+/** Bearing along every segment of a path.
+ *
+ * @param [in] num_points Number of points in the path
+ * @param [in] points     Points in path order
+ * @param [out] result    num_points - 1 bearings
+ */
+
+template<typename DomainT>
+void segment_bearings(std::size_t num_points, double const* points, double* result)
+{
+  geomath_kernels<DomainT>::segment_bearings(num_points, points, result);
+}
+
+/** Speed along every segment of a path.
+ *
+ * @param [in] num_points Number of points in the path
+ * @param [in] points     Points in path order
+ * @param [in] timestamps One time in seconds for each point
+ * @param [out] result    num_points - 1 speeds
+ */
+
+template<typename DomainT>
+void segment_speeds(std::size_t num_points, double const* points,
+                    double const* timestamps, double* result)
+{
+  geomath_kernels<DomainT>::segment_speeds(num_points, points, timestamps, result);
+}
+
+/** Signed turn angle at every interior point of a path.
+ *
+ * @param [in] num_points Number of points in the path
+ * @param [in] points     Points in path order
+ * @param [out] result    num_points - 2 turn angles
+ */
+
+template<typename DomainT>
+void signed_turn_angles(std::size_t num_points, double const* points, double* result)
+{
+  geomath_kernels<DomainT>::signed_turn_angles(num_points, points, result);
+}
+
+// ----------------------------------------------------------------------
+
+/** Copy the coordinates of a sequence of points into a row-major array.
+ *
+ * @param [in] begin   First point
+ * @param [in] end     Past the last point
+ * @param [out] result Coordinates, dimension values per point
+ */
+
+template<typename PointIteratorT>
+void flatten_coordinates(PointIteratorT begin, PointIteratorT end, std::vector<double>& result)
+{
+  typedef typename std::iterator_traits<PointIteratorT>::value_type point_type;
+  const std::size_t dimension = traits::dimension<point_type>::value;
+
+  result.clear();
+  for (; begin != end; ++begin)
+    {
+    for (std::size_t d = 0; d < dimension; ++d)
+      {
+      result.push_back((*begin)[d]);
+      }
+    }
+}
+
+/** Seconds from the first point of a sequence to each of its points.
+ *
+ * @param [in] begin   First point
+ * @param [in] end     Past the last point
+ * @param [out] result One time per point
+ */
+
+template<typename PointIteratorT>
+void relative_timestamps(PointIteratorT begin, PointIteratorT end, std::vector<double>& result)
+{
+  result.clear();
+  if (begin == end) return;
+
+  Timestamp origin = begin->timestamp();
+  for (; begin != end; ++begin)
+    {
+    result.push_back(static_cast<double>((begin->timestamp() - origin).total_microseconds()) / 1e6);
+    }
+}
+
+/** Length of every segment of a trajectory in its domain's units. */
+template<typename TrajectoryT>
+void segment_lengths(TrajectoryT const& path, std::vector<double>& result)
+{
+  typedef typename traits::domain<typename TrajectoryT::point_type>::type domain_type;
+  std::vector<double> coordinates;
+  flatten_coordinates(path.begin(), path.end(), coordinates);
+  result.assign(path.size() < 2 ? 0 : path.size() - 1, 0.0);
+  segment_lengths<domain_type>(path.size(), coordinates.data(), result.data());
+}
+
+/** Bearing along every segment of a trajectory. */
+template<typename TrajectoryT>
+void segment_bearings(TrajectoryT const& path, std::vector<double>& result)
+{
+  typedef typename traits::domain<typename TrajectoryT::point_type>::type domain_type;
+  std::vector<double> coordinates;
+  flatten_coordinates(path.begin(), path.end(), coordinates);
+  result.assign(path.size() < 2 ? 0 : path.size() - 1, 0.0);
+  segment_bearings<domain_type>(path.size(), coordinates.data(), result.data());
+}
+
+/** Speed along every segment of a trajectory using its point timestamps. */
+template<typename TrajectoryT>
+void segment_speeds(TrajectoryT const& path, std::vector<double>& result)
+{
+  typedef typename traits::domain<typename TrajectoryT::point_type>::type domain_type;
+  std::vector<double> coordinates, timestamps;
+  flatten_coordinates(path.begin(), path.end(), coordinates);
+  relative_timestamps(path.begin(), path.end(), timestamps);
+  result.assign(path.size() < 2 ? 0 : path.size() - 1, 0.0);
+  segment_speeds<domain_type>(path.size(), coordinates.data(), timestamps.data(), result.data());
+}
+
+/** Signed turn angle at every interior point of a trajectory. */
+template<typename TrajectoryT>
+void signed_turn_angles(TrajectoryT const& path, std::vector<double>& result)
+{
+  typedef typename traits::domain<typename TrajectoryT::point_type>::type domain_type;
+  std::vector<double> coordinates;
+  flatten_coordinates(path.begin(), path.end(), coordinates);
+  result.assign(path.size() < 3 ? 0 : path.size() - 2, 0.0);
+  signed_turn_angles<domain_type>(path.size(), coordinates.data(), result.data());
+}
+
+// ----------------------------------------------------------------------
+
+/** ECEF coordinates for arrays of terrestrial positions.
+ *
+ * This is the same conversion as TerrestrialPoint::ECEF_from_km()
+ * (WGS84 ellipsoid, results in km) applied to every point at once.
+ *
+ * @param [in] num_points   Number of points
+ * @param [in] lonlat       (longitude, latitude) in degrees for each point
+ * @param [in] altitudes_km Altitude in km for each point
+ * @param [out] result      (x, y, z) in km for each point
+ */
+
+inline void ecef_from_lonlat(std::size_t num_points,
+                             double const* lonlat,
+                             double const* altitudes_km,
+                             double* result)
+{
+  using conversions::constants::RADIANS_PER_DEGREE;
+  const double a = 6378.137;
+  const double e2 = 8.1819190842622e-2 * 8.1819190842622e-2;
+
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    double longitude = RADIANS_PER_DEGREE * lonlat[2*i];
+    double latitude = RADIANS_PER_DEGREE * lonlat[2*i+1];
+    double sin_latitude = std::sin(latitude);
+    double n = a / std::sqrt(1.0 - e2 * sin_latitude * sin_latitude);
+    double nac = (n + altitudes_km[i]) * std::cos(latitude);
+    result[3*i] = nac * std::cos(longitude);
+    result[3*i+1] = nac * std::sin(longitude);
+    result[3*i+2] = (n * (1.0 - e2) + altitudes_km[i]) * sin_latitude;
+    }
+}
+
+/// Multiplier that turns an altitude in the given units into km
+inline double kilometers_per_altitude_unit(domain::terrestrial::AltitudeUnits unit)
+{
+  switch (unit)
+    {
+    case domain::terrestrial::AltitudeUnits::METERS:
+      return 1.0 / 1000.0;
+    case domain::terrestrial::AltitudeUnits::FEET:
+      return 1.0 / 3280.839895013123;
+    case domain::terrestrial::AltitudeUnits::KILOMETERS:
+    default:
+      return 1.0;
+    }
+}
+
+/** ECEF coordinates for every point of a terrestrial trajectory.
+ *
+ * The altitude property is looked up with the same name for every
+ * point; an empty name means altitude 0 everywhere.
+ *
+ * @param [in] path              Trajectory to convert
+ * @param [in] altitude_property Name of the altitude property, or ""
+ * @param [in] unit              Units of the altitude property
+ * @param [out] result           3 * path.size() values, (x, y, z) in km per point
+ *
+ * @throw domain::terrestrial::PropertyDoesNotExist if a point has no altitude
+ */
+
+inline void ecef_coordinates(domain::terrestrial::trajectory_type const& path,
+                             std::string const& altitude_property,
+                             domain::terrestrial::AltitudeUnits unit,
+                             double* result)
+{
+  const double km_per_unit = kilometers_per_altitude_unit(unit);
+  std::vector<double> lonlat(2 * path.size());
+  std::vector<double> altitudes(path.size(), 0.0);
+
+  for (std::size_t i = 0; i < path.size(); ++i)
+    {
+    lonlat[2*i] = path[i].longitude();
+    lonlat[2*i+1] = path[i].latitude();
+    if (!altitude_property.empty())
+      {
+      bool ok = false;
+      altitudes[i] = km_per_unit * path[i].real_property(altitude_property, &ok);
+      if (!ok)
+        {
+        throw domain::terrestrial::PropertyDoesNotExist(altitude_property);
+        }
+      }
+    }
+  ecef_from_lonlat(path.size(), lonlat.data(), altitudes.data(), result);
+}
+
+/** ECEF coordinates for every point of many terrestrial trajectories.
+ *
+ * The points of all trajectories go into one contiguous array in
+ * order.  trajectory_index[i] says which trajectory point i came
+ * from.  Trajectories are converted in parallel.
+ *
+ * @param [in] paths             Trajectories to convert
+ * @param [in] altitude_property Name of the altitude property, or ""
+ * @param [in] unit              Units of the altitude property
+ * @param [out] coordinates      (x, y, z) in km for each point
+ * @param [out] trajectory_index Position in paths of each point's trajectory
+ * @param [in] num_threads       Number of threads; 0 means default_thread_count()
+ *
+ * @throw domain::terrestrial::PropertyDoesNotExist if a point has no altitude
+ */
+
+inline void ecef_coordinates(std::vector<domain::terrestrial::trajectory_type const*> const& paths,
+                             std::string const& altitude_property,
+                             domain::terrestrial::AltitudeUnits unit,
+                             std::vector<double>& coordinates,
+                             std::vector<std::size_t>& trajectory_index,
+                             std::size_t num_threads=0)
+{
+  std::vector<std::size_t> offsets(paths.size() + 1, 0);
+  for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+    offsets[i+1] = offsets[i] + paths[i]->size();
+    }
+
+  coordinates.assign(3 * offsets.back(), 0.0);
+  trajectory_index.resize(offsets.back());
+
+  parallel_for(
+    0, paths.size(),
+    [&](std::size_t i)
+    {
+      std::fill(trajectory_index.begin() + offsets[i], trajectory_index.begin() + offsets[i+1], i);
+      ecef_coordinates(*paths[i], altitude_property, unit, coordinates.data() + 3 * offsets[i]);
+    },
+    num_threads, 1);
+}
+
+} } // namespace tracktable::batch
+
+#endif
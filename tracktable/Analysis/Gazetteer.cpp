@@ -0,0 +1,698 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/Gazetteer.h>
+#include <tracktable/Core/Conversions.h>
+#include <tracktable/Core/ParallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+
+namespace tracktable {
+
+namespace {
+
+// Places per leaf.  Small enough that scanning a leaf is cheaper
+// than descending further, large enough to keep the node array
+// small next to the entries.
+const std::uint32_t LEAF_SIZE = 16;
+
+const char CACHE_MAGIC[8] = { 'T', 'T', 'G', 'A', 'Z', 'E', 'T', '1' };
+const std::uint32_t CACHE_BYTE_ORDER = 0x01020304;
+
+using conversions::constants::EARTH_RADIUS_IN_KM;
+using conversions::constants::RADIANS_PER_DEGREE;
+
+void unit_vector(double longitude, double latitude, double* position)
+{
+  double lon = longitude * RADIANS_PER_DEGREE;
+  double lat = latitude * RADIANS_PER_DEGREE;
+  double cos_lat = std::cos(lat);
+  position[0] = cos_lat * std::cos(lon);
+  position[1] = cos_lat * std::sin(lon);
+  position[2] = std::sin(lat);
+}
+
+double chord_squared(double const* a, double const* b)
+{
+  double dx = a[0] - b[0];
+  double dy = a[1] - b[1];
+  double dz = a[2] - b[2];
+  return dx*dx + dy*dy + dz*dz;
+}
+
+double chord_squared_to_km(double chord_sq)
+{
+  double half_chord = 0.5 * std::sqrt(chord_sq);
+  return 2 * EARTH_RADIUS_IN_KM * std::asin(std::min(1.0, half_chord));
+}
+
+// Largest squared chord that is still within a distance.  Anything
+// at or beyond half the circumference is everything.
+double km_to_chord_squared(double km)
+{
+  if (!(km < EARTH_RADIUS_IN_KM * conversions::constants::PI))
+    {
+    return std::numeric_limits<double>::infinity();
+    }
+  if (km < 0)
+    {
+    return -1;
+    }
+  double chord = 2 * std::sin(0.5 * km / EARTH_RADIUS_IN_KM);
+  // A hair of slack so that points exactly on the boundary survive
+  // the round trip through sin and asin.
+  return chord * chord * (1 + 1e-12);
+}
+
+template<typename NodeT>
+double box_chord_squared(NodeT const& node, double const* position)
+{
+  double total = 0;
+  for (int d = 0; d < 3; ++d)
+    {
+    double gap = 0;
+    if (position[d] < node.Min[d])
+      {
+      gap = node.Min[d] - position[d];
+      }
+    else if (position[d] > node.Max[d])
+      {
+      gap = position[d] - node.Max[d];
+      }
+    total += gap * gap;
+    }
+  return total;
+}
+
+bool match_less(Gazetteer::match_type const& a, Gazetteer::match_type const& b)
+{
+  return (a.second < b.second) || (a.second == b.second && a.first < b.first);
+}
+
+// Split an inclusive longitude range into at most two ranges that do
+// not cross the antimeridian.  Returns the number of ranges.
+std::size_t longitude_ranges(double min_longitude, double max_longitude, double* ranges)
+{
+  if (min_longitude <= max_longitude)
+    {
+    ranges[0] = min_longitude;
+    ranges[1] = max_longitude;
+    return 1;
+    }
+  ranges[0] = min_longitude;
+  ranges[1] = 180;
+  ranges[2] = -180;
+  ranges[3] = max_longitude;
+  return 2;
+}
+
+bool in_longitude_ranges(double longitude, double const* ranges, std::size_t num_ranges)
+{
+  for (std::size_t i = 0; i < num_ranges; ++i)
+    {
+    if (longitude >= ranges[2*i] && longitude <= ranges[2*i+1])
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+template<typename T>
+void write_raw(std::ostream& out, T const& value)
+{
+  out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template<typename T>
+bool read_raw(std::istream& in, T& value)
+{
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------
+
+// Candidates are kept in a max-heap on squared chord so that the
+// worst of the k best is always on top.
+struct Gazetteer::NearestSearch
+{
+  typedef std::pair<double, id_type> candidate_type;
+
+  double Position[3];
+  std::size_t K;
+  double MaxChordSquared;
+  std::priority_queue<candidate_type> Best;
+
+  double bound() const
+    {
+      if (this->Best.size() < this->K)
+        {
+        return this->MaxChordSquared;
+        }
+      return this->Best.top().first;
+    }
+
+  void offer(double chord_sq, id_type id)
+    {
+      if (chord_sq > this->MaxChordSquared)
+        {
+        return;
+        }
+      candidate_type candidate(chord_sq, id);
+      if (this->Best.size() < this->K)
+        {
+        this->Best.push(candidate);
+        }
+      else if (candidate < this->Best.top())
+        {
+        this->Best.pop();
+        this->Best.push(candidate);
+        }
+    }
+};
+
+// ----------------------------------------------------------------------
+
+Gazetteer::Gazetteer()
+  : NumThreads(0)
+{
+  static_assert(std::is_trivially_copyable<Entry>::value, "Gazetteer entries must be trivially copyable");
+  static_assert(std::is_trivially_copyable<Node>::value, "Gazetteer nodes must be trivially copyable");
+}
+
+void Gazetteer::build(std::size_t num_places,
+                      double const* longitudes,
+                      double const* latitudes,
+                      id_type const* ids)
+{
+  if (num_places >= std::numeric_limits<std::uint32_t>::max())
+    {
+    throw std::length_error("Gazetteer cannot hold more than 2^32 - 1 places");
+    }
+
+  this->clear();
+  this->Entries.resize(num_places);
+  for (std::size_t i = 0; i < num_places; ++i)
+    {
+    Entry& entry = this->Entries[i];
+    entry.Longitude = longitudes[i];
+    entry.Latitude = latitudes[i];
+    entry.Id = (ids ? ids[i] : static_cast<id_type>(i));
+    unit_vector(entry.Longitude, entry.Latitude, entry.Position);
+    }
+
+  if (num_places > 0)
+    {
+    this->Nodes.reserve(2 * (num_places / LEAF_SIZE + 1));
+    this->build_node(0, static_cast<std::uint32_t>(num_places));
+    }
+}
+
+void Gazetteer::build(std::vector<double> const& longitudes,
+                      std::vector<double> const& latitudes,
+                      std::vector<id_type> const& ids)
+{
+  if (latitudes.size() != longitudes.size()
+      || (!ids.empty() && ids.size() != longitudes.size()))
+    {
+    throw std::invalid_argument("Gazetteer: longitudes, latitudes and IDs must have the same length");
+    }
+  this->build(longitudes.size(), longitudes.data(), latitudes.data(),
+              ids.empty() ? nullptr : ids.data());
+}
+
+std::uint32_t Gazetteer::build_node(std::uint32_t begin, std::uint32_t end)
+{
+  std::uint32_t index = static_cast<std::uint32_t>(this->Nodes.size());
+  this->Nodes.push_back(Node());
+  Node node;
+  std::memset(&node, 0, sizeof(Node));
+  node.Begin = begin;
+  node.End = end;
+
+  for (int d = 0; d < 3; ++d)
+    {
+    node.Min[d] = std::numeric_limits<double>::infinity();
+    node.Max[d] = -std::numeric_limits<double>::infinity();
+    }
+  node.MinLongitude = node.MinLatitude = std::numeric_limits<double>::infinity();
+  node.MaxLongitude = node.MaxLatitude = -std::numeric_limits<double>::infinity();
+
+  for (std::uint32_t i = begin; i < end; ++i)
+    {
+    Entry const& entry = this->Entries[i];
+    for (int d = 0; d < 3; ++d)
+      {
+      node.Min[d] = std::min(node.Min[d], entry.Position[d]);
+      node.Max[d] = std::max(node.Max[d], entry.Position[d]);
+      }
+    node.MinLongitude = std::min(node.MinLongitude, entry.Longitude);
+    node.MaxLongitude = std::max(node.MaxLongitude, entry.Longitude);
+    node.MinLatitude = std::min(node.MinLatitude, entry.Latitude);
+    node.MaxLatitude = std::max(node.MaxLatitude, entry.Latitude);
+    }
+
+  if (end - begin > LEAF_SIZE)
+    {
+    int axis = 0;
+    for (int d = 1; d < 3; ++d)
+      {
+      if (node.Max[d] - node.Min[d] > node.Max[axis] - node.Min[axis])
+        {
+        axis = d;
+        }
+      }
+
+    std::uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(this->Entries.begin() + begin,
+                     this->Entries.begin() + middle,
+                     this->Entries.begin() + end,
+                     [axis](Entry const& a, Entry const& b) {
+                       return a.Position[axis] < b.Position[axis];
+                     });
+
+    this->build_node(begin, middle);
+    node.Right = this->build_node(middle, end);
+    }
+
+  this->Nodes[index] = node;
+  return index;
+}
+
+std::size_t Gazetteer::size() const
+{
+  return this->Entries.size();
+}
+
+bool Gazetteer::empty() const
+{
+  return this->Entries.empty();
+}
+
+void Gazetteer::clear()
+{
+  this->Entries.clear();
+  this->Nodes.clear();
+}
+
+void Gazetteer::set_num_threads(std::size_t num_threads)
+{
+  this->NumThreads = num_threads;
+}
+
+std::size_t Gazetteer::num_threads() const
+{
+  return this->NumThreads;
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<Gazetteer::match_type>
+Gazetteer::find_nearest(double longitude, double latitude, std::size_t k, double max_distance) const
+{
+  std::vector<match_type> result;
+  if (k == 0 || this->empty())
+    {
+    return result;
+    }
+
+  NearestSearch search;
+  unit_vector(longitude, latitude, search.Position);
+  search.K = k;
+  search.MaxChordSquared = km_to_chord_squared(max_distance);
+  if (search.MaxChordSquared < 0)
+    {
+    return result;
+    }
+  this->search_nearest(0, search);
+
+  result.reserve(search.Best.size());
+  while (!search.Best.empty())
+    {
+    result.push_back(match_type(search.Best.top().second, chord_squared_to_km(search.Best.top().first)));
+    search.Best.pop();
+    }
+  std::reverse(result.begin(), result.end());
+  return result;
+}
+
+void Gazetteer::search_nearest(std::uint32_t index, NearestSearch& search) const
+{
+  Node const& node = this->Nodes[index];
+  if (node.Right == 0)
+    {
+    for (std::uint32_t i = node.Begin; i < node.End; ++i)
+      {
+      Entry const& entry = this->Entries[i];
+      search.offer(chord_squared(entry.Position, search.Position), entry.Id);
+      }
+    return;
+    }
+
+  std::uint32_t near_child = index + 1;
+  std::uint32_t far_child = node.Right;
+  double near_distance = box_chord_squared(this->Nodes[near_child], search.Position);
+  double far_distance = box_chord_squared(this->Nodes[far_child], search.Position);
+  if (far_distance < near_distance)
+    {
+    std::swap(near_child, far_child);
+    std::swap(near_distance, far_distance);
+    }
+
+  if (near_distance <= search.bound())
+    {
+    this->search_nearest(near_child, search);
+    }
+  if (far_distance <= search.bound())
+    {
+    this->search_nearest(far_child, search);
+    }
+}
+
+std::vector<Gazetteer::match_type>
+Gazetteer::find_within_radius(double longitude, double latitude, double radius) const
+{
+  std::vector<match_type> result;
+  double max_chord_squared = km_to_chord_squared(radius);
+  if (this->empty() || max_chord_squared < 0)
+    {
+    return result;
+    }
+
+  double position[3];
+  unit_vector(longitude, latitude, position);
+  this->search_radius(0, position, max_chord_squared, result);
+  std::sort(result.begin(), result.end(), match_less);
+  return result;
+}
+
+void Gazetteer::search_radius(std::uint32_t index, double const* position, double max_chord_squared,
+                              std::vector<match_type>& matches) const
+{
+  Node const& node = this->Nodes[index];
+  if (box_chord_squared(node, position) > max_chord_squared)
+    {
+    return;
+    }
+  if (node.Right != 0)
+    {
+    this->search_radius(index + 1, position, max_chord_squared, matches);
+    this->search_radius(node.Right, position, max_chord_squared, matches);
+    return;
+    }
+  for (std::uint32_t i = node.Begin; i < node.End; ++i)
+    {
+    Entry const& entry = this->Entries[i];
+    double chord_sq = chord_squared(entry.Position, position);
+    if (chord_sq <= max_chord_squared)
+      {
+      matches.push_back(match_type(entry.Id, chord_squared_to_km(chord_sq)));
+      }
+    }
+}
+
+std::vector<Gazetteer::id_type>
+Gazetteer::find_within_box(double min_longitude, double min_latitude,
+                           double max_longitude, double max_latitude) const
+{
+  std::vector<id_type> result;
+  if (this->empty() || min_latitude > max_latitude)
+    {
+    return result;
+    }
+  double ranges[4];
+  std::size_t num_ranges = longitude_ranges(min_longitude, max_longitude, ranges);
+  this->search_box(0, ranges, num_ranges, min_latitude, max_latitude, result);
+  return result;
+}
+
+void Gazetteer::search_box(std::uint32_t index, double const* lon_ranges, std::size_t num_lon_ranges,
+                           double min_latitude, double max_latitude,
+                           std::vector<id_type>& ids) const
+{
+  Node const& node = this->Nodes[index];
+  if (node.MaxLatitude < min_latitude || node.MinLatitude > max_latitude)
+    {
+    return;
+    }
+
+  bool overlaps = false;
+  bool contained = false;
+  for (std::size_t i = 0; i < num_lon_ranges; ++i)
+    {
+    double low = lon_ranges[2*i];
+    double high = lon_ranges[2*i+1];
+    if (node.MaxLongitude >= low && node.MinLongitude <= high)
+      {
+      overlaps = true;
+      contained = contained || (node.MinLongitude >= low && node.MaxLongitude <= high);
+      }
+    }
+  if (!overlaps)
+    {
+    return;
+    }
+
+  if (contained && node.MinLatitude >= min_latitude && node.MaxLatitude <= max_latitude)
+    {
+    for (std::uint32_t i = node.Begin; i < node.End; ++i)
+      {
+      ids.push_back(this->Entries[i].Id);
+      }
+    return;
+    }
+
+  if (node.Right != 0)
+    {
+    this->search_box(index + 1, lon_ranges, num_lon_ranges, min_latitude, max_latitude, ids);
+    this->search_box(node.Right, lon_ranges, num_lon_ranges, min_latitude, max_latitude, ids);
+    return;
+    }
+
+  for (std::uint32_t i = node.Begin; i < node.End; ++i)
+    {
+    Entry const& entry = this->Entries[i];
+    if (entry.Latitude >= min_latitude && entry.Latitude <= max_latitude
+        && in_longitude_ranges(entry.Longitude, lon_ranges, num_lon_ranges))
+      {
+      ids.push_back(entry.Id);
+      }
+    }
+}
+
+// ----------------------------------------------------------------------
+
+void Gazetteer::find_nearest(std::size_t num_queries,
+                             double const* longitudes,
+                             double const* latitudes,
+                             std::size_t k,
+                             id_type* ids,
+                             double* distances,
+                             double max_distance) const
+{
+  parallel_for(0, num_queries,
+               [&](std::size_t query) {
+                 std::vector<match_type> matches(
+                   this->find_nearest(longitudes[query], latitudes[query], k, max_distance)
+                   );
+                 for (std::size_t i = 0; i < k; ++i)
+                   {
+                   bool found = (i < matches.size());
+                   ids[query * k + i] = (found ? matches[i].first : -1);
+                   distances[query * k + i] = (found ? matches[i].second : std::numeric_limits<double>::infinity());
+                   }
+               },
+               this->NumThreads, 64);
+}
+
+namespace {
+
+// Concatenate per-query results into compressed rows
+template<typename T>
+void flatten_rows(std::vector<std::vector<T> >& rows,
+                  std::vector<std::size_t>& offsets,
+                  std::vector<T>& values)
+{
+  offsets.assign(1, 0);
+  offsets.reserve(rows.size() + 1);
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+    total += rows[i].size();
+    offsets.push_back(total);
+    }
+  values.clear();
+  values.reserve(total);
+  for (std::size_t i = 0; i < rows.size(); ++i)
+    {
+    values.insert(values.end(), rows[i].begin(), rows[i].end());
+    std::vector<T>().swap(rows[i]);
+    }
+}
+
+} // anonymous namespace
+
+void Gazetteer::find_within_radius(std::size_t num_queries,
+                                   double const* longitudes,
+                                   double const* latitudes,
+                                   double radius,
+                                   std::vector<std::size_t>& offsets,
+                                   std::vector<match_type>& matches) const
+{
+  std::vector<std::vector<match_type> > rows(num_queries);
+  parallel_for(0, num_queries,
+               [&](std::size_t query) {
+                 rows[query] = this->find_within_radius(longitudes[query], latitudes[query], radius);
+               },
+               this->NumThreads, 64);
+  flatten_rows(rows, offsets, matches);
+}
+
+void Gazetteer::find_within_box(std::size_t num_boxes,
+                                double const* boxes,
+                                std::vector<std::size_t>& offsets,
+                                std::vector<id_type>& ids) const
+{
+  std::vector<std::vector<id_type> > rows(num_boxes);
+  parallel_for(0, num_boxes,
+               [&](std::size_t box) {
+                 double const* corners = boxes + 4 * box;
+                 rows[box] = this->find_within_box(corners[0], corners[1], corners[2], corners[3]);
+               },
+               this->NumThreads, 16);
+  flatten_rows(rows, offsets, ids);
+}
+
+// ----------------------------------------------------------------------
+
+bool Gazetteer::save(std::string const& filename, std::string const& source_key) const
+{
+  std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!out)
+    {
+    return false;
+    }
+
+  out.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+  write_raw(out, CACHE_BYTE_ORDER);
+  write_raw(out, static_cast<std::uint64_t>(source_key.size()));
+  out.write(source_key.data(), static_cast<std::streamsize>(source_key.size()));
+  write_raw(out, static_cast<std::uint64_t>(this->Entries.size()));
+  write_raw(out, static_cast<std::uint64_t>(this->Nodes.size()));
+  out.write(reinterpret_cast<char const*>(this->Entries.data()),
+            static_cast<std::streamsize>(this->Entries.size() * sizeof(Entry)));
+  out.write(reinterpret_cast<char const*>(this->Nodes.data()),
+            static_cast<std::streamsize>(this->Nodes.size() * sizeof(Node)));
+  out.close();
+  return static_cast<bool>(out);
+}
+
+bool Gazetteer::load(std::string const& filename, std::string const& source_key)
+{
+  this->clear();
+
+  std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!in)
+    {
+    return false;
+    }
+
+  char magic[sizeof(CACHE_MAGIC)];
+  std::uint32_t byte_order = 0;
+  std::uint64_t key_size = 0;
+  if (!in.read(magic, sizeof(magic))
+      || std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0
+      || !read_raw(in, byte_order) || byte_order != CACHE_BYTE_ORDER
+      || !read_raw(in, key_size) || key_size != source_key.size())
+    {
+    return false;
+    }
+
+  std::string key(source_key.size(), '\0');
+  std::uint64_t num_entries = 0;
+  std::uint64_t num_nodes = 0;
+  if (!in.read(&key[0], static_cast<std::streamsize>(key.size()))
+      || key != source_key
+      || !read_raw(in, num_entries) || !read_raw(in, num_nodes)
+      || num_entries >= std::numeric_limits<std::uint32_t>::max()
+      || (num_entries == 0) != (num_nodes == 0)
+      || num_nodes > 2 * num_entries)
+    {
+    return false;
+    }
+
+  // The counts must describe exactly what is left in the file before
+  // we allocate anything for them
+  std::streampos data_begin = in.tellg();
+  in.seekg(0, std::ios::end);
+  std::streampos data_end = in.tellg();
+  in.seekg(data_begin);
+  if (data_begin < 0 || data_end < data_begin
+      || static_cast<std::uint64_t>(data_end - data_begin)
+           != num_entries * sizeof(Entry) + num_nodes * sizeof(Node))
+    {
+    return false;
+    }
+
+  this->Entries.resize(static_cast<std::size_t>(num_entries));
+  this->Nodes.resize(static_cast<std::size_t>(num_nodes));
+  in.read(reinterpret_cast<char*>(this->Entries.data()),
+          static_cast<std::streamsize>(this->Entries.size() * sizeof(Entry)));
+  in.read(reinterpret_cast<char*>(this->Nodes.data()),
+          static_cast<std::streamsize>(this->Nodes.size() * sizeof(Node)));
+  if (!in || in.peek() != std::char_traits<char>::eof())
+    {
+    this->clear();
+    return false;
+    }
+
+  // Make sure the tree cannot send a query out of bounds
+  for (std::size_t i = 0; i < this->Nodes.size(); ++i)
+    {
+    Node const& node = this->Nodes[i];
+    if (node.Begin > node.End || node.End > num_entries
+        || (node.Right != 0 && (node.Right <= i + 1 || node.Right >= num_nodes || i + 1 >= num_nodes)))
+      {
+      this->clear();
+      return false;
+      }
+    }
+
+  return true;
+}
+
+} // namespace tracktable
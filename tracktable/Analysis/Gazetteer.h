@@ -0,0 +1,274 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/Gazetteer.h - Spatial index over named places
+ * (airports, ports, cities) on the globe
+ *
+ * The lookups in tracktable.info used to scan every record in Python
+ * for each query.  A Gazetteer holds only the positions of the places
+ * and an integer ID for each one, packed into a static k-d tree over
+ * points on the unit sphere.  It answers nearest-neighbor,
+ * great-circle radius and longitude/latitude box queries, one at a
+ * time or in parallel batches, and it can be written to and read
+ * from a binary cache file so that large tables are only indexed
+ * once.
+ */
+
+#ifndef __tracktable_Gazetteer_h
+#define __tracktable_Gazetteer_h
+
+#include <tracktable/Analysis/TracktableAnalysisWindowsHeader.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+/**
+ * @class Gazetteer
+ * @brief Static spatial index over places on the Earth
+ *
+ * Each place is a (longitude, latitude) position in degrees plus an
+ * ID chosen by the caller, usually the row number of the place in
+ * its source table.  Distances are great-circle distances in
+ * kilometers on a sphere with the same radius that the terrestrial
+ * domain uses, so they agree with tracktable::distance().
+ *
+ * Points are stored as unit vectors.  Chord length increases with
+ * great-circle distance, so the k-d tree can prune with ordinary
+ * box distances and the results are exact.
+ *
+ * The index is immutable once built.  All query methods are const
+ * and safe to call from several threads at once.
+ *
+ * @code
+ * tracktable::Gazetteer airports;
+ * airports.build(longitudes, latitudes, row_numbers);
+ *
+ * std::vector<tracktable::Gazetteer::match_type> closest(
+ *   airports.find_nearest(-106.6, 35.0, 3)
+ *   );
+ * @endcode
+ */
+class TRACKTABLE_ANALYSIS_EXPORT Gazetteer
+{
+public:
+  typedef std::int64_t id_type;
+
+  /// (place ID, distance in km)
+  typedef std::pair<id_type, double> match_type;
+
+  Gazetteer();
+
+  /** Index a set of places
+   *
+   * Any previous contents are discarded.
+   *
+   * @param [in] num_places  Number of places
+   * @param [in] longitudes  Longitude of each place in degrees
+   * @param [in] latitudes   Latitude of each place in degrees
+   * @param [in] ids         ID of each place; if null, places are
+   *                         numbered from 0 in input order
+   */
+  void build(std::size_t num_places,
+             double const* longitudes,
+             double const* latitudes,
+             id_type const* ids=nullptr);
+
+  void build(std::vector<double> const& longitudes,
+             std::vector<double> const& latitudes,
+             std::vector<id_type> const& ids=std::vector<id_type>());
+
+  /// Number of places in the index
+  std::size_t size() const;
+
+  bool empty() const;
+
+  void clear();
+
+  /// Number of threads for batch queries; 0 means default_thread_count()
+  void set_num_threads(std::size_t num_threads);
+
+  std::size_t num_threads() const;
+
+  // ---------------------------------------------------------------
+  // Single queries
+
+  /** Find the places closest to a position
+   *
+   * @param [in] longitude     Query longitude in degrees
+   * @param [in] latitude      Query latitude in degrees
+   * @param [in] k             Number of places to return
+   * @param [in] max_distance  Ignore places farther than this (km)
+   * @return Up to k matches sorted by increasing distance
+   */
+  std::vector<match_type> find_nearest(
+    double longitude, double latitude, std::size_t k,
+    double max_distance=std::numeric_limits<double>::infinity()
+    ) const;
+
+  /** Find every place within a great-circle distance of a position
+   *
+   * @return Matches sorted by increasing distance
+   */
+  std::vector<match_type> find_within_radius(
+    double longitude, double latitude, double radius
+    ) const;
+
+  /** Find every place inside a longitude/latitude box
+   *
+   * The box includes its boundary.  If min_longitude is greater than
+   * max_longitude the box is taken to cross the antimeridian.
+   *
+   * @return IDs in no particular order
+   */
+  std::vector<id_type> find_within_box(
+    double min_longitude, double min_latitude,
+    double max_longitude, double max_latitude
+    ) const;
+
+  // ---------------------------------------------------------------
+  // Batch queries
+  //
+  // These run the single queries above for many positions in
+  // parallel.  Results that vary in length come back in compressed
+  // rows: the results for query i are in positions
+  // [offsets[i], offsets[i+1]) of the output.
+
+  /** Find the k nearest places to each of many positions
+   *
+   * Queries with fewer than k places in range have their unused
+   * slots filled with ID -1 and distance infinity.
+   *
+   * @param [in]  num_queries   Number of positions
+   * @param [in]  longitudes    Query longitudes
+   * @param [in]  latitudes     Query latitudes
+   * @param [in]  k             Places per query
+   * @param [out] ids           num_queries * k IDs, row by row
+   * @param [out] distances     num_queries * k distances, row by row
+   * @param [in]  max_distance  Ignore places farther than this (km)
+   */
+  void find_nearest(std::size_t num_queries,
+                    double const* longitudes,
+                    double const* latitudes,
+                    std::size_t k,
+                    id_type* ids,
+                    double* distances,
+                    double max_distance=std::numeric_limits<double>::infinity()) const;
+
+  void find_within_radius(std::size_t num_queries,
+                          double const* longitudes,
+                          double const* latitudes,
+                          double radius,
+                          std::vector<std::size_t>& offsets,
+                          std::vector<match_type>& matches) const;
+
+  /** Find the places inside each of many boxes
+   *
+   * @param [in]  num_boxes  Number of boxes
+   * @param [in]  boxes      4 values per box: min longitude, min
+   *                         latitude, max longitude, max latitude
+   * @param [out] offsets    num_boxes + 1 row offsets
+   * @param [out] ids        IDs found, box by box
+   */
+  void find_within_box(std::size_t num_boxes,
+                       double const* boxes,
+                       std::vector<std::size_t>& offsets,
+                       std::vector<id_type>& ids) const;
+
+  // ---------------------------------------------------------------
+  // Caching
+
+  /** Write the index to a binary file
+   *
+   * @param [in] filename    File to write
+   * @param [in] source_key  Anything that identifies the data the
+   *                         index was built from, such as a file
+   *                         name with its size and modification time
+   * @return True on success
+   */
+  bool save(std::string const& filename, std::string const& source_key) const;
+
+  /** Read an index written by save()
+   *
+   * The index is left empty and false is returned if the file is
+   * missing, damaged, written on a machine with a different byte
+   * order, or was built from data with a different source key.
+   */
+  bool load(std::string const& filename, std::string const& source_key);
+
+private:
+  struct Entry
+  {
+    double Position[3];
+    double Longitude;
+    double Latitude;
+    id_type Id;
+  };
+
+  // Nodes are stored in depth-first order.  An interior node's left
+  // child immediately follows it; Right is the index of its right
+  // child.  Leaves have Right == 0.
+  struct Node
+  {
+    double Min[3];
+    double Max[3];
+    double MinLongitude;
+    double MaxLongitude;
+    double MinLatitude;
+    double MaxLatitude;
+    std::uint32_t Begin;
+    std::uint32_t End;
+    std::uint32_t Right;
+    std::uint32_t Padding;
+  };
+
+  struct NearestSearch;
+
+  std::uint32_t build_node(std::uint32_t begin, std::uint32_t end);
+  void search_nearest(std::uint32_t node, NearestSearch& search) const;
+  void search_radius(std::uint32_t node, double const* position, double max_chord_squared,
+                     std::vector<match_type>& matches) const;
+  void search_box(std::uint32_t node, double const* lon_ranges, std::size_t num_lon_ranges,
+                  double min_latitude, double max_latitude,
+                  std::vector<id_type>& ids) const;
+
+  std::vector<Entry> Entries;
+  std::vector<Node> Nodes;
+  std::size_t NumThreads;
+};
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,582 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/Geofence.h>
+#include <tracktable/Core/ParallelFor.h>
+
+#include <boost/geometry/geometry.hpp>
+#include <tracktable/Analysis/GuardedBoostGeometryRTreeHeader.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace tracktable {
+
+namespace {
+
+const std::size_t NUM_SHARDS = 64;
+
+typedef boost::geometry::model::point<double, 2, boost::geometry::cs::cartesian> index_point_type;
+typedef boost::geometry::model::box<index_point_type> index_box_type;
+typedef std::pair<index_box_type, std::int64_t> index_value_type;
+
+index_box_type ring_box(std::vector<double> const& ring)
+{
+  double min_x = ring[0], max_x = ring[0];
+  double min_y = ring[1], max_y = ring[1];
+  for (std::size_t i = 2; i + 1 < ring.size(); i += 2)
+    {
+    min_x = std::min(min_x, ring[i]);
+    max_x = std::max(max_x, ring[i]);
+    min_y = std::min(min_y, ring[i+1]);
+    max_y = std::max(max_y, ring[i+1]);
+    }
+  return index_box_type(index_point_type(min_x, min_y), index_point_type(max_x, max_y));
+}
+
+std::vector<double> box_ring(double min_x, double min_y, double max_x, double max_y)
+{
+  std::vector<double> ring;
+  ring.push_back(min_x); ring.push_back(min_y);
+  ring.push_back(max_x); ring.push_back(min_y);
+  ring.push_back(max_x); ring.push_back(max_y);
+  ring.push_back(min_x); ring.push_back(max_y);
+  return ring;
+}
+
+// Even-odd rule over all the rings
+bool point_in_rings(std::vector<std::vector<double> > const& rings, double x, double y)
+{
+  bool inside = false;
+  for (std::size_t r = 0; r < rings.size(); ++r)
+    {
+    std::vector<double> const& ring = rings[r];
+    std::size_t n = ring.size() / 2;
+    for (std::size_t i = 0, j = n - 1; i < n; j = i++)
+      {
+      double xi = ring[2*i], yi = ring[2*i+1];
+      double xj = ring[2*j], yj = ring[2*j+1];
+      if (((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi) + xi))
+        {
+        inside = !inside;
+        }
+      }
+    }
+  return inside;
+}
+
+// Fractions along (x0, y0) - (x1, y1) where it crosses the rings'
+// edges.  Crossings at the very start of the segment belong to the
+// previous segment.  Each edge includes its first vertex but not its
+// last so that passing through a vertex counts once.  Edges that lie
+// on the antimeridian only exist because a region that straddles it
+// was cut in two, so they are not boundaries.
+void ring_crossings(std::vector<std::vector<double> > const& rings,
+                    double x0, double y0, double x1, double y1,
+                    std::vector<double>& fractions)
+{
+  double rx = x1 - x0, ry = y1 - y0;
+  for (std::size_t r = 0; r < rings.size(); ++r)
+    {
+    std::vector<double> const& ring = rings[r];
+    std::size_t n = ring.size() / 2;
+    for (std::size_t i = 0; i < n; ++i)
+      {
+      std::size_t j = (i + 1) % n;
+      double ex = ring[2*i], ey = ring[2*i+1];
+      double sx = ring[2*j] - ex, sy = ring[2*j+1] - ey;
+      if (sx == 0 && std::fabs(ex) == 180)
+        {
+        continue;
+        }
+      double denominator = rx * sy - ry * sx;
+      if (denominator == 0)
+        {
+        continue;
+        }
+      double qx = ex - x0, qy = ey - y0;
+      double t = (qx * sy - qy * sx) / denominator;
+      double u = (qx * ry - qy * rx) / denominator;
+      if (t > 0 && t <= 1 && u >= 0 && u < 1)
+        {
+        fractions.push_back(t);
+        }
+      }
+    }
+}
+
+Timestamp interpolate_time(Timestamp const& start, Timestamp const& finish, double fraction)
+{
+  double span = static_cast<double>((finish - start).total_microseconds());
+  return start + boost::posix_time::microseconds(static_cast<std::int64_t>(std::llround(fraction * span)));
+}
+
+double fraction_at_time(Timestamp const& start, Timestamp const& finish, Timestamp const& when)
+{
+  double span = static_cast<double>((finish - start).total_microseconds());
+  if (span <= 0)
+    {
+    return 1;
+    }
+  return static_cast<double>((when - start).total_microseconds()) / span;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------
+
+class GeofenceMonitor::RegionIndex
+{
+public:
+  boost::geometry::index::rtree<index_value_type, boost::geometry::index::quadratic<16> > Tree;
+};
+
+GeofenceMonitor::GeofenceMonitor()
+  : Index(new RegionIndex)
+  , NextSerial(1)
+  , Shards(NUM_SHARDS)
+  , DwellTime(boost::posix_time::seconds(0))
+  , NumThreads(0)
+{
+}
+
+GeofenceMonitor::~GeofenceMonitor()
+{
+}
+
+void GeofenceMonitor::add_box(region_id_type region,
+                              double min_longitude, double min_latitude,
+                              double max_longitude, double max_latitude)
+{
+  Region new_region;
+  new_region.Id = region;
+  if (min_longitude <= max_longitude)
+    {
+    new_region.Rings.push_back(box_ring(min_longitude, min_latitude, max_longitude, max_latitude));
+    }
+  else
+    {
+    // Two disjoint pieces on either side of the antimeridian
+    new_region.Rings.push_back(box_ring(min_longitude, min_latitude, 180, max_latitude));
+    new_region.Rings.push_back(box_ring(-180, min_latitude, max_longitude, max_latitude));
+    }
+  this->remove_region(region);
+  new_region.Serial = this->NextSerial++;
+  this->insert_region(this->Regions.emplace(region, std::move(new_region)).first->second);
+}
+
+void GeofenceMonitor::add_polygon(region_id_type region, std::vector<std::vector<double> > const& rings)
+{
+  Region new_region;
+  new_region.Id = region;
+  for (std::size_t i = 0; i < rings.size(); ++i)
+    {
+    std::vector<double> ring(rings[i]);
+    if (ring.size() % 2 != 0)
+      {
+      throw std::invalid_argument("GeofenceMonitor: rings must hold longitude, latitude pairs");
+      }
+    std::size_t n = ring.size();
+    if (n >= 4 && ring[0] == ring[n-2] && ring[1] == ring[n-1])
+      {
+      ring.resize(n - 2);
+      }
+    if (ring.size() >= 6)
+      {
+      new_region.Rings.push_back(ring);
+      }
+    }
+  if (new_region.Rings.empty())
+    {
+    throw std::invalid_argument("GeofenceMonitor: a polygon needs at least one ring with 3 vertices");
+    }
+  this->remove_region(region);
+  new_region.Serial = this->NextSerial++;
+  this->insert_region(this->Regions.emplace(region, std::move(new_region)).first->second);
+}
+
+void GeofenceMonitor::insert_region(Region const& region)
+{
+  for (std::size_t i = 0; i < region.Rings.size(); ++i)
+    {
+    this->Index->Tree.insert(index_value_type(ring_box(region.Rings[i]), region.Id));
+    }
+}
+
+bool GeofenceMonitor::remove_region(region_id_type region)
+{
+  std::unordered_map<region_id_type, Region>::iterator here = this->Regions.find(region);
+  if (here == this->Regions.end())
+    {
+    return false;
+    }
+  for (std::size_t i = 0; i < here->second.Rings.size(); ++i)
+    {
+    this->Index->Tree.remove(index_value_type(ring_box(here->second.Rings[i]), region));
+    }
+  this->Regions.erase(here);
+  return true;
+}
+
+bool GeofenceMonitor::has_region(region_id_type region) const
+{
+  return this->Regions.find(region) != this->Regions.end();
+}
+
+std::size_t GeofenceMonitor::num_regions() const
+{
+  return this->Regions.size();
+}
+
+void GeofenceMonitor::clear_regions()
+{
+  this->Index->Tree.clear();
+  this->Regions.clear();
+}
+
+void GeofenceMonitor::regions_near(double min_x, double min_y, double max_x, double max_y,
+                                   std::vector<Region const*>& regions) const
+{
+  std::vector<index_value_type> hits;
+  index_box_type query(index_point_type(min_x, min_y), index_point_type(max_x, max_y));
+  this->Index->Tree.query(boost::geometry::index::intersects(query), std::back_inserter(hits));
+  for (std::size_t i = 0; i < hits.size(); ++i)
+    {
+    regions.push_back(&this->Regions.find(hits[i].second)->second);
+    }
+}
+
+// ----------------------------------------------------------------------
+
+void GeofenceMonitor::set_dwell_time(Duration const& dwell_time)
+{
+  this->DwellTime = dwell_time;
+}
+
+Duration GeofenceMonitor::dwell_time() const
+{
+  return this->DwellTime;
+}
+
+void GeofenceMonitor::set_num_threads(std::size_t num_threads)
+{
+  this->NumThreads = num_threads;
+}
+
+std::size_t GeofenceMonitor::num_threads() const
+{
+  return this->NumThreads;
+}
+
+std::size_t GeofenceMonitor::shard_index(std::string const& object_id) const
+{
+  return std::hash<std::string>()(object_id) % this->Shards.size();
+}
+
+std::size_t GeofenceMonitor::num_objects() const
+{
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < this->Shards.size(); ++i)
+    {
+    count += this->Shards[i].Objects.size();
+    }
+  return count;
+}
+
+void GeofenceMonitor::remove_object(std::string const& object_id)
+{
+  this->Shards[this->shard_index(object_id)].Objects.erase(object_id);
+}
+
+void GeofenceMonitor::clear_objects()
+{
+  for (std::size_t i = 0; i < this->Shards.size(); ++i)
+    {
+    this->Shards[i].Objects.clear();
+    }
+}
+
+std::vector<GeofenceMonitor::region_id_type>
+GeofenceMonitor::regions_containing(std::string const& object_id) const
+{
+  std::vector<region_id_type> result;
+  Shard const& shard = this->Shards[this->shard_index(object_id)];
+  std::unordered_map<std::string, ObjectState>::const_iterator here = shard.Objects.find(object_id);
+  if (here != shard.Objects.end())
+    {
+    for (std::size_t i = 0; i < here->second.Visits.size(); ++i)
+      {
+      Visit const& visit = here->second.Visits[i];
+      std::unordered_map<region_id_type, Region>::const_iterator region = this->Regions.find(visit.Region);
+      if (region != this->Regions.end() && region->second.Serial == visit.Serial)
+        {
+        result.push_back(visit.Region);
+        }
+      }
+    }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+void GeofenceMonitor::update(std::string const& object_id,
+                             double longitude, double latitude,
+                             Timestamp const& time,
+                             event_vector_type& events,
+                             std::size_t point_index)
+{
+  Shard& shard = this->Shards[this->shard_index(object_id)];
+  ObjectState& state = shard.Objects[object_id];
+  this->update_object(state, object_id, longitude, latitude, time, events, point_index);
+}
+
+void GeofenceMonitor::process(std::size_t num_points,
+                              std::string const* object_ids,
+                              double const* longitudes,
+                              double const* latitudes,
+                              Timestamp const* times,
+                              event_vector_type& events)
+{
+  std::vector<std::vector<std::size_t> > points_by_shard(this->Shards.size());
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    points_by_shard[this->shard_index(object_ids[i])].push_back(i);
+    }
+
+  std::vector<event_vector_type> shard_events(this->Shards.size());
+  parallel_for(0, this->Shards.size(),
+               [&, this](std::size_t s) {
+                 Shard& shard = this->Shards[s];
+                 std::vector<std::size_t> const& points = points_by_shard[s];
+                 for (std::size_t p = 0; p < points.size(); ++p)
+                   {
+                   std::size_t i = points[p];
+                   this->update_object(shard.Objects[object_ids[i]], object_ids[i],
+                                       longitudes[i], latitudes[i], times[i],
+                                       shard_events[s], i);
+                   }
+               },
+               this->NumThreads, 1);
+
+  // Each shard's events are already in point order
+  std::size_t first_new = events.size();
+  for (std::size_t s = 0; s < shard_events.size(); ++s)
+    {
+    events.insert(events.end(), shard_events[s].begin(), shard_events[s].end());
+    }
+  std::stable_sort(events.begin() + first_new, events.end(),
+                   [](GeofenceEvent const& a, GeofenceEvent const& b) {
+                     return a.point_index < b.point_index;
+                   });
+}
+
+// ----------------------------------------------------------------------
+
+// Work out what happened to one object between its previous point
+// and this one.  For every region near either point, start from
+// whether the object was inside, toggle at each boundary crossing
+// along the segment and compare with whether the new point really
+// is inside.  If the two disagree, a crossing was counted twice at a
+// vertex (drop the last one) or the region is new (report the change
+// at the new point).
+void GeofenceMonitor::update_object(ObjectState& state,
+                                    std::string const& object_id,
+                                    double x, double y,
+                                    Timestamp const& time,
+                                    event_vector_type& events,
+                                    std::size_t point_index) const
+{
+  bool have_segment = state.Seen;
+  if (have_segment && time < state.Time)
+    {
+    return;
+    }
+
+  double x0 = (have_segment ? state.X : x);
+  double y0 = (have_segment ? state.Y : y);
+  Timestamp t0 = (have_segment ? state.Time : time);
+
+  // A step of more than 180 degrees crosses the antimeridian.  Look
+  // at it as two copies of the segment shifted by a full turn; the
+  // fraction along the segment means the same thing in both.
+  double shift = 0;
+  if (x - x0 > 180)
+    {
+    shift = -360;
+    }
+  else if (x0 - x > 180)
+    {
+    shift = 360;
+    }
+
+  std::vector<Region const*> candidates;
+  this->regions_near(std::min(x0, x + shift), std::min(y0, y),
+                     std::max(x0, x + shift), std::max(y0, y), candidates);
+  if (shift != 0)
+    {
+    this->regions_near(std::min(x0 - shift, x), std::min(y0, y),
+                       std::max(x0 - shift, x), std::max(y0, y), candidates);
+    }
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  // Visits to regions that have since been removed are forgotten
+  std::vector<Visit> visits;
+  for (std::size_t i = 0; i < state.Visits.size(); ++i)
+    {
+    Visit const& visit = state.Visits[i];
+    std::unordered_map<region_id_type, Region>::const_iterator region = this->Regions.find(visit.Region);
+    if (region != this->Regions.end() && region->second.Serial == visit.Serial)
+      {
+      visits.push_back(visit);
+      }
+    }
+
+  std::size_t first_event = events.size();
+  std::vector<Visit> new_visits;
+  std::vector<double> fractions;
+  bool dwell_enabled = (this->DwellTime > boost::posix_time::seconds(0));
+
+  auto make_event = [&](Region const& region, GeofenceEventType type, double fraction) {
+    GeofenceEvent event;
+    event.object_id = object_id;
+    event.region = region.Id;
+    event.type = type;
+    event.time = interpolate_time(t0, time, fraction);
+    event.longitude = x0 + fraction * (x + shift - x0);
+    if (event.longitude > 180)
+      {
+      event.longitude -= 360;
+      }
+    else if (event.longitude < -180)
+      {
+      event.longitude += 360;
+      }
+    event.latitude = y0 + fraction * (y - y0);
+    event.point_index = point_index;
+    return event;
+  };
+
+  for (std::size_t c = 0; c < candidates.size(); ++c)
+    {
+    Region const& region = *candidates[c];
+
+    Visit visit;
+    visit.Region = region.Id;
+    visit.Serial = region.Serial;
+    visit.Entered = time;
+    visit.DwellReported = false;
+    bool inside = false;
+    for (std::size_t i = 0; i < visits.size(); ++i)
+      {
+      if (visits[i].Serial == region.Serial)
+        {
+        visit = visits[i];
+        inside = true;
+        break;
+        }
+      }
+
+    fractions.clear();
+    if (have_segment)
+      {
+      ring_crossings(region.Rings, x0, y0, x + shift, y, fractions);
+      if (shift != 0)
+        {
+        ring_crossings(region.Rings, x0 - shift, y0, x, y, fractions);
+        }
+      std::sort(fractions.begin(), fractions.end());
+      }
+
+    bool inside_now = point_in_rings(region.Rings, x, y);
+    bool parity_says_inside = (inside != (fractions.size() % 2 == 1));
+    if (parity_says_inside != inside_now)
+      {
+      if (!fractions.empty())
+        {
+        fractions.pop_back();
+        }
+      else
+        {
+        fractions.push_back(1);
+        }
+      }
+
+    for (std::size_t f = 0; f < fractions.size(); ++f)
+      {
+      if (!inside)
+        {
+        events.push_back(make_event(region, GeofenceEventType::ENTER, fractions[f]));
+        visit.Entered = events.back().time;
+        visit.DwellReported = false;
+        inside = true;
+        }
+      else
+        {
+        Timestamp left = interpolate_time(t0, time, fractions[f]);
+        if (dwell_enabled && !visit.DwellReported && left - visit.Entered >= this->DwellTime)
+          {
+          events.push_back(make_event(region, GeofenceEventType::DWELL,
+                                      fraction_at_time(t0, time, visit.Entered + this->DwellTime)));
+          events.back().time = visit.Entered + this->DwellTime;
+          }
+        events.push_back(make_event(region, GeofenceEventType::EXIT, fractions[f]));
+        inside = false;
+        }
+      }
+
+    if (inside)
+      {
+      if (dwell_enabled && !visit.DwellReported && time - visit.Entered >= this->DwellTime)
+        {
+        events.push_back(make_event(region, GeofenceEventType::DWELL,
+                                    fraction_at_time(t0, time, visit.Entered + this->DwellTime)));
+        events.back().time = visit.Entered + this->DwellTime;
+        visit.DwellReported = true;
+        }
+      new_visits.push_back(visit);
+      }
+    }
+
+  std::stable_sort(events.begin() + first_event, events.end(),
+                   [](GeofenceEvent const& a, GeofenceEvent const& b) { return a.time < b.time; });
+
+  state.X = x;
+  state.Y = y;
+  state.Time = time;
+  state.Seen = true;
+  state.Visits.swap(new_visits);
+}
+
+} // namespace tracktable
@@ -0,0 +1,319 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/Geofence.h - Enter, exit and dwell events for
+ * moving objects against a changing set of regions
+ *
+ * RTree::intersects answers "which boxes is this point in" once.
+ * Monitoring regions means asking that for every point of every
+ * object as it streams in and reporting only the changes.  A
+ * GeofenceMonitor keeps the regions in an R-tree that can be updated
+ * at any time, remembers which regions each object is in, and turns
+ * the segment between an object's last two points into enter and exit
+ * events with interpolated crossing times.
+ */
+
+#ifndef __tracktable_Geofence_h
+#define __tracktable_Geofence_h
+
+#include <tracktable/Analysis/TracktableAnalysisWindowsHeader.h>
+#include <tracktable/Core/Timestamp.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tracktable {
+
+enum class GeofenceEventType {
+  /// The object moved into the region (or was first seen inside it)
+  ENTER,
+  /// The object moved out of the region
+  EXIT,
+  /// The object has been inside the region for the dwell time
+  DWELL,
+};
+
+/// One change in an object's relationship to a region
+struct GeofenceEvent
+{
+  std::string object_id;
+  std::int64_t region;
+  GeofenceEventType type;
+  /// When it happened, interpolated between the object's points
+  Timestamp time;
+  /// Where it happened (the crossing point for ENTER and EXIT)
+  double longitude;
+  double latitude;
+  /// Index of the point that produced the event within its batch
+  std::size_t point_index;
+};
+
+/**
+ * @class GeofenceMonitor
+ * @brief Streaming region-entry detection for many objects at once
+ *
+ * Regions are boxes or polygons in longitude/latitude degrees, each
+ * with an ID chosen by the caller.  Polygons follow the even-odd
+ * rule, so holes are extra rings.  Like PolygonLayer, geometry is
+ * planar in longitude/latitude, and a step of more than 180 degrees
+ * of longitude between two points is taken to cross the antimeridian.
+ *
+ * Feed points in time order for each object, either one at a time
+ * with update() or in batches with process().  For each point the
+ * monitor looks at the segment from the object's previous point and
+ * emits:
+ *
+ * - ENTER and EXIT for every boundary crossing along the segment, at
+ *   the time and place of the crossing.  A segment that passes
+ *   through a region without stopping there produces both.
+ * - ENTER at the point itself for regions an object is inside when
+ *   it is first seen or when the region is added.
+ * - DWELL once per visit, at the moment the object has been inside
+ *   a region for the dwell time, if one is set.
+ *
+ * Points that are older than an object's previous point are ignored.
+ * Nothing is emitted for an object that simply stops reporting; call
+ * remove_object() to forget it.
+ *
+ * Regions can be added and removed between calls.  Removing a region
+ * silently forgets which objects were inside it.  Batches are split
+ * by object across threads, so points for one object stay in order
+ * and the events come back in input order regardless of the thread
+ * count.  The monitor itself must not be changed while a batch is
+ * running.
+ *
+ * @code
+ * tracktable::GeofenceMonitor monitor;
+ * monitor.add_box(1, -106.8, 34.9, -106.4, 35.3);
+ * monitor.set_dwell_time(tracktable::minutes(10));
+ *
+ * std::vector<tracktable::GeofenceEvent> events;
+ * monitor.process(points.begin(), points.end(), events);
+ * @endcode
+ */
+class TRACKTABLE_ANALYSIS_EXPORT GeofenceMonitor
+{
+public:
+  typedef std::int64_t region_id_type;
+  typedef std::vector<GeofenceEvent> event_vector_type;
+
+  GeofenceMonitor();
+  ~GeofenceMonitor();
+
+  // ---------------------------------------------------------------
+  // Regions
+
+  /** Add a box region
+   *
+   * A box whose min longitude is greater than its max longitude
+   * crosses the antimeridian.  Adding a region with an ID that is
+   * already in use replaces the old region.
+   */
+  void add_box(region_id_type region,
+               double min_longitude, double min_latitude,
+               double max_longitude, double max_latitude);
+
+  /** Add a polygon region
+   *
+   * @param [in] region     Region ID
+   * @param [in] rings      Rings of lon, lat, lon, lat, ... values.
+   *                        Rings may or may not repeat their first vertex.
+   */
+  void add_polygon(region_id_type region, std::vector<std::vector<double> > const& rings);
+
+  /// Remove a region.  Returns false if there was no such region.
+  bool remove_region(region_id_type region);
+
+  bool has_region(region_id_type region) const;
+
+  std::size_t num_regions() const;
+
+  /// Remove every region
+  void clear_regions();
+
+  // ---------------------------------------------------------------
+  // Settings
+
+  /// How long an object must stay in a region to produce DWELL; 0 disables DWELL
+  void set_dwell_time(Duration const& dwell_time);
+
+  Duration dwell_time() const;
+
+  /// Number of threads for process(); 0 means default_thread_count()
+  void set_num_threads(std::size_t num_threads);
+
+  std::size_t num_threads() const;
+
+  // ---------------------------------------------------------------
+  // Objects
+
+  /// Number of objects being tracked
+  std::size_t num_objects() const;
+
+  /// Forget an object.  No events are emitted.
+  void remove_object(std::string const& object_id);
+
+  /// Forget every object
+  void clear_objects();
+
+  /// Regions an object is inside right now, in increasing order
+  std::vector<region_id_type> regions_containing(std::string const& object_id) const;
+
+  // ---------------------------------------------------------------
+  // Points
+
+  /** Process one point
+   *
+   * @param [in]  object_id   ID of the moving object
+   * @param [in]  longitude   Longitude in degrees
+   * @param [in]  latitude    Latitude in degrees
+   * @param [in]  time        Timestamp of the point
+   * @param [out] events      New events are appended here
+   * @param [in]  point_index Stored in each event
+   */
+  void update(std::string const& object_id,
+              double longitude, double latitude,
+              Timestamp const& time,
+              event_vector_type& events,
+              std::size_t point_index=0);
+
+  /** Process a batch of points in parallel
+   *
+   * Events are appended to `events` in the order of the points that
+   * produced them, and in time order for each point.
+   *
+   * @param [in]  num_points  Number of points
+   * @param [in]  object_ids  Object ID of each point
+   * @param [in]  longitudes  Longitude of each point
+   * @param [in]  latitudes   Latitude of each point
+   * @param [in]  times       Timestamp of each point
+   * @param [out] events      New events are appended here
+   */
+  void process(std::size_t num_points,
+               std::string const* object_ids,
+               double const* longitudes,
+               double const* latitudes,
+               Timestamp const* times,
+               event_vector_type& events);
+
+  /** Process a batch of trajectory points in parallel
+   *
+   * Any point type with object_id(), timestamp() and longitude and
+   * latitude (or x and y) as coordinates 0 and 1 will do.
+   */
+  template<typename iterator_type>
+  void process(iterator_type begin, iterator_type end, event_vector_type& events)
+    {
+      std::vector<std::string> object_ids;
+      std::vector<double> longitudes, latitudes;
+      std::vector<Timestamp> times;
+      for (; begin != end; ++begin)
+        {
+        object_ids.push_back(begin->object_id());
+        longitudes.push_back((*begin)[0]);
+        latitudes.push_back((*begin)[1]);
+        times.push_back(begin->timestamp());
+        }
+      this->process(object_ids.size(), object_ids.data(), longitudes.data(), latitudes.data(),
+                    times.data(), events);
+    }
+
+private:
+  GeofenceMonitor(GeofenceMonitor const&) = delete;
+  GeofenceMonitor& operator=(GeofenceMonitor const&) = delete;
+
+  struct Region
+  {
+    region_id_type Id;
+    // Changes every time a region is added, so that state left over
+    // from a removed region never matches a new one with the same ID
+    std::uint64_t Serial;
+    // Rings of x, y, x, y, ...
+    std::vector<std::vector<double> > Rings;
+  };
+
+  struct Visit
+  {
+    region_id_type Region;
+    std::uint64_t Serial;
+    Timestamp Entered;
+    bool DwellReported;
+  };
+
+  struct ObjectState
+  {
+    ObjectState()
+      : X(0), Y(0), Seen(false)
+      { }
+
+    double X, Y;
+    Timestamp Time;
+    bool Seen;
+    std::vector<Visit> Visits;
+  };
+
+  // Object state is split into shards by a hash of the object ID so
+  // that each thread in process() owns some shards outright
+  struct Shard
+  {
+    std::unordered_map<std::string, ObjectState> Objects;
+  };
+
+  class RegionIndex;
+
+  void insert_region(Region const& region);
+  std::size_t shard_index(std::string const& object_id) const;
+
+  void update_object(ObjectState& state,
+                     std::string const& object_id,
+                     double x, double y,
+                     Timestamp const& time,
+                     event_vector_type& events,
+                     std::size_t point_index) const;
+
+  void regions_near(double min_x, double min_y, double max_x, double max_y,
+                    std::vector<Region const*>& regions) const;
+
+  std::unique_ptr<RegionIndex> Index;
+  std::unordered_map<region_id_type, Region> Regions;
+  std::uint64_t NextSerial;
+  std::vector<Shard> Shards;
+  Duration DwellTime;
+  std::size_t NumThreads;
+};
+
+} // namespace tracktable
+
+#endif
@@ -29,8 +29,11 @@
 
 #include "GreatCircleFit.h"
 
+#include <tracktable/Core/ParallelFor.h>
 #include <tracktable/Domain/Terrestrial.h>
 
+#include <cmath>
+
 // TODO: template/sfinae for double/float
 double constexpr sqrt_recursion(double _x, double _curr, double _prev) {
   return _curr == _prev ? _curr : sqrt_recursion(_x, 0.5 * (_curr + _x / _curr), _curr);
@@ -47,10 +50,6 @@ double constexpr constsqrt(double _x) {
                                                                  : std::numeric_limits<double>::quiet_NaN();
 }
 
-/* optimization function */
-double opt_fun(const tracktable::domain::cartesian3d::base_point_type &_p,
-               const tracktable::domain::terrestrial::trajectory_type &_trajectory,
-               std::string _altitude_string, tracktable::domain::terrestrial::AltitudeUnits _unit);
 tracktable::domain::cartesian3d::base_point_type add_scaled_vector(
     const tracktable::domain::cartesian3d::base_point_type &_v0,
     const tracktable::domain::cartesian3d::base_point_type &_v1, double _fac);
@@ -76,10 +75,56 @@ tracktable::domain::terrestrial::trajectory_type great_circle_fit_and_project(
   return result;
 }
 
-// TODO: Does not work well with trajectories with poor aspect ratio, should work direction of travel into it
+void GreatCircleFitWorkspace::load(const tracktable::domain::terrestrial::trajectory_type &_trajectory,
+                                   std::string const &_altitude_string,
+                                   tracktable::domain::terrestrial::AltitudeUnits _unit) {
+  X.resize(_trajectory.size());
+  Y.resize(_trajectory.size());
+  Z.resize(_trajectory.size());
+  for (auto i = 0u; i < _trajectory.size(); ++i) {
+    auto unit = tracktable::arithmetic::normalize(_trajectory[i].ECEF(_altitude_string, _unit));
+    X[i] = unit[0];
+    Y[i] = unit[1];
+    Z[i] = unit[2];
+  }
+}
+
+double GreatCircleFitWorkspace::objective(const tracktable::domain::cartesian3d::base_point_type &_normal) const {
+  const double nx = _normal[0];
+  const double ny = _normal[1];
+  const double nz = _normal[2];
+  const double *x = X.data();
+  const double *y = Y.data();
+  const double *z = Z.data();
+  const std::size_t n = X.size();
+
+  double partial[4] = {0.0, 0.0, 0.0, 0.0};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      double val = nx * x[i + lane] + ny * y[i + lane] + nz * z[i + lane];
+      // val += val * val * val / 6.0;  // TODO: Ask Rintoul to confirm the +=
+      partial[lane] += std::abs(val);
+    }
+  }
+  double sum = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+  for (; i < n; ++i) {
+    sum += std::abs(nx * x[i] + ny * y[i] + nz * z[i]);
+  }
+  return sum;
+}
+
 tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
     const tracktable::domain::terrestrial::trajectory_type &_trajectory, std::string _altitude_string,
     tracktable::domain::terrestrial::AltitudeUnits _unit) {
+  GreatCircleFitWorkspace workspace;
+  return find_best_fit_plane(_trajectory, workspace, _altitude_string, _unit);
+}
+
+// TODO: Does not work well with trajectories with poor aspect ratio, should work direction of travel into it
+tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
+    const tracktable::domain::terrestrial::trajectory_type &_trajectory, GreatCircleFitWorkspace &_workspace,
+    std::string _altitude_string, tracktable::domain::terrestrial::AltitudeUnits _unit) {
   if (_trajectory.size() < 2) {
     throw TooFewPoints();
   }
@@ -99,9 +144,13 @@ tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
   // Then we can use them to make a first guess
   auto normal = tracktable::arithmetic::normalize(tracktable::arithmetic::cross_product(v1, v2));
 
+  // Every evaluation below reads the unit vectors from the workspace
+  // instead of converting the trajectory again.
+  _workspace.load(_trajectory, _altitude_string, _unit);
+
   // Using our initial guess, see our optimization value.  We are trying
   // to minimize this.
-  double minSum = opt_fun(normal, _trajectory, _altitude_string, _unit);
+  double minSum = _workspace.objective(normal);
 
   // Tools for our optimization routine.  The first two give us a way to
   // find a neighborhood of points, the second is or control over how
@@ -131,7 +180,7 @@ tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
       temp = add_scaled_vector(temp, v1, eps * cyc.at(i));
       temp = add_scaled_vector(temp, v2, eps * cyc.at((i + 2u) % numDirections));
       tracktable::arithmetic::normalize_in_place(temp);
-      auto sum = opt_fun(temp, _trajectory, _altitude_string, _unit);
+      auto sum = _workspace.objective(temp);
       if (sum < minSum) {
         normal = temp;
         minSum = sum;
@@ -142,6 +191,40 @@ tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
   return normal;
 }
 
+std::vector<tracktable::domain::cartesian3d::base_point_type> find_best_fit_planes(
+    std::vector<tracktable::domain::terrestrial::trajectory_type const *> const &_trajectories,
+    std::string _altitude_string, tracktable::domain::terrestrial::AltitudeUnits _unit, std::size_t _num_threads) {
+  if (_num_threads == 0) {
+    _num_threads = default_thread_count();
+  }
+  std::vector<tracktable::domain::cartesian3d::base_point_type> normals(
+      _trajectories.size(), tracktable::arithmetic::zero<tracktable::domain::cartesian3d::base_point_type>());
+  std::vector<GreatCircleFitWorkspace> workspaces(_num_threads);
+
+  parallel_for_with_worker(
+      0, _trajectories.size(),
+      [&](std::size_t _i, std::size_t _worker) {
+        try {
+          normals[_i] = find_best_fit_plane(*_trajectories[_i], workspaces[_worker], _altitude_string, _unit);
+        } catch (TooFewPoints &) {
+        } catch (IdenticalPositions &) {
+        }
+      },
+      _num_threads, 4);
+  return normals;
+}
+
+std::vector<tracktable::domain::cartesian3d::base_point_type> find_best_fit_planes(
+    std::vector<tracktable::domain::terrestrial::trajectory_type> const &_trajectories,
+    std::string _altitude_string, tracktable::domain::terrestrial::AltitudeUnits _unit, std::size_t _num_threads) {
+  std::vector<tracktable::domain::terrestrial::trajectory_type const *> pointers;
+  pointers.reserve(_trajectories.size());
+  for (auto const &trajectory : _trajectories) {
+    pointers.push_back(&trajectory);
+  }
+  return find_best_fit_planes(pointers, _altitude_string, _unit, _num_threads);
+}
+
 void project_trajectory_onto_plane(tracktable::domain::terrestrial::trajectory_type &_trajectory,
                                    const tracktable::domain::cartesian3d::base_point_type &_normal,
                                    std::string _altitude_string,
@@ -159,19 +242,6 @@ void project_trajectory_onto_plane(tracktable::domain::terrestrial::trajectory_t
 
 }  // namespace tracktable
 
-double opt_fun(const tracktable::domain::cartesian3d::base_point_type &_p,
-               const tracktable::domain::terrestrial::trajectory_type &_trajectory,
-               std::string _altitude_string, tracktable::domain::terrestrial::AltitudeUnits _unit) {
-  auto sum = 0.0;
-  for (const auto &p : _trajectory) {
-    auto val =
-        tracktable::arithmetic::dot(_p, tracktable::arithmetic::normalize(p.ECEF(_altitude_string, _unit)));
-    // val += val * val * val / 6.0;  // TODO: Ask Rintoul to confirm the +=
-    sum += std::abs(val);  // * val;
-  }
-  return sum;
-}
-
 tracktable::domain::cartesian3d::base_point_type add_scaled_vector(
     const tracktable::domain::cartesian3d::base_point_type &_v0,
     const tracktable::domain::cartesian3d::base_point_type &_v1, double _fac) {
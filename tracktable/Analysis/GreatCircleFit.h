@@ -34,6 +34,8 @@
 #include <tracktable/Domain/Cartesian3D.h>
 #include <tracktable/Domain/Terrestrial.h>
 
+#include <vector>
+
 /**
  * @brief An exception thrown when a trajectory has too few points
  */
@@ -60,6 +62,50 @@ class ZeroNorm : public std::runtime_error {
 
 namespace tracktable {
 
+/** @brief Scratch space for fitting many trajectories without reallocating
+ *
+ * Holds the ECEF unit vector of every point in one trajectory as three
+ * contiguous arrays. find_best_fit_plane() evaluates its objective
+ * dozens of times per trajectory; reading these arrays instead of
+ * converting every point on every evaluation is what makes batch
+ * fitting cheap. Reuse one workspace per thread so the arrays keep
+ * their capacity from one trajectory to the next.
+ */
+class TRACKTABLE_ANALYSIS_EXPORT GreatCircleFitWorkspace {
+ public:
+  /** @brief Convert a trajectory's points to ECEF unit vectors
+   * @param _trajectory The trajectory to load
+   * @param _altitude_string Label of point property that contains altitude
+   * @param _unit Units of the altitude property
+   */
+  void load(const tracktable::domain::terrestrial::trajectory_type &_trajectory,
+            std::string const &_altitude_string = "altitude",
+            tracktable::domain::terrestrial::AltitudeUnits _unit =
+                tracktable::domain::terrestrial::AltitudeUnits::FEET);
+
+  /** @brief Sum of |dot(normal, u)| over the loaded unit vectors u
+   *
+   * This is the quantity find_best_fit_plane() minimizes. The loop
+   * keeps four independent partial sums so that the compiler can
+   * vectorize it.
+   * @param _normal Unit normal of the candidate plane
+   */
+  double objective(const tracktable::domain::cartesian3d::base_point_type &_normal) const;
+
+  /// Number of loaded points
+  std::size_t size() const { return X.size(); }
+
+  /// Unit vector of loaded point `_i`
+  tracktable::domain::cartesian3d::base_point_type unit_vector(std::size_t _i) const {
+    return tracktable::domain::cartesian3d::base_point_type(X[_i], Y[_i], Z[_i]);
+  }
+
+ private:
+  std::vector<double> X;
+  std::vector<double> Y;
+  std::vector<double> Z;
+};
+
 /** @brief Find the best fit plane and project onto it
  *   The purpose is to do a linear fit on a globe. Thus it only works with terrestrial trajectories
  * @note in place version is a destructive the process, the trajectory is modified.
@@ -100,6 +146,52 @@ tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
     tracktable::domain::terrestrial::AltitudeUnits _unit =
         tracktable::domain::terrestrial::AltitudeUnits::FEET);
 
+/** @brief Find the best fit plane using caller-supplied scratch space
+ *
+ * Same result as find_best_fit_plane() above. The workspace is
+ * overwritten.
+ * @param _trajectory The trajectory to fit
+ * @param _workspace Scratch space, see GreatCircleFitWorkspace
+ * @param _altitude_string Label of point property that contains altitude
+ * @param _unit Units of the altitude property
+ * @return The normal (in ECEF space) representing the best fit plane.
+ */
+TRACKTABLE_ANALYSIS_EXPORT
+tracktable::domain::cartesian3d::base_point_type find_best_fit_plane(
+    const tracktable::domain::terrestrial::trajectory_type &_trajectory, GreatCircleFitWorkspace &_workspace,
+    std::string _altitude_string = "altitude",
+    tracktable::domain::terrestrial::AltitudeUnits _unit =
+        tracktable::domain::terrestrial::AltitudeUnits::FEET);
+
+/** @brief Find the best fit plane of many trajectories in parallel
+ *
+ * Each thread gets one GreatCircleFitWorkspace that it reuses for every
+ * trajectory it fits. Trajectories that cannot be fit (fewer than two
+ * points or all points identical) get a zero normal instead of
+ * aborting the batch.
+ * @param _trajectories The trajectories to fit
+ * @param _altitude_string Label of point property that contains altitude
+ * @param _unit Units of the altitude property
+ * @param _num_threads Number of threads to use; 0 means default_thread_count()
+ * @return One normal per trajectory, in the same order
+ */
+TRACKTABLE_ANALYSIS_EXPORT
+std::vector<tracktable::domain::cartesian3d::base_point_type> find_best_fit_planes(
+    std::vector<tracktable::domain::terrestrial::trajectory_type const *> const &_trajectories,
+    std::string _altitude_string = "altitude",
+    tracktable::domain::terrestrial::AltitudeUnits _unit = tracktable::domain::terrestrial::AltitudeUnits::FEET,
+    std::size_t _num_threads = 0);
+
+/** @brief Find the best fit plane of many trajectories in parallel
+ * @copydetails find_best_fit_planes(std::vector<tracktable::domain::terrestrial::trajectory_type const *> const &, std::string, tracktable::domain::terrestrial::AltitudeUnits, std::size_t)
+ */
+TRACKTABLE_ANALYSIS_EXPORT
+std::vector<tracktable::domain::cartesian3d::base_point_type> find_best_fit_planes(
+    std::vector<tracktable::domain::terrestrial::trajectory_type> const &_trajectories,
+    std::string _altitude_string = "altitude",
+    tracktable::domain::terrestrial::AltitudeUnits _unit = tracktable::domain::terrestrial::AltitudeUnits::FEET,
+    std::size_t _num_threads = 0);
+
 /** @brief Project a trajectory onto a plane defined by it's normal in ECEF space
  *
  * @param _trajectory the trajectory to project
@@ -0,0 +1,779 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/HNSWIndex.h - Approximate nearest neighbors for
+ * high-dimensional points
+ *
+ * The R-tree in RTree.h answers nearest-neighbor queries exactly, but
+ * its bounding boxes stop pruning anything once points have more than
+ * about ten dimensions and every query ends up touching most of the
+ * tree.  HNSWIndex is a hierarchical navigable small world graph
+ * (Malkov and Yashunin, "Efficient and robust approximate nearest
+ * neighbor search using Hierarchical Navigable Small World graphs",
+ * 2018).  Queries walk a layered proximity graph instead of a tree and
+ * cost roughly logarithmic time in the number of points regardless of
+ * dimension, at the price of occasionally missing a true neighbor.
+ */
+
+#ifndef __tracktable_HNSWIndex_h
+#define __tracktable_HNSWIndex_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/ParallelFor.h>
+
+#include <tracktable/Core/WarningGuards/PushWarningState.h>
+#include <tracktable/Core/WarningGuards/CommonBoostWarnings.h>
+#include <boost/geometry/algorithms/comparable_distance.hpp>
+#include <boost/geometry/algorithms/distance.hpp>
+#include <tracktable/Core/WarningGuards/PopWarningState.h>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+/** Approximate nearest-neighbor index over a set of points
+ *
+ * You can populate the index with any point type known to
+ * boost::geometry, including the feature vectors in
+ * `Domain/FeatureVectors.h`.  Distances come from
+ * `boost::geometry::comparable_distance` while searching and from
+ * `boost::geometry::distance` in the results.
+ *
+ * Points are identified by the order in which they were inserted,
+ * starting at 0.  Points cannot be removed.
+ *
+ * Three parameters trade accuracy for speed:
+ *
+ * - `max_neighbors` (M in the paper) is the number of graph edges
+ *   kept per point and layer (twice that on the bottom layer).  More
+ *   edges give better recall on hard data at the cost of memory and
+ *   build time.  Values from 8 to 48 are typical.
+ *
+ * - `ef_construction` is the size of the candidate list used while
+ *   linking a new point into the graph.  Larger values build a better
+ *   graph more slowly.
+ *
+ * - `ef_search` is the size of the candidate list used while
+ *   answering queries.  It can be changed at any time and is the main
+ *   recall/speed knob.  It is never smaller than the number of
+ *   neighbors requested.
+ *
+ * Quick Start:
+ *
+ * @code
+ *
+ * typedef tracktable::domain::feature_vectors::FeatureVector<24> signature_type;
+ * tracktable::HNSWIndex<signature_type> index;
+ *
+ * index.insert(my_signatures.begin(), my_signatures.end());
+ *
+ * std::vector<std::pair<std::size_t, double> > neighbors;
+ * index.find_nearest_neighbors(query, 10, std::back_inserter(neighbors));
+ *
+ * @endcode
+ *
+ * Insertion of a batch of points and batched queries can both use
+ * several threads.  Other than that, the index is not thread-safe:
+ * don't insert while another thread is querying.
+ *
+ * The index supports boost::serialization so it can be written to
+ * and read from disk with any Boost archive.
+ */
+
+template<typename PointT>
+class HNSWIndex
+{
+public:
+  typedef PointT point_type;
+  /// (point ID, distance to query)
+  typedef std::pair<std::size_t, double> neighbor_type;
+  typedef std::vector<neighbor_type> neighbor_vector_type;
+
+  /** Instantiate an empty index
+   *
+   * @param [in] max_neighbors    Graph edges per point and layer
+   * @param [in] ef_construction  Candidate list size while building
+   * @param [in] random_seed      Seed for choosing each point's top layer
+   */
+  HNSWIndex(std::size_t max_neighbors=16,
+            std::size_t ef_construction=200,
+            unsigned int random_seed=100)
+    : MaxNeighbors(std::max<std::size_t>(max_neighbors, 2))
+    , EfConstruction(std::max<std::size_t>(ef_construction, 1))
+    , EfSearch(50)
+    , LevelMultiplier(1.0 / std::log(static_cast<double>(std::max<std::size_t>(max_neighbors, 2))))
+    , MaxLevel(-1)
+    , EntryPoint(0)
+    , RandomGenerator(random_seed)
+    { }
+
+  HNSWIndex(HNSWIndex const& other)
+    : MaxNeighbors(other.MaxNeighbors)
+    , EfConstruction(other.EfConstruction)
+    , EfSearch(other.EfSearch)
+    , LevelMultiplier(other.LevelMultiplier)
+    , MaxLevel(other.MaxLevel)
+    , EntryPoint(other.EntryPoint)
+    , Points(other.Points)
+    , Links(other.Links)
+    , RandomGenerator(other.RandomGenerator)
+    , NodeLocks(other.Points.size())
+    { }
+
+  HNSWIndex& operator=(HNSWIndex const& other)
+    {
+      this->MaxNeighbors = other.MaxNeighbors;
+      this->EfConstruction = other.EfConstruction;
+      this->EfSearch = other.EfSearch;
+      this->LevelMultiplier = other.LevelMultiplier;
+      this->MaxLevel = other.MaxLevel;
+      this->EntryPoint = other.EntryPoint;
+      this->Points = other.Points;
+      this->Links = other.Links;
+      this->RandomGenerator = other.RandomGenerator;
+      this->NodeLocks.clear();
+      this->NodeLocks.resize(this->Points.size());
+      this->ScratchPool.clear();
+      return *this;
+    }
+
+  /// Number of points in the index
+  std::size_t size() const
+    {
+      return this->Points.size();
+    }
+
+  /// Whether or not the index is empty
+  bool empty() const
+    {
+      return this->Points.empty();
+    }
+
+  /// Remove all points
+  void clear()
+    {
+      this->Points.clear();
+      this->Links.clear();
+      this->NodeLocks.clear();
+      this->ScratchPool.clear();
+      this->MaxLevel = -1;
+      this->EntryPoint = 0;
+    }
+
+  /// Point with the given ID
+  point_type const& point(std::size_t point_id) const
+    {
+      return this->Points[point_id];
+    }
+
+  /// Graph edges per point and layer
+  std::size_t max_neighbors() const { return this->MaxNeighbors; }
+
+  /// Candidate list size while building
+  std::size_t ef_construction() const { return this->EfConstruction; }
+
+  /// Candidate list size while searching
+  std::size_t ef_search() const { return this->EfSearch; }
+
+  /** Set the candidate list size for queries
+   *
+   * Larger values find more of the true nearest neighbors and take
+   * longer.
+   *
+   * @param [in] ef  New candidate list size
+   */
+  void set_ef_search(std::size_t ef)
+    {
+      this->EfSearch = std::max<std::size_t>(ef, 1);
+    }
+
+  // ----------------------------------------------------------------------
+
+  /** Add one point to the index
+   *
+   * @param [in] new_point  Point to add
+   * @return ID of the new point
+   */
+  std::size_t insert(point_type const& new_point)
+    {
+      std::size_t point_id = this->append_point(new_point);
+      this->link_point(point_id, this->acquire_scratch().get());
+      return point_id;
+    }
+
+  /** Add many points to the index
+   *
+   * The points receive consecutive IDs starting with the return
+   * value.  The graph is built with several threads at once; the
+   * result is as good as a serial build but not bit-for-bit
+   * reproducible from one run to the next.
+   *
+   * @param [in] begin        Iterator for beginning of input points
+   * @param [in] end          Iterator for end of input points
+   * @param [in] num_threads  Number of threads to use; 0 means default_thread_count()
+   * @return ID of the first point inserted
+   */
+  template<typename PointIteratorT>
+  std::size_t insert(PointIteratorT begin, PointIteratorT end,
+                     std::size_t num_threads=0)
+    {
+      std::size_t first_id = this->Points.size();
+      for (; begin != end; ++begin)
+        {
+        this->append_point(*begin);
+        }
+
+      std::size_t parallel_start = first_id;
+      if (this->MaxLevel < 0 && parallel_start < this->Points.size())
+        {
+        this->link_point(parallel_start, this->acquire_scratch().get());
+        ++parallel_start;
+        }
+
+      if (num_threads == 0)
+        {
+        num_threads = default_thread_count();
+        }
+      std::vector<scratch_pointer_type> scratch;
+      for (std::size_t i = 0; i < num_threads; ++i)
+        {
+        scratch.push_back(this->acquire_scratch());
+        }
+
+      parallel_for_with_worker(
+        parallel_start, this->Points.size(),
+        [this, &scratch](std::size_t point_id, std::size_t worker) {
+          this->link_point(point_id, scratch[worker].get(), true);
+        },
+        num_threads,
+        64);
+
+      return first_id;
+    }
+
+  // ----------------------------------------------------------------------
+
+  /** Find (approximately) the nearest neighbors of a point
+   *
+   * Results are written as (point ID, distance) pairs in order of
+   * increasing distance.  Fewer than `num_neighbors` results are
+   * written only when the index holds fewer points.
+   *
+   * @param [in] search_point   Point whose neighbors you want
+   * @param [in] num_neighbors  How many neighbors to find
+   * @param [out] output        Output iterator for neighbor_type
+   * @param [in] ef             Candidate list size for this query; 0 means ef_search()
+   */
+  template<typename OutputIteratorT>
+  void find_nearest_neighbors(point_type const& search_point,
+                              std::size_t num_neighbors,
+                              OutputIteratorT output,
+                              std::size_t ef=0) const
+    {
+      scratch_pointer_type scratch(this->acquire_scratch());
+      neighbor_vector_type result;
+      this->search(search_point, num_neighbors, ef, scratch.get(), result);
+      std::copy(result.begin(), result.end(), output);
+    }
+
+  /** Find nearest neighbors for many points at once
+   *
+   * @param [in] begin          Iterator for beginning of search points
+   * @param [in] end            Iterator for end of search points
+   * @param [in] num_neighbors  How many neighbors to find for each
+   * @param [in] num_threads    Number of threads to use; 0 means default_thread_count()
+   * @param [in] ef             Candidate list size; 0 means ef_search()
+   * @return One list of (point ID, distance) pairs per search point
+   */
+  template<typename PointIteratorT>
+  std::vector<neighbor_vector_type>
+  batch_find_nearest_neighbors(PointIteratorT begin, PointIteratorT end,
+                               std::size_t num_neighbors,
+                               std::size_t num_threads=0,
+                               std::size_t ef=0) const
+    {
+      std::vector<point_type> queries(begin, end);
+      std::vector<neighbor_vector_type> results(queries.size());
+      if (num_threads == 0)
+        {
+        num_threads = default_thread_count();
+        }
+      std::vector<scratch_pointer_type> scratch;
+      for (std::size_t i = 0; i < num_threads; ++i)
+        {
+        scratch.push_back(this->acquire_scratch());
+        }
+
+      parallel_for_with_worker(
+        0, queries.size(),
+        [&](std::size_t i, std::size_t worker) {
+          this->search(queries[i], num_neighbors, ef, scratch[worker].get(), results[i]);
+        },
+        num_threads);
+
+      return results;
+    }
+
+private:
+  typedef std::uint32_t link_type;
+  typedef std::vector<link_type> link_vector_type;
+  typedef std::pair<double, link_type> candidate_type;
+  typedef std::priority_queue<candidate_type> max_heap_type;
+  typedef std::priority_queue<candidate_type,
+                              std::vector<candidate_type>,
+                              std::greater<candidate_type> > min_heap_type;
+
+  // Marks for the points visited by one search.  Bumping the
+  // generation clears all the marks at once so that a search costs
+  // nothing proportional to the size of the index.
+  struct VisitedSet
+  {
+    std::vector<std::uint32_t> Marks;
+    std::uint32_t Generation;
+
+    VisitedSet() : Generation(0) { }
+
+    void reset(std::size_t num_points)
+      {
+        if (this->Marks.size() < num_points)
+          {
+          this->Marks.resize(num_points, 0);
+          }
+        if (++this->Generation == 0)
+          {
+          std::fill(this->Marks.begin(), this->Marks.end(), 0);
+          this->Generation = 1;
+          }
+      }
+
+    bool visit(link_type node)
+      {
+        if (this->Marks[node] == this->Generation) return false;
+        this->Marks[node] = this->Generation;
+        return true;
+      }
+  };
+
+  // Hands a VisitedSet back to the index's pool when the caller is done
+  struct ScratchReturner
+  {
+    HNSWIndex const* Owner;
+    void operator()(VisitedSet* scratch) const
+      {
+        std::lock_guard<std::mutex> guard(this->Owner->ScratchMutex);
+        this->Owner->ScratchPool.push_back(std::unique_ptr<VisitedSet>(scratch));
+      }
+  };
+
+  typedef std::unique_ptr<VisitedSet, ScratchReturner> scratch_pointer_type;
+
+  std::size_t MaxNeighbors;
+  std::size_t EfConstruction;
+  std::size_t EfSearch;
+  double LevelMultiplier;
+  int MaxLevel;
+  link_type EntryPoint;
+
+  std::vector<point_type> Points;
+  // Links[point][layer] lists the point's neighbors on that layer
+  std::vector<std::vector<link_vector_type> > Links;
+  std::mt19937 RandomGenerator;
+
+  mutable std::deque<std::mutex> NodeLocks;
+  std::mutex EntryPointMutex;
+  mutable std::mutex ScratchMutex;
+  mutable std::vector<std::unique_ptr<VisitedSet> > ScratchPool;
+
+  friend class boost::serialization::access;
+
+  // ----------------------------------------------------------------------
+
+  template<class Archive>
+  void serialize(Archive& ar, const unsigned int /*version*/)
+    {
+      ar & this->MaxNeighbors;
+      ar & this->EfConstruction;
+      ar & this->EfSearch;
+      ar & this->LevelMultiplier;
+      ar & this->MaxLevel;
+      ar & this->EntryPoint;
+      ar & this->Points;
+      ar & this->Links;
+      if (Archive::is_loading::value)
+        {
+        this->NodeLocks.clear();
+        this->NodeLocks.resize(this->Points.size());
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  scratch_pointer_type acquire_scratch() const
+    {
+      std::unique_ptr<VisitedSet> scratch;
+      {
+      std::lock_guard<std::mutex> guard(this->ScratchMutex);
+      if (!this->ScratchPool.empty())
+        {
+        scratch = std::move(this->ScratchPool.back());
+        this->ScratchPool.pop_back();
+        }
+      }
+      if (!scratch)
+        {
+        scratch.reset(new VisitedSet);
+        }
+      return scratch_pointer_type(scratch.release(), ScratchReturner{this});
+    }
+
+  // ----------------------------------------------------------------------
+
+  double distance_between(point_type const& a, point_type const& b) const
+    {
+      return static_cast<double>(boost::geometry::comparable_distance(a, b));
+    }
+
+  std::size_t max_links(int layer) const
+    {
+      return (layer == 0 ? 2 * this->MaxNeighbors : this->MaxNeighbors);
+    }
+
+  // ----------------------------------------------------------------------
+
+  /// Store a point and choose its top layer, but don't link it yet
+  std::size_t append_point(point_type const& new_point)
+    {
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      double sample = uniform(this->RandomGenerator);
+      int level = static_cast<int>(
+        -std::log(std::max(sample, 1e-12)) * this->LevelMultiplier);
+
+      this->Points.push_back(new_point);
+      this->Links.push_back(std::vector<link_vector_type>(level + 1));
+      this->NodeLocks.emplace_back();
+      return this->Points.size() - 1;
+    }
+
+  // ----------------------------------------------------------------------
+
+  /// Copy a point's neighbor list, taking its lock if other threads are building
+  link_vector_type const& neighbors_of(link_type node, int layer,
+                                       bool concurrent,
+                                       link_vector_type& copy) const
+    {
+      if (!concurrent)
+        {
+        return this->Links[node][layer];
+        }
+      std::lock_guard<std::mutex> guard(this->NodeLocks[node]);
+      copy = this->Links[node][layer];
+      return copy;
+    }
+
+  // ----------------------------------------------------------------------
+
+  /// Walk downhill on one layer until no neighbor is closer
+  link_type greedy_search(point_type const& target, link_type start,
+                          int layer, bool concurrent) const
+    {
+      link_type current = start;
+      double current_distance = this->distance_between(target, this->Points[current]);
+      link_vector_type copy;
+      bool improved = true;
+      while (improved)
+        {
+        improved = false;
+        link_vector_type const& neighbors =
+          this->neighbors_of(current, layer, concurrent, copy);
+        for (link_type neighbor : neighbors)
+          {
+          double d = this->distance_between(target, this->Points[neighbor]);
+          if (d < current_distance)
+            {
+            current_distance = d;
+            current = neighbor;
+            improved = true;
+            }
+          }
+        }
+      return current;
+    }
+
+  // ----------------------------------------------------------------------
+
+  /** Best-first search on one layer
+   *
+   * Returns up to `ef` of the closest points found, nearest first.
+   */
+  std::vector<candidate_type> search_layer(point_type const& target,
+                                           std::vector<link_type> const& entry_points,
+                                           std::size_t ef,
+                                           int layer,
+                                           VisitedSet* visited,
+                                           bool concurrent) const
+    {
+      visited->reset(this->Points.size());
+      min_heap_type candidates;
+      max_heap_type found;
+
+      for (link_type entry : entry_points)
+        {
+        if (!visited->visit(entry)) continue;
+        double d = this->distance_between(target, this->Points[entry]);
+        candidates.push(candidate_type(d, entry));
+        found.push(candidate_type(d, entry));
+        }
+      while (found.size() > ef)
+        {
+        found.pop();
+        }
+
+      link_vector_type copy;
+      while (!candidates.empty())
+        {
+        candidate_type closest = candidates.top();
+        if (closest.first > found.top().first && found.size() >= ef)
+          {
+          break;
+          }
+        candidates.pop();
+
+        link_vector_type const& neighbors =
+          this->neighbors_of(closest.second, layer, concurrent, copy);
+        for (link_type neighbor : neighbors)
+          {
+          if (!visited->visit(neighbor)) continue;
+          double d = this->distance_between(target, this->Points[neighbor]);
+          if (found.size() < ef || d < found.top().first)
+            {
+            candidates.push(candidate_type(d, neighbor));
+            found.push(candidate_type(d, neighbor));
+            if (found.size() > ef)
+              {
+              found.pop();
+              }
+            }
+          }
+        }
+
+      std::vector<candidate_type> result;
+      result.reserve(found.size());
+      while (!found.empty())
+        {
+        result.push_back(found.top());
+        found.pop();
+        }
+      std::reverse(result.begin(), result.end());
+      return result;
+    }
+
+  // ----------------------------------------------------------------------
+
+  /** Choose neighbors that point in different directions
+   *
+   * This is the heuristic from the paper: walk the candidates from
+   * nearest to farthest and keep one only if it is closer to the base
+   * point than to every neighbor already kept.  It keeps the graph
+   * connected across clusters where plain nearest neighbors would
+   * all point into the same clump.
+   */
+  link_vector_type select_neighbors(std::vector<candidate_type> const& candidates,
+                                    std::size_t how_many) const
+    {
+      link_vector_type result;
+      result.reserve(how_many);
+      for (candidate_type const& candidate : candidates)
+        {
+        if (result.size() >= how_many) break;
+        bool keep = true;
+        for (link_type chosen : result)
+          {
+          if (this->distance_between(this->Points[candidate.second],
+                                     this->Points[chosen]) < candidate.first)
+            {
+            keep = false;
+            break;
+            }
+          }
+        if (keep)
+          {
+          result.push_back(candidate.second);
+          }
+        }
+      return result;
+    }
+
+  // ----------------------------------------------------------------------
+
+  /// Connect a point that append_point() has stored into the graph
+  void link_point(std::size_t point_id, VisitedSet* visited, bool concurrent=false)
+    {
+      link_type node = static_cast<link_type>(point_id);
+      int level = static_cast<int>(this->Links[node].size()) - 1;
+      point_type const& new_point = this->Points[node];
+
+      std::unique_lock<std::mutex> entry_lock(this->EntryPointMutex);
+      if (this->MaxLevel < 0)
+        {
+        this->EntryPoint = node;
+        this->MaxLevel = level;
+        return;
+        }
+      int max_level = this->MaxLevel;
+      link_type entry_point = this->EntryPoint;
+      // Points that raise the top of the graph are rare: let them hold
+      // the entry point lock for their whole insertion
+      if (level <= max_level)
+        {
+        entry_lock.unlock();
+        }
+
+      link_type current = entry_point;
+      for (int layer = max_level; layer > level; --layer)
+        {
+        current = this->greedy_search(new_point, current, layer, concurrent);
+        }
+
+      std::vector<link_type> entry_points(1, current);
+      for (int layer = std::min(level, max_level); layer >= 0; --layer)
+        {
+        std::vector<candidate_type> candidates(
+          this->search_layer(new_point, entry_points, this->EfConstruction,
+                             layer, visited, concurrent));
+        link_vector_type chosen(this->select_neighbors(candidates, this->MaxNeighbors));
+
+        {
+        std::lock_guard<std::mutex> guard(this->NodeLocks[node]);
+        this->Links[node][layer] = chosen;
+        }
+
+        for (link_type neighbor : chosen)
+          {
+          this->add_link(neighbor, node, layer);
+          }
+
+        entry_points.clear();
+        for (candidate_type const& candidate : candidates)
+          {
+          entry_points.push_back(candidate.second);
+          }
+        }
+
+      if (level > max_level)
+        {
+        this->EntryPoint = node;
+        this->MaxLevel = level;
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  /// Add a reverse edge, pruning the neighbor's list if it is full
+  void add_link(link_type from, link_type to, int layer)
+    {
+      std::lock_guard<std::mutex> guard(this->NodeLocks[from]);
+      link_vector_type& links = this->Links[from][layer];
+      if (std::find(links.begin(), links.end(), to) != links.end())
+        {
+        return;
+        }
+      links.push_back(to);
+
+      std::size_t limit = this->max_links(layer);
+      if (links.size() > limit)
+        {
+        point_type const& base = this->Points[from];
+        std::vector<candidate_type> candidates;
+        candidates.reserve(links.size());
+        for (link_type link : links)
+          {
+          candidates.push_back(
+            candidate_type(this->distance_between(base, this->Points[link]), link));
+          }
+        std::sort(candidates.begin(), candidates.end());
+        links = this->select_neighbors(candidates, limit);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  void search(point_type const& target, std::size_t num_neighbors,
+              std::size_t ef, VisitedSet* visited,
+              neighbor_vector_type& result) const
+    {
+      result.clear();
+      if (this->MaxLevel < 0 || num_neighbors == 0)
+        {
+        return;
+        }
+      if (ef == 0)
+        {
+        ef = this->EfSearch;
+        }
+      ef = std::max(ef, num_neighbors);
+
+      link_type current = this->EntryPoint;
+      for (int layer = this->MaxLevel; layer > 0; --layer)
+        {
+        current = this->greedy_search(target, current, layer, false);
+        }
+
+      std::vector<candidate_type> candidates(
+        this->search_layer(target, std::vector<link_type>(1, current),
+                           ef, 0, visited, false));
+      std::size_t count = std::min(num_neighbors, candidates.size());
+      result.reserve(count);
+      for (std::size_t i = 0; i < count; ++i)
+        {
+        link_type id = candidates[i].second;
+        result.push_back(
+          neighbor_type(id, static_cast<double>(
+                          boost::geometry::distance(target, this->Points[id]))));
+        }
+    }
+};
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,816 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/IncrementalDBSCAN.h - DBSCAN over a point set
+ * that changes a little at a time
+ *
+ * DBSCAN::learn_clusters builds its R-tree and discovers every
+ * cluster from scratch on each call.  When the point set is a sliding
+ * window (the last N days of feature vectors, say) almost all of that
+ * work is repeated.  IncrementalDBSCAN keeps the R-tree, each point's
+ * neighbor count and each point's cluster label between calls.
+ * Inserting or removing points updates the neighbor counts of the
+ * points nearby and then revisits only the clusters whose core points
+ * changed.  Each update reports the clusters that were created,
+ * merged, split or dissolved.
+ *
+ * The definitions of "neighbor" and "core point" are the same as in
+ * DBSCAN: a point is in another point's neighborhood if it lies
+ * within the search box around it (or inside the ellipsoid inscribed
+ * in that box when use_ellipsoid is set), and a point is a core point
+ * when its neighborhood, including itself, holds at least
+ * min_cluster_size points.  Core points therefore come out exactly as
+ * they would from a batch run over the same points.  Border points
+ * that could belong to more than one cluster keep their previous
+ * label when they still can, so they may differ from a batch run.
+ */
+
+#ifndef __tracktable_IncrementalDBSCAN_h
+#define __tracktable_IncrementalDBSCAN_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/PointArithmetic.h>
+#include <tracktable/Core/Timestamp.h>
+
+#include <tracktable/Analysis/GuardedBoostGeometryRTreeHeader.h>
+#include <tracktable/Analysis/detail/dbscan_points.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+enum class ClusterEventType {
+  /// A cluster appeared where there was none before
+  CREATED,
+  /// Two or more clusters became connected
+  MERGED,
+  /// A cluster lost the core points that held it together
+  SPLIT,
+  /// A cluster has no core points left
+  DISSOLVED,
+};
+
+/** One change to the cluster structure
+ *
+ * For CREATED and DISSOLVED, `cluster` is the cluster in question and
+ * `related` is empty.  For MERGED, `cluster` is the label that
+ * survived and `related` lists the labels absorbed into it.  For
+ * SPLIT, `cluster` is the label that came apart and `related` lists
+ * the labels of the pieces (one of which may be `cluster` itself).
+ */
+struct ClusterEvent
+{
+  ClusterEventType type;
+  int cluster;
+  std::vector<int> related;
+};
+
+/** DBSCAN that keeps its state between updates
+ *
+ * Points are identified by the integer ID that insert() hands out.
+ * IDs are assigned consecutively and are never reused.  Cluster
+ * labels are positive integers that stay the same from one update to
+ * the next as long as the cluster survives; label 0 means noise.
+ * Unlike DBSCAN::learn_clusters the labels are not renumbered to be
+ * contiguous.
+ *
+ * Each point may carry a timestamp so that a time window can be
+ * maintained with erase_before().  advance_window() does the
+ * insertion and the expiry in one update, which is cheaper than doing
+ * them separately because affected clusters are only revisited once.
+ *
+ * Example:
+ *
+ * @code
+ *
+ * typedef tracktable::cartesian2d::BasePoint point2d;
+ * tracktable::IncrementalDBSCAN<point2d> dbscan(point2d(0.5, 0.5), 10);
+ *
+ * // every night
+ * dbscan.advance_window(todays_points.begin(), todays_points.end(),
+ *                       today, today - boost::gregorian::days(90));
+ * for (auto const& event : dbscan.last_events())
+ *   {
+ *   ...
+ *   }
+ *
+ * @endcode
+ */
+
+template<class PointT>
+class IncrementalDBSCAN
+{
+public:
+  typedef PointT point_type;
+  typedef std::pair<point_type, std::size_t> rtree_value_type;
+  typedef boost::geometry::index::rtree<
+    rtree_value_type, boost::geometry::index::quadratic<16>
+    > rtree_type;
+  typedef std::vector<ClusterEvent> event_vector_type;
+
+  /** Instantiate an empty clustering
+   *
+   * @param [in] search_box_half_span  Distance defining "nearby" in each dimension
+   * @param [in] min_cluster_size      Minimum neighbor count for core points
+   * @param [in] use_ellipsoid         Use the ellipsoid inside the search box
+   */
+  IncrementalDBSCAN(point_type const& search_box_half_span,
+                    unsigned int min_cluster_size,
+                    bool use_ellipsoid=false)
+    : HalfSpan(search_box_half_span)
+    , MinClusterSize(min_cluster_size)
+    , UseEllipsoid(use_ellipsoid)
+    , NextPointId(0)
+    , NextClusterId(1)
+    , NumRangeQueries(0)
+    { }
+
+  /** Add points to the clustering
+   *
+   * The points receive consecutive IDs starting with the return
+   * value.  Points added without a timestamp are never removed by
+   * erase_before().
+   *
+   * @param [in] begin  Iterator for beginning of input points
+   * @param [in] end    Iterator for end of input points
+   * @param [in] when   Timestamp for all of these points
+   * @return ID of the first point inserted
+   */
+  template<class PointIteratorT>
+  std::size_t insert(PointIteratorT begin, PointIteratorT end,
+                     Timestamp const& when=Timestamp())
+    {
+      std::size_t first_id = this->NextPointId;
+      this->update(std::vector<std::size_t>(), begin, end, when);
+      return first_id;
+    }
+
+  /** Remove a single point
+   *
+   * @param [in] point_id  ID returned from insert()
+   * @return Whether or not the point was present
+   */
+  bool erase(std::size_t point_id)
+    {
+      if (this->Points.find(point_id) == this->Points.end())
+        {
+        return false;
+        }
+      std::vector<point_type> no_points;
+      this->update(std::vector<std::size_t>(1, point_id),
+                   no_points.begin(), no_points.end(), Timestamp());
+      return true;
+    }
+
+  /** Remove every point with a timestamp before the cutoff
+   *
+   * @param [in] cutoff  Points strictly older than this are removed
+   * @return Number of points removed
+   */
+  std::size_t erase_before(Timestamp const& cutoff)
+    {
+      std::vector<point_type> no_points;
+      std::vector<std::size_t> expired(this->expired_points(cutoff));
+      this->update(expired, no_points.begin(), no_points.end(), Timestamp());
+      return expired.size();
+    }
+
+  /** Slide a time window forward
+   *
+   * Removes the points older than `cutoff` and adds the new points
+   * in a single update.
+   *
+   * @param [in] begin   Iterator for beginning of input points
+   * @param [in] end     Iterator for end of input points
+   * @param [in] when    Timestamp for the new points
+   * @param [in] cutoff  Points strictly older than this are removed
+   * @return ID of the first point inserted
+   */
+  template<class PointIteratorT>
+  std::size_t advance_window(PointIteratorT begin, PointIteratorT end,
+                             Timestamp const& when,
+                             Timestamp const& cutoff)
+    {
+      std::size_t first_id = this->NextPointId;
+      this->update(this->expired_points(cutoff), begin, end, when);
+      return first_id;
+    }
+
+  /// Cluster changes caused by the most recent update
+  event_vector_type const& last_events() const
+    {
+      return this->LastEvents;
+    }
+
+  /// Number of points currently in the clustering
+  std::size_t size() const
+    {
+      return this->Points.size();
+    }
+
+  /// Number of clusters (not counting noise)
+  std::size_t num_clusters() const
+    {
+      return this->ClusterMembers.size();
+    }
+
+  /// How many range queries the updates have made (performance statistic)
+  std::size_t num_range_queries() const
+    {
+      return this->NumRangeQueries;
+    }
+
+  /** Cluster label for one point
+   *
+   * @param [in] point_id  ID returned from insert()
+   * @return Cluster label, 0 for noise or -1 if the point is not present
+   */
+  int cluster_id(std::size_t point_id) const
+    {
+      typename point_map_type::const_iterator iter = this->Points.find(point_id);
+      if (iter == this->Points.end())
+        {
+        return -1;
+        }
+      return iter->second.ClusterId;
+    }
+
+  /// Whether or not a point is a core point
+  bool is_core(std::size_t point_id) const
+    {
+      typename point_map_type::const_iterator iter = this->Points.find(point_id);
+      return (iter != this->Points.end() && iter->second.Core);
+    }
+
+  /** Write (point ID, cluster label) for every point
+   *
+   * Labels are written in order of ascending point ID.
+   *
+   * @param [out] output  Output iterator for std::pair<std::size_t, int>
+   */
+  template<class OutputIteratorT>
+  void point_cluster_labels(OutputIteratorT output) const
+    {
+      std::vector<std::pair<std::size_t, int> > labels;
+      labels.reserve(this->Points.size());
+      for (typename point_map_type::const_iterator iter = this->Points.begin();
+           iter != this->Points.end();
+           ++iter)
+        {
+        labels.push_back(std::make_pair(iter->first, iter->second.ClusterId));
+        }
+      std::sort(labels.begin(), labels.end());
+      std::copy(labels.begin(), labels.end(), output);
+    }
+
+  /// Sorted list of the current cluster labels
+  std::vector<int> cluster_ids() const
+    {
+      std::vector<int> result;
+      result.reserve(this->ClusterMembers.size());
+      for (typename cluster_map_type::const_iterator iter = this->ClusterMembers.begin();
+           iter != this->ClusterMembers.end();
+           ++iter)
+        {
+        result.push_back(iter->first);
+        }
+      std::sort(result.begin(), result.end());
+      return result;
+    }
+
+  /// Sorted IDs of the points in one cluster
+  std::vector<std::size_t> cluster_members(int cluster) const
+    {
+      std::vector<std::size_t> result;
+      typename cluster_map_type::const_iterator iter = this->ClusterMembers.find(cluster);
+      if (iter != this->ClusterMembers.end())
+        {
+        result.assign(iter->second.begin(), iter->second.end());
+        std::sort(result.begin(), result.end());
+        }
+      return result;
+    }
+
+private:
+  struct PointRecord
+  {
+    point_type Point;
+    Timestamp When;
+    std::size_t NeighborCount;
+    int ClusterId;
+    bool Core;
+  };
+
+  typedef std::unordered_map<std::size_t, PointRecord> point_map_type;
+  typedef std::unordered_set<std::size_t> member_set_type;
+  typedef std::unordered_map<int, member_set_type> cluster_map_type;
+  typedef std::multimap<Timestamp, std::size_t> expiry_map_type;
+
+  point_type HalfSpan;
+  std::size_t MinClusterSize;
+  bool UseEllipsoid;
+
+  rtree_type Index;
+  point_map_type Points;
+  cluster_map_type ClusterMembers;
+  expiry_map_type ExpiryQueue;
+  event_vector_type LastEvents;
+
+  std::size_t NextPointId;
+  int NextClusterId;
+  std::size_t NumRangeQueries;
+
+  // ----------------------------------------------------------------------
+
+  std::vector<std::size_t> expired_points(Timestamp const& cutoff) const
+    {
+      std::vector<std::size_t> result;
+      typename expiry_map_type::const_iterator stop = this->ExpiryQueue.lower_bound(cutoff);
+      for (typename expiry_map_type::const_iterator iter = this->ExpiryQueue.begin();
+           iter != stop;
+           ++iter)
+        {
+        result.push_back(iter->second);
+        }
+      return result;
+    }
+
+  // ----------------------------------------------------------------------
+
+  void find_neighbors(point_type const& center,
+                      std::vector<rtree_value_type>& neighbors)
+    {
+      neighbors.clear();
+      this->Index.query(
+        boost::geometry::index::within(
+          analysis::detail::make_box(center, this->HalfSpan)),
+        std::back_inserter(neighbors));
+      ++ this->NumRangeQueries;
+
+      if (this->UseEllipsoid)
+        {
+        point_type const& half_span = this->HalfSpan;
+        neighbors.erase(
+          std::remove_if(
+            neighbors.begin(), neighbors.end(),
+            [&center, &half_span](rtree_value_type const& value) {
+              return arithmetic::norm_squared(
+                arithmetic::divide(
+                  arithmetic::subtract(value.first, center),
+                  half_span)) > 1.0;
+            }),
+          neighbors.end());
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  void set_label(std::size_t point_id, PointRecord& record, int new_label)
+    {
+      if (record.ClusterId == new_label) return;
+      if (record.ClusterId != 0)
+        {
+        this->ClusterMembers[record.ClusterId].erase(point_id);
+        }
+      if (new_label != 0)
+        {
+        this->ClusterMembers[new_label].insert(point_id);
+        }
+      record.ClusterId = new_label;
+    }
+
+  // ----------------------------------------------------------------------
+
+  static std::size_t find_root(std::vector<std::size_t>& parent, std::size_t node)
+    {
+      while (parent[node] != node)
+        {
+        parent[node] = parent[parent[node]];
+        node = parent[node];
+        }
+      return node;
+    }
+
+  static void join(std::vector<std::size_t>& parent, std::size_t a, std::size_t b)
+    {
+      a = find_root(parent, a);
+      b = find_root(parent, b);
+      if (a != b)
+        {
+        parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  /** Apply removals and insertions, then repair the clusters
+   *
+   * Neighbor counts change only for points near the ones added or
+   * removed.  Clusters can only come apart when they lose a core
+   * point, so the core points of those ("dirty") clusters are
+   * regrouped one by one.  Every other cluster is still connected and
+   * is handled as a single node: new core points can join it to other
+   * clusters but cannot split it.
+   */
+  template<class PointIteratorT>
+  void update(std::vector<std::size_t> const& removals,
+              PointIteratorT insert_begin, PointIteratorT insert_end,
+              Timestamp const& when)
+    {
+      this->LastEvents.clear();
+
+      // Core status of every point whose neighbor count changed, as
+      // it was before this update
+      std::unordered_map<std::size_t, bool> was_core;
+      std::set<int> dirty_clusters;
+      std::vector<rtree_value_type> neighbors;
+
+      for (std::size_t point_id : removals)
+        {
+        typename point_map_type::iterator found = this->Points.find(point_id);
+        if (found == this->Points.end()) continue;
+
+        PointRecord record(found->second);
+        this->Points.erase(found);
+        was_core.erase(point_id);
+        this->Index.remove(rtree_value_type(record.Point, point_id));
+        if (!record.When.is_special())
+          {
+          std::pair<typename expiry_map_type::iterator,
+                    typename expiry_map_type::iterator> range =
+            this->ExpiryQueue.equal_range(record.When);
+          for (; range.first != range.second; ++range.first)
+            {
+            if (range.first->second == point_id)
+              {
+              this->ExpiryQueue.erase(range.first);
+              break;
+              }
+            }
+          }
+        if (record.ClusterId != 0)
+          {
+          this->ClusterMembers[record.ClusterId].erase(point_id);
+          if (record.Core)
+            {
+            dirty_clusters.insert(record.ClusterId);
+            }
+          }
+
+        this->find_neighbors(record.Point, neighbors);
+        for (rtree_value_type const& neighbor : neighbors)
+          {
+          PointRecord& affected = this->Points[neighbor.second];
+          was_core.insert(std::make_pair(neighbor.second, affected.Core));
+          -- affected.NeighborCount;
+          }
+        }
+
+      for (; insert_begin != insert_end; ++insert_begin)
+        {
+        std::size_t point_id = this->NextPointId++;
+        PointRecord record;
+        record.Point = *insert_begin;
+        record.When = when;
+        record.ClusterId = 0;
+        record.Core = false;
+
+        this->find_neighbors(record.Point, neighbors);
+        for (rtree_value_type const& neighbor : neighbors)
+          {
+          PointRecord& affected = this->Points[neighbor.second];
+          was_core.insert(std::make_pair(neighbor.second, affected.Core));
+          ++ affected.NeighborCount;
+          }
+        record.NeighborCount = neighbors.size() + 1;
+
+        this->Points.insert(std::make_pair(point_id, record));
+        this->Index.insert(rtree_value_type(record.Point, point_id));
+        if (!when.is_special())
+          {
+          this->ExpiryQueue.insert(std::make_pair(when, point_id));
+          }
+        was_core[point_id] = false;
+        }
+
+      // Core points that have to be grouped individually: new ones
+      // and the surviving core points of dirty clusters
+      std::vector<std::size_t> loose_points;
+      std::unordered_map<std::size_t, std::size_t> loose_node;
+      // Points that may need a new border/noise label
+      std::vector<std::size_t> border_candidates;
+
+      for (auto const& entry : was_core)
+        {
+        PointRecord& record = this->Points[entry.first];
+        record.Core = (record.NeighborCount >= this->MinClusterSize);
+        if (entry.second && !record.Core)
+          {
+          dirty_clusters.insert(record.ClusterId);
+          }
+        if (!entry.second && record.Core)
+          {
+          loose_node[entry.first] = loose_points.size();
+          loose_points.push_back(entry.first);
+          }
+        if (!record.Core)
+          {
+          border_candidates.push_back(entry.first);
+          }
+        }
+
+      for (int cluster : dirty_clusters)
+        {
+        for (std::size_t member : this->ClusterMembers[cluster])
+          {
+          PointRecord const& record = this->Points[member];
+          if (record.Core && loose_node.find(member) == loose_node.end())
+            {
+            loose_node[member] = loose_points.size();
+            loose_points.push_back(member);
+            }
+          else if (!record.Core)
+            {
+            border_candidates.push_back(member);
+            }
+          }
+        }
+
+      // Group the loose core points and the clean clusters they touch
+      std::vector<std::size_t> parent(loose_points.size());
+      std::iota(parent.begin(), parent.end(), 0);
+      std::map<int, std::size_t> cluster_node;
+
+      for (std::size_t i = 0; i < loose_points.size(); ++i)
+        {
+        this->find_neighbors(this->Points[loose_points[i]].Point, neighbors);
+        for (rtree_value_type const& neighbor : neighbors)
+          {
+          if (neighbor.second == loose_points[i]) continue;
+          PointRecord const& record = this->Points[neighbor.second];
+          if (!record.Core)
+            {
+            border_candidates.push_back(neighbor.second);
+            continue;
+            }
+          std::unordered_map<std::size_t, std::size_t>::const_iterator loose =
+            loose_node.find(neighbor.second);
+          if (loose != loose_node.end())
+            {
+            join(parent, i, loose->second);
+            }
+          else
+            {
+            std::map<int, std::size_t>::iterator node =
+              cluster_node.find(record.ClusterId);
+            if (node == cluster_node.end())
+              {
+              node = cluster_node.insert(
+                std::make_pair(record.ClusterId, parent.size())).first;
+              parent.push_back(parent.size());
+              }
+            join(parent, i, node->second);
+            }
+          }
+        }
+
+      // Collect the components along with the old labels that could
+      // carry over to each one
+      struct Component
+      {
+        std::vector<std::size_t> loose;
+        std::vector<int> clean_clusters;
+        std::vector<int> candidates;
+        std::size_t weight;
+        int label;
+      };
+
+      std::map<std::size_t, Component> components;
+      for (std::size_t i = 0; i < loose_points.size(); ++i)
+        {
+        Component& component = components[find_root(parent, i)];
+        component.loose.push_back(loose_points[i]);
+        std::unordered_map<std::size_t, bool>::const_iterator status =
+          was_core.find(loose_points[i]);
+        bool old_core = (status == was_core.end() || status->second);
+        if (old_core)
+          {
+          component.candidates.push_back(this->Points[loose_points[i]].ClusterId);
+          }
+        }
+      for (auto const& entry : cluster_node)
+        {
+        Component& component = components[find_root(parent, entry.second)];
+        component.clean_clusters.push_back(entry.first);
+        component.candidates.push_back(entry.first);
+        }
+
+      std::vector<Component*> ordered;
+      for (auto& entry : components)
+        {
+        Component& component = entry.second;
+        std::sort(component.candidates.begin(), component.candidates.end());
+        component.candidates.erase(
+          std::unique(component.candidates.begin(), component.candidates.end()),
+          component.candidates.end());
+        component.weight = 0;
+        for (int cluster : component.candidates)
+          {
+          component.weight = std::max(component.weight,
+                                      this->ClusterMembers[cluster].size());
+          }
+        ordered.push_back(&component);
+        }
+
+      // The heaviest components get first pick of the old labels so
+      // that the big piece of a split cluster keeps its label
+      std::stable_sort(ordered.begin(), ordered.end(),
+                       [](Component const* a, Component const* b) {
+                         return a->weight > b->weight;
+                       });
+
+      std::set<int> claimed;
+      for (Component* component : ordered)
+        {
+        component->label = 0;
+        std::size_t best_size = 0;
+        for (int cluster : component->candidates)
+          {
+          std::size_t cluster_size = this->ClusterMembers[cluster].size();
+          if (claimed.count(cluster) == 0 &&
+              (component->label == 0 || cluster_size > best_size))
+            {
+            component->label = cluster;
+            best_size = cluster_size;
+            }
+          }
+        if (component->label == 0)
+          {
+          component->label = this->NextClusterId++;
+          if (component->candidates.empty())
+            {
+            this->LastEvents.push_back(
+              ClusterEvent{ClusterEventType::CREATED, component->label, std::vector<int>()});
+            }
+          }
+        claimed.insert(component->label);
+        }
+
+      // Relabel: clean clusters move wholesale, loose points one at a time
+      std::map<int, std::vector<int> > split_pieces;
+      for (Component* component : ordered)
+        {
+        std::vector<int> absorbed;
+        for (int cluster : component->candidates)
+          {
+          if (cluster == component->label) continue;
+          if (dirty_clusters.count(cluster))
+            {
+            // A piece of a dirty cluster: reported as a split, and
+            // as a merge as well if it joined other clusters
+            if (component->candidates.size() > 1)
+              {
+              absorbed.push_back(cluster);
+              }
+            }
+          else
+            {
+            absorbed.push_back(cluster);
+            }
+          }
+        for (int cluster : component->clean_clusters)
+          {
+          if (cluster == component->label) continue;
+          member_set_type members;
+          members.swap(this->ClusterMembers[cluster]);
+          this->ClusterMembers.erase(cluster);
+          for (std::size_t member : members)
+            {
+            this->Points[member].ClusterId = component->label;
+            }
+          this->ClusterMembers[component->label].insert(members.begin(), members.end());
+          }
+        for (std::size_t point_id : component->loose)
+          {
+          PointRecord& record = this->Points[point_id];
+          std::unordered_map<std::size_t, bool>::const_iterator status =
+            was_core.find(point_id);
+          if (status == was_core.end() || status->second)
+            {
+            std::vector<int>& pieces = split_pieces[record.ClusterId];
+            if (std::find(pieces.begin(), pieces.end(), component->label) == pieces.end())
+              {
+              pieces.push_back(component->label);
+              }
+            }
+          this->set_label(point_id, record, component->label);
+          }
+        if (!absorbed.empty())
+          {
+          this->LastEvents.push_back(
+            ClusterEvent{ClusterEventType::MERGED, component->label, absorbed});
+          }
+        }
+
+      for (int cluster : dirty_clusters)
+        {
+        std::vector<int>& pieces = split_pieces[cluster];
+        if (pieces.empty())
+          {
+          this->LastEvents.push_back(
+            ClusterEvent{ClusterEventType::DISSOLVED, cluster, std::vector<int>()});
+          }
+        else if (pieces.size() > 1)
+          {
+          std::sort(pieces.begin(), pieces.end());
+          this->LastEvents.push_back(
+            ClusterEvent{ClusterEventType::SPLIT, cluster, pieces});
+          }
+        }
+
+      // Border points keep their label if a core point with that
+      // label is still nearby, otherwise take the smallest nearby
+      // label or become noise
+      std::sort(border_candidates.begin(), border_candidates.end());
+      border_candidates.erase(
+        std::unique(border_candidates.begin(), border_candidates.end()),
+        border_candidates.end());
+      for (std::size_t point_id : border_candidates)
+        {
+        typename point_map_type::iterator found = this->Points.find(point_id);
+        if (found == this->Points.end() || found->second.Core) continue;
+        PointRecord& record = found->second;
+
+        this->find_neighbors(record.Point, neighbors);
+        int new_label = 0;
+        for (rtree_value_type const& neighbor : neighbors)
+          {
+          PointRecord const& other = this->Points[neighbor.second];
+          if (!other.Core) continue;
+          if (other.ClusterId == record.ClusterId)
+            {
+            new_label = record.ClusterId;
+            break;
+            }
+          if (new_label == 0 || other.ClusterId < new_label)
+            {
+            new_label = other.ClusterId;
+            }
+          }
+        this->set_label(point_id, record, new_label);
+        }
+
+      for (typename cluster_map_type::iterator iter = this->ClusterMembers.begin();
+           iter != this->ClusterMembers.end(); )
+        {
+        if (iter->second.empty())
+          {
+          iter = this->ClusterMembers.erase(iter);
+          }
+        else
+          {
+          ++iter;
+          }
+        }
+    }
+};
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,378 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/LSHBucketing.h - Split feature vectors into
+ * groups of likely neighbors with locality-sensitive hashing
+ *
+ * DBSCAN spends nearly all of its time on neighborhood queries, and
+ * on millions of distance-geometry signatures even an R-tree query
+ * touches a large part of the data.  LSHBucketing hashes each point by
+ * where it falls along a handful of random directions (Datar et al.,
+ * "Locality-sensitive hashing scheme based on p-stable distributions",
+ * 2004).  Points that are close together usually land in the same
+ * bucket, so clustering each bucket on its own finds nearly the same
+ * clusters for a fraction of the cost, and buckets can be clustered in
+ * parallel.
+ *
+ * Points near the edge of a bucket can be copied into the adjacent
+ * buckets as well ("multi-probe").  More probes means fewer neighbors
+ * lost at bucket boundaries at the price of more duplicated work.
+ */
+
+#ifndef __tracktable_LSHBucketing_h
+#define __tracktable_LSHBucketing_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Analysis/ComputeDBSCANClustering.h>
+
+#include <boost/functional/hash.hpp>
+#include <boost/geometry/core/coordinate_dimension.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+/** Random-projection hash buckets for points
+ *
+ * Each point is divided component-wise by `scale` (usually the DBSCAN
+ * search box half-span, so that "nearby" means about 1 unit in every
+ * direction), projected onto `num_projections` random Gaussian
+ * directions and the projections cut into cells `bucket_width` units
+ * wide.  Points whose cells agree along every direction share a
+ * bucket.
+ *
+ * - More projections give smaller, more numerous buckets: faster
+ *   clustering, more neighbors split across boundaries.
+ * - A wider bucket does the opposite.
+ * - Each probe copies a point into the neighboring bucket across the
+ *   cell boundary it is nearest to, recovering most of the neighbors
+ *   that the boundaries would otherwise split off.
+ *
+ * You can use this with any Tracktable point type whose coordinates
+ * can be read with operator[], including the feature vectors in
+ * `Domain/FeatureVectors.h`.
+ */
+
+template<typename PointT>
+class LSHBucketing
+{
+public:
+  typedef PointT point_type;
+  typedef std::vector<std::size_t> bucket_type;
+  typedef std::vector<bucket_type> bucket_vector_type;
+
+  /** Instantiate a bucketing scheme
+   *
+   * @param [in] scale            Divide each component by this before hashing
+   * @param [in] num_projections  Number of random directions
+   * @param [in] bucket_width     Cell width along each direction in scaled units
+   * @param [in] num_probes       Extra buckets to copy each point into
+   * @param [in] random_seed      Seed for the random directions
+   */
+  LSHBucketing(point_type const& scale,
+               std::size_t num_projections=8,
+               double bucket_width=4.0,
+               std::size_t num_probes=0,
+               unsigned int random_seed=0)
+    : Scale(scale)
+    , NumProjections(std::max<std::size_t>(num_projections, 1))
+    , BucketWidth(bucket_width > 0 ? bucket_width : 1.0)
+    , NumProbes(num_probes)
+    {
+      std::mt19937 generator(random_seed);
+      std::normal_distribution<double> gaussian(0.0, 1.0);
+      std::uniform_real_distribution<double> offset(0.0, this->BucketWidth);
+
+      this->Directions.resize(this->NumProjections * Dimension);
+      for (double& component : this->Directions)
+        {
+        component = gaussian(generator);
+        }
+      this->Offsets.resize(this->NumProjections);
+      for (double& value : this->Offsets)
+        {
+        value = offset(generator);
+        }
+    }
+
+  std::size_t num_projections() const { return this->NumProjections; }
+  double bucket_width() const { return this->BucketWidth; }
+  std::size_t num_probes() const { return this->NumProbes; }
+
+  /** Sort points into buckets
+   *
+   * @param [in] begin  Iterator for beginning of input points
+   * @param [in] end    Iterator for end of input points
+   * @return One list of point indices per non-empty bucket.  A point
+   *         appears in up to 1 + num_probes buckets.
+   */
+  template<typename PointIteratorT>
+  bucket_vector_type partition(PointIteratorT begin, PointIteratorT end) const
+    {
+      typedef std::vector<std::int64_t> key_type;
+      std::unordered_map<key_type, std::size_t, boost::hash<key_type> > bucket_ids;
+      bucket_vector_type buckets;
+
+      key_type key(this->NumProjections);
+      std::vector<double> fractions(this->NumProjections);
+      std::vector<std::pair<double, std::ptrdiff_t> > boundaries;
+
+      auto add_to_bucket = [&](key_type const& bucket_key, std::size_t point_index) {
+        auto inserted = bucket_ids.insert(std::make_pair(bucket_key, buckets.size()));
+        if (inserted.second)
+          {
+          buckets.push_back(bucket_type());
+          }
+        buckets[inserted.first->second].push_back(point_index);
+      };
+
+      std::size_t point_index = 0;
+      for (; begin != end; ++begin, ++point_index)
+        {
+        this->hash(*begin, key, fractions);
+        add_to_bucket(key, point_index);
+
+        if (this->NumProbes == 0) continue;
+
+        // Distance to the lower and upper cell boundary along each
+        // direction, encoded as (distance, +/-(direction + 1))
+        boundaries.clear();
+        for (std::size_t j = 0; j < this->NumProjections; ++j)
+          {
+          std::ptrdiff_t which = static_cast<std::ptrdiff_t>(j) + 1;
+          boundaries.push_back(std::make_pair(fractions[j], -which));
+          boundaries.push_back(std::make_pair(1.0 - fractions[j], which));
+          }
+        std::size_t num_probes = std::min(this->NumProbes, boundaries.size());
+        std::partial_sort(boundaries.begin(), boundaries.begin() + num_probes,
+                          boundaries.end());
+        for (std::size_t p = 0; p < num_probes; ++p)
+          {
+          std::ptrdiff_t which = boundaries[p].second;
+          std::size_t direction = static_cast<std::size_t>(std::abs(which) - 1);
+          key[direction] += (which < 0 ? -1 : 1);
+          add_to_bucket(key, point_index);
+          key[direction] -= (which < 0 ? -1 : 1);
+          }
+        }
+
+      return buckets;
+    }
+
+private:
+  static const std::size_t Dimension =
+    boost::geometry::dimension<point_type>::value;
+
+  point_type Scale;
+  std::size_t NumProjections;
+  double BucketWidth;
+  std::size_t NumProbes;
+  // Row-major: NumProjections rows of Dimension components
+  std::vector<double> Directions;
+  std::vector<double> Offsets;
+
+  void hash(point_type const& point,
+            std::vector<std::int64_t>& key,
+            std::vector<double>& fractions) const
+    {
+      double scaled[Dimension];
+      for (std::size_t d = 0; d < Dimension; ++d)
+        {
+        scaled[d] = point[d] / this->Scale[d];
+        }
+      for (std::size_t j = 0; j < this->NumProjections; ++j)
+        {
+        double const* direction = &this->Directions[j * Dimension];
+        double projection = this->Offsets[j];
+        for (std::size_t d = 0; d < Dimension; ++d)
+          {
+          projection += direction[d] * scaled[d];
+          }
+        double cell = std::floor(projection / this->BucketWidth);
+        key[j] = static_cast<std::int64_t>(cell);
+        fractions[j] = projection / this->BucketWidth - cell;
+        }
+    }
+};
+
+// ----------------------------------------------------------------------
+
+/** Cluster points with DBSCAN one LSH bucket at a time
+ *
+ * The points are split into buckets with `bucketing`, each bucket is
+ * clustered with `cluster_with_dbscan` on its own (several buckets at
+ * a time) and the per-bucket clusters are stitched back together:
+ * two clusters that share a point copied into both buckets by a probe
+ * become one cluster.
+ *
+ * This is an approximation.  Neighbors that land in different buckets
+ * are not seen, so a sparse cluster can lose core points or split in
+ * two; more probes or fewer projections make that less likely.
+ *
+ * @param [in] input_begin   Iterator for beginning of input points
+ * @param [in] input_end     Iterator for end of input points
+ * @param [in] search_box_half_span  Distance defining "nearby" in all dimensions
+ * @param [in] minimum_cluster_size  Minimum number of neighbors for core points
+ * @param [out] output_sink  (Vertex ID, Cluster ID) for each point, in input order
+ * @param [in] bucketing     How to split the points into buckets
+ * @param [in] num_threads   Number of threads to use; 0 means default_thread_count()
+ * @return Number of clusters discovered
+ */
+
+template<class SearchBoxT, class PointIteratorT, class OutputIteratorT>
+int cluster_with_bucketed_dbscan(
+  PointIteratorT input_begin,
+  PointIteratorT input_end,
+  SearchBoxT search_box_half_span,
+  int minimum_cluster_size,
+  OutputIteratorT output_sink,
+  LSHBucketing<SearchBoxT> const& bucketing,
+  std::size_t num_threads=0
+  )
+{
+  typedef std::pair<int, int> cluster_label_type;
+
+  std::vector<SearchBoxT> points(input_begin, input_end);
+  typename LSHBucketing<SearchBoxT>::bucket_vector_type buckets(
+    bucketing.partition(points.begin(), points.end()));
+
+  // Biggest buckets first so that one huge bucket doesn't start last
+  std::vector<std::size_t> order(buckets.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&buckets](std::size_t a, std::size_t b) {
+                     return buckets[a].size() > buckets[b].size();
+                   });
+
+  std::vector<std::vector<cluster_label_type> > bucket_labels(buckets.size());
+  std::vector<int> bucket_cluster_count(buckets.size(), 0);
+  parallel_for(
+    0, order.size(),
+    [&](std::size_t i) {
+      std::size_t which = order[i];
+      typename LSHBucketing<SearchBoxT>::bucket_type const& members = buckets[which];
+      if (members.size() < static_cast<std::size_t>(minimum_cluster_size))
+        {
+        return;
+        }
+      std::vector<SearchBoxT> bucket_points;
+      bucket_points.reserve(members.size());
+      for (std::size_t member : members)
+        {
+        bucket_points.push_back(points[member]);
+        }
+      cluster_with_dbscan(
+        bucket_points.begin(), bucket_points.end(),
+        search_box_half_span, minimum_cluster_size,
+        std::back_inserter(bucket_labels[which]));
+      for (cluster_label_type const& label : bucket_labels[which])
+        {
+        bucket_cluster_count[which] = std::max(bucket_cluster_count[which], label.second);
+        }
+    },
+    num_threads,
+    1);
+
+  // Give every (bucket, cluster) pair a global number, then join
+  // the ones that share a point
+  std::vector<std::size_t> first_cluster(buckets.size() + 1, 0);
+  for (std::size_t b = 0; b < buckets.size(); ++b)
+    {
+    first_cluster[b + 1] = first_cluster[b] + bucket_cluster_count[b];
+    }
+  std::vector<std::size_t> parent(first_cluster.back());
+  std::iota(parent.begin(), parent.end(), 0);
+  auto find_root = [&parent](std::size_t node) {
+    while (parent[node] != node)
+      {
+      parent[node] = parent[parent[node]];
+      node = parent[node];
+      }
+    return node;
+  };
+
+  const std::size_t no_cluster = static_cast<std::size_t>(-1);
+  std::vector<std::size_t> point_cluster(points.size(), no_cluster);
+  for (std::size_t b = 0; b < buckets.size(); ++b)
+    {
+    for (cluster_label_type const& label : bucket_labels[b])
+      {
+      if (label.second == 0) continue;
+      // cluster_with_dbscan numbers clusters from 1
+      std::size_t global = first_cluster[b] + label.second - 1;
+      std::size_t point_index = buckets[b][label.first];
+      if (point_cluster[point_index] == no_cluster)
+        {
+        point_cluster[point_index] = global;
+        }
+      else
+        {
+        std::size_t a = find_root(point_cluster[point_index]);
+        std::size_t c = find_root(global);
+        if (a != c)
+          {
+          parent[std::max(a, c)] = std::min(a, c);
+          }
+        }
+      }
+    }
+
+  // Number the final clusters in order of their first point
+  std::unordered_map<std::size_t, int> final_label;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+    int label = 0;
+    if (point_cluster[i] != no_cluster)
+      {
+      std::size_t root = find_root(point_cluster[i]);
+      auto inserted = final_label.insert(
+        std::make_pair(root, static_cast<int>(final_label.size()) + 1));
+      label = inserted.first->second;
+      }
+    *output_sink = cluster_label_type(static_cast<int>(i), label);
+    ++output_sink;
+    }
+
+  return static_cast<int>(final_label.size());
+}
+
+} // namespace tracktable
+
+#endif
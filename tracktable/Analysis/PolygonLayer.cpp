@@ -0,0 +1,661 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/PolygonLayer.h>
+#include <tracktable/Core/Conversions.h>
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace tracktable {
+
+namespace {
+
+// Edges per leaf and children per interior node
+const std::size_t NODE_CAPACITY = 16;
+
+// Grid cell that an edge passes through: ask the edges
+const std::int32_t MIXED_CELL = -2;
+
+const double KM_PER_DEGREE =
+  conversions::constants::EARTH_RADIUS_IN_KM * conversions::constants::RADIANS_PER_DEGREE;
+
+// Distance from x to the interval [low, high], allowing x to be
+// shifted by a whole turn of longitude
+double longitude_gap(double x, double low, double high)
+{
+  double best = std::numeric_limits<double>::infinity();
+  for (int turn = -1; turn <= 1; ++turn)
+    {
+    double shifted = x + 360.0 * turn;
+    double gap = 0;
+    if (shifted < low)
+      {
+      gap = low - shifted;
+      }
+    else if (shifted > high)
+      {
+      gap = shifted - high;
+      }
+    best = std::min(best, gap);
+    }
+  return best;
+}
+
+double point_segment_distance(double px, double py,
+                              double x0, double y0, double x1, double y1)
+{
+  double dx = x1 - x0;
+  double dy = y1 - y0;
+  double length_squared = dx*dx + dy*dy;
+  double t = 0;
+  if (length_squared > 0)
+    {
+    t = ((px - x0) * dx + (py - y0) * dy) / length_squared;
+    t = std::max(0.0, std::min(1.0, t));
+    }
+  double ex = x0 + t * dx - px;
+  double ey = y0 + t * dy - py;
+  return std::sqrt(ex*ex + ey*ey);
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------
+
+PolygonLayer::PolygonLayer()
+  : AreaMinX(0)
+  , AreaMinY(0)
+  , AreaMaxX(0)
+  , AreaMaxY(0)
+  , GridWidth(0)
+  , GridHeight(0)
+  , CellWidth(0)
+  , CellHeight(0)
+  , Built(false)
+  , NumThreads(0)
+{
+}
+
+PolygonLayer::feature_id_type PolygonLayer::add_area(std::size_t num_vertices, double const* coordinates)
+{
+  feature_id_type feature = static_cast<feature_id_type>(this->FeatureIsArea.size());
+  this->FeatureIsArea.push_back(1);
+  this->add_edges(feature, num_vertices, coordinates, true);
+  return feature;
+}
+
+void PolygonLayer::add_ring(feature_id_type area, std::size_t num_vertices, double const* coordinates)
+{
+  if (!this->is_area(area))
+    {
+    throw std::invalid_argument("PolygonLayer: rings can only be added to areas");
+    }
+  this->add_edges(area, num_vertices, coordinates, true);
+}
+
+PolygonLayer::feature_id_type PolygonLayer::add_line(std::size_t num_vertices, double const* coordinates)
+{
+  feature_id_type feature = static_cast<feature_id_type>(this->FeatureIsArea.size());
+  this->FeatureIsArea.push_back(0);
+  this->add_edges(feature, num_vertices, coordinates, false);
+  return feature;
+}
+
+void PolygonLayer::add_edges(feature_id_type feature, std::size_t num_vertices,
+                             double const* coordinates, bool closed)
+{
+  if (feature >= std::numeric_limits<std::uint32_t>::max())
+    {
+    throw std::length_error("PolygonLayer: too many features");
+    }
+  this->Built = false;
+
+  std::size_t num_edges = (closed ? num_vertices : (num_vertices > 0 ? num_vertices - 1 : 0));
+  for (std::size_t i = 0; i < num_edges; ++i)
+    {
+    std::size_t j = (i + 1) % num_vertices;
+    Edge edge;
+    edge.X0 = coordinates[2*i];
+    edge.Y0 = coordinates[2*i + 1];
+    edge.X1 = coordinates[2*j];
+    edge.Y1 = coordinates[2*j + 1];
+    edge.Feature = static_cast<std::uint32_t>(feature);
+    edge.IsArea = (closed ? 1 : 0);
+    // Repeated vertices, including the usual repeat of the first
+    // vertex at the end of a ring, give empty edges
+    if (edge.X0 != edge.X1 || edge.Y0 != edge.Y1)
+      {
+      this->Edges.push_back(edge);
+      }
+    }
+}
+
+void PolygonLayer::clear()
+{
+  this->FeatureIsArea.clear();
+  this->Edges.clear();
+  this->Nodes.clear();
+  this->Grid.clear();
+  this->GridWidth = this->GridHeight = 0;
+  this->Built = false;
+}
+
+std::size_t PolygonLayer::num_features() const
+{
+  return this->FeatureIsArea.size();
+}
+
+std::size_t PolygonLayer::num_edges() const
+{
+  return this->Edges.size();
+}
+
+bool PolygonLayer::is_area(feature_id_type feature) const
+{
+  return (feature >= 0
+          && static_cast<std::size_t>(feature) < this->FeatureIsArea.size()
+          && this->FeatureIsArea[static_cast<std::size_t>(feature)] != 0);
+}
+
+bool PolygonLayer::is_built() const
+{
+  return this->Built;
+}
+
+void PolygonLayer::set_num_threads(std::size_t num_threads)
+{
+  this->NumThreads = num_threads;
+}
+
+std::size_t PolygonLayer::num_threads() const
+{
+  return this->NumThreads;
+}
+
+void PolygonLayer::check_built() const
+{
+  if (!this->Built)
+    {
+    throw std::logic_error("PolygonLayer: call build() before querying the layer");
+    }
+}
+
+// ----------------------------------------------------------------------
+
+void PolygonLayer::build(std::size_t grid_resolution)
+{
+  this->build_tree();
+  this->build_grid(grid_resolution);
+  this->Built = true;
+}
+
+// Sort-tile-recursive bulk load: sort edges into vertical slices by
+// x, each slice by y, and pack runs of NODE_CAPACITY into leaves.
+// Each level above packs runs of NODE_CAPACITY nodes from the level
+// below, which are already in slice order.
+void PolygonLayer::build_tree()
+{
+  this->Nodes.clear();
+  std::size_t num_edges = this->Edges.size();
+  if (num_edges == 0)
+    {
+    return;
+    }
+
+  std::size_t num_leaves = (num_edges + NODE_CAPACITY - 1) / NODE_CAPACITY;
+  std::size_t num_slices = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(num_leaves))));
+  std::size_t slice_size = num_slices * NODE_CAPACITY;
+
+  std::sort(this->Edges.begin(), this->Edges.end(),
+            [](Edge const& a, Edge const& b) { return a.X0 + a.X1 < b.X0 + b.X1; });
+  for (std::size_t begin = 0; begin < num_edges; begin += slice_size)
+    {
+    std::size_t end = std::min(num_edges, begin + slice_size);
+    std::sort(this->Edges.begin() + begin, this->Edges.begin() + end,
+              [](Edge const& a, Edge const& b) { return a.Y0 + a.Y1 < b.Y0 + b.Y1; });
+    }
+
+  for (std::size_t begin = 0; begin < num_edges; begin += NODE_CAPACITY)
+    {
+    Node node;
+    node.Begin = static_cast<std::uint32_t>(begin);
+    node.End = static_cast<std::uint32_t>(std::min(num_edges, begin + NODE_CAPACITY));
+    node.IsLeaf = 1;
+    node.Padding = 0;
+    node.MinX = node.MinY = std::numeric_limits<double>::infinity();
+    node.MaxX = node.MaxY = -std::numeric_limits<double>::infinity();
+    for (std::size_t i = node.Begin; i < node.End; ++i)
+      {
+      Edge const& edge = this->Edges[i];
+      node.MinX = std::min(node.MinX, std::min(edge.X0, edge.X1));
+      node.MaxX = std::max(node.MaxX, std::max(edge.X0, edge.X1));
+      node.MinY = std::min(node.MinY, std::min(edge.Y0, edge.Y1));
+      node.MaxY = std::max(node.MaxY, std::max(edge.Y0, edge.Y1));
+      }
+    this->Nodes.push_back(node);
+    }
+
+  std::size_t level_begin = 0;
+  std::size_t level_end = this->Nodes.size();
+  while (level_end - level_begin > 1)
+    {
+    for (std::size_t begin = level_begin; begin < level_end; begin += NODE_CAPACITY)
+      {
+      Node node;
+      node.Begin = static_cast<std::uint32_t>(begin);
+      node.End = static_cast<std::uint32_t>(std::min(level_end, begin + NODE_CAPACITY));
+      node.IsLeaf = 0;
+      node.Padding = 0;
+      node.MinX = node.MinY = std::numeric_limits<double>::infinity();
+      node.MaxX = node.MaxY = -std::numeric_limits<double>::infinity();
+      for (std::size_t i = node.Begin; i < node.End; ++i)
+        {
+        Node const& child = this->Nodes[i];
+        node.MinX = std::min(node.MinX, child.MinX);
+        node.MaxX = std::max(node.MaxX, child.MaxX);
+        node.MinY = std::min(node.MinY, child.MinY);
+        node.MaxY = std::max(node.MaxY, child.MaxY);
+        }
+      this->Nodes.push_back(node);
+      }
+    level_begin = level_end;
+    level_end = this->Nodes.size();
+    }
+}
+
+// Precompute the answer to locate() for every grid cell that no
+// area edge touches.  Within such a cell nothing can separate two
+// points, so one exact test answers for the whole cell.  Better
+// still, nothing separates two such cells that are next to each
+// other in a row, so one exact test answers for a whole run.
+void PolygonLayer::build_grid(std::size_t grid_resolution)
+{
+  this->Grid.clear();
+  this->GridWidth = this->GridHeight = 0;
+
+  bool have_areas = false;
+  this->AreaMinX = this->AreaMinY = std::numeric_limits<double>::infinity();
+  this->AreaMaxX = this->AreaMaxY = -std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < this->Edges.size(); ++i)
+    {
+    Edge const& edge = this->Edges[i];
+    if (edge.IsArea)
+      {
+      have_areas = true;
+      this->AreaMinX = std::min(this->AreaMinX, std::min(edge.X0, edge.X1));
+      this->AreaMaxX = std::max(this->AreaMaxX, std::max(edge.X0, edge.X1));
+      this->AreaMinY = std::min(this->AreaMinY, std::min(edge.Y0, edge.Y1));
+      this->AreaMaxY = std::max(this->AreaMaxY, std::max(edge.Y0, edge.Y1));
+      }
+    }
+  if (!have_areas || grid_resolution == 0)
+    {
+    return;
+    }
+
+  double width = this->AreaMaxX - this->AreaMinX;
+  double height = this->AreaMaxY - this->AreaMinY;
+  double cell_size = std::max(width, height) / static_cast<double>(grid_resolution);
+  if (!(cell_size > 0))
+    {
+    return;
+    }
+  this->GridWidth = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(width / cell_size)));
+  this->GridHeight = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(height / cell_size)));
+  this->CellWidth = width / static_cast<double>(this->GridWidth);
+  this->CellHeight = height / static_cast<double>(this->GridHeight);
+  if (!(this->CellWidth > 0) || !(this->CellHeight > 0))
+    {
+    this->GridWidth = this->GridHeight = 0;
+    return;
+    }
+  this->Grid.assign(this->GridWidth * this->GridHeight, 0);
+
+  // Mark every cell that an area edge's bounding box touches, with
+  // a little slack so that rounding cannot leave an edge out
+  double slack = 1e-9;
+  for (std::size_t i = 0; i < this->Edges.size(); ++i)
+    {
+    Edge const& edge = this->Edges[i];
+    if (!edge.IsArea)
+      {
+      continue;
+      }
+    double low_x = (std::min(edge.X0, edge.X1) - this->AreaMinX) / this->CellWidth - slack;
+    double high_x = (std::max(edge.X0, edge.X1) - this->AreaMinX) / this->CellWidth + slack;
+    double low_y = (std::min(edge.Y0, edge.Y1) - this->AreaMinY) / this->CellHeight - slack;
+    double high_y = (std::max(edge.Y0, edge.Y1) - this->AreaMinY) / this->CellHeight + slack;
+    std::size_t column_begin = static_cast<std::size_t>(std::max(0.0, std::floor(low_x)));
+    std::size_t column_end = std::min(this->GridWidth - 1, static_cast<std::size_t>(std::max(0.0, std::floor(high_x))));
+    std::size_t row_begin = static_cast<std::size_t>(std::max(0.0, std::floor(low_y)));
+    std::size_t row_end = std::min(this->GridHeight - 1, static_cast<std::size_t>(std::max(0.0, std::floor(high_y))));
+    for (std::size_t row = row_begin; row <= row_end; ++row)
+      {
+      for (std::size_t column = column_begin; column <= column_end; ++column)
+        {
+        this->Grid[row * this->GridWidth + column] = MIXED_CELL;
+        }
+      }
+    }
+
+  parallel_for(0, this->GridHeight,
+               [this](std::size_t row) {
+                 std::int32_t* cells = &this->Grid[row * this->GridWidth];
+                 double y = this->AreaMinY + (static_cast<double>(row) + 0.5) * this->CellHeight;
+                 std::size_t column = 0;
+                 while (column < this->GridWidth)
+                   {
+                   if (cells[column] == MIXED_CELL)
+                     {
+                     ++column;
+                     continue;
+                     }
+                   double x = this->AreaMinX + (static_cast<double>(column) + 0.5) * this->CellWidth;
+                   std::int32_t answer = static_cast<std::int32_t>(this->locate_exact(x, y));
+                   for (; column < this->GridWidth && cells[column] != MIXED_CELL; ++column)
+                     {
+                     cells[column] = answer;
+                     }
+                   }
+               },
+               this->NumThreads, 4);
+}
+
+// ----------------------------------------------------------------------
+
+PolygonLayer::feature_id_type PolygonLayer::locate(double longitude, double latitude) const
+{
+  this->check_built();
+  if (!(longitude >= this->AreaMinX && longitude <= this->AreaMaxX
+        && latitude >= this->AreaMinY && latitude <= this->AreaMaxY))
+    {
+    return -1;
+    }
+
+  if (!this->Grid.empty())
+    {
+    std::size_t column = std::min(this->GridWidth - 1,
+                                  static_cast<std::size_t>((longitude - this->AreaMinX) / this->CellWidth));
+    std::size_t row = std::min(this->GridHeight - 1,
+                               static_cast<std::size_t>((latitude - this->AreaMinY) / this->CellHeight));
+    std::int32_t cell = this->Grid[row * this->GridWidth + column];
+    if (cell != MIXED_CELL)
+      {
+      return cell;
+      }
+    }
+  return this->locate_exact(longitude, latitude);
+}
+
+bool PolygonLayer::contains(double longitude, double latitude) const
+{
+  return this->locate(longitude, latitude) >= 0;
+}
+
+// Cast a horizontal ray from the point toward the nearer side of the
+// areas' bounding box and count how often it crosses each area's
+// edges.  Areas crossed an odd number of times contain the point.
+PolygonLayer::feature_id_type PolygonLayer::locate_exact(double x, double y) const
+{
+  if (this->Nodes.empty())
+    {
+    return -1;
+    }
+
+  bool rightward = (this->AreaMaxX - x <= x - this->AreaMinX);
+  double ray_low = (rightward ? x : this->AreaMinX);
+  double ray_high = (rightward ? this->AreaMaxX : x);
+
+  std::vector<std::uint32_t> crossed;
+  std::vector<std::uint32_t> stack(1, static_cast<std::uint32_t>(this->Nodes.size() - 1));
+  while (!stack.empty())
+    {
+    Node const& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (node.MinY > y || node.MaxY < y || node.MaxX < ray_low || node.MinX > ray_high)
+      {
+      continue;
+      }
+    if (!node.IsLeaf)
+      {
+      for (std::uint32_t child = node.Begin; child < node.End; ++child)
+        {
+        stack.push_back(child);
+        }
+      continue;
+      }
+    for (std::uint32_t i = node.Begin; i < node.End; ++i)
+      {
+      Edge const& edge = this->Edges[i];
+      if (!edge.IsArea || ((edge.Y0 > y) == (edge.Y1 > y)))
+        {
+        continue;
+        }
+      double crossing_x = edge.X0 + (y - edge.Y0) * (edge.X1 - edge.X0) / (edge.Y1 - edge.Y0);
+      if (rightward ? (crossing_x > x) : (crossing_x < x))
+        {
+        crossed.push_back(edge.Feature);
+        }
+      }
+    }
+
+  std::sort(crossed.begin(), crossed.end());
+  for (std::size_t i = 0; i < crossed.size(); )
+    {
+    std::size_t j = i;
+    while (j < crossed.size() && crossed[j] == crossed[i])
+      {
+      ++j;
+      }
+    if ((j - i) % 2 == 1)
+      {
+      return crossed[i];
+      }
+    i = j;
+    }
+  return -1;
+}
+
+// ----------------------------------------------------------------------
+
+// Best-first search: visit nodes in order of the smallest distance
+// anything inside them could have.
+double PolygonLayer::distance_to_boundary(double longitude, double latitude, double max_distance) const
+{
+  this->check_built();
+  if (this->Nodes.empty())
+    {
+    return std::numeric_limits<double>::infinity();
+    }
+
+  double scale_x = KM_PER_DEGREE * std::cos(latitude * conversions::constants::RADIANS_PER_DEGREE);
+  double scale_y = KM_PER_DEGREE;
+  double best = std::numeric_limits<double>::infinity();
+
+  auto node_bound = [&](Node const& node) {
+    double gap_y = 0;
+    if (latitude < node.MinY)
+      {
+      gap_y = node.MinY - latitude;
+      }
+    else if (latitude > node.MaxY)
+      {
+      gap_y = latitude - node.MaxY;
+      }
+    double dx = longitude_gap(longitude, node.MinX, node.MaxX) * scale_x;
+    double dy = gap_y * scale_y;
+    return std::sqrt(dx*dx + dy*dy);
+  };
+
+  typedef std::pair<double, std::uint32_t> entry_type;
+  std::priority_queue<entry_type, std::vector<entry_type>, std::greater<entry_type> > queue;
+  std::uint32_t root = static_cast<std::uint32_t>(this->Nodes.size() - 1);
+  queue.push(entry_type(node_bound(this->Nodes[root]), root));
+
+  while (!queue.empty())
+    {
+    entry_type next = queue.top();
+    queue.pop();
+    if (next.first >= best || next.first > max_distance)
+      {
+      break;
+      }
+    Node const& node = this->Nodes[next.second];
+    if (!node.IsLeaf)
+      {
+      for (std::uint32_t child = node.Begin; child < node.End; ++child)
+        {
+        double bound = node_bound(this->Nodes[child]);
+        if (bound < best && bound <= max_distance)
+          {
+          queue.push(entry_type(bound, child));
+          }
+        }
+      continue;
+      }
+    for (std::uint32_t i = node.Begin; i < node.End; ++i)
+      {
+      Edge const& edge = this->Edges[i];
+      double middle = 0.5 * (edge.X0 + edge.X1);
+      double query_x = longitude + 360.0 * std::round((middle - longitude) / 360.0);
+      double distance = point_segment_distance(
+        query_x * scale_x, latitude * scale_y,
+        edge.X0 * scale_x, edge.Y0 * scale_y,
+        edge.X1 * scale_x, edge.Y1 * scale_y);
+      best = std::min(best, distance);
+      }
+    }
+
+  return (best <= max_distance ? best : std::numeric_limits<double>::infinity());
+}
+
+// ----------------------------------------------------------------------
+
+std::size_t PolygonLayer::count_crossings(double longitude0, double latitude0,
+                                          double longitude1, double latitude1) const
+{
+  this->check_built();
+  if (longitude1 - longitude0 > 180)
+    {
+    return this->crossings_in_tree(longitude0, latitude0, longitude1 - 360, latitude1)
+      + this->crossings_in_tree(longitude0 + 360, latitude0, longitude1, latitude1);
+    }
+  else if (longitude0 - longitude1 > 180)
+    {
+    return this->crossings_in_tree(longitude0, latitude0, longitude1 + 360, latitude1)
+      + this->crossings_in_tree(longitude0 - 360, latitude0, longitude1, latitude1);
+    }
+  return this->crossings_in_tree(longitude0, latitude0, longitude1, latitude1);
+}
+
+// An edge counts as crossed when the segment meets it anywhere from
+// its first vertex up to but not including its last, so a segment
+// through a vertex shared by two edges counts once.
+std::size_t PolygonLayer::crossings_in_tree(double x0, double y0, double x1, double y1) const
+{
+  if (this->Nodes.empty() || (x0 == x1 && y0 == y1))
+    {
+    return 0;
+    }
+
+  double min_x = std::min(x0, x1), max_x = std::max(x0, x1);
+  double min_y = std::min(y0, y1), max_y = std::max(y0, y1);
+  double rx = x1 - x0, ry = y1 - y0;
+
+  std::size_t crossings = 0;
+  std::vector<std::uint32_t> stack(1, static_cast<std::uint32_t>(this->Nodes.size() - 1));
+  while (!stack.empty())
+    {
+    Node const& node = this->Nodes[stack.back()];
+    stack.pop_back();
+    if (node.MinX > max_x || node.MaxX < min_x || node.MinY > max_y || node.MaxY < min_y)
+      {
+      continue;
+      }
+    if (!node.IsLeaf)
+      {
+      for (std::uint32_t child = node.Begin; child < node.End; ++child)
+        {
+        stack.push_back(child);
+        }
+      continue;
+      }
+    for (std::uint32_t i = node.Begin; i < node.End; ++i)
+      {
+      Edge const& edge = this->Edges[i];
+      double sx = edge.X1 - edge.X0, sy = edge.Y1 - edge.Y0;
+      double denominator = rx * sy - ry * sx;
+      if (denominator == 0)
+        {
+        continue;
+        }
+      double qx = edge.X0 - x0, qy = edge.Y0 - y0;
+      double t = (qx * sy - qy * sx) / denominator;
+      double u = (qx * ry - qy * rx) / denominator;
+      if (t >= 0 && t <= 1 && u >= 0 && u < 1)
+        {
+        ++crossings;
+        }
+      }
+    }
+  return crossings;
+}
+
+// ----------------------------------------------------------------------
+
+void PolygonLayer::locate(std::size_t num_points,
+                          double const* longitudes,
+                          double const* latitudes,
+                          feature_id_type* features) const
+{
+  this->check_built();
+  parallel_for(0, num_points,
+               [&, this](std::size_t i) { features[i] = this->locate(longitudes[i], latitudes[i]); },
+               this->NumThreads, 256);
+}
+
+void PolygonLayer::distance_to_boundary(std::size_t num_points,
+                                        double const* longitudes,
+                                        double const* latitudes,
+                                        double* distances,
+                                        double max_distance) const
+{
+  this->check_built();
+  parallel_for(0, num_points,
+               [&, this](std::size_t i) {
+                 distances[i] = this->distance_to_boundary(longitudes[i], latitudes[i], max_distance);
+               },
+               this->NumThreads, 64);
+}
+
+} // namespace tracktable
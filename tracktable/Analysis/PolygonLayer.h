@@ -0,0 +1,325 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/PolygonLayer.h - Point-in-polygon, distance to
+ * boundary and boundary crossings against a layer of polygons and
+ * lines in longitude/latitude
+ *
+ * Shorelines, lakes and political borders come to us as thousands
+ * of rings and lines with millions of vertices.  Testing every point
+ * of every trajectory against them one shape at a time is hopeless.
+ * A PolygonLayer puts every edge into one packed R-tree and, for
+ * point-in-polygon, precomputes a grid that answers most points
+ * without looking at a single edge.
+ */
+
+#ifndef __tracktable_PolygonLayer_h
+#define __tracktable_PolygonLayer_h
+
+#include <tracktable/Analysis/TracktableAnalysisWindowsHeader.h>
+#include <tracktable/Core/ParallelFor.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tracktable {
+
+/**
+ * @class PolygonLayer
+ * @brief Spatial queries against a fixed set of polygons and lines
+ *
+ * A layer holds two kinds of feature, both in longitude/latitude
+ * degrees:
+ *
+ * - Areas: one or more closed rings.  A point is inside an area if
+ *   it is inside an odd number of the area's rings, so holes are
+ *   just extra rings.
+ * - Lines: open polylines such as borders or rivers.  Lines have
+ *   edges for distance and crossing queries but no inside.
+ *
+ * Features are numbered from 0 in the order they are added.  Once
+ * every feature is in, call build().  After that the layer cannot
+ * be changed, and all queries are const and safe to call from
+ * several threads at once.
+ *
+ * Geometry is planar in longitude/latitude, as it is in the
+ * shapefiles these layers usually come from, except that distances
+ * are reported in kilometers (see distance_to_boundary()) and
+ * segments longer than 180 degrees of longitude are taken to cross
+ * the antimeridian.
+ *
+ * @code
+ * tracktable::PolygonLayer land;
+ * for (auto const& ring : shoreline_rings)
+ *   {
+ *   land.add_area(ring.size(), ring.data());
+ *   }
+ * land.build();
+ *
+ * std::vector<double> over_land(land.fraction_inside(trajectories.begin(), trajectories.end()));
+ * @endcode
+ */
+class TRACKTABLE_ANALYSIS_EXPORT PolygonLayer
+{
+public:
+  typedef std::int64_t feature_id_type;
+
+  PolygonLayer();
+
+  /** Add an area with a single ring
+   *
+   * The ring may or may not repeat its first vertex at the end.
+   *
+   * @param [in] num_vertices  Number of vertices
+   * @param [in] coordinates   2 * num_vertices values: lon, lat, lon, lat, ...
+   * @return ID of the new feature
+   */
+  feature_id_type add_area(std::size_t num_vertices, double const* coordinates);
+
+  /** Add another ring (usually a hole) to an existing area
+   *
+   * @param [in] area          ID returned by add_area()
+   * @param [in] num_vertices  Number of vertices
+   * @param [in] coordinates   2 * num_vertices values: lon, lat, lon, lat, ...
+   */
+  void add_ring(feature_id_type area, std::size_t num_vertices, double const* coordinates);
+
+  /** Add an open polyline
+   *
+   * @return ID of the new feature
+   */
+  feature_id_type add_line(std::size_t num_vertices, double const* coordinates);
+
+  /** Build the search structures
+   *
+   * @param [in] grid_resolution  Number of grid cells along the longer
+   *   side of the areas' bounding box.  More cells answer more
+   *   point-in-polygon queries without touching edges at the cost
+   *   of 4 bytes per cell.  0 disables the grid.
+   */
+  void build(std::size_t grid_resolution=1024);
+
+  /// Has build() been called since the last change?
+  bool is_built() const;
+
+  /// Remove every feature
+  void clear();
+
+  std::size_t num_features() const;
+  std::size_t num_edges() const;
+
+  /// Is this feature an area (true) or a line (false)?
+  bool is_area(feature_id_type feature) const;
+
+  /// Number of threads for batch queries; 0 means default_thread_count()
+  void set_num_threads(std::size_t num_threads);
+
+  std::size_t num_threads() const;
+
+  // ---------------------------------------------------------------
+  // Single queries
+
+  /** Find the area that contains a point
+   *
+   * If areas overlap, the one with the lowest ID wins.
+   *
+   * @return Area ID, or -1 if the point is not in any area
+   */
+  feature_id_type locate(double longitude, double latitude) const;
+
+  bool contains(double longitude, double latitude) const;
+
+  /** Distance from a point to the nearest edge of any feature
+   *
+   * The distance is measured in kilometers in a local equirectangular
+   * projection centered on the query point.  That is within a
+   * fraction of a percent of the great-circle distance out to a few
+   * hundred kilometers, which is the range these queries are for.
+   *
+   * @param [in] longitude     Query longitude
+   * @param [in] latitude      Query latitude
+   * @param [in] max_distance  Stop looking past this distance (km)
+   * @return Distance in km, or infinity if nothing is within max_distance
+   */
+  double distance_to_boundary(double longitude, double latitude,
+                              double max_distance=std::numeric_limits<double>::infinity()) const;
+
+  /// Number of edges that the segment between two points crosses
+  std::size_t count_crossings(double longitude0, double latitude0,
+                              double longitude1, double latitude1) const;
+
+  // ---------------------------------------------------------------
+  // Batch queries over arrays of points, run in parallel
+
+  void locate(std::size_t num_points,
+              double const* longitudes,
+              double const* latitudes,
+              feature_id_type* features) const;
+
+  void distance_to_boundary(std::size_t num_points,
+                            double const* longitudes,
+                            double const* latitudes,
+                            double* distances,
+                            double max_distance=std::numeric_limits<double>::infinity()) const;
+
+  // ---------------------------------------------------------------
+  // Trajectory queries
+
+  /// Fraction of a trajectory's points that are inside some area (0 if empty)
+  template<typename TrajectoryT>
+  double fraction_inside(TrajectoryT const& trajectory) const
+    {
+      if (trajectory.empty())
+        {
+        return 0;
+        }
+      std::size_t inside = 0;
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        if (this->locate(trajectory[i][0], trajectory[i][1]) >= 0)
+          {
+          ++inside;
+          }
+        }
+      return static_cast<double>(inside) / static_cast<double>(trajectory.size());
+    }
+
+  /// Number of edges crossed by a trajectory's segments
+  template<typename TrajectoryT>
+  std::size_t count_crossings(TrajectoryT const& trajectory) const
+    {
+      std::size_t crossings = 0;
+      for (std::size_t i = 1; i < trajectory.size(); ++i)
+        {
+        crossings += this->count_crossings(trajectory[i-1][0], trajectory[i-1][1],
+                                           trajectory[i][0], trajectory[i][1]);
+        }
+      return crossings;
+    }
+
+  /** Fraction of points inside some area for every trajectory in a collection
+   *
+   * The collection may hold trajectories or pointers to them.
+   * Trajectories are processed in parallel.
+   */
+  template<typename iterator_type>
+  std::vector<double> fraction_inside(iterator_type begin, iterator_type end) const
+    {
+      std::vector<decltype(address_of(*begin))> paths;
+      for (; begin != end; ++begin)
+        {
+        paths.push_back(address_of(*begin));
+        }
+      std::vector<double> result(paths.size());
+      parallel_for(0, paths.size(),
+                   [&, this](std::size_t i) { result[i] = this->fraction_inside(*paths[i]); },
+                   this->NumThreads, 1);
+      return result;
+    }
+
+  /** Number of boundary crossings for every trajectory in a collection
+   *
+   * The collection may hold trajectories or pointers to them.
+   * Trajectories are processed in parallel.
+   */
+  template<typename iterator_type>
+  std::vector<std::size_t> count_crossings(iterator_type begin, iterator_type end) const
+    {
+      std::vector<decltype(address_of(*begin))> paths;
+      for (; begin != end; ++begin)
+        {
+        paths.push_back(address_of(*begin));
+        }
+      std::vector<std::size_t> result(paths.size());
+      parallel_for(0, paths.size(),
+                   [&, this](std::size_t i) { result[i] = this->count_crossings(*paths[i]); },
+                   this->NumThreads, 1);
+      return result;
+    }
+
+private:
+  struct Edge
+  {
+    double X0, Y0, X1, Y1;
+    std::uint32_t Feature;
+    std::uint32_t IsArea;
+  };
+
+  // Packed R-tree node.  Leaves cover Edges[Begin, End); interior
+  // nodes cover Nodes[Begin, End).  The root is the last node.
+  struct Node
+  {
+    double MinX, MinY, MaxX, MaxY;
+    std::uint32_t Begin;
+    std::uint32_t End;
+    std::uint32_t IsLeaf;
+    std::uint32_t Padding;
+  };
+
+  template<typename T>
+  static T const* address_of(T const& thing)
+    {
+      return &thing;
+    }
+
+  template<typename T>
+  static T const* address_of(T const* thing)
+    {
+      return thing;
+    }
+
+  void add_edges(feature_id_type feature, std::size_t num_vertices,
+                 double const* coordinates, bool closed);
+  void build_tree();
+  void build_grid(std::size_t grid_resolution);
+  void check_built() const;
+
+  feature_id_type locate_exact(double x, double y) const;
+  std::size_t crossings_in_tree(double x0, double y0, double x1, double y1) const;
+
+  std::vector<std::uint8_t> FeatureIsArea;
+  std::vector<Edge> Edges;
+  std::vector<Node> Nodes;
+
+  // Point-in-polygon grid over AreaMinX..AreaMaxX, AreaMinY..AreaMaxY
+  double AreaMinX, AreaMinY, AreaMaxX, AreaMaxY;
+  std::size_t GridWidth, GridHeight;
+  double CellWidth, CellHeight;
+  std::vector<std::int32_t> Grid;
+
+  bool Built;
+  std::size_t NumThreads;
+};
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,825 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/PortalDiscovery.h - Find origin/destination
+ * portal pairs in a collection of trajectories
+ *
+ * A portal is a box on the map.  A portal pair is two boxes with many
+ * trajectories that travel more or less directly from one to the
+ * other.  We find them by dividing a bounding box into a coarse grid,
+ * scoring every pair of populated cells, and then repeatedly
+ * subdividing the cells in the pairs that score well.
+ */
+
+#ifndef __tracktable_PortalDiscovery_h
+#define __tracktable_PortalDiscovery_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Core/detail/algorithm_signatures/Distance.h>
+
+#include <boost/geometry/core/cs.hpp>
+#include <boost/geometry/geometries/box.hpp>
+#include <boost/cstdint.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+namespace detail {
+
+template<typename trajectory_type>
+trajectory_type const& portal_input_trajectory(trajectory_type const& trajectory)
+{
+  return trajectory;
+}
+
+template<typename trajectory_type>
+trajectory_type const& portal_input_trajectory(std::shared_ptr<trajectory_type> const& trajectory)
+{
+  return *trajectory;
+}
+
+template<typename trajectory_type>
+trajectory_type const& portal_input_trajectory(trajectory_type const* trajectory)
+{
+  return *trajectory;
+}
+
+// Longitude wraps at +/-180 only for points in degrees on the sphere
+template<typename point_type>
+struct portal_longitude_wraps
+  : std::is_same<
+      typename boost::geometry::cs_tag<point_type>::type,
+      boost::geometry::spherical_equatorial_tag
+    >
+{ };
+
+} // namespace detail
+
+/**
+ * @class PortalDiscovery
+ * @brief Hierarchical search for origin/destination portal pairs
+ *
+ * The search area is a box in coordinate space (longitude/latitude for
+ * terrestrial trajectories).  It is first divided
+ * into `x_divisions` by `y_divisions` cells.  Those cells are level 1.
+ * Each further level divides a cell into `subdivisions` by
+ * `subdivisions` children until the requested depth is reached.
+ *
+ * The value of a pair of portals is the number of trajectories that
+ * pass through both of them and that travel from one to the other
+ * along a path no longer than `straightness` times the distance
+ * between the point where they leave the first portal and the point
+ * where they enter the second.  Only pairs whose value is at least
+ * `minimum_value` are refined further.
+ *
+ * Every trajectory is rasterized once onto the finest grid when the
+ * search starts.  From then on, deciding whether a trajectory touches
+ * a cell at any level is an integer comparison against the cells it
+ * was binned into; there are no further geometric intersection tests.
+ * Binning, subdivision and pair scoring for each level all run in
+ * parallel.
+ *
+ * When refinement is done we take the pair with the highest value
+ * times separation, remove its contributing trajectories from
+ * consideration, rescore the remaining pairs and repeat until no pair
+ * has enough value left.  A pair whose centers are no more than
+ * `minimum_separation` apart is not reported, but its trajectories
+ * are removed all the same.  Separations are in the domain's distance
+ * units: km for terrestrial trajectories.
+ *
+ * Segments are rasterized as straight lines in coordinate space.  For
+ * terrestrial trajectories the search area must not cross the
+ * antimeridian; segments that jump more than 180 degrees in longitude
+ * only mark the cells that contain their endpoints.
+ *
+ * Example:
+ *
+ * @code
+ * typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+ * typedef trajectory_type::point_type point_type;
+ *
+ * tracktable::PortalDiscovery<trajectory_type> portals(
+ *    point_type(-125, 25), point_type(-65, 50), 12, 5);
+ * portals.set_depth(5);
+ * portals.set_minimum_value(16);
+ *
+ * std::vector<tracktable::PortalDiscovery<trajectory_type>::portal_pair_type> pairs =
+ *    portals.find_portal_pairs(trajectories.begin(), trajectories.end());
+ * @endcode
+ */
+template<typename TrajectoryT>
+class PortalDiscovery
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef boost::geometry::model::box<point_type> box_type;
+
+  /// One origin/destination pair reported by find_portal_pairs()
+  struct portal_pair_type
+  {
+    /// Portal with the larger number of trajectories passing through it
+    box_type first_portal;
+    /// The other end of the pair
+    box_type second_portal;
+    /// Number of trajectories that travel between the two portals
+    std::size_t value;
+    /// Distance between the centers of the two portals
+    double separation;
+    /// Positions in the input sequence of the contributing trajectories
+    std::vector<std::size_t> contributors;
+  };
+
+  /** Set up a search over a longitude/latitude box.
+   *
+   * @param [in] min_corner   Southwest corner of the search area
+   * @param [in] max_corner   Northeast corner of the search area
+   * @param [in] x_divisions  Number of level-1 cells in longitude
+   * @param [in] y_divisions  Number of level-1 cells in latitude
+   */
+  PortalDiscovery(point_type const& min_corner,
+                  point_type const& max_corner,
+                  std::size_t x_divisions=12,
+                  std::size_t y_divisions=5)
+    : MinCorner(min_corner)
+    , MaxCorner(max_corner)
+    , XDivisions(x_divisions)
+    , YDivisions(y_divisions)
+    , Subdivisions(2)
+    , Depth(5)
+    , MinimumValue(16)
+    , MinimumSeparation(1000)
+    , Straightness(1.01)
+    , MaximumPairs(0)
+    , NumThreads(0)
+    , GridWidth(0)
+    , GridHeight(0)
+    , CellWidth(0)
+    , CellHeight(0)
+    {
+      if (x_divisions == 0 || y_divisions == 0)
+        {
+        throw std::invalid_argument("PortalDiscovery: number of divisions must be positive");
+        }
+      if (!(max_corner[0] > min_corner[0] && max_corner[1] > min_corner[1]))
+        {
+        throw std::invalid_argument("PortalDiscovery: max_corner must be northeast of min_corner");
+        }
+    }
+
+  /// Number of levels of refinement, including the first grid (default 5)
+  void set_depth(std::size_t depth)
+    {
+      if (depth == 0)
+        {
+        throw std::invalid_argument("PortalDiscovery: depth must be at least 1");
+        }
+      this->Depth = depth;
+    }
+
+  std::size_t depth() const
+    {
+      return this->Depth;
+    }
+
+  /// Number of children along each axis when a portal is refined (default 2)
+  void set_subdivisions(std::size_t subdivisions)
+    {
+      if (subdivisions < 2)
+        {
+        throw std::invalid_argument("PortalDiscovery: subdivisions must be at least 2");
+        }
+      this->Subdivisions = subdivisions;
+    }
+
+  std::size_t subdivisions() const
+    {
+      return this->Subdivisions;
+    }
+
+  /// Minimum number of trajectories for a pair to be kept (default 16)
+  void set_minimum_value(std::size_t value)
+    {
+      this->MinimumValue = value;
+    }
+
+  std::size_t minimum_value() const
+    {
+      return this->MinimumValue;
+    }
+
+  /// Minimum distance between portal centers in a reported pair (default 1000, in km for terrestrial points)
+  void set_minimum_separation(double separation)
+    {
+      this->MinimumSeparation = separation;
+    }
+
+  double minimum_separation() const
+    {
+      return this->MinimumSeparation;
+    }
+
+  /// How much longer than the direct route a contributing path may be (default 1.01)
+  void set_straightness(double ratio)
+    {
+      this->Straightness = ratio;
+    }
+
+  double straightness() const
+    {
+      return this->Straightness;
+    }
+
+  /// Stop after reporting this many pairs; 0 means no limit (default 0)
+  void set_maximum_pairs(std::size_t count)
+    {
+      this->MaximumPairs = count;
+    }
+
+  std::size_t maximum_pairs() const
+    {
+      return this->MaximumPairs;
+    }
+
+  /// Number of threads to use; 0 means default_thread_count() (default 0)
+  void set_num_threads(std::size_t num_threads)
+    {
+      this->NumThreads = num_threads;
+    }
+
+  std::size_t num_threads() const
+    {
+      return this->NumThreads;
+    }
+
+  /** Find portal pairs in a sequence of trajectories.
+   *
+   * The iterators may refer to trajectories, to pointers to
+   * trajectories or to `std::shared_ptr`s to trajectories.
+   * Contributors in the results are positions in this sequence.
+   * Pairs are returned in the order they were extracted, best first.
+   *
+   * @param [in] begin  Start of the trajectory sequence
+   * @param [in] end    End of the trajectory sequence
+   */
+  template<typename iterator_type>
+  std::vector<portal_pair_type> find_portal_pairs(iterator_type begin, iterator_type end)
+    {
+      std::vector<trajectory_type const*> trajectories;
+      for (; begin != end; ++begin)
+        {
+        trajectories.push_back(&detail::portal_input_trajectory(*begin));
+        }
+
+      this->setup_grid();
+      this->Bins.clear();
+      this->Bins.resize(trajectories.size());
+      this->Portals.clear();
+
+      parallel_for(0, trajectories.size(),
+                   [this, &trajectories](std::size_t i) {
+                     this->bin_trajectory(*trajectories[i], this->Bins[i]);
+                   },
+                   this->NumThreads);
+
+      Portal root;
+      root.X0 = 0;
+      root.Y0 = 0;
+      root.X1 = static_cast<boost::uint32_t>(this->GridWidth);
+      root.Y1 = static_cast<boost::uint32_t>(this->GridHeight);
+      for (std::size_t i = 0; i < this->Bins.size(); ++i)
+        {
+        if (!this->Bins[i].Cells.empty())
+          {
+          root.Members.push_back(i);
+          }
+        }
+      this->Portals.push_back(root);
+
+      std::vector<char> removed(trajectories.size(), 0);
+      std::vector<PairCandidate> pairs;
+
+      this->divide_portals(std::vector<std::size_t>(1, 0), this->XDivisions, this->YDivisions);
+      this->add_sibling_pairs(0, pairs);
+      this->score_pairs(pairs, removed);
+
+      for (std::size_t level = 2; level <= this->Depth; ++level)
+        {
+        std::vector<std::size_t> to_divide;
+        for (std::size_t i = 0; i < pairs.size(); ++i)
+          {
+          to_divide.push_back(pairs[i].First);
+          to_divide.push_back(pairs[i].Second);
+          }
+        std::sort(to_divide.begin(), to_divide.end());
+        to_divide.erase(std::unique(to_divide.begin(), to_divide.end()), to_divide.end());
+
+        this->divide_portals(to_divide, this->Subdivisions, this->Subdivisions);
+
+        std::vector<PairCandidate> refined;
+        for (std::size_t i = 0; i < pairs.size(); ++i)
+          {
+          std::vector<std::size_t> const& first_children(this->Portals[pairs[i].First].Children);
+          std::vector<std::size_t> const& second_children(this->Portals[pairs[i].Second].Children);
+          for (std::size_t a = 0; a < first_children.size(); ++a)
+            {
+            for (std::size_t b = 0; b < second_children.size(); ++b)
+              {
+              refined.push_back(this->make_pair_candidate(first_children[a], second_children[b]));
+              }
+            }
+          }
+        for (std::size_t i = 0; i < to_divide.size(); ++i)
+          {
+          this->add_sibling_pairs(to_divide[i], refined);
+          }
+
+        this->score_pairs(refined, removed);
+        pairs.swap(refined);
+        }
+
+      std::vector<portal_pair_type> result;
+      while (!pairs.empty()
+             && (this->MaximumPairs == 0 || result.size() < this->MaximumPairs))
+        {
+        typename std::vector<PairCandidate>::iterator best =
+          std::max_element(pairs.begin(), pairs.end(),
+                           [](PairCandidate const& a, PairCandidate const& b) {
+                             return a.Value * a.Separation < b.Value * b.Separation;
+                           });
+
+        // A pair that is too close together is not reported, but its
+        // trajectories are still used up so that they cannot prop up
+        // a neighboring pair.
+        portal_pair_type found;
+        found.first_portal = this->Portals[best->First].Box;
+        found.second_portal = this->Portals[best->Second].Box;
+        found.separation = best->Separation;
+        found.value = this->pair_value(*best, removed, &found.contributors);
+        for (std::size_t i = 0; i < found.contributors.size(); ++i)
+          {
+          removed[found.contributors[i]] = 1;
+          }
+        if (found.separation > this->MinimumSeparation)
+          {
+          result.push_back(found);
+          }
+
+        *best = pairs.back();
+        pairs.pop_back();
+        this->score_pairs(pairs, removed);
+        }
+
+      this->Bins.clear();
+      this->Portals.clear();
+      return result;
+    }
+
+private:
+  // A run of consecutive segments that touch the same finest-level cell
+  struct CellRun
+  {
+    boost::uint32_t X;
+    boost::uint32_t Y;
+    boost::uint32_t FirstSegment;
+    boost::uint32_t LastSegment;
+  };
+
+  struct TrajectoryBins
+  {
+    trajectory_type const* Trajectory;
+    std::vector<CellRun> Cells;
+    std::vector<double> DistanceAlong;
+  };
+
+  // A portal covers finest-level cells [X0, X1) x [Y0, Y1)
+  struct Portal
+  {
+    boost::uint32_t X0, Y0, X1, Y1;
+    box_type Box;
+    point_type Center;
+    std::vector<std::size_t> Members;
+    std::vector<std::size_t> Children;
+  };
+
+  struct PairCandidate
+  {
+    std::size_t First;
+    std::size_t Second;
+    std::size_t Value;
+    double Separation;
+  };
+
+  point_type MinCorner;
+  point_type MaxCorner;
+  std::size_t XDivisions;
+  std::size_t YDivisions;
+  std::size_t Subdivisions;
+  std::size_t Depth;
+  std::size_t MinimumValue;
+  double MinimumSeparation;
+  double Straightness;
+  std::size_t MaximumPairs;
+  std::size_t NumThreads;
+
+  std::size_t GridWidth;
+  std::size_t GridHeight;
+  double CellWidth;
+  double CellHeight;
+  std::vector<TrajectoryBins> Bins;
+  std::vector<Portal> Portals;
+
+  void setup_grid()
+    {
+      std::size_t scale = 1;
+      for (std::size_t level = 1; level < this->Depth; ++level)
+        {
+        scale *= this->Subdivisions;
+        }
+      this->GridWidth = this->XDivisions * scale;
+      this->GridHeight = this->YDivisions * scale;
+      this->CellWidth = (this->MaxCorner[0] - this->MinCorner[0]) / this->GridWidth;
+      this->CellHeight = (this->MaxCorner[1] - this->MinCorner[1]) / this->GridHeight;
+    }
+
+  // Rasterize every segment of a trajectory onto the finest grid
+  void bin_trajectory(trajectory_type const& trajectory, TrajectoryBins& bins) const
+    {
+      bins.Trajectory = &trajectory;
+      bins.Cells.clear();
+      bins.DistanceAlong.clear();
+      if (trajectory.size() < 2)
+        {
+        return;
+        }
+
+      bins.DistanceAlong.reserve(trajectory.size());
+      bins.DistanceAlong.push_back(0);
+      for (std::size_t i = 1; i < trajectory.size(); ++i)
+        {
+        bins.DistanceAlong.push_back(bins.DistanceAlong.back()
+                                     + ::tracktable::distance(trajectory[i-1], trajectory[i]));
+        }
+
+      for (std::size_t i = 0; i + 1 < trajectory.size(); ++i)
+        {
+        double x0 = (trajectory[i][0] - this->MinCorner[0]) / this->CellWidth;
+        double y0 = (trajectory[i][1] - this->MinCorner[1]) / this->CellHeight;
+        double x1 = (trajectory[i+1][0] - this->MinCorner[0]) / this->CellWidth;
+        double y1 = (trajectory[i+1][1] - this->MinCorner[1]) / this->CellHeight;
+        boost::uint32_t segment = static_cast<boost::uint32_t>(i);
+
+        if (detail::portal_longitude_wraps<point_type>::value
+            && std::abs(trajectory[i+1][0] - trajectory[i][0]) > 180)
+          {
+          this->add_cell(bins, std::floor(x0), std::floor(y0), segment);
+          this->add_cell(bins, std::floor(x1), std::floor(y1), segment);
+          }
+        else
+          {
+          this->traverse_segment(bins, x0, y0, x1, y1, segment);
+          }
+        }
+    }
+
+  // Walk the grid cells crossed by a segment given in cell coordinates.
+  // This is the usual Amanatides-Woo voxel traversal.
+  void traverse_segment(TrajectoryBins& bins,
+                        double x0, double y0, double x1, double y1,
+                        boost::uint32_t segment) const
+    {
+      double width = static_cast<double>(this->GridWidth);
+      double height = static_cast<double>(this->GridHeight);
+      if ((x0 < 0 && x1 < 0) || (y0 < 0 && y1 < 0)
+          || (x0 >= width && x1 >= width) || (y0 >= height && y1 >= height))
+        {
+        return;
+        }
+
+      double cell_x = std::floor(x0);
+      double cell_y = std::floor(y0);
+      double end_x = std::floor(x1);
+      double end_y = std::floor(y1);
+      double dx = x1 - x0;
+      double dy = y1 - y0;
+      double infinity = std::numeric_limits<double>::infinity();
+
+      double step_x = (dx > 0 ? 1 : (dx < 0 ? -1 : 0));
+      double step_y = (dy > 0 ? 1 : (dy < 0 ? -1 : 0));
+      double next_x = (dx == 0 ? infinity :
+                       (dx > 0 ? cell_x + 1 - x0 : x0 - cell_x) / std::abs(dx));
+      double next_y = (dy == 0 ? infinity :
+                       (dy > 0 ? cell_y + 1 - y0 : y0 - cell_y) / std::abs(dy));
+      double delta_x = (dx == 0 ? infinity : 1 / std::abs(dx));
+      double delta_y = (dy == 0 ? infinity : 1 / std::abs(dy));
+
+      std::size_t num_steps = static_cast<std::size_t>(std::abs(end_x - cell_x) + std::abs(end_y - cell_y));
+      this->add_cell(bins, cell_x, cell_y, segment);
+      for (std::size_t step = 0; step < num_steps; ++step)
+        {
+        if (next_x < next_y)
+          {
+          cell_x += step_x;
+          next_x += delta_x;
+          }
+        else
+          {
+          cell_y += step_y;
+          next_y += delta_y;
+          }
+        this->add_cell(bins, cell_x, cell_y, segment);
+        }
+    }
+
+  void add_cell(TrajectoryBins& bins, double x, double y, boost::uint32_t segment) const
+    {
+      if (x < 0 || y < 0
+          || x >= static_cast<double>(this->GridWidth)
+          || y >= static_cast<double>(this->GridHeight))
+        {
+        return;
+        }
+
+      boost::uint32_t cell_x = static_cast<boost::uint32_t>(x);
+      boost::uint32_t cell_y = static_cast<boost::uint32_t>(y);
+      if (!bins.Cells.empty() && bins.Cells.back().X == cell_x && bins.Cells.back().Y == cell_y)
+        {
+        bins.Cells.back().LastSegment = segment;
+        }
+      else
+        {
+        CellRun run;
+        run.X = cell_x;
+        run.Y = cell_y;
+        run.FirstSegment = segment;
+        run.LastSegment = segment;
+        bins.Cells.push_back(run);
+        }
+    }
+
+  static bool contains(Portal const& portal, CellRun const& run)
+    {
+      return (run.X >= portal.X0 && run.X < portal.X1
+              && run.Y >= portal.Y0 && run.Y < portal.Y1);
+    }
+
+  // Split each of the given portals into x_count by y_count children
+  // and sort the parent's members into them using the binned cells.
+  // Only children that some trajectory touches are kept.
+  void divide_portals(std::vector<std::size_t> const& parents,
+                      std::size_t x_count, std::size_t y_count)
+    {
+      std::vector<std::vector<Portal> > children(parents.size());
+
+      parallel_for(0, parents.size(),
+                   [&, this](std::size_t i) {
+                     Portal const& parent(this->Portals[parents[i]]);
+                     boost::uint32_t width = static_cast<boost::uint32_t>((parent.X1 - parent.X0) / x_count);
+                     boost::uint32_t height = static_cast<boost::uint32_t>((parent.Y1 - parent.Y0) / y_count);
+
+                     std::vector<Portal> subdivided(x_count * y_count);
+                     std::vector<char> touched(x_count * y_count, 0);
+                     std::vector<std::size_t> touched_list;
+
+                     for (std::size_t m = 0; m < parent.Members.size(); ++m)
+                       {
+                       std::size_t member = parent.Members[m];
+                       std::vector<CellRun> const& cells(this->Bins[member].Cells);
+                       for (std::size_t c = 0; c < cells.size(); ++c)
+                         {
+                         if (!contains(parent, cells[c]))
+                           {
+                           continue;
+                           }
+                         std::size_t child = ((cells[c].X - parent.X0) / width)
+                           + x_count * ((cells[c].Y - parent.Y0) / height);
+                         if (!touched[child])
+                           {
+                           touched[child] = 1;
+                           touched_list.push_back(child);
+                           subdivided[child].Members.push_back(member);
+                           }
+                         }
+                       for (std::size_t t = 0; t < touched_list.size(); ++t)
+                         {
+                         touched[touched_list[t]] = 0;
+                         }
+                       touched_list.clear();
+                       }
+
+                     for (std::size_t y = 0; y < y_count; ++y)
+                       {
+                       for (std::size_t x = 0; x < x_count; ++x)
+                         {
+                         Portal& child(subdivided[x + x_count * y]);
+                         if (child.Members.empty())
+                           {
+                           continue;
+                           }
+                         child.X0 = static_cast<boost::uint32_t>(parent.X0 + x * width);
+                         child.Y0 = static_cast<boost::uint32_t>(parent.Y0 + y * height);
+                         child.X1 = child.X0 + width;
+                         child.Y1 = child.Y0 + height;
+                         this->set_geometry(child);
+                         children[i].push_back(std::move(child));
+                         }
+                       }
+                   },
+                   this->NumThreads, 1);
+
+      for (std::size_t i = 0; i < parents.size(); ++i)
+        {
+        for (std::size_t c = 0; c < children[i].size(); ++c)
+          {
+          this->Portals[parents[i]].Children.push_back(this->Portals.size());
+          this->Portals.push_back(std::move(children[i][c]));
+          }
+        }
+    }
+
+  void set_geometry(Portal& portal) const
+    {
+      point_type low(this->MinCorner);
+      point_type high(this->MinCorner);
+      low[0] = this->MinCorner[0] + portal.X0 * this->CellWidth;
+      low[1] = this->MinCorner[1] + portal.Y0 * this->CellHeight;
+      high[0] = this->MinCorner[0] + portal.X1 * this->CellWidth;
+      high[1] = this->MinCorner[1] + portal.Y1 * this->CellHeight;
+      portal.Box = box_type(low, high);
+      portal.Center = low;
+      portal.Center[0] = 0.5 * (low[0] + high[0]);
+      portal.Center[1] = 0.5 * (low[1] + high[1]);
+    }
+
+  PairCandidate make_pair_candidate(std::size_t first, std::size_t second) const
+    {
+      // Keep the portal with more trajectories first
+      if (this->Portals[first].Members.size() < this->Portals[second].Members.size())
+        {
+        std::swap(first, second);
+        }
+      PairCandidate pair;
+      pair.First = first;
+      pair.Second = second;
+      pair.Value = 0;
+      pair.Separation = ::tracktable::distance(this->Portals[first].Center,
+                                               this->Portals[second].Center);
+      return pair;
+    }
+
+  void add_sibling_pairs(std::size_t parent, std::vector<PairCandidate>& pairs) const
+    {
+      std::vector<std::size_t> const& children(this->Portals[parent].Children);
+      for (std::size_t a = 0; a < children.size(); ++a)
+        {
+        for (std::size_t b = a + 1; b < children.size(); ++b)
+          {
+          pairs.push_back(this->make_pair_candidate(children[a], children[b]));
+          }
+        }
+    }
+
+  // Compute the value of every pair in parallel and drop the ones
+  // that fall below the minimum.
+  void score_pairs(std::vector<PairCandidate>& pairs, std::vector<char> const& removed) const
+    {
+      parallel_for(0, pairs.size(),
+                   [&, this](std::size_t i) {
+                     pairs[i].Value = this->pair_value(pairs[i], removed, 0);
+                   },
+                   this->NumThreads);
+
+      pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+                                 [this](PairCandidate const& pair) {
+                                   return pair.Value < this->MinimumValue;
+                                 }),
+                  pairs.end());
+    }
+
+  std::size_t pair_value(PairCandidate const& pair,
+                         std::vector<char> const& removed,
+                         std::vector<std::size_t>* contributors) const
+    {
+      Portal const& first(this->Portals[pair.First]);
+      Portal const& second(this->Portals[pair.Second]);
+      std::vector<std::size_t>::const_iterator a = first.Members.begin();
+      std::vector<std::size_t>::const_iterator b = second.Members.begin();
+      std::size_t value = 0;
+
+      while (a != first.Members.end() && b != second.Members.end())
+        {
+        if (*a < *b)
+          {
+          ++a;
+          }
+        else if (*b < *a)
+          {
+          ++b;
+          }
+        else
+          {
+          if (!removed[*a] && this->travels_between(this->Bins[*a], first, second))
+            {
+            ++value;
+            if (contributors)
+              {
+              contributors->push_back(*a);
+              }
+            }
+          ++a;
+          ++b;
+          }
+        }
+      return value;
+    }
+
+  // Find the innermost stretch of the trajectory that goes from one
+  // portal to the other and check that it is close to direct.
+  bool travels_between(TrajectoryBins const& bins, Portal const& first, Portal const& second) const
+    {
+      int previous = 0;
+      std::size_t last_in_first = 0;
+      std::size_t last_in_second = 0;
+      std::size_t start = 0;
+      std::size_t finish = 0;
+      bool found = false;
+
+      for (std::size_t i = 0; i < bins.Cells.size(); ++i)
+        {
+        CellRun const& run(bins.Cells[i]);
+        if (contains(first, run))
+          {
+          if (previous == 2)
+            {
+            start = last_in_second;
+            finish = run.FirstSegment + 1;
+            found = true;
+            }
+          last_in_first = run.LastSegment;
+          previous = 1;
+          }
+        else if (contains(second, run))
+          {
+          if (previous == 1)
+            {
+            start = last_in_first;
+            finish = run.FirstSegment + 1;
+            found = true;
+            }
+          last_in_second = run.LastSegment;
+          previous = 2;
+          }
+        }
+
+      if (!found)
+        {
+        return false;
+        }
+
+      double path_length = bins.DistanceAlong[finish] - bins.DistanceAlong[start];
+      double direct = ::tracktable::distance((*bins.Trajectory)[start], (*bins.Trajectory)[finish]);
+      return path_length < this->Straightness * direct;
+    }
+};
+
+} // namespace tracktable
+
+#endif
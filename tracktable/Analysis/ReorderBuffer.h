@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/ReorderBuffer.h - Put slightly late points back
+ * into time order
+ *
+ * AssembleTrajectories expects points sorted by timestamp.  Feeds
+ * merged from several receivers are almost sorted: each point shows
+ * up at most a few minutes after it should have.  Rather than sort a
+ * whole day of data before assembling it, run the points through a
+ * ReorderBuffer, which holds each one just long enough to be sure
+ * nothing earlier is still on its way.
+ */
+
+#ifndef __tracktable_ReorderBuffer_h
+#define __tracktable_ReorderBuffer_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/Timestamp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+/**
+ * @class ReorderBuffer
+ * @brief Bounded-lateness reordering for a stream of points
+ *
+ * Push points in the order they arrive and pop them in timestamp
+ * order.  The buffer keeps a *watermark*: the latest timestamp seen
+ * so far minus the maximum lateness.  A point can be popped once its
+ * timestamp is at or before the watermark, since any point that
+ * belongs before it would have arrived by then.
+ *
+ * A point that arrives with a timestamp before the watermark is too
+ * late to put back in order.  It is dropped and counted.  A point that
+ * arrives out of order but in time is counted as late and released in
+ * its proper place.  Points with equal timestamps come out in the
+ * order they went in, so the points of each object stay in order.
+ *
+ * The buffer holds at most a maximum lateness's worth of points.  You
+ * can also cap it at a number of points.  When it is full the oldest
+ * point is released early and the watermark moves up to it, which
+ * turns some late points into dropped ones but keeps memory bounded
+ * during bursts.
+ *
+ * Call `flush()` at the end of the input to release everything that
+ * is left.
+ */
+template<typename PointT>
+class ReorderBuffer
+{
+public:
+  typedef PointT point_type;
+
+  /** Create a buffer
+   *
+   * @param [in] maximum_lateness  Longest a point can be delayed and still be put back in order
+   * @param [in] maximum_size      Largest number of points to hold; 0 for no limit
+   */
+  ReorderBuffer(Duration const& maximum_lateness=seconds(0),
+                std::size_t maximum_size=0)
+    : MaximumLateness(maximum_lateness)
+    , MaximumSize(maximum_size)
+    , NextSequence(0)
+    , LatePointCount(0)
+    , DroppedPointCount(0)
+    , LatestTimestamp(no_such_timestamp())
+    , Watermark(no_such_timestamp())
+    { }
+
+  Duration maximum_lateness() const
+    {
+      return this->MaximumLateness;
+    }
+
+  std::size_t maximum_size() const
+    {
+      return this->MaximumSize;
+    }
+
+  /// Number of points waiting to be popped
+  std::size_t size() const
+    {
+      return this->Heap.size();
+    }
+
+  bool empty() const
+    {
+      return this->Heap.empty();
+    }
+
+  /** Earliest timestamp that can still be accepted
+   *
+   * This is not a date/time until the first point arrives.
+   */
+  Timestamp watermark() const
+    {
+      return this->Watermark;
+    }
+
+  /// Number of points that arrived out of order but in time
+  std::size_t late_point_count() const
+    {
+      return this->LatePointCount;
+    }
+
+  /// Number of points that arrived too late and were thrown away
+  std::size_t dropped_point_count() const
+    {
+      return this->DroppedPointCount;
+    }
+
+  /// Discard all buffered points and counters
+  void clear()
+    {
+      this->Heap.clear();
+      this->NextSequence = 0;
+      this->LatePointCount = 0;
+      this->DroppedPointCount = 0;
+      this->LatestTimestamp = no_such_timestamp();
+      this->Watermark = no_such_timestamp();
+    }
+
+  /** Add a point to the buffer
+   *
+   * @param [in] point  Next point in arrival order
+   * @return False if the point was too late and was dropped
+   */
+  bool push(point_type const& point)
+    {
+      Timestamp when(point.timestamp());
+      if (!this->Watermark.is_special() && when < this->Watermark)
+        {
+        ++this->DroppedPointCount;
+        return false;
+        }
+
+      if (this->LatestTimestamp.is_special() || when > this->LatestTimestamp)
+        {
+        this->LatestTimestamp = when;
+        this->raise_watermark(when - this->MaximumLateness);
+        }
+      else if (when < this->LatestTimestamp)
+        {
+        ++this->LatePointCount;
+        }
+
+      this->Heap.push_back(Entry(when, this->NextSequence++, point));
+      std::push_heap(this->Heap.begin(), this->Heap.end(), EntryAfter());
+
+      if (this->MaximumSize > 0 && this->Heap.size() > this->MaximumSize)
+        {
+        this->raise_watermark(this->Heap.front().When);
+        }
+      return true;
+    }
+
+  /** Take the earliest point if it is ready
+   *
+   * @param [out] point  Earliest buffered point
+   * @return True if a point was at or before the watermark
+   */
+  bool pop(point_type& point)
+    {
+      if (this->Heap.empty() || this->Heap.front().When > this->Watermark)
+        {
+        return false;
+        }
+      std::pop_heap(this->Heap.begin(), this->Heap.end(), EntryAfter());
+      point = std::move(this->Heap.back().Point);
+      this->Heap.pop_back();
+      return true;
+    }
+
+  /** Make every buffered point ready to pop
+   *
+   * Call this at the end of the input.  The watermark moves up to the
+   * latest timestamp seen, so points pushed afterward are accepted
+   * only if they are no earlier than that.
+   */
+  void flush()
+    {
+      if (!this->LatestTimestamp.is_special())
+        {
+        this->raise_watermark(this->LatestTimestamp);
+        }
+    }
+
+private:
+  struct Entry
+  {
+    Entry(Timestamp const& when, std::size_t sequence, point_type const& point)
+      : When(when), Sequence(sequence), Point(point)
+      { }
+
+    Timestamp When;
+    std::size_t Sequence;
+    point_type Point;
+  };
+
+  // Heap order: the earliest timestamp, then the earliest arrival,
+  // is at the front
+  struct EntryAfter
+  {
+    bool operator()(Entry const& a, Entry const& b) const
+      {
+        if (a.When != b.When)
+          {
+          return (a.When > b.When);
+          }
+        return (a.Sequence > b.Sequence);
+      }
+  };
+
+  void raise_watermark(Timestamp const& when)
+    {
+      if (this->Watermark.is_special() || when > this->Watermark)
+        {
+        this->Watermark = when;
+        }
+    }
+
+  Duration MaximumLateness;
+  std::size_t MaximumSize;
+  std::vector<Entry> Heap;
+  std::size_t NextSequence;
+  std::size_t LatePointCount;
+  std::size_t DroppedPointCount;
+  Timestamp LatestTimestamp;
+  Timestamp Watermark;
+};
+
+} // namespace tracktable
+
+#endif
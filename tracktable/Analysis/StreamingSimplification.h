@@ -0,0 +1,326 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/StreamingSimplification.h - Time-aware
+ * trajectory simplification one point at a time
+ *
+ * tracktable::simplify() runs Douglas-Peucker on the shape of a
+ * finished trajectory and ignores time, so a simplified track can
+ * put an object in the wrong place at a given moment.  The
+ * simplifier here measures error in time as well as space and only
+ * ever looks at the points since the last one it decided to keep, so
+ * it can run while trajectories are still being assembled.
+ */
+
+#ifndef __tracktable_StreamingSimplification_h
+#define __tracktable_StreamingSimplification_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Core/Timestamp.h>
+#include <tracktable/Core/detail/algorithm_signatures/Distance.h>
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace tracktable {
+
+/// How StreamingSimplifier decides whether a point can be dropped
+enum class SimplificationMetric {
+  /** A point can be dropped if the kept points on either side,
+   * interpolated to its timestamp, put the object within the
+   * tolerance of where it really was.  This bounds the error of
+   * point_at_time() at every original timestamp.
+   */
+  SYNCHRONIZED_EUCLIDEAN_DISTANCE,
+  /** A point can be dropped if the velocity at the last kept point
+   * predicts the next point to within the tolerance.  This is cheaper
+   * (constant work per point) but only bounds the prediction error.
+   */
+  DEAD_RECKONING,
+};
+
+/**
+ * @class StreamingSimplifier
+ * @brief Opening-window simplification for one trajectory as it grows
+ *
+ * Append points through the simplifier instead of calling
+ * `push_back` on the trajectory.  The trajectory holds the points that
+ * have been kept plus the window of points since the last kept point
+ * (the anchor).  When a new point arrives we check whether the
+ * window can still be described by a straight, constant-speed run
+ * from the anchor to the new point.  If it cannot, the newest point
+ * in the window becomes the new anchor and the points in between are
+ * erased.  Call `finish()` once the trajectory is complete to drop
+ * whatever the final window allows.
+ *
+ * The window never grows beyond `max_window` points.  When it is full
+ * the newest point is kept regardless, which bounds memory and work
+ * per point.
+ *
+ * Distances are measured with tracktable::distance() and positions
+ * are interpolated with the domain's own point interpolation, so this
+ * works in every domain.  For terrestrial points the tolerance is in
+ * kilometers.
+ *
+ * One simplifier tracks one trajectory.  Call `reset()` (or use a new
+ * simplifier) before starting another.
+ */
+template<typename TrajectoryT>
+class StreamingSimplifier
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef typename point_type::Superclass generic_trajectory_point_type;
+  typedef typename generic_trajectory_point_type::Superclass base_point_type;
+
+  /** Create a simplifier
+   *
+   * @param [in] tolerance   Largest error allowed for a dropped point; 0 keeps every point
+   * @param [in] metric      How to measure the error
+   * @param [in] max_window  Largest number of points held since the last kept point
+   */
+  StreamingSimplifier(double tolerance=0,
+                      SimplificationMetric metric=SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE,
+                      std::size_t max_window=64)
+    : Tolerance(tolerance)
+    , Metric(metric)
+    , MaxWindow(max_window == 0 ? 1 : max_window)
+    , Anchor(0)
+    , PointsAppended(0)
+    { }
+
+  double tolerance() const
+    {
+      return this->Tolerance;
+    }
+
+  SimplificationMetric metric() const
+    {
+      return this->Metric;
+    }
+
+  std::size_t max_window() const
+    {
+      return this->MaxWindow;
+    }
+
+  /// Number of points appended since construction or the last reset()
+  std::size_t points_appended() const
+    {
+      return this->PointsAppended;
+    }
+
+  /// Forget the current trajectory
+  void reset()
+    {
+      this->Anchor = 0;
+      this->PointsAppended = 0;
+    }
+
+  /** Add a point to the end of a trajectory
+   *
+   * Points in the window that are no longer needed are erased from
+   * the trajectory.
+   *
+   * @param [in,out] trajectory  Trajectory being built
+   * @param [in]     point       Next point in time order
+   */
+  void append(trajectory_type& trajectory, point_type const& point)
+    {
+      if (this->Tolerance > 0 && !trajectory.empty())
+        {
+        if (this->Anchor >= trajectory.size())
+          {
+          this->Anchor = trajectory.size() - 1;
+          }
+        std::size_t window = trajectory.size() - this->Anchor - 1;
+        if (window > 0
+            && (window >= this->MaxWindow || !this->window_fits(trajectory, point)))
+          {
+          this->keep_last_point(trajectory);
+          }
+        }
+      trajectory.push_back(point);
+      ++this->PointsAppended;
+    }
+
+  /** Drop the points that the final window allows
+   *
+   * Call this once no more points will be appended.
+   *
+   * @param [in,out] trajectory  Trajectory being built
+   */
+  void finish(trajectory_type& trajectory)
+    {
+      if (this->Tolerance > 0 && !trajectory.empty())
+        {
+        if (this->Anchor >= trajectory.size())
+          {
+          this->Anchor = trajectory.size() - 1;
+          }
+        this->keep_last_point(trajectory);
+        }
+    }
+
+private:
+  double Tolerance;
+  SimplificationMetric Metric;
+  std::size_t MaxWindow;
+  std::size_t Anchor;
+  std::size_t PointsAppended;
+
+  // Erase everything between the anchor and the last point and make
+  // the last point the new anchor
+  void keep_last_point(trajectory_type& trajectory)
+    {
+      if (trajectory.size() > this->Anchor + 2)
+        {
+        trajectory.erase(trajectory.begin() + this->Anchor + 1, trajectory.end() - 1);
+        }
+      this->Anchor = trajectory.size() - 1;
+    }
+
+  static double time_fraction(point_type const& start,
+                              point_type const& finish,
+                              Timestamp const& when)
+    {
+      double span = static_cast<double>((finish.timestamp() - start.timestamp()).total_microseconds());
+      if (span == 0)
+        {
+        return 0;
+        }
+      return static_cast<double>((when - start.timestamp()).total_microseconds()) / span;
+    }
+
+  bool window_fits(trajectory_type const& trajectory, point_type const& point) const
+    {
+      point_type const& anchor(trajectory[this->Anchor]);
+
+      if (this->Metric == SimplificationMetric::DEAD_RECKONING)
+        {
+        point_type const& heading(trajectory[this->Anchor + 1]);
+        base_point_type predicted(
+          algorithms::extrapolate<base_point_type>::apply(
+            static_cast<base_point_type const&>(anchor),
+            static_cast<base_point_type const&>(heading),
+            time_fraction(anchor, heading, point.timestamp())));
+        return (::tracktable::distance(predicted, static_cast<base_point_type const&>(point))
+                <= this->Tolerance);
+        }
+
+      for (std::size_t i = this->Anchor + 1; i < trajectory.size(); ++i)
+        {
+        base_point_type synchronized(
+          algorithms::interpolate<base_point_type>::apply(
+            static_cast<base_point_type const&>(anchor),
+            static_cast<base_point_type const&>(point),
+            time_fraction(anchor, point, trajectory[i].timestamp())));
+        if (::tracktable::distance(synchronized, static_cast<base_point_type const&>(trajectory[i]))
+            > this->Tolerance)
+          {
+          return false;
+          }
+        }
+      return true;
+    }
+};
+
+/** Simplify a finished trajectory with the streaming simplifier
+ *
+ * The result is exactly what the assembler would produce with the
+ * same simplification settings.  Like simplify(), the result is a new
+ * trajectory with the original's properties.
+ *
+ * @param [in] trajectory  Trajectory to simplify
+ * @param [in] tolerance   Largest error allowed for a dropped point
+ * @param [in] metric      How to measure the error
+ * @param [in] max_window  Largest number of points held since the last kept point
+ * @return Simplified copy of the trajectory
+ */
+template<typename trajectory_type>
+trajectory_type simplify_in_time(
+  trajectory_type const& trajectory,
+  double tolerance,
+  SimplificationMetric metric=SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE,
+  std::size_t max_window=64)
+{
+  StreamingSimplifier<trajectory_type> simplifier(tolerance, metric, max_window);
+  trajectory_type result(trajectory.begin(), trajectory.begin(), trajectory);
+  for (std::size_t i = 0; i < trajectory.size(); ++i)
+    {
+    simplifier.append(result, trajectory[i]);
+    }
+  simplifier.finish(result);
+  return result;
+}
+
+/** Simplify every trajectory in a collection in parallel
+ *
+ * @param [in] begin        Start of the trajectory sequence
+ * @param [in] end          End of the trajectory sequence
+ * @param [in] tolerance    Largest error allowed for a dropped point
+ * @param [in] metric       How to measure the error
+ * @param [in] max_window   Largest number of points held since the last kept point
+ * @param [in] num_threads  Number of threads; 0 means default_thread_count()
+ * @return Simplified copies in the same order as the input
+ */
+template<typename iterator_type>
+std::vector<typename std::iterator_traits<iterator_type>::value_type>
+simplify_in_time(
+  iterator_type begin,
+  iterator_type end,
+  double tolerance,
+  SimplificationMetric metric=SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE,
+  std::size_t max_window=64,
+  std::size_t num_threads=0)
+{
+  typedef typename std::iterator_traits<iterator_type>::value_type trajectory_type;
+  std::vector<trajectory_type const*> input;
+  for (; begin != end; ++begin)
+    {
+    input.push_back(&(*begin));
+    }
+
+  std::vector<trajectory_type> result(input.size(), trajectory_type(false));
+  parallel_for(0, input.size(),
+               [&](std::size_t i) {
+                 result[i] = simplify_in_time(*input[i], tolerance, metric, max_window);
+               },
+               num_threads, 1);
+  return result;
+}
+
+} // namespace tracktable
+
+#endif
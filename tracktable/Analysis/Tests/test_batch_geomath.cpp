@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/BatchGeomath.h>
+#include <tracktable/Core/Trajectory.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_type terrestrial_trajectory;
+typedef tracktable::domain::cartesian2d::trajectory_type cartesian2d_trajectory;
+typedef tracktable::domain::cartesian3d::trajectory_type cartesian3d_trajectory;
+
+// ----------------------------------------------------------------------
+
+// Build a wandering path with irregular timestamps (including one
+// repeated timestamp) and fill in its flat coordinate and time arrays
+
+template<typename TrajectoryT>
+TrajectoryT make_path(std::size_t num_points, double step,
+                      std::vector<double>& coordinates,
+                      std::vector<double>& timestamps)
+{
+  typedef typename TrajectoryT::point_type point_type;
+  const std::size_t dimension = tracktable::traits::dimension<point_type>::value;
+
+  std::mt19937 generator(1234);
+  std::uniform_real_distribution<double> jitter(-step, step);
+  std::uniform_int_distribution<int> seconds(1, 120);
+
+  TrajectoryT path;
+  point_type point;
+  for (std::size_t d = 0; d < dimension; ++d)
+    {
+    point[d] = 10.0 * d;
+    }
+  tracktable::Timestamp start = tracktable::time_from_string("2020-01-01 00:00:00");
+  tracktable::Timestamp when = start;
+
+  coordinates.clear();
+  timestamps.clear();
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    for (std::size_t d = 0; d < dimension; ++d)
+      {
+      point[d] += jitter(generator);
+      coordinates.push_back(point[d]);
+      }
+    if (i != num_points / 2)
+      {
+      when += tracktable::seconds(seconds(generator));
+      }
+    point.set_timestamp(when);
+    timestamps.push_back(static_cast<double>((when - start).total_seconds()));
+    path.push_back(point);
+    }
+  return path;
+}
+
+int check_close(std::string const& what, std::size_t i, double expected, double actual,
+                double tolerance=1e-9)
+{
+  if (std::abs(expected - actual) > tolerance * (1.0 + std::abs(expected)))
+    {
+    std::cerr << "ERROR: " << what << " " << i << ": expected "
+              << expected << ", got " << actual << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+// ----------------------------------------------------------------------
+
+// Every batch result must agree with the scalar algorithm applied to
+// the same points
+
+template<typename TrajectoryT>
+int test_against_scalar(std::string const& name, double step)
+{
+  typedef typename tracktable::traits::domain<typename TrajectoryT::point_type>::type domain_type;
+
+  int error_count = 0;
+  std::vector<double> coordinates, timestamps;
+  TrajectoryT path(make_path<TrajectoryT>(500, step, coordinates, timestamps));
+  const std::size_t n = path.size();
+  const std::size_t dimension = coordinates.size() / n;
+
+  std::vector<double> lengths(n - 1), speeds(n - 1), pairwise(n - 1);
+  tracktable::batch::segment_lengths<domain_type>(n, coordinates.data(), lengths.data());
+  tracktable::batch::segment_speeds<domain_type>(n, coordinates.data(), timestamps.data(), speeds.data());
+  tracktable::batch::distances<domain_type>(n - 1, coordinates.data(),
+                                            coordinates.data() + dimension, pairwise.data());
+
+  for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+    double expected_length = tracktable::distance(path[i], path[i+1]);
+    error_count += check_close(name + " segment length", i, expected_length, lengths[i]);
+    error_count += check_close(name + " distance", i, expected_length, pairwise[i]);
+    error_count += check_close(name + " speed", i,
+                               tracktable::speed_between(path[i], path[i+1]), speeds[i]);
+    }
+
+  std::vector<double> from_trajectory;
+  tracktable::batch::segment_speeds(path, from_trajectory);
+  if (from_trajectory.size() != n - 1)
+    {
+    std::cerr << "ERROR: " << name << ": trajectory speeds have length "
+              << from_trajectory.size() << "\n";
+    ++error_count;
+    }
+  else
+    {
+    for (std::size_t i = 0; i + 1 < n; ++i)
+      {
+      error_count += check_close(name + " trajectory speed", i, speeds[i], from_trajectory[i]);
+      }
+    }
+
+  return error_count;
+}
+
+template<typename TrajectoryT>
+int test_angles_against_scalar(std::string const& name, double step)
+{
+  typedef typename tracktable::traits::domain<typename TrajectoryT::point_type>::type domain_type;
+
+  int error_count = 0;
+  std::vector<double> coordinates, timestamps;
+  TrajectoryT path(make_path<TrajectoryT>(500, step, coordinates, timestamps));
+  const std::size_t n = path.size();
+
+  std::vector<double> headings(n - 1);
+  tracktable::batch::segment_bearings<domain_type>(n, coordinates.data(), headings.data());
+  for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+    error_count += check_close(name + " bearing", i,
+                               tracktable::bearing(path[i], path[i+1]), headings[i]);
+    }
+
+  std::vector<double> turns;
+  tracktable::batch::signed_turn_angles(path, turns);
+  if (turns.size() != n - 2)
+    {
+    std::cerr << "ERROR: " << name << ": expected " << n - 2 << " turn angles, got "
+              << turns.size() << "\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_terrestrial_turn_angles()
+{
+  int error_count = 0;
+  std::vector<double> coordinates, timestamps;
+  terrestrial_trajectory path(make_path<terrestrial_trajectory>(200, 0.5, coordinates, timestamps));
+
+  std::vector<double> turns;
+  tracktable::batch::signed_turn_angles(path, turns);
+  for (std::size_t i = 0; i < turns.size(); ++i)
+    {
+    error_count += check_close("terrestrial turn angle", i,
+                               tracktable::signed_turn_angle(path[i], path[i+1], path[i+2]),
+                               turns[i], 1e-7);
+    }
+  return error_count;
+}
+
+int test_cartesian2d_turn_angles()
+{
+  // Go east, turn left to go north, then turn right to go east again
+  const double points[] = { 0, 0,  1, 0,  1, 1,  2, 1 };
+  const double pi = tracktable::conversions::constants::PI;
+  double turns[2];
+
+  tracktable::batch::signed_turn_angles<tracktable::traits::domains::cartesian2d>(4, points, turns);
+  return (check_close("cartesian2d left turn", 0, 0.5 * pi, turns[0])
+          + check_close("cartesian2d right turn", 1, -0.5 * pi, turns[1]));
+}
+
+int test_short_paths()
+{
+  int error_count = 0;
+  terrestrial_trajectory empty;
+  std::vector<double> result(5, 1.0);
+
+  tracktable::batch::segment_lengths(empty, result);
+  if (!result.empty())
+    {
+    std::cerr << "ERROR: empty trajectory has " << result.size() << " segment lengths\n";
+    ++error_count;
+    }
+
+  terrestrial_trajectory two_points;
+  two_points.push_back(terrestrial_trajectory::point_type(0, 0));
+  two_points.push_back(terrestrial_trajectory::point_type(1, 0));
+  tracktable::batch::signed_turn_angles(two_points, result);
+  if (!result.empty())
+    {
+    std::cerr << "ERROR: two-point trajectory has " << result.size() << " turn angles\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+int test_ecef()
+{
+  typedef terrestrial_trajectory::point_type point_type;
+  typedef tracktable::domain::terrestrial::AltitudeUnits units_type;
+
+  int error_count = 0;
+  std::vector<terrestrial_trajectory> storage;
+  for (std::size_t t = 0; t < 5; ++t)
+    {
+    std::vector<double> coordinates, timestamps;
+    storage.push_back(make_path<terrestrial_trajectory>(20 + 7 * t, 0.5, coordinates, timestamps));
+    for (std::size_t i = 0; i < storage.back().size(); ++i)
+      {
+      storage.back()[i].set_property("altitude", 1000.0 * static_cast<double>(i));
+      if (t != 3 || i != 2)
+        {
+        storage.back()[i].set_property("height", 1.0);
+        }
+      }
+    }
+  std::vector<terrestrial_trajectory const*> paths;
+  for (std::size_t t = 0; t < storage.size(); ++t)
+    {
+    paths.push_back(&storage[t]);
+    }
+
+  std::vector<double> coordinates;
+  std::vector<std::size_t> trajectory_index;
+  tracktable::batch::ecef_coordinates(paths, "altitude", units_type::FEET,
+                                      coordinates, trajectory_index, 3);
+
+  std::size_t next = 0;
+  for (std::size_t t = 0; t < storage.size(); ++t)
+    {
+    for (std::size_t i = 0; i < storage[t].size(); ++i, ++next)
+      {
+      point_type const& point = storage[t][i];
+      tracktable::domain::cartesian3d::base_point_type expected(point.ECEF_from_feet("altitude"));
+      if (trajectory_index[next] != t)
+        {
+        std::cerr << "ERROR: ECEF point " << next << " belongs to trajectory "
+                  << t << ", not " << trajectory_index[next] << "\n";
+        ++error_count;
+        }
+      for (std::size_t d = 0; d < 3; ++d)
+        {
+        error_count += check_close("ECEF coordinate", next, expected[d], coordinates[3*next + d]);
+        }
+      }
+    }
+  if (3 * next != coordinates.size() || next != trajectory_index.size())
+    {
+    std::cerr << "ERROR: expected " << next << " ECEF points, got "
+              << trajectory_index.size() << "\n";
+    ++error_count;
+    }
+
+  // One point has no "height"
+  try
+    {
+    tracktable::batch::ecef_coordinates(paths, "height", units_type::METERS,
+                                        coordinates, trajectory_index, 3);
+    std::cerr << "ERROR: missing altitude did not throw\n";
+    ++error_count;
+    }
+  catch (tracktable::domain::terrestrial::PropertyDoesNotExist const&)
+    {
+    }
+
+  // With no altitude property every point sits on the ellipsoid
+  tracktable::batch::ecef_coordinates(paths, "", units_type::FEET,
+                                      coordinates, trajectory_index, 3);
+  tracktable::domain::cartesian3d::base_point_type surface(storage[3][2].ECEF());
+  std::size_t index = storage[0].size() + storage[1].size() + storage[2].size() + 2;
+  for (std::size_t d = 0; d < 3; ++d)
+    {
+    error_count += check_close("surface ECEF coordinate", index, surface[d], coordinates[3*index + d]);
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  error_count += test_against_scalar<terrestrial_trajectory>("terrestrial", 0.5);
+  error_count += test_against_scalar<cartesian2d_trajectory>("cartesian2d", 5.0);
+  error_count += test_against_scalar<cartesian3d_trajectory>("cartesian3d", 5.0);
+  error_count += test_angles_against_scalar<terrestrial_trajectory>("terrestrial", 0.5);
+  error_count += test_angles_against_scalar<cartesian2d_trajectory>("cartesian2d", 5.0);
+  error_count += test_terrestrial_turn_angles();
+  error_count += test_cartesian2d_turn_angles();
+  error_count += test_short_paths();
+  error_count += test_ecef();
+
+  return error_count;
+}
@@ -0,0 +1,364 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/Gazetteer.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef tracktable::Gazetteer::id_type id_type;
+typedef tracktable::Gazetteer::match_type match_type;
+typedef tracktable::domain::terrestrial::base_point_type point_type;
+
+struct Places
+{
+  std::vector<double> Longitudes;
+  std::vector<double> Latitudes;
+  std::vector<id_type> Ids;
+};
+
+// Mostly uniform over the globe, with a dense cluster that straddles
+// the antimeridian and a few places right at the poles.
+Places make_places(std::size_t count, unsigned int seed)
+{
+  Places places;
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<double> unit(0, 1);
+  for (std::size_t i = 0; i < count; ++i)
+    {
+    double lon, lat;
+    if (i % 4 == 0)
+      {
+      lon = 179.0 + 2.0 * unit(rng);
+      if (lon > 180) lon -= 360;
+      lat = -17.0 + 2.0 * unit(rng);
+      }
+    else
+      {
+      lon = -180 + 360 * unit(rng);
+      lat = std::asin(2 * unit(rng) - 1) * 180 / 3.141592653589793;
+      }
+    places.Longitudes.push_back(lon);
+    places.Latitudes.push_back(lat);
+    places.Ids.push_back(static_cast<id_type>(1000 + 7 * i));
+    }
+  places.Longitudes.push_back(0); places.Latitudes.push_back(90); places.Ids.push_back(1);
+  places.Longitudes.push_back(45); places.Latitudes.push_back(-90); places.Ids.push_back(2);
+  return places;
+}
+
+double brute_distance(Places const& places, std::size_t i, double lon, double lat)
+{
+  return tracktable::distance(point_type(places.Longitudes[i], places.Latitudes[i]),
+                              point_type(lon, lat));
+}
+
+std::vector<match_type> brute_within(Places const& places, double lon, double lat, double radius)
+{
+  std::vector<match_type> result;
+  for (std::size_t i = 0; i < places.Ids.size(); ++i)
+    {
+    double d = brute_distance(places, i, lon, lat);
+    if (d <= radius)
+      {
+      result.push_back(match_type(places.Ids[i], d));
+      }
+    }
+  std::sort(result.begin(), result.end(),
+            [](match_type const& a, match_type const& b) { return a.second < b.second; });
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+int test_queries(tracktable::Gazetteer const& gazetteer, Places const& places)
+{
+  int error_count = 0;
+  std::vector<std::pair<double, double> > queries;
+  queries.push_back(std::make_pair(-180.0, -16.0));
+  queries.push_back(std::make_pair(179.9, -16.5));
+  queries.push_back(std::make_pair(0.0, 89.99));
+  queries.push_back(std::make_pair(-106.6, 35.0));
+  queries.push_back(std::make_pair(12.5, -89.0));
+  std::mt19937 rng(99);
+  std::uniform_real_distribution<double> unit(0, 1);
+  for (int i = 0; i < 40; ++i)
+    {
+    queries.push_back(std::make_pair(-180 + 360 * unit(rng), -90 + 180 * unit(rng)));
+    }
+
+  for (std::size_t q = 0; q < queries.size(); ++q)
+    {
+    double lon = queries[q].first;
+    double lat = queries[q].second;
+    std::vector<match_type> expected(brute_within(places, lon, lat, 50000));
+
+    std::vector<match_type> nearest(gazetteer.find_nearest(lon, lat, 5));
+    if (nearest.size() != 5)
+      {
+      std::cerr << "ERROR: Expected 5 nearest places, got " << nearest.size() << "\n";
+      ++error_count;
+      continue;
+      }
+    for (std::size_t i = 0; i < nearest.size(); ++i)
+      {
+      if (std::fabs(nearest[i].second - expected[i].second) > 1e-6)
+        {
+        std::cerr << "ERROR: Query (" << lon << ", " << lat << "): neighbor " << i
+                  << " is at " << nearest[i].second << " km, brute force says "
+                  << expected[i].second << " km\n";
+        ++error_count;
+        break;
+        }
+      }
+
+    double radius = 25 + 500 * unit(rng);
+    std::vector<match_type> within(gazetteer.find_within_radius(lon, lat, radius));
+    std::vector<match_type> brute(brute_within(places, lon, lat, radius));
+    if (within.size() != brute.size())
+      {
+      std::cerr << "ERROR: Query (" << lon << ", " << lat << "): " << within.size()
+                << " places within " << radius << " km, brute force found " << brute.size() << "\n";
+      ++error_count;
+      }
+    }
+
+  // Limits on nearest-neighbor distance
+  std::vector<match_type> limited(gazetteer.find_nearest(-106.6, 35.0, 1000, 300));
+  std::vector<match_type> brute(brute_within(places, -106.6, 35.0, 300));
+  if (limited.size() != brute.size())
+    {
+    std::cerr << "ERROR: Expected " << brute.size() << " places within the distance limit, got "
+              << limited.size() << "\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int check_box(tracktable::Gazetteer const& gazetteer, Places const& places,
+              double min_lon, double min_lat, double max_lon, double max_lat)
+{
+  std::vector<id_type> expected;
+  for (std::size_t i = 0; i < places.Ids.size(); ++i)
+    {
+    double lon = places.Longitudes[i];
+    double lat = places.Latitudes[i];
+    bool lon_inside = (min_lon <= max_lon)
+      ? (lon >= min_lon && lon <= max_lon)
+      : (lon >= min_lon || lon <= max_lon);
+    if (lon_inside && lat >= min_lat && lat <= max_lat)
+      {
+      expected.push_back(places.Ids[i]);
+      }
+    }
+  std::vector<id_type> actual(gazetteer.find_within_box(min_lon, min_lat, max_lon, max_lat));
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  if (actual != expected)
+    {
+    std::cerr << "ERROR: Box (" << min_lon << ", " << min_lat << ") - (" << max_lon << ", " << max_lat
+              << ") contains " << expected.size() << " places but the gazetteer found "
+              << actual.size() << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+int test_boxes(tracktable::Gazetteer const& gazetteer, Places const& places)
+{
+  int error_count = 0;
+  error_count += check_box(gazetteer, places, -88, 24, -79.5, 31);
+  error_count += check_box(gazetteer, places, 179.5, -17, -179.5, -16);
+  error_count += check_box(gazetteer, places, -180, -90, 180, 90);
+  error_count += check_box(gazetteer, places, 10, 80, 20, 90);
+  error_count += check_box(gazetteer, places, 10, 20, 10, 20);
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_batches(tracktable::Gazetteer const& gazetteer)
+{
+  int error_count = 0;
+  std::vector<double> lons, lats, boxes;
+  for (int i = 0; i < 1000; ++i)
+    {
+    lons.push_back(-180 + 0.36 * i);
+    lats.push_back(-80 + 0.16 * i);
+    boxes.push_back(lons.back());
+    boxes.push_back(lats.back());
+    boxes.push_back(lons.back() + 5);
+    boxes.push_back(lats.back() + 5);
+    }
+
+  std::size_t k = 3;
+  std::vector<id_type> ids(lons.size() * k);
+  std::vector<double> distances(lons.size() * k);
+  gazetteer.find_nearest(lons.size(), lons.data(), lats.data(), k, ids.data(), distances.data());
+
+  std::vector<std::size_t> offsets;
+  std::vector<match_type> matches;
+  gazetteer.find_within_radius(lons.size(), lons.data(), lats.data(), 200, offsets, matches);
+
+  std::vector<std::size_t> box_offsets;
+  std::vector<id_type> box_ids;
+  gazetteer.find_within_box(lons.size(), boxes.data(), box_offsets, box_ids);
+
+  for (std::size_t q = 0; q < lons.size(); ++q)
+    {
+    std::vector<match_type> nearest(gazetteer.find_nearest(lons[q], lats[q], k));
+    std::vector<match_type> within(gazetteer.find_within_radius(lons[q], lats[q], 200));
+    std::vector<id_type> in_box(gazetteer.find_within_box(boxes[4*q], boxes[4*q+1], boxes[4*q+2], boxes[4*q+3]));
+    bool ok = (offsets[q+1] - offsets[q] == within.size())
+      && (box_offsets[q+1] - box_offsets[q] == in_box.size());
+    for (std::size_t i = 0; ok && i < k; ++i)
+      {
+      ok = (ids[q*k + i] == nearest[i].first && distances[q*k + i] == nearest[i].second);
+      }
+    for (std::size_t i = 0; ok && i < within.size(); ++i)
+      {
+      ok = (matches[offsets[q] + i] == within[i]);
+      }
+    if (!ok)
+      {
+      std::cerr << "ERROR: Batch results for query " << q << " differ from the single query\n";
+      return error_count + 1;
+      }
+    }
+
+  // Not enough places: unused slots are marked
+  tracktable::Gazetteer tiny;
+  double lon = 1, lat = 2;
+  tiny.build(1, &lon, &lat);
+  id_type tiny_ids[2];
+  double tiny_distances[2];
+  tiny.find_nearest(1, &lon, &lat, 2, tiny_ids, tiny_distances);
+  if (tiny_ids[0] != 0 || tiny_distances[0] != 0 || tiny_ids[1] != -1
+      || tiny_distances[1] != std::numeric_limits<double>::infinity())
+    {
+    std::cerr << "ERROR: Missing neighbors should be reported as ID -1 at infinite distance\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_cache(tracktable::Gazetteer const& gazetteer)
+{
+  int error_count = 0;
+  std::string filename("test_gazetteer_cache.bin");
+
+  if (!gazetteer.save(filename, "places v1"))
+    {
+    std::cerr << "ERROR: Could not write gazetteer cache\n";
+    return 1;
+    }
+
+  tracktable::Gazetteer copy;
+  if (copy.load(filename, "places v2"))
+    {
+    std::cerr << "ERROR: Cache with the wrong source key should not load\n";
+    ++error_count;
+    }
+  if (!copy.load(filename, "places v1") || copy.size() != gazetteer.size())
+    {
+    std::cerr << "ERROR: Could not read gazetteer cache\n";
+    ++error_count;
+    }
+  else if (copy.find_nearest(10, 10, 20) != gazetteer.find_nearest(10, 10, 20))
+    {
+    std::cerr << "ERROR: Cached gazetteer gives different answers\n";
+    ++error_count;
+    }
+
+  // Truncated caches must be rejected
+  std::ifstream infile(filename.c_str(), std::ios::binary);
+  std::string contents((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
+  infile.close();
+    {
+    std::ofstream outfile(filename.c_str(), std::ios::binary | std::ios::trunc);
+    outfile.write(contents.data(), static_cast<std::streamsize>(contents.size() - 10));
+    }
+  if (copy.load(filename, "places v1") || !copy.empty())
+    {
+    std::cerr << "ERROR: Truncated cache should not load\n";
+    ++error_count;
+    }
+
+  // So must a cache whose entry count claims more than the file holds.
+  // The count follows the 8-byte magic, the byte order and the key.
+  std::string inflated(contents);
+  std::uint64_t huge_count = 0x7fffffff;
+  std::memcpy(&inflated[8 + 4 + 8 + 9], &huge_count, sizeof(huge_count));
+    {
+    std::ofstream outfile(filename.c_str(), std::ios::binary | std::ios::trunc);
+    outfile.write(inflated.data(), static_cast<std::streamsize>(inflated.size()));
+    }
+  if (copy.load(filename, "places v1") || !copy.empty())
+    {
+    std::cerr << "ERROR: Cache with an inflated entry count should not load\n";
+    ++error_count;
+    }
+
+  std::remove(filename.c_str());
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  Places places(make_places(20000, 12345));
+  tracktable::Gazetteer gazetteer;
+  gazetteer.build(places.Longitudes, places.Latitudes, places.Ids);
+
+  error_count += test_queries(gazetteer, places);
+  error_count += test_boxes(gazetteer, places);
+  error_count += test_batches(gazetteer);
+  error_count += test_cache(gazetteer);
+  return error_count;
+}
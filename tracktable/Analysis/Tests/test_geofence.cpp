@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/Geofence.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef tracktable::GeofenceEvent event_type;
+typedef tracktable::GeofenceEventType event_kind;
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+
+tracktable::Timestamp base_time()
+{
+  return tracktable::time_from_string("2020-01-01 00:00:00");
+}
+
+tracktable::Timestamp at_minute(int minute)
+{
+  return base_time() + tracktable::minutes(minute);
+}
+
+std::string describe(std::vector<event_type> const& events)
+{
+  std::ostringstream out;
+  for (std::size_t i = 0; i < events.size(); ++i)
+    {
+    char const* kind = (events[i].type == event_kind::ENTER ? "ENTER"
+                        : events[i].type == event_kind::EXIT ? "EXIT" : "DWELL");
+    out << "  " << events[i].object_id << " " << kind << " region " << events[i].region
+        << " at " << events[i].time << " (" << events[i].longitude << ", "
+        << events[i].latitude << ")\n";
+    }
+  return out.str();
+}
+
+bool check_event(event_type const& event, event_kind type, std::int64_t region,
+                 tracktable::Timestamp const& time, double longitude, double latitude)
+{
+  return (event.type == type
+          && event.region == region
+          && std::abs((event.time - time).total_milliseconds()) <= 1
+          && std::fabs(event.longitude - longitude) < 1e-9
+          && std::fabs(event.latitude - latitude) < 1e-9);
+}
+
+// ----------------------------------------------------------------------
+
+int test_crossings()
+{
+  int error_count = 0;
+
+  // Box from 0 to 10 and a triangle with a hole
+  tracktable::GeofenceMonitor monitor;
+  monitor.add_box(1, 0, 0, 10, 10);
+  std::vector<std::vector<double> > rings(2);
+  double outer[] = { 20, 0, 40, 0, 30, 20, 20, 0 };
+  double hole[] = { 28, 2, 32, 2, 30, 6 };
+  rings[0].assign(outer, outer + 8);
+  rings[1].assign(hole, hole + 6);
+  monitor.add_polygon(2, rings);
+
+  std::vector<event_type> events;
+  // Start outside, then one segment straight through the box and
+  // into the triangle
+  monitor.update("a", -10, 5, at_minute(0), events);
+  monitor.update("a", 26, 5, at_minute(36), events);
+  if (events.size() != 3
+      || !check_event(events[0], event_kind::ENTER, 1, at_minute(10), 0, 5)
+      || !check_event(events[1], event_kind::EXIT, 1, at_minute(20), 10, 5)
+      || !check_event(events[2], event_kind::ENTER, 2, base_time() + tracktable::seconds(1950), 22.5, 5))
+    {
+    std::cerr << "ERROR: Expected a pass through the box and entry to the triangle, got:\n"
+              << describe(events);
+    ++error_count;
+    }
+
+  // Into the triangle's hole and out of it
+  events.clear();
+  monitor.update("a", 30, 4, at_minute(40), events);
+  monitor.update("a", 30, 1, at_minute(50), events);
+  if (events.size() != 2
+      || events[0].type != event_kind::EXIT || events[0].region != 2
+      || events[1].type != event_kind::ENTER || events[1].region != 2)
+    {
+    std::cerr << "ERROR: Expected exit into the hole and entry back out of it, got:\n"
+              << describe(events);
+    ++error_count;
+    }
+
+  std::vector<std::int64_t> inside(monitor.regions_containing("a"));
+  if (inside.size() != 1 || inside[0] != 2)
+    {
+    std::cerr << "ERROR: Object should be inside region 2 only\n";
+    ++error_count;
+    }
+
+  // Points out of order are ignored
+  events.clear();
+  monitor.update("a", 5, 5, at_minute(45), events);
+  if (!events.empty())
+    {
+    std::cerr << "ERROR: Old point should be ignored, got:\n" << describe(events);
+    ++error_count;
+    }
+
+  // A region added on top of an object reports ENTER at its next
+  // point; removing a region is silent
+  events.clear();
+  monitor.add_box(3, 29, 0, 31, 2);
+  monitor.remove_region(2);
+  monitor.update("a", 30, 1, at_minute(55), events);
+  if (events.size() != 1 || !check_event(events[0], event_kind::ENTER, 3, at_minute(55), 30, 1))
+    {
+    std::cerr << "ERROR: Expected entry to the new region only, got:\n" << describe(events);
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_dwell_and_antimeridian()
+{
+  int error_count = 0;
+
+  tracktable::GeofenceMonitor monitor;
+  monitor.add_box(7, 170, -20, -170, 20);
+  monitor.set_dwell_time(tracktable::minutes(15));
+
+  std::vector<event_type> events;
+  monitor.update("ship", 160, 0, at_minute(0), events);
+  monitor.update("ship", -160, 0, at_minute(40), events);
+  // Crossing the box from 170 to -170 takes from minute 10 to 30
+  if (events.size() != 3
+      || !check_event(events[0], event_kind::ENTER, 7, at_minute(10), 170, 0)
+      || !check_event(events[1], event_kind::DWELL, 7, at_minute(25), -175, 0)
+      || !check_event(events[2], event_kind::EXIT, 7, at_minute(30), -170, 0))
+    {
+    std::cerr << "ERROR: Expected enter, dwell and exit across the antimeridian, got:\n"
+              << describe(events);
+    ++error_count;
+    }
+
+  // Dwell is reported once per visit
+  events.clear();
+  monitor.update("ship", 179, 0, at_minute(50), events);
+  monitor.update("ship", 179, 1, at_minute(70), events);
+  monitor.update("ship", 179, 2, at_minute(90), events);
+  if (events.size() != 2 || events[1].type != event_kind::DWELL)
+    {
+    std::cerr << "ERROR: Expected one entry and one dwell, got:\n" << describe(events);
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+// Batches split across threads must give exactly the events that
+// feeding the points one at a time gives
+int test_batches()
+{
+  int error_count = 0;
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> unit(0, 1);
+
+  std::vector<point_type> points;
+  std::vector<double> x(200), y(200);
+  for (int step = 0; step < 100; ++step)
+    {
+    for (int object = 0; object < 200; ++object)
+      {
+      x[object] += unit(rng) - 0.5;
+      y[object] += unit(rng) - 0.5;
+      point_type point;
+      point.set_object_id("object" + std::to_string(object));
+      point.set_longitude(x[object]);
+      point.set_latitude(y[object]);
+      point.set_timestamp(base_time() + tracktable::seconds(60 * step));
+      points.push_back(point);
+      }
+    }
+
+  tracktable::GeofenceMonitor serial, parallel;
+  for (int region = 0; region < 50; ++region)
+    {
+    double cx = -8 + 16 * unit(rng), cy = -8 + 16 * unit(rng);
+    serial.add_box(region, cx - 1, cy - 1, cx + 1, cy + 1);
+    parallel.add_box(region, cx - 1, cy - 1, cx + 1, cy + 1);
+    }
+  serial.set_dwell_time(tracktable::minutes(5));
+  parallel.set_dwell_time(tracktable::minutes(5));
+  parallel.set_num_threads(4);
+
+  std::vector<event_type> expected, actual;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+    serial.update(points[i].object_id(), points[i].longitude(), points[i].latitude(),
+                  points[i].timestamp(), expected, i);
+    }
+  parallel.process(points.begin(), points.begin() + 7000, actual);
+  std::vector<event_type> second_batch;
+  parallel.process(points.begin() + 7000, points.end(), second_batch);
+  for (std::size_t i = 0; i < second_batch.size(); ++i)
+    {
+    second_batch[i].point_index += 7000;
+    }
+  actual.insert(actual.end(), second_batch.begin(), second_batch.end());
+
+  bool same = (expected.size() == actual.size());
+  for (std::size_t i = 0; same && i < expected.size(); ++i)
+    {
+    same = (expected[i].object_id == actual[i].object_id
+            && expected[i].region == actual[i].region
+            && expected[i].type == actual[i].type
+            && expected[i].time == actual[i].time
+            && expected[i].point_index == actual[i].point_index);
+    }
+  if (!same || expected.empty())
+    {
+    std::cerr << "ERROR: Parallel batches produced " << actual.size()
+              << " events, one point at a time produced " << expected.size() << "\n";
+    ++error_count;
+    }
+  if (parallel.num_objects() != 200)
+    {
+    std::cerr << "ERROR: Expected 200 objects, found " << parallel.num_objects() << "\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  error_count += test_crossings();
+  error_count += test_dwell_and_antimeridian();
+  error_count += test_batches();
+
+  return error_count;
+}
@@ -266,4 +266,62 @@ SCENARIO("TOP DOWN SANITY") {
       }
     }
   }
-}
\ No newline at end of file
+}
+/////////////////////////////////BATCH/////////////////////////////////////////
+SCENARIO("Best fit planes for a batch of trajectories") {
+  GIVEN("Zigzagging trajectories of different lengths and headings, plus two that cannot be fit") {
+    std::vector<TrajectoryT> trajectories;
+    for (auto t = 0u; t < 40u; ++t) {
+      auto p = tracktable::arithmetic::zero<PointT>();
+      p.set_longitude(-120.0 + t);
+      p.set_latitude(-30.0 + 1.5 * t);
+      p.set_property("altitude", ALTITUDE);
+      tracktable::ConstantSpeedPointGenerator generator(p, tracktable::minutes(1), SPEED, 9.0 * t);
+      TrajectoryT trajectory;
+      for (auto i = 0u; i < 3u + 7u * t; ++i) {
+        auto pp = generator.next();
+        pp.set_latitude(pp.latitude() + ((i % 2) != 0u ? ZIG : ZAG));
+        trajectory.push_back(pp);
+      }
+      trajectories.push_back(trajectory);
+    }
+    TrajectoryT onePoint;
+    onePoint.push_back(trajectories[0][0]);
+    trajectories.push_back(onePoint);
+    TrajectoryT samePoints;
+    samePoints.push_back(trajectories[0][0]);
+    samePoints.push_back(trajectories[0][0]);
+    trajectories.push_back(samePoints);
+
+    WHEN("You fit them all at once on several threads") {
+      auto normals = tracktable::find_best_fit_planes(trajectories, "altitude",
+                                                      tracktable::domain::terrestrial::AltitudeUnits::FEET, 4);
+      THEN("Every fit matches the single-trajectory fit") {
+        REQUIRE(normals.size() == trajectories.size());
+        for (auto t = 0u; t < 40u; ++t) {
+          auto expected = tracktable::find_best_fit_plane(trajectories[t]);
+          for (auto u = 0u; u < Point3dT::size(); ++u) {
+            CHECK(normals[t][u] == expected[u]);
+          }
+        }
+      }
+      THEN("Trajectories that cannot be fit get a zero normal") {
+        CHECK(0.0 == tracktable::arithmetic::norm_squared(normals[40]));
+        CHECK(0.0 == tracktable::arithmetic::norm_squared(normals[41]));
+      }
+    }
+    WHEN("You reuse one workspace for every fit") {
+      tracktable::GreatCircleFitWorkspace workspace;
+      THEN("The results do not depend on what the workspace held before") {
+        for (auto t = 40u; t > 0u; --t) {
+          auto reused = tracktable::find_best_fit_plane(trajectories[t - 1], workspace);
+          auto fresh = tracktable::find_best_fit_plane(trajectories[t - 1]);
+          for (auto u = 0u; u < Point3dT::size(); ++u) {
+            CHECK(reused[u] == fresh[u]);
+          }
+        }
+        CHECK(workspace.size() == trajectories[0].size());
+      }
+    }
+  }
+}
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/HNSWIndex.h>
+#include <tracktable/Domain/FeatureVectors.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <sstream>
+#include <vector>
+
+typedef tracktable::domain::feature_vectors::FeatureVector<24> point_type;
+typedef tracktable::HNSWIndex<point_type> index_type;
+typedef index_type::neighbor_vector_type neighbor_vector_type;
+
+// ----------------------------------------------------------------------
+
+// Clumpy data is harder for a graph index than uniform noise: points
+// are drawn around a few dozen centers of different spreads.
+
+std::vector<point_type> clustered_points(std::mt19937& generator, std::size_t count)
+{
+  std::uniform_real_distribution<double> uniform(-10, 10);
+  std::vector<point_type> centers(40);
+  for (point_type& center : centers)
+    {
+    for (std::size_t d = 0; d < 24; ++d)
+      {
+      center[d] = uniform(generator);
+      }
+    }
+
+  std::uniform_int_distribution<std::size_t> which(0, centers.size() - 1);
+  std::vector<point_type> result(count);
+  for (point_type& point : result)
+    {
+    std::size_t center = which(generator);
+    std::normal_distribution<double> spread(0, 0.5 + 0.05 * center);
+    for (std::size_t d = 0; d < 24; ++d)
+      {
+      point[d] = centers[center][d] + spread(generator);
+      }
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<std::size_t> exact_neighbors(std::vector<point_type> const& points,
+                                         point_type const& query,
+                                         std::size_t k)
+{
+  std::vector<std::pair<double, std::size_t> > distances;
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+    distances.push_back(std::make_pair(
+      boost::geometry::comparable_distance(query, points[i]), i));
+    }
+  std::partial_sort(distances.begin(), distances.begin() + k, distances.end());
+  std::vector<std::size_t> result;
+  for (std::size_t i = 0; i < k; ++i)
+    {
+    result.push_back(distances[i].second);
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+double recall(index_type const& index,
+              std::vector<point_type> const& points,
+              std::vector<point_type> const& queries,
+              std::size_t k)
+{
+  std::size_t hits = 0;
+  for (point_type const& query : queries)
+    {
+    std::vector<std::size_t> truth(exact_neighbors(points, query, k));
+    std::set<std::size_t> expected(truth.begin(), truth.end());
+    neighbor_vector_type found;
+    index.find_nearest_neighbors(query, k, std::back_inserter(found));
+    for (auto const& neighbor : found)
+      {
+      hits += expected.count(neighbor.first);
+      }
+    }
+  return static_cast<double>(hits) / (queries.size() * k);
+}
+
+// ----------------------------------------------------------------------
+
+int test_recall(index_type const& index,
+                std::vector<point_type> const& points,
+                std::vector<point_type> const& queries,
+                std::string const& description)
+{
+  double measured = recall(index, points, queries, 10);
+  std::cout << description << ": recall@10 = " << measured << "\n";
+  if (measured < 0.9)
+    {
+    std::cerr << "ERROR: " << description << ": expected recall@10 of at least 0.9, got "
+              << measured << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+// ----------------------------------------------------------------------
+
+int test_small_index()
+{
+  int error_count = 0;
+  index_type index;
+  neighbor_vector_type found;
+
+  index.find_nearest_neighbors(point_type(), 5, std::back_inserter(found));
+  if (!found.empty())
+    {
+    std::cerr << "ERROR: Empty index returned " << found.size() << " neighbors\n";
+    ++error_count;
+    }
+
+  std::vector<point_type> points(3);
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+    for (std::size_t d = 0; d < 24; ++d)
+      {
+      points[i][d] = static_cast<double>(i);
+      }
+    index.insert(points[i]);
+    }
+
+  index.find_nearest_neighbors(points[2], 5, std::back_inserter(found));
+  if (found.size() != 3 || found[0].first != 2 || found[0].second != 0)
+    {
+    std::cerr << "ERROR: Expected all 3 points with point 2 first, got "
+              << found.size() << " points\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int, char*[])
+{
+  int error_count = 0;
+  std::mt19937 generator(1234);
+  std::vector<point_type> points(clustered_points(generator, 5000));
+  std::vector<point_type> queries(clustered_points(generator, 100));
+
+  error_count += test_small_index();
+
+  index_type serial_index(16, 100);
+  serial_index.set_ef_search(100);
+  for (point_type const& point : points)
+    {
+    serial_index.insert(point);
+    }
+  error_count += test_recall(serial_index, points, queries, "Serial build");
+
+  index_type parallel_index(16, 100);
+  parallel_index.set_ef_search(100);
+  std::size_t first_id = parallel_index.insert(points.begin(), points.end(), 4);
+  if (first_id != 0 || parallel_index.size() != points.size())
+    {
+    std::cerr << "ERROR: Parallel build has " << parallel_index.size()
+              << " points starting at " << first_id << "\n";
+    ++error_count;
+    }
+  error_count += test_recall(parallel_index, points, queries, "Parallel build");
+
+  // Raising ef_search should never make things worse
+  parallel_index.set_ef_search(10);
+  double low_recall = recall(parallel_index, points, queries, 10);
+  parallel_index.set_ef_search(200);
+  double high_recall = recall(parallel_index, points, queries, 10);
+  std::cout << "ef_search 10: " << low_recall << ", ef_search 200: " << high_recall << "\n";
+  if (high_recall < low_recall)
+    {
+    std::cerr << "ERROR: Recall dropped from " << low_recall << " to "
+              << high_recall << " when ef_search went up\n";
+    ++error_count;
+    }
+
+  // Batched queries must agree with one-at-a-time queries
+  std::vector<neighbor_vector_type> batch(
+    parallel_index.batch_find_nearest_neighbors(queries.begin(), queries.end(), 10, 4));
+  for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+    neighbor_vector_type single;
+    parallel_index.find_nearest_neighbors(queries[i], 10, std::back_inserter(single));
+    if (single != batch[i])
+      {
+      std::cerr << "ERROR: Batched query " << i << " differs from single query\n";
+      ++error_count;
+      }
+    }
+
+  // A saved and restored index must answer queries identically
+  std::stringstream buffer;
+  {
+  boost::archive::binary_oarchive archive(buffer);
+  archive << parallel_index;
+  }
+  index_type restored;
+  {
+  boost::archive::binary_iarchive archive(buffer);
+  archive >> restored;
+  }
+  if (restored.size() != parallel_index.size() ||
+      restored.ef_search() != parallel_index.ef_search())
+    {
+    std::cerr << "ERROR: Restored index has " << restored.size()
+              << " points and ef_search " << restored.ef_search() << "\n";
+    ++error_count;
+    }
+  std::vector<neighbor_vector_type> restored_batch(
+    restored.batch_find_nearest_neighbors(queries.begin(), queries.end(), 10, 4));
+  if (restored_batch != batch)
+    {
+    std::cerr << "ERROR: Restored index returns different neighbors\n";
+    ++error_count;
+    }
+
+  // Points inserted after restoring are linked into the same graph
+  std::vector<point_type> more_points(clustered_points(generator, 500));
+  restored.insert(more_points.begin(), more_points.end());
+  std::vector<point_type> all_points(points);
+  all_points.insert(all_points.end(), more_points.begin(), more_points.end());
+  error_count += test_recall(restored, all_points, queries, "Restored and extended");
+
+  return error_count;
+}
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/IncrementalDBSCAN.h>
+#include <tracktable/Analysis/ComputeDBSCANClustering.h>
+#include <tracktable/Core/PointCartesian.h>
+#include <tracktable/Core/Timestamp.h>
+
+#include <cmath>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+typedef tracktable::PointCartesian<2> point_type;
+typedef tracktable::IncrementalDBSCAN<point_type> incremental_dbscan_type;
+
+// ----------------------------------------------------------------------
+
+point_type make_point(double x, double y)
+{
+  point_type result;
+  result[0] = x;
+  result[1] = y;
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+std::vector<point_type> random_batch(std::mt19937& generator, std::size_t count)
+{
+  static const double centers[][2] = { {0, 0}, {3, 0}, {0, 3}, {3, 3}, {1.5, 1.5} };
+  std::normal_distribution<double> blob(0, 0.25);
+  std::uniform_real_distribution<double> anywhere(-1, 4);
+  std::uniform_int_distribution<int> which(0, 5);
+
+  std::vector<point_type> result;
+  for (std::size_t i = 0; i < count; ++i)
+    {
+    int center = which(generator);
+    if (center == 5)
+      {
+      result.push_back(make_point(anywhere(generator), anywhere(generator)));
+      }
+    else
+      {
+      result.push_back(make_point(centers[center][0] + blob(generator),
+                                  centers[center][1] + blob(generator)));
+      }
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+bool is_core_point(std::vector<point_type> const& points, std::size_t which,
+                   point_type const& half_span, std::size_t min_cluster_size)
+{
+  std::size_t neighbors = 0;
+  for (point_type const& point : points)
+    {
+    if (std::abs(point[0] - points[which][0]) < half_span[0] &&
+        std::abs(point[1] - points[which][1]) < half_span[1])
+      {
+      ++neighbors;
+      }
+    }
+  return neighbors >= min_cluster_size;
+}
+
+// ----------------------------------------------------------------------
+
+// Compare the incremental results against a batch run over the same
+// points.  Core points must match exactly and be partitioned the same
+// way.  Border points may land in a different cluster but must be
+// clustered (not noise) in both or neither.
+
+int compare_with_batch(incremental_dbscan_type const& incremental,
+                       std::map<std::size_t, point_type> const& live_points,
+                       point_type const& half_span,
+                       std::size_t min_cluster_size,
+                       std::string const& description)
+{
+  int error_count = 0;
+  std::vector<point_type> points;
+  std::vector<std::size_t> ids;
+  for (auto const& entry : live_points)
+    {
+    ids.push_back(entry.first);
+    points.push_back(entry.second);
+    }
+
+  if (incremental.size() != points.size())
+    {
+    std::cerr << "ERROR: " << description << ": incremental clustering has "
+              << incremental.size() << " points, expected "
+              << points.size() << "\n";
+    return 1;
+    }
+
+  std::vector<std::pair<int, int> > batch_labels;
+  tracktable::cluster_with_dbscan(points.begin(), points.end(),
+                                  half_span, min_cluster_size,
+                                  std::back_inserter(batch_labels));
+
+  std::map<int, int> batch_to_incremental;
+  std::map<int, int> incremental_to_batch;
+  for (auto const& label : batch_labels)
+    {
+    std::size_t which = label.first;
+    int batch_cluster = label.second;
+    int incremental_cluster = incremental.cluster_id(ids[which]);
+    bool core = is_core_point(points, which, half_span, min_cluster_size);
+
+    if (core != incremental.is_core(ids[which]))
+      {
+      std::cerr << "ERROR: " << description << ": point " << ids[which]
+                << " core status mismatch\n";
+      ++error_count;
+      }
+    if ((batch_cluster == 0) != (incremental_cluster == 0))
+      {
+      std::cerr << "ERROR: " << description << ": point " << ids[which]
+                << " has batch label " << batch_cluster
+                << " but incremental label " << incremental_cluster << "\n";
+      ++error_count;
+      }
+    if (core && batch_cluster != 0)
+      {
+      auto forward = batch_to_incremental.insert(
+        std::make_pair(batch_cluster, incremental_cluster)).first;
+      auto backward = incremental_to_batch.insert(
+        std::make_pair(incremental_cluster, batch_cluster)).first;
+      if (forward->second != incremental_cluster || backward->second != batch_cluster)
+        {
+        std::cerr << "ERROR: " << description << ": core point " << ids[which]
+                  << " is in batch cluster " << batch_cluster
+                  << " and incremental cluster " << incremental_cluster
+                  << " but the partitions do not agree\n";
+        ++error_count;
+        }
+      }
+    }
+
+  if (batch_to_incremental.size() != incremental.num_clusters())
+    {
+    std::cerr << "ERROR: " << description << ": batch found "
+              << batch_to_incremental.size() << " clusters, incremental has "
+              << incremental.num_clusters() << "\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_sliding_window()
+{
+  int error_count = 0;
+  std::mt19937 generator(12345);
+  point_type half_span(make_point(0.15, 0.15));
+  std::size_t min_cluster_size = 6;
+  incremental_dbscan_type dbscan(half_span, min_cluster_size);
+  std::map<std::size_t, point_type> live_points;
+  std::vector<std::vector<std::size_t> > day_ids;
+
+  tracktable::Timestamp start(tracktable::time_from_string("2020-01-01 00:00:00"));
+  for (int day = 0; day < 8; ++day)
+    {
+    tracktable::Timestamp today(start + tracktable::days(day));
+    tracktable::Timestamp cutoff(today - tracktable::days(4));
+    std::vector<point_type> batch(random_batch(generator, 300));
+
+    std::size_t first_id = dbscan.advance_window(batch.begin(), batch.end(),
+                                                 today, cutoff);
+    for (std::size_t i = 0; i < batch.size(); ++i)
+      {
+      live_points[first_id + i] = batch[i];
+      }
+    // Days older than the cutoff fall out of the window
+    if (day >= 5)
+      {
+      for (std::size_t i = 0; i < 300; ++i)
+        {
+        live_points.erase((day - 5) * 300 + i);
+        }
+      }
+
+    std::cout << "Day " << day << ": " << dbscan.size() << " points, "
+              << dbscan.num_clusters() << " clusters, "
+              << dbscan.last_events().size() << " events\n";
+    error_count += compare_with_batch(dbscan, live_points, half_span,
+                                      min_cluster_size,
+                                      "sliding window day " + std::to_string(day));
+    }
+
+  // Removing individual points should also keep the clustering exact
+  for (std::size_t i = 0; i < 200; ++i)
+    {
+    std::size_t victim = live_points.begin()->first + 3 * i;
+    if (dbscan.erase(victim))
+      {
+      live_points.erase(victim);
+      }
+    }
+  error_count += compare_with_batch(dbscan, live_points, half_span,
+                                    min_cluster_size, "individual erase");
+
+  std::size_t removed = dbscan.erase_before(start + tracktable::days(100));
+  if (removed != live_points.size() || dbscan.size() != 0 || dbscan.num_clusters() != 0)
+    {
+    std::cerr << "ERROR: erase_before removed " << removed << " of "
+              << live_points.size() << " points and left "
+              << dbscan.num_clusters() << " clusters\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+bool has_event(incremental_dbscan_type const& dbscan, tracktable::ClusterEventType type)
+{
+  for (tracktable::ClusterEvent const& event : dbscan.last_events())
+    {
+    if (event.type == type) return true;
+    }
+  return false;
+}
+
+// ----------------------------------------------------------------------
+
+int test_events()
+{
+  int error_count = 0;
+  incremental_dbscan_type dbscan(make_point(0.6, 0.6), 3);
+
+  // Two short rows of points far enough apart to be separate
+  // clusters and a row of points that connects them
+  std::vector<point_type> left, right, bridge;
+  for (int i = 0; i < 4; ++i)
+    {
+    left.push_back(make_point(i * 0.5, 0));
+    right.push_back(make_point(4 + i * 0.5, 0));
+    bridge.push_back(make_point(2 + i * 0.5, 0));
+    }
+
+  dbscan.insert(left.begin(), left.end());
+  if (!has_event(dbscan, tracktable::ClusterEventType::CREATED) ||
+      dbscan.num_clusters() != 1)
+    {
+    std::cerr << "ERROR: Expected the first row to create a cluster\n";
+    ++error_count;
+    }
+  int left_cluster = dbscan.cluster_id(0);
+
+  dbscan.insert(right.begin(), right.end());
+  if (dbscan.num_clusters() != 2 || dbscan.cluster_id(4) == left_cluster)
+    {
+    std::cerr << "ERROR: Expected the second row to be a second cluster\n";
+    ++error_count;
+    }
+
+  std::size_t bridge_start = dbscan.insert(bridge.begin(), bridge.end());
+  if (!has_event(dbscan, tracktable::ClusterEventType::MERGED) ||
+      dbscan.num_clusters() != 1)
+    {
+    std::cerr << "ERROR: Expected the bridge to merge the two clusters\n";
+    ++error_count;
+    }
+  int merged_cluster = dbscan.cluster_id(0);
+  for (std::size_t i = 0; i < 12; ++i)
+    {
+    if (dbscan.cluster_id(i) != merged_cluster)
+      {
+      std::cerr << "ERROR: Point " << i << " has label " << dbscan.cluster_id(i)
+                << " after merge, expected " << merged_cluster << "\n";
+      ++error_count;
+      }
+    }
+
+  dbscan.erase(bridge_start + 1);
+  if (!has_event(dbscan, tracktable::ClusterEventType::SPLIT) ||
+      dbscan.num_clusters() != 2 ||
+      dbscan.cluster_id(0) == dbscan.cluster_id(4))
+    {
+    std::cerr << "ERROR: Expected removing the middle of the bridge to split the cluster\n";
+    ++error_count;
+    }
+
+  bool dissolved = false;
+  for (std::size_t i = 0; i < right.size(); ++i)
+    {
+    dbscan.erase(4 + i);
+    dissolved = dissolved || has_event(dbscan, tracktable::ClusterEventType::DISSOLVED);
+    }
+  if (!dissolved ||
+      dbscan.num_clusters() != 1)
+    {
+    std::cerr << "ERROR: Expected removing the second row to dissolve its cluster\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int, char*[])
+{
+  int error_count = 0;
+
+  error_count += test_events();
+  error_count += test_sliding_window();
+
+  return error_count;
+}
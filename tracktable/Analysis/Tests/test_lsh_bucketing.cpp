@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above
+ * copyright notice, this list of conditions and the following
+ * disclaimer in the documentation and/or other materials provided
+ * with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/LSHBucketing.h>
+#include <tracktable/Analysis/ComputeDBSCANClustering.h>
+#include <tracktable/Domain/FeatureVectors.h>
+
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+typedef tracktable::domain::feature_vectors::FeatureVector<10> point_type;
+typedef tracktable::LSHBucketing<point_type> bucketing_type;
+
+// ----------------------------------------------------------------------
+
+// Tight blobs around random centers plus a sprinkling of noise points
+
+std::vector<point_type> make_points(std::size_t num_clusters,
+                                    std::size_t points_per_cluster,
+                                    std::size_t num_noise_points)
+{
+  std::mt19937 generator(4321);
+  std::uniform_real_distribution<double> uniform(-20, 20);
+  std::normal_distribution<double> blob(0, 0.1);
+
+  std::vector<point_type> points;
+  for (std::size_t c = 0; c < num_clusters; ++c)
+    {
+    point_type center;
+    for (std::size_t d = 0; d < 10; ++d)
+      {
+      center[d] = uniform(generator);
+      }
+    for (std::size_t i = 0; i < points_per_cluster; ++i)
+      {
+      point_type point;
+      for (std::size_t d = 0; d < 10; ++d)
+        {
+        point[d] = center[d] + blob(generator);
+        }
+      points.push_back(point);
+      }
+    }
+  for (std::size_t i = 0; i < num_noise_points; ++i)
+    {
+    point_type point;
+    for (std::size_t d = 0; d < 10; ++d)
+      {
+      point[d] = uniform(generator);
+      }
+    points.push_back(point);
+    }
+  return points;
+}
+
+// ----------------------------------------------------------------------
+
+int test_partition(std::vector<point_type> const& points,
+                   point_type const& half_span)
+{
+  int error_count = 0;
+
+  for (std::size_t probes = 0; probes <= 3; ++probes)
+    {
+    bucketing_type bucketing(half_span, 6, 4.0, probes, 17);
+    bucketing_type::bucket_vector_type buckets(
+      bucketing.partition(points.begin(), points.end()));
+
+    std::vector<std::size_t> copies(points.size(), 0);
+    for (auto const& bucket : buckets)
+      {
+      if (bucket.empty())
+        {
+        std::cerr << "ERROR: partition() returned an empty bucket\n";
+        ++error_count;
+        }
+      for (std::size_t member : bucket)
+        {
+        ++copies[member];
+        }
+      }
+    for (std::size_t i = 0; i < points.size(); ++i)
+      {
+      if (copies[i] < 1 || copies[i] > probes + 1)
+        {
+        std::cerr << "ERROR: With " << probes << " probes point " << i
+                  << " landed in " << copies[i] << " buckets\n";
+        ++error_count;
+        break;
+        }
+      }
+    std::cout << probes << " probes: " << buckets.size() << " buckets\n";
+
+    bucketing_type::bucket_vector_type again(
+      bucketing.partition(points.begin(), points.end()));
+    if (again != buckets)
+      {
+      std::cerr << "ERROR: partition() is not repeatable\n";
+      ++error_count;
+      }
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_clustering(std::vector<point_type> const& points,
+                    point_type const& half_span,
+                    std::size_t expected_clusters)
+{
+  int error_count = 0;
+  std::vector<std::pair<int, int> > exact_labels, bucketed_labels;
+
+  tracktable::cluster_with_dbscan(points.begin(), points.end(), half_span, 5,
+                                  std::back_inserter(exact_labels));
+
+  bucketing_type bucketing(half_span, 4, 8.0, 2, 17);
+  int num_clusters = tracktable::cluster_with_bucketed_dbscan(
+    points.begin(), points.end(), half_span, 5,
+    std::back_inserter(bucketed_labels), bucketing, 4);
+
+  if (num_clusters != static_cast<int>(expected_clusters))
+    {
+    std::cerr << "ERROR: Expected " << expected_clusters
+              << " clusters from bucketed DBSCAN, got " << num_clusters << "\n";
+    ++error_count;
+    }
+  if (bucketed_labels.size() != points.size())
+    {
+    std::cerr << "ERROR: Expected " << points.size() << " labels, got "
+              << bucketed_labels.size() << "\n";
+    return error_count + 1;
+    }
+
+  // The well-separated blobs must come out the same either way, up to
+  // renumbering and a few fringe points
+  std::map<int, int> exact_to_bucketed;
+  std::size_t noise_mismatches = 0;
+  std::vector<int> exact_by_point(points.size());
+  for (auto const& label : exact_labels)
+    {
+    exact_by_point[label.first] = label.second;
+    }
+  for (std::size_t i = 0; i < points.size(); ++i)
+    {
+    if (bucketed_labels[i].first != static_cast<int>(i))
+      {
+      std::cerr << "ERROR: Labels are not in input order at " << i << "\n";
+      ++error_count;
+      break;
+      }
+    int exact = exact_by_point[i];
+    int bucketed = bucketed_labels[i].second;
+    if ((exact == 0) != (bucketed == 0))
+      {
+      // A point at the fringe of a blob can lose the neighbors that
+      // made it a member when they land in another bucket
+      ++noise_mismatches;
+      continue;
+      }
+    if (exact == 0) continue;
+    auto mapped = exact_to_bucketed.insert(std::make_pair(exact, bucketed)).first;
+    if (mapped->second != bucketed)
+      {
+      std::cerr << "ERROR: Exact cluster " << exact << " maps to bucketed clusters "
+                << mapped->second << " and " << bucketed << "\n";
+      ++error_count;
+      }
+    }
+  std::cout << noise_mismatches << " points differ between noise and cluster\n";
+  if (noise_mismatches > points.size() / 100)
+    {
+    std::cerr << "ERROR: " << noise_mismatches
+              << " points are noise in one clustering but not the other\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int, char*[])
+{
+  int error_count = 0;
+  std::size_t num_clusters = 30;
+  std::vector<point_type> points(make_points(num_clusters, 100, 200));
+  point_type half_span;
+  for (std::size_t d = 0; d < 10; ++d)
+    {
+    half_span[d] = 0.25;
+    }
+
+  error_count += test_partition(points, half_span);
+  error_count += test_clustering(points, half_span, num_clusters);
+
+  return error_count;
+}
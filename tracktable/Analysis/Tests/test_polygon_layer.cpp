@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/PolygonLayer.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+typedef tracktable::PolygonLayer::feature_id_type feature_id_type;
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+
+typedef std::vector<double> ring_type;
+
+// Even-odd point-in-ring test without any acceleration
+bool brute_inside(ring_type const& ring, double x, double y)
+{
+  bool inside = false;
+  std::size_t n = ring.size() / 2;
+  for (std::size_t i = 0, j = n - 1; i < n; j = i++)
+    {
+    double xi = ring[2*i], yi = ring[2*i+1];
+    double xj = ring[2*j], yj = ring[2*j+1];
+    if (((yi > y) != (yj > y)) && (x < (xj - xi) * (y - yi) / (yj - yi) + xi))
+      {
+      inside = !inside;
+      }
+    }
+  return inside;
+}
+
+// A wobbly ring around a center, like a crude island
+ring_type make_island(double center_x, double center_y, double radius,
+                      std::size_t num_vertices, std::mt19937& rng)
+{
+  std::uniform_real_distribution<double> wobble(0.6, 1.0);
+  ring_type ring;
+  for (std::size_t i = 0; i < num_vertices; ++i)
+    {
+    double angle = 2 * 3.141592653589793 * static_cast<double>(i) / static_cast<double>(num_vertices);
+    double r = radius * wobble(rng);
+    ring.push_back(center_x + r * std::cos(angle));
+    ring.push_back(center_y + r * std::sin(angle));
+    }
+  return ring;
+}
+
+ring_type make_box(double min_x, double min_y, double max_x, double max_y)
+{
+  ring_type ring;
+  ring.push_back(min_x); ring.push_back(min_y);
+  ring.push_back(max_x); ring.push_back(min_y);
+  ring.push_back(max_x); ring.push_back(max_y);
+  ring.push_back(min_x); ring.push_back(max_y);
+  ring.push_back(min_x); ring.push_back(min_y);
+  return ring;
+}
+
+// ----------------------------------------------------------------------
+
+int test_locate()
+{
+  int error_count = 0;
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<double> unit(0, 1);
+
+  // Islands in a 40x40-degree ocean, one of them with a lagoon
+  std::vector<ring_type> islands;
+  for (int i = 0; i < 30; ++i)
+    {
+    islands.push_back(make_island(-20 + 40 * unit(rng), -20 + 40 * unit(rng),
+                                  0.5 + 3 * unit(rng), 50 + i * 7, rng));
+    }
+  ring_type lagoon(make_box(-1, -1, 1, 1));
+  ring_type atoll(make_box(-2, -2, 2, 2));
+
+  tracktable::PolygonLayer layer;
+  feature_id_type atoll_id = layer.add_area(atoll.size() / 2, atoll.data());
+  layer.add_ring(atoll_id, lagoon.size() / 2, lagoon.data());
+  for (std::size_t i = 0; i < islands.size(); ++i)
+    {
+    layer.add_area(islands[i].size() / 2, islands[i].data());
+    }
+
+  bool threw = false;
+  try
+    {
+    layer.locate(0, 0);
+    }
+  catch (std::logic_error const&)
+    {
+    threw = true;
+    }
+  if (!threw)
+    {
+    std::cerr << "ERROR: Querying an unbuilt layer should throw\n";
+    ++error_count;
+    }
+
+  for (std::size_t resolution : { std::size_t(0), std::size_t(7), std::size_t(512) })
+    {
+    layer.build(resolution);
+
+    std::vector<double> longitudes, latitudes;
+    for (int i = 0; i < 20000; ++i)
+      {
+      longitudes.push_back(-25 + 50 * unit(rng));
+      latitudes.push_back(-25 + 50 * unit(rng));
+      }
+    std::vector<feature_id_type> found(longitudes.size());
+    layer.locate(longitudes.size(), longitudes.data(), latitudes.data(), found.data());
+
+    int mismatches = 0;
+    for (std::size_t p = 0; p < longitudes.size(); ++p)
+      {
+      double x = longitudes[p], y = latitudes[p];
+      feature_id_type expected = -1;
+      if (brute_inside(atoll, x, y) != brute_inside(lagoon, x, y))
+        {
+        expected = atoll_id;
+        }
+      else
+        {
+        for (std::size_t i = 0; i < islands.size(); ++i)
+          {
+          if (brute_inside(islands[i], x, y))
+            {
+            expected = static_cast<feature_id_type>(i + 1);
+            break;
+            }
+          }
+        }
+      if (found[p] != expected || layer.locate(x, y) != expected)
+        {
+        ++mismatches;
+        }
+      }
+    if (mismatches)
+      {
+      std::cerr << "ERROR: Grid resolution " << resolution << ": " << mismatches
+                << " points located differently from brute force\n";
+      ++error_count;
+      }
+    }
+
+  if (layer.contains(0, 0) || !layer.contains(1.5, 0))
+    {
+    std::cerr << "ERROR: Lagoon should be outside the atoll and its rim inside\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_distance_and_crossings()
+{
+  int error_count = 0;
+
+  // A box from the equator to 10N and a border along 30E
+  tracktable::PolygonLayer layer;
+  ring_type box(make_box(0, 0, 10, 10));
+  layer.add_area(box.size() / 2, box.data());
+  double border[] = { 30, -20, 30, 20 };
+  layer.add_line(2, border);
+  layer.build();
+
+  if (layer.num_features() != 2 || layer.num_edges() != 5 || !layer.is_area(0) || layer.is_area(1))
+    {
+    std::cerr << "ERROR: Layer should have one area with 4 edges and one line with 1 edge\n";
+    ++error_count;
+    }
+
+  // One degree of latitude
+  double km_per_degree = tracktable::conversions::constants::EARTH_RADIUS_IN_KM
+    * tracktable::conversions::constants::RADIANS_PER_DEGREE;
+  double distance = layer.distance_to_boundary(5, -1);
+  if (std::fabs(distance - km_per_degree) > 1e-6)
+    {
+    std::cerr << "ERROR: Distance from (5, -1) should be " << km_per_degree
+              << " km, got " << distance << "\n";
+    ++error_count;
+    }
+  distance = layer.distance_to_boundary(5, 5);
+  double expected = 5 * km_per_degree * std::cos(5 * tracktable::conversions::constants::RADIANS_PER_DEGREE);
+  if (std::fabs(distance - expected) > 1e-6)
+    {
+    std::cerr << "ERROR: Distance from the middle of the box should be " << expected
+              << " km, got " << distance << "\n";
+    ++error_count;
+    }
+  distance = layer.distance_to_boundary(-170, 0, 1000);
+  if (distance != std::numeric_limits<double>::infinity())
+    {
+    std::cerr << "ERROR: Nothing should be within 1000 km of (-170, 0), got " << distance << "\n";
+    ++error_count;
+    }
+
+  std::size_t crossings = layer.count_crossings(-5, 5, 35, 5);
+  if (crossings != 3)
+    {
+    std::cerr << "ERROR: Segment across the box and the border should cross 3 edges, got "
+              << crossings << "\n";
+    ++error_count;
+    }
+  // Through the box's corner: two edges meet there but it is one crossing
+  crossings = layer.count_crossings(-5, -5, 5, 5);
+  if (crossings != 1)
+    {
+    std::cerr << "ERROR: Segment through a corner should cross 1 edge, got " << crossings << "\n";
+    ++error_count;
+    }
+
+  // Trajectories
+  trajectory_type inside_out;
+  for (int i = 0; i < 4; ++i)
+    {
+    point_type point;
+    point.set_longitude(2 + 10 * i);
+    point.set_latitude(5);
+    inside_out.push_back(point);
+    }
+  std::vector<trajectory_type> trajectories(2, inside_out);
+  trajectories[1].clear();
+  std::vector<double> fractions(layer.fraction_inside(trajectories.begin(), trajectories.end()));
+  std::vector<std::size_t> counts(layer.count_crossings(trajectories.begin(), trajectories.end()));
+  if (std::fabs(fractions[0] - 0.25) > 1e-12 || fractions[1] != 0
+      || counts[0] != 2 || counts[1] != 0)
+    {
+    std::cerr << "ERROR: Expected fractions 0.25, 0 and crossings 2, 0; got "
+              << fractions[0] << ", " << fractions[1] << " and "
+              << counts[0] << ", " << counts[1] << "\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_antimeridian()
+{
+  int error_count = 0;
+
+  // Two halves of an island that straddles the antimeridian, as
+  // shoreline data usually splits them
+  tracktable::PolygonLayer layer;
+  ring_type east(make_box(178, -18, 180, -16));
+  ring_type west(make_box(-180, -18, -179, -16));
+  layer.add_area(east.size() / 2, east.data());
+  layer.add_area(west.size() / 2, west.data());
+  layer.build();
+
+  std::size_t crossings = layer.count_crossings(170, -17, -170, -17);
+  if (crossings != 4)
+    {
+    std::cerr << "ERROR: Segment across the antimeridian should cross 4 edges, got "
+              << crossings << "\n";
+    ++error_count;
+    }
+
+  // 1 degree east of the island's western edge at -179, seen from -178
+  double km_per_degree = tracktable::conversions::constants::EARTH_RADIUS_IN_KM
+    * tracktable::conversions::constants::RADIANS_PER_DEGREE;
+  double expected = km_per_degree * std::cos(17 * tracktable::conversions::constants::RADIANS_PER_DEGREE);
+  double distance = layer.distance_to_boundary(-178, -17);
+  if (std::fabs(distance - expected) > 1e-6)
+    {
+    std::cerr << "ERROR: Distance from (-178, -17) should be " << expected
+              << " km, got " << distance << "\n";
+    ++error_count;
+    }
+  // 2 degrees west of the eastern half's western edge, across nothing
+  expected = 2 * km_per_degree * std::cos(17 * tracktable::conversions::constants::RADIANS_PER_DEGREE);
+  distance = layer.distance_to_boundary(176, -17);
+  if (std::fabs(distance - expected) > 1e-6)
+    {
+    std::cerr << "ERROR: Distance from (176, -17) should be " << expected
+              << " km, got " << distance << "\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  error_count += test_locate();
+  error_count += test_distance_and_crossings();
+  error_count += test_antimeridian();
+
+  return error_count;
+}
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/PortalDiscovery.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <boost/geometry/algorithms/covered_by.hpp>
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::PortalDiscovery<trajectory_type> discovery_type;
+typedef discovery_type::portal_pair_type portal_pair_type;
+
+// ----------------------------------------------------------------------
+
+point_type make_point(double longitude, double latitude)
+{
+  point_type point;
+  point.set_longitude(longitude);
+  point.set_latitude(latitude);
+  return point;
+}
+
+// Build a trajectory that flies directly from one point to another
+trajectory_type fly(std::string const& object_id,
+                    point_type const& origin,
+                    point_type const& destination,
+                    int num_points)
+{
+  trajectory_type path;
+  tracktable::Timestamp when = tracktable::time_from_string("2020-01-01 00:00:00");
+  for (int i = 0; i < num_points; ++i)
+    {
+    point_type point(tracktable::interpolate(origin, destination,
+                                             static_cast<double>(i) / (num_points - 1)));
+    point.set_object_id(object_id);
+    point.set_timestamp(when + tracktable::seconds(60 * i));
+    path.push_back(point);
+    }
+  return path;
+}
+
+// Build a trajectory that wanders back and forth near a point
+trajectory_type wander(std::string const& object_id, point_type const& center)
+{
+  trajectory_type path;
+  tracktable::Timestamp when = tracktable::time_from_string("2020-01-01 00:00:00");
+  for (int i = 0; i < 40; ++i)
+    {
+    point_type point(center);
+    point.set_longitude(center.longitude() + ((i % 4) < 2 ? 1.5 : -1.5));
+    point.set_latitude(center.latitude() + ((i % 3) - 1) * 1.0);
+    point.set_object_id(object_id);
+    point.set_timestamp(when + tracktable::seconds(60 * i));
+    path.push_back(point);
+    }
+  return path;
+}
+
+// ----------------------------------------------------------------------
+
+int check_pair(portal_pair_type const& pair,
+               point_type const& origin,
+               point_type const& destination,
+               std::size_t expected_value)
+{
+  int error_count = 0;
+  if (pair.value != expected_value || pair.contributors.size() != expected_value)
+    {
+    std::cerr << "ERROR: Expected portal pair value " << expected_value
+              << " but got " << pair.value << " with "
+              << pair.contributors.size() << " contributors\n";
+    ++error_count;
+    }
+
+  bool forward = (boost::geometry::covered_by(origin, pair.first_portal)
+                  && boost::geometry::covered_by(destination, pair.second_portal));
+  bool backward = (boost::geometry::covered_by(destination, pair.first_portal)
+                   && boost::geometry::covered_by(origin, pair.second_portal));
+  if (!forward && !backward)
+    {
+    std::cerr << "ERROR: Portal pair does not contain the origin and destination\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_portal_discovery()
+{
+  int error_count = 0;
+
+  point_type denver(make_point(-104.7, 39.9));
+  point_type atlanta(make_point(-84.4, 33.6));
+  point_type seattle(make_point(-122.3, 47.4));
+  point_type phoenix(make_point(-112.0, 33.4));
+  point_type chicago(make_point(-87.9, 42.0));
+
+  std::vector<std::shared_ptr<trajectory_type> > trajectories;
+  for (int i = 0; i < 30; ++i)
+    {
+    std::ostringstream name;
+    name << "DEN-ATL-" << i;
+    trajectories.push_back(std::make_shared<trajectory_type>(
+      fly(name.str(), denver, atlanta, 50 + i)));
+    }
+  for (int i = 0; i < 20; ++i)
+    {
+    std::ostringstream name;
+    name << "PHX-SEA-" << i;
+    trajectories.push_back(std::make_shared<trajectory_type>(
+      fly(name.str(), phoenix, seattle, 40 + i)));
+    }
+  for (int i = 0; i < 20; ++i)
+    {
+    std::ostringstream name;
+    name << "wander-" << i;
+    trajectories.push_back(std::make_shared<trajectory_type>(
+      wander(name.str(), chicago)));
+    }
+
+  discovery_type discovery(make_point(-125, 25), make_point(-65, 50), 12, 5);
+  discovery.set_depth(4);
+  discovery.set_minimum_value(10);
+  discovery.set_minimum_separation(100);
+  discovery.set_num_threads(4);
+
+  std::vector<portal_pair_type> pairs(
+    discovery.find_portal_pairs(trajectories.begin(), trajectories.end()));
+
+  if (pairs.size() != 2)
+    {
+    std::cerr << "ERROR: Expected 2 portal pairs but found " << pairs.size() << "\n";
+    return error_count + 1;
+    }
+
+  error_count += check_pair(pairs[0], denver, atlanta, 30);
+  error_count += check_pair(pairs[1], phoenix, seattle, 20);
+  for (std::size_t i = 0; i < pairs[0].contributors.size(); ++i)
+    {
+    if (pairs[0].contributors[i] != i)
+      {
+      std::cerr << "ERROR: Unexpected contributor " << pairs[0].contributors[i]
+                << " in first pair\n";
+      ++error_count;
+      break;
+      }
+    }
+
+  // A single thread must find exactly the same thing
+  discovery.set_num_threads(1);
+  std::vector<portal_pair_type> serial_pairs(
+    discovery.find_portal_pairs(trajectories.begin(), trajectories.end()));
+  if (serial_pairs.size() != pairs.size()
+      || serial_pairs[0].contributors != pairs[0].contributors
+      || serial_pairs[1].contributors != pairs[1].contributors)
+    {
+    std::cerr << "ERROR: Serial and parallel portal discovery disagree\n";
+    ++error_count;
+    }
+
+  // Limiting the number of pairs stops after the best one
+  discovery.set_maximum_pairs(1);
+  if (discovery.find_portal_pairs(trajectories.begin(), trajectories.end()).size() != 1)
+    {
+    std::cerr << "ERROR: Maximum pair count was not respected\n";
+    ++error_count;
+    }
+
+  // Both routes are under 3000 km, so neither pair may be reported
+  discovery.set_maximum_pairs(0);
+  discovery.set_minimum_separation(3000);
+  std::size_t num_far_pairs = discovery.find_portal_pairs(trajectories.begin(), trajectories.end()).size();
+  if (num_far_pairs != 0)
+    {
+    std::cerr << "ERROR: Expected no pairs 3000 km apart but found " << num_far_pairs << "\n";
+    ++error_count;
+    }
+
+  if (discovery_type(make_point(-125, 25), make_point(-65, 50)).minimum_separation() != 1000)
+    {
+    std::cerr << "ERROR: Default minimum separation should be 1000 km\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+// Cartesian coordinates do not wrap, so a segment more than 180 units
+// wide must still mark every cell it crosses.  These segments start
+// and end outside the search area; only the cells in between can
+// produce a pair.
+int test_wide_cartesian_segments()
+{
+  typedef tracktable::domain::cartesian2d::trajectory_type cartesian_trajectory_type;
+  typedef tracktable::domain::cartesian2d::trajectory_point_type cartesian_point_type;
+  typedef tracktable::PortalDiscovery<cartesian_trajectory_type> cartesian_discovery_type;
+
+  std::vector<cartesian_trajectory_type> trajectories;
+  tracktable::Timestamp when = tracktable::time_from_string("2020-01-01 00:00:00");
+  for (int i = 0; i < 20; ++i)
+    {
+    cartesian_trajectory_type path;
+    double y = 60 + 0.5 * i;
+    cartesian_point_type start, finish;
+    start[0] = -500;
+    start[1] = y;
+    finish[0] = 1500;
+    finish[1] = y;
+    start.set_timestamp(when);
+    finish.set_timestamp(when + tracktable::hours(1));
+    path.push_back(start);
+    path.push_back(finish);
+    trajectories.push_back(path);
+    }
+
+  cartesian_point_type min_corner, max_corner;
+  min_corner[0] = 0;
+  min_corner[1] = 0;
+  max_corner[0] = 1000;
+  max_corner[1] = 100;
+  cartesian_discovery_type discovery(min_corner, max_corner, 10, 1);
+  discovery.set_depth(2);
+  discovery.set_minimum_value(10);
+  discovery.set_minimum_separation(500);
+
+  std::vector<cartesian_discovery_type::portal_pair_type> pairs(
+    discovery.find_portal_pairs(trajectories.begin(), trajectories.end()));
+  if (pairs.size() != 1 || pairs[0].value != 20)
+    {
+    std::cerr << "ERROR: Expected one Cartesian pair with value 20 but found "
+              << pairs.size() << " pairs\n";
+    return 1;
+    }
+  return 0;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_portal_discovery();
+  error_count += test_wide_cartesian_segments();
+  return error_count;
+}
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/AssembleTrajectories.h>
+#include <tracktable/Analysis/ReorderBuffer.h>
+#include <tracktable/Domain/Cartesian2D.h>
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::cartesian2d::trajectory_type trajectory_type;
+typedef tracktable::domain::cartesian2d::trajectory_point_type point_type;
+typedef tracktable::ReorderBuffer<point_type> buffer_type;
+typedef tracktable::AssembleTrajectories<trajectory_type, std::vector<point_type>::iterator> assembler_type;
+
+tracktable::Timestamp const Start(tracktable::time_from_string("2020-01-01 00:00:00"));
+
+// ----------------------------------------------------------------------
+
+point_type make_point(std::string const& object_id, int second, double x, double y)
+{
+  point_type point;
+  point.set_object_id(object_id);
+  point.set_timestamp(Start + tracktable::seconds(second));
+  point[0] = x;
+  point[1] = y;
+  return point;
+}
+
+std::vector<trajectory_type> assemble_all(assembler_type& assembler)
+{
+  std::vector<trajectory_type> result;
+  for (assembler_type::iterator iter = assembler.begin(); iter != assembler.end(); ++iter)
+    {
+    result.push_back(*iter);
+    }
+  return result;
+}
+
+int seconds_since_start(point_type const& point)
+{
+  return static_cast<int>((point.timestamp() - Start).total_seconds());
+}
+
+// ----------------------------------------------------------------------
+
+int test_buffer()
+{
+  int error_count = 0;
+
+  buffer_type buffer(tracktable::seconds(10));
+  int arrivals[] = { 0, 5, 3, 12, 8, 20, 1, 11, 25, 40 };
+  std::vector<int> released;
+  point_type point;
+  for (int second : arrivals)
+    {
+    buffer.push(make_point("A", second, 0, 0));
+    while (buffer.pop(point))
+      {
+      released.push_back(seconds_since_start(point));
+      }
+    }
+
+  // 1 arrives after the watermark has reached 10 and is dropped
+  if (buffer.dropped_point_count() != 1)
+    {
+    std::cerr << "ERROR: Expected 1 dropped point, got " << buffer.dropped_point_count() << "\n";
+    ++error_count;
+    }
+  // 3, 8 and 11 arrive out of order but in time
+  if (buffer.late_point_count() != 3)
+    {
+    std::cerr << "ERROR: Expected 3 late points, got " << buffer.late_point_count() << "\n";
+    ++error_count;
+    }
+  if (buffer.watermark() != Start + tracktable::seconds(30) || buffer.size() != 1)
+    {
+    std::cerr << "ERROR: Expected watermark at 30s with 1 point waiting, got "
+              << buffer.watermark() << " with " << buffer.size() << "\n";
+    ++error_count;
+    }
+
+  buffer.flush();
+  while (buffer.pop(point))
+    {
+    released.push_back(seconds_since_start(point));
+    }
+
+  std::vector<int> expected = { 0, 3, 5, 8, 11, 12, 20, 25, 40 };
+  if (released != expected)
+    {
+    std::cerr << "ERROR: Points came out in the wrong order:";
+    for (int second : released)
+      {
+      std::cerr << " " << second;
+      }
+    std::cerr << "\n";
+    ++error_count;
+    }
+
+  // A full buffer releases its oldest point early
+  buffer_type small(tracktable::minutes(5), 3);
+  for (int second = 10; second > 0; --second)
+    {
+    small.push(make_point("B", second, 0, 0));
+    }
+  if (small.size() != 4 || !small.pop(point) || seconds_since_start(point) != 7
+      || small.dropped_point_count() != 6)
+    {
+    std::cerr << "ERROR: Capped buffer did not release its oldest point and drop later ones\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+// Several objects moving in parallel, delivered with up to 30 seconds
+// of random delay.  Reordering should give back exactly the
+// trajectories that sorted input gives.
+int test_assembly()
+{
+  int error_count = 0;
+
+  std::vector<point_type> sorted_points;
+  for (int second = 0; second < 600; second += 5)
+    {
+    for (int object = 0; object < 4; ++object)
+      {
+      sorted_points.push_back(make_point(std::string(1, 'A' + object), second, second, object));
+      }
+    }
+
+  std::mt19937 generator(1234);
+  std::uniform_int_distribution<int> delay(0, 30);
+  std::vector<std::pair<int, std::size_t> > arrival_order;
+  for (std::size_t i = 0; i < sorted_points.size(); ++i)
+    {
+    arrival_order.push_back(std::make_pair(seconds_since_start(sorted_points[i]) + delay(generator), i));
+    }
+  std::sort(arrival_order.begin(), arrival_order.end());
+  std::vector<point_type> shuffled_points;
+  for (std::size_t i = 0; i < arrival_order.size(); ++i)
+    {
+    shuffled_points.push_back(sorted_points[arrival_order[i].second]);
+    }
+
+  assembler_type sorted_assembler(sorted_points.begin(), sorted_points.end());
+  sorted_assembler.set_separation_time(tracktable::seconds(20));
+  sorted_assembler.set_separation_distance(100);
+  std::vector<trajectory_type> expected(assemble_all(sorted_assembler));
+
+  assembler_type reordering_assembler(shuffled_points.begin(), shuffled_points.end());
+  reordering_assembler.set_separation_time(tracktable::seconds(20));
+  reordering_assembler.set_separation_distance(100);
+  reordering_assembler.set_maximum_lateness(tracktable::seconds(30));
+
+  std::vector<trajectory_type> reordered;
+  assembler_type::iterator iter(reordering_assembler.begin());
+  for ( ; iter != reordering_assembler.end(); ++iter)
+    {
+    reordered.push_back(*iter);
+    }
+
+  if (iter.dropped_point_count() != 0 || iter.late_point_count() == 0)
+    {
+    std::cerr << "ERROR: Expected some late points and no dropped ones, got "
+              << iter.late_point_count() << " late and "
+              << iter.dropped_point_count() << " dropped\n";
+    ++error_count;
+    }
+
+  if (expected.size() != 4 || reordered.size() != expected.size())
+    {
+    std::cerr << "ERROR: Expected 4 trajectories from both assemblers, got "
+              << expected.size() << " and " << reordered.size() << "\n";
+    return error_count + 1;
+    }
+
+  for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+    bool found = false;
+    for (std::size_t j = 0; j < reordered.size() && !found; ++j)
+      {
+      found = (reordered[j].object_id() == expected[i].object_id()
+               && reordered[j].size() == expected[i].size()
+               && std::equal(reordered[j].begin(), reordered[j].end(), expected[i].begin()));
+      }
+    if (!found)
+      {
+      std::cerr << "ERROR: Reordered input did not reproduce trajectory for "
+                << expected[i].object_id() << "\n";
+      ++error_count;
+      }
+    }
+
+  // Without a lateness the shuffled input splits trajectories
+  assembler_type plain_assembler(shuffled_points.begin(), shuffled_points.end());
+  plain_assembler.set_separation_time(tracktable::seconds(20));
+  plain_assembler.set_separation_distance(100);
+  std::vector<trajectory_type> split(assemble_all(plain_assembler));
+  if (split.size() <= expected.size())
+    {
+    std::cerr << "ERROR: Shuffled input should have split trajectories without reordering\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  error_count += test_buffer();
+  error_count += test_assembly();
+
+  return error_count;
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/AssembleTrajectories.h>
+#include <tracktable/Analysis/StreamingSimplification.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::cartesian2d::trajectory_type trajectory_type;
+typedef tracktable::domain::cartesian2d::trajectory_point_type point_type;
+
+tracktable::Timestamp const Start(tracktable::time_from_string("2020-01-01 00:00:00"));
+
+// ----------------------------------------------------------------------
+
+point_type make_point(std::string const& object_id, int second, double x, double y)
+{
+  point_type point;
+  point.set_object_id(object_id);
+  point.set_timestamp(Start + tracktable::seconds(second));
+  point[0] = x;
+  point[1] = y;
+  return point;
+}
+
+// Move east at 1 unit/s, stop for a while, then move east again.
+// Spatially this is a straight line, so only a time-aware
+// simplification keeps the stop.
+trajectory_type stop_and_go(std::string const& object_id)
+{
+  trajectory_type path;
+  double x = 0;
+  for (int i = 0; i < 150; ++i)
+    {
+    path.push_back(make_point(object_id, i, x, 0));
+    if (i < 50 || i >= 100)
+      {
+      x += 1;
+      }
+    }
+  return path;
+}
+
+trajectory_type random_walk(std::string const& object_id, std::mt19937& generator)
+{
+  std::normal_distribution<double> jitter(0, 0.3);
+  trajectory_type path;
+  double x = 0, y = 0, dx = 1, dy = 0;
+  for (int i = 0; i < 300; ++i)
+    {
+    path.push_back(make_point(object_id, 2 * i, x, y));
+    dx += jitter(generator);
+    dy += jitter(generator);
+    x += dx;
+    y += dy;
+    }
+  return path;
+}
+
+// Largest distance between an original point and where the
+// simplified trajectory says the object was at that time
+double worst_synchronized_error(trajectory_type const& original, trajectory_type const& simplified)
+{
+  double worst = 0;
+  for (std::size_t i = 0; i < original.size(); ++i)
+    {
+    point_type estimate(tracktable::point_at_time(simplified, original[i].timestamp()));
+    worst = std::max(worst, tracktable::distance(estimate, original[i]));
+    }
+  return worst;
+}
+
+// ----------------------------------------------------------------------
+
+int test_simplifier()
+{
+  int error_count = 0;
+
+  trajectory_type straight;
+  for (int i = 0; i < 100; ++i)
+    {
+    straight.push_back(make_point("straight", i, i, 2 * i));
+    }
+  trajectory_type result(tracktable::simplify_in_time(straight, 0.01, tracktable::SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE, 1000));
+  if (result.size() != 2)
+    {
+    std::cerr << "ERROR: Constant-velocity path should simplify to 2 points, got " << result.size() << "\n";
+    ++error_count;
+    }
+  result = tracktable::simplify_in_time(straight, 0.01, tracktable::SimplificationMetric::DEAD_RECKONING, 1000);
+  if (result.size() != 2)
+    {
+    std::cerr << "ERROR: Dead reckoning should simplify a constant-velocity path to 2 points, got "
+              << result.size() << "\n";
+    ++error_count;
+    }
+  result = tracktable::simplify_in_time(straight, 0.01, tracktable::SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE, 10);
+  if (result.size() < 11 || result.size() > 12)
+    {
+    std::cerr << "ERROR: Window of 10 should keep about every tenth point, kept " << result.size() << "\n";
+    ++error_count;
+    }
+
+  trajectory_type stops(stop_and_go("stops"));
+  result = tracktable::simplify_in_time(stops, 0.5);
+  if (result.size() != 4)
+    {
+    std::cerr << "ERROR: Stop-and-go path should keep 4 points, kept " << result.size() << "\n";
+    ++error_count;
+    }
+  if (tracktable::simplify(stops, 0.5).size() != 2)
+    {
+    std::cerr << "ERROR: Expected shape-only simplification to lose the stop\n";
+    ++error_count;
+    }
+
+  std::mt19937 generator(42);
+  trajectory_type walk(random_walk("walk", generator));
+  double tolerance = 2.0;
+  result = tracktable::simplify_in_time(walk, tolerance);
+  double worst = worst_synchronized_error(walk, result);
+  if (worst > tolerance * (1 + 1e-9))
+    {
+    std::cerr << "ERROR: Synchronized error " << worst << " exceeds tolerance " << tolerance << "\n";
+    ++error_count;
+    }
+  if (result.size() >= walk.size() || result.front() != walk.front() || result.back() != walk.back())
+    {
+    std::cerr << "ERROR: Simplified walk should be shorter and keep both endpoints\n";
+    ++error_count;
+    }
+
+  // Terrestrial trajectories use great-circle interpolation and km
+  typedef tracktable::domain::terrestrial::trajectory_type terrestrial_trajectory_type;
+  typedef tracktable::domain::terrestrial::trajectory_point_type terrestrial_point_type;
+  terrestrial_trajectory_type flight;
+  terrestrial_point_type origin, destination;
+  origin.set_longitude(-100);
+  origin.set_latitude(35);
+  destination.set_longitude(-80);
+  destination.set_latitude(40);
+  for (int i = 0; i <= 50; ++i)
+    {
+    terrestrial_point_type point(tracktable::interpolate(origin, destination, i / 50.0));
+    point.set_timestamp(Start + tracktable::minutes(i));
+    flight.push_back(point);
+    }
+  if (tracktable::simplify_in_time(flight, 0.1).size() != 2)
+    {
+    std::cerr << "ERROR: Great-circle flight at constant speed should simplify to 2 points\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_assembly_and_batch()
+{
+  int error_count = 0;
+  std::mt19937 generator(7);
+  std::vector<trajectory_type> originals;
+  for (int i = 0; i < 6; ++i)
+    {
+    std::ostringstream name;
+    name << "object" << i;
+    originals.push_back(i % 2 ? random_walk(name.str(), generator) : stop_and_go(name.str()));
+    }
+
+  // Interleave points from every object in time order
+  std::vector<point_type> points;
+  for (int second = 0; second < 600; ++second)
+    {
+    for (std::size_t i = 0; i < originals.size(); ++i)
+      {
+      for (std::size_t j = 0; j < originals[i].size(); ++j)
+        {
+        if (originals[i][j].timestamp() == Start + tracktable::seconds(second))
+          {
+          points.push_back(originals[i][j]);
+          }
+        }
+      }
+    }
+
+  double tolerance = 1.5;
+  typedef tracktable::AssembleTrajectories<trajectory_type, std::vector<point_type>::const_iterator> assembler_type;
+  assembler_type assembler(points.begin(), points.end());
+  assembler.set_separation_distance(1000);
+  assembler.set_minimum_trajectory_length(100);
+  assembler.set_simplification_tolerance(tolerance);
+
+  std::map<std::string, trajectory_type> assembled;
+  for (assembler_type::iterator iter = assembler.begin(); iter != assembler.end(); ++iter)
+    {
+    trajectory_type trajectory(*iter);
+    assembled[trajectory.object_id()] = trajectory;
+    }
+
+  if (assembled.size() != originals.size())
+    {
+    std::cerr << "ERROR: Expected " << originals.size() << " trajectories from assembly, got "
+              << assembled.size() << "\n";
+    ++error_count;
+    }
+
+  std::vector<trajectory_type> batch(
+    tracktable::simplify_in_time(originals.begin(), originals.end(), tolerance,
+                                 tracktable::SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE,
+                                 64, 4));
+  for (std::size_t i = 0; i < originals.size(); ++i)
+    {
+    trajectory_type const& inline_result(assembled[originals[i].object_id()]);
+    if (inline_result.size() != batch[i].size()
+        || !std::equal(inline_result.begin(), inline_result.end(), batch[i].begin()))
+      {
+      std::cerr << "ERROR: Assembler and batch simplification disagree for "
+                << originals[i].object_id() << "\n";
+      ++error_count;
+      }
+    if (worst_synchronized_error(originals[i], batch[i]) > tolerance * (1 + 1e-9))
+      {
+      std::cerr << "ERROR: Batch simplification exceeded the tolerance for "
+                << originals[i].object_id() << "\n";
+      ++error_count;
+      }
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_simplifier();
+  error_count += test_assembly_and_batch();
+  return error_count;
+}
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/TrajectoryFilterPipeline.h>
+#include <tracktable/Core/FloatingPointComparison.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::domain::terrestrial::base_point_type base_point_type;
+typedef tracktable::domain::terrestrial::box_type box_type;
+typedef tracktable::TrajectoryFilterPipeline<trajectory_type> pipeline_type;
+typedef pipeline_type::feature_cache_type features_type;
+
+// ----------------------------------------------------------------------
+
+// Build a path along the equator.  Each leg goes `leg_length` steps of
+// 0.01 degrees east or west, alternating, starting eastward.
+trajectory_type build_path(std::string const& object_id, int num_legs, int leg_length)
+{
+  trajectory_type path;
+  tracktable::Timestamp when = tracktable::time_from_string("2020-01-01 00:00:00");
+  double longitude = 0;
+  double step = 0.01;
+
+  for (int leg = 0; leg < num_legs; ++leg)
+    {
+    for (int i = 0; i < leg_length; ++i)
+      {
+      point_type point;
+      point.set_object_id(object_id);
+      point.set_timestamp(when);
+      point.set_longitude(longitude);
+      point.set_latitude(0);
+      path.push_back(point);
+      longitude += step;
+      when += tracktable::seconds(60);
+      }
+    step = -step;
+    }
+  return path;
+}
+
+// ----------------------------------------------------------------------
+
+int check_value(std::string const& label, double actual, double expected)
+{
+  if (!tracktable::almost_equal(actual, expected, 1e-6))
+    {
+    std::cerr << "ERROR: " << label << ": expected " << expected
+              << " but got " << actual << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+// ----------------------------------------------------------------------
+
+int test_feature_cache()
+{
+  int error_count = 0;
+  trajectory_type straight = build_path("straight", 1, 20);
+  features_type features;
+  features.reset(straight);
+
+  error_count += check_value("Segment count", features.segment_lengths().size(), 19);
+  error_count += check_value("Heading count", features.headings().size(), 20);
+  error_count += check_value("Turn angle count", features.turn_angles().size(), 18);
+  error_count += check_value("Length", features.length(), tracktable::length(straight));
+  error_count += check_value("Length ratio",
+                             tracktable::filter_metrics::length_ratio(features), 1.0);
+  error_count += check_value("Heading", features.headings().front(), 90.0);
+  error_count += check_value("Curvature",
+                             tracktable::filter_metrics::curvature(features), 0.0);
+  error_count += check_value("Straight fraction",
+                             tracktable::filter_metrics::straight_fraction(features), 0.0);
+  error_count += check_value("Turnarounds on straight path",
+                             tracktable::filter_metrics::turn_arounds(features), 0);
+
+  trajectory_type mapping = build_path("mapping", 6, 10);
+  features.reset(mapping);
+  error_count += check_value("Turnarounds on mapping path",
+                             tracktable::filter_metrics::turn_arounds(features), 5);
+  if (features.headings().size() != mapping.size())
+    {
+    std::cerr << "ERROR: Feature cache kept headings from previous trajectory\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_pipeline()
+{
+  int error_count = 0;
+  std::vector<trajectory_type> trajectories;
+  for (int i = 0; i < 200; ++i)
+    {
+    std::ostringstream name;
+    name << "object" << i;
+    // Lengths cycle through 1..5 legs and 3 different leg lengths
+    trajectories.push_back(build_path(name.str(), 1 + i % 5, 6 + 2 * (i % 3)));
+    }
+
+  pipeline_type pipeline;
+  pipeline.add_range_filter("length", tracktable::filter_metrics::length<features_type>, 8.0);
+  pipeline.add_range_filter("turn-arounds", tracktable::filter_metrics::turn_arounds<features_type>, 2);
+  pipeline.add_predicate("even-id", [](features_type& features) {
+      return (features.trajectory().object_id().back() - '0') % 2 == 0;
+    });
+
+  std::vector<bool> expected;
+  std::size_t expected_survivors = 0;
+  for (std::size_t i = 0; i < trajectories.size(); ++i)
+    {
+    expected.push_back(pipeline.keep(trajectories[i]));
+    if (expected.back())
+      {
+      ++expected_survivors;
+      }
+    }
+
+  std::vector<int> outcome(pipeline.evaluate(trajectories.begin(), trajectories.end(), 4));
+  for (std::size_t i = 0; i < outcome.size(); ++i)
+    {
+    if ((outcome[i] == pipeline_type::PASSED_ALL_STAGES) != expected[i])
+      {
+      std::cerr << "ERROR: Parallel evaluation disagrees with serial evaluation for trajectory "
+                << i << "\n";
+      ++error_count;
+      }
+    }
+
+  std::vector<trajectory_type> survivors(trajectories);
+  pipeline.filter(survivors, 4);
+
+  if (survivors.size() != expected_survivors || expected_survivors == 0)
+    {
+    std::cerr << "ERROR: Expected " << expected_survivors
+              << " trajectories to survive filtering but got "
+              << survivors.size() << "\n";
+    ++error_count;
+    }
+
+  std::size_t total_rejected = 0;
+  for (std::size_t i = 0; i < pipeline.size(); ++i)
+    {
+    total_rejected += pipeline.rejection_counts()[i];
+    if (pipeline.rejection_counts()[i] == 0)
+      {
+      std::cerr << "ERROR: Expected stage " << pipeline.stage_name(i)
+                << " to reject something\n";
+      ++error_count;
+      }
+    }
+  if (total_rejected + survivors.size() != trajectories.size())
+    {
+    std::cerr << "ERROR: Rejection counts do not add up\n";
+    ++error_count;
+    }
+
+  // Survivors must keep their original order
+  std::size_t next_expected = 0;
+  for (std::size_t i = 0; i < survivors.size(); ++i)
+    {
+    while (next_expected < expected.size() && !expected[next_expected])
+      {
+      ++next_expected;
+      }
+    if (next_expected >= trajectories.size() ||
+        survivors[i].object_id() != trajectories[next_expected].object_id())
+      {
+      std::cerr << "ERROR: Survivor " << i << " is out of order\n";
+      ++error_count;
+      break;
+      }
+    ++next_expected;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_stages()
+{
+  int error_count = 0;
+  std::vector<trajectory_type> trajectories;
+  for (int i = 0; i < 50; ++i)
+    {
+    std::ostringstream name;
+    name << "object" << i;
+    trajectory_type path = build_path(name.str(), 1, 20);
+    // Altitude climbs 100 per point from a different start for each path
+    for (std::size_t j = 0; j < path.size(); ++j)
+      {
+      path[j].set_property("altitude", 100.0 * (i + static_cast<int>(j)));
+      }
+    // Shift every other path north so it misses the box
+    if (i % 2 == 1)
+      {
+      for (auto& point : path)
+        {
+        point.set_latitude(10);
+        }
+      }
+    trajectories.push_back(path);
+    }
+
+  tracktable::Timestamp start = tracktable::time_from_string("2020-01-01 00:05:00");
+  tracktable::Timestamp finish = tracktable::time_from_string("2020-01-01 00:10:30");
+  box_type box(base_point_type(-1, -1), base_point_type(1, 1));
+
+  pipeline_type pipeline;
+  pipeline.add_predicate("box", tracktable::filter_predicates::intersects_box<features_type>(box));
+  pipeline.add_transform("time window",
+                         tracktable::filter_transforms::clip_to_time_window<trajectory_type>(start, finish));
+  // After clipping, path i covers altitudes 100*(i+5) to 100*(i+10.5)
+  pipeline.add_predicate("altitude",
+                         tracktable::filter_predicates::property_in_range<features_type>("altitude", 0, 1800));
+  if (!pipeline.has_transforms())
+    {
+    std::cerr << "ERROR: Pipeline does not know it has transforms\n";
+    ++error_count;
+    }
+
+  std::vector<trajectory_type> survivors(trajectories);
+  pipeline.filter(survivors, 3);
+
+  // Even paths with 100*(i+5) <= 1800, i.e. i <= 13
+  if (survivors.size() != 7)
+    {
+    std::cerr << "ERROR: Expected 7 survivors but got " << survivors.size() << "\n";
+    ++error_count;
+    }
+  for (auto const& path : survivors)
+    {
+    if (path.start_time() != start || path.end_time() != finish)
+      {
+      std::cerr << "ERROR: Survivor " << path.object_id() << " was not clipped to the time window\n";
+      ++error_count;
+      }
+    }
+  if (trajectories[0].size() != 20)
+    {
+    std::cerr << "ERROR: Filtering a copy changed the original\n";
+    ++error_count;
+    }
+  if (!pipeline.keep(trajectories[0]) || pipeline.keep(trajectories[1]) || pipeline.keep(trajectories[20]))
+    {
+    std::cerr << "ERROR: keep() disagrees with filter()\n";
+    ++error_count;
+    }
+  error_count += check_value("Box rejections", pipeline.rejection_counts()[0], 25);
+  error_count += check_value("Altitude rejections", pipeline.rejection_counts()[2], 18);
+
+  // Paths below the interval on one side and above on the other pass
+  trajectory_type spanning = build_path("spanning", 1, 2);
+  spanning[0].set_property("altitude", -5.0);
+  spanning[1].set_property("altitude", 5000.0);
+  features_type features;
+  features.reset(spanning);
+  if (!tracktable::filter_predicates::property_in_range<features_type>("altitude", 0, 1800)(features))
+    {
+    std::cerr << "ERROR: Path climbing through the altitude range was rejected\n";
+    ++error_count;
+    }
+
+  // Streaming in small batches must give the same answer
+  std::vector<trajectory_type> streamed;
+  pipeline.filter_sequence(trajectories.begin(), trajectories.end(),
+                           std::back_inserter(streamed), 2, 4);
+  if (streamed.size() != survivors.size())
+    {
+    std::cerr << "ERROR: filter_sequence kept " << streamed.size()
+              << " trajectories; filter kept " << survivors.size() << "\n";
+    ++error_count;
+    }
+  else
+    {
+    for (std::size_t i = 0; i < streamed.size(); ++i)
+      {
+      if (streamed[i] != survivors[i])
+        {
+        std::cerr << "ERROR: filter_sequence result " << i << " differs from filter\n";
+        ++error_count;
+        }
+      }
+    }
+  error_count += check_value("Streamed box rejections", pipeline.rejection_counts()[0], 25);
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_feature_cache();
+  error_count += test_pipeline();
+  error_count += test_stages();
+  return error_count;
+}
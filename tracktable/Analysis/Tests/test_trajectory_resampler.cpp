@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/TrajectoryResampler.h>
+#include <tracktable/Core/FloatingPointComparison.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::cartesian2d::trajectory_type trajectory_type;
+typedef tracktable::domain::cartesian2d::trajectory_point_type point_type;
+typedef tracktable::TrajectoryResampler<trajectory_type> resampler_type;
+
+tracktable::Timestamp const Start(tracktable::time_from_string("2020-01-01 00:00:00"));
+
+// ----------------------------------------------------------------------
+
+// Points every 10 seconds moving 1 unit per second along x
+trajectory_type build_path(std::string const& object_id, int num_points)
+{
+  static char const* statuses[] = { "a", "b", "c", "d" };
+  trajectory_type path;
+  for (int i = 0; i < num_points; ++i)
+    {
+    point_type point;
+    point.set_object_id(object_id);
+    point.set_timestamp(Start + tracktable::seconds(10 * i));
+    point[0] = 10 * i;
+    point[1] = 0;
+    point.set_property("speed", 2.0 * 10 * i);
+    point.set_property("status", std::string(statuses[i % 4]));
+    point.set_property("unwanted", 1.0);
+    path.push_back(point);
+    }
+  return path;
+}
+
+int check_value(std::string const& label, double actual, double expected)
+{
+  if (!tracktable::almost_equal(actual, expected, 1e-9))
+    {
+    std::cerr << "ERROR: " << label << ": expected " << expected
+              << " but got " << actual << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+// ----------------------------------------------------------------------
+
+int test_single_trajectory()
+{
+  int error_count = 0;
+  trajectory_type path(build_path("single", 4));
+  path.set_property("flight", std::string("TT123"));
+
+  resampler_type resampler;
+  resampler.interpolate_property("speed");
+  resampler.copy_property("status");
+
+  trajectory_type result(resampler.resample(path, tracktable::seconds(5)));
+  error_count += check_value("Sample count", result.size(), 7);
+  for (std::size_t i = 0; i < result.size(); ++i)
+    {
+    error_count += check_value("x", result[i][0], 5.0 * i);
+    error_count += check_value("speed", result[i].real_property("speed"), 10.0 * i);
+    if (result[i].timestamp() != Start + tracktable::seconds(5 * i))
+      {
+      std::cerr << "ERROR: Sample " << i << " has the wrong timestamp\n";
+      ++error_count;
+      }
+    if (result[i].has_property("unwanted"))
+      {
+      std::cerr << "ERROR: Property that was not asked for was carried along\n";
+      ++error_count;
+      }
+    }
+  if (result[3].string_property("status") != "b" || result[1].string_property("status") != "a")
+    {
+    std::cerr << "ERROR: Copied property did not come from the nearer point\n";
+    ++error_count;
+    }
+  if (result.string_property("flight") != "TT123" || result.object_id() != "single")
+    {
+    std::cerr << "ERROR: Trajectory properties or object ID were not carried along\n";
+    ++error_count;
+    }
+  if (result.uuid() != path.uuid() || result.uuid().is_nil())
+    {
+    std::cerr << "ERROR: Resampled trajectory does not have the original's UUID\n";
+    ++error_count;
+    }
+
+  // Explicit times outside the path are skipped
+  std::vector<tracktable::Timestamp> times;
+  times.push_back(Start - tracktable::seconds(10));
+  times.push_back(Start + tracktable::seconds(12));
+  times.push_back(Start + tracktable::seconds(12));
+  times.push_back(Start + tracktable::seconds(30));
+  times.push_back(Start + tracktable::seconds(31));
+  result = resampler.resample(path, times);
+  error_count += check_value("Explicit sample count", result.size(), 3);
+  error_count += check_value("Explicit sample x", result[0][0], 12);
+  error_count += check_value("Last sample x", result[2][0], 30);
+
+  std::swap(times[0], times[1]);
+  bool threw = false;
+  try
+    {
+    resampler.resample(path, times);
+    }
+  catch (std::invalid_argument&)
+    {
+    threw = true;
+    }
+  if (!threw)
+    {
+    std::cerr << "ERROR: Unsorted sample times were accepted\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_terrestrial()
+{
+  typedef tracktable::domain::terrestrial::trajectory_type terrestrial_trajectory_type;
+  typedef tracktable::domain::terrestrial::trajectory_point_type terrestrial_point_type;
+
+  int error_count = 0;
+  terrestrial_trajectory_type path;
+  for (int i = 0; i < 20; ++i)
+    {
+    terrestrial_point_type point;
+    point.set_object_id("flight");
+    point.set_timestamp(Start + tracktable::seconds(37 * i + (i % 3) * 11));
+    point.set_longitude(-100 + 0.7 * i);
+    point.set_latitude(30 + 0.2 * i * (i % 2 ? 1 : -1));
+    path.push_back(point);
+    }
+
+  tracktable::TrajectoryResampler<terrestrial_trajectory_type> resampler;
+  terrestrial_trajectory_type result(resampler.resample(path, tracktable::seconds(13)));
+  for (std::size_t i = 0; i < result.size(); ++i)
+    {
+    terrestrial_point_type expected(tracktable::point_at_time(path, result[i].timestamp()));
+    error_count += check_value("Longitude", result[i].longitude(), expected.longitude());
+    error_count += check_value("Latitude", result[i].latitude(), expected.latitude());
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_collection()
+{
+  int error_count = 0;
+  std::vector<trajectory_type> paths;
+  for (int i = 0; i < 50; ++i)
+    {
+    std::ostringstream name;
+    name << "object" << i;
+    paths.push_back(build_path(name.str(), 2 + i % 7));
+    }
+
+  resampler_type resampler;
+  resampler.interpolate_property("speed");
+  resampler.set_num_threads(4);
+
+  std::vector<trajectory_type> resampled(resampler.resample(paths.begin(), paths.end(), tracktable::seconds(3)));
+  resampler_type::columns_type columns(resampler.resample_columns(paths.begin(), paths.end(), tracktable::seconds(3)));
+
+  error_count += check_value("Offset count", columns.offsets.size(), paths.size() + 1);
+  for (std::size_t i = 0; i < paths.size(); ++i)
+    {
+    trajectory_type serial(resampler.resample(paths[i], tracktable::seconds(3)));
+    if (serial != resampled[i])
+      {
+      std::cerr << "ERROR: Parallel resampling of trajectory " << i << " differs from serial\n";
+      ++error_count;
+      }
+    if (resampled[i].uuid() != paths[i].uuid())
+      {
+      std::cerr << "ERROR: Parallel resampling of trajectory " << i << " lost its UUID\n";
+      ++error_count;
+      }
+    if (columns.offsets[i+1] - columns.offsets[i] != serial.size()
+        || columns.object_ids[i] != paths[i].object_id())
+      {
+      std::cerr << "ERROR: Column layout is wrong for trajectory " << i << "\n";
+      ++error_count;
+      continue;
+      }
+    for (std::size_t j = 0; j < serial.size(); ++j)
+      {
+      std::size_t row = columns.offsets[i] + j;
+      error_count += check_value("Column x", columns.coordinates[0][row], serial[j][0]);
+      error_count += check_value("Column speed", columns.properties[0][row], serial[j].real_property("speed"));
+      }
+    }
+
+  // A shared time grid aligns every trajectory on the same instants
+  std::vector<tracktable::Timestamp> grid(
+    resampler_type::sample_times(Start, Start + tracktable::seconds(60), tracktable::seconds(20)));
+  resampled = resampler.resample(paths.begin(), paths.end(), grid);
+  error_count += check_value("Aligned sample count", resampled[6].size(), 4);
+  error_count += check_value("Aligned sample x", resampled[6][2][0], 40);
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_single_trajectory();
+  error_count += test_terrestrial();
+  error_count += test_collection();
+  return error_count;
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Analysis/TrajectorySimilaritySearch.h>
+#include <tracktable/Core/FloatingPointComparison.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::cartesian2d::trajectory_type trajectory_type;
+typedef tracktable::domain::cartesian2d::trajectory_point_type point_type;
+typedef tracktable::TrajectorySimilaritySearch<trajectory_type> search_type;
+
+// ----------------------------------------------------------------------
+
+trajectory_type make_trajectory(std::vector<std::pair<double, double> > const& coordinates)
+{
+  trajectory_type result;
+  for (std::size_t i = 0; i < coordinates.size(); ++i)
+    {
+    point_type point;
+    point[0] = coordinates[i].first;
+    point[1] = coordinates[i].second;
+    result.push_back(point);
+    }
+  return result;
+}
+
+// A wobbly path from a random start in a random direction
+trajectory_type random_walk(std::mt19937& generator)
+{
+  std::uniform_real_distribution<double> position(0, 100);
+  std::uniform_real_distribution<double> step(-1, 3);
+  std::uniform_int_distribution<int> length(10, 40);
+
+  trajectory_type result;
+  point_type point;
+  point[0] = position(generator);
+  point[1] = position(generator);
+  double dx = step(generator);
+  double dy = step(generator);
+  int num_points = length(generator);
+  for (int i = 0; i < num_points; ++i)
+    {
+    result.push_back(point);
+    point[0] += dx + 0.25 * step(generator);
+    point[1] += dy + 0.25 * step(generator);
+    }
+  return result;
+}
+
+int check_value(std::string const& label, double actual, double expected)
+{
+  if (!tracktable::almost_equal(actual, expected, 1e-9))
+    {
+    std::cerr << "ERROR: " << label << ": expected " << expected
+              << " but got " << actual << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+// ----------------------------------------------------------------------
+
+int test_distances()
+{
+  int error_count = 0;
+  trajectory_type line(make_trajectory({{0, 0}, {1, 0}, {2, 0}}));
+  trajectory_type above(make_trajectory({{0, 1}, {1, 1}, {2, 1}}));
+  trajectory_type shortcut(make_trajectory({{0, 0}, {2, 0}}));
+  trajectory_type reversed(make_trajectory({{2, 0}, {1, 0}, {0, 0}}));
+
+  error_count += check_value("Frechet parallel lines", tracktable::discrete_frechet_distance(line, above), 1);
+  error_count += check_value("DTW parallel lines", tracktable::dynamic_time_warping_distance(line, above), 3);
+  error_count += check_value("Hausdorff parallel lines", tracktable::hausdorff_distance(line, above), 1);
+
+  error_count += check_value("Frechet shortcut", tracktable::discrete_frechet_distance(line, shortcut), 1);
+  error_count += check_value("DTW shortcut", tracktable::dynamic_time_warping_distance(line, shortcut), 1);
+  error_count += check_value("Hausdorff shortcut", tracktable::hausdorff_distance(line, shortcut), 1);
+
+  error_count += check_value("Frechet reversed", tracktable::discrete_frechet_distance(line, reversed), 2);
+  error_count += check_value("Hausdorff reversed", tracktable::hausdorff_distance(line, reversed), 0);
+
+  error_count += check_value("Banded Frechet", tracktable::discrete_frechet_distance(line, above, 1), 1);
+  error_count += check_value("Banded DTW", tracktable::dynamic_time_warping_distance(line, shortcut, 1), 1);
+
+  double infinity = std::numeric_limits<double>::infinity();
+  if (tracktable::discrete_frechet_distance(line, above, 0, 0.5) != infinity
+      || tracktable::dynamic_time_warping_distance(line, above, 0, 2.5) != infinity
+      || tracktable::hausdorff_distance(line, above, 0.5) != infinity)
+    {
+    std::cerr << "ERROR: Distances did not stop early when over the cutoff\n";
+    ++error_count;
+    }
+  if (tracktable::discrete_frechet_distance(line, trajectory_type()) != infinity)
+    {
+    std::cerr << "ERROR: Distance to an empty trajectory should be infinite\n";
+    ++error_count;
+    }
+
+  // Terrestrial trajectories go through the same code
+  typedef tracktable::domain::terrestrial::trajectory_type terrestrial_trajectory_type;
+  typedef tracktable::domain::terrestrial::trajectory_point_type terrestrial_point_type;
+  terrestrial_trajectory_type flight;
+  for (int i = 0; i < 10; ++i)
+    {
+    terrestrial_point_type point;
+    point.set_longitude(-100 + i);
+    point.set_latitude(35);
+    flight.push_back(point);
+    }
+  error_count += check_value("Terrestrial self distance",
+                             tracktable::discrete_frechet_distance(flight, flight), 0);
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_search(tracktable::SimilarityMeasure measure, std::string const& name)
+{
+  int error_count = 0;
+  std::mt19937 generator(12345);
+
+  std::vector<trajectory_type> library;
+  for (int i = 0; i < 300; ++i)
+    {
+    library.push_back(random_walk(generator));
+    }
+
+  search_type search(measure, 8);
+  search.set_num_threads(4);
+  search.insert(library.begin(), library.end());
+
+  for (int q = 0; q < 5; ++q)
+    {
+    trajectory_type query(random_walk(generator));
+    std::size_t const k = 5;
+
+    std::vector<search_type::match_type> expected;
+    for (std::size_t i = 0; i < library.size(); ++i)
+      {
+      double exact = tracktable::trajectory_distance(measure, query, library[i], 8);
+      expected.push_back(search_type::match_type(i, exact));
+      if (search.lower_bound(query, library[i]) > exact + 1e-9)
+        {
+        std::cerr << "ERROR: " << name << ": lower bound exceeds exact distance for trajectory "
+                  << i << "\n";
+        ++error_count;
+        }
+      }
+    std::sort(expected.begin(), expected.end(),
+              [](search_type::match_type const& a, search_type::match_type const& b) {
+                return a.second < b.second || (a.second == b.second && a.first < b.first);
+              });
+    expected.resize(k);
+
+    std::vector<search_type::match_type> actual(search.find_nearest(query, k));
+    if (actual.size() != k)
+      {
+      std::cerr << "ERROR: " << name << ": expected " << k << " neighbors but got "
+                << actual.size() << "\n";
+      ++error_count;
+      continue;
+      }
+    for (std::size_t i = 0; i < k; ++i)
+      {
+      if (actual[i].first != expected[i].first
+          || !tracktable::almost_equal(actual[i].second, expected[i].second, 1e-9))
+        {
+        std::cerr << "ERROR: " << name << ": neighbor " << i << " should be "
+                  << expected[i].first << " at " << expected[i].second
+                  << " but is " << actual[i].first << " at " << actual[i].second << "\n";
+        ++error_count;
+        }
+      }
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_distances();
+  error_count += test_search(tracktable::SimilarityMeasure::DISCRETE_FRECHET, "Frechet");
+  error_count += test_search(tracktable::SimilarityMeasure::DYNAMIC_TIME_WARPING, "DTW");
+  error_count += test_search(tracktable::SimilarityMeasure::HAUSDORFF, "Hausdorff");
+  return error_count;
+}
@@ -0,0 +1,875 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __tracktable_TrajectoryFilterPipeline_h
+#define __tracktable_TrajectoryFilterPipeline_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/Geometry.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Core/detail/algorithm_signatures/Bearing.h>
+#include <tracktable/Core/detail/algorithm_signatures/Distance.h>
+#include <tracktable/Core/detail/algorithm_signatures/EndToEndDistance.h>
+#include <tracktable/Core/detail/algorithm_signatures/Intersects.h>
+#include <tracktable/Core/detail/algorithm_signatures/SubsetDuringInterval.h>
+#include <tracktable/Core/detail/algorithm_signatures/TurnAngle.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+/**
+ * @class TrajectoryFeatureCache
+ * @brief Derived quantities for one trajectory, computed on demand
+ *
+ * Filters over trajectories tend to need the same intermediate
+ * values: headings, segment lengths, turn angles, total length.  A
+ * feature cache computes each of these at most once per trajectory
+ * and hands the same values to every filter stage that asks.
+ *
+ * Caches are meant to be reused.  Call `reset()` with the next
+ * trajectory; the vectors inside keep their capacity so that a worker
+ * thread does not allocate per trajectory once it has warmed up.
+ *
+ * The trajectory must outlive the calls made through the cache.
+ */
+template<typename TrajectoryT>
+class TrajectoryFeatureCache
+{
+public:
+  typedef TrajectoryT trajectory_type;
+
+  TrajectoryFeatureCache()
+    : Trajectory(0)
+    , Scratch(false)
+    {
+      this->clear_flags();
+    }
+
+  /** Point the cache at a new trajectory and forget all derived values.
+   *
+   * @param [in] trajectory Trajectory to compute features for
+   */
+  void reset(trajectory_type const& trajectory)
+    {
+      this->Trajectory = &trajectory;
+      this->clear_flags();
+    }
+
+  /// Trajectory currently being examined
+  trajectory_type const& trajectory() const
+    {
+      return *this->Trajectory;
+    }
+
+  /** Working copy for stages that change the trajectory.
+   *
+   * Transform stages copy the trajectory here the first time one of
+   * them runs and then point the cache at the copy, so the original
+   * is never modified and later stages see the changed trajectory.
+   */
+  trajectory_type& scratch()
+    {
+      return this->Scratch;
+    }
+
+  /// Is the cache looking at its own working copy?
+  bool using_scratch() const
+    {
+      return this->Trajectory == &this->Scratch;
+    }
+
+  /** Distance between each pair of consecutive points.
+   *
+   * Entry i is the distance from point i to point i+1, so there are
+   * size()-1 entries for a non-empty trajectory.
+   */
+  std::vector<double> const& segment_lengths()
+    {
+      if (!this->HaveSegmentLengths)
+        {
+        trajectory_type const& path(*this->Trajectory);
+        this->SegmentLengths.clear();
+        for (std::size_t i = 1; i < path.size(); ++i)
+          {
+          this->SegmentLengths.push_back(::tracktable::distance(path[i-1], path[i]));
+          }
+        this->HaveSegmentLengths = true;
+        }
+      return this->SegmentLengths;
+    }
+
+  /** Heading at each point.
+   *
+   * Entry i is the bearing from point i to point i+1.  The last point
+   * repeats the heading of the one before it and a single-point
+   * trajectory has heading 0.  This is the same convention used when
+   * headings are assigned as point properties.
+   */
+  std::vector<double> const& headings()
+    {
+      if (!this->HaveHeadings)
+        {
+        trajectory_type const& path(*this->Trajectory);
+        this->Headings.clear();
+        if (path.size() == 1)
+          {
+          this->Headings.push_back(0.0);
+          }
+        else if (path.size() > 1)
+          {
+          for (std::size_t i = 0; i + 1 < path.size(); ++i)
+            {
+            this->Headings.push_back(::tracktable::bearing(path[i], path[i+1]));
+            }
+          this->Headings.push_back(this->Headings.back());
+          }
+        this->HaveHeadings = true;
+        }
+      return this->Headings;
+    }
+
+  /** Signed turn angle at each interior point.
+   *
+   * Entry i is the turn angle at point i+1, so there are size()-2
+   * entries for trajectories with at least 3 points.
+   */
+  std::vector<double> const& turn_angles()
+    {
+      if (!this->HaveTurnAngles)
+        {
+        trajectory_type const& path(*this->Trajectory);
+        this->TurnAngles.clear();
+        for (std::size_t i = 1; i + 1 < path.size(); ++i)
+          {
+          this->TurnAngles.push_back(::tracktable::signed_turn_angle(path[i-1], path[i], path[i+1]));
+          }
+        this->HaveTurnAngles = true;
+        }
+      return this->TurnAngles;
+    }
+
+  /// Total length of the trajectory (sum of segment lengths)
+  double length()
+    {
+      if (!this->HaveLength)
+        {
+        std::vector<double> const& segments(this->segment_lengths());
+        this->Length = 0;
+        for (std::size_t i = 0; i < segments.size(); ++i)
+          {
+          this->Length += segments[i];
+          }
+        this->HaveLength = true;
+        }
+      return this->Length;
+    }
+
+  /// Distance from the first point to the last
+  double end_to_end_distance()
+    {
+      return this->cached(this->HaveEndToEnd, this->EndToEnd,
+                          [this]() { return ::tracktable::end_to_end_distance(*this->Trajectory); });
+    }
+
+  /// Sum of the signed turn angles at all interior points
+  double total_curvature()
+    {
+      if (!this->HaveCurvature)
+        {
+        std::vector<double> const& angles(this->turn_angles());
+        this->Curvature = 0;
+        for (std::size_t i = 0; i < angles.size(); ++i)
+          {
+          this->Curvature += angles[i];
+          }
+        this->HaveCurvature = true;
+        }
+      return this->Curvature;
+    }
+
+  /// Area of the convex hull of the trajectory's points
+  double convex_hull_area()
+    {
+      return this->cached(this->HaveHullArea, this->HullArea,
+                          [this]() { return ::tracktable::convex_hull_area(*this->Trajectory); });
+    }
+
+  /// Aspect ratio of the convex hull of the trajectory's points
+  double convex_hull_aspect_ratio()
+    {
+      return this->cached(this->HaveHullAspectRatio, this->HullAspectRatio,
+                          [this]() { return ::tracktable::convex_hull_aspect_ratio(*this->Trajectory); });
+    }
+
+  /// Radius of gyration of the trajectory's points
+  double radius_of_gyration()
+    {
+      return this->cached(this->HaveGyration, this->Gyration,
+                          [this]() { return ::tracktable::radius_of_gyration(*this->Trajectory); });
+    }
+
+private:
+  TrajectoryFeatureCache(TrajectoryFeatureCache const&) = delete;
+  TrajectoryFeatureCache& operator=(TrajectoryFeatureCache const&) = delete;
+
+  trajectory_type const* Trajectory;
+  trajectory_type Scratch;
+
+  std::vector<double> SegmentLengths;
+  std::vector<double> Headings;
+  std::vector<double> TurnAngles;
+
+  bool HaveSegmentLengths;
+  bool HaveHeadings;
+  bool HaveTurnAngles;
+  bool HaveLength;
+  bool HaveEndToEnd;
+  bool HaveCurvature;
+  bool HaveHullArea;
+  bool HaveHullAspectRatio;
+  bool HaveGyration;
+
+  double Length;
+  double EndToEnd;
+  double Curvature;
+  double HullArea;
+  double HullAspectRatio;
+  double Gyration;
+
+  void clear_flags()
+    {
+      this->HaveSegmentLengths = false;
+      this->HaveHeadings = false;
+      this->HaveTurnAngles = false;
+      this->HaveLength = false;
+      this->HaveEndToEnd = false;
+      this->HaveCurvature = false;
+      this->HaveHullArea = false;
+      this->HaveHullAspectRatio = false;
+      this->HaveGyration = false;
+    }
+
+  template<typename function_type>
+  double cached(bool& have_value, double& value, function_type const& compute)
+    {
+      if (!have_value)
+        {
+        value = compute();
+        have_value = true;
+        }
+      return value;
+    }
+};
+
+// ----------------------------------------------------------------------
+
+/** Metrics that filter stages can evaluate on a TrajectoryFeatureCache.
+ *
+ * Each of these takes a feature cache and returns a number.  They are
+ * meant to be passed straight to
+ * `TrajectoryFilterPipeline::add_range_filter()`.
+ */
+namespace filter_metrics {
+
+/// Total length of the trajectory
+template<typename cache_type>
+double length(cache_type& features)
+{
+  return features.length();
+}
+
+/// Absolute value of the sum of signed turn angles
+template<typename cache_type>
+double curvature(cache_type& features)
+{
+  return std::abs(features.total_curvature());
+}
+
+/// End-to-end distance divided by total length (1 for a straight path)
+template<typename cache_type>
+double length_ratio(cache_type& features)
+{
+  return features.end_to_end_distance() / features.length();
+}
+
+/// Convex hull area divided by radius of gyration
+template<typename cache_type>
+double hull_gyration_ratio(cache_type& features)
+{
+  return features.convex_hull_area() / features.radius_of_gyration();
+}
+
+/// Aspect ratio of the convex hull
+template<typename cache_type>
+double hull_aspect_ratio(cache_type& features)
+{
+  return features.convex_hull_aspect_ratio();
+}
+
+/** Fraction of points that lie on long runs of nearly constant heading
+ *
+ * A run ends where two consecutive headings are within 2 degrees of
+ * one another.  Runs of at least 5 points count toward the total.
+ */
+template<typename cache_type>
+double straight_fraction(cache_type& features)
+{
+  std::vector<double> const& headings(features.headings());
+  const std::size_t min_straight_size = 5;
+  const std::size_t num_points = headings.size();
+  if (num_points == 0)
+    {
+    return 0;
+    }
+
+  std::size_t sum = 0;
+  std::size_t run_begin = 0;
+  std::size_t run_end = 0;
+  do
+    {
+    run_end = num_points;
+    for (std::size_t i = run_begin; i + 1 < num_points; ++i)
+      {
+      double h1 = headings[i+1];
+      double h2 = headings[i];
+      double difference = (h2 - h1) - 360.0 * int((h2 - h1) / 180.0);
+      if (std::abs(difference) < 2.0)
+        {
+        run_end = i + 1;
+        break;
+        }
+      }
+    if (run_end - run_begin >= min_straight_size)
+      {
+      sum += run_end - run_begin;
+      }
+    run_begin = run_end;
+    } while (run_end != num_points);
+
+  return static_cast<double>(sum) / static_cast<double>(num_points);
+}
+
+/** Number of times the trajectory reverses direction
+ *
+ * A turnaround is a pair of points 5 apart whose headings differ by
+ * 180 degrees, within 2 degrees.  After a turnaround we skip ahead 5
+ * points before looking for the next one.
+ */
+template<typename cache_type>
+double turn_arounds(cache_type& features)
+{
+  std::vector<double> const& headings(features.headings());
+  const std::size_t window = 5;
+  const std::size_t leap_limit = 5;
+  if (headings.size() <= window)
+    {
+    return 0;
+    }
+
+  unsigned int count = 0;
+  bool found = false;
+  std::size_t first = 0;
+  std::size_t second = window;
+  do
+    {
+    double difference = std::abs(headings[first] - headings[second]);
+    if (std::abs(difference - 180.0) < 2.0)
+      {
+      if (!found)
+        {
+        ++count;
+        }
+      found = true;
+      }
+    else
+      {
+      found = false;
+      }
+
+    std::size_t leap = 1;
+    if (found)
+      {
+      leap = std::min(headings.size() - second, leap_limit);
+      }
+    first += leap;
+    second += leap;
+    } while (second != headings.size());
+
+  return static_cast<double>(count);
+}
+
+/// Number of points in the trajectory
+template<typename cache_type>
+double num_points(cache_type& features)
+{
+  return static_cast<double>(features.trajectory().size());
+}
+
+/// Seconds from the first point to the last
+template<typename cache_type>
+double duration(cache_type& features)
+{
+  if (features.trajectory().empty())
+    {
+    return 0;
+    }
+  return static_cast<double>(features.trajectory().duration().total_microseconds()) / 1e6;
+}
+
+} // namespace filter_metrics
+
+/** Ready-made predicates for TrajectoryFilterPipeline::add_predicate().
+ *
+ * Each of these returns a function object that takes a feature cache
+ * and returns true to keep the trajectory.
+ */
+namespace filter_predicates {
+
+/** Keep trajectories that touch a bounding box anywhere
+ *
+ * The whole trajectory is kept, not just the part inside the box.
+ *
+ * @param [in] box  Box in the trajectory's domain
+ */
+template<typename cache_type, typename box_type>
+std::function<bool(cache_type&)> intersects_box(box_type const& box)
+{
+  return [box](cache_type& features) {
+    return (!features.trajectory().empty()
+            && ::tracktable::intersects(box, features.trajectory()));
+  };
+}
+
+/** Keep trajectories whose numeric point property reaches an interval
+ *
+ * A trajectory passes if some point's value lies in [minimum,
+ * maximum] or if it has points both below and above the interval,
+ * since it must then pass through it.  Points that lack the property
+ * are ignored.  This is how altitude filters work.
+ *
+ * @param [in] property  Name of a numeric point property
+ * @param [in] minimum   Bottom of the interval
+ * @param [in] maximum   Top of the interval
+ */
+template<typename cache_type>
+std::function<bool(cache_type&)> property_in_range(std::string const& property,
+                                                  double minimum, double maximum)
+{
+  return [property, minimum, maximum](cache_type& features) {
+    bool below = false;
+    bool above = false;
+    for (auto const& point : features.trajectory())
+      {
+      bool ok = false;
+      double value = point.real_property(property, &ok);
+      if (!ok)
+        {
+        continue;
+        }
+      if (value < minimum)
+        {
+        below = true;
+        }
+      else if (value > maximum)
+        {
+        above = true;
+        }
+      else
+        {
+        return true;
+        }
+      if (below && above)
+        {
+        return true;
+        }
+      }
+    return false;
+  };
+}
+
+} // namespace filter_predicates
+
+/** Ready-made transforms for TrajectoryFilterPipeline::add_transform().
+ *
+ * Each of these returns a function object that changes a trajectory
+ * in place and returns false if nothing worth keeping is left.
+ */
+namespace filter_transforms {
+
+/** Clip trajectories to a time window
+ *
+ * Points outside the window are dropped and new endpoints are
+ * interpolated at the window's edges, as subset_during_interval()
+ * does.  Trajectories entirely outside the window are rejected.
+ *
+ * @param [in] start   Beginning of the window
+ * @param [in] finish  End of the window
+ */
+template<typename trajectory_type>
+std::function<bool(trajectory_type&)> clip_to_time_window(Timestamp const& start, Timestamp const& finish)
+{
+  return [start, finish](trajectory_type& trajectory) {
+    if (trajectory.empty())
+      {
+      return false;
+      }
+    if (trajectory.start_time() < start || trajectory.end_time() > finish)
+      {
+      trajectory = ::tracktable::subset_during_interval(trajectory, start, finish);
+      }
+    return !trajectory.empty();
+  };
+}
+
+} // namespace filter_transforms
+
+// ----------------------------------------------------------------------
+
+/**
+ * @class TrajectoryFilterPipeline
+ * @brief Evaluate a chain of trajectory filters in a single pass
+ *
+ * Classification jobs often chain many filters: keep trajectories
+ * whose length is in some range, whose curvature is in another, that
+ * have at least N turnarounds, and so on.  Running each filter as its
+ * own pass over the collection walks every trajectory once per filter
+ * and recomputes shared quantities such as headings each time.
+ *
+ * A pipeline holds an ordered list of stages.  Each trajectory is run
+ * through all the stages at once with a single TrajectoryFeatureCache,
+ * so derived quantities are computed at most once, and evaluation
+ * stops at the first stage that rejects the trajectory.  Put cheap,
+ * selective stages first.  Trajectories are evaluated in parallel.
+ *
+ * Stages can also change trajectories (see add_transform()), for
+ * example to clip them to a time window.  Later stages see the
+ * changed trajectory and filter() keeps the changed version.  The
+ * input to evaluate() and keep() is never modified.
+ *
+ * @code
+ *
+ * typedef tracktable::TrajectoryFilterPipeline<trajectory_type> pipeline_type;
+ * typedef pipeline_type::feature_cache_type features_type;
+ *
+ * pipeline_type pipeline;
+ * pipeline.add_range_filter("length", tracktable::filter_metrics::length<features_type>, 100, 5000);
+ * pipeline.add_range_filter("turn-arounds", tracktable::filter_metrics::turn_arounds<features_type>, 10);
+ * pipeline.filter(trajectories);
+ *
+ * @endcode
+ */
+template<typename TrajectoryT>
+class TrajectoryFilterPipeline
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef TrajectoryFeatureCache<TrajectoryT> feature_cache_type;
+  typedef std::function<bool(feature_cache_type&)> predicate_type;
+  typedef std::function<double(feature_cache_type&)> metric_type;
+  typedef std::function<bool(trajectory_type&)> transform_type;
+
+  /// Value returned by evaluate() for trajectories that pass every stage
+  static const int PASSED_ALL_STAGES = -1;
+
+  TrajectoryFilterPipeline()
+    : HasTransforms(false)
+    { }
+
+  /** Add a stage that keeps trajectories for which a predicate is true.
+   *
+   * @param [in] name       Name of the stage (used in reports)
+   * @param [in] predicate  Function returning true for trajectories to keep
+   */
+  void add_predicate(std::string const& name, predicate_type const& predicate)
+    {
+      this->StageNames.push_back(name);
+      this->Stages.push_back(predicate);
+    }
+
+  /** Add a stage that keeps trajectories whose metric is in [minimum, maximum].
+   *
+   * @param [in] name     Name of the stage (used in reports)
+   * @param [in] metric   Function computing a number from a feature cache
+   * @param [in] minimum  Smallest acceptable value
+   * @param [in] maximum  Largest acceptable value
+   */
+  void add_range_filter(std::string const& name,
+                        metric_type const& metric,
+                        double minimum=-std::numeric_limits<double>::max(),
+                        double maximum=std::numeric_limits<double>::max())
+    {
+      this->add_predicate(
+        name,
+        [metric, minimum, maximum](feature_cache_type& features) {
+          double value = metric(features);
+          return (minimum <= value && value <= maximum);
+        });
+    }
+
+  /** Add a stage that changes the trajectory.
+   *
+   * The transform works on the feature cache's working copy, never
+   * on the original.  It returns false to reject the trajectory.
+   *
+   * @param [in] name       Name of the stage (used in reports)
+   * @param [in] transform  Function that modifies a trajectory in place
+   */
+  void add_transform(std::string const& name, transform_type const& transform)
+    {
+      this->add_predicate(
+        name,
+        [transform](feature_cache_type& features) {
+          if (!features.using_scratch())
+            {
+            features.scratch() = features.trajectory();
+            }
+          bool keep = transform(features.scratch());
+          features.reset(features.scratch());
+          return keep;
+        });
+      this->HasTransforms = true;
+    }
+
+  /// Does any stage change the trajectories?
+  bool has_transforms() const
+    {
+      return this->HasTransforms;
+    }
+
+  /// Number of stages in the pipeline
+  std::size_t size() const
+    {
+      return this->Stages.size();
+    }
+
+  /// Name of a stage
+  std::string const& stage_name(std::size_t which) const
+    {
+      return this->StageNames[which];
+    }
+
+  /** Run one trajectory through the stages.
+   *
+   * @param [in] features Feature cache already reset() to the trajectory
+   * @return Index of the first stage that rejected the trajectory, or PASSED_ALL_STAGES
+   */
+  int evaluate(feature_cache_type& features) const
+    {
+      for (std::size_t i = 0; i < this->Stages.size(); ++i)
+        {
+        if (!this->Stages[i](features))
+          {
+          return static_cast<int>(i);
+          }
+        }
+      return PASSED_ALL_STAGES;
+    }
+
+  /** Run one trajectory through the stages.
+   *
+   * @param [in] trajectory Trajectory to evaluate
+   * @return True if every stage accepts the trajectory
+   */
+  bool keep(trajectory_type const& trajectory) const
+    {
+      feature_cache_type features;
+      features.reset(trajectory);
+      return (this->evaluate(features) == PASSED_ALL_STAGES);
+    }
+
+  /** Run a collection of trajectories through the stages in parallel.
+   *
+   * @param [in] begin        Random-access iterator to the first trajectory
+   * @param [in] end          Iterator past the last trajectory
+   * @param [in] num_threads  Number of threads; 0 uses all available
+   * @return For each trajectory, the index of the first stage that rejected it or PASSED_ALL_STAGES
+   */
+  template<typename iterator_type>
+  std::vector<int> evaluate(iterator_type begin, iterator_type end,
+                            std::size_t num_threads=0) const
+    {
+      std::size_t num_trajectories = static_cast<std::size_t>(std::distance(begin, end));
+      std::vector<int> result(num_trajectories, PASSED_ALL_STAGES);
+      if (num_threads == 0)
+        {
+        num_threads = default_thread_count();
+        }
+      std::vector<feature_cache_type> workspaces(num_threads);
+
+      parallel_for_with_worker(
+        0, num_trajectories,
+        [&](std::size_t i, std::size_t worker) {
+          feature_cache_type& features(workspaces[worker]);
+          features.reset(*(begin + i));
+          result[i] = this->evaluate(features);
+        },
+        num_threads);
+
+      return result;
+    }
+
+  /** Remove all trajectories that fail any stage.
+   *
+   * The surviving trajectories keep their relative order.  After
+   * this call, rejection_counts() reports how many trajectories each
+   * stage removed.
+   *
+   * @param [in,out] trajectories  Collection to filter in place
+   * @param [in]     num_threads   Number of threads; 0 uses all available
+   */
+  template<typename container_type>
+  void filter(container_type& trajectories, std::size_t num_threads=0)
+    {
+      this->RejectionCounts.assign(this->Stages.size(), 0);
+      this->filter_batch(trajectories, num_threads);
+    }
+
+  /** Filter a sequence that can only be read once, such as a reader.
+   *
+   * Trajectories are read in batches of `batch_size`, each batch is
+   * filtered in parallel and the survivors are written to `output`
+   * in their original order.  After this call, rejection_counts()
+   * covers the whole sequence.
+   *
+   * @param [in] begin        Input iterator to the first trajectory
+   * @param [in] end          Iterator past the last trajectory
+   * @param [in] output       Output iterator for the survivors
+   * @param [in] num_threads  Number of threads; 0 uses all available
+   * @param [in] batch_size   Trajectories to hold in memory at once
+   * @return Output iterator past the last survivor
+   */
+  template<typename input_iterator_type, typename output_iterator_type>
+  output_iterator_type filter_sequence(input_iterator_type begin,
+                                       input_iterator_type end,
+                                       output_iterator_type output,
+                                       std::size_t num_threads=0,
+                                       std::size_t batch_size=4096)
+    {
+      this->RejectionCounts.assign(this->Stages.size(), 0);
+      if (batch_size == 0)
+        {
+        batch_size = 1;
+        }
+      std::vector<trajectory_type> batch;
+      while (begin != end)
+        {
+        batch.clear();
+        for (; begin != end && batch.size() < batch_size; ++begin)
+          {
+          batch.push_back(*begin);
+          }
+        this->filter_batch(batch, num_threads);
+        output = std::move(batch.begin(), batch.end(), output);
+        }
+      return output;
+    }
+
+  /** Number of trajectories rejected by each stage during the last filter() call.
+   *
+   * A trajectory is only counted against the first stage that rejected it.
+   */
+  std::vector<std::size_t> const& rejection_counts() const
+    {
+      return this->RejectionCounts;
+    }
+
+private:
+  std::vector<std::string> StageNames;
+  std::vector<predicate_type> Stages;
+  std::vector<std::size_t> RejectionCounts;
+  bool HasTransforms;
+
+  // Filter one collection in place and add to RejectionCounts.
+  // Trajectories changed by transform stages are swapped in from the
+  // worker's feature cache.
+  template<typename container_type>
+  void filter_batch(container_type& trajectories, std::size_t num_threads)
+    {
+      std::vector<int> outcome;
+      if (!this->HasTransforms)
+        {
+        outcome = this->evaluate(trajectories.begin(), trajectories.end(), num_threads);
+        }
+      else
+        {
+        if (num_threads == 0)
+          {
+          num_threads = default_thread_count();
+          }
+        outcome.assign(trajectories.size(), PASSED_ALL_STAGES);
+        std::vector<feature_cache_type> workspaces(num_threads);
+        parallel_for_with_worker(
+          0, trajectories.size(),
+          [&](std::size_t i, std::size_t worker) {
+            feature_cache_type& features(workspaces[worker]);
+            features.reset(trajectories[i]);
+            outcome[i] = this->evaluate(features);
+            if (outcome[i] == PASSED_ALL_STAGES && features.using_scratch())
+              {
+              std::swap(trajectories[i], features.scratch());
+              }
+          },
+          num_threads);
+        }
+
+      std::size_t keep_index = 0;
+      for (std::size_t i = 0; i < outcome.size(); ++i)
+        {
+        if (outcome[i] == PASSED_ALL_STAGES)
+          {
+          if (keep_index != i)
+            {
+            trajectories[keep_index] = std::move(trajectories[i]);
+            }
+          ++keep_index;
+          }
+        else
+          {
+          ++this->RejectionCounts[outcome[i]];
+          }
+        }
+      trajectories.erase(trajectories.begin() + keep_index, trajectories.end());
+    }
+};
+
+template<typename TrajectoryT>
+const int TrajectoryFilterPipeline<TrajectoryT>::PASSED_ALL_STAGES;
+
+} // namespace tracktable
+
+#endif
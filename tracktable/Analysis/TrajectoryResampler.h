@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/TrajectoryResampler.h - Resample trajectories
+ * at a list of times or a fixed interval
+ *
+ * Calling point_at_time() once per sample searches the whole
+ * trajectory for every sample and interpolates every property.  When
+ * the sample times are sorted we can instead walk the trajectory and
+ * the sample list together, once, and only interpolate the
+ * properties the caller asks for.
+ */
+
+#ifndef __tracktable_TrajectoryResampler_h
+#define __tracktable_TrajectoryResampler_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Core/PointTraits.h>
+#include <tracktable/Core/PropertyMap.h>
+#include <tracktable/Core/Timestamp.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace tracktable {
+
+/**
+ * @class TrajectoryResampler
+ * @brief Resample trajectories at sorted times in a single pass
+ *
+ * Each output point has its coordinates interpolated with the
+ * domain's own interpolation (great circle for terrestrial points,
+ * linear for Cartesian points), its timestamp set to the sample time
+ * and the object ID of the input point before it.
+ *
+ * Point properties are dropped unless you ask for them.  Properties
+ * registered with interpolate_property() are interpolated the same
+ * way point_at_time() would: linearly for numbers and timestamps,
+ * nearest neighbor for strings.  Properties registered with
+ * copy_property() take the value from whichever input point is
+ * closer in time.  Trajectory-level properties and the UUID are always
+ * copied.
+ *
+ * Sample times outside the time span of a trajectory are skipped, so
+ * resampled trajectories never extrapolate.
+ *
+ * The collection methods accept sequences of trajectories or of
+ * pointers to trajectories.
+ *
+ * Example:
+ *
+ * @code
+ * tracktable::TrajectoryResampler<trajectory_type> resampler;
+ * resampler.interpolate_property("altitude");
+ * resampler.copy_property("status");
+ *
+ * trajectory_type every_minute = resampler.resample(path, tracktable::minutes(1));
+ * std::vector<trajectory_type> all_tracks =
+ *   resampler.resample(tracks.begin(), tracks.end(), tracktable::seconds(10));
+ * @endcode
+ */
+template<typename TrajectoryT>
+class TrajectoryResampler
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef typename point_type::Superclass generic_trajectory_point_type;
+  typedef typename generic_trajectory_point_type::Superclass base_point_type;
+
+  /** Resampled collection stored column by column
+   *
+   * Row r holds one sample.  The rows for trajectory i are
+   * `[offsets[i], offsets[i+1])`.  Properties that are missing or
+   * not numeric come out as NaN.
+   */
+  struct columns_type
+  {
+    std::vector<std::size_t> offsets;
+    std::vector<std::string> object_ids;
+    std::vector<Timestamp> timestamps;
+    std::vector<std::vector<double> > coordinates;
+    std::vector<std::string> property_names;
+    std::vector<std::vector<double> > properties;
+  };
+
+  TrajectoryResampler()
+    : NumThreads(0)
+    { }
+
+  /// Interpolate this point property between neighboring points
+  void interpolate_property(std::string const& name)
+    {
+      this->InterpolatedProperties.push_back(name);
+    }
+
+  /// Copy this point property from the nearer neighboring point
+  void copy_property(std::string const& name)
+    {
+      this->CopiedProperties.push_back(name);
+    }
+
+  /// Forget all registered point properties
+  void clear_properties()
+    {
+      this->InterpolatedProperties.clear();
+      this->CopiedProperties.clear();
+    }
+
+  /// Number of threads for collections; 0 means default_thread_count()
+  void set_num_threads(std::size_t num_threads)
+    {
+      this->NumThreads = num_threads;
+    }
+
+  std::size_t num_threads() const
+    {
+      return this->NumThreads;
+    }
+
+  /** Resample one trajectory at the given times
+   *
+   * @param [in] path   Trajectory to resample; points must be in time order
+   * @param [in] times  Sample times in non-decreasing order
+   * @return New trajectory with one point per sample time inside the path's time span
+   * @throws std::invalid_argument if the sample times are not sorted
+   */
+  trajectory_type resample(trajectory_type const& path,
+                           std::vector<Timestamp> const& times) const
+    {
+      if (!std::is_sorted(times.begin(), times.end()))
+        {
+        throw std::invalid_argument("TrajectoryResampler: sample times must be sorted");
+        }
+      trajectory_type result(false);
+      this->resample_into(path, times.begin(), times.end(), result);
+      return result;
+    }
+
+  /** Resample one trajectory at a fixed interval
+   *
+   * Samples start at the first point's timestamp and continue while
+   * they are no later than the last point's timestamp.
+   *
+   * @param [in] path      Trajectory to resample; points must be in time order
+   * @param [in] interval  Time between samples
+   * @throws std::invalid_argument if the interval is not positive
+   */
+  trajectory_type resample(trajectory_type const& path, Duration const& interval) const
+    {
+      trajectory_type result(false);
+      std::vector<Timestamp> times;
+      if (!path.empty())
+        {
+        times = sample_times(path.front().timestamp(),
+                             path.back().timestamp(),
+                             interval);
+        }
+      this->resample_into(path, times.begin(), times.end(), result);
+      return result;
+    }
+
+  /** Resample every trajectory in a collection at the same times
+   *
+   * Trajectories are processed in parallel.
+   *
+   * @param [in] begin  Start of the trajectory sequence
+   * @param [in] end    End of the trajectory sequence
+   * @param [in] times  Sample times in non-decreasing order
+   */
+  template<typename iterator_type>
+  std::vector<trajectory_type> resample(iterator_type begin,
+                                        iterator_type end,
+                                        std::vector<Timestamp> const& times) const
+    {
+      if (!std::is_sorted(times.begin(), times.end()))
+        {
+        throw std::invalid_argument("TrajectoryResampler: sample times must be sorted");
+        }
+      std::vector<trajectory_type const*> paths(pointers(begin, end));
+      std::vector<trajectory_type> result(paths.size(), trajectory_type(false));
+      parallel_for(0, paths.size(),
+                   [&, this](std::size_t i) {
+                     this->resample_into(*paths[i], times.begin(), times.end(), result[i]);
+                   },
+                   this->NumThreads, 1);
+      return result;
+    }
+
+  /** Resample every trajectory in a collection at a fixed interval
+   *
+   * Each trajectory gets its own samples starting at its first
+   * point.  Trajectories are processed in parallel.
+   *
+   * @param [in] begin     Start of the trajectory sequence
+   * @param [in] end       End of the trajectory sequence
+   * @param [in] interval  Time between samples
+   */
+  template<typename iterator_type>
+  std::vector<trajectory_type> resample(iterator_type begin,
+                                        iterator_type end,
+                                        Duration const& interval) const
+    {
+      check_interval(interval);
+      std::vector<trajectory_type const*> paths(pointers(begin, end));
+      std::vector<trajectory_type> result(paths.size(), trajectory_type(false));
+      parallel_for(0, paths.size(),
+                   [&, this](std::size_t i) {
+                     result[i] = this->resample(*paths[i], interval);
+                   },
+                   this->NumThreads, 1);
+      return result;
+    }
+
+  /** Resample a collection at the same times into columns
+   *
+   * This is the same as the collection version of resample() but the
+   * output is a set of flat arrays that can be handed to plotting or
+   * numeric code without walking any trajectories.
+   *
+   * @param [in] begin  Start of the trajectory sequence
+   * @param [in] end    End of the trajectory sequence
+   * @param [in] times  Sample times in non-decreasing order
+   */
+  template<typename iterator_type>
+  columns_type resample_columns(iterator_type begin,
+                                iterator_type end,
+                                std::vector<Timestamp> const& times) const
+    {
+      return this->to_columns(this->resample(begin, end, times));
+    }
+
+  /** Resample a collection at a fixed interval into columns
+   *
+   * @param [in] begin     Start of the trajectory sequence
+   * @param [in] end       End of the trajectory sequence
+   * @param [in] interval  Time between samples
+   */
+  template<typename iterator_type>
+  columns_type resample_columns(iterator_type begin,
+                                iterator_type end,
+                                Duration const& interval) const
+    {
+      return this->to_columns(this->resample(begin, end, interval));
+    }
+
+  /** List the times from start to finish at a fixed interval
+   *
+   * @param [in] start     First sample time
+   * @param [in] finish    No sample will be later than this
+   * @param [in] interval  Time between samples
+   * @throws std::invalid_argument if the interval is not positive
+   */
+  static std::vector<Timestamp> sample_times(Timestamp const& start,
+                                             Timestamp const& finish,
+                                             Duration const& interval)
+    {
+      check_interval(interval);
+      std::vector<Timestamp> times;
+      for (Timestamp when = start; when <= finish; when += interval)
+        {
+        times.push_back(when);
+        }
+      return times;
+    }
+
+private:
+  std::vector<std::string> InterpolatedProperties;
+  std::vector<std::string> CopiedProperties;
+  std::size_t NumThreads;
+
+  static void check_interval(Duration const& interval)
+    {
+      if (interval <= Duration(0, 0, 0, 0))
+        {
+        throw std::invalid_argument("TrajectoryResampler: interval must be positive");
+        }
+    }
+
+  template<typename iterator_type>
+  static std::vector<trajectory_type const*> pointers(iterator_type begin, iterator_type end)
+    {
+      std::vector<trajectory_type const*> result;
+      for (; begin != end; ++begin)
+        {
+        result.push_back(address_of(*begin));
+        }
+      return result;
+    }
+
+  static trajectory_type const* address_of(trajectory_type const& path)
+    {
+      return &path;
+    }
+
+  static trajectory_type const* address_of(trajectory_type const* path)
+    {
+      return path;
+    }
+
+  // Walk the trajectory and the sorted sample times together
+  template<typename time_iterator_type>
+  void resample_into(trajectory_type const& path,
+                     time_iterator_type time_begin,
+                     time_iterator_type time_end,
+                     trajectory_type& result) const
+    {
+      result.clear();
+      result.set_uuid(path.uuid());
+      result.__set_properties(path.__properties());
+      if (path.empty())
+        {
+        return;
+        }
+
+      Timestamp const first_time(path.front().timestamp());
+      Timestamp const last_time(path.back().timestamp());
+      std::size_t segment = 0;
+
+      for (time_iterator_type when = time_begin; when != time_end; ++when)
+        {
+        if (*when < first_time)
+          {
+          continue;
+          }
+        if (*when > last_time)
+          {
+          break;
+          }
+
+        // Advance until path[segment] <= when < path[segment+1]
+        while (segment + 1 < path.size() && path[segment + 1].timestamp() <= *when)
+          {
+          ++segment;
+          }
+
+        if (segment + 1 == path.size() || path[segment].timestamp() == *when)
+          {
+          result.push_back(this->sample_at(path[segment], path[segment], 0, *when));
+          }
+        else
+          {
+          point_type const& before(path[segment]);
+          point_type const& after(path[segment + 1]);
+          double fraction =
+            static_cast<double>((*when - before.timestamp()).total_microseconds())
+            / static_cast<double>((after.timestamp() - before.timestamp()).total_microseconds());
+          result.push_back(this->sample_at(before, after, fraction, *when));
+          }
+        }
+    }
+
+  point_type sample_at(point_type const& before,
+                       point_type const& after,
+                       double fraction,
+                       Timestamp const& when) const
+    {
+      point_type result = point_type(generic_trajectory_point_type(
+        algorithms::interpolate<base_point_type>::apply(
+          static_cast<base_point_type const&>(before),
+          static_cast<base_point_type const&>(after),
+          fraction)));
+      result.set_object_id(before.object_id());
+      result.set_timestamp(when);
+
+      for (std::size_t i = 0; i < this->InterpolatedProperties.size(); ++i)
+        {
+        std::string const& name(this->InterpolatedProperties[i]);
+        bool before_ok = false;
+        bool after_ok = false;
+        PropertyValueT before_value(before.property(name, &before_ok));
+        PropertyValueT after_value(after.property(name, &after_ok));
+        if (before_ok && after_ok)
+          {
+          try
+            {
+            result.set_property(name, algorithms::interpolate_property(before_value, after_value, fraction));
+            }
+          catch (boost::bad_get& /*e*/)
+            {
+            result.set_property(name, fraction <= 0.5 ? before_value : after_value);
+            }
+          }
+        else if (before_ok || after_ok)
+          {
+          result.set_property(name, before_ok ? before_value : after_value);
+          }
+        }
+
+      point_type const& nearer(fraction <= 0.5 ? before : after);
+      for (std::size_t i = 0; i < this->CopiedProperties.size(); ++i)
+        {
+        bool ok = false;
+        PropertyValueT value(nearer.property(this->CopiedProperties[i], &ok));
+        if (ok)
+          {
+          result.set_property(this->CopiedProperties[i], value);
+          }
+        }
+      return result;
+    }
+
+  columns_type to_columns(std::vector<trajectory_type> const& paths) const
+    {
+      std::size_t const dimension = traits::dimension<point_type>::value;
+      double const not_a_number = std::numeric_limits<double>::quiet_NaN();
+
+      columns_type columns;
+      columns.property_names = this->InterpolatedProperties;
+      columns.property_names.insert(columns.property_names.end(),
+                                    this->CopiedProperties.begin(),
+                                    this->CopiedProperties.end());
+      columns.offsets.push_back(0);
+      for (std::size_t i = 0; i < paths.size(); ++i)
+        {
+        columns.offsets.push_back(columns.offsets.back() + paths[i].size());
+        columns.object_ids.push_back(paths[i].object_id());
+        }
+
+      std::size_t num_rows = columns.offsets.back();
+      columns.timestamps.resize(num_rows);
+      columns.coordinates.assign(dimension, std::vector<double>(num_rows));
+      columns.properties.assign(columns.property_names.size(),
+                                std::vector<double>(num_rows, not_a_number));
+
+      parallel_for(0, paths.size(),
+                   [&](std::size_t i) {
+                     std::size_t row = columns.offsets[i];
+                     for (std::size_t p = 0; p < paths[i].size(); ++p, ++row)
+                       {
+                       point_type const& point(paths[i][p]);
+                       columns.timestamps[row] = point.timestamp();
+                       for (std::size_t d = 0; d < dimension; ++d)
+                         {
+                         columns.coordinates[d][row] = point[d];
+                         }
+                       for (std::size_t n = 0; n < columns.property_names.size(); ++n)
+                         {
+                         bool ok = false;
+                         double value = point.real_property(columns.property_names[n], &ok);
+                         if (ok)
+                           {
+                           columns.properties[n][row] = value;
+                           }
+                         }
+                       }
+                   },
+                   this->NumThreads, 1);
+      return columns;
+    }
+};
+
+} // namespace tracktable
+
+#endif
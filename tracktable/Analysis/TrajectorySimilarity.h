@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/TrajectorySimilarity.h - Whole-trajectory
+ * distance measures
+ *
+ * These functions compare two trajectories point by point instead of
+ * through a fixed-length signature.  They work in any domain because
+ * the only thing they need is tracktable::distance() between points.
+ */
+
+#ifndef __tracktable_TrajectorySimilarity_h
+#define __tracktable_TrajectorySimilarity_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/detail/algorithm_signatures/Distance.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace tracktable {
+
+/// Distance measures understood by TrajectorySimilaritySearch
+enum class SimilarityMeasure {
+  DISCRETE_FRECHET,
+  DYNAMIC_TIME_WARPING,
+  HAUSDORFF,
+};
+
+namespace detail {
+
+struct frechet_step
+{
+  static double apply(double best_predecessor, double point_distance)
+    {
+      return std::max(best_predecessor, point_distance);
+    }
+};
+
+struct dtw_step
+{
+  static double apply(double best_predecessor, double point_distance)
+    {
+      return best_predecessor + point_distance;
+    }
+};
+
+/** @internal Dynamic program shared by Fréchet and DTW distance.
+ *
+ * Only cells (i, j) with |i - j| <= band are filled in.  The band is
+ * widened to the difference in lengths if necessary so that the last
+ * cell stays reachable.  A band of 0 means no restriction.  Cell
+ * values never decrease along a warping path, so as soon as every
+ * cell in a row exceeds `cutoff` we know the answer will too and stop
+ * early with infinity.
+ */
+template<typename step_type, typename trajectory_type1, typename trajectory_type2>
+double banded_warping_distance(trajectory_type1 const& first,
+                               trajectory_type2 const& second,
+                               std::size_t band,
+                               double cutoff)
+{
+  double const infinity = std::numeric_limits<double>::infinity();
+  std::size_t const n = first.size();
+  std::size_t const m = second.size();
+  if (n == 0 || m == 0)
+    {
+    return infinity;
+    }
+
+  std::size_t length_difference = (n > m ? n - m : m - n);
+  std::size_t width = (band == 0 ? std::max(n, m) : std::max(band, length_difference));
+
+  std::vector<double> previous(m, infinity);
+  std::vector<double> current(m, infinity);
+  std::size_t previous_low = 0;
+  std::size_t previous_high = 0;
+
+  for (std::size_t i = 0; i < n; ++i)
+    {
+    std::size_t low = (i > width ? i - width : 0);
+    std::size_t high = std::min(m - 1, i + width);
+    double row_minimum = infinity;
+
+    for (std::size_t j = low; j <= high; ++j)
+      {
+      double point_distance = ::tracktable::distance(first[i], second[j]);
+      double best = infinity;
+      if (i == 0 && j == 0)
+        {
+        best = 0;
+        }
+      if (i > 0 && j >= previous_low && j <= previous_high)
+        {
+        best = std::min(best, previous[j]);
+        }
+      if (i > 0 && j > previous_low && j - 1 <= previous_high)
+        {
+        best = std::min(best, previous[j-1]);
+        }
+      if (j > low)
+        {
+        best = std::min(best, current[j-1]);
+        }
+      current[j] = step_type::apply(best, point_distance);
+      row_minimum = std::min(row_minimum, current[j]);
+      }
+
+    if (row_minimum > cutoff)
+      {
+      return infinity;
+      }
+    previous.swap(current);
+    previous_low = low;
+    previous_high = high;
+    }
+
+  return previous[m-1];
+}
+
+/** @internal Directed Hausdorff distance with early break.
+ *
+ * For each point in `first` we stop scanning `second` as soon as we
+ * find a point closer than the running maximum, since that point
+ * cannot raise the result.
+ */
+template<typename trajectory_type1, typename trajectory_type2>
+double directed_hausdorff_distance(trajectory_type1 const& first,
+                                   trajectory_type2 const& second,
+                                   double cutoff)
+{
+  double const infinity = std::numeric_limits<double>::infinity();
+  double running_max = 0;
+  for (std::size_t i = 0; i < first.size(); ++i)
+    {
+    double nearest = infinity;
+    for (std::size_t j = 0; j < second.size(); ++j)
+      {
+      double d = ::tracktable::distance(first[i], second[j]);
+      if (d < running_max)
+        {
+        nearest = d;
+        break;
+        }
+      nearest = std::min(nearest, d);
+      }
+    running_max = std::max(running_max, nearest);
+    if (running_max > cutoff)
+      {
+      return infinity;
+      }
+    }
+  return running_max;
+}
+
+} // namespace detail
+
+/** Discrete Fréchet distance between two trajectories
+ *
+ * This is the smallest possible "leash length" when two walkers
+ * step through the points of each trajectory in order, either one or
+ * both advancing at each step.
+ *
+ * The optional `band` limits how far the two walkers' indices may
+ * drift apart (a Sakoe-Chiba band).  It is widened to the difference
+ * in trajectory lengths if necessary.  With a band the result is an
+ * upper bound on the unrestricted distance.  A band of 0 means no
+ * restriction.
+ *
+ * If `cutoff` is given and the distance is known to be larger than
+ * it, the computation stops early and returns infinity.
+ *
+ * @param [in] first   First trajectory
+ * @param [in] second  Second trajectory
+ * @param [in] band    Maximum index difference between matched points (0 for none)
+ * @param [in] cutoff  Stop early once the result is known to exceed this
+ * @return Distance in the units of tracktable::distance(), or infinity if either trajectory is empty
+ */
+template<typename trajectory_type1, typename trajectory_type2>
+double discrete_frechet_distance(trajectory_type1 const& first,
+                                 trajectory_type2 const& second,
+                                 std::size_t band=0,
+                                 double cutoff=std::numeric_limits<double>::infinity())
+{
+  return detail::banded_warping_distance<detail::frechet_step>(first, second, band, cutoff);
+}
+
+/** Dynamic time warping distance between two trajectories
+ *
+ * This is the smallest possible sum of point-to-point distances over
+ * all monotone alignments of the two trajectories.  The `band` and
+ * `cutoff` arguments mean the same thing as they do for
+ * discrete_frechet_distance().
+ *
+ * @param [in] first   First trajectory
+ * @param [in] second  Second trajectory
+ * @param [in] band    Maximum index difference between matched points (0 for none)
+ * @param [in] cutoff  Stop early once the result is known to exceed this
+ * @return Distance in the units of tracktable::distance(), or infinity if either trajectory is empty
+ */
+template<typename trajectory_type1, typename trajectory_type2>
+double dynamic_time_warping_distance(trajectory_type1 const& first,
+                                     trajectory_type2 const& second,
+                                     std::size_t band=0,
+                                     double cutoff=std::numeric_limits<double>::infinity())
+{
+  return detail::banded_warping_distance<detail::dtw_step>(first, second, band, cutoff);
+}
+
+/** Hausdorff distance between the points of two trajectories
+ *
+ * This is the largest distance from a point in either trajectory to
+ * the nearest point in the other.  Point order is ignored.
+ *
+ * @param [in] first   First trajectory
+ * @param [in] second  Second trajectory
+ * @param [in] cutoff  Stop early once the result is known to exceed this
+ * @return Distance in the units of tracktable::distance(), or infinity if either trajectory is empty
+ */
+template<typename trajectory_type1, typename trajectory_type2>
+double hausdorff_distance(trajectory_type1 const& first,
+                          trajectory_type2 const& second,
+                          double cutoff=std::numeric_limits<double>::infinity())
+{
+  if (first.size() == 0 || second.size() == 0)
+    {
+    return std::numeric_limits<double>::infinity();
+    }
+  double forward = detail::directed_hausdorff_distance(first, second, cutoff);
+  if (forward > cutoff)
+    {
+    return forward;
+    }
+  return std::max(forward, detail::directed_hausdorff_distance(second, first, cutoff));
+}
+
+/** Compute one of the trajectory distances by name
+ *
+ * @param [in] measure  Which distance to compute
+ * @param [in] first    First trajectory
+ * @param [in] second   Second trajectory
+ * @param [in] band     Band for Fréchet and DTW; ignored for Hausdorff
+ * @param [in] cutoff   Stop early once the result is known to exceed this
+ */
+template<typename trajectory_type1, typename trajectory_type2>
+double trajectory_distance(SimilarityMeasure measure,
+                           trajectory_type1 const& first,
+                           trajectory_type2 const& second,
+                           std::size_t band=0,
+                           double cutoff=std::numeric_limits<double>::infinity())
+{
+  switch (measure)
+    {
+    case SimilarityMeasure::DYNAMIC_TIME_WARPING:
+      return dynamic_time_warping_distance(first, second, band, cutoff);
+    case SimilarityMeasure::HAUSDORFF:
+      return hausdorff_distance(first, second, cutoff);
+    case SimilarityMeasure::DISCRETE_FRECHET:
+    default:
+      return discrete_frechet_distance(first, second, band, cutoff);
+    }
+}
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,377 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Analysis/TrajectorySimilaritySearch.h - Find the
+ * trajectories in a collection that are most similar to a query
+ *
+ * Exact trajectory distances are expensive: Fréchet and DTW are
+ * quadratic in the number of points.  This search avoids most of
+ * them.  Every stored trajectory carries a few cheap summaries that
+ * give a guaranteed lower bound on its distance to a query, plus a
+ * distance geometry signature held in an RTree.  The signature finds
+ * likely neighbors quickly so that we have a tight threshold early;
+ * the lower bounds then let us skip every candidate that cannot beat
+ * it.
+ */
+
+#ifndef __tracktable_TrajectorySimilaritySearch_h
+#define __tracktable_TrajectorySimilaritySearch_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/ParallelFor.h>
+#include <tracktable/Analysis/DistanceGeometry.h>
+#include <tracktable/Analysis/RTree.h>
+#include <tracktable/Analysis/TrajectorySimilarity.h>
+#include <tracktable/Domain/FeatureVectors.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace tracktable {
+
+/**
+ * @class TrajectorySimilaritySearch
+ * @brief Exact k-nearest-neighbor search over whole trajectories
+ *
+ * Results are exact for the chosen measure (discrete Fréchet, DTW or
+ * Hausdorff, with the chosen band).  Pruning uses two lower bounds
+ * that hold for all three measures in every domain:
+ *
+ * - Bounding ball: each trajectory is summarized by its middle point
+ *   and the largest distance from that point to any other point.  By
+ *   the triangle inequality no pair of points from two trajectories
+ *   can be closer than the distance between centers minus both radii.
+ * - Endpoints: Fréchet and DTW must match first point to first point
+ *   and last point to last point.
+ *
+ * Candidates are visited in order of increasing lower bound and the
+ * exact distances are computed in parallel batches.  Each exact
+ * computation is told the current k-th best distance so that it can
+ * give up as soon as it cannot win.
+ *
+ * The search keeps its own copy of every trajectory.
+ *
+ * @tparam TrajectoryT      Trajectory type for any domain
+ * @tparam signature_depth  Depth of the distance geometry signature used to seed the search
+ */
+template<typename TrajectoryT, std::size_t signature_depth=4>
+class TrajectorySimilaritySearch
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef domain::feature_vectors::FeatureVector<(signature_depth * (signature_depth + 1)) / 2> signature_type;
+  typedef std::pair<signature_type, std::size_t> indexed_signature_type;
+  typedef RTree<indexed_signature_type> rtree_type;
+
+  /// Position of a stored trajectory and its distance to the query
+  typedef std::pair<std::size_t, double> match_type;
+
+  /** Create an empty search index
+   *
+   * @param [in] measure  Distance measure used to rank results
+   * @param [in] band     Band for Fréchet and DTW (0 for none)
+   */
+  TrajectorySimilaritySearch(SimilarityMeasure measure=SimilarityMeasure::DISCRETE_FRECHET,
+                             std::size_t band=0)
+    : Measure(measure)
+    , Band(band)
+    , NumThreads(0)
+    { }
+
+  /// Distance measure used to rank results
+  void set_measure(SimilarityMeasure measure)
+    {
+      this->Measure = measure;
+    }
+
+  SimilarityMeasure measure() const
+    {
+      return this->Measure;
+    }
+
+  /// Band for Fréchet and DTW distances; 0 means no restriction
+  void set_band(std::size_t band)
+    {
+      this->Band = band;
+    }
+
+  std::size_t band() const
+    {
+      return this->Band;
+    }
+
+  /// Number of threads for exact distances; 0 means default_thread_count()
+  void set_num_threads(std::size_t num_threads)
+    {
+      this->NumThreads = num_threads;
+    }
+
+  std::size_t num_threads() const
+    {
+      return this->NumThreads;
+    }
+
+  /** Add one trajectory to the index
+   *
+   * Its position (starting from 0 in insertion order) is what
+   * find_nearest() reports.
+   *
+   * @param [in] trajectory  Trajectory to add (will be copied)
+   */
+  void insert(trajectory_type const& trajectory)
+    {
+      this->Trajectories.push_back(trajectory);
+      this->Summaries.push_back(this->summarize(trajectory));
+      if (trajectory.size() > 0)
+        {
+        this->SignatureTree.insert(
+          indexed_signature_type(this->Summaries.back().Signature,
+                                 this->Trajectories.size() - 1));
+        }
+    }
+
+  /** Add several trajectories to the index
+   *
+   * @param [in] begin  Start of the trajectory sequence
+   * @param [in] end    End of the trajectory sequence
+   */
+  template<typename iterator_type>
+  void insert(iterator_type begin, iterator_type end)
+    {
+      for (; begin != end; ++begin)
+        {
+        this->insert(*begin);
+        }
+    }
+
+  /// Number of trajectories in the index
+  std::size_t size() const
+    {
+      return this->Trajectories.size();
+    }
+
+  /// Trajectory stored at a given position
+  trajectory_type const& trajectory(std::size_t index) const
+    {
+      return this->Trajectories[index];
+    }
+
+  /** Find the k stored trajectories closest to a query
+   *
+   * Empty trajectories are never returned.  Results are sorted by
+   * increasing distance; ties are broken by position.
+   *
+   * @param [in] query  Trajectory to compare against
+   * @param [in] k      Number of neighbors to find
+   * @return Up to k (position, distance) pairs
+   */
+  std::vector<match_type> find_nearest(trajectory_type const& query, std::size_t k) const
+    {
+      std::vector<match_type> best;
+      if (k == 0 || query.size() == 0 || this->Trajectories.empty())
+        {
+        return best;
+        }
+
+      Summary query_summary(this->summarize(query));
+      std::vector<char> visited(this->Trajectories.size(), 0);
+
+      // Seed with the nearest signatures so the threshold starts out tight
+      std::vector<indexed_signature_type> seeds;
+      this->SignatureTree.find_nearest_neighbors(
+        query_summary.Signature,
+        static_cast<unsigned int>(std::min(this->Trajectories.size(), 2 * k)),
+        std::back_inserter(seeds));
+
+      std::vector<std::size_t> batch;
+      for (std::size_t i = 0; i < seeds.size(); ++i)
+        {
+        batch.push_back(seeds[i].second);
+        visited[seeds[i].second] = 1;
+        }
+      this->evaluate_batch(query, batch, k, best);
+
+      std::vector<std::pair<double, std::size_t> > candidates;
+      for (std::size_t i = 0; i < this->Trajectories.size(); ++i)
+        {
+        if (!visited[i] && this->Trajectories[i].size() > 0)
+          {
+          candidates.push_back(std::make_pair(this->lower_bound(query_summary, this->Summaries[i]), i));
+          }
+        }
+      std::sort(candidates.begin(), candidates.end());
+
+      std::size_t batch_size = 4 * (this->NumThreads == 0 ? default_thread_count() : this->NumThreads);
+      std::size_t next = 0;
+      while (next < candidates.size())
+        {
+        batch.clear();
+        double threshold = this->threshold(best, k);
+        while (next < candidates.size() && batch.size() < batch_size)
+          {
+          if (!(candidates[next].first <= threshold))
+            {
+            next = candidates.size();
+            break;
+            }
+          batch.push_back(candidates[next].second);
+          ++next;
+          }
+        this->evaluate_batch(query, batch, k, best);
+        }
+
+      return best;
+    }
+
+  /** Lower bound on the distance between two trajectories
+   *
+   * This is the bound that find_nearest() uses for pruning.  It is
+   * exposed mainly so that it can be tested.
+   */
+  double lower_bound(trajectory_type const& first, trajectory_type const& second) const
+    {
+      return this->lower_bound(this->summarize(first), this->summarize(second));
+    }
+
+private:
+  struct Summary
+  {
+    point_type Center;
+    double Radius;
+    point_type First;
+    point_type Last;
+    std::size_t NumPoints;
+    signature_type Signature;
+  };
+
+  SimilarityMeasure Measure;
+  std::size_t Band;
+  std::size_t NumThreads;
+  std::vector<trajectory_type> Trajectories;
+  std::vector<Summary> Summaries;
+  rtree_type SignatureTree;
+
+  Summary summarize(trajectory_type const& trajectory) const
+    {
+      Summary summary;
+      summary.NumPoints = trajectory.size();
+      summary.Radius = 0;
+      if (trajectory.size() == 0)
+        {
+        return summary;
+        }
+
+      summary.Center = trajectory[trajectory.size() / 2];
+      summary.First = trajectory.front();
+      summary.Last = trajectory.back();
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        summary.Radius = std::max(summary.Radius,
+                                  ::tracktable::distance(summary.Center, trajectory[i]));
+        }
+
+      std::vector<double> signature(distance_geometry_by_distance(trajectory, signature_depth));
+      for (std::size_t i = 0; i < signature.size(); ++i)
+        {
+        summary.Signature[i] = signature[i];
+        }
+      return summary;
+    }
+
+  double lower_bound(Summary const& first, Summary const& second) const
+    {
+      double bound = ::tracktable::distance(first.Center, second.Center)
+        - first.Radius - second.Radius;
+      bound = std::max(bound, 0.0);
+
+      double start = ::tracktable::distance(first.First, second.First);
+      double finish = ::tracktable::distance(first.Last, second.Last);
+      if (this->Measure == SimilarityMeasure::DISCRETE_FRECHET)
+        {
+        bound = std::max(bound, std::max(start, finish));
+        }
+      else if (this->Measure == SimilarityMeasure::DYNAMIC_TIME_WARPING)
+        {
+        bool single_cell = (first.NumPoints == 1 && second.NumPoints == 1);
+        bound = std::max(bound, single_cell ? start : start + finish);
+        }
+      return bound;
+    }
+
+  static double threshold(std::vector<match_type> const& best, std::size_t k)
+    {
+      return (best.size() < k ? std::numeric_limits<double>::infinity() : best.back().second);
+    }
+
+  static bool closer(match_type const& a, match_type const& b)
+    {
+      return (a.second < b.second || (a.second == b.second && a.first < b.first));
+    }
+
+  // Compute exact distances for a batch of candidates in parallel and
+  // merge them into the running list of the k best
+  void evaluate_batch(trajectory_type const& query,
+                      std::vector<std::size_t> const& batch,
+                      std::size_t k,
+                      std::vector<match_type>& best) const
+    {
+      double cutoff = this->threshold(best, k);
+      std::vector<double> distances(batch.size());
+      parallel_for(0, batch.size(),
+                   [&, this](std::size_t i) {
+                     distances[i] = trajectory_distance(this->Measure, query,
+                                                        this->Trajectories[batch[i]],
+                                                        this->Band, cutoff);
+                   },
+                   this->NumThreads, 1);
+
+      for (std::size_t i = 0; i < batch.size(); ++i)
+        {
+        if (distances[i] <= cutoff && distances[i] != std::numeric_limits<double>::infinity())
+          {
+          best.push_back(match_type(batch[i], distances[i]));
+          }
+        }
+      std::sort(best.begin(), best.end(), closer);
+      if (best.size() > k)
+        {
+        best.resize(k);
+        }
+    }
+};
+
+} // namespace tracktable
+
+#endif
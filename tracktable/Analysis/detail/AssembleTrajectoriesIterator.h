@@ -31,7 +31,10 @@
 #ifndef __tracktable_AssembleTrajectoriesIterator_h
 #define __tracktable_AssembleTrajectoriesIterator_h
 
+#include <tracktable/Core/MemoryResource.h>
 #include <tracktable/Core/Timestamp.h>
+#include <tracktable/Analysis/ReorderBuffer.h>
+#include <tracktable/Analysis/StreamingSimplification.h>
 
 #include <list>
 
@@ -43,6 +46,7 @@
 #include <typeinfo>
 #include <iterator>
 #include <cassert>
+#include <utility>
 
 namespace tracktable {
 
@@ -54,6 +58,9 @@ template<
 class AssembleTrajectoriesIterator
 {
 public:
+  typedef StreamingSimplifier<trajectory_type> simplifier_type;
+  typedef ReorderBuffer<point_type> reorder_buffer_type;
+
   AssembleTrajectoriesIterator()
     {
       this->MinimumTrajectoryLength = 0;
@@ -63,6 +70,8 @@ public:
       this->InvalidTrajectoryCount = 0;
       this->PointCount = 0;
       this->CleanupInterval = 10000;
+      this->Resource = nullptr;
+      this->HoistConstantProperties = false;
     }
 
   AssembleTrajectoriesIterator(source_iterator_type const& input_begin,
@@ -70,13 +79,21 @@ public:
                                int minimum_length,
                                double separation_distance,
                                Duration const& separation_time,
-                               int cleanup_interval)
+                               int cleanup_interval,
+                               simplifier_type const& simplifier=simplifier_type(),
+                               memory_resource* resource=nullptr,
+                               bool hoist_constant_properties=false,
+                               reorder_buffer_type const& reorder=reorder_buffer_type())
     : InputBegin(input_begin),
       InputEnd(input_end),
       MinimumTrajectoryLength(minimum_length),
       SeparationDistance(separation_distance),
       SeparationTime(separation_time),
-      CleanupInterval(cleanup_interval)
+      CleanupInterval(cleanup_interval),
+      Simplifier(simplifier),
+      Resource(resource),
+      HoistConstantProperties(hoist_constant_properties),
+      Reorder(reorder)
     {
       this->ValidTrajectoryCount = 0;
       this->InvalidTrajectoryCount = 0;
@@ -98,7 +115,12 @@ public:
       ValidTrajectoryCount(other.ValidTrajectoryCount),
       InvalidTrajectoryCount(other.InvalidTrajectoryCount),
       PointCount(other.PointCount),
-      CleanupInterval(other.CleanupInterval)
+      CleanupInterval(other.CleanupInterval),
+      Simplifier(other.Simplifier),
+      SimplifiersInProgress(other.SimplifiersInProgress),
+      Resource(other.Resource),
+      HoistConstantProperties(other.HoistConstantProperties),
+      Reorder(other.Reorder)
     { }
 
   ~AssembleTrajectoriesIterator() { }
@@ -115,6 +137,12 @@ public:
       this->InvalidTrajectoryCount = other.InvalidTrajectoryCount;
       this->PointCount = other.PointCount;
       this->CleanupInterval = other.CleanupInterval;
+      this->Simplifier = other.Simplifier;
+      this->SimplifiersInProgress = other.SimplifiersInProgress;
+      this->Resource = other.Resource;
+      this->HoistConstantProperties = other.HoistConstantProperties;
+      this->Reorder = other.Reorder;
+      return *this;
     }
 
   // ----------------------------------------------------------------------
@@ -133,6 +161,7 @@ public:
         this->SeparationTime == other.SeparationTime &&
         this->TrajectoriesInProgress.size() == other.TrajectoriesInProgress.size() &&
         this->FinishedTrajectories.size() == other.FinishedTrajectories.size() &&
+        this->Reorder.size() == other.Reorder.size() &&
         this->CleanupInterval == other.CleanupInterval
         );
     }
@@ -168,9 +197,24 @@ public:
 
   // ----------------------------------------------------------------------
 
+  std::size_t late_point_count() const
+    {
+      return this->Reorder.late_point_count();
+    }
+
+  // ----------------------------------------------------------------------
+
+  std::size_t dropped_point_count() const
+    {
+      return this->Reorder.dropped_point_count();
+    }
+
+  // ----------------------------------------------------------------------
+
   trajectory_type operator*()
     {
       assert(this->FinishedTrajectories.empty() == false);
+      ScopedMemoryResource use_resource(this->Resource);
       return this->FinishedTrajectories.front();
     }
 
@@ -202,6 +246,7 @@ public:
 private:
   typedef boost::unordered_map<std::string, trajectory_type> string_trajectory_map_type;
   typedef std::list<trajectory_type>     trajectory_list_type;
+  typedef boost::unordered_map<std::string, simplifier_type> string_simplifier_map_type;
 
   source_iterator_type InputBegin;
   source_iterator_type InputEnd;
@@ -218,41 +263,56 @@ private:
   int PointCount;
   int CleanupInterval;
 
+  // Per-object simplification state, only used when the simplifier
+  // has a nonzero tolerance
+  simplifier_type Simplifier;
+  string_simplifier_map_type SimplifiersInProgress;
+
+  // Where trajectories under construction get their memory; nullptr
+  // means whatever is current on the calling thread
+  memory_resource* Resource;
+
+  // Share constant point properties in each finished trajectory
+  bool HoistConstantProperties;
+
+  // Puts late input points back in time order, only used when the
+  // maximum lateness is positive
+  reorder_buffer_type Reorder;
+
   // ----------------------------------------------------------------------
 
   void find_next_complete_trajectory()
     {
+      ScopedMemoryResource use_resource(this->Resource);
       point_type next_point;
 
-      while (this->InputBegin != this->InputEnd)
+      while (this->next_input_point(next_point))
         {
         ++ this->PointCount;
 
-        next_point = *(this->InputBegin);
         typename string_trajectory_map_type::iterator find_iter = this->TrajectoriesInProgress.find(next_point.object_id());
 
         if (find_iter == this->TrajectoriesInProgress.end())
           {
           // We are not currently tracking a trajectory with this
-          // object ID.  Start a new one.
-          trajectory_type new_traj;
-          new_traj.push_back(next_point);
-          this->TrajectoriesInProgress[next_point.object_id()] = new_traj;
+          // object ID.  Start a new one in place.
+          this->start_trajectory(next_point);
           }
         else
           {
           // We have a partial trajectory for this object ID.
           if (this->point_belongs_to_trajectory(find_iter, next_point))
             {
-            (*find_iter).second.push_back(next_point);
+            this->extend_trajectory(find_iter, next_point);
             }
           else
             {
             // We're about to start a new trajectory.  Clear out the
             // old one and announce its readiness.
-            if ((*find_iter).second.size() >= this->MinimumTrajectoryLength)
+            if (this->input_point_count(find_iter) >= this->MinimumTrajectoryLength)
               {
-              this->FinishedTrajectories.push_back((*find_iter).second);
+              this->finish_trajectory(find_iter);
+              this->FinishedTrajectories.push_back(std::move((*find_iter).second));
               this->TrajectoriesInProgress.erase(find_iter);
               ++ this->ValidTrajectoryCount;
               }
@@ -263,9 +323,7 @@ private:
               }
 
             // Start the new trajectory.
-            trajectory_type new_traj;
-            new_traj.push_back(next_point);
-            this->TrajectoriesInProgress[next_point.object_id()] = new_traj;
+            this->start_trajectory(next_point);
             }
           }
 
@@ -274,7 +332,6 @@ private:
           this->cleanup_trajectories_in_progress(next_point.timestamp());
           }
 
-        ++ this->InputBegin;
         if (this->FinishedTrajectories.empty() == false)
           {
           return;
@@ -282,8 +339,7 @@ private:
         }
 
       // Done iterating over all input points.
-      if (this->InputBegin == this->InputEnd &&
-          this->TrajectoriesInProgress.size() > 0)
+      if (this->TrajectoriesInProgress.size() > 0)
         {
         this->cleanup_trajectories_in_progress(next_point.timestamp() + days(10000));
         }
@@ -292,6 +348,43 @@ private:
 
   // ----------------------------------------------------------------------
 
+  bool reordering() const
+    {
+      return (this->Reorder.maximum_lateness() > seconds(0));
+    }
+
+  // ----------------------------------------------------------------------
+
+  // Fetch the next point to assemble, either straight from the input
+  // or, when reordering, from the reorder buffer once it is ready.
+  bool next_input_point(point_type& point)
+    {
+      if (!this->reordering())
+        {
+        if (this->InputBegin == this->InputEnd)
+          {
+          return false;
+          }
+        point = *(this->InputBegin);
+        ++ this->InputBegin;
+        return true;
+        }
+
+      while (!this->Reorder.pop(point))
+        {
+        if (this->InputBegin == this->InputEnd)
+          {
+          this->Reorder.flush();
+          return this->Reorder.pop(point);
+          }
+        this->Reorder.push(*(this->InputBegin));
+        ++ this->InputBegin;
+        }
+      return true;
+    }
+
+  // ----------------------------------------------------------------------
+
   void cleanup_trajectories_in_progress(Timestamp const& current_time)
     {
       typename string_trajectory_map_type::iterator traj_iter(this->TrajectoriesInProgress.begin());
@@ -303,15 +396,17 @@ private:
           {
           // This trajectory is done and can either be published or
           // discarded.
-          if ((*traj_iter).second.size() >= this->MinimumTrajectoryLength)
+          if (this->input_point_count(traj_iter) >= this->MinimumTrajectoryLength)
             {
-            this->FinishedTrajectories.push_back((*traj_iter).second);
+            this->finish_trajectory(traj_iter);
+            this->FinishedTrajectories.push_back(std::move((*traj_iter).second));
             ++this->ValidTrajectoryCount;
             }
           else
             {
             ++this->InvalidTrajectoryCount;
             }
+          this->SimplifiersInProgress.erase((*traj_iter).first);
 
           traj_iter = this->TrajectoriesInProgress.erase(traj_iter);
           }
@@ -325,6 +420,75 @@ private:
 
   // ----------------------------------------------------------------------
 
+  bool simplifying() const
+    {
+      return (this->Simplifier.tolerance() > 0);
+    }
+
+  // ----------------------------------------------------------------------
+
+  void start_trajectory(point_type const& first_point)
+    {
+      trajectory_type& trajectory(this->TrajectoriesInProgress[first_point.object_id()]);
+      if (this->simplifying())
+        {
+        simplifier_type& simplifier(this->SimplifiersInProgress[first_point.object_id()]);
+        simplifier = this->Simplifier;
+        simplifier.append(trajectory, first_point);
+        }
+      else
+        {
+        trajectory.push_back(first_point);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  template<typename trajectory_iter_t>
+  void extend_trajectory(trajectory_iter_t const& iter, point_type const& next_point)
+    {
+      if (this->simplifying())
+        {
+        this->SimplifiersInProgress[(*iter).first].append((*iter).second, next_point);
+        }
+      else
+        {
+        (*iter).second.push_back(next_point);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  // Number of input points in a trajectory in progress.  This is
+  // what the minimum length applies to, even when simplification has
+  // thrown some of them away.
+  template<typename trajectory_iter_t>
+  std::size_t input_point_count(trajectory_iter_t const& iter)
+    {
+      if (this->simplifying())
+        {
+        return this->SimplifiersInProgress[(*iter).first].points_appended();
+        }
+      return (*iter).second.size();
+    }
+
+  // ----------------------------------------------------------------------
+
+  template<typename trajectory_iter_t>
+  void finish_trajectory(trajectory_iter_t const& iter)
+    {
+      if (this->simplifying())
+        {
+        this->SimplifiersInProgress[(*iter).first].finish((*iter).second);
+        }
+      if (this->HoistConstantProperties)
+        {
+        (*iter).second.hoist_constant_properties();
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
   template<typename trajectory_iter_t>
   bool point_belongs_to_trajectory(trajectory_iter_t const& iter,
                                    point_type const& latest_point) const
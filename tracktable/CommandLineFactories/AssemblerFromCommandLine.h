@@ -54,6 +54,7 @@ class AssemblerFromCommandLine : public CommandLineFactory {
     std::size_t SeparationSeconds;
     std::size_t MinimumNumPoints;
     std::size_t CleanupInterval;
+    double SimplifyTolerance;
   };
 
  private:
@@ -79,6 +80,9 @@ class AssemblerFromCommandLine : public CommandLineFactory {
     ("clean-up-interval",
       bpo::value<std::size_t>(&settings->CleanupInterval)->default_value(10000),
      "Number of points between cleanup")
+    ("simplify-tolerance",
+      bpo::value<double>(&settings->SimplifyTolerance)->default_value(0),
+     "Drop points that can be interpolated in time to within this distance (0 keeps all points)")
     ;
     _options.add(assemblerOptions);
     // clang-format on
@@ -100,6 +104,7 @@ class AssemblerFromCommandLine : public CommandLineFactory {
     assembler->set_separation_time(tracktable::seconds(settings->SeparationSeconds));
     assembler->set_minimum_trajectory_length(settings->MinimumNumPoints);
     assembler->set_cleanup_interval(settings->CleanupInterval);
+    assembler->set_simplification_tolerance(settings->SimplifyTolerance);
     return assembler;
   }
 };
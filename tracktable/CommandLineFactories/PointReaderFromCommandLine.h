@@ -32,9 +32,11 @@
 #include "CommandLineFactory.h"
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/RW/CompressedInputStream.h>
 #include <tracktable/RW/PointReader.h>
 
 #include <fstream>
+#include <memory>
 
 namespace bpo = boost::program_options;
 namespace tracktable {
@@ -57,6 +59,7 @@ class PointReaderFromCommandLine : public CommandLineFactory {
     size_t TimestampColumn = 0;
     size_t FirstCoordinateColumn = 0;
     size_t SecondCoordinateColumn = 0;
+    size_t DecompressionThreads = 0;
     std::vector<FieldAssignmentType> RealFields;
     std::vector<FieldAssignmentType> TimestampFields;
     std::vector<FieldAssignmentType> StringFields;
@@ -67,6 +70,7 @@ class PointReaderFromCommandLine : public CommandLineFactory {
       _o << "TimestampColumn: " << TimestampColumn << std::endl;
       _o << "FirstCoordinateColumn: " << FirstCoordinateColumn << std::endl;
       _o << "SecondCoordinateColumn: " << SecondCoordinateColumn << std::endl;
+      _o << "DecompressionThreads: " << DecompressionThreads << std::endl;
       _o << "RealFields: " << std::endl;
       for (auto& field : RealFields) {
         _o << "  " << field.first << ": " << field.second << std::endl;
@@ -145,6 +149,9 @@ class PointReaderFromCommandLine : public CommandLineFactory {
     ("delimiter",
       bpo::value<StringType>(&settings->FieldDelimiter)->default_value("\t"),
      "Delimiter for fields in input file")
+    ("decompression-threads",
+      bpo::value<size_t>(&settings->DecompressionThreads)->default_value(0),
+     "Threads for decompressing blocked gzip (bgzip) input files (0 for one per processor)")
     ;
     _options.add(readerOptions);
     // clang-format on
@@ -170,11 +177,19 @@ class PointReaderFromCommandLine : public CommandLineFactory {
         throw std::runtime_error(
             "ERROR: Trying to create second point reader which is not supported at this time\n");
       }
-      infile.open(settings->InputFilename.c_str());
+      infile.open(settings->InputFilename.c_str(), std::ios::in | std::ios::binary);
       if (!infile.is_open()) {
         throw std::runtime_error("ERROR: Cannot open file " + settings->InputFilename + " for input.\n");
       }
-      reader->set_input(infile);
+      // gzip and zstd files are recognized by their magic numbers and
+      // decompressed on the fly.  Anything else passes straight through.
+      decompressedInfile = std::make_unique<tracktable::CompressedInputStream>(infile, settings->DecompressionThreads);
+      if (!compression_format_supported(decompressedInfile->format())) {
+        throw std::runtime_error("ERROR: " + settings->InputFilename + " is compressed with " +
+                                 compression_format_name(decompressedInfile->format()) +
+                                 ", which this build of Tracktable cannot read.\n");
+      }
+      reader->set_input(*decompressedInfile);
     }
     reader->set_object_id_column(settings->ObjectIdColumn);
     reader->set_timestamp_column(settings->TimestampColumn);
@@ -197,6 +212,7 @@ class PointReaderFromCommandLine : public CommandLineFactory {
   }
 
   ~PointReaderFromCommandLine() {
+    decompressedInfile.reset();
     if (infile.is_open()) {
       infile.close();
     }
@@ -204,6 +220,7 @@ class PointReaderFromCommandLine : public CommandLineFactory {
 
  private:
   std::ifstream infile;
+  std::unique_ptr<tracktable::CompressedInputStream> decompressedInfile;
 };
 
 }  // namespace tracktable
@@ -39,7 +39,8 @@ enum FieldID {
   SECONDS = 1 << 1,
   MINIMUMPOINTS = 1 << 2,
   CLEANUPINTERVAL = 1 << 3,
-  ALL = DISTANCE | SECONDS | MINIMUMPOINTS | CLEANUPINTERVAL
+  SIMPLIFYTOLERANCE = 1 << 4,
+  ALL = DISTANCE | SECONDS | MINIMUMPOINTS | CLEANUPINTERVAL | SIMPLIFYTOLERANCE
 };
 
 using tracktable::AssemblerFromCommandLine;
@@ -142,6 +143,20 @@ SCENARIO("Creating Assembler", "[AssemblerFromCommandLine]") {
           }
         }
       }
+      WHEN("args: --simplify-tolerance=0.5") {
+        int ARGC = 2;
+        char* ARGV[3]{(char*)"exec", (char*)"--simplify-tolerance=0.5", nullptr};
+        WHEN("Command Line is parsed") {
+          factory.parseCommandLine(ARGC, ARGV);
+          WHEN("assembler is created") {
+            auto assembler = factory.createAssembler(reader);
+            THEN("simplification tolerance is set to 0.5; Rest are default") {
+              REQUIRE(assembler->simplification_tolerance() == Approx(0.5));
+              checkDefaults(assembler, FieldID(~FieldID::SIMPLIFYTOLERANCE));
+            }
+          }
+        }
+      }
 
       WHEN("args: --separation-distance=42 --separation-seconds=43 --min-points=44 --clean-up-interval=45") {
         int ARGC = 5;
@@ -182,4 +197,7 @@ void checkDefaults(std::shared_ptr<AssemblerT> _assembler, FieldID _fields) {
   if (0 != (FieldID::CLEANUPINTERVAL & _fields)) {
     REQUIRE(_assembler->cleanup_interval() == 10000);
   }
+  if (0 != (FieldID::SIMPLIFYTOLERANCE & _fields)) {
+    REQUIRE(_assembler->simplification_tolerance() == Approx(0.0));
+  }
 }
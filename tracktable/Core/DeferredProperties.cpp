@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Core/DeferredProperties.h>
+#include <tracktable/Core/Logging.h>
+#include <tracktable/Core/TimestampConverter.h>
+
+#include <boost/lexical_cast.hpp>
+
+namespace tracktable {
+
+void DeferredProperties::add(string_type const& name, string_type const& text, PropertyUnderlyingType type)
+{
+  for (std::size_t i = 0; i < this->Entries.size(); ++i)
+    {
+    if (this->Entries[i].Name == name)
+      {
+      this->Entries[i].Text = text;
+      this->Entries[i].Type = type;
+      return;
+      }
+    }
+
+  Entry entry;
+  entry.Name = name;
+  entry.Text = text;
+  entry.Type = type;
+  this->Entries.push_back(entry);
+}
+
+// ----------------------------------------------------------------------
+
+void DeferredProperties::erase(string_type const& name)
+{
+  for (std::size_t i = 0; i < this->Entries.size(); ++i)
+    {
+    if (this->Entries[i].Name == name)
+      {
+      this->Entries.erase(this->Entries.begin() + i);
+      return;
+      }
+    }
+}
+
+// ----------------------------------------------------------------------
+
+void DeferredProperties::resolve_all(PropertyMap& properties)
+{
+  for (std::size_t i = 0; i < this->Entries.size(); ++i)
+    {
+    convert(this->Entries[i], properties);
+    }
+  this->Entries.clear();
+}
+
+// ----------------------------------------------------------------------
+
+void DeferredProperties::convert(Entry const& entry, PropertyMap& properties)
+{
+  switch (entry.Type)
+    {
+    case TYPE_REAL:
+      {
+      double value = 0;
+      if (boost::conversion::try_lexical_convert(entry.Text, value))
+        {
+        set_property(properties, entry.Name, PropertyValueT(value));
+        return;
+        }
+      }; break;
+    case TYPE_TIMESTAMP:
+      {
+      // Converters hold stream buffers, so each thread gets its own.
+      static thread_local TimestampConverter converter;
+      Timestamp value(converter.timestamp_from_string(entry.Text));
+      if (is_timestamp_valid(value))
+        {
+        set_property(properties, entry.Name, PropertyValueT(value));
+        return;
+        }
+      }; break;
+    default:
+      {
+      set_property(properties, entry.Name, to_property_variant(entry.Text, entry.Type));
+      return;
+      }
+    }
+
+  TRACKTABLE_LOG(log::debug)
+    << "WARNING: Parse error while trying to set deferred field '"
+    << entry.Name << "' from string '"
+    << entry.Text << "'";
+}
+
+} // namespace tracktable
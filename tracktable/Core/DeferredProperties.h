@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Core/DeferredProperties.h - Property values kept as text
+ * until they are read
+ *
+ * Readers in lazy-property mode hand each point the raw text of its
+ * numeric and timestamp columns instead of converting it.  The point
+ * keeps that text in a DeferredProperties and converts all of it the
+ * first time anything reads one of its properties.  From then on the
+ * values live in the point's PropertyMap like any other property.
+ */
+
+#ifndef __tracktable_DeferredProperties_h
+#define __tracktable_DeferredProperties_h
+
+#include <tracktable/Core/TracktableCoreWindowsHeader.h>
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/PropertyMap.h>
+#include <tracktable/Core/PropertyValue.h>
+
+#include <vector>
+
+namespace tracktable {
+
+/** Named property values that have not been converted yet
+ *
+ * Each entry holds a property's name, its text and the type it should
+ * become.  Real values are converted with `boost::lexical_cast` and
+ * timestamps with the default input format.  Text that does not
+ * convert is dropped with a debug message, just as a reader drops a
+ * column that it cannot parse.
+ */
+class TRACKTABLE_CORE_EXPORT DeferredProperties
+{
+public:
+  /** Remember a value to convert later
+   *
+   * Replaces any text already deferred under the same name.
+   *
+   * @param [in] name  Name of property
+   * @param [in] text  Value as it appeared in the input
+   * @param [in] type  Type to convert the text to
+   */
+  void add(string_type const& name, string_type const& text, PropertyUnderlyingType type);
+
+  /** Forget a deferred value without converting it
+   *
+   * @param [in] name  Name of property
+   */
+  void erase(string_type const& name);
+
+  /// Check whether there is anything left to convert
+  bool empty() const
+    {
+      return this->Entries.empty();
+    }
+
+  /// Forget every deferred value
+  void clear()
+    {
+      this->Entries.clear();
+    }
+
+  /** Convert every deferred value into a property map
+   *
+   * The text is forgotten afterward whether or not it converted.
+   *
+   * @param [in,out] properties  Map to receive the converted values
+   */
+  void resolve_all(PropertyMap& properties);
+
+private:
+  struct Entry
+  {
+    string_type Name;
+    string_type Text;
+    PropertyUnderlyingType Type;
+  };
+
+  static void convert(Entry const& entry, PropertyMap& properties);
+
+  // Points rarely defer more than a few dozen columns, so a vector
+  // is cheaper than a map here.
+  std::vector<Entry> Entries;
+};
+
+} // namespace tracktable
+
+#endif
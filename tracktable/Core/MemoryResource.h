@@ -0,0 +1,272 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Core/MemoryResource.h - Draw trajectories, points and
+ * property maps from an arena instead of the global heap
+ *
+ * Every trajectory point owns a property map whose nodes are separate
+ * heap allocations, and every trajectory owns a vector of points.
+ * Tearing down millions of them one free() at a time is slow, and
+ * threads that allocate and free at the same time contend for the
+ * heap.  PropertyMap and Trajectory allocate through ResourceAllocator,
+ * which sends their memory to a memory_resource chosen when the
+ * container is created:
+ *
+ *   - a container created with no resource installed uses the global
+ *     heap, exactly as before;
+ *
+ *   - a container created while a ScopedMemoryResource is alive on
+ *     the current thread uses that resource.  This includes copies:
+ *     copying a point or trajectory puts the copy in the resource that
+ *     is current at the time, not in the resource of the original.
+ *
+ * The usual pattern is to build a batch inside a monotonic arena, work
+ * on it and then throw the whole batch away at once:
+ *
+ *   boost::container::pmr::monotonic_buffer_resource arena;
+ *   {
+ *     tracktable::ScopedMemoryResource use_arena(&arena);
+ *     std::vector<trajectory_type> batch(read_batch());
+ *     process(batch);
+ *   }   // batch destroyed; its deallocations cost nothing
+ *   arena.release();
+ *
+ * Anything allocated from a resource must be destroyed (or copied
+ * outside the scope) before that resource is released.  Moving a
+ * container keeps its resource, so do not move arena-backed
+ * trajectories into long-lived storage.  Do not swap() property maps
+ * or point vectors that come from different resources; assign with
+ * std::move() instead.
+ *
+ * ArenaSet holds one monotonic arena per worker thread for the
+ * parallel readers.  Like the arenas themselves it is not thread-safe:
+ * each arena must only be used by one thread at a time.
+ */
+
+#ifndef __tracktable_MemoryResource_h
+#define __tracktable_MemoryResource_h
+
+#include <tracktable/Core/TracktableCoreWindowsHeader.h>
+
+#include <boost/container/pmr/memory_resource.hpp>
+#include <boost/container/pmr/monotonic_buffer_resource.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace tracktable {
+
+/// Abstract source of memory, as in C++17's std::pmr::memory_resource
+typedef boost::container::pmr::memory_resource memory_resource;
+
+/// Arena that frees nothing until it is released or destroyed
+typedef boost::container::pmr::monotonic_buffer_resource monotonic_arena;
+
+/** Memory resource that new containers on this thread will use
+ *
+ * This is the global heap unless a ScopedMemoryResource is alive on
+ * the calling thread.
+ *
+ * @return Resource currently in effect on this thread
+ */
+TRACKTABLE_CORE_EXPORT memory_resource* current_memory_resource();
+
+/** Change the memory resource that new containers on this thread will use
+ *
+ * Prefer ScopedMemoryResource, which puts the old resource back for you.
+ *
+ * @param [in] resource New resource, or nullptr for the global heap
+ * @return The resource that was previously in effect
+ */
+TRACKTABLE_CORE_EXPORT memory_resource* set_current_memory_resource(memory_resource* resource);
+
+/** Use a memory resource on this thread for as long as this object lives
+ *
+ * Scopes nest: the previous resource comes back when this one is
+ * destroyed.  Passing nullptr keeps whatever is already in effect.
+ */
+class TRACKTABLE_CORE_EXPORT ScopedMemoryResource
+{
+public:
+  /** Install a resource for the current thread
+   *
+   * @param [in] resource Resource to use, or nullptr to leave things as they are
+   */
+  explicit ScopedMemoryResource(memory_resource* resource)
+    : Previous(current_memory_resource())
+    {
+      if (resource)
+        {
+        set_current_memory_resource(resource);
+        }
+    }
+
+  ~ScopedMemoryResource()
+    {
+      set_current_memory_resource(this->Previous);
+    }
+
+private:
+  ScopedMemoryResource(ScopedMemoryResource const&) = delete;
+  ScopedMemoryResource& operator=(ScopedMemoryResource const&) = delete;
+
+  memory_resource* Previous;
+};
+
+// ----------------------------------------------------------------------
+
+/** Standard allocator that draws from a memory_resource
+ *
+ * This behaves like std::pmr::polymorphic_allocator except for where
+ * default-constructed and copied containers get their memory: from
+ * current_memory_resource() instead of one process-wide default.
+ * Assignment and swap never move a container to a different
+ * resource.
+ *
+ * Because swap does not exchange allocators, swapping two containers
+ * that draw from different resources is undefined behavior: nodes
+ * from one resource would later be returned to the other.  Only swap
+ * containers that share a resource.  Move assignment is always safe;
+ * between different resources it moves the elements one at a time.
+ */
+template<typename T>
+class ResourceAllocator
+{
+public:
+  typedef T value_type;
+  typedef std::false_type propagate_on_container_copy_assignment;
+  typedef std::false_type propagate_on_container_move_assignment;
+  typedef std::false_type propagate_on_container_swap;
+  typedef std::false_type is_always_equal;
+
+  ResourceAllocator()
+    : Resource(current_memory_resource())
+    { }
+
+  ResourceAllocator(memory_resource* resource)
+    : Resource(resource ? resource : current_memory_resource())
+    { }
+
+  template<typename U>
+  ResourceAllocator(ResourceAllocator<U> const& other)
+    : Resource(other.resource())
+    { }
+
+  T* allocate(std::size_t n)
+    {
+      return static_cast<T*>(this->Resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+  void deallocate(T* p, std::size_t n)
+    {
+      this->Resource->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+  /// Copies of a container use whatever resource is current when they are made
+  ResourceAllocator select_on_container_copy_construction() const
+    {
+      return ResourceAllocator();
+    }
+
+  memory_resource* resource() const
+    {
+      return this->Resource;
+    }
+
+private:
+  memory_resource* Resource;
+};
+
+template<typename T, typename U>
+bool operator==(ResourceAllocator<T> const& a, ResourceAllocator<U> const& b)
+{
+  return (a.resource() == b.resource() || a.resource()->is_equal(*b.resource()));
+}
+
+template<typename T, typename U>
+bool operator!=(ResourceAllocator<T> const& a, ResourceAllocator<U> const& b)
+{
+  return !(a == b);
+}
+
+// ----------------------------------------------------------------------
+
+/** One monotonic arena per worker thread
+ *
+ * Hand arena(worker) to each worker of a parallel job.  Everything the
+ * workers build stays valid until release() or destruction, which
+ * frees all of it at once.
+ */
+class ArenaSet
+{
+public:
+  /** Create a set of arenas
+   *
+   * @param [in] num_arenas   Number of arenas, usually one per thread
+   * @param [in] initial_size Size in bytes of each arena's first block
+   */
+  explicit ArenaSet(std::size_t num_arenas, std::size_t initial_size=64*1024)
+    {
+      for (std::size_t i = 0; i < num_arenas; ++i)
+        {
+        this->Arenas.emplace_back(new monotonic_arena(initial_size));
+        }
+    }
+
+  /// Number of arenas in the set
+  std::size_t size() const
+    {
+      return this->Arenas.size();
+    }
+
+  /// Arena for worker i
+  memory_resource* arena(std::size_t i)
+    {
+      return this->Arenas[i].get();
+    }
+
+  /// Free everything allocated from every arena
+  void release()
+    {
+      for (std::size_t i = 0; i < this->Arenas.size(); ++i)
+        {
+        this->Arenas[i]->release();
+        }
+    }
+
+private:
+  std::vector<std::unique_ptr<monotonic_arena> > Arenas;
+};
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Core/ParallelFor.h - Run a loop body over an index range
+ * on several threads
+ *
+ * Batch algorithms often do the same independent piece of work for
+ * every trajectory in a collection.  This header gives them one small
+ * shared way to spread that work over std::threads without pulling in
+ * a tasking library.
+ */
+
+#ifndef __tracktable_ParallelFor_h
+#define __tracktable_ParallelFor_h
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tracktable {
+
+/** Return the number of threads to use when the caller does not say.
+ *
+ * This is the hardware concurrency reported by the standard library,
+ * or 1 if that cannot be determined.
+ */
+inline std::size_t default_thread_count()
+{
+  unsigned int hardware_threads = std::thread::hardware_concurrency();
+  return (hardware_threads == 0 ? 1 : hardware_threads);
+}
+
+/** Call a function for every index in [begin, end) using several threads.
+ *
+ * The function is called as `function(index, worker)` where `worker`
+ * is a number in [0, num_threads) that identifies the calling thread.
+ * Use it to index per-thread scratch space so that workers never
+ * share mutable state.
+ *
+ * Indices are handed out in blocks of `grain_size` from a shared
+ * counter so that uneven work (long and short trajectories) balances
+ * out between threads.  If the body throws, the remaining work is
+ * abandoned and the first exception is rethrown in the calling
+ * thread.
+ *
+ * When `num_threads` is 1, or the range is no larger than one block,
+ * the loop runs in the calling thread without starting any others.
+ *
+ * @param [in] begin       First index to process
+ * @param [in] end         One past the last index to process
+ * @param [in] function    Loop body taking (index, worker)
+ * @param [in] num_threads Number of threads to use; 0 means default_thread_count()
+ * @param [in] grain_size  Number of consecutive indices handed to a thread at once
+ */
+template<typename function_type>
+void parallel_for_with_worker(std::size_t begin,
+                              std::size_t end,
+                              function_type const& function,
+                              std::size_t num_threads=0,
+                              std::size_t grain_size=16)
+{
+  if (end <= begin)
+    {
+    return;
+    }
+  if (num_threads == 0)
+    {
+    num_threads = default_thread_count();
+    }
+  if (grain_size == 0)
+    {
+    grain_size = 1;
+    }
+
+  std::size_t num_blocks = (end - begin + grain_size - 1) / grain_size;
+  num_threads = std::min(num_threads, num_blocks);
+
+  if (num_threads <= 1)
+    {
+    for (std::size_t i = begin; i < end; ++i)
+      {
+      function(i, 0);
+      }
+    return;
+    }
+
+  std::atomic<std::size_t> next_block(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr first_error;
+  std::mutex error_mutex;
+
+  auto worker_body = [&](std::size_t worker) {
+    try
+      {
+      while (!failed.load(std::memory_order_relaxed))
+        {
+        std::size_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+        if (block >= num_blocks)
+          {
+          break;
+          }
+        std::size_t block_begin = begin + block * grain_size;
+        std::size_t block_end = std::min(end, block_begin + grain_size);
+        for (std::size_t i = block_begin; i < block_end; ++i)
+          {
+          function(i, worker);
+          }
+        }
+      }
+    catch (...)
+      {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!first_error)
+        {
+        first_error = std::current_exception();
+        }
+      failed.store(true, std::memory_order_relaxed);
+      }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(num_threads - 1);
+  for (std::size_t worker = 1; worker < num_threads; ++worker)
+    {
+    workers.push_back(std::thread(worker_body, worker));
+    }
+  worker_body(0);
+  for (std::size_t i = 0; i < workers.size(); ++i)
+    {
+    workers[i].join();
+    }
+
+  if (first_error)
+    {
+    std::rethrow_exception(first_error);
+    }
+}
+
+/** Call a function for every index in [begin, end) using several threads.
+ *
+ * This is the same as parallel_for_with_worker() except that the
+ * function is called as `function(index)`.
+ *
+ * @param [in] begin       First index to process
+ * @param [in] end         One past the last index to process
+ * @param [in] function    Loop body taking (index)
+ * @param [in] num_threads Number of threads to use; 0 means default_thread_count()
+ * @param [in] grain_size  Number of consecutive indices handed to a thread at once
+ */
+template<typename function_type>
+void parallel_for(std::size_t begin,
+                  std::size_t end,
+                  function_type const& function,
+                  std::size_t num_threads=0,
+                  std::size_t grain_size=16)
+{
+  parallel_for_with_worker(
+    begin, end,
+    [&function](std::size_t i, std::size_t /*worker*/) { function(i); },
+    num_threads, grain_size
+    );
+}
+
+} // namespace tracktable
+
+#endif
@@ -101,7 +101,7 @@ string_type PropertyConverter::property_to_string(PropertyValueT const& prop)
       };
 #endif
     case TYPE_STRING:
-      return boost::get<string_type>(prop);
+      return boost::get<SharedString>(prop);
     case TYPE_NULL:
       return this->NullValue;
     case TYPE_UNKNOWN:
@@ -128,7 +128,7 @@ PropertyValueT PropertyConverter::property_from_string(
       {
       case TYPE_STRING:
 	      {
-	      result = PropertyValueT(prop_value);
+	      result = PropertyValueT(this->Strings.intern(prop_value));
 	      }; break;
       case TYPE_REAL:
 	      {
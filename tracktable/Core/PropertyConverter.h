@@ -33,6 +33,7 @@
 
 #include <tracktable/Core/TracktableCommon.h>
 #include <tracktable/Core/PropertyMap.h>
+#include <tracktable/Core/SharedString.h>
 #include <tracktable/Core/TimestampConverter.h>
 #include <tracktable/Core/TracktableCoreWindowsHeader.h>
 #include <sstream>
@@ -175,6 +176,10 @@ class TRACKTABLE_CORE_EXPORT PropertyConverter
    * Parse a string to create a property value according to the
    * current input formats and the requested output type.
    *
+   * String values are interned: every string property this converter
+   * produces with the same text shares one buffer.  Each copy of a
+   * converter has its own pool, so give each thread its own copy.
+   *
    * @param [in] prop_string  Property represented as string
    * @param [in] prop_type    Property type (see tracktable::PropertyUnderlyingType)
    * @return Property parsed from string
@@ -193,6 +198,7 @@ class TRACKTABLE_CORE_EXPORT PropertyConverter
   TimestampConverter TimestampReadWrite;
   std::ostringstream OutputBuf;
   std::istringstream InputBuf;
+  StringPool Strings;
 };
 
 
@@ -37,6 +37,19 @@
 
 namespace {
 
+// Strings live in the variant as SharedString
+template<typename T>
+struct stored_type
+{
+  typedef T type;
+};
+
+template<>
+struct stored_type<tracktable::string_type>
+{
+  typedef tracktable::SharedString type;
+};
+
 /*! \brief Retrieve a property or some default value.
  *
  * This method of retrieving a named property will never fail or throw
@@ -65,7 +78,7 @@ T typed_property_with_default(
     {
     try
       {
-      return boost::get<T>(variant_result);
+      return boost::get<typename stored_type<T>::type>(variant_result);
       }
     catch (boost::bad_get e)
       {
@@ -352,7 +365,7 @@ string_type string_property(PropertyMap const& properties, string_type const& na
     try
       {
       if (is_present) *is_present = true;
-      return boost::get<string_type>(tuple_value);
+      return boost::get<SharedString>(tuple_value);
       }
     catch (boost::bad_get e)
       {
@@ -44,8 +44,10 @@
 #include <tracktable/Core/TracktableCoreWindowsHeader.h>
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/MemoryResource.h>
 #include <tracktable/Core/PropertyValue.h>
 
+#include <functional>
 #include <map>
 #include <boost/serialization/map.hpp>
 
@@ -59,8 +61,16 @@ namespace tracktable {
  *       asymptotic performance but we will probably never have enough
  *       entries in a single property map for it to even be noticeable,
  *       let alone significant.
+ *
+ * @note Map nodes come from the memory resource that is current when
+ *       the map is created.  See tracktable/Core/MemoryResource.h.
  */
-typedef std::map<std::string, PropertyValueT> PropertyMap;
+typedef std::map<
+  std::string,
+  PropertyValueT,
+  std::less<std::string>,
+  ResourceAllocator<std::pair<const std::string, PropertyValueT> >
+  > PropertyMap;
 
 /*! @brief Check to see whether a given property is present.
  *
@@ -72,20 +72,19 @@ public:
     }
 #endif
 
-  result_type operator()(tracktable::string_type const& value1)
+  result_type operator()(tracktable::SharedString const& value1)
     {
       if (tracktable::is_property_null(this->SecondValue))
         {
         return (this->interpolant < 0.5) ? value1 : this->SecondValue;
         }
-      tracktable::string_type value2(boost::get<tracktable::string_type>(this->SecondValue));
       if (this->interpolant < 0.5)
         {
         return tracktable::PropertyValueT(value1);
         }
       else
         {
-        return tracktable::PropertyValueT(value2);
+        return tracktable::PropertyValueT(boost::get<tracktable::SharedString>(this->SecondValue));
         }
     }
 
@@ -160,7 +159,7 @@ public:
       return tracktable::TYPE_REAL;
     }
 
-  tracktable::PropertyUnderlyingType operator()(tracktable::string_type const& /*value*/) const
+  tracktable::PropertyUnderlyingType operator()(tracktable::SharedString const& /*value*/) const
     {
       return tracktable::TYPE_STRING;
     }
@@ -301,8 +300,9 @@ public:
     }
 
     // Compares two strings using lexicographical comparison
-    int operator()(const std::string& v1, const std::string& v2) const {
-        return v1.compare(v2);
+    int operator()(const SharedString& v1, const SharedString& v2) const {
+        if (v1.shares_storage_with(v2)) return 0;
+        return v1.str().compare(v2.str());
     }
 
     // All null values are equal
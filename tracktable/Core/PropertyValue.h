@@ -48,6 +48,7 @@
 #include <tracktable/Core/TracktableCoreWindowsHeader.h>
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/SharedString.h>
 #include <tracktable/Core/Timestamp.h>
 
 #include <tracktable/Core/detail/algorithm_signatures/Interpolate.h>
@@ -55,6 +56,8 @@
 
 #include <boost/variant.hpp>
 #include <boost/serialization/variant.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/utility/enable_if.hpp>
 #include <boost/math/special_functions/relative_difference.hpp>
 
 namespace tracktable {
@@ -175,18 +178,88 @@ TRACKTABLE_CORE_EXPORT std::ostream& operator<<(std::ostream& out, NullValue con
  * Under the hood this will probably always be a `boost::variant` but we
  * will provide our own interface so that you don't have to know or care
  * exactly how Boost does it.
+ *
+ * Strings are stored as SharedString so that copies of a property
+ * share one immutable buffer.  `boost::get<string_type>` still works
+ * on a PropertyValue, but it gives read-only access to the shared
+ * text.
+ *
+ * \note This changes the variant's string alternative from
+ *       `string_type` to SharedString, which can break code that
+ *       reaches into the variant directly:
+ *         - `boost::get<string_type>` returns `string_type const&`
+ *           (or `string_type const*`) instead of a mutable reference.
+ *           To change a string property, assign a new value with
+ *           set_property().
+ *         - A visitor with an `operator()(string_type const&)`
+ *           overload still works through SharedString's implicit
+ *           conversion unless a template overload matches first.
+ *           Add an overload for SharedString (or call `str()`) in
+ *           that case.
+ *         - Use `boost::get<SharedString>` when you need the shared
+ *           storage itself.
+ *       Archives store strings exactly as before.
  */
 
 // typedef boost::variant<NullValue, int64_t, double, string_type, Timestamp> PropertyValueT;
  typedef boost::variant<
    NullValue,
    double,
-   string_type,
+   SharedString,
    Timestamp
    >
    PropertyValue;
 typedef PropertyValue PropertyValueT;
 
+} // namespace tracktable
+
+namespace boost {
+
+// String properties used to be stored as string_type.  These
+// overloads keep `boost::get<string_type>` compiling for code written
+// against that; they return the SharedString's text, read-only.
+
+template<typename U>
+inline typename boost::enable_if<boost::is_same<U, tracktable::string_type>, U const*>::type
+get(tracktable::PropertyValue const* operand) BOOST_NOEXCEPT
+{
+  tracktable::SharedString const* text = boost::get<tracktable::SharedString>(operand);
+  return (text ? &text->str() : 0);
+}
+
+template<typename U>
+inline typename boost::enable_if<boost::is_same<U, tracktable::string_type>, U const*>::type
+get(tracktable::PropertyValue* operand) BOOST_NOEXCEPT
+{
+  return boost::get<U>(const_cast<tracktable::PropertyValue const*>(operand));
+}
+
+template<typename U>
+inline typename boost::enable_if<boost::is_same<U, tracktable::string_type>, U const&>::type
+get(tracktable::PropertyValue const& operand)
+{
+  return boost::get<tracktable::SharedString>(operand).str();
+}
+
+template<typename U>
+inline typename boost::enable_if<boost::is_same<U, tracktable::string_type>, U const&>::type
+get(tracktable::PropertyValue& operand)
+{
+  return boost::get<tracktable::SharedString>(operand).str();
+}
+
+// A temporary variant takes its string with it, so hand back a copy
+template<typename U>
+inline typename boost::enable_if<boost::is_same<U, tracktable::string_type>, U>::type
+get(tracktable::PropertyValue&& operand)
+{
+  return boost::get<tracktable::SharedString>(operand).str();
+}
+
+} // namespace boost
+
+namespace tracktable {
+
 inline PropertyValue make_null(PropertyUnderlyingType null_type)
 {
   NullValue my_value(null_type);
@@ -275,6 +348,8 @@ PropertyValue to_property_variant(source_type const& source, PropertyUnderlyingT
       case TYPE_UNKNOWN:
         return PropertyValue();
       }
+    // Not a valid PropertyUnderlyingType
+    return PropertyValue();
     }
   catch (boost::bad_lexical_cast&)
     {
@@ -329,8 +404,80 @@ void load(Archive& ar, tracktable::PropertyUnderlyingType& value, const unsigned
     }
 }
 
+// PropertyValue gets its own save/load so that strings go into the
+// archive as a plain string_type, just as they did before the variant
+// held SharedString.  Everything else matches the layout from
+// boost/serialization/variant.hpp: the index, then the value.
+
+template<typename Archive>
+void save(Archive& ar, tracktable::PropertyValue const& property, const unsigned int /*version*/)
+{
+  int which = property.which();
+  ar << BOOST_SERIALIZATION_NVP(which);
+  switch (which)
+    {
+    case 0: {
+    tracktable::NullValue const& value(boost::get<tracktable::NullValue>(property));
+    ar << BOOST_SERIALIZATION_NVP(value);
+    }; break;
+    case 1: {
+    double const& value(boost::get<double>(property));
+    ar << BOOST_SERIALIZATION_NVP(value);
+    }; break;
+    case 2: {
+    tracktable::string_type const& value(boost::get<tracktable::SharedString>(property).str());
+    ar << BOOST_SERIALIZATION_NVP(value);
+    }; break;
+    case 3: {
+    tracktable::Timestamp const& value(boost::get<tracktable::Timestamp>(property));
+    ar << BOOST_SERIALIZATION_NVP(value);
+    }; break;
+    }
+}
+
+template<typename T, typename Archive>
+void load_property_alternative(Archive& ar, tracktable::PropertyValue& property)
+{
+  T value;
+  ar >> BOOST_SERIALIZATION_NVP(value);
+  property = value;
+  ar.reset_object_address(&boost::get<T>(property), &value);
+}
+
+template<typename Archive>
+void load(Archive& ar, tracktable::PropertyValue& property, const unsigned int /*version*/)
+{
+  int which;
+  ar >> BOOST_SERIALIZATION_NVP(which);
+  switch (which)
+    {
+    case 0: {
+    load_property_alternative<tracktable::NullValue>(ar, property);
+    }; break;
+    case 1: {
+    load_property_alternative<double>(ar, property);
+    }; break;
+    case 2: {
+    tracktable::string_type value;
+    ar >> BOOST_SERIALIZATION_NVP(value);
+    property = tracktable::SharedString(std::move(value));
+    }; break;
+    case 3: {
+    load_property_alternative<tracktable::Timestamp>(ar, property);
+    }; break;
+    default: {
+    boost::serialization::throw_exception(
+      boost::archive::archive_exception(
+        boost::archive::archive_exception::unsupported_version
+        )
+      );
+    }; break;
+    }
+}
+
 } } // namespace boost::serialization
 
 BOOST_SERIALIZATION_SPLIT_FREE(tracktable::PropertyUnderlyingType)
+BOOST_SERIALIZATION_SPLIT_FREE(tracktable::PropertyValue)
 
 #endif
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Core/SharedString.h>
+
+#include <boost/make_shared.hpp>
+
+namespace tracktable {
+
+namespace {
+
+boost::shared_ptr<const string_type> const& empty_string()
+{
+  static boost::shared_ptr<const string_type> empty(boost::make_shared<const string_type>());
+  return empty;
+}
+
+}
+
+SharedString::SharedString()
+  : Text(empty_string())
+{
+}
+
+SharedString::SharedString(string_type const& text)
+  : Text(boost::make_shared<const string_type>(text))
+{
+}
+
+SharedString::SharedString(string_type&& text)
+  : Text(boost::make_shared<const string_type>(std::move(text)))
+{
+}
+
+SharedString::SharedString(const char* text)
+  : Text(boost::make_shared<const string_type>(text))
+{
+}
+
+// ----------------------------------------------------------------------
+
+StringPool::StringPool(std::size_t max_entries)
+  : MaxEntries(max_entries)
+{
+}
+
+SharedString StringPool::intern(string_type const& text)
+{
+  // Look up by the plain string so that a hit costs no allocation
+  boost::unordered_set<SharedString, Hash, Equal>::const_iterator iter(
+    this->Strings.find(text, Hash(), Equal()));
+  if (iter != this->Strings.end())
+    {
+    return *iter;
+    }
+
+  SharedString result(text);
+  if (this->Strings.size() < this->MaxEntries)
+    {
+    this->Strings.insert(result);
+    }
+  return result;
+}
+
+} // namespace tracktable
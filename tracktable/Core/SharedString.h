@@ -0,0 +1,239 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * tracktable/Core/SharedString.h - Immutable strings that share storage
+ *
+ * String property values such as callsigns, aircraft types and
+ * destinations usually repeat on every point of a trajectory.  A
+ * SharedString holds a reference-counted pointer to an immutable
+ * string, so copying one (when a point is copied or interpolated)
+ * costs a reference count instead of an allocation and a copy.
+ *
+ * StringPool interns strings: asking a pool for the same text twice
+ * gives back two SharedStrings with the same storage.  The readers use
+ * one pool per parser so that all the points in a file that say
+ * "underway" share one string.
+ */
+
+#ifndef __tracktable_SharedString_h
+#define __tracktable_SharedString_h
+
+#include <tracktable/Core/TracktableCoreWindowsHeader.h>
+
+#include <tracktable/Core/TracktableCommon.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/unordered_set.hpp>
+
+#include <cstddef>
+#include <ostream>
+
+namespace tracktable {
+
+/** Immutable, reference-counted string
+ *
+ * SharedString converts implicitly to and from `string_type`, so you
+ * can use it most places you would use a `std::string const&`.  It
+ * never changes once created: to get a different value, assign a new
+ * SharedString.
+ *
+ * There is no serialization for SharedString itself.  PropertyValue
+ * writes its strings to archives as plain `string_type`.
+ */
+class TRACKTABLE_CORE_EXPORT SharedString
+{
+public:
+  /// Create an empty string
+  SharedString();
+
+  /** Copy text into new shared storage
+   *
+   * @param [in] text Value for the string
+   */
+  SharedString(string_type const& text);
+
+  /** Move text into new shared storage
+   *
+   * @param [in] text Value for the string
+   */
+  SharedString(string_type&& text);
+
+  /** Copy a C string into new shared storage
+   *
+   * @param [in] text Null-terminated value for the string
+   */
+  SharedString(const char* text);
+
+  /// Contents of the string
+  string_type const& str() const
+    {
+      return *this->Text;
+    }
+
+  operator string_type const&() const
+    {
+      return *this->Text;
+    }
+
+  const char* c_str() const
+    {
+      return this->Text->c_str();
+    }
+
+  std::size_t size() const
+    {
+      return this->Text->size();
+    }
+
+  bool empty() const
+    {
+      return this->Text->empty();
+    }
+
+  /** Check whether two strings use the same storage
+   *
+   * Strings from the same StringPool with the same contents always
+   * share storage, as do copies of one SharedString.
+   *
+   * @param [in] other String to check
+   * @return True if both strings point at the same storage
+   */
+  bool shares_storage_with(SharedString const& other) const
+    {
+      return (this->Text == other.Text);
+    }
+
+private:
+  boost::shared_ptr<const string_type> Text;
+};
+
+inline bool operator==(SharedString const& a, SharedString const& b)
+{
+  return (a.shares_storage_with(b) || a.str() == b.str());
+}
+
+inline bool operator==(SharedString const& a, string_type const& b) { return a.str() == b; }
+inline bool operator==(string_type const& a, SharedString const& b) { return a == b.str(); }
+inline bool operator==(SharedString const& a, const char* b) { return a.str() == b; }
+inline bool operator==(const char* a, SharedString const& b) { return a == b.str(); }
+
+inline bool operator!=(SharedString const& a, SharedString const& b) { return !(a == b); }
+inline bool operator!=(SharedString const& a, string_type const& b) { return !(a == b); }
+inline bool operator!=(string_type const& a, SharedString const& b) { return !(a == b); }
+inline bool operator!=(SharedString const& a, const char* b) { return !(a == b); }
+inline bool operator!=(const char* a, SharedString const& b) { return !(a == b); }
+
+inline bool operator<(SharedString const& a, SharedString const& b)
+{
+  return (!a.shares_storage_with(b) && a.str() < b.str());
+}
+
+inline std::ostream& operator<<(std::ostream& out, SharedString const& text)
+{
+  out << text.str();
+  return out;
+}
+
+// ----------------------------------------------------------------------
+
+/** Hand out one SharedString per distinct value
+ *
+ * A pool keeps every string it has handed out alive until it is
+ * cleared or destroyed.  Strings stay valid after that; they just stop
+ * being shared with later requests.  Once the pool holds
+ * `max_entries` strings it stops remembering new ones, so a column of
+ * unique values cannot make it grow without bound.
+ *
+ * StringPool is not thread-safe.  Give each thread its own.
+ */
+class TRACKTABLE_CORE_EXPORT StringPool
+{
+public:
+  /** Create an empty pool
+   *
+   * @param [in] max_entries Largest number of distinct strings to remember
+   */
+  explicit StringPool(std::size_t max_entries=65536);
+
+  /** Get the shared copy of a string
+   *
+   * @param [in] text Value to look up
+   * @return SharedString with the same contents as `text`
+   */
+  SharedString intern(string_type const& text);
+
+  /// Number of distinct strings in the pool
+  std::size_t size() const
+    {
+      return this->Strings.size();
+    }
+
+  /// Largest number of distinct strings the pool will remember
+  std::size_t max_entries() const
+    {
+      return this->MaxEntries;
+    }
+
+  /// Forget every string in the pool
+  void clear()
+    {
+      this->Strings.clear();
+    }
+
+private:
+  struct Hash
+  {
+    std::size_t operator()(string_type const& text) const
+      {
+        return boost::hash<string_type>()(text);
+      }
+    std::size_t operator()(SharedString const& text) const
+      {
+        return boost::hash<string_type>()(text.str());
+      }
+  };
+
+  struct Equal
+  {
+    template<typename T1, typename T2>
+    bool operator()(T1 const& a, T2 const& b) const
+      {
+        return (a == b);
+      }
+  };
+
+  boost::unordered_set<SharedString, Hash, Equal> Strings;
+  std::size_t MaxEntries;
+};
+
+} // namespace tracktable
+
+#endif
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Check that trajectories, points and property maps draw their
+// memory from the resource that was current when they were created,
+// and that copies made outside a scope go back to the heap.  The
+// timings compare building and tearing down a batch of trajectories
+// on the heap and in a monotonic arena.
+
+#include <tracktable/Core/MemoryResource.h>
+#include <tracktable/Core/PointLonLat.h>
+#include <tracktable/Core/Trajectory.h>
+#include <tracktable/Core/TrajectoryPoint.h>
+
+#include <boost/container/pmr/global_resource.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace tracktable {
+
+typedef TrajectoryPoint<PointLonLat> TrajectoryPointLonLat;
+typedef Trajectory<TrajectoryPointLonLat> TrajectoryLonLat;
+
+}
+
+typedef ::tracktable::TrajectoryPointLonLat point_type;
+typedef ::tracktable::TrajectoryLonLat trajectory_type;
+
+// ----------------------------------------------------------------------
+
+// Heap-backed resource that counts how many bytes are outstanding
+class CountingResource : public tracktable::memory_resource
+{
+public:
+  CountingResource() : BytesInUse(0), Allocations(0) { }
+
+  std::size_t BytesInUse;
+  std::size_t Allocations;
+
+protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      this->BytesInUse += bytes;
+      ++ this->Allocations;
+      return this->upstream()->allocate(bytes, alignment);
+    }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+      this->BytesInUse -= bytes;
+      this->upstream()->deallocate(p, bytes, alignment);
+    }
+
+  bool do_is_equal(tracktable::memory_resource const& other) const BOOST_NOEXCEPT override
+    {
+      return (this == &other);
+    }
+
+private:
+  tracktable::memory_resource* upstream() const
+    {
+      return boost::container::pmr::new_delete_resource();
+    }
+};
+
+// ----------------------------------------------------------------------
+
+trajectory_type make_trajectory(std::size_t num_points)
+{
+  trajectory_type path(false);
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    point_type point;
+    point.set_object_id("ANAME");
+    point.set_longitude(static_cast<double>(i));
+    point.set_latitude(10);
+    point.set_property("speed", static_cast<double>(i));
+    point.set_property("status", std::string("underway"));
+    path.push_back(point);
+    }
+  path.set_property("source", std::string("test"));
+  return path;
+}
+
+// ----------------------------------------------------------------------
+
+int test_scoped_allocation()
+{
+  int error_count = 0;
+  CountingResource counter;
+
+  if (tracktable::current_memory_resource() != boost::container::pmr::new_delete_resource())
+    {
+    std::cerr << "ERROR: Expected the heap to be the default resource\n";
+    ++error_count;
+    }
+
+  trajectory_type heap_copy;
+  {
+  tracktable::ScopedMemoryResource use_counter(&counter);
+  if (tracktable::current_memory_resource() != &counter)
+    {
+    std::cerr << "ERROR: ScopedMemoryResource did not install the resource\n";
+    ++error_count;
+    }
+
+  trajectory_type path(make_trajectory(10));
+  if (counter.Allocations == 0 || counter.BytesInUse == 0)
+    {
+    std::cerr << "ERROR: Trajectory built in scope did not use the resource\n";
+    ++error_count;
+    }
+
+  {
+  tracktable::ScopedMemoryResource use_heap(boost::container::pmr::new_delete_resource());
+  std::size_t bytes_before = counter.BytesInUse;
+  heap_copy = path;
+  trajectory_type second_copy(path);
+  if (counter.BytesInUse != bytes_before)
+    {
+    std::cerr << "ERROR: Copies made outside the scope used the scoped resource\n";
+    ++error_count;
+    }
+  if (second_copy != path || heap_copy != path)
+    {
+    std::cerr << "ERROR: Copies out of the resource are not equal to the original\n";
+    ++error_count;
+    }
+  }
+
+  if (tracktable::current_memory_resource() != &counter)
+    {
+    std::cerr << "ERROR: Nested scope did not restore the outer resource\n";
+    ++error_count;
+    }
+  }
+
+  if (counter.BytesInUse != 0)
+    {
+    std::cerr << "ERROR: " << counter.BytesInUse
+              << " bytes still allocated from the resource after its scope ended\n";
+    ++error_count;
+    }
+  if (tracktable::current_memory_resource() != boost::container::pmr::new_delete_resource())
+    {
+    std::cerr << "ERROR: Scope did not restore the heap\n";
+    ++error_count;
+    }
+  if (heap_copy.size() != 10 || heap_copy[3].real_property("speed") != 3)
+    {
+    std::cerr << "ERROR: Heap copy did not survive the end of the scope\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_arena_set()
+{
+  int error_count = 0;
+  tracktable::ArenaSet arenas(2, 1024);
+
+  if (arenas.size() != 2 || arenas.arena(0) == arenas.arena(1))
+    {
+    std::cerr << "ERROR: Expected two distinct arenas\n";
+    ++error_count;
+    }
+
+  for (int round = 0; round < 3; ++round)
+    {
+    std::vector<trajectory_type> batch;
+    {
+    tracktable::ScopedMemoryResource use_arena(arenas.arena(round % 2));
+    for (int i = 0; i < 20; ++i)
+      {
+      batch.push_back(make_trajectory(5));
+      }
+    }
+    for (std::size_t i = 0; i < batch.size(); ++i)
+      {
+      if (batch[i].size() != 5
+          || batch[i][4].string_property("status") != "underway"
+          || batch[i].string_property("source") != "test")
+        {
+        std::cerr << "ERROR: Arena-backed trajectory " << i
+                  << " in round " << round << " has the wrong contents\n";
+        ++error_count;
+        break;
+        }
+      }
+    batch.clear();
+    arenas.release();
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+void build_and_discard(std::size_t num_trajectories)
+{
+  std::vector<trajectory_type> batch;
+  batch.reserve(num_trajectories);
+  for (std::size_t i = 0; i < num_trajectories; ++i)
+    {
+    batch.push_back(make_trajectory(20));
+    }
+}
+
+void compare_heap_and_arena()
+{
+  const std::size_t num_trajectories = 20000;
+
+  {
+  std::cout << "Heap:  ";
+  boost::timer::auto_cpu_timer timer(std::cout, "%w seconds wall, %t seconds CPU\n");
+  build_and_discard(num_trajectories);
+  }
+
+  {
+  std::cout << "Arena: ";
+  boost::timer::auto_cpu_timer timer(std::cout, "%w seconds wall, %t seconds CPU\n");
+  tracktable::monotonic_arena arena;
+  tracktable::ScopedMemoryResource use_arena(&arena);
+  build_and_discard(num_trajectories);
+  }
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  error_count += test_scoped_allocation();
+  error_count += test_arena_set();
+  compare_heap_and_arena();
+
+  return error_count;
+}
@@ -32,7 +32,10 @@
 
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
 
+#include <boost/serialization/string.hpp>
 #include <boost/serialization/variant.hpp>
 
 #include <iostream>
@@ -126,7 +129,63 @@ test_property_variant_serialization()
 
 // ----------------------------------------------------------------------
 
+// What PropertyValue looked like before strings became SharedString
+typedef boost::variant<
+  tracktable::NullValue,
+  double,
+  std::string,
+  tracktable::Timestamp
+  > plain_string_variant;
 
+template<typename thing_type>
+std::string xml_archive(thing_type const& thing)
+{
+  std::ostringstream outbuf;
+  {
+  boost::archive::xml_oarchive archive_out(outbuf);
+  archive_out << boost::serialization::make_nvp("property", thing);
+  }
+  return outbuf.str();
+}
+
+int
+test_string_archive_layout()
+{
+  int error_count = 0;
+  tracktable::PropertyValueT shared_variant(tracktable::SharedString("this is a test"));
+  plain_string_variant plain_variant(std::string("this is a test"));
+
+  std::string shared_xml(xml_archive(shared_variant));
+  std::string plain_xml(xml_archive(plain_variant));
+  if (shared_xml != plain_xml)
+    {
+    std::cerr << "ERROR: String property archive changed layout.  Expected:\n"
+              << plain_xml << "\nGot:\n" << shared_xml << "\n";
+    ++error_count;
+    }
+
+  // Archives written with the old layout still load
+  std::istringstream inbuf(plain_xml);
+  boost::archive::xml_iarchive archive_in(inbuf);
+  tracktable::PropertyValueT restored;
+  archive_in >> boost::serialization::make_nvp("property", restored);
+  error_count += check_for_error("string from plain archive", shared_variant, restored);
+
+  // Code written for a string_type alternative still compiles
+  tracktable::PropertyValueT const real_variant(3.0);
+  if (boost::get<std::string>(restored) != "this is a test"
+      || boost::get<std::string>(&restored) == 0
+      || boost::get<std::string>(&real_variant) != 0
+      || boost::get<std::string>(tracktable::PropertyValueT(shared_variant)) != "this is a test")
+    {
+    std::cerr << "ERROR: boost::get<std::string> did not find the string property\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
 
 int
 main(int , char **)
@@ -134,6 +193,7 @@ main(int , char **)
   int num_errors = 0;
 
   num_errors += test_property_variant_serialization();
+  num_errors += test_string_archive_layout();
 
   return num_errors;
 }
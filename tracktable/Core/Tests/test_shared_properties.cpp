@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Check that string properties share storage, that a StringPool
+// interns them, and that hoisting constant point properties into a
+// shared block leaves every point reading the same values as before.
+
+#include <tracktable/Core/PointLonLat.h>
+#include <tracktable/Core/SharedString.h>
+#include <tracktable/Core/Trajectory.h>
+#include <tracktable/Core/TrajectoryPoint.h>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+namespace tracktable {
+
+typedef TrajectoryPoint<PointLonLat> TrajectoryPointLonLat;
+typedef Trajectory<TrajectoryPointLonLat> TrajectoryLonLat;
+
+}
+
+typedef ::tracktable::TrajectoryPointLonLat point_type;
+typedef ::tracktable::TrajectoryLonLat trajectory_type;
+
+// ----------------------------------------------------------------------
+
+int test_shared_strings()
+{
+  int error_count = 0;
+
+  tracktable::StringPool pool(2);
+  tracktable::SharedString a(pool.intern("underway"));
+  tracktable::SharedString b(pool.intern(std::string("underway")));
+  if (!a.shares_storage_with(b) || pool.size() != 1)
+    {
+    std::cerr << "ERROR: Interning the same text twice did not share storage\n";
+    ++error_count;
+    }
+
+  pool.intern("moored");
+  tracktable::SharedString c(pool.intern("anchored"));
+  tracktable::SharedString d(pool.intern("anchored"));
+  if (pool.size() != 2 || c.shares_storage_with(d) || c != d)
+    {
+    std::cerr << "ERROR: Full pool should hand out equal but unshared strings\n";
+    ++error_count;
+    }
+
+  point_type point;
+  point.set_property("status", a);
+  point.set_property("name", std::string("Alpha"));
+  point_type copy(point);
+  tracktable::SharedString const* original_status =
+    boost::get<tracktable::SharedString>(&point.__properties().find("status")->second);
+  tracktable::SharedString const* copied_status =
+    boost::get<tracktable::SharedString>(&copy.__properties().find("status")->second);
+  if (!original_status || !copied_status || !original_status->shares_storage_with(*copied_status))
+    {
+    std::cerr << "ERROR: Copying a point copied its string properties\n";
+    ++error_count;
+    }
+  if (copy.string_property("status") != "underway" || copy.string_property("name") != "Alpha")
+    {
+    std::cerr << "ERROR: String properties do not read back correctly\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+trajectory_type make_trajectory()
+{
+  trajectory_type path;
+  tracktable::StringPool pool;
+  for (int i = 0; i < 5; ++i)
+    {
+    point_type point;
+    point.set_object_id("ANAME");
+    point.set_longitude(i);
+    point.set_latitude(0);
+    point.set_timestamp(tracktable::time_from_string("2020-01-01 00:00:00") + tracktable::seconds(60 * i));
+    point.set_property("callsign", pool.intern("ABC123"));
+    point.set_property("type", pool.intern("B738"));
+    point.set_property("altitude", 1000.0 * i);
+    point.set_property("status", pool.intern(i < 3 ? "climbing" : "cruise"));
+    path.push_back(point);
+    }
+  // Same name as a trajectory property but a different value: stays put
+  path[0].set_property("source", std::string("radar"));
+  for (std::size_t i = 1; i < path.size(); ++i)
+    {
+    path[i].set_property("source", std::string("radar"));
+    }
+  path.set_property("source", std::string("merged"));
+  return path;
+}
+
+int test_hoisting()
+{
+  int error_count = 0;
+
+  trajectory_type original(make_trajectory());
+  trajectory_type path(original);
+
+  std::size_t num_hoisted = path.hoist_constant_properties();
+  if (num_hoisted != 2)
+    {
+    std::cerr << "ERROR: Expected to hoist 2 properties but hoisted " << num_hoisted << "\n";
+    ++error_count;
+    }
+
+  if (path.string_property("callsign") != "ABC123" || path.string_property("type") != "B738")
+    {
+    std::cerr << "ERROR: Hoisted properties were not copied to the trajectory\n";
+    ++error_count;
+    }
+  if (path.string_property("source") != "merged")
+    {
+    std::cerr << "ERROR: Hoisting overwrote an existing trajectory property\n";
+    ++error_count;
+    }
+
+  for (std::size_t i = 0; i < path.size(); ++i)
+    {
+    if (path[i].__properties().find("callsign") != path[i].__properties().end()
+        || !path[i].shared_properties()
+        || path[i].shared_properties() != path[0].shared_properties())
+      {
+      std::cerr << "ERROR: Point " << i << " still has its own copy of a hoisted property\n";
+      ++error_count;
+      }
+    bool ok = false;
+    if (path[i].string_property("callsign", &ok) != "ABC123" || !ok
+        || !path[i].has_property("type")
+        || path[i].string_property_with_default("type", "none") != "B738"
+        || path[i].string_property("status") != original[i].string_property("status")
+        || path[i].real_property("altitude") != original[i].real_property("altitude"))
+      {
+      std::cerr << "ERROR: Point " << i << " reads different values after hoisting\n";
+      ++error_count;
+      }
+    }
+
+  if (!std::equal(path.begin(), path.end(), original.begin()))
+    {
+    std::cerr << "ERROR: Hoisting changed the value of the trajectory's points\n";
+    ++error_count;
+    }
+
+  // A point's own value takes precedence over the shared block
+  path[2].set_property("type", std::string("A320"));
+  if (path[2].string_property("type") != "A320" || path[3].string_property("type") != "B738")
+    {
+    std::cerr << "ERROR: Setting a hoisted property on one point did not override it\n";
+    ++error_count;
+    }
+  path[2].set_property("type", std::string("B738"));
+
+  // Interpolated points keep the shared block
+  point_type halfway(tracktable::interpolate(path[0], path[1], 0.5));
+  if (halfway.shared_properties() != path[0].shared_properties()
+      || halfway.string_property("callsign") != "ABC123"
+      || halfway.real_property("altitude") != 500)
+    {
+    std::cerr << "ERROR: Interpolated point lost the shared properties\n";
+    ++error_count;
+    }
+
+  // Archives hold every property on every point
+  std::ostringstream outbuf;
+  {
+  boost::archive::text_oarchive archive(outbuf);
+  archive << path[4];
+  }
+  point_type restored;
+  {
+  std::istringstream inbuf(outbuf.str());
+  boost::archive::text_iarchive archive(inbuf);
+  archive >> restored;
+  }
+  if (restored.shared_properties() || restored != original[4]
+      || restored.__properties().size() != original[4].__properties().size())
+    {
+    std::cerr << "ERROR: Serialized point did not carry its shared properties\n";
+    ++error_count;
+    }
+
+  // Hoisting twice finds nothing new
+  if (path.hoist_constant_properties() != 0)
+    {
+    std::cerr << "ERROR: Second hoist should find nothing to do\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  error_count += test_shared_strings();
+  error_count += test_hoisting();
+
+  return error_count;
+}
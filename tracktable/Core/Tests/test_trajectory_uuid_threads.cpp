@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Construct trajectories from several threads at once, first with the
+// old mutex-guarded generator and then with the thread-local default.
+
+#include <tracktable/Core/PointLonLat.h>
+#include <tracktable/Core/Trajectory.h>
+#include <tracktable/Core/TrajectoryPoint.h>
+
+#include <iostream>
+#include <set>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace tracktable {
+
+typedef TrajectoryPoint<PointLonLat> TrajectoryPointLonLat;
+typedef Trajectory<TrajectoryPointLonLat> TrajectoryLonLat;
+
+}
+
+typedef ::tracktable::TrajectoryLonLat trajectory_type;
+
+// std::vector only moves elements on reallocation if moving cannot throw
+static_assert(std::is_nothrow_move_constructible<trajectory_type>::value,
+              "Trajectory move constructor must be noexcept");
+static_assert(std::is_nothrow_move_assignable<trajectory_type>::value
+              == std::is_nothrow_move_assignable<trajectory_type::point_vector_type>::value,
+              "Trajectory move assignment must be noexcept exactly when moving its points is");
+
+const std::size_t NUM_THREADS = 4;
+const std::size_t TRAJECTORIES_PER_THREAD = 50000;
+
+// ----------------------------------------------------------------------
+
+void build_trajectories(std::vector<tracktable::uuid_type>* uuids)
+{
+  uuids->reserve(TRAJECTORIES_PER_THREAD);
+  for (std::size_t i = 0; i < TRAJECTORIES_PER_THREAD; ++i)
+    {
+    trajectory_type path;
+    uuids->push_back(path.uuid());
+    }
+}
+
+// ----------------------------------------------------------------------
+
+void build_temporary_trajectories()
+{
+  for (std::size_t i = 0; i < TRAJECTORIES_PER_THREAD; ++i)
+    {
+    trajectory_type path;
+    path.push_back(tracktable::TrajectoryPointLonLat());
+    }
+}
+
+// ----------------------------------------------------------------------
+
+int construct_in_parallel(std::string const& label)
+{
+  int error_count = 0;
+  std::vector< std::vector<tracktable::uuid_type> > uuids(NUM_THREADS);
+  std::vector<std::thread> threads;
+
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    threads.push_back(std::thread(build_trajectories, &uuids[i]));
+    }
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    threads[i].join();
+    }
+
+  std::set<tracktable::uuid_type> unique_uuids;
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    for (std::size_t j = 0; j < uuids[i].size(); ++j)
+      {
+      if (uuids[i][j].is_nil())
+        {
+        std::cerr << "ERROR: " << label << ": Trajectory has a nil UUID\n";
+        ++error_count;
+        }
+      unique_uuids.insert(uuids[i][j]);
+      }
+    }
+
+  if (unique_uuids.size() != NUM_THREADS * TRAJECTORIES_PER_THREAD)
+    {
+    std::cerr << "ERROR: " << label << ": Expected "
+              << NUM_THREADS * TRAJECTORIES_PER_THREAD
+              << " distinct UUIDs but got " << unique_uuids.size() << "\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int construct_lazily()
+{
+  int error_count = 0;
+
+  tracktable::set_lazy_uuid_generation(true);
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    threads.push_back(std::thread(build_temporary_trajectories));
+    }
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    threads[i].join();
+    }
+
+  trajectory_type path1;
+  if (!path1.uuid_pending())
+    {
+    std::cerr << "ERROR: Expected UUID to be pending with lazy generation on\n";
+    ++error_count;
+    }
+
+  trajectory_type path2(path1);
+  if (!path1.uuid_pending() || !path2.uuid_pending())
+    {
+    std::cerr << "ERROR: Expected copy constructor to leave the lazy UUID pending\n";
+    ++error_count;
+    }
+  trajectory_type path2b;
+  path2b = path1;
+  if (!path1.uuid_pending() || !path2b.uuid_pending())
+    {
+    std::cerr << "ERROR: Expected copy assignment to leave the lazy UUID pending\n";
+    ++error_count;
+    }
+  if (path2.uuid().is_nil() || path1.uuid().is_nil())
+    {
+    std::cerr << "ERROR: Expected a pending UUID to be generated on first access\n";
+    ++error_count;
+    }
+  if (path2.uuid() != path1.uuid() || path2b.uuid() != path1.uuid())
+    {
+    std::cerr << "ERROR: Expected copies of a pending UUID to share it\n";
+    ++error_count;
+    }
+  if (path1.uuid_pending() || path2b.uuid_pending())
+    {
+    std::cerr << "ERROR: Expected generating a shared UUID to clear it for all copies\n";
+    ++error_count;
+    }
+
+  trajectory_type raced;
+  std::vector<trajectory_type> raced_copies(NUM_THREADS, raced);
+  std::vector<tracktable::uuid_type> raced_uuids(NUM_THREADS);
+  std::vector<std::thread> racers;
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    racers.push_back(std::thread([&raced_copies, &raced_uuids, i]() {
+      raced_uuids[i] = raced_copies[i].uuid();
+      }));
+    }
+  for (std::size_t i = 0; i < NUM_THREADS; ++i)
+    {
+    racers[i].join();
+    if (raced_uuids[i] != raced.uuid())
+      {
+      std::cerr << "ERROR: Expected copies asked from several threads to agree on the UUID\n";
+      ++error_count;
+      }
+    }
+
+  trajectory_type path2c(path1);
+  if (path2c.uuid_pending() || path2c.uuid() != path1.uuid())
+    {
+    std::cerr << "ERROR: Expected copy of a generated UUID to share it\n";
+    ++error_count;
+    }
+
+  trajectory_type path3;
+  tracktable::uuid_type explicit_uuid = tracktable::generate_automatic_uuid();
+  path3.set_uuid(explicit_uuid);
+  if (path3.uuid() != explicit_uuid)
+    {
+    std::cerr << "ERROR: Expected explicit UUID to replace the pending one\n";
+    ++error_count;
+    }
+
+  trajectory_type path4(false);
+  if (path4.uuid_pending() || !path4.uuid().is_nil())
+    {
+    std::cerr << "ERROR: Expected null UUID with automatic generation disabled\n";
+    ++error_count;
+    }
+
+  tracktable::set_lazy_uuid_generation(false);
+  error_count += construct_in_parallel("Lazy off after lazy on");
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+
+  tracktable::UUIDGenerator::pointer thread_local_generator(tracktable::automatic_uuid_generator());
+
+  tracktable::set_automatic_uuid_generator(
+    tracktable::BoostRandomUUIDGenerator<boost::random::mt19937>::create()
+    );
+  error_count += construct_in_parallel("Shared generator with mutex");
+
+  tracktable::set_automatic_uuid_generator(thread_local_generator);
+  error_count += construct_in_parallel("Thread-local generator");
+
+  error_count += construct_lazily();
+
+  return error_count;
+}
@@ -33,6 +33,7 @@
 #define __tracktable_Trajectory_h
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/MemoryResource.h>
 #include <tracktable/Core/PropertyMap.h>
 #include <tracktable/Core/Timestamp.h>
 #include <tracktable/Core/UUID.h>
@@ -54,16 +55,22 @@
 
 #include <tracktable/Core/GuardedBoostGeometryHeaders.h>
 #include <boost/geometry/geometries/register/linestring.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/variant.hpp>
 
+#include <atomic>
 #include <cassert>
+#include <mutex>
 #include <ostream>
 #include <vector>
 #include <typeinfo>
+#include <type_traits>
+#include <utility>
 #include <iostream>
 
 namespace tracktable {
@@ -80,6 +87,9 @@ namespace tracktable {
  *
  * We provide accessors so that you can treat a Trajectory as if it
  * were a std::vector.
+ *
+ * Points are stored in the memory resource that is current when the
+ * trajectory is created.  See tracktable/Core/MemoryResource.h.
  */
 
 template< class PointT >
@@ -94,7 +104,7 @@ public:
   // std::vector so that you can cleanly use it as such with the C++
   // STL.
   typedef PointT point_type;
-  typedef std::vector<PointT> point_vector_type;
+  typedef std::vector<PointT, ResourceAllocator<PointT> > point_vector_type;
   typedef typename point_vector_type::iterator iterator;
   typedef typename point_vector_type::const_iterator const_iterator;
   typedef typename point_vector_type::reverse_iterator reverse_iterator;
@@ -108,22 +118,41 @@ public:
   /** Instantiate an empty trajectory
    */
 
-  Trajectory(bool generate_uuid=true): UUID() {
+  Trajectory(bool generate_uuid=true): UUID(), LazyUUID() {
     if (generate_uuid)
-      this->set_uuid();
+      this->assign_automatic_uuid();
   }
 
   ~Trajectory() { }
 
   /// Create a trajectory a copy of another
+  //
+  // If the other trajectory has not generated its lazy UUID yet, the
+  // copy shares the pending UUID with it: whichever one is asked first
+  // generates the UUID for both.  Copying never writes to `other`, so
+  // several threads may copy the same trajectory at once.
 
 Trajectory(const Trajectory& other) :
     UUID(other.UUID),
+    LazyUUID(other.LazyUUID),
     Points(other.Points),
     Properties(other.Properties)
     {
     }
 
+  /// Move another trajectory into this one
+  //
+  // A pending lazy UUID stays pending since the other trajectory
+  // gives up its identity.
+
+Trajectory(Trajectory&& other) noexcept :
+    UUID(other.UUID),
+    LazyUUID(std::move(other.LazyUUID)),
+    Points(std::move(other.Points)),
+    Properties(std::move(other.Properties))
+    {
+    }
+
   /** Create a new trajectory with pre-specified length
    *
    * Create a new trajectory with n elements.  You may also supply a
@@ -136,10 +165,11 @@ Trajectory(const Trajectory& other) :
 
   Trajectory(size_type n, point_type initial_value=point_type(), bool generate_uuid=true)
     : UUID(),
+      LazyUUID(),
       Points(n, initial_value)
     {
       if (generate_uuid)
-        this->set_uuid();
+        this->assign_automatic_uuid();
     }
 
   /** Create a new trajectory from a range of points
@@ -153,20 +183,22 @@ Trajectory(const Trajectory& other) :
   template<class InputIterator>
   Trajectory(InputIterator first, InputIterator last, bool generate_uuid=true)
     : UUID(),
+      LazyUUID(),
       Points(first, last)
     {
       if (generate_uuid)
-        this->set_uuid();
+        this->assign_automatic_uuid();
       this->compute_current_features(0);
     }
 
   template<class InputIterator>
   Trajectory(InputIterator first, InputIterator last, const Trajectory& original)
      : UUID(),
+     LazyUUID(),
      Points(first, last),
      Properties(original.Properties)
      {
-       this->set_uuid();
+       this->assign_automatic_uuid();
        this->compute_current_features(0);
      }
 
@@ -174,11 +206,29 @@ Trajectory(const Trajectory& other) :
   Trajectory& operator=(const Trajectory& other)
     {
       this->UUID = other.UUID;
+      this->LazyUUID = other.LazyUUID;
       this->Points = other.Points;
       this->Properties = other.Properties;
       return *this;
     }
 
+  /// Move another trajectory into this one
+  //
+  // ResourceAllocator does not follow the points on move assignment,
+  // so moving between trajectories that use different memory
+  // resources copies the points and may throw.
+
+  Trajectory& operator=(Trajectory&& other)
+    noexcept(std::is_nothrow_move_assignable<point_vector_type>::value
+             && std::is_nothrow_move_assignable<PropertyMap>::value)
+    {
+      this->UUID = other.UUID;
+      this->LazyUUID = std::move(other.LazyUUID);
+      this->Points = std::move(other.Points);
+      this->Properties = std::move(other.Properties);
+      return *this;
+    }
+
     /// Make this trajectory a clone of another
   Trajectory& clone() const
   {
@@ -242,8 +292,25 @@ Trajectory(const Trajectory& other) :
   }
 
   /** Return the UUID (RFC 4122 or variant) of the trajectory.
+   *
+   * If the trajectory was created while lazy UUID generation was
+   * turned on (see `set_lazy_uuid_generation()`), the UUID is
+   * generated on the first call to this method.
+   *
+   * Copies made while the UUID is still pending share it with the
+   * original, so they all report the same UUID.  The first call may
+   * come from several threads at once.
    */
   const uuid_type& uuid() const {
+    if (this->LazyUUID)
+      {
+      PendingUUID& pending = *this->LazyUUID;
+      std::call_once(pending.Once, [&pending]() {
+        pending.Value = generate_automatic_uuid();
+        pending.Generated = true;
+        });
+      return pending.Value;
+      }
     return this->UUID;
   }
 
@@ -251,14 +318,25 @@ Trajectory(const Trajectory& other) :
    */
   void set_uuid(const uuid_type& new_uuid) {
     this->UUID = new_uuid;
+    this->LazyUUID.reset();
   }
 
   /** Set the UUID of the trajectory to a random UUID using the systemwide generator
    */
   void set_uuid() {
-      if (automatic_uuid_generator()) {
-        this->UUID = automatic_uuid_generator()->generate_uuid();
+      uuid_type new_uuid = generate_automatic_uuid();
+      if (!new_uuid.is_nil()) {
+        this->UUID = new_uuid;
       }
+      this->LazyUUID.reset();
+  }
+
+  /** Check whether the UUID is still waiting to be generated.
+   *
+   * \return True if the trajectory has a lazy UUID that nobody has asked for yet
+   */
+  bool uuid_pending() const {
+    return this->LazyUUID && !this->LazyUUID->Generated;
   }
 
   /** Return the ID of the moving object.
@@ -396,6 +474,108 @@ Trajectory(const Trajectory& other) :
    */
   void __set_properties(PropertyMap const& props) { this->Properties = props; }
 
+  /** @internal
+   *
+   * Same interface as TrajectoryPoint::__all_properties() for the
+   * writers.  Trajectories have no shared properties.
+   */
+  PropertyMap const& __all_properties(PropertyMap& /*scratch*/) const { return this->Properties; }
+
+  /** Keep one copy of the point properties that never change
+   *
+   * Find the point properties that are present with the same value
+   * on every point (callsign, aircraft type and so on), copy them
+   * into this trajectory's properties and replace the per-point
+   * copies with one block that all the points share.  Reading those
+   * properties from a point still works exactly as before.
+   *
+   * Null values are never hoisted, and neither is a property that the
+   * trajectory already has with a different value.  Trajectories with
+   * fewer than two points are left alone.
+   *
+   * Point writers write shared properties with every point as usual.
+   *
+   * @return Number of properties hoisted
+   */
+  std::size_t hoist_constant_properties()
+    {
+      if (this->Points.size() < 2)
+        {
+        return 0;
+        }
+
+      // Points that already share different blocks get their own
+      // copies back so that there is only one block to extend.
+      boost::shared_ptr<const PropertyMap> existing(this->Points.front().shared_properties());
+      for (iterator point = this->Points.begin(); point != this->Points.end(); ++point)
+        {
+        if (point->shared_properties() != existing)
+          {
+          for (iterator p = this->Points.begin(); p != this->Points.end(); ++p)
+            {
+            p->unshare_properties();
+            }
+          existing.reset();
+          break;
+          }
+        }
+
+      PropertyMap constants(this->Points.front().__properties());
+      for (PropertyMap::iterator candidate = constants.begin(); candidate != constants.end(); )
+        {
+        bool keep = !is_property_null(candidate->second);
+        if (keep)
+          {
+          bool already_present = false;
+          PropertyValueT trajectory_value(
+            ::tracktable::property(this->Properties, candidate->first, &already_present));
+          keep = (!already_present || trajectory_value == candidate->second);
+          }
+        for (const_iterator point = this->Points.begin() + 1;
+             keep && point != this->Points.end();
+             ++point)
+          {
+          PropertyMap::const_iterator here(point->__properties().find(candidate->first));
+          keep = (here != point->__properties().end() && here->second == candidate->second);
+          }
+
+        if (keep)
+          {
+          ++candidate;
+          }
+        else
+          {
+          candidate = constants.erase(candidate);
+          }
+        }
+
+      if (constants.empty())
+        {
+        return 0;
+        }
+
+      boost::shared_ptr<PropertyMap> shared(boost::make_shared<PropertyMap>());
+      if (existing)
+        {
+        *shared = *existing;
+        }
+      for (PropertyMap::const_iterator iter = constants.begin(); iter != constants.end(); ++iter)
+        {
+        (*shared)[iter->first] = iter->second;
+        this->Properties[iter->first] = iter->second;
+        }
+      boost::shared_ptr<const PropertyMap> frozen(shared);
+      for (iterator point = this->Points.begin(); point != this->Points.end(); ++point)
+        {
+        for (PropertyMap::const_iterator iter = constants.begin(); iter != constants.end(); ++iter)
+          {
+          point->__non_const_properties().erase(iter->first);
+          }
+        point->set_shared_properties(frozen);
+        }
+      return constants.size();
+    }
+
   //@}
   // ************************************************************
   // *** END doxygen group for property related methods
@@ -808,9 +988,22 @@ Trajectory(const Trajectory& other) :
   // ************************************************************
 
 protected:
+  /// UUID generated on first access and shared by all copies made before then
+  struct PendingUUID
+  {
+    PendingUUID() : Generated(false), Value() { }
+
+    std::once_flag Once;
+    std::atomic<bool> Generated;
+    uuid_type Value;
+  };
+
   /// Internal storage for the trajectory UUID
   uuid_type UUID;
 
+  /// Lazy UUID shared with copies; null when `UUID` holds the UUID
+  boost::shared_ptr<PendingUUID> LazyUUID;
+
   /// Internal storage for the points in the trajectory
   point_vector_type Points;
 
@@ -818,6 +1011,19 @@ protected:
 
 
 private:
+  /// Generate a UUID now or mark it pending, depending on the global setting
+  void assign_automatic_uuid()
+  {
+    if (lazy_uuid_generation())
+      {
+      this->LazyUUID = boost::make_shared<PendingUUID>();
+      }
+    else
+      {
+      this->set_uuid();
+      }
+  }
+
   template<class Archive>
   void serialize(Archive& ar, const unsigned int /*version*/)
   {
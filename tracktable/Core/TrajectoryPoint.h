@@ -33,6 +33,7 @@
 
 #include <tracktable/Core/TracktableCommon.h>
 #include <tracktable/Core/Timestamp.h>
+#include <tracktable/Core/DeferredProperties.h>
 #include <tracktable/Core/PropertyMap.h>
 #include <tracktable/Core/PointBase.h>
 
@@ -53,12 +54,18 @@
 #include <tracktable/Core/detail/algorithm_signatures/SphericalCoordinateAccess.h>
 #include <tracktable/Core/detail/algorithm_signatures/TurnAngle.h>
 
+#include <atomic>
 #include <ostream>
 #include <cassert>
+#include <memory>
+#include <mutex>
 
 #include <boost/mpl/bool.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/geometry/strategies/strategies.hpp>
 #include <boost/serialization/map.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
 #include <boost/serialization/variant.hpp>
@@ -88,6 +95,19 @@ namespace tracktable {
  *       functions to retrieve it with no casting necessary. Take a
  *       look at tracktable/Core/Tests/test_trajectory_point_lonlat.cpp (XXX CHECK
  *       THIS) for a demonstration.
+ *
+ * A point can also share a read-only block of properties with other
+ * points.  Trajectory::hoist_constant_properties() uses this to keep
+ * one copy of the properties that are the same on every point.  The
+ * property accessors look in the point's own properties first and
+ * then in the shared block, so callers cannot tell the difference.
+ * `__properties()` returns only the point's own properties.
+ *
+ * Readers in lazy-property mode give a point the text of some of its
+ * properties with set_deferred_property().  The first time anything
+ * reads a property, all of that text is converted and stored like any
+ * other property.  The conversion is guarded by a lock held by the
+ * point, so const access stays safe from several threads at once.
  */
 
 #if defined(WIN32)
@@ -124,9 +144,10 @@ public:
     : Superclass(other)
     ,CurrentLength(other.CurrentLength)
     ,ObjectId(other.ObjectId)
-    ,Properties(other.Properties)
+    ,SharedProperties(other.SharedProperties)
     ,UpdateTime(other.UpdateTime)
     {
+      other.copy_own_properties(this->Properties, this->Deferred);
     }
 
   /** Instantiate a TrajectoryPoint with a base point
@@ -156,7 +177,11 @@ public:
       this->Superclass::operator=(other);
       this->CurrentLength = other.CurrentLength;
       this->ObjectId = other.ObjectId;
-      this->Properties = other.Properties;
+      if (this != &other)
+        {
+        other.copy_own_properties(this->Properties, this->Deferred);
+        }
+      this->SharedProperties = other.SharedProperties;
       this->UpdateTime = other.UpdateTime;
       return *this;
     }
@@ -177,7 +202,7 @@ public:
       return ( this->Superclass::operator==(other)
                // && this->CurrentLength == other.CurrentLength
                && this->ObjectId == other.ObjectId
-               && this->Properties == other.Properties
+               && this->same_properties_as(other)
                && this->UpdateTime == other.UpdateTime
         );
     }
@@ -221,9 +246,60 @@ public:
    */
   void set_property(std::string const& name, PropertyValueT const& value)
     {
+      if (this->Deferred && !this->Deferred->Resolved)
+        {
+        this->Deferred->Text.erase(name);
+        }
       ::tracktable::set_property(this->Properties, name, value);
     }
 
+  /** Set a named property from text that will be converted when it is read
+   *
+   * The text is converted to `type` the first time anything reads a
+   * property of this point.  If it does not convert, the property is
+   * absent from then on.
+   *
+   * @param [in] name  Name of property
+   * @param [in] text  Value as it appeared in the input
+   * @param [in] type  Type to convert the text to
+   */
+  void set_deferred_property(std::string const& name, std::string const& text, PropertyUnderlyingType type)
+    {
+      this->Properties.erase(name);
+      if (!this->Deferred || this->Deferred->Resolved)
+        {
+        this->Deferred.reset(new PendingProperties);
+        }
+      this->Deferred->Text.add(name, text, type);
+    }
+
+  /** Check whether any properties are still waiting to be converted
+   *
+   * @return `True` if set_deferred_property() left text that has not been read yet
+   */
+  bool has_deferred_properties() const
+    {
+      return (this->Deferred && !this->Deferred->Resolved);
+    }
+
+  /** Convert every deferred property now
+   *
+   * Any property read does this first.  Several threads may call it
+   * on the same point at once; only one of them converts the text.
+   */
+  void resolve_deferred_properties() const
+    {
+      if (this->Deferred && !this->Deferred->Resolved)
+        {
+        std::lock_guard<std::mutex> guard(this->Deferred->Lock);
+        if (!this->Deferred->Resolved)
+          {
+          this->Deferred->Text.resolve_all(this->Properties);
+          this->Deferred->Resolved = true;
+          }
+        }
+    }
+
   /** Retrieve a named property with checking
    *
    * @param [in] name Name of property to retrieve
@@ -232,7 +308,7 @@ public:
    */
   PropertyValueT property(std::string const& name, bool *ok=0) const
     {
-      return ::tracktable::property(this->Properties, name, ok);
+      return ::tracktable::property(this->properties_containing(name), name, ok);
     }
 
   /** Retrieve a named property or a default value
@@ -243,7 +319,7 @@ public:
    */
   PropertyValueT property(std::string const& name, PropertyValueT const& default_value) const
     {
-      return ::tracktable::property_with_default(this->Properties, name, default_value);
+      return ::tracktable::property_with_default(this->properties_containing(name), name, default_value);
     }
 
   /** Retrieve a named property without safety checking
@@ -257,7 +333,7 @@ public:
   PropertyValueT property_without_checking(std::string const& name) const
     {
       bool ok;
-      return ::tracktable::property(this->Properties, name, &ok);
+      return ::tracktable::property(this->properties_containing(name), name, &ok);
     }
 
   /** Safely retrieve a named property with a string value
@@ -268,7 +344,7 @@ public:
    */
   std::string string_property(std::string const& name, bool *ok=0) const
     {
-      return ::tracktable::string_property(this->Properties, name, ok);
+      return ::tracktable::string_property(this->properties_containing(name), name, ok);
     }
 
   /** Safely retrieve a named property with a floating-point value
@@ -279,7 +355,7 @@ public:
    */
   double real_property(std::string const& name, bool *ok=0) const
     {
-      return ::tracktable::real_property(this->Properties, name, ok);
+      return ::tracktable::real_property(this->properties_containing(name), name, ok);
     }
 
   /** Safely retrieve a named property with a timestamp value
@@ -290,7 +366,7 @@ public:
    */
   Timestamp timestamp_property(std::string const& name, bool *ok=0) const
     {
-      return ::tracktable::timestamp_property(this->Properties, name, ok);
+      return ::tracktable::timestamp_property(this->properties_containing(name), name, ok);
     }
 
   /** Safely retrieve a named property with a string value
@@ -301,7 +377,7 @@ public:
    */
   std::string string_property_with_default(std::string const& name, std::string const& default_value) const
     {
-      return ::tracktable::string_property_with_default(this->Properties, name, default_value);
+      return ::tracktable::string_property_with_default(this->properties_containing(name), name, default_value);
     }
 
   /** Safely retrieve a named property with a floating-point value
@@ -312,7 +388,7 @@ public:
    */
   double real_property_with_default(std::string const& name, double default_value) const
     {
-      return ::tracktable::real_property_with_default(this->Properties, name, default_value);
+      return ::tracktable::real_property_with_default(this->properties_containing(name), name, default_value);
     }
 
 
@@ -324,7 +400,7 @@ public:
    */
   Timestamp timestamp_property_with_default(std::string const& name, Timestamp const& default_value) const
     {
-      return ::tracktable::timestamp_property_with_default(this->Properties, name, default_value);
+      return ::tracktable::timestamp_property_with_default(this->properties_containing(name), name, default_value);
     }
 
   /** Check whether a property is present
@@ -334,7 +410,49 @@ public:
    */
   bool has_property(std::string const& name) const
     {
-      return ::tracktable::has_property(this->Properties, name);
+      this->resolve_deferred_properties();
+      return (::tracktable::has_property(this->Properties, name)
+              || (this->SharedProperties
+                  && ::tracktable::has_property(*this->SharedProperties, name)));
+    }
+
+  /** Get the block of properties this point shares with others
+   *
+   * @return Shared properties, or a null pointer if there are none
+   */
+  boost::shared_ptr<const PropertyMap> shared_properties() const
+    {
+      return this->SharedProperties;
+    }
+
+  /** Share a block of read-only properties with other points
+   *
+   * Properties set on the point itself take precedence over the
+   * shared block.
+   *
+   * @param [in] shared Properties to share, or a null pointer for none
+   */
+  void set_shared_properties(boost::shared_ptr<const PropertyMap> const& shared)
+    {
+      this->SharedProperties = shared;
+    }
+
+  /** Copy any shared properties into this point's own property map
+   *
+   * Afterward the point no longer shares properties with anything.
+   */
+  void unshare_properties()
+    {
+      if (this->SharedProperties)
+        {
+        for (PropertyMap::const_iterator iter = this->SharedProperties->begin();
+             iter != this->SharedProperties->end();
+             ++iter)
+          {
+          this->Properties.insert(*iter);
+          }
+        this->SharedProperties.reset();
+        }
     }
 
   /** Convert point to a human-readable string form
@@ -351,7 +469,8 @@ public:
       outbuf << this->timestamp() << ": ";
       outbuf << this->Superclass::to_string();
       outbuf << " ";
-      outbuf << property_map_to_string(this->Properties);
+      PropertyMap merged;
+      outbuf << property_map_to_string(this->__all_properties(merged));
       outbuf << "]";
       return outbuf.str();
     }
@@ -451,21 +570,56 @@ public:
    * This method is for use by the Python wrappers that can provide
    * their own access to the non-const property map.
    */
-  PropertyMap& __non_const_properties() { return this->Properties; }
+  PropertyMap& __non_const_properties()
+    {
+      this->resolve_deferred_properties();
+      return this->Properties;
+    }
 
   /** @internal
    *
    * This method is for use by the Python wrappers that can provide
    * their own access to the property map.
    */
-  PropertyMap const& __properties() const { return this->Properties; }
+  PropertyMap const& __properties() const
+    {
+      this->resolve_deferred_properties();
+      return this->Properties;
+    }
 
   /** @internal
    *
    * This method is for use by the Python wrappers that can provide
    * their own access to the property map.
    */
-  void __set_properties(PropertyMap const& props) { this->Properties = props; }
+  void __set_properties(PropertyMap const& props)
+    {
+      this->Deferred.reset();
+      this->Properties = props;
+    }
+
+  /** @internal
+   *
+   * This method is for use by the writers.  It returns this point's
+   * own and shared properties together, using `scratch` only if the
+   * point has shared properties.
+   */
+  PropertyMap const& __all_properties(PropertyMap& scratch) const
+    {
+      this->resolve_deferred_properties();
+      if (!this->SharedProperties)
+        {
+        return this->Properties;
+        }
+      scratch = *this->SharedProperties;
+      for (PropertyMap::const_iterator iter = this->Properties.begin();
+           iter != this->Properties.end();
+           ++iter)
+        {
+        scratch[iter->first] = iter->second;
+        }
+      return scratch;
+    }
 
   friend std::ostream& operator<<(std::ostream& out, TrajectoryPoint const& point)
     {
@@ -482,31 +636,108 @@ protected:
   double CurrentTimeFraction;
   /// Storage for a point's object ID
   std::string ObjectId;
-  /// Storage for a point's named properties
-  PropertyMap Properties;
+  /// Text waiting to be converted and the lock that guards converting it
+  struct PendingProperties
+  {
+    PendingProperties() : Resolved(false) { }
+
+    std::mutex Lock;
+    std::atomic<bool> Resolved;
+    DeferredProperties Text;
+  };
+
+  /// Storage for a point's named properties (const methods write it only under Deferred->Lock)
+  mutable PropertyMap Properties;
+  /// Read-only properties shared with other points (may be null)
+  boost::shared_ptr<const PropertyMap> SharedProperties;
+  /// Property text set with set_deferred_property() (null if there is none)
+  std::unique_ptr<PendingProperties> Deferred;
   /// Storage for a point's timestamp
   Timestamp UpdateTime;
 
 private:
+  /// Map that holds `name`: the point's own properties unless only the shared block has it
+  PropertyMap const& properties_containing(std::string const& name) const
+    {
+      this->resolve_deferred_properties();
+      if (this->SharedProperties
+          && !::tracktable::has_property(this->Properties, name)
+          && ::tracktable::has_property(*this->SharedProperties, name))
+        {
+        return *this->SharedProperties;
+        }
+      return this->Properties;
+    }
+
+  /// Copy own properties and unconverted text without racing a conversion
+  void copy_own_properties(PropertyMap& properties,
+                           std::unique_ptr<PendingProperties>& deferred) const
+    {
+      if (!this->Deferred)
+        {
+        properties = this->Properties;
+        deferred.reset();
+        return;
+        }
+      std::lock_guard<std::mutex> guard(this->Deferred->Lock);
+      properties = this->Properties;
+      if (this->Deferred->Resolved)
+        {
+        deferred.reset();
+        }
+      else
+        {
+        deferred.reset(new PendingProperties);
+        deferred->Text = this->Deferred->Text;
+        }
+    }
+
+  /// Compare own and shared properties together
+  bool same_properties_as(TrajectoryPoint const& other) const
+    {
+      this->resolve_deferred_properties();
+      other.resolve_deferred_properties();
+      if (this->SharedProperties == other.SharedProperties)
+        {
+        return (this->Properties == other.Properties);
+        }
+      PropertyMap mine, theirs;
+      return (this->__all_properties(mine) == other.__all_properties(theirs));
+    }
+
   /** Serialize the points and properties to an archive
+   *
+   * Shared properties are written as if they belonged to the point,
+   * so archives look the same whether or not a point shares any.
    *
    * @param [in] ar Archive to serialize to
    * @param [in] version Version of the archive
    */
   template<typename archive_t>
-  void serialize(archive_t& archive, const unsigned int /*version*/)
+  void save(archive_t& archive, const unsigned int /*version*/) const
+  {
+    archive & BOOST_SERIALIZATION_BASE_OBJECT_NVP(Superclass);
+    archive & BOOST_SERIALIZATION_NVP(CurrentLength);
+    archive & BOOST_SERIALIZATION_NVP(ObjectId);
+    archive & BOOST_SERIALIZATION_NVP(UpdateTime);
+    PropertyMap merged;
+    archive & boost::serialization::make_nvp("Properties", this->__all_properties(merged));
+  }
+
+  template<typename archive_t>
+  void load(archive_t& archive, const unsigned int /*version*/)
   {
-/*
-    archive & boost::serialization::make_nvp("Superclass",
-                                             static_cast<Superclass*>(*this));
-*/
     archive & BOOST_SERIALIZATION_BASE_OBJECT_NVP(Superclass);
     archive & BOOST_SERIALIZATION_NVP(CurrentLength);
     archive & BOOST_SERIALIZATION_NVP(ObjectId);
     archive & BOOST_SERIALIZATION_NVP(UpdateTime);
     archive & BOOST_SERIALIZATION_NVP(Properties);
+    this->SharedProperties.reset();
+    this->Deferred.reset();
   }
 
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
 };
 
 } // namespace tracktable
@@ -569,9 +800,21 @@ struct interpolate< TrajectoryPoint<BasePointT> >
         interpolate<std::string>::apply(left.object_id(), right.object_id(), t)
         );
 
-      result.__set_properties(
-        interpolate<PropertyMap>::apply(left.__properties(), right.__properties(), t)
-        );
+      if (left.shared_properties() == right.shared_properties())
+        {
+        result.__set_properties(
+          interpolate<PropertyMap>::apply(left.__properties(), right.__properties(), t)
+          );
+        result.set_shared_properties(left.shared_properties());
+        }
+      else
+        {
+        PropertyMap left_scratch, right_scratch;
+        result.__set_properties(
+          interpolate<PropertyMap>::apply(left.__all_properties(left_scratch),
+                                          right.__all_properties(right_scratch), t)
+          );
+        }
       return result;
     }
 };
@@ -604,9 +847,21 @@ struct extrapolate< TrajectoryPoint<BasePointT> >
             interpolate<std::string>::apply(left.object_id(), right.object_id(), t)
         );
 
-        result.__set_properties(
-            extrapolate<PropertyMap>::apply(left.__properties(), right.__properties(), t)
-        );
+        if (left.shared_properties() == right.shared_properties())
+        {
+            result.__set_properties(
+                extrapolate<PropertyMap>::apply(left.__properties(), right.__properties(), t)
+            );
+            result.set_shared_properties(left.shared_properties());
+        }
+        else
+        {
+            PropertyMap left_scratch, right_scratch;
+            result.__set_properties(
+                extrapolate<PropertyMap>::apply(left.__all_properties(left_scratch),
+                                                right.__all_properties(right_scratch), t)
+            );
+        }
         return result;
     }
 };
@@ -30,10 +30,21 @@
 
 #include <tracktable/Core/UUID.h>
 
+#include <atomic>
+
 namespace tracktable
 {
 
-  TRACKTABLE_CORE_EXPORT UUIDGenerator::pointer AutomaticUUIDGenerator ( BoostRandomUUIDGenerator<boost::random::mt19937>::create() );
+  TRACKTABLE_CORE_EXPORT UUIDGenerator::pointer AutomaticUUIDGenerator ( ThreadLocalUUIDGenerator::create() );
+
+  static std::atomic<bool> LazyUUIDGeneration(false);
+
+  uuid_type ThreadLocalUUIDGenerator::generate_uuid()
+  {
+      // Each thread seeds its own generator on first use.
+      static thread_local random_generator_type generator;
+      return generator();
+  }
 
   UUIDGenerator::pointer automatic_uuid_generator()
   {
@@ -45,4 +56,23 @@ namespace tracktable
       AutomaticUUIDGenerator = new_automatic_generator;
   }
 
+  uuid_type generate_automatic_uuid()
+  {
+      if (AutomaticUUIDGenerator)
+      {
+        return AutomaticUUIDGenerator->generate_uuid();
+      }
+      return uuid_type();
+  }
+
+  void set_lazy_uuid_generation(bool lazy)
+  {
+      LazyUUIDGeneration.store(lazy, std::memory_order_relaxed);
+  }
+
+  bool lazy_uuid_generation()
+  {
+      return LazyUUIDGeneration.load(std::memory_order_relaxed);
+  }
+
 } // namespace tracktable
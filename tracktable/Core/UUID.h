@@ -284,6 +284,53 @@ private:
 
 };
 
+/** Generates random uuids from a per-thread Boost random generator
+ *
+ * Every thread that calls `generate_uuid()` gets its own mt19937-based
+ * generator, seeded independently the first time that thread asks for
+ * a uuid.  Since no state is shared between threads there is no mutex
+ * to take, which keeps trajectory construction from serializing on the
+ * global generator when many threads are at work.
+ *
+ * This is the default automatic uuid generator.
+ */
+class TRACKTABLE_CORE_EXPORT ThreadLocalUUIDGenerator : public UUIDGenerator
+{
+private:
+  /** Instantiate a thread-local uuid generator
+   * Use ThreadLocalUUIDGenerator::create()
+   */
+  ThreadLocalUUIDGenerator() { }
+
+public:
+  typedef boost::uuids::basic_random_generator<boost::random::mt19937> random_generator_type;
+
+  /** Static method to create an instance
+   *
+   * Example setting the thread-local generator as the default:
+   *
+   * @code
+   *
+   * ::tracktable::set_automatic_uuid_generator(::tracktable::ThreadLocalUUIDGenerator::create());
+   *
+   * @endcode
+   *
+   * @return Pointer to the new thread-local UUID generator
+   */
+  static UUIDGenerator::pointer create() {
+    return UUIDGenerator::pointer(new ThreadLocalUUIDGenerator());
+  }
+
+  /// Destructor for the thread-local UUID generator
+  virtual ~ThreadLocalUUIDGenerator() { }
+
+  /** Generate a UUID using the calling thread's generator
+   *
+   * @return The generated UUID
+   */
+  uuid_type generate_uuid();
+};
+
 /** Get the current global automatic uuid generator.
  *
  * A global automatic uuid generator is used to avoid the cost of continuously instantiating
@@ -299,14 +346,44 @@ TRACKTABLE_CORE_EXPORT UUIDGenerator::pointer automatic_uuid_generator();
  * Allows the global uuid generator to be changed from the default generator
  * to any generator implementing the `generate()` method of `UUIDGenerator`.
  *
- * The default generator is a boost random uuid generator using mt19937 for
- * random number generation.
+ * The default generator is a `ThreadLocalUUIDGenerator`, which keeps one
+ * boost random uuid generator using mt19937 per thread.
  *
  * The `BoostRandomUUIDGenerator` template can be used to quickly create
  * generators employing other random number generation approaches.
  */
 TRACKTABLE_CORE_EXPORT void set_automatic_uuid_generator ( UUIDGenerator::pointer new_random_generator );
 
+/** Generate a uuid with the global automatic uuid generator
+ *
+ * This is equivalent to `automatic_uuid_generator()->generate_uuid()`
+ * but does not copy the generator's shared pointer, so concurrent
+ * callers do not contend on its reference count.
+ *
+ * @return A new uuid, or the nil uuid if there is no automatic generator
+ */
+TRACKTABLE_CORE_EXPORT uuid_type generate_automatic_uuid();
+
+/** Enable or disable lazy uuid assignment for new trajectories
+ *
+ * When lazy assignment is on, trajectories that are constructed with
+ * automatic uuid generation enabled do not call the generator right
+ * away.  Instead the uuid is created the first time someone asks for
+ * it through `Trajectory::uuid()`.  Temporary trajectories that are
+ * never asked for their uuid then cost nothing.
+ *
+ * Lazy assignment is off by default.
+ *
+ * @param[in] lazy Whether or not to defer uuid generation
+ */
+TRACKTABLE_CORE_EXPORT void set_lazy_uuid_generation(bool lazy);
+
+/** Check whether lazy uuid assignment is on
+ *
+ * @return True if new trajectories defer uuid generation until first use
+ */
+TRACKTABLE_CORE_EXPORT bool lazy_uuid_generation();
+
 } // namespace tracktable
 
 #endif // __tracktable_UUID_h
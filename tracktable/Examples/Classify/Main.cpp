@@ -32,6 +32,7 @@
 #include "Mapping.h"
 #include "TrackFilter.h"
 
+#include <tracktable/Analysis/TrajectoryFilterPipeline.h>
 #include <tracktable/CommandLineFactories/AssemblerFromCommandLine.h>
 #include <tracktable/CommandLineFactories/PointReaderFromCommandLine.h>
 #include <tracktable/Core/Geometry.h>
@@ -47,7 +48,6 @@ using PointT = typename TrajectoryT::point_type;
 using PointReaderT = tracktable::PointReader<PointT>;
 using PointReaderIteratorT = typename PointReaderT::iterator;
 using AssemblerT = tracktable::AssembleTrajectories<TrajectoryT, PointReaderIteratorT>;
-constexpr auto length = tracktable::length<TrajectoryT>;
 
 using tracktable::kml;
 
@@ -64,7 +64,7 @@ The classify example demonstrates:
       - hull-aspect ratio
       - straightness
       - number of turn arounds
-    - A few different methods of applying these filters are demonstrated int he code
+    - Evaluating all of the requested filters in one parallel pass
     - Writing trajectories as KML
 
 Typical use:
@@ -103,9 +103,10 @@ int main(int _argc, char* _argv[]) {
       "maximum curvature of trajectory")
     ;
     // clang-format on
-    /** We can use the Trackfilter class to help us with the repetitive task of filtering
-     *   We provide the TrackFilter with a lambda that corresponds to the 'ShouldKeep'
-     *   scenario the filter. */
+    /** The MinMaxTrackFilter class adds --min-X/--max-X command line options for us.
+     *   It can also filter a vector of trajectories on its own using the measurement
+     *   we give it, but below we only use it for its options and bounds and let a
+     *   single TrajectoryFilterPipeline do the filtering. */
     MinMaxTrackFilter<double> hullGyrationFilter("hull-gyration-ratio", [](const TrajectoryT& _t) {
         return tracktable::convex_hull_area(_t) / tracktable::radius_of_gyration(_t);
     });
@@ -203,100 +204,70 @@ int main(int _argc, char* _argv[]) {
         std::cerr << std::left << "\nStarting with " << trajectories.size() << " trajectories" << std::endl;
     }
 
+    // All of the requested filters are gathered into one pipeline and
+    // evaluated in a single pass.  Each trajectory is examined once,
+    // quantities such as headings and segment lengths are computed once
+    // and shared by every filter that needs them, and a trajectory is
+    // dropped as soon as one filter rejects it.  Trajectories are
+    // processed in parallel.
+    using PipelineT = tracktable::TrajectoryFilterPipeline<TrajectoryT>;
+    using FeaturesT = PipelineT::feature_cache_type;
+    PipelineT pipeline;
+
     // Filter tracks based on length
-    // This is the typical method, fairly compact and reasonably efficient
     // we can check if an option was used by checking its 'count' in the variable map
     if (vm->count("min-length") != 0 || vm->count("max-length") != 0) {
-        std::cerr << "Filtering based on length" << std::endl;
-        boost::timer::auto_cpu_timer t(std::cerr);
         auto lower = vm->count("min-length") != 0 ? (*vm)["min-length"].as<double>() : 0.0;
         auto upper = vm->count("max-length") != 0 ? (*vm)["max-length"].as<double>()
                                                   : std::numeric_limits<double>::max();
-        // We use remove_if to move all trajectories where the lambda returns true to the end
-        // remove_if returns the end of the list of kept items.
-        // we then erase everything from that point to the 'end()'
-        trajectories.erase(std::remove_if(trajectories.begin(), trajectories.end(),
-                                          [&](const TrajectoryT& _t) {
-                                              auto l = length(_t);
-                                              return (upper < l) || (l < lower);
-                                          }),
-                           trajectories.end());
-        std::cerr << trajectories.size() << " trajectories after filtering for length" << std::endl;
+        pipeline.add_range_filter("length", tracktable::filter_metrics::length<FeaturesT>, lower, upper);
     }
 
     // Filter tracks based on curvature
     // This can be used to looks for loops.
-    // This method is identical to that above but the steps are seperated out for demonstration
     if (vm->count("min-curvature") != 0 || vm->count("max-curvature") != 0) {
-        std::cerr << "Filtering based on curvature" << std::endl;
-        boost::timer::auto_cpu_timer t(std::cerr);
         auto lower = vm->count("min-curvature") != 0 ? (*vm)["min-curvature"].as<double>() : 0.0;
         auto upper = vm->count("max-curvature") != 0 ? (*vm)["max-curvature"].as<double>()
                                                      : std::numeric_limits<double>::max();
-        // Create and save a lambda to use as filter predicate
-        auto filterFunc = [&](const TrajectoryT& _t) {
-            auto c = std::abs(TotalCurvature(_t));
-            return (upper < c) || (c < lower);
-        };
-        // we save the result of remove if to use in the erase
-        auto lastGood = std::remove_if(trajectories.begin(), trajectories.end(), filterFunc);
-        // we then erase everything from that point to the 'end()'
-        trajectories.erase(lastGood, trajectories.end());
-        std::cerr << trajectories.size() << " trajectories after filtering for curvature" << std::endl;
-    }
-
-    // use track filter object, we still manually check options ot skip if not asked for.
-    // The track filter object uses the same method as above, but centralizes the code
-    // for improved reliability and maintenance.
-    if (vm->count("min-hull-gyration-ratio") != 0 || vm->count("max-hull-gyration-ratio") != 0) {
-        auto& filter = hullGyrationFilter;
-        std::cerr << "Filtering based on " << filter.getName() << std::endl;
-        boost::timer::auto_cpu_timer t(std::cerr);
-        filter(trajectories);
-        std::cerr << trajectories.size() << " trajectories after filtering for " << filter.getName()
-                  << std::endl;
+        pipeline.add_range_filter("curvature", tracktable::filter_metrics::curvature<FeaturesT>, lower, upper);
     }
 
+    // The track filter objects supply the command line options; the
+    // metrics themselves come from the library.
+    auto addStage = [&](const auto& _filter, PipelineT::metric_type _metric) {
+        if (vm->count("min-" + _filter.getName()) != 0 || vm->count("max-" + _filter.getName()) != 0) {
+            pipeline.add_range_filter(_filter.getName(), _metric, static_cast<double>(_filter.getMin()),
+                                      static_cast<double>(_filter.getMax()));
+        }
+    };
+    addStage(hullGyrationFilter, tracktable::filter_metrics::hull_gyration_ratio<FeaturesT>);
     // This ratio represents the directness of a flight
-    if (vm->count("min-length-ratio") != 0 || vm->count("max-length-ratio") != 0) {
-        auto& filter = lengthRatioFilter;
-        std::cerr << "Filtering based on " << filter.getName() << std::endl;
-        boost::timer::auto_cpu_timer t(std::cerr);
-        filter(trajectories);
-        std::cerr << trajectories.size() << " trajectories after filtering for " << filter.getName()
-                  << std::endl;
-    }
+    addStage(lengthRatioFilter, tracktable::filter_metrics::length_ratio<FeaturesT>);
+    addStage(hullAspectRatioFilter, tracktable::filter_metrics::hull_aspect_ratio<FeaturesT>);
+    // Mapping flights will have a high straightness with a high number of turn arounds
+    addStage(straightnessFilter, tracktable::filter_metrics::straight_fraction<FeaturesT>);
+    addStage(turnAroundsFilter, tracktable::filter_metrics::turn_arounds<FeaturesT>);
 
-    if (vm->count("min-hull-aspect-ratio") != 0 || vm->count("max-hull-aspect-ratio") != 0) {
-        auto& filter = hullAspectRatioFilter;
-        std::cerr << "Filtering based on " << filter.getName() << std::endl;
+    if (pipeline.size() != 0) {
+        std::cerr << "Filtering based on";
+        for (auto i = 0u; i < pipeline.size(); ++i) {
+            std::cerr << " " << pipeline.stage_name(i);
+        }
+        std::cerr << std::endl;
         boost::timer::auto_cpu_timer t(std::cerr);
-        filter(trajectories);
-        std::cerr << trajectories.size() << " trajectories after filtering for " << filter.getName()
-                  << std::endl;
+        pipeline.filter(trajectories);
+        for (auto i = 0u; i < pipeline.size(); ++i) {
+            std::cerr << pipeline.rejection_counts()[i] << " trajectories removed by " << pipeline.stage_name(i)
+                      << std::endl;
+        }
+        std::cerr << trajectories.size() << " trajectories after filtering" << std::endl;
     }
-    // Apply headings if needed
-    if (0 != (vm->count("assign-headings") + vm->count("min-straightness") + vm->count("max-straightness") +
-              vm->count("min-turn-arounds") + vm->count("max-turn-arounds"))) {
+
+    // Headings are only written to the points when asked for; the
+    // filters above compute their own.
+    if (vm->count("assign-headings") != 0) {
         AssignTrajectoryHeadings(trajectories);
     }
-    // Mapping flights will have a high straightness with a high number of turn arounds
-    if (vm->count("min-straightness") != 0 || vm->count("max-straightness") != 0) {
-        auto& filter = straightnessFilter;
-        std::cerr << "Filtering based on " << filter.getName() << std::endl;
-        boost::timer::auto_cpu_timer t(std::cerr);
-        filter(trajectories);
-        std::cerr << trajectories.size() << " trajectories after filtering for " << filter.getName()
-                  << std::endl;
-    }
-    if (vm->count("min-turn-arounds") != 0 || vm->count("max-turn-arounds") != 0) {
-        auto& filter = turnAroundsFilter;
-        std::cerr << "Filtering based on " << filter.getName() << std::endl;
-        boost::timer::auto_cpu_timer t(std::cerr);
-        filter(trajectories);
-        std::cerr << trajectories.size() << " trajectories after filtering for " << filter.getName()
-                  << std::endl;
-    }
 
     if (0 != vm->count("no-output")) {
         std::cerr << "No Output" << std::endl;
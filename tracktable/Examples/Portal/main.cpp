@@ -28,20 +28,25 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include "Portal.h"
-#include "PortalPair.h"
-
+#include <tracktable/Analysis/PortalDiscovery.h>
 #include <tracktable/CommandLineFactories/AssemblerFromCommandLine.h>
 #include <tracktable/CommandLineFactories/PointReaderFromCommandLine.h>
 #include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/RW/KmlOut.h>
 
 #include <boost/timer/timer.hpp>
 
+#include <fstream>
+#include <sstream>
+
 using TrajectoryT = tracktable::domain::terrestrial::trajectory_type;
 using PointT = typename TrajectoryT::point_type;
 using PointReaderT = tracktable::PointReader<PointT>;
 using PointReaderIteratorT = typename PointReaderT::iterator;
 using AssemblerT = tracktable::AssembleTrajectories<TrajectoryT, PointReaderIteratorT>;
+using TrajectoryPtrT = std::shared_ptr<TrajectoryT>;
+using PortalDiscoveryT = tracktable::PortalDiscovery<TrajectoryT>;
+using PortalPairT = PortalDiscoveryT::portal_pair_type;
 
 static constexpr auto helpmsg = R"(
 --------------------------------------------------------------------------------
@@ -55,19 +60,46 @@ cells = 12*5*bins^(2+depth)
 
 empty cells are dropped but a cell is only empty if no trajectories pass through it
 
+Each pair that is found is written to its own KML file (flights0.kml, flights1.kml, ...)
+along with the trajectories that travel between the two portals.
+
 The portal example demonstrates:
     - Using command line factories to read points and assemble trajectories
     - Using boost program options to take parameters from command lines(in addition to the factories)
-    - Use of boost::geometry::intersects to test where trajectories overlap regions
+    - Using tracktable::PortalDiscovery to find origin/destination pairs
 
 Typical use:
-    ./portal-- input=/data/flights.tsv --depth=5 --min-value=12 --min-seperation=10 --bin-count=2
+    ./portal-- input=/data/flights.tsv --depth=5 --min-value=12 --min-seperation=1000 --bin-count=2
 
 Defaults assume a tab separated file formatted as :
 
 OBJECTID TIMESTAMP LON LAT
 --------------------------------------------------------------------------------)";
 
+using tracktable::kml;
+void writeKmlPortalPair(const PortalPairT &_pair, const std::vector<TrajectoryPtrT> &_trajectories,
+                        const std::string &_fileName) {
+    std::vector<TrajectoryPtrT> contributors;
+    for (auto index : _pair.contributors) {
+        contributors.push_back(_trajectories[index]);
+    }
+
+    std::ofstream out(_fileName.c_str());
+    out.precision(15);
+    out << kml::header;
+    kml::width(3);
+    kml::write(out, contributors);
+
+    out << kml::style("Portal", "FF0000FF", 1.0);
+    out << kml::startpm();
+    out << kml::startmulti();
+    out << kml::box(_pair.first_portal.min_corner(), _pair.first_portal.max_corner());
+    out << kml::box(_pair.second_portal.min_corner(), _pair.second_portal.max_corner());
+    out << kml::stopmulti();
+    out << kml::stoppm();
+    out << kml::footer;
+}
+
 int main(int _argc, char* _argv[]) {
     constexpr auto timerFormat = "\u001b[30;1m %w seconds\u001b[0m\n";
     // Set log level to reduce unecessary output
@@ -89,14 +121,14 @@ int main(int _argc, char* _argv[]) {
     assemblerFactory.setVariables(vm);
 
     // Portal specific configuration
-    auto seperationDistance = 10.0;
+    auto seperationDistance = 1000.0;
     auto depth = 5u;
     auto binSize = 2u;
     auto minValue = 16u;
     boost::program_options::options_description portalOptions("Portals");
     // clang-format off
     portalOptions.add_options()
-        ("portal-sep", bpo::value(&seperationDistance)->default_value(10), "Set minimum portal separation distance (in lat-lon)")
+        ("portal-sep", bpo::value(&seperationDistance)->default_value(1000), "Set minimum distance between portal centers (in km)")
         ("depth", bpo::value(&depth)->default_value(5), "Set depth for portal decomposition")
         ("bin-count", bpo::value(&binSize)->default_value(2), "Portal chopping factor (default is 2)")
         ("min-value", bpo::value(&minValue)->default_value(16), "Minumum number of portal pairs (default is 16)")
@@ -148,25 +180,29 @@ int main(int _argc, char* _argv[]) {
     }
 
     // Create box for the USA
+    // Note: we are assuming the starting box is the USA and has an aspect ratio
+    // of 12 by 5.  Using a different aliquot will result in non-square portals.
+    // Not that there is anything wrong with that.
     PointT lowerLeft(-125.0, 25.0);  // lower left of USA
     PointT upperRight(-65.0, 50.0);  // upper right of USA
-    auto USA = std::make_shared<Portal>(boost::geometry::model::box<PointT>(lowerLeft, upperRight));
-    USA->level = 0;
-    PairHeap pairs;
-    pairs.minimumSeperation = seperationDistance;
-    pairs.minimumValue = minValue;
-    pairs.depth = depth;
-    pairs.xDivisions = binSize;
-    pairs.yDivisions = binSize;
-    {
-        std::cerr << "Initializing Pair Heap" << std::endl;
-        boost::timer::auto_cpu_timer initializeTimer(std::cerr, timerFormat);
-        pairs.initialize(trajectories, USA);
-    }
+    PortalDiscoveryT discovery(lowerLeft, upperRight, 12, 5);
+    discovery.set_minimum_separation(seperationDistance);
+    discovery.set_minimum_value(minValue);
+    discovery.set_depth(depth);
+    discovery.set_subdivisions(binSize);
+
+    std::vector<PortalPairT> pairs;
     {
         std::cerr << "Finding Portals" << std::endl;
         boost::timer::auto_cpu_timer findTimer(std::cerr, timerFormat);
-        pairs.find_portals();
+        pairs = discovery.find_portal_pairs(trajectories.begin(), trajectories.end());
+    }
+    std::cerr << "Found " << pairs.size() << " portal pairs" << std::endl;
+
+    for (auto i = 0u; i < pairs.size(); ++i) {
+        std::stringstream filename;
+        filename << "flights" << i << ".kml";
+        writeKmlPortalPair(pairs[i], trajectories, filename.str());
     }
     return 0;
 }
\ No newline at end of file
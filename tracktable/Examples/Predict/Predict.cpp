@@ -33,6 +33,7 @@
 #include "BuildFeatures.h"
 #include "PredictData.h"
 
+#include <tracktable/Analysis/HNSWIndex.h>
 #include <tracktable/RW/KmlOut.h>
 
 using tracktable::kml;
@@ -43,16 +44,17 @@ void Predict(const TrajectoryVectorT &_trajectories, const size_t _numSamples) {
     // use random features as our 'test' set
     auto to_be_predicted = BuildRandomFeatures(_trajectories, 0.2, 0.8);
 
-    // Create rtree for our predictions
-    PredictRtreeT rtree;
-    // std::vector<PredictRtreeT::value_type> data;
+    // Create a nearest-neighbor index for our predictions.  Point IDs in
+    // the index are positions in the features vector.
+    tracktable::HNSWIndex<PredictData::FeatureT> neighbor_index;
+    neighbor_index.set_ef_search(4 * (_numSamples + 10));
 
-    // Build the feature vector/id number combo for the rtree.  There is an
-    // unused value set to 0 that might be used in the future.
-
-    for (auto i = 0u; i < features.size(); ++i) {
-        rtree.insert(&(features[i]));
+    std::vector<PredictData::FeatureT> feature_points;
+    feature_points.reserve(features.size());
+    for (auto const &feature : features) {
+        feature_points.push_back(feature.feature);
     }
+    neighbor_index.insert(feature_points.begin(), feature_points.end());
 
     // Define the the number of trajectories that will be used to predict
     // the destination.  The bins vector will be used to hold the result of
@@ -66,15 +68,16 @@ void Predict(const TrajectoryVectorT &_trajectories, const size_t _numSamples) {
     // find all of its neighbors to predict where it will land.
 
     for (auto &current : to_be_predicted) {
-        std::vector<PredictRtreeT::value_type> result_n;
+        std::vector<PredictData *> result_n;
 
         // Note we are getting more results than _numSamples.  This is because
         // we will throw out the hit that corresponds to the trajectory itself.
         // It would be cheating to use that for prediction.
 
-        auto it = rtree.qbegin(boost::geometry::index::nearest(current.feature, _numSamples + 10));
-        for (; (it != rtree.qend()) && (result_n.size() < _numSamples); ++it) {
-            if ((*it)->index != current.index) result_n.push_back(*it);
+        std::vector<std::pair<size_t, double>> neighbors;
+        neighbor_index.find_nearest_neighbors(current.feature, _numSamples + 10, std::back_inserter(neighbors));
+        for (auto it = neighbors.begin(); (it != neighbors.end()) && (result_n.size() < _numSamples); ++it) {
+            if (features[it->first].index != current.index) result_n.push_back(&(features[it->first]));
         }
 
         using WeightPairT = std::pair<std::string, double>;
@@ -85,7 +88,7 @@ void Predict(const TrajectoryVectorT &_trajectories, const size_t _numSamples) {
         auto dest = current.index->front().string_property("dest");
         std::cout << dest << std::endl;
 
-        // Take the results from the rtree query, and then build a vector that
+        // Take the results from the neighbor query, and then build a vector that
         // has the resulting flights.  In addition, build a table of weights for
         // each potential destination (via a map) using what is essentially a
         // 1/d^2 weight.  The d^2 term comes from the "comparable_distance"
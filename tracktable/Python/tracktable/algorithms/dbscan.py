@@ -71,7 +71,8 @@ def is_decorated(point):
     return False
 
 
-def compute_cluster_labels(feature_vectors, search_box_half_span, min_cluster_size):
+def compute_cluster_labels(feature_vectors, search_box_half_span, min_cluster_size,
+                           lsh_options=None):
     """Use DBSCAN to compute clusters for a set of points.
 
     DBSCAN is a clustering algorithm that looks for regions of high
@@ -86,6 +87,19 @@ def compute_cluster_labels(feature_vectors, search_box_half_span, min_cluster_si
         min_cluster_size (int): The minimum number of points that you're willing to call a
             cluster.
 
+    Keyword Arguments:
+        lsh_options (dict): If not None, split the points into buckets
+            with locality-sensitive hashing and run DBSCAN on each
+            bucket separately (and in parallel).  This is much faster
+            on millions of points but approximate: a few neighbors are
+            lost at bucket boundaries.  The dictionary may contain
+            'num_projections' (default 8; more means smaller buckets),
+            'bucket_width' (default 4.0, in units of the search box),
+            'num_probes' (default 1; extra buckets each point is copied
+            into, more means better recall), 'num_threads' (default 0,
+            one per core) and 'random_seed' (default 0).  An empty
+            dictionary uses all the defaults. (Default: None)
+
     Returns:
         You will get back a list of (vertex_id, cluster_id) pairs. If you
         supplied a list of points as input the vertex IDs will be indices
@@ -118,13 +132,27 @@ def compute_cluster_labels(feature_vectors, search_box_half_span, min_cluster_si
     else:
         point_size = len(first_point)
 
-    cluster_engine_name = 'dbscan_learn_cluster_ids_{}'.format(point_size)
-    dbscan_learn_cluster_labels = getattr(_dbscan_clustering, cluster_engine_name)
-    integer_labels = dbscan_learn_cluster_labels(
-        native_feature_vectors,
-        native_box_half_span,
-        min_cluster_size
-        )
+    if lsh_options is None:
+        cluster_engine_name = 'dbscan_learn_cluster_ids_{}'.format(point_size)
+        dbscan_learn_cluster_labels = getattr(_dbscan_clustering, cluster_engine_name)
+        integer_labels = dbscan_learn_cluster_labels(
+            native_feature_vectors,
+            native_box_half_span,
+            min_cluster_size
+            )
+    else:
+        cluster_engine_name = 'dbscan_learn_cluster_ids_lsh_{}'.format(point_size)
+        dbscan_learn_cluster_labels = getattr(_dbscan_clustering, cluster_engine_name)
+        integer_labels = dbscan_learn_cluster_labels(
+            native_feature_vectors,
+            native_box_half_span,
+            min_cluster_size,
+            lsh_options.get('num_projections', 8),
+            lsh_options.get('bucket_width', 4.0),
+            lsh_options.get('num_probes', 1),
+            lsh_options.get('num_threads', 0),
+            lsh_options.get('random_seed', 0)
+            )
 
     final_labels = []
     for (vertex_index, cluster_id) in integer_labels:
@@ -0,0 +1,117 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.algorithms.great_circle_fit - Fit great circles to terrestrial trajectories
+
+The best-fit great circle of a trajectory is the plane through the
+center of the earth that is closest to all of its points.  A flight
+that stays close to its great circle is flying a direct route; a
+large residual flags a detour.
+"""
+
+from __future__ import division, absolute_import, print_function
+
+from tracktable.lib import _great_circle_fit
+
+#: Values accepted for the ``altitude_units`` argument
+ALTITUDE_UNITS = ('feet', 'meters', 'kilometers')
+
+
+def best_fit_plane(trajectory, altitude_property='altitude', altitude_units='feet'):
+    """Find the plane normal of a trajectory's best-fit great circle
+
+    Arguments:
+        trajectory (Trajectory): Terrestrial trajectory with at least
+            two distinct points
+
+    Keyword Arguments:
+        altitude_property (str): Name of the point property that holds
+            altitude (Default: 'altitude')
+        altitude_units (str): One of 'feet', 'meters' or 'kilometers'
+            (Default: 'feet')
+
+    Returns:
+        Unit normal of the plane as an (x, y, z) tuple in ECEF space
+
+    Raises:
+        ValueError: The trajectory has fewer than two distinct points
+            or the units are not recognized
+    """
+
+    return _great_circle_fit.find_best_fit_plane(trajectory, altitude_property, altitude_units)
+
+
+def best_fit_planes(trajectories, altitude_property='altitude', altitude_units='feet', num_threads=0):
+    """Find best-fit great circles for many trajectories at once
+
+    The fits run in C++ on several threads without holding the GIL.
+    Each thread reuses its scratch space from one trajectory to the
+    next.
+
+    Arguments:
+        trajectories (iterable of Trajectory): Terrestrial trajectories
+
+    Keyword Arguments:
+        altitude_property (str): Name of the point property that holds
+            altitude (Default: 'altitude')
+        altitude_units (str): One of 'feet', 'meters' or 'kilometers'
+            (Default: 'feet')
+        num_threads (int): Number of threads to use; 0 means one per
+            core (Default: 0)
+
+    Returns:
+        List of (x, y, z) normals, one per trajectory in input order.
+        Trajectories that cannot be fit get (0, 0, 0).
+    """
+
+    return _great_circle_fit.find_best_fit_planes(trajectories, altitude_property,
+                                                  altitude_units, num_threads)
+
+
+def project_onto_plane(trajectory, normal, altitude_property='altitude', altitude_units='feet'):
+    """Move every point of a trajectory onto a great circle
+
+    Arguments:
+        trajectory (Trajectory): Terrestrial trajectory
+        normal (tuple of 3 floats): Plane normal, usually from
+            :func:`best_fit_plane`
+
+    Keyword Arguments:
+        altitude_property (str): Name of the point property that holds
+            altitude (Default: 'altitude')
+        altitude_units (str): One of 'feet', 'meters' or 'kilometers'
+            (Default: 'feet')
+
+    Returns:
+        New trajectory whose points lie on the great circle
+    """
+
+    return _great_circle_fit.project_trajectory_onto_plane(trajectory, normal,
+                                                           altitude_property, altitude_units)
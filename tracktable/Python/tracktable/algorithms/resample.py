@@ -0,0 +1,204 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.algorithms.resample - Resample trajectories at regular times
+"""
+
+from __future__ import division, absolute_import, print_function
+
+import collections
+
+import numpy
+
+from tracktable.lib import _trajectory_resampler
+
+_NATIVE_RESAMPLERS = {
+    'terrestrial': _trajectory_resampler.TerrestrialTrajectoryResampler,
+    'cartesian2d': _trajectory_resampler.Cartesian2DTrajectoryResampler,
+    'cartesian3d': _trajectory_resampler.Cartesian3DTrajectoryResampler
+    }
+
+ResampledColumns = collections.namedtuple(
+    'ResampledColumns',
+    ['offsets', 'object_ids', 'timestamps', 'coordinates', 'properties'])
+ResampledColumns.__doc__ = """Resampled trajectories stored column by column
+
+Row ``r`` holds one sample. The rows for trajectory ``i`` are
+``offsets[i]`` up to but not including ``offsets[i+1]``.
+
+Attributes:
+    offsets (numpy.ndarray): One more entry than there are trajectories
+    object_ids (list of str): Object ID of each trajectory
+    timestamps (numpy.ndarray): Sample times as ``datetime64[us]``
+    coordinates (numpy.ndarray): One row per coordinate, one column per sample
+    properties (dict): Property name to array of values. Missing and
+        non-numeric values are NaN.
+"""
+
+
+def _make_resampler(domain, interpolate_properties, copy_properties, num_threads):
+    if domain not in _NATIVE_RESAMPLERS:
+        raise ValueError(
+            'resample: Unsupported domain "{}"'.format(domain))
+    resampler = _NATIVE_RESAMPLERS[domain]()
+    for name in interpolate_properties:
+        resampler.interpolate_property(name)
+    for name in copy_properties:
+        resampler.copy_property(name)
+    resampler.set_num_threads(num_threads)
+    return resampler
+
+
+def _check_schedule(interval, times):
+    if (interval is None) == (times is None):
+        raise ValueError('resample: Specify exactly one of interval and times')
+
+
+def resample_trajectory(trajectory,
+                        interval=None,
+                        times=None,
+                        interpolate_properties=(),
+                        copy_properties=()):
+    """Resample a trajectory at a fixed interval or at given times
+
+    The trajectory and the sample times are walked together once, so
+    this is much faster than calling
+    :func:`tracktable.core.geomath.point_at_time` for every sample.
+    Coordinates are interpolated the same way ``point_at_time`` does
+    it. Sample times outside the trajectory's time span are skipped.
+
+    Point properties are dropped unless they are named in
+    ``interpolate_properties`` (interpolated between neighboring
+    points) or ``copy_properties`` (copied from the point nearer in
+    time). Trajectory properties are always kept.
+
+    Arguments:
+        trajectory (Trajectory): Trajectory to resample. Its points
+            must be in time order.
+
+    Keyword Arguments:
+        interval (datetime.timedelta): Time between samples, starting
+            at the trajectory's first point (Default: None)
+        times (iterable of datetime.datetime): Sorted sample times
+            (Default: None)
+        interpolate_properties (iterable of str): Point properties to
+            interpolate (Default: none)
+        copy_properties (iterable of str): Point properties to copy
+            from the nearer point (Default: none)
+
+    Returns:
+        New trajectory from the same domain
+
+    Raises:
+        ValueError: Both or neither of ``interval`` and ``times`` were
+            given, the interval is not positive, or the times are not
+            sorted
+    """
+
+    _check_schedule(interval, times)
+    resampler = _make_resampler(trajectory.domain, interpolate_properties, copy_properties, 1)
+    if interval is not None:
+        return resampler.resample_at_interval(trajectory, interval)
+    return resampler.resample_at_times(trajectory, list(times))
+
+
+def resample_trajectories(trajectories,
+                          interval=None,
+                          times=None,
+                          interpolate_properties=(),
+                          copy_properties=(),
+                          columns=False,
+                          num_threads=0):
+    """Resample a collection of trajectories in parallel
+
+    With ``times`` every trajectory is sampled at the same instants,
+    which lines tracks up for movies, prediction and rendezvous
+    checks. With ``interval`` each trajectory gets its own samples
+    starting at its first point. See :func:`resample_trajectory` for
+    how points and properties are handled.
+
+    Arguments:
+        trajectories (iterable): Trajectories from a single domain
+
+    Keyword Arguments:
+        interval (datetime.timedelta): Time between samples (Default: None)
+        times (iterable of datetime.datetime): Sorted sample times
+            shared by all trajectories (Default: None)
+        interpolate_properties (iterable of str): Point properties to
+            interpolate (Default: none)
+        copy_properties (iterable of str): Point properties to copy
+            from the nearer point (Default: none)
+        columns (bool): Return a :class:`ResampledColumns` of NumPy
+            arrays instead of trajectories (Default: False)
+        num_threads (int): Number of threads to use; 0 means one per
+            processor (Default: 0)
+
+    Returns:
+        List of new trajectories in input order, or a
+        :class:`ResampledColumns` if ``columns`` is true
+
+    Raises:
+        ValueError: See :func:`resample_trajectory`
+    """
+
+    _check_schedule(interval, times)
+    trajectories = list(trajectories)
+    if len(trajectories) == 0:
+        return _to_columns(None) if columns else []
+
+    resampler = _make_resampler(trajectories[0].domain,
+                                interpolate_properties,
+                                copy_properties,
+                                num_threads)
+    if columns:
+        if interval is not None:
+            raw = resampler.columns_at_interval(trajectories, interval)
+        else:
+            raw = resampler.columns_at_times(trajectories, list(times))
+        return _to_columns(raw)
+
+    if interval is not None:
+        return resampler.resample_collection_at_interval(trajectories, interval)
+    return resampler.resample_collection_at_times(trajectories, list(times))
+
+
+def _to_columns(raw):
+    if raw is None:
+        return ResampledColumns(numpy.zeros(1, dtype=numpy.int64), [],
+                                numpy.array([], dtype='datetime64[us]'),
+                                numpy.zeros((0, 0)), {})
+    return ResampledColumns(
+        numpy.array(raw['offsets'], dtype=numpy.int64),
+        list(raw['object_ids']),
+        numpy.array([numpy.datetime64(t.replace(tzinfo=None), 'us') for t in raw['timestamps']],
+                    dtype='datetime64[us]'),
+        numpy.array(raw['coordinates'], dtype=numpy.float64),
+        dict((name, numpy.array(values, dtype=numpy.float64))
+             for (name, values) in raw['properties'].items()))
@@ -0,0 +1,217 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.algorithms.similarity - Compare whole trajectories
+"""
+
+from __future__ import division, absolute_import, print_function
+
+from tracktable.lib import _trajectory_similarity
+
+#: Measures that can be used with :class:`TrajectorySimilaritySearch`
+MEASURES = ('frechet', 'dtw', 'hausdorff')
+
+_NATIVE_SEARCHES = {
+    'terrestrial': _trajectory_similarity.TerrestrialTrajectorySimilaritySearch,
+    'cartesian2d': _trajectory_similarity.Cartesian2DTrajectorySimilaritySearch,
+    'cartesian3d': _trajectory_similarity.Cartesian3DTrajectorySimilaritySearch
+    }
+
+
+def frechet_distance(first, second, band=0, cutoff=float('inf')):
+    """Discrete Fréchet distance between two trajectories
+
+    This is the smallest possible "leash length" when two walkers step
+    through the points of each trajectory in order, either one or both
+    advancing at each step.
+
+    Arguments:
+        first (Trajectory): First trajectory
+        second (Trajectory): Second trajectory, from the same domain
+
+    Keyword Arguments:
+        band (int): Maximum difference between the indices of matched
+            points. It is widened to the difference in trajectory
+            lengths if necessary. With a band the result is an upper
+            bound on the unrestricted distance. 0 means no limit.
+            (Default: 0)
+        cutoff (float): Stop early and return infinity once the
+            distance is known to be larger than this (Default: infinity)
+
+    Returns:
+        Distance in the units of :func:`tracktable.core.geomath.distance`,
+        or infinity if either trajectory is empty
+    """
+
+    return _trajectory_similarity.frechet_distance(first, second, band, cutoff)
+
+
+def dtw_distance(first, second, band=0, cutoff=float('inf')):
+    """Dynamic time warping distance between two trajectories
+
+    This is the smallest possible sum of point-to-point distances over
+    all monotone alignments of the two trajectories. The ``band`` and
+    ``cutoff`` arguments mean the same thing as they do for
+    :func:`frechet_distance`.
+
+    Arguments:
+        first (Trajectory): First trajectory
+        second (Trajectory): Second trajectory, from the same domain
+
+    Keyword Arguments:
+        band (int): Maximum difference between the indices of matched
+            points; 0 means no limit (Default: 0)
+        cutoff (float): Stop early and return infinity once the
+            distance is known to be larger than this (Default: infinity)
+
+    Returns:
+        Sum of distances in the units of
+        :func:`tracktable.core.geomath.distance`, or infinity if either
+        trajectory is empty
+    """
+
+    return _trajectory_similarity.dtw_distance(first, second, band, cutoff)
+
+
+def hausdorff_distance(first, second, cutoff=float('inf')):
+    """Hausdorff distance between the points of two trajectories
+
+    This is the largest distance from a point in either trajectory to
+    the nearest point in the other. Point order is ignored.
+
+    Arguments:
+        first (Trajectory): First trajectory
+        second (Trajectory): Second trajectory, from the same domain
+
+    Keyword Arguments:
+        cutoff (float): Stop early and return infinity once the
+            distance is known to be larger than this (Default: infinity)
+
+    Returns:
+        Distance in the units of :func:`tracktable.core.geomath.distance`,
+        or infinity if either trajectory is empty
+    """
+
+    return _trajectory_similarity.hausdorff_distance(first, second, cutoff)
+
+
+class TrajectorySimilaritySearch(object):
+    """Find the stored trajectories closest to a query trajectory
+
+    Results are exact for the chosen measure. Most candidates are
+    ruled out with cheap lower bounds before any exact distance is
+    computed, and the exact distances are computed in C++ on several
+    threads.
+
+    The index keeps its own copy of every trajectory. Results refer to
+    trajectories by their position in insertion order.
+
+    Example:
+
+    .. code-block:: python
+
+        search = TrajectorySimilaritySearch(trajectories, measure='dtw')
+        for (index, distance) in search.find_nearest(query, 5):
+            print(trajectories[index].object_id, distance)
+    """
+
+    def __init__(self, trajectories=None, measure='frechet', band=0, num_threads=0):
+        """Create a search index
+
+        Keyword Arguments:
+            trajectories (iterable): Trajectories to add right away
+                (Default: None)
+            measure (str): One of :data:`MEASURES` (Default: 'frechet')
+            band (int): Band for Fréchet and DTW; see
+                :func:`frechet_distance` (Default: 0)
+            num_threads (int): Number of threads to use; 0 means one
+                per processor (Default: 0)
+
+        Raises:
+            ValueError: ``measure`` is not one of :data:`MEASURES`
+        """
+
+        if measure not in MEASURES:
+            raise ValueError(
+                'TrajectorySimilaritySearch: Unknown measure "{}"'.format(measure))
+        self.measure = measure
+        self.band = band
+        self.num_threads = num_threads
+        self._search = None
+        if trajectories is not None:
+            self.insert(trajectories)
+
+    def insert(self, trajectories):
+        """Add trajectories to the index
+
+        All trajectories in one index must come from the same domain.
+
+        Arguments:
+            trajectories (iterable): Trajectories to add
+
+        Raises:
+            ValueError: The trajectories are not from a supported domain
+        """
+
+        trajectories = list(trajectories)
+        if len(trajectories) == 0:
+            return
+        if self._search is None:
+            domain = trajectories[0].domain
+            if domain not in _NATIVE_SEARCHES:
+                raise ValueError(
+                    'TrajectorySimilaritySearch: Unsupported domain "{}"'.format(domain))
+            self._search = _NATIVE_SEARCHES[domain](self.measure, self.band, self.num_threads)
+        self._search.insert(trajectories)
+
+    def find_nearest(self, query, k=1):
+        """Find the k stored trajectories closest to a query
+
+        Empty trajectories are never returned.
+
+        Arguments:
+            query (Trajectory): Trajectory to compare against
+
+        Keyword Arguments:
+            k (int): Number of neighbors to find (Default: 1)
+
+        Returns:
+            List of up to ``k`` (position, distance) tuples sorted by
+            increasing distance
+        """
+
+        if self._search is None:
+            return []
+        return self._search.find_nearest(query, k)
+
+    def __len__(self):
+        if self._search is None:
+            return 0
+        return len(self._search)
@@ -185,9 +185,49 @@ def test_cluster_dictionary():
 
 # ----------------------------------------------------------------------
 
+def test_lsh_clusters():
+    random.seed(0)
+
+    corner_points = place_corner_clusters()
+    noise_points = place_noise_points([0.5, 0.5, 0.5], [10, 10, 10], 100)
+    all_points = corner_points + noise_points
+
+    print("Learning cluster IDs with and without LSH buckets.")
+    exact_ids = dict(compute_cluster_labels(all_points,
+                                            [0.05, 0.05, 0.05],
+                                            4))
+    lsh_ids = dict(compute_cluster_labels(all_points,
+                                          [0.05, 0.05, 0.05],
+                                          4,
+                                          lsh_options={'num_projections': 2,
+                                                       'bucket_width': 16.0,
+                                                       'num_probes': 2}))
+
+    # The corner clusters are far apart, so the two clusterings must
+    # agree up to renumbering.
+    exact_to_lsh = {}
+    for (vertex_id, exact_cluster) in exact_ids.items():
+        lsh_cluster = lsh_ids[vertex_id]
+        if (exact_cluster == 0) != (lsh_cluster == 0):
+            print(("ERROR: Point {} has cluster {} without LSH but {} "
+                   "with LSH.").format(vertex_id, exact_cluster, lsh_cluster))
+            return 1
+        if exact_cluster != 0:
+            if exact_to_lsh.setdefault(exact_cluster, lsh_cluster) != lsh_cluster:
+                print("ERROR: Cluster {} was split by LSH bucketing.".format(exact_cluster))
+                return 1
+
+    if len(set(exact_to_lsh.values())) != len(exact_to_lsh):
+        print("ERROR: LSH bucketing merged separate clusters.")
+        return 1
+    return 0
+
+# ----------------------------------------------------------------------
+
 def main():
     num_errors = test_clusters()
     num_errors += test_cluster_dictionary()
+    num_errors += test_lsh_clusters()
     return num_errors
 
 # ----------------------------------------------------------------------
@@ -0,0 +1,105 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Test the Python interface to the best-fit great circle functions.
+# The C++ tests cover the fit itself in more detail.
+
+from __future__ import absolute_import, division, print_function
+
+import datetime
+import sys
+
+from tracktable.algorithms.great_circle_fit import (best_fit_plane,
+                                                    best_fit_planes,
+                                                    project_onto_plane)
+from tracktable.domain.terrestrial import Trajectory, TrajectoryPoint
+
+
+def make_trajectory(object_id, coordinates):
+    trajectory = Trajectory()
+    when = datetime.datetime(2020, 1, 1)
+    for (i, (lon, lat)) in enumerate(coordinates):
+        point = TrajectoryPoint(lon, lat)
+        point.object_id = object_id
+        point.timestamp = when + datetime.timedelta(minutes=i)
+        point.properties['altitude'] = 30000.0
+        trajectory.append(point)
+    return trajectory
+
+
+def test_single_and_batch():
+    error_count = 0
+    equator = make_trajectory('east', [(i, 0) for i in range(10)])
+    meridian = make_trajectory('north', [(0, i) for i in range(10)])
+    single = make_trajectory('single', [(5, 5)])
+
+    normal = best_fit_plane(equator)
+    if abs(abs(normal[2]) - 1) > 1e-9:
+        print('ERROR: Equator should fit a plane with a polar normal, got {}'.format(normal))
+        error_count += 1
+
+    normals = best_fit_planes([equator, meridian, single], num_threads=2)
+    if len(normals) != 3:
+        print('ERROR: Expected 3 normals but got {}'.format(len(normals)))
+        return error_count + 1
+    if normals[0] != normal or normals[1] != best_fit_plane(meridian):
+        print('ERROR: Batch fits do not match single fits: {}'.format(normals))
+        error_count += 1
+    if normals[2] != (0.0, 0.0, 0.0):
+        print('ERROR: Unfittable trajectory should get a zero normal, got {}'.format(normals[2]))
+        error_count += 1
+
+    try:
+        best_fit_plane(single)
+        print('ERROR: Fitting a one-point trajectory should raise ValueError')
+        error_count += 1
+    except ValueError:
+        pass
+
+    try:
+        best_fit_planes([equator], altitude_units='furlongs')
+        print('ERROR: Unknown altitude units should raise ValueError')
+        error_count += 1
+    except ValueError:
+        pass
+
+    projected = project_onto_plane(equator, normal)
+    if len(projected) != len(equator):
+        print('ERROR: Projection changed the number of points')
+        error_count += 1
+
+    return error_count
+
+
+def main():
+    return test_single_and_batch()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
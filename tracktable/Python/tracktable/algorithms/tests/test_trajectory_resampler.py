@@ -0,0 +1,150 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Test the Python interface to the single-pass trajectory resampler.
+# The C++ test covers interpolation in more detail.
+
+from __future__ import absolute_import, division, print_function
+
+import datetime
+import sys
+
+import numpy
+
+from tracktable.algorithms.resample import resample_trajectories, resample_trajectory
+from tracktable.core import geomath
+from tracktable.domain.cartesian2d import Trajectory, TrajectoryPoint
+
+START = datetime.datetime(2020, 1, 1)
+
+
+def make_trajectory(object_id, offset, num_points):
+    trajectory = Trajectory()
+    for i in range(num_points):
+        point = TrajectoryPoint(offset + 10.0 * i, 0)
+        point.object_id = object_id
+        point.timestamp = START + datetime.timedelta(minutes=i)
+        point.properties['speed'] = float(i)
+        point.properties['status'] = 'leg{}'.format(i)
+        trajectory.append(point)
+    return trajectory
+
+
+def test_single_trajectory():
+    error_count = 0
+    path = make_trajectory('path', 0, 5)
+
+    resampled = resample_trajectory(path,
+                                    interval=datetime.timedelta(seconds=15),
+                                    interpolate_properties=['speed'],
+                                    copy_properties=['status'])
+    if len(resampled) != 17:
+        print('ERROR: Expected 17 samples but got {}'.format(len(resampled)))
+        return error_count + 1
+
+    for (i, point) in enumerate(resampled):
+        expected = geomath.point_at_time(path, START + datetime.timedelta(seconds=15 * i))
+        if abs(point[0] - expected[0]) > 1e-9 or abs(point.properties['speed'] - 0.25 * i) > 1e-9:
+            print('ERROR: Sample {} is {} but point_at_time gives {}'.format(i, point, expected))
+            error_count += 1
+        if point.properties['status'] != 'leg{}'.format((i + 1) // 4):
+            print('ERROR: Sample {} copied status {}'.format(i, point.properties['status']))
+            error_count += 1
+
+    plain = resample_trajectory(path, interval=datetime.timedelta(seconds=30))
+    if 'speed' in plain[1].properties:
+        print('ERROR: Properties should be dropped unless requested')
+        error_count += 1
+
+    times = [START - datetime.timedelta(minutes=1), START + datetime.timedelta(seconds=90)]
+    at_times = resample_trajectory(path, times=times)
+    if len(at_times) != 1 or abs(at_times[0][0] - 15) > 1e-9:
+        print('ERROR: Resampling at explicit times gave {}'.format(list(at_times)))
+        error_count += 1
+
+    for bad_arguments in [dict(), dict(interval=datetime.timedelta(0)),
+                          dict(times=list(reversed(times)))]:
+        try:
+            resample_trajectory(path, **bad_arguments)
+            print('ERROR: Resampling accepted bad arguments {}'.format(bad_arguments))
+            error_count += 1
+        except ValueError:
+            pass
+
+    return error_count
+
+
+def test_collection():
+    error_count = 0
+    paths = [make_trajectory('path{}'.format(i), 100 * i, 3 + i) for i in range(20)]
+    times = [START + datetime.timedelta(seconds=20 * i) for i in range(12)]
+
+    aligned = resample_trajectories(paths, times=times, interpolate_properties=['speed'],
+                                    num_threads=2)
+    for (path, result) in zip(paths, aligned):
+        expected = resample_trajectory(path, times=times, interpolate_properties=['speed'])
+        if [tuple(p) for p in result] != [tuple(p) for p in expected]:
+            print('ERROR: Parallel and serial resampling disagree for {}'.format(path.object_id))
+            error_count += 1
+
+    columns = resample_trajectories(paths, interval=datetime.timedelta(seconds=30),
+                                    interpolate_properties=['speed'], columns=True,
+                                    num_threads=2)
+    separate = resample_trajectories(paths, interval=datetime.timedelta(seconds=30))
+    expected_offsets = numpy.cumsum([0] + [len(t) for t in separate])
+    if not numpy.array_equal(columns.offsets, expected_offsets):
+        print('ERROR: Column offsets {} should be {}'.format(columns.offsets, expected_offsets))
+        error_count += 1
+    if columns.object_ids != [p.object_id for p in paths]:
+        print('ERROR: Column object IDs are wrong')
+        error_count += 1
+    if columns.coordinates.shape != (2, expected_offsets[-1]):
+        print('ERROR: Coordinate columns have shape {}'.format(columns.coordinates.shape))
+        error_count += 1
+    last = separate[-1]
+    if (abs(columns.coordinates[0][-1] - last[-1][0]) > 1e-9 or
+            abs(columns.properties['speed'][expected_offsets[-2] + 1] - 0.5) > 1e-9 or
+            columns.timestamps[-1] != numpy.datetime64(last[-1].timestamp.replace(tzinfo=None), 'us')):
+        print('ERROR: Column values do not match resampled trajectories')
+        error_count += 1
+
+    empty = resample_trajectories([], interval=datetime.timedelta(seconds=30), columns=True)
+    if len(empty.object_ids) != 0 or list(empty.offsets) != [0]:
+        print('ERROR: Empty collection should give empty columns')
+        error_count += 1
+
+    return error_count
+
+
+def main():
+    return test_single_trajectory() + test_collection()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,133 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Test the Python interface to the trajectory distances and the
+# k-nearest-neighbor search.  The C++ tests cover the algorithms in
+# more detail.
+
+from __future__ import absolute_import, division, print_function
+
+import datetime
+import itertools
+import math
+import sys
+
+from tracktable.algorithms.similarity import (TrajectorySimilaritySearch,
+                                              dtw_distance,
+                                              frechet_distance,
+                                              hausdorff_distance)
+from tracktable.domain.cartesian2d import Trajectory, TrajectoryPoint
+
+
+def make_trajectory(object_id, coordinates):
+    trajectory = Trajectory()
+    when = datetime.datetime(2020, 1, 1)
+    for (i, (x, y)) in enumerate(coordinates):
+        point = TrajectoryPoint(x, y)
+        point.object_id = object_id
+        point.timestamp = when + datetime.timedelta(seconds=i)
+        trajectory.append(point)
+    return trajectory
+
+
+def check(label, actual, expected):
+    if abs(actual - expected) > 1e-9:
+        print('ERROR: {}: expected {} but got {}'.format(label, expected, actual))
+        return 1
+    return 0
+
+
+def test_distances():
+    error_count = 0
+    lower = make_trajectory('lower', [(0, 0), (1, 0), (2, 0), (3, 0)])
+    upper = make_trajectory('upper', [(0, 1), (1, 1), (2, 1), (3, 1)])
+    error_count += check('Frechet', frechet_distance(lower, upper), 1)
+    error_count += check('DTW', dtw_distance(lower, upper), 4)
+    error_count += check('Hausdorff', hausdorff_distance(lower, upper), 1)
+    error_count += check('Frechet to self', frechet_distance(lower, lower), 0)
+
+    if not math.isinf(frechet_distance(lower, upper, cutoff=0.5)):
+        print('ERROR: Frechet distance ignored cutoff')
+        error_count += 1
+    if not math.isinf(dtw_distance(lower, Trajectory())):
+        print('ERROR: Distance to empty trajectory should be infinite')
+        error_count += 1
+    return error_count
+
+
+def test_search():
+    error_count = 0
+    trajectories = []
+    for (i, j) in itertools.product(range(10), range(10)):
+        trajectories.append(make_trajectory(
+            'object{}'.format(len(trajectories)),
+            [(i + 0.1 * t, j + 0.05 * t * t) for t in range(12)]))
+
+    query = make_trajectory('query', [(3.2 + 0.1 * t, 4.1 + 0.05 * t * t) for t in range(12)])
+
+    for measure in ('frechet', 'dtw', 'hausdorff'):
+        search = TrajectorySimilaritySearch(trajectories, measure=measure, num_threads=2)
+        if len(search) != len(trajectories):
+            print('ERROR: Search holds {} trajectories instead of {}'.format(
+                len(search), len(trajectories)))
+            error_count += 1
+
+        distance_function = {'frechet': frechet_distance,
+                             'dtw': dtw_distance,
+                             'hausdorff': hausdorff_distance}[measure]
+        expected = sorted((distance_function(query, t), i) for (i, t) in enumerate(trajectories))
+        matches = search.find_nearest(query, 5)
+        if [m[0] for m in matches] != [e[1] for e in expected[:5]]:
+            print('ERROR: {} search returned {} but brute force found {}'.format(
+                measure, matches, expected[:5]))
+            error_count += 1
+        for ((index, distance), (true_distance, _)) in zip(matches, expected):
+            error_count += check('{} distance for match {}'.format(measure, index),
+                                 distance, true_distance)
+
+    try:
+        TrajectorySimilaritySearch(measure='manhattan')
+        print('ERROR: Unknown measure was accepted')
+        error_count += 1
+    except ValueError:
+        pass
+
+    if TrajectorySimilaritySearch().find_nearest(query, 3) != []:
+        print('ERROR: Empty search should return no matches')
+        error_count += 1
+
+    return error_count
+
+
+def main():
+    return test_distances() + test_search()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
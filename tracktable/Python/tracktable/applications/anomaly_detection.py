@@ -38,7 +38,8 @@ are the primary driver functions for anomaly detection.
 import logging
 
 from tqdm import tqdm
-from tracktable.core.geomath import (ECEF_from_feet, compute_bounding_box,
+from tracktable.core.geomath import (ECEF_from_trajectories,
+                                     ECEF_from_trajectory, compute_bounding_box,
                                      intersects, point_at_length_fraction)
 from tracktable.domain.cartesian3d import BasePoint as CartesianPoint3D
 from tracktable.domain.feature_vectors import convert_to_feature_vector
@@ -199,7 +200,8 @@ def _create_rtree_bounding_box(center_point,
     """Create a bounding box around the values of the rtree.
 
     Arguments:
-        center_point (Tracktable point): Point to use as the center of the bounding box.
+        center_point (sequence): ECEF (x, y, z) coordinates in km of the
+            center of the bounding box, as returned by ECEF_from_trajectory.
         buffer (float): Amount of area to consider as valid around the bounding box.
 
     Keyword Arguments:
@@ -210,14 +212,10 @@ def _create_rtree_bounding_box(center_point,
         The min and max corner values of the bounding box.
     """
 
-    # Convert this point to ECEF for more exact distance calculations.
-    center_point.set_property("altitude", 0)
-    center_point_ecef = ECEF_from_feet(center_point)
-
     # Create a bounding box around the center point. This will be a cube
     #  of length (2 * nearness_radius).
-    min_corner = CartesianPoint3D(center_point_ecef)
-    max_corner = CartesianPoint3D(center_point_ecef)
+    min_corner = CartesianPoint3D(*center_point)
+    max_corner = CartesianPoint3D(*center_point)
     for j in range(3):
         min_corner[j] -= buffer
         max_corner[j] += buffer
@@ -247,8 +245,9 @@ def _add_nearby_historical_points(traj_indices_near_all_control_points,
     Arguments:
         traj_indices_near_all_control_points (list): List that contains
             the index for every trajectory that passes by the given trajectory.
-        control_point (Tracktable point): Point along the trajectory equally-spaced
-            from the previous and next points.
+        control_point (sequence): ECEF (x, y, z) coordinates in km of a
+            point along the trajectory equally-spaced from the previous
+            and next points.
         nearness_radius (float): The inradius, in km, of the cubes
             centered at each control point. Only trajectories within all of
             these cubes will be considered passersby.
@@ -358,13 +357,17 @@ def _find_passersby(trajectory,
 
     traj_indices_near_all_control_points = set()
 
-    for i in range(num_control_points):
-        # Get a point along the trajectory (equally-spaced from the previous and next points).
-        control_point = point_at_length_fraction(trajectory,
-                                                 start_fraction + (end_fraction - start_fraction) * i / (num_control_points - 1))
+    # Get points along the trajectory (equally-spaced from the previous
+    #  and next points) and convert them all to ECEF at once for more
+    #  exact distance calculations.
+    control_points = [point_at_length_fraction(trajectory,
+                                               start_fraction + (end_fraction - start_fraction) * i / (num_control_points - 1))
+                      for i in range(num_control_points)]
+    control_points_ecef = ECEF_from_trajectory(Trajectory.from_position_list(control_points), None)
 
+    for i in range(num_control_points):
         traj_indices_near_all_control_points = _add_nearby_historical_points(traj_indices_near_all_control_points,
-                                                                            control_point,
+                                                                            control_points_ecef[i],
                                                                             nearness_radius,
                                                                             point_idx_to_traj_idx,
                                                                             num_historical_trajs,
@@ -497,20 +500,16 @@ def create_points_list_and_lookup(trajectories, create_lookup=True):
 
     logger.debug('Create List of Points')
 
-    points = []
-    point_idx_to_traj_idx = {}
-    #for traj_index, trajectory in enumerate(trajectories):
-    for traj_index, trajectory in tqdm(enumerate(trajectories),
-                                       total=len(trajectories)):
-        for point in trajectory:
-            # Convert this point to ECEF for more exact distance calculations.
-            point.set_property("altitude", 0)
-            converted_point = ECEF_from_feet(point, "altitude")
-            # Append each point with its trajectory index to our points list.
-            points.append((converted_point[0], converted_point[1], converted_point[2], traj_index))
-            if create_lookup:
-                # Create a dictionary for reverse-lookup of trajectory index.
-                point_idx_to_traj_idx[len(points)-1] = traj_index
+    # Convert all the points to ECEF (at altitude 0) for more exact
+    # distance calculations.
+    coordinates, trajectory_index = ECEF_from_trajectories(trajectories, None)
+    trajectory_index = trajectory_index.tolist()
+    # Append each point with its trajectory index to our points list.
+    points = [(x, y, z, traj_index)
+              for ((x, y, z), traj_index) in zip(coordinates.tolist(), trajectory_index)]
+    if create_lookup:
+        # Create a dictionary for reverse-lookup of trajectory index.
+        point_idx_to_traj_idx = dict(enumerate(trajectory_index))
 
     if create_lookup:
         return points, point_idx_to_traj_idx
@@ -573,10 +572,9 @@ def traj_reader_to_rtree(reader):
 
     points_rtree = RTree()
     for traj_index, trajectory in enumerate(tqdm(reader)):
-        for point in trajectory:
-            # Convert this point to ECEF for more exact distance calculations.
-            point.set_property("altitude", 0)
-            ecef_point = ECEF_from_feet(point, "altitude")
+        # Convert the points to ECEF (at altitude 0) for more exact
+        # distance calculations.
+        for ecef_point in ECEF_from_trajectory(trajectory, None).tolist():
             # Add the point (and its trajectory index) to our r-tree.
             points_rtree.insert_point(convert_to_feature_vector([ecef_point[0],
                                                                  ecef_point[1],
@@ -600,10 +598,9 @@ def trajectories_to_rtree_ram_limited(trajectories):
 
     points_rtree = RTree()
     for traj_index, trajectory in enumerate(tqdm(trajectories)):
-        for point in trajectory:
-            # Convert this point to ECEF for more exact distance calculations.
-            point.set_property("altitude", 0)
-            ecef_point = ECEF_from_feet(point, "altitude")
+        # Convert the points to ECEF (at altitude 0) for more exact
+        # distance calculations.
+        for ecef_point in ECEF_from_trajectory(trajectory, None).tolist():
             # Add the point (and its trajectory index) to our r-tree.
             points_rtree.insert_point(convert_to_feature_vector([ecef_point[0],
                                                                  ecef_point[1],
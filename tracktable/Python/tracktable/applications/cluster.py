@@ -52,6 +52,7 @@ def cluster_trajectories(trajectories,
                          search_box_span,
                          *args,
                          min_cluster_size=2,
+                         lsh_options=None,
                          **kwargs):
     """Create a cotravel feature vector for each trajectory and use box-DBSCAN
     to cluster the trajectories.
@@ -65,6 +66,10 @@ def cluster_trajectories(trajectories,
     Keyword Arguments:
         min_cluster_size (int): The minimum number of points that you're willing to call a
             cluster. (Default: 2)
+        lsh_options (dict): Run DBSCAN within locality-sensitive hash
+            buckets instead of on all feature vectors at once.  See
+            tracktable.algorithms.dbscan.compute_cluster_labels for the
+            options.  (Default: None)
 
     Returns:
         list of ordered pairs. The first value of each ordered pair corresponds to trajectory index
@@ -82,7 +87,8 @@ def cluster_trajectories(trajectories,
 
     return group_clusters(compute_cluster_labels(feature_vectors,
                                                  search_box_span,
-                                                 min_cluster_size),
+                                                 min_cluster_size,
+                                                 lsh_options=lsh_options),
                                                  trajectories)
 
 
@@ -142,7 +148,9 @@ def cluster_trajectories_rendezvous(trajectories,
 def cluster_trajectories_shape(trajectories,
                                depth=4,
                                epsilon=0.05,
-                               min_cluster_size=2):
+                               min_cluster_size=2,
+                               use_lsh=False,
+                               lsh_options=None):
     """Create a cotravel feature vector for each trajectory and use box-DBSCAN
     to cluster the trajectories.
 
@@ -154,6 +162,14 @@ def cluster_trajectories_shape(trajectories,
         epsilon (float): The epsilon value to generate the search box span. (Default: 0.05)
         min_cluster_size (int): The minimum number of points that you're willing to call a
             cluster. (Default: 2)
+        use_lsh (bool): Split the signatures into locality-sensitive
+            hash buckets and cluster each bucket separately.  Much
+            faster on millions of trajectories, at the cost of
+            occasionally losing a neighbor at a bucket boundary.
+            (Default: False)
+        lsh_options (dict): Options for the LSH buckets; see
+            tracktable.algorithms.dbscan.compute_cluster_labels.
+            Ignored unless use_lsh is True. (Default: None)
 
     Returns:
         list of ordered pairs. The first value of each ordered pair corresponds to trajectory index
@@ -163,10 +179,16 @@ def cluster_trajectories_shape(trajectories,
     """
     search_box_span = [epsilon] * round((depth * (depth + 1) / 2))
 
+    if use_lsh and lsh_options is None:
+        lsh_options = {}
+    elif not use_lsh:
+        lsh_options = None
+
     return cluster_trajectories(trajectories,
                                 distance_geometry_by_distance,
                                 search_box_span,
                                 min_cluster_size=min_cluster_size,
+                                lsh_options=lsh_options,
                                 depth=depth)
 
 def _rendezvous_signature(trajectory,
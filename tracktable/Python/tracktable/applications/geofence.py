@@ -0,0 +1,188 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.applications.geofence - Enter, exit and dwell events for
+points streaming past a set of regions
+"""
+
+from __future__ import division, absolute_import, print_function
+
+import collections
+import datetime
+
+# Importing the core module registers the timestamp converters that
+# the events need
+import tracktable.core
+from tracktable.lib import _geofence
+
+GeofenceEvent = collections.namedtuple(
+    'GeofenceEvent',
+    ['object_id', 'region', 'event_type', 'timestamp', 'longitude', 'latitude', 'point_index'])
+GeofenceEvent.__doc__ = """One change in an object's relationship to a region
+
+Attributes:
+    object_id (str): Object that moved
+    region (int): ID of the region
+    event_type (str): 'enter', 'exit' or 'dwell'
+    timestamp (datetime): When it happened, interpolated between the
+        object's points
+    longitude (float): Where it happened (the boundary crossing for
+        'enter' and 'exit')
+    latitude (float): Where it happened
+    point_index (int): Position of the point that produced the event
+        in the list given to :meth:`GeofenceMonitor.process`
+"""
+
+
+class GeofenceMonitor(object):
+    """Watch many moving objects against many regions
+
+    Regions are boxes or polygons in longitude/latitude (or x/y for
+    2D Cartesian points) with integer IDs of your choosing. Feed
+    points in time order for each object, as they arrive from a
+    reader or assembler, and the monitor reports only the changes:
+
+    - 'enter' and 'exit' at the time and place where the segment
+      between an object's last two points crosses a region boundary,
+      including segments that pass straight through a region
+    - 'enter' at the point itself for regions an object is in when
+      it is first seen or when the region is added
+    - 'dwell' once per visit, the moment an object has been inside a
+      region for :attr:`dwell_time`
+
+    Points older than an object's previous point are ignored. Regions
+    can be added and removed at any time; removing one is silent.
+
+    Example:
+
+    .. code-block:: python
+
+        monitor = GeofenceMonitor()
+        monitor.add_box(1, (-106.8, 34.9), (-106.4, 35.3))
+        monitor.dwell_time = datetime.timedelta(minutes=10)
+        for event in monitor.process(points):
+            print(event.object_id, event.event_type, event.timestamp)
+
+    Attributes:
+        num_threads (int): Threads to use in :meth:`process`. 0 means
+            one per core.
+    """
+
+    def __init__(self):
+        self._monitor = _geofence.GeofenceMonitor()
+
+    def add_box(self, region, min_corner, max_corner):
+        """Add a box region, replacing any region with the same ID
+
+        A box whose min longitude is greater than its max longitude
+        crosses the antimeridian.
+
+        Arguments:
+            region (int): Region ID
+            min_corner (point or tuple): (min longitude, min latitude)
+            max_corner (point or tuple): (max longitude, max latitude)
+        """
+        self._monitor.add_box(region, min_corner[0], min_corner[1], max_corner[0], max_corner[1])
+
+    def add_polygon(self, region, rings):
+        """Add a polygon region, replacing any region with the same ID
+
+        Arguments:
+            region (int): Region ID
+            rings (list): Rings, each a sequence of (longitude,
+                latitude) pairs. Later rings are usually holes.
+        """
+        self._monitor.add_polygon(region, rings)
+
+    def remove_region(self, region):
+        """Remove a region. Returns False if there was no such region."""
+        return self._monitor.remove_region(region)
+
+    def __contains__(self, region):
+        return self._monitor.has_region(region)
+
+    def __len__(self):
+        return self._monitor.num_regions
+
+    @property
+    def dwell_time(self):
+        """How long an object must stay in a region to produce 'dwell'
+
+        A timedelta of 0 (the default) turns dwell events off.
+        """
+        return datetime.timedelta(seconds=self._monitor.dwell_time)
+
+    @dwell_time.setter
+    def dwell_time(self, value):
+        if isinstance(value, datetime.timedelta):
+            value = value.total_seconds()
+        self._monitor.dwell_time = value
+
+    @property
+    def num_threads(self):
+        return self._monitor.num_threads
+
+    @num_threads.setter
+    def num_threads(self, value):
+        self._monitor.num_threads = value
+
+    @property
+    def num_objects(self):
+        """Number of objects being tracked"""
+        return self._monitor.num_objects
+
+    def remove_object(self, object_id):
+        """Forget an object without reporting anything"""
+        self._monitor.remove_object(object_id)
+
+    def regions_containing(self, object_id):
+        """Sorted list of the regions an object is inside right now"""
+        return self._monitor.regions_containing(object_id)
+
+    def update(self, point):
+        """Process a single point
+
+        Returns:
+            List of :class:`GeofenceEvent` in time order
+        """
+        return [GeofenceEvent(**event) for event in
+                self._monitor.update(point.object_id, point[0], point[1], point.timestamp)]
+
+    def process(self, points):
+        """Process a batch of points using several threads
+
+        Arguments:
+            points (iterable): Terrestrial or 2D Cartesian trajectory points
+
+        Returns:
+            List of :class:`GeofenceEvent` in the order of the points
+            that produced them
+        """
+        return [GeofenceEvent(**event) for event in self._monitor.process(points)]
@@ -0,0 +1,141 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.applications.portal_discovery - Find origin/destination portal pairs
+"""
+
+from __future__ import division, absolute_import, print_function
+
+import collections
+
+from tracktable.lib import _portal_discovery
+
+PortalPair = collections.namedtuple(
+    'PortalPair',
+    ['first_portal', 'second_portal', 'value', 'separation', 'contributors'])
+PortalPair.__doc__ = """One origin/destination portal pair
+
+Attributes:
+    first_portal (BoundingBox): Portal with more trajectories passing through it
+    second_portal (BoundingBox): The other end of the pair
+    value (int): Number of trajectories that travel between the portals
+    separation (float): Distance between the portal centers
+    contributors (list of int): Positions of the contributing
+        trajectories in the input list
+"""
+
+_FINDERS = {
+    'terrestrial': _portal_discovery.find_portal_pairs_terrestrial,
+    'cartesian2d': _portal_discovery.find_portal_pairs_cartesian2d
+    }
+
+
+def find_portal_pairs(trajectories,
+                      bounding_box,
+                      x_divisions=12,
+                      y_divisions=5,
+                      depth=5,
+                      subdivisions=2,
+                      minimum_value=16,
+                      minimum_separation=1000,
+                      straightness=1.01,
+                      maximum_pairs=0,
+                      num_threads=0):
+    """Find pairs of regions that many trajectories travel directly between
+
+    The search area is divided into a grid of ``x_divisions`` by
+    ``y_divisions`` cells. Pairs of cells that enough trajectories
+    travel between are refined by dividing each cell into
+    ``subdivisions`` by ``subdivisions`` children, down to ``depth``
+    levels. The best pair is then reported, its trajectories are
+    removed from consideration, and the search repeats until no pair
+    is left with at least ``minimum_value`` trajectories. A best pair
+    whose portals are no more than ``minimum_separation`` apart is not
+    reported, but its trajectories are still removed.
+
+    Each trajectory is binned into the finest grid once, and each
+    level of refinement runs in parallel, so this is practical for
+    very large collections.
+
+    Arguments:
+        trajectories (list): Terrestrial or 2D Cartesian trajectories,
+            all from the same domain
+        bounding_box (BoundingBox): Area to search. The search area
+            must not cross the antimeridian.
+
+    Keyword Arguments:
+        x_divisions (int): Number of first-level cells horizontally (Default: 12)
+        y_divisions (int): Number of first-level cells vertically (Default: 5)
+        depth (int): Number of levels of refinement (Default: 5)
+        subdivisions (int): Children along each axis when a cell is refined (Default: 2)
+        minimum_value (int): Minimum number of trajectories for a pair (Default: 16)
+        minimum_separation (float): Minimum distance between portal
+            centers, in km for terrestrial trajectories and in
+            coordinate units for Cartesian ones (Default: 1000)
+        straightness (float): How much longer than the direct route a
+            contributing path may be (Default: 1.01)
+        maximum_pairs (int): Stop after this many pairs; 0 means no limit (Default: 0)
+        num_threads (int): Number of threads to use; 0 means one per
+            processor (Default: 0)
+
+    Returns:
+        List of :class:`PortalPair`, best first
+
+    Raises:
+        ValueError: The trajectories are not from a supported domain
+    """
+
+    trajectories = list(trajectories)
+    if len(trajectories) == 0:
+        return []
+
+    domain = trajectories[0].domain
+    if domain not in _FINDERS:
+        raise ValueError(
+            'find_portal_pairs: Unsupported domain "{}"'.format(domain))
+
+    pairs = _FINDERS[domain](trajectories,
+                             bounding_box.min_corner,
+                             bounding_box.max_corner,
+                             x_divisions,
+                             y_divisions,
+                             depth,
+                             subdivisions,
+                             minimum_value,
+                             minimum_separation,
+                             straightness,
+                             maximum_pairs,
+                             num_threads)
+
+    return [PortalPair(pair['first_portal'],
+                       pair['second_portal'],
+                       pair['value'],
+                       pair['separation'],
+                       pair['contributors']) for pair in pairs]
@@ -58,7 +58,8 @@ from folium.plugins import HeatMap
 from tqdm import tqdm
 from tracktable.applications.assemble_trajectories import \
     AssembleTrajectoryFromPoints
-from tracktable.core.geomath import (ECEF_from_feet, distance, interpolate,
+from tracktable.core.geomath import (ECEF_from_trajectories,
+                                     ECEF_from_trajectory, distance, interpolate,
                                      km_to_radians, length,
                                      point_at_length_fraction, point_at_time)
 from tracktable.domain.cartesian3d import BasePoint as CartesianPoint3D
@@ -243,27 +244,6 @@ def _pick_observed(trajectories, index=None, fragment_length=100, samples=4,
                                        start_fraction=start_fraction)[1]
     return Trajectory.from_position_list(observed_trajectory)
 
-def _create_feature_vector(point, index):
-    """Creates a feature vector from long, lat, altitude (set to 0) and the
-    trajectory a point belongs to
-
-    Arguments:
-        point (Tracktable point): to make into a feature vector
-        index (int): The index from a list of trajectories that indicates which
-            trajectory the point belongs to
-
-    Returns:
-        a feature vector
-    """
-
-    # altitude is not guaranteed in the data
-    point.set_property('altitude', 0)
-    converted_point = ECEF_from_feet(point, 'altitude')
-    return convert_to_feature_vector([converted_point[0],
-                                      converted_point[1], converted_point[2],
-                                      index])
-
-
 def _create_id_to_index(trajectories):
     """Create a dictionary that maps original_traj_id to its index in trajectories
 
@@ -515,11 +495,13 @@ def process_historical_trajectories(data_file, raw_data=None, separation_time=20
 
     # Set up RTree with all the points we are looking at and which trajectory
     # each point belongs to
-    all_points = []
     logger.info('Begin constructing feature vectors from all points')
-    for i in tqdm(range(0, len(trajectories))):
-        for point in trajectories[i]:
-            all_points.append(_create_feature_vector(point, i))
+    # altitude is not guaranteed in the data so every point goes in at
+    # altitude 0
+    coordinates, trajectory_index = ECEF_from_trajectories(trajectories, None)
+    all_points = [convert_to_feature_vector([x, y, z, i])
+                  for ((x, y, z), i) in tqdm(zip(coordinates.tolist(), trajectory_index.tolist()),
+                                             total=len(trajectory_index))]
     logger.info('Begin constructing RTree')
     tree = RTree(points=tqdm(all_points))
 
@@ -560,13 +542,13 @@ def align(rtree, all_points, trajectories, observed_trajectory, neighbor_distanc
 
     results0 = []
     aligning_trajs = {}
-    for point in tqdm(observed_trajectory):
-        point.set_property('altitude', 0)
-        # convert to ECEF for more exact distance calculations
-        converted_point = ECEF_from_feet(point, 'altitude')
+    # convert to ECEF for more exact distance calculations
+    converted_points = ECEF_from_trajectory(observed_trajectory, None)
+    for (point, converted_point) in tqdm(zip(observed_trajectory, converted_points),
+                                         total=len(observed_trajectory)):
         # create a bounding box of size neighbor_distance around the point
-        min_corner = CartesianPoint3D(converted_point)
-        max_corner = CartesianPoint3D(converted_point)
+        min_corner = CartesianPoint3D(*converted_point)
+        max_corner = CartesianPoint3D(*converted_point)
         for j in range(3):
             min_corner[j] -= neighbor_distance
             max_corner[j] += neighbor_distance
@@ -0,0 +1,93 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Test the Python interface to the geofence monitor.  The C++ test
+# covers crossings, dwell and threading in more detail.
+
+from __future__ import absolute_import, division, print_function
+
+import datetime
+import sys
+
+from tracktable.applications.geofence import GeofenceMonitor
+from tracktable.domain.terrestrial import TrajectoryPoint
+
+
+def make_point(object_id, longitude, latitude, minute):
+    point = TrajectoryPoint(longitude, latitude)
+    point.object_id = object_id
+    point.timestamp = datetime.datetime(2020, 1, 1) + datetime.timedelta(minutes=minute)
+    return point
+
+
+def test_geofence():
+    error_count = 0
+
+    monitor = GeofenceMonitor()
+    monitor.add_box(1, (0, 0), (10, 10))
+    monitor.add_polygon(2, [[(20, 0), (40, 0), (30, 20)]])
+    monitor.dwell_time = datetime.timedelta(minutes=5)
+    if len(monitor) != 2 or 1 not in monitor:
+        print('ERROR: Expected regions 1 and 2')
+        error_count += 1
+
+    points = [make_point('a', -10, 5, 0),
+              make_point('b', 30, 5, 0),
+              make_point('a', 20, 5, 30)]
+    events = monitor.process(points)
+    summary = [(e.object_id, e.region, e.event_type, e.point_index) for e in events]
+    expected = [('b', 2, 'enter', 1),
+                ('a', 1, 'enter', 2),
+                ('a', 1, 'dwell', 2),
+                ('a', 1, 'exit', 2)]
+    if summary != expected:
+        print('ERROR: Expected events {}, got {}'.format(expected, summary))
+        error_count += 1
+    elif events[1].timestamp != datetime.datetime(2020, 1, 1, 0, 10):
+        print('ERROR: Entry should be interpolated to 00:10, got {}'.format(events[1].timestamp))
+        error_count += 1
+
+    events = monitor.update(make_point('b', 30, 6, 10))
+    if len(events) != 1 or events[0].event_type != 'dwell':
+        print('ERROR: Expected a dwell event for b, got {}'.format(events))
+        error_count += 1
+
+    if monitor.regions_containing('b') != [2] or monitor.num_objects != 2:
+        print('ERROR: Object b should be in region 2')
+        error_count += 1
+
+    return error_count
+
+
+def main():
+    return test_geofence()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,109 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Test the Python interface to hierarchical portal discovery.  The
+# C++ test covers the search itself in more detail.
+
+from __future__ import absolute_import, division, print_function
+
+import datetime
+import sys
+
+from tracktable.applications.portal_discovery import find_portal_pairs
+from tracktable.core import geomath
+from tracktable.domain.terrestrial import BoundingBox, Trajectory, TrajectoryPoint
+
+
+def fly(object_id, origin, destination, num_points):
+    trajectory = Trajectory()
+    when = datetime.datetime(2020, 1, 1)
+    start = TrajectoryPoint(*origin)
+    finish = TrajectoryPoint(*destination)
+    for i in range(num_points):
+        point = geomath.interpolate(start, finish, i / (num_points - 1))
+        point.object_id = object_id
+        point.timestamp = when + datetime.timedelta(minutes=i)
+        trajectory.append(point)
+    return trajectory
+
+
+def contains(box, coordinates):
+    return (box.min_corner[0] <= coordinates[0] <= box.max_corner[0] and
+            box.min_corner[1] <= coordinates[1] <= box.max_corner[1])
+
+
+def test_portal_discovery():
+    error_count = 0
+    denver = (-104.7, 39.9)
+    atlanta = (-84.4, 33.6)
+    seattle = (-122.3, 47.4)
+    phoenix = (-112.0, 33.4)
+
+    trajectories = [fly('DEN-ATL-{}'.format(i), denver, atlanta, 50 + i) for i in range(30)]
+    trajectories += [fly('PHX-SEA-{}'.format(i), phoenix, seattle, 40 + i) for i in range(20)]
+
+    pairs = find_portal_pairs(trajectories,
+                              BoundingBox((-125, 25), (-65, 50)),
+                              depth=4,
+                              minimum_value=10,
+                              minimum_separation=100,
+                              num_threads=2)
+
+    if len(pairs) != 2:
+        print('ERROR: Expected 2 portal pairs but found {}'.format(len(pairs)))
+        return error_count + 1
+
+    for (pair, origin, destination, count) in [(pairs[0], denver, atlanta, 30),
+                                               (pairs[1], phoenix, seattle, 20)]:
+        if pair.value != count or len(pair.contributors) != count:
+            print('ERROR: Expected {} trajectories in pair but got {}'.format(count, pair.value))
+            error_count += 1
+        forward = contains(pair.first_portal, origin) and contains(pair.second_portal, destination)
+        backward = contains(pair.first_portal, destination) and contains(pair.second_portal, origin)
+        if not (forward or backward):
+            print('ERROR: Portal pair {} does not connect {} and {}'.format(pair, origin, destination))
+            error_count += 1
+
+    if sorted(pairs[0].contributors) != list(range(30)):
+        print('ERROR: Unexpected contributors to first pair: {}'.format(pairs[0].contributors))
+        error_count += 1
+
+    if find_portal_pairs([], BoundingBox((-125, 25), (-65, 50))) != []:
+        print('ERROR: Empty input should produce no pairs')
+        error_count += 1
+
+    return error_count
+
+
+def main():
+    return test_portal_discovery()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
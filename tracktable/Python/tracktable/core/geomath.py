@@ -39,6 +39,8 @@ from six.moves import range
 import copy
 import math
 
+import numpy
+
 import tracktable.core.log
 
 from tracktable.lib._domain_algorithm_overloads import distance as _distance
@@ -59,6 +61,7 @@ from tracktable.lib._domain_algorithm_overloads import intersects as _intersects
 from tracktable.lib._domain_algorithm_overloads import geometric_median as _geometric_median
 from tracktable.lib._domain_algorithm_overloads import geometric_mean as _geometric_mean
 from tracktable.lib._domain_algorithm_overloads import simplify as _simplify
+from tracktable.lib._domain_algorithm_overloads import simplify_in_time as _simplify_in_time
 from tracktable.lib._domain_algorithm_overloads import convex_hull_perimeter as _convex_hull_perimeter
 from tracktable.lib._domain_algorithm_overloads import convex_hull_area as _convex_hull_area
 from tracktable.lib._domain_algorithm_overloads import convex_hull_aspect_ratio as _convex_hull_aspect_ratio
@@ -67,6 +70,7 @@ from tracktable.lib._domain_algorithm_overloads import radius_of_gyration as _ra
 from tracktable.lib._domain_algorithm_overloads import current_length as _current_length
 from tracktable.lib._domain_algorithm_overloads import current_length_fraction as _current_length_fraction
 from tracktable.lib._domain_algorithm_overloads import current_time_fraction as _current_time_fraction
+from tracktable.lib import _batch_geomath
 
 import logging
 LOGGER = logging.getLogger(__name__)
@@ -896,6 +900,40 @@ def simplify(trajectory, tolerance):
 
 # ----------------------------------------------------------------------
 
+def simplify_in_time(trajectory, tolerance, metric='synchronized', max_window=64):
+    """Time-aware simplification for trajectory
+
+    Unlike simplify(), this function measures error at each point's
+    timestamp, so the simplified trajectory keeps the original's
+    speed. The result is the same as what the C++ trajectory
+    assembler produces when it simplifies trajectories as it builds
+    them.
+
+    With the 'synchronized' metric a point is dropped only if the
+    kept points on either side, interpolated to its timestamp, land
+    within ``tolerance`` of it. This bounds the error of
+    point_at_time() at every original timestamp. The 'dead_reckoning'
+    metric is cheaper: a point is dropped if the velocity at the last
+    kept point predicts it to within ``tolerance``.
+
+    Args:
+       trajectory (Trajectory): Trajectory to simplify
+       tolerance (float): Error tolerance measured in the trajectory's native distance
+       metric (str): 'synchronized' or 'dead_reckoning' (Default: 'synchronized')
+       max_window (int): Largest number of points considered since the
+           last kept point. A point is kept whenever the window is full. (Default: 64)
+
+    Returns:
+       Simplified version of trajectory
+
+    Raises:
+       ValueError: ``metric`` is not one of the supported names
+    """
+
+    return _simplify_in_time(trajectory, tolerance, metric, max_window)
+
+# ----------------------------------------------------------------------
+
 def convex_hull_perimeter(trajectory):
     """Compute the perimeter of the convex hull of a trajectory
 
@@ -1183,3 +1221,258 @@ def ECEF_from_meters(point, altitudeString = "altitude"):
     return point.ECEF_from_meters(altitudeString)
 
 # ----------------------------------------------------------------------
+
+def ECEF_from_trajectory(trajectory, altitudeString="altitude", units="feet"):
+    """Convert every point of a trajectory to ECEF
+
+    This gives the same coordinates as calling ECEF_from_feet() (or
+    ECEF_from_meters()) on each point but converts the whole
+    trajectory in one call.
+
+    Args:
+       trajectory: Terrestrial trajectory to convert
+
+    Keyword Arguments:
+       altitudeString (str): Label of altitude property; None or "" means altitude 0 (Default: "altitude")
+       units (str): 'feet', 'meters' or 'kilometers' (Default: "feet")
+
+    Returns:
+       N x 3 NumPy array of (x, y, z) coordinates in km
+
+    Raises:
+       KeyError: a point has no altitude property
+    """
+
+    (coordinates, _) = ECEF_from_trajectories([trajectory], altitudeString, units, num_threads=1)
+    return coordinates
+
+# ----------------------------------------------------------------------
+
+def ECEF_from_trajectories(trajectories, altitudeString="altitude", units="feet", num_threads=0):
+    """Convert every point of many trajectories to ECEF
+
+    The points of all the trajectories come back in one array, in
+    order, along with the index of the trajectory each point came
+    from.  Trajectories are converted in parallel.
+
+    Args:
+       trajectories: Terrestrial trajectories to convert
+
+    Keyword Arguments:
+       altitudeString (str): Label of altitude property; None or "" means altitude 0 (Default: "altitude")
+       units (str): 'feet', 'meters' or 'kilometers' (Default: "feet")
+       num_threads (int): Number of threads to use; 0 means one per core (Default: 0)
+
+    Returns:
+       Tuple of an N x 3 NumPy array of (x, y, z) coordinates in km
+       and an N-element int64 array of trajectory indices
+
+    Raises:
+       KeyError: a point has no altitude property
+    """
+
+    (coordinates, trajectory_index) = _batch_geomath.ecef_from_trajectories(
+        trajectories, altitudeString or "", units, num_threads)
+    return (numpy.frombuffer(coordinates, dtype=numpy.float64).reshape(-1, 3),
+            numpy.frombuffer(trajectory_index, dtype=numpy.int64))
+
+# ----------------------------------------------------------------------
+#
+# Array versions
+#
+# The functions below compute distances, bearings, speeds and turn
+# angles for whole arrays of points in one call.  Coordinates are
+# N x D float64 arrays with one row per point: (longitude, latitude)
+# for terrestrial points, (x, y) or (x, y, z) for Cartesian points.
+# The domain is named once for the entire array and all of the
+# arithmetic happens in C++, so these are much faster than calling
+# the scalar functions above point by point.  Units are the same as
+# for the scalar functions.
+#
+# ----------------------------------------------------------------------
+
+def distances(hither, yon, domain='terrestrial'):
+    """Distance between corresponding points of two arrays
+
+    Args:
+       hither (N x D array): First set of points
+       yon (N x D array): Second set of points
+
+    Keyword Arguments:
+       domain (str): 'terrestrial', 'cartesian2d' or 'cartesian3d' (Default: 'terrestrial')
+
+    Returns:
+       NumPy array of N distances in domain-specific units
+    """
+
+    from_points = _point_array(hither)
+    to_points = _point_array(yon)
+    result = numpy.empty(from_points.shape[0])
+    _batch_geomath.distances(domain, from_points, to_points, result)
+    return result
+
+# ----------------------------------------------------------------------
+
+def bearings(origin, destination, domain='terrestrial'):
+    """Bearing from each point of one array to the corresponding point of another
+
+    Bearings are in degrees for terrestrial points and radians for
+    Cartesian 2D points, just like bearing().  They are not defined
+    for Cartesian 3D points.
+
+    Args:
+       origin (N x D array): Start points
+       destination (N x D array): End points
+
+    Keyword Arguments:
+       domain (str): 'terrestrial' or 'cartesian2d' (Default: 'terrestrial')
+
+    Returns:
+       NumPy array of N bearings
+    """
+
+    from_points = _point_array(origin)
+    to_points = _point_array(destination)
+    result = numpy.empty(from_points.shape[0])
+    _batch_geomath.bearings(domain, from_points, to_points, result)
+    return result
+
+# ----------------------------------------------------------------------
+
+def segment_lengths(path, domain=None, num_threads=0):
+    """Length of every segment of a path
+
+    The path can be an N x D array of coordinates, a trajectory or a
+    list of trajectories.  For a list the result is a list with one
+    array per trajectory, computed on several threads.
+
+    Args:
+       path (array, Trajectory or list of Trajectory): Points in path order
+
+    Keyword Arguments:
+       domain (str): Domain of a coordinate array; trajectories supply their own (Default: 'terrestrial')
+       num_threads (int): Threads to use for a list of trajectories; 0 means one per core (Default: 0)
+
+    Returns:
+       NumPy array of N-1 lengths, or a list of such arrays
+    """
+
+    return _measure_path('segment_lengths', path, None, domain, num_threads)
+
+# ----------------------------------------------------------------------
+
+def segment_bearings(path, domain=None, num_threads=0):
+    """Bearing along every segment of a path
+
+    See segment_lengths() for the kinds of path accepted.  Bearings
+    are not defined for Cartesian 3D points.
+
+    Args:
+       path (array, Trajectory or list of Trajectory): Points in path order
+
+    Keyword Arguments:
+       domain (str): Domain of a coordinate array; trajectories supply their own (Default: 'terrestrial')
+       num_threads (int): Threads to use for a list of trajectories; 0 means one per core (Default: 0)
+
+    Returns:
+       NumPy array of N-1 bearings, or a list of such arrays
+    """
+
+    return _measure_path('segment_bearings', path, None, domain, num_threads)
+
+# ----------------------------------------------------------------------
+
+def segment_speeds(path, timestamps=None, domain=None, num_threads=0):
+    """Speed along every segment of a path
+
+    Trajectories use their own timestamps.  A coordinate array needs
+    a matching array of timestamps: datetime64 values, datetime
+    objects or plain numbers of seconds.  As in speed_between(),
+    segments that take no time have speed 0.
+
+    Args:
+       path (array, Trajectory or list of Trajectory): Points in path order
+
+    Keyword Arguments:
+       timestamps (array): One timestamp per point of a coordinate array (Default: None)
+       domain (str): Domain of a coordinate array; trajectories supply their own (Default: 'terrestrial')
+       num_threads (int): Threads to use for a list of trajectories; 0 means one per core (Default: 0)
+
+    Returns:
+       NumPy array of N-1 speeds, or a list of such arrays
+
+    Raises:
+       ValueError: a coordinate array was supplied without timestamps
+    """
+
+    return _measure_path('segment_speeds', path, timestamps, domain, num_threads)
+
+# ----------------------------------------------------------------------
+
+def signed_turn_angles(path, domain=None, num_threads=0):
+    """Signed turn angle at every interior point of a path
+
+    Terrestrial turn angles are in degrees with positive values
+    turning clockwise, as in signed_turn_angle().  Cartesian 2D turn
+    angles are the angle in radians between one segment and the next
+    with positive values turning counterclockwise.  Turn angles are
+    not defined for Cartesian 3D points.
+
+    Args:
+       path (array, Trajectory or list of Trajectory): Points in path order
+
+    Keyword Arguments:
+       domain (str): Domain of a coordinate array; trajectories supply their own (Default: 'terrestrial')
+       num_threads (int): Threads to use for a list of trajectories; 0 means one per core (Default: 0)
+
+    Returns:
+       NumPy array of N-2 turn angles, or a list of such arrays
+    """
+
+    return _measure_path('signed_turn_angles', path, None, domain, num_threads)
+
+# ----------------------------------------------------------------------
+
+def _point_array(points):
+    points = numpy.ascontiguousarray(points, dtype=numpy.float64)
+    if points.ndim != 2:
+        raise ValueError('Points must be an N x D array with one row per point')
+    return points
+
+
+def _seconds_array(timestamps):
+    times = numpy.asarray(timestamps)
+    if times.size == 0:
+        return numpy.zeros(0)
+    if times.dtype.kind == 'M':
+        return (times - times[0]).astype('timedelta64[us]').astype(numpy.float64) / 1e6
+    if times.dtype.kind == 'O':
+        start = times[0]
+        return numpy.array([(when - start).total_seconds() for when in times])
+    return numpy.ascontiguousarray(times, dtype=numpy.float64)
+
+
+def _measure_path(measure, path, timestamps, domain, num_threads):
+    if hasattr(path, 'trajectory_id'):
+        return numpy.frombuffer(
+            _batch_geomath.measure_trajectories(path.domain, [path], measure, 1)[0],
+            dtype=numpy.float64)
+
+    if not isinstance(path, numpy.ndarray):
+        path = list(path)
+        if len(path) > 0 and hasattr(path[0], 'trajectory_id'):
+            results = _batch_geomath.measure_trajectories(
+                path[0].domain, path, measure, num_threads)
+            return [numpy.frombuffer(values, dtype=numpy.float64) for values in results]
+
+    if domain is None:
+        domain = 'terrestrial'
+    points = _point_array(path)
+    points_per_value = 3 if measure == 'signed_turn_angles' else 2
+    result = numpy.empty(max(points.shape[0] - points_per_value + 1, 0))
+    if measure == 'segment_speeds':
+        if timestamps is None:
+            raise ValueError('segment_speeds needs timestamps for an array of points')
+        timestamps = _seconds_array(timestamps)
+    _batch_geomath.measure_points(domain, measure, points, timestamps, result)
+    return result
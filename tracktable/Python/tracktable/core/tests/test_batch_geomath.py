@@ -0,0 +1,164 @@
+#
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+
+# This file contains test cases for the array versions of the
+# tracktable.core.geomath functions.  Every array result must match
+# the scalar function applied point by point.
+
+from __future__ import print_function
+
+import datetime
+import math
+import random
+import sys
+
+import numpy
+
+from tracktable.core import geomath
+from tracktable.domain import terrestrial, cartesian2d, cartesian3d
+
+
+def make_trajectory(domain, num_points, step, seed):
+    generator = random.Random(seed)
+    when = datetime.datetime(year=2020, month=1, day=1, hour=0, minute=0, second=0)
+    coordinates = [0.0] * len(domain.BasePoint())
+
+    points = []
+    for i in range(num_points):
+        coordinates = [c + generator.uniform(-step, step) for c in coordinates]
+        point = domain.TrajectoryPoint(*coordinates)
+        point.object_id = 'batch'
+        if i != num_points // 2:
+            when += datetime.timedelta(seconds=generator.randint(1, 120))
+        point.timestamp = when
+        points.append(point)
+    return domain.Trajectory.from_position_list(points)
+
+
+def coordinate_array(trajectory):
+    return numpy.array([[point[d] for d in range(len(point))] for point in trajectory])
+
+
+def compare(label, expected, actual, tolerance=1e-7):
+    if len(expected) != len(actual):
+        print('ERROR: {}: expected {} values but got {}'.format(
+            label, len(expected), len(actual)), file=sys.stderr)
+        return 1
+    for (i, (want, got)) in enumerate(zip(expected, actual)):
+        if math.fabs(want - got) > tolerance * (1 + math.fabs(want)):
+            print('ERROR: {}: value {} should be {} but is {}'.format(
+                label, i, want, got), file=sys.stderr)
+            return 1
+    return 0
+
+
+def test_domain(domain, step, has_angles):
+    name = domain.__name__
+    trajectory = make_trajectory(domain, 200, step, 1234)
+    points = coordinate_array(trajectory)
+    timestamps = [point.timestamp for point in trajectory]
+    trajectory_points = list(trajectory)
+    pairs = list(zip(trajectory_points[:-1], trajectory_points[1:]))
+    error_count = 0
+
+    expected = [geomath.distance(a, b) for (a, b) in pairs]
+    error_count += compare(name + ' segment_lengths',
+                           expected, geomath.segment_lengths(trajectory))
+    error_count += compare(name + ' segment_lengths (array)',
+                           expected, geomath.segment_lengths(points, domain=name))
+    error_count += compare(name + ' distances',
+                           expected, geomath.distances(points[:-1], points[1:], domain=name))
+
+    expected = [geomath.speed_between(a, b) for (a, b) in pairs]
+    error_count += compare(name + ' segment_speeds',
+                           expected, geomath.segment_speeds(trajectory))
+    error_count += compare(name + ' segment_speeds (array)',
+                           expected, geomath.segment_speeds(points, timestamps, domain=name))
+
+    if has_angles:
+        expected = [geomath.bearing(a, b) for (a, b) in pairs]
+        error_count += compare(name + ' segment_bearings',
+                               expected, geomath.segment_bearings(trajectory))
+        error_count += compare(name + ' bearings',
+                               expected, geomath.bearings(points[:-1], points[1:], domain=name))
+        if len(geomath.signed_turn_angles(trajectory)) != len(trajectory) - 2:
+            print('ERROR: {}: wrong number of turn angles'.format(name), file=sys.stderr)
+            error_count += 1
+    else:
+        try:
+            geomath.segment_bearings(trajectory)
+            print('ERROR: {}: bearings should not be defined'.format(name), file=sys.stderr)
+            error_count += 1
+        except ValueError:
+            pass
+
+    return error_count
+
+
+def test_terrestrial_turn_angles():
+    trajectory = make_trajectory(terrestrial, 100, 0.5, 4321)
+    expected = [geomath.signed_turn_angle(trajectory[i], trajectory[i+1], trajectory[i+2])
+                for i in range(len(trajectory) - 2)]
+    return compare('terrestrial signed_turn_angles',
+                   expected, geomath.signed_turn_angles(trajectory), 1e-6)
+
+
+def test_collection():
+    trajectories = [make_trajectory(terrestrial, 50 + i, 0.5, i) for i in range(8)]
+    error_count = 0
+    all_lengths = geomath.segment_lengths(trajectories, num_threads=2)
+    if len(all_lengths) != len(trajectories):
+        print('ERROR: expected one result per trajectory', file=sys.stderr)
+        return 1
+    for (trajectory, lengths) in zip(trajectories, all_lengths):
+        error_count += compare('collection segment_lengths',
+                               geomath.segment_lengths(trajectory), lengths, 0)
+    return error_count
+
+
+def test_datetime64_timestamps():
+    points = numpy.array([[0.0, 0.0], [50.0, 0.0]])
+    timestamps = numpy.array(['2010-01-01T00:00', '2010-01-01T01:00'], dtype='datetime64[s]')
+    return compare('datetime64 timestamps', [5559.7463],
+                   geomath.segment_speeds(points, timestamps), 1e-6)
+
+
+def main():
+    error_count = 0
+    error_count += test_domain(terrestrial, 0.5, True)
+    error_count += test_domain(cartesian2d, 5.0, True)
+    error_count += test_domain(cartesian3d, 5.0, False)
+    error_count += test_terrestrial_turn_angles()
+    error_count += test_collection()
+    error_count += test_datetime64_timestamps()
+    return error_count
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,104 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# This file contains a test case for tracktable.geomath.simplify_in_time.
+#
+from __future__ import print_function
+
+import datetime
+import sys
+
+from tracktable.core import geomath
+from tracktable.domain import cartesian2d
+
+
+def make_trajectory():
+    # Constant speed east for 50 points, then constant speed north
+    # at a different speed for 50 more.
+    trajectory = cartesian2d.Trajectory()
+    start_time = datetime.datetime(2020, 1, 1)
+    x = 0.0
+    y = 0.0
+    for i in range(100):
+        point = cartesian2d.TrajectoryPoint(x, y)
+        point.object_id = 'test'
+        point.timestamp = start_time + datetime.timedelta(seconds=10 * i)
+        trajectory.append(point)
+        if i < 49:
+            x += 1.0
+        else:
+            y += 3.0
+    return trajectory
+
+
+def test_metric(trajectory, metric, tolerance):
+    error_count = 0
+    simplified = geomath.simplify_in_time(trajectory, tolerance, metric=metric)
+
+    if len(simplified) >= len(trajectory) or len(simplified) < 3:
+        print(('ERROR: test_simplify_in_time: {} kept {} of {} points').format(
+            metric, len(simplified), len(trajectory)), file=sys.stderr)
+        error_count += 1
+
+    if simplified[0] != trajectory[0] or simplified[-1] != trajectory[-1]:
+        print('ERROR: test_simplify_in_time: {} did not keep the endpoints'.format(metric),
+              file=sys.stderr)
+        error_count += 1
+
+    if metric == 'synchronized':
+        for point in trajectory:
+            estimate = geomath.point_at_time(simplified, point.timestamp)
+            if geomath.distance(estimate, point) > tolerance + 1e-9:
+                print(('ERROR: test_simplify_in_time: Point at {} is {} away '
+                       'after simplification').format(
+                           point.timestamp, geomath.distance(estimate, point)),
+                      file=sys.stderr)
+                error_count += 1
+                break
+    return error_count
+
+
+def main():
+    error_count = 0
+    trajectory = make_trajectory()
+    error_count += test_metric(trajectory, 'synchronized', 0.5)
+    error_count += test_metric(trajectory, 'dead_reckoning', 0.5)
+
+    try:
+        geomath.simplify_in_time(trajectory, 0.5, metric='douglas_peucker')
+        print('ERROR: test_simplify_in_time: Unknown metric was accepted', file=sys.stderr)
+        error_count += 1
+    except ValueError:
+        pass
+
+    return error_count
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -93,6 +93,34 @@ def run_test():
     expected = CartesianPoint3D(-1497.212, -5006.208, 3645.708)
     error_count += verify_result(actual, expected, "AlbuquerqueFeet");
 
+    print("Testing ECEF_from_trajectories")
+
+    albuquerque.set_property("altitude", 1000)
+    lonlatzero.set_property("altitude", 0)
+    trajectories = [TerrestrialTrajectory.from_position_list([lonlatzero, albuquerque]),
+                    TerrestrialTrajectory.from_position_list([albuquerque])]
+    (coordinates, trajectory_index) = geomath.ECEF_from_trajectories(trajectories, units="meters")
+    if list(trajectory_index) != [0, 0, 1] or coordinates.shape != (3, 3):
+        sys.stderr.write('ERROR: ECEF_from_trajectories returned {} points from trajectories {}.\n'.format(
+            coordinates.shape[0], list(trajectory_index)))
+        error_count += 1
+    else:
+        expected = CartesianPoint3D(-1497.375, -5006.753, 3646.108)
+        error_count += verify_result(CartesianPoint3D(*coordinates[1]), expected, "TrajectoriesMeters")
+        error_count += verify_result(CartesianPoint3D(*coordinates[2]), expected, "TrajectoriesMeters2")
+
+    actual = geomath.ECEF_from_trajectory(trajectories[0], None)
+    error_count += verify_result(CartesianPoint3D(*actual[1]),
+                                 CartesianPoint3D(-1497.14022, -5005.96887, 3645.53304),
+                                 "TrajectoryNoAltitude")
+
+    try:
+        geomath.ECEF_from_trajectory(trajectories[0], "height")
+        sys.stderr.write('ERROR: ECEF_from_trajectory did not notice a missing altitude.\n')
+        error_count += 1
+    except KeyError:
+        pass
+
     if error_count == 0:
         print("Trajectory ECEF passed all tests.")
 
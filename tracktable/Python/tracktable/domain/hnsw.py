@@ -0,0 +1,257 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.domain.hnsw - Approximate nearest neighbors for
+high-dimensional feature vectors.
+
+The R-tree in tracktable.domain.rtree answers nearest-neighbor
+queries exactly but slows to a crawl once feature vectors have more
+than about ten components.  HNSWIndex answers the same queries with a
+graph search whose cost barely depends on dimension, at the price of
+occasionally missing one of the true neighbors.  Raise `ef_search` to
+trade speed for accuracy.
+"""
+
+from __future__ import absolute_import, division, print_function
+
+from tracktable.domain.feature_vectors import convert_to_feature_vector
+from tracktable.lib import _rtree
+
+
+class HNSWIndex(object):
+    """Approximate nearest-neighbor index
+
+    Points are identified by the order in which they were added,
+    starting at 0, just like the R-tree.
+
+    Keyword Args:
+        points (sequence of points): Points to add right away
+        max_neighbors (int): Graph edges per point.  More edges give
+            better accuracy on hard data and use more memory.
+            (Default: 16)
+        ef_construction (int): Candidate list size while building.
+            Larger values build a better graph more slowly.
+            (Default: 200)
+        num_threads (int): Threads to use when adding many points at
+            once.  0 means one per core. (Default: 0)
+    """
+
+    def __init__(self, points=None, max_neighbors=16, ef_construction=200,
+                 num_threads=0):
+        self._index = None
+        self._feature_vector_length = None
+        self._max_neighbors = max_neighbors
+        self._ef_construction = ef_construction
+        self._ef_search = None
+        self.num_threads = num_threads
+
+        if points is not None:
+            self.insert_points(points)
+
+    # ----------------------------------------------------------------------
+
+    def _setup_index(self, dimension):
+        self._feature_vector_length = dimension
+        index_class = getattr(_rtree, 'hnsw_index_{}'.format(dimension))
+        self._index = index_class(self._max_neighbors, self._ef_construction)
+        if self._ef_search is not None:
+            self._index.ef_search = self._ef_search
+
+    def _check_dimension(self, point):
+        if len(point) != self._feature_vector_length:
+            raise ValueError((
+                'Point with {} components cannot be used with an '
+                'index whose points all have {} components.'
+                ).format(
+                    len(point),
+                    self._feature_vector_length
+                ))
+
+    # ----------------------------------------------------------------------
+
+    @property
+    def ef_search(self):
+        """Candidate list size for queries
+
+        Larger values find more of the true nearest neighbors and take
+        longer.  It is never smaller than the number of neighbors
+        requested.
+        """
+
+        if self._index is not None:
+            return self._index.ef_search
+        return self._ef_search if self._ef_search is not None else 50
+
+    @ef_search.setter
+    def ef_search(self, value):
+        self._ef_search = int(value)
+        if self._index is not None:
+            self._index.ef_search = self._ef_search
+
+    # ----------------------------------------------------------------------
+
+    def insert_point(self, point):
+        """Add a single point to the index.
+
+        Arguments:
+            point (array-like or FeatureVector): Point to add.  If this is
+                not the first point added, it must have the same dimension
+                as all previous points.
+
+        Raises:
+            ValueError: The point you have supplied has a different number
+                of components than the points already in the index.
+        """
+
+        if self._index is None:
+            self._setup_index(len(point))
+        else:
+            self._check_dimension(point)
+        self._index.insert_point(convert_to_feature_vector(point))
+
+    # ----------------------------------------------------------------------
+
+    def insert_points(self, points):
+        """Add many points to the index
+
+        The points are linked into the graph using `num_threads`
+        threads.
+
+        Arguments:
+            points (sequence of points): Points to insert
+        """
+
+        new_points = [convert_to_feature_vector(p) for p in points]
+        if len(new_points) == 0:
+            return
+        if self._index is None:
+            self._setup_index(len(new_points[0]))
+        for point in new_points:
+            self._check_dimension(point)
+        self._index.insert_points(new_points, self.num_threads)
+
+    # ----------------------------------------------------------------------
+
+    def find_nearest_neighbors(self, seed_point, num_neighbors, ef=0):
+        """Find points near a search point
+
+        Finds (approximately) the K nearest neighbors to a search point.
+
+        Note:
+            If the search point is already present in the index then
+            it will usually be one of the results returned.
+
+        Args:
+           seed_point (Tracktable point): Point whose neighbors you want to find
+           num_neighbors (int): How many neighbors to find
+
+        Keyword Args:
+           ef (int): Candidate list size for this query.  0 means
+               use `ef_search`. (Default: 0)
+
+        Returns: Indices of the neighbors, nearest first
+        """
+
+        if self._index is None:
+            return []
+        self._check_dimension(seed_point)
+        return self._index.find_nearest_neighbors(
+            convert_to_feature_vector(seed_point), num_neighbors, ef)
+
+    # ----------------------------------------------------------------------
+
+    def batch_find_nearest_neighbors(self, seed_points, num_neighbors, ef=0):
+        """Find points near each of several search points
+
+        The queries run on `num_threads` threads.
+
+        Args:
+           seed_points (sequence of points): Points whose neighbors you want
+           num_neighbors (int): How many neighbors to find for each
+
+        Keyword Args:
+           ef (int): Candidate list size for these queries.  0 means
+               use `ef_search`. (Default: 0)
+
+        Returns: One list of neighbor indices per search point, nearest first
+        """
+
+        queries = [convert_to_feature_vector(p) for p in seed_points]
+        if self._index is None:
+            return [[] for _ in queries]
+        for query in queries:
+            self._check_dimension(query)
+        return self._index.batch_find_nearest_neighbors(
+            queries, num_neighbors, self.num_threads, ef)
+
+    # ----------------------------------------------------------------------
+
+    def save(self, filename):
+        """Write the index to a file
+
+        Args:
+           filename (str): Where to write the index
+        """
+
+        if self._index is None:
+            raise ValueError('Cannot save an empty index.')
+        self._index.save(filename)
+
+    # ----------------------------------------------------------------------
+
+    @classmethod
+    def load(cls, filename, dimension, num_threads=0):
+        """Read an index written by save()
+
+        Args:
+           filename (str): File to read
+           dimension (int): Number of components in the indexed points
+
+        Keyword Args:
+           num_threads (int): Threads to use for later batch operations
+               (Default: 0)
+
+        Returns: New HNSWIndex
+        """
+
+        result = cls(num_threads=num_threads)
+        result._setup_index(dimension)
+        result._index.load(filename)
+        return result
+
+    # ----------------------------------------------------------------------
+
+    def __len__(self):
+        """Return the number of points in the index"""
+
+        if self._index is None:
+            return 0
+        else:
+            return len(self._index)
@@ -0,0 +1,135 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import absolute_import, division, print_function
+
+import os
+import random
+import sys
+import tempfile
+
+from six.moves import range
+from tracktable.domain.hnsw import HNSWIndex
+from tracktable.domain import feature_vectors as fv
+
+
+def random_points(point_type, count, generator):
+    points = []
+    for i in range(count):
+        point = point_type()
+        for d in range(len(point)):
+            point[d] = generator.uniform(-1, 1)
+        points.append(point)
+    return points
+
+
+def exact_neighbors(points, query, num_neighbors):
+    def distance_squared(point):
+        return sum((point[d] - query[d]) ** 2 for d in range(len(query)))
+    order = sorted(range(len(points)), key=lambda i: distance_squared(points[i]))
+    return order[:num_neighbors]
+
+
+def test_line_of_points(point_type):
+    # Same layout as the R-tree test: points at (i, i, ..., i) and a
+    # query at 4.5 whose neighbors are 3, 4, 5 and 6.
+    points = []
+    for i in range(10):
+        point = point_type()
+        for d in range(len(point)):
+            point[d] = i
+        points.append(point)
+
+    sample_point = point_type()
+    for d in range(len(sample_point)):
+        sample_point[d] = 4.5
+
+    index = HNSWIndex(points)
+    neighbors = index.find_nearest_neighbors(sample_point, 4)
+    if set([3, 4, 5, 6]) != set(neighbors):
+        print(("ERROR: Dimension {}: Expected nearby points to have indices "
+               "[3, 4, 5, 6].  Instead we got {}.").format(
+                   len(sample_point), sorted(neighbors)))
+        return 1
+    return 0
+
+
+def test_recall_and_persistence():
+    error_count = 0
+    generator = random.Random(1234)
+    point_type = fv.POINT_TYPES[20]
+    points = random_points(point_type, 2000, generator)
+    queries = random_points(point_type, 20, generator)
+
+    index = HNSWIndex(num_threads=2)
+    index.ef_search = 100
+    index.insert_points(points)
+    if len(index) != len(points):
+        print("ERROR: Index has {} points, expected {}.".format(
+            len(index), len(points)))
+        error_count += 1
+
+    results = index.batch_find_nearest_neighbors(queries, 10)
+    hits = 0
+    for query, found in zip(queries, results):
+        hits += len(set(found) & set(exact_neighbors(points, query, 10)))
+        if found != index.find_nearest_neighbors(query, 10):
+            print("ERROR: Batched and single queries disagree.")
+            error_count += 1
+    recall = hits / (10.0 * len(queries))
+    if recall < 0.9:
+        print("ERROR: Expected recall of at least 0.9, got {}.".format(recall))
+        error_count += 1
+
+    handle, filename = tempfile.mkstemp(suffix='.hnsw')
+    os.close(handle)
+    try:
+        index.save(filename)
+        restored = HNSWIndex.load(filename, 20)
+        if restored.batch_find_nearest_neighbors(queries, 10) != results:
+            print("ERROR: Restored index returned different neighbors.")
+            error_count += 1
+    finally:
+        os.remove(filename)
+
+    return error_count
+
+
+def main():
+    error_count = 0
+
+    for dimension in range(1, 30):
+        error_count += test_line_of_points(fv.POINT_TYPES[dimension])
+    error_count += test_recall_and_persistence()
+
+    return error_count
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,62 @@
+#
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+from __future__ import print_function, division
+import gzip
+import io
+import sys
+
+from tracktable.rw.point import trajectory_point_reader
+
+def test_compressed_point_reader(filename, expected_num_points):
+    print("Attempting to read {} points from gzipped copy of {}.".format(expected_num_points, filename))
+
+    with open(filename, 'rb') as infile:
+        compressed = io.BytesIO(gzip.compress(infile.read()))
+
+    reader = trajectory_point_reader(compressed, delimiter=',')
+    reader.field_delimiter = ','
+    all_points = list(reader)
+
+    error_count = 0
+    if reader.compression != 'gzip':
+        print("ERROR: Expected reader to detect gzip input but it saw {}.".format(reader.compression))
+        error_count += 1
+    if len(all_points) != expected_num_points:
+        print("ERROR: Expected to see {} points but saw {} instead.".format(expected_num_points, len(all_points)))
+        error_count += 1
+    return error_count
+
+
+def main():
+    return test_compressed_point_reader(sys.argv[1], int(sys.argv[2]))
+
+if __name__ == '__main__':
+    sys.exit(main())
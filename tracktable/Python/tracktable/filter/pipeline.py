@@ -0,0 +1,263 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.filter.pipeline - Run many trajectory filters in one pass
+"""
+
+from __future__ import division, absolute_import, print_function
+
+import sys
+
+from tracktable.lib import _trajectory_filter_pipeline
+
+#: Metrics that can be used with :meth:`TrajectoryFilterPipeline.add_range_filter`
+METRICS = (
+    'length',
+    'curvature',
+    'length_ratio',
+    'hull_gyration_ratio',
+    'hull_aspect_ratio',
+    'straight_fraction',
+    'turn_arounds'
+    )
+
+_NATIVE_PIPELINES = {
+    'terrestrial': _trajectory_filter_pipeline.TerrestrialTrajectoryFilterPipeline,
+    'cartesian2d': _trajectory_filter_pipeline.Cartesian2DTrajectoryFilterPipeline
+    }
+
+
+class TrajectoryFilterPipeline(object):
+    """Evaluate a chain of trajectory filters in a single pass
+
+    Each trajectory runs through all of the stages at once. Quantities
+    that several metrics need, such as headings and segment lengths,
+    are computed once per trajectory, and evaluation stops at the
+    first stage that rejects it. Stages built from the metrics in
+    :data:`METRICS`, time windows, bounding boxes and property ranges
+    run in C++ on several threads. Stages built from Python functions
+    run one trajectory at a time, so add them last.
+
+    A time window stage clips trajectories instead of just accepting
+    or rejecting them. Later stages see the clipped trajectory and
+    :meth:`filter` returns the clipped copies.
+
+    Attributes:
+        rejection_counts (list of int): After :meth:`filter`, how many
+            trajectories each stage rejected. A trajectory only counts
+            against the first stage that rejected it.
+
+    Example:
+
+    .. code-block:: python
+
+        pipeline = TrajectoryFilterPipeline()
+        pipeline.add_range_filter('length', minimum=100, maximum=5000)
+        pipeline.add_range_filter('turn_arounds', minimum=10)
+        pipeline.add_predicate(lambda t: t.object_id.startswith('N'))
+        keepers = pipeline.filter(trajectories)
+
+    """
+
+    def __init__(self):
+        """Initialize an empty pipeline that accepts everything."""
+        self._stages = []
+        self.rejection_counts = []
+
+    def add_range_filter(self, metric, minimum=None, maximum=None, name=None):
+        """Keep trajectories whose metric lies in [minimum, maximum]
+
+        Arguments:
+            metric (str): One of the names in :data:`METRICS`
+
+        Keyword Arguments:
+            minimum (float): Smallest acceptable value (Default: no limit)
+            maximum (float): Largest acceptable value (Default: no limit)
+            name (str): Name for this stage (Default: the metric name)
+
+        Raises:
+            ValueError: ``metric`` is not a known metric
+        """
+        if metric not in METRICS:
+            raise ValueError(
+                ('TrajectoryFilterPipeline: Unknown metric "{}". '
+                 'Known metrics are {}.').format(metric, ', '.join(METRICS)))
+        if minimum is None:
+            minimum = -sys.float_info.max
+        if maximum is None:
+            maximum = sys.float_info.max
+        self._stages.append(('range', name or metric, metric, minimum, maximum))
+
+    def add_time_window(self, start_time, end_time, name=None):
+        """Clip trajectories to a time window
+
+        Points outside the window are dropped and new endpoints are
+        interpolated at its edges. Trajectories that lie entirely
+        outside the window are rejected.
+
+        Arguments:
+            start_time (datetime): Beginning of the window
+            end_time (datetime): End of the window
+
+        Keyword Arguments:
+            name (str): Name for this stage (Default: 'time_window')
+
+        Raises:
+            ValueError: Either end of the window is missing
+        """
+        if start_time is None or end_time is None:
+            raise ValueError(
+                ('TrajectoryFilterPipeline: Incomplete time window ({}, {}). '
+                 'Both ends must be set.').format(start_time, end_time))
+        self._stages.append(('time_window', name or 'time_window', start_time, end_time))
+
+    def add_bounding_box_filter(self, box, name=None):
+        """Keep trajectories that touch a bounding box
+
+        No clipping is done: a trajectory with any part inside the box
+        is kept whole.
+
+        Arguments:
+            box: Bounding box with ``min_corner`` and ``max_corner``
+                attributes, or a tuple (min_x, min_y, max_x, max_y)
+
+        Keyword Arguments:
+            name (str): Name for this stage (Default: 'bounding_box')
+        """
+        if hasattr(box, 'min_corner'):
+            corners = (box.min_corner[0], box.min_corner[1],
+                       box.max_corner[0], box.max_corner[1])
+        else:
+            corners = tuple(box)
+        self._stages.append(('box', name or 'bounding_box') + tuple(float(c) for c in corners))
+
+    def add_property_filter(self, property_name, minimum=None, maximum=None, name=None):
+        """Keep trajectories whose numeric point property reaches [minimum, maximum]
+
+        A trajectory passes if any point's value is in the interval or
+        if it has points both below and above the interval. Points
+        without the property are ignored.
+
+        Arguments:
+            property_name (str): Name of a numeric point property
+
+        Keyword Arguments:
+            minimum (float): Bottom of the interval (Default: no limit)
+            maximum (float): Top of the interval (Default: no limit)
+            name (str): Name for this stage (Default: the property name)
+        """
+        if minimum is None:
+            minimum = -sys.float_info.max
+        if maximum is None:
+            maximum = sys.float_info.max
+        self._stages.append(('property', name or property_name, property_name, minimum, maximum))
+
+    def add_predicate(self, predicate, name=None):
+        """Keep trajectories for which a Python function returns True
+
+        Arguments:
+            predicate (callable): Function that takes a trajectory and
+                returns True to keep it.  The trajectory it receives is
+                a copy, so it is safe to keep.
+
+        Keyword Arguments:
+            name (str): Name for this stage (Default: the function's name)
+        """
+        if name is None:
+            name = getattr(predicate, '__name__', 'predicate')
+        self._stages.append(('predicate', name, predicate))
+
+    @property
+    def stage_names(self):
+        """Names of the stages in the order they run"""
+        return [stage[1] for stage in self._stages]
+
+    def evaluate(self, trajectories, num_threads=0):
+        """Find the first stage that rejects each trajectory
+
+        Arguments:
+            trajectories (list): Terrestrial or 2D Cartesian
+                trajectories, all from the same domain
+
+        Keyword Arguments:
+            num_threads (int): Number of threads to use (Default: 0,
+                meaning one per processor)
+
+        Returns:
+            List containing, for each trajectory, the index of the
+            first stage that rejected it or -1 if it passed every stage
+        """
+        trajectories = list(trajectories)
+        if len(trajectories) == 0:
+            return []
+        return self._native_pipeline(trajectories[0].domain).evaluate(trajectories, num_threads)
+
+    def filter(self, trajectories, num_threads=0):
+        """Return the trajectories that pass every stage
+
+        Survivors keep their original order. This also updates
+        ``rejection_counts``.
+
+        Arguments:
+            trajectories (list): Trajectories from a single domain
+
+        Keyword Arguments:
+            num_threads (int): Number of threads to use (Default: 0,
+                meaning one per processor)
+
+        Returns:
+            List of trajectories that passed every stage
+        """
+        trajectories = list(trajectories)
+        if len(trajectories) == 0:
+            self.rejection_counts = [0] * len(self._stages)
+            return []
+        native = self._native_pipeline(trajectories[0].domain)
+        survivors = native.filter(trajectories, num_threads)
+        self.rejection_counts = list(native.rejection_counts())
+        return survivors
+
+    def _native_pipeline(self, domain):
+        if domain not in _NATIVE_PIPELINES:
+            raise ValueError(
+                'TrajectoryFilterPipeline: Unsupported domain "{}"'.format(domain))
+        native = _NATIVE_PIPELINES[domain]()
+        for stage in self._stages:
+            if stage[0] == 'range':
+                native.add_range_filter(stage[1], stage[2], stage[3], stage[4])
+            elif stage[0] == 'time_window':
+                native.add_time_window(stage[1], stage[2], stage[3])
+            elif stage[0] == 'box':
+                native.add_box_filter(stage[1], stage[2], stage[3], stage[4], stage[5])
+            elif stage[0] == 'property':
+                native.add_property_range_filter(stage[1], stage[2], stage[3], stage[4])
+            else:
+                native.add_predicate(stage[1], stage[2])
+        return native
@@ -0,0 +1,211 @@
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+# Test the Python interface to the fused trajectory filter pipeline.
+# The C++ tests cover the metrics themselves in more detail.
+
+from __future__ import absolute_import, division, print_function
+
+import datetime
+import sys
+
+from tracktable.core import geomath
+from tracktable.domain.terrestrial import Trajectory as TerrestrialTrajectory
+from tracktable.domain.terrestrial import \
+    TrajectoryPoint as TerrestrialTrajectoryPoint
+from tracktable.filter.pipeline import TrajectoryFilterPipeline
+from tracktable.filter.trajectory import (ClipToTimeWindow,
+                                          FilterByAltitude,
+                                          FilterByBoundingBox)
+
+
+def make_path(object_id, num_legs, leg_length):
+    """Walk back and forth along the equator in 0.01 degree steps"""
+    trajectory = TerrestrialTrajectory()
+    when = datetime.datetime(2020, 1, 1)
+    longitude = 0
+    step = 0.01
+    for leg in range(num_legs):
+        for i in range(leg_length):
+            point = TerrestrialTrajectoryPoint(longitude, 0)
+            point.object_id = object_id
+            point.timestamp = when
+            trajectory.append(point)
+            longitude += step
+            when += datetime.timedelta(minutes=1)
+        step = -step
+    return trajectory
+
+
+def test_pipeline():
+    error_count = 0
+    trajectories = [make_path('object{}'.format(i), 1 + i % 5, 6 + 2 * (i % 3))
+                    for i in range(60)]
+
+    pipeline = TrajectoryFilterPipeline()
+    pipeline.add_range_filter('length', minimum=8.0)
+    pipeline.add_range_filter('turn_arounds', minimum=2)
+
+    def even_id(trajectory):
+        return int(trajectory.object_id[-1]) % 2 == 0
+
+    pipeline.add_predicate(even_id)
+
+    if pipeline.stage_names != ['length', 'turn_arounds', 'even_id']:
+        print('ERROR: Unexpected stage names {}'.format(pipeline.stage_names))
+        error_count += 1
+
+    expected = []
+    for trajectory in trajectories:
+        # Recompute the length stage in Python to cross-check
+        if geomath.length(trajectory) < 8.0:
+            expected.append(0)
+        else:
+            expected.append(None)
+
+    outcome = pipeline.evaluate(trajectories, 4)
+    for (i, (actual, wanted)) in enumerate(zip(outcome, expected)):
+        if wanted == 0 and actual != 0:
+            print('ERROR: Trajectory {} should fail the length stage but got {}'.format(i, actual))
+            error_count += 1
+        if wanted is None and actual == 0:
+            print('ERROR: Trajectory {} should pass the length stage'.format(i))
+            error_count += 1
+
+    survivors = pipeline.filter(trajectories, 4)
+    if len(survivors) != outcome.count(-1) or len(survivors) == 0:
+        print('ERROR: Expected {} survivors but got {}'.format(outcome.count(-1), len(survivors)))
+        error_count += 1
+    if sum(pipeline.rejection_counts) + len(survivors) != len(trajectories):
+        print('ERROR: Rejection counts {} do not add up'.format(pipeline.rejection_counts))
+        error_count += 1
+    for trajectory in survivors:
+        if not even_id(trajectory):
+            print('ERROR: Trajectory {} should have been removed by the predicate'.format(trajectory.object_id))
+            error_count += 1
+
+    # Native-only pipelines run in parallel and must agree with a single thread
+    native_only = TrajectoryFilterPipeline()
+    native_only.add_range_filter('length', minimum=8.0)
+    native_only.add_range_filter('straight_fraction', maximum=0.5)
+    if native_only.evaluate(trajectories, 1) != native_only.evaluate(trajectories, 4):
+        print('ERROR: Parallel and serial evaluation disagree')
+        error_count += 1
+
+    try:
+        native_only.add_range_filter('no_such_metric', minimum=1)
+        print('ERROR: Unknown metric was accepted')
+        error_count += 1
+    except ValueError:
+        pass
+
+    return error_count
+
+
+def make_climbing_paths():
+    """Straight paths with rising altitude; odd ones lie at 10 degrees north"""
+    trajectories = []
+    for i in range(20):
+        trajectory = TerrestrialTrajectory()
+        when = datetime.datetime(2020, 1, 1)
+        for j in range(20):
+            point = TerrestrialTrajectoryPoint(0.01 * j, 10 * (i % 2))
+            point.object_id = 'object{}'.format(i)
+            point.timestamp = when
+            point.properties['altitude'] = 100.0 * (i + j)
+            trajectory.append(point)
+            when += datetime.timedelta(minutes=1)
+        trajectories.append(trajectory)
+    return trajectories
+
+
+def test_native_stages():
+    error_count = 0
+    trajectories = make_climbing_paths()
+    start = datetime.datetime(2020, 1, 1, 0, 5)
+    finish = datetime.datetime(2020, 1, 1, 0, 10, 30)
+
+    pipeline = TrajectoryFilterPipeline()
+    pipeline.add_bounding_box_filter((-1, -1, 1, 1))
+    pipeline.add_time_window(start, finish)
+    pipeline.add_property_filter('altitude', 0, 1800)
+
+    # Even paths with 100 * (i + 5) <= 1800, i.e. i <= 13
+    survivors = pipeline.filter(trajectories, 2)
+    if [t.object_id for t in survivors] != ['object{}'.format(i) for i in range(0, 14, 2)]:
+        print('ERROR: Unexpected survivors {}'.format([t.object_id for t in survivors]))
+        error_count += 1
+    for trajectory in survivors:
+        if trajectory[0].timestamp != start or trajectory[-1].timestamp != finish:
+            print('ERROR: Trajectory {} was not clipped'.format(trajectory.object_id))
+            error_count += 1
+    if len(trajectories[0]) != 20:
+        print('ERROR: Clipping changed the input trajectory')
+        error_count += 1
+    if pipeline.rejection_counts != [10, 0, 3]:
+        print('ERROR: Unexpected rejection counts {}'.format(pipeline.rejection_counts))
+        error_count += 1
+
+    # The classic filter objects chain into the same pipeline
+    box_filter = FilterByBoundingBox()
+    box_filter.input = iter(trajectories)
+    box_filter.box = (-1, -1, 1, 1)
+    clipper = ClipToTimeWindow()
+    clipper.input = box_filter.trajectories()
+    clipper.start_time = start
+    clipper.end_time = finish
+    altitude_filter = FilterByAltitude()
+    altitude_filter.input = clipper.trajectories()
+    altitude_filter.min_altitude = 0
+    altitude_filter.max_altitude = 1800
+    altitude_filter.batch_size = 3
+
+    chained = list(altitude_filter.trajectories())
+    if [t.object_id for t in chained] != [t.object_id for t in survivors]:
+        print('ERROR: Chained filters kept {}'.format([t.object_id for t in chained]))
+        error_count += 1
+
+    clipper = ClipToTimeWindow()
+    clipper.input = trajectories
+    try:
+        list(clipper.trajectories())
+        print('ERROR: Incomplete time window was accepted')
+        error_count += 1
+    except ValueError:
+        pass
+
+    return error_count
+
+
+def main():
+    return test_pipeline() + test_native_stages()
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -28,17 +28,97 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 """tracktable.filter.trajectory - Filters that take trajectories as input
+
+ClipToTimeWindow, FilterByBoundingBox and FilterByAltitude run in C++
+through :class:`tracktable.filter.pipeline.TrajectoryFilterPipeline`.
+Input is read in batches and each batch is filtered on several
+threads. When one of these filters reads from another's
+``trajectories()``, the two run as a single pipeline so that each
+trajectory is only handed to C++ once.
 """
 
 import logging
 
 from shapely.geometry import Polygon
-from tracktable.core.geomath import (compute_bounding_box, intersects,
-                                     subset_during_interval)
+from tracktable.core.geomath import compute_bounding_box
+from tracktable.filter.pipeline import TrajectoryFilterPipeline
 
 logger = logging.getLogger(__name__)
 
-class ClipToTimeWindow(object):
+
+class _FilteredTrajectories(object):
+    """Iterator over the output of a pipeline-backed filter
+
+    This behaves like the generator that ``trajectories()`` used to
+    return. A downstream pipeline-backed filter that reads from it
+    takes over its stages instead of iterating over it.
+    """
+
+    def __init__(self, source_filter):
+        self.source_filter = source_filter
+        self._generator = None
+
+    def __iter__(self):
+        return self
+
+    def __next__(self):
+        if self._generator is None:
+            self._generator = self.source_filter._run()
+        return next(self._generator)
+
+    next = __next__
+
+
+class _PipelineFilter(object):
+    """Base class for filters that run in a native pipeline
+
+    Subclasses implement ``_add_stages(pipeline)``.
+
+    Attributes:
+       batch_size (int): Number of trajectories filtered at once
+    """
+
+    batch_size = 4096
+
+    def trajectories(self):
+        """Return the trajectories that pass this filter
+
+        Note:
+            This is an iterator, so you can only traverse the sequence
+            once unless you collect it in a list yourself.
+        """
+        return _FilteredTrajectories(self)
+
+    def _run(self):
+        # Walk up the chain of pipeline-backed filters to the real source
+        chain = [self]
+        source = self.input
+        while isinstance(source, _FilteredTrajectories) and source._generator is None:
+            chain.append(source.source_filter)
+            source = source.source_filter.input
+
+        pipeline = TrajectoryFilterPipeline()
+        for trajectory_filter in reversed(chain):
+            trajectory_filter._add_stages(pipeline)
+
+        batch = []
+        for trajectory in source:
+            batch.append(trajectory)
+            if len(batch) >= self.batch_size:
+                for survivor in pipeline.filter(batch):
+                    yield survivor
+                batch = []
+        if batch:
+            for survivor in pipeline.filter(batch):
+                yield survivor
+
+    def _add_stages(self, pipeline):
+        raise NotImplementedError()
+
+
+# ----------------------------------------------------------------------
+
+class ClipToTimeWindow(_PipelineFilter):
     """Truncate trajectories to fit within a time window
 
     Given an iterable of Trajectory objects, return those portions of
@@ -71,27 +151,24 @@ class ClipToTimeWindow(object):
              self.start_time and self.end_time. If one of the input
              trajectories extends beyond that boundary, a new endpoint will
              be interpolated so that it begins or ends precisely at the
-             boundary. Trajectories entirely outside the boundary will be
-             returned as empty trajectories with 0 points.
+             boundary. Trajectories entirely outside the boundary are
+             dropped.
         """
+        return super(ClipToTimeWindow, self).trajectories()
 
+    def _add_stages(self, pipeline):
         if (self.input is None):
             raise ValueError("ClipToTimeWindow: No input source!  Set 'input' to a valid trajectory source.")
 
         if self.start_time is None or self.end_time is None:
             raise ValueError("ClipToTimeWindow: Incomplete time window!  You must set both 'start_time' and 'end_time'. The current time window is ({}, {}).".format(self.start_time, self.end_time))
 
-        for trajectory in self.input:
-            subset = subset_during_interval(trajectory,
-                self.start_time,
-                self.end_time)
-            if len(subset) > 0:
-                yield(subset)
+        pipeline.add_time_window(self.start_time, self.end_time)
 
 
 # ----------------------------------------------------------------------
 
-class FilterByBoundingBox(object):
+class FilterByBoundingBox(_PipelineFilter):
     """FilterByBoundingBox: Eliminate trajectories that don't intersect a given box
 
     Given a source that produces Trajectories, return only those
@@ -101,7 +178,8 @@ class FilterByBoundingBox(object):
 
     Attributes:
       input (iterable): Sequence of Trajectory objects
-      box (tuple): Bounding box
+      box: Bounding box with min_corner and max_corner, or a tuple
+        (min_x, min_y, max_x, max_y)
     """
 
     def __init__(self):
@@ -116,25 +194,24 @@ class FilterByBoundingBox(object):
         Yields:
           Trajectory objects with at least one point inside the bounding box
         """
+        return super(FilterByBoundingBox, self).trajectories()
 
+    def _add_stages(self, pipeline):
         if self.box is None:
             logger.warning("FilterByBoundingBox: Box is not set.")
-
-        for trajectory in self.input:
-            if self.box is None:
-                yield(trajectory)
-            elif intersects(self.box, trajectory):
-                yield(trajectory)
+        else:
+            pipeline.add_bounding_box_filter(self.box)
 
 
 # ----------------------------------------------------------------------
 
-class FilterByAltitude(object):
+class FilterByAltitude(_PipelineFilter):
     """Filter out trajectories that don't intersect an interval of altitude
 
     Given a source that produces Trajectories, return only those
     trajectories that have at least one point between min_altitude and
-    max_altitude.
+    max_altitude, or points both below and above the interval. Points
+    without an altitude are ignored.
 
     Like FilterByBoundingBox, no clipping will take place. If a
     trajectory crosses the specified interval at all then you will get
@@ -161,27 +238,10 @@ class FilterByAltitude(object):
         Yields:
            Trajectory objects that fall within the altitude region
         """
+        return super(FilterByAltitude, self).trajectories()
 
-        point_below = False
-        point_above = False
-
-        for trajectory in self.input:
-            for point in trajectory:
-                altitude = point.properties['altitude']
-
-                if altitude >= self.min_altitude and altitude <= self.max_altitude:
-                    yield(trajectory)
-                else:
-                    # If the trajectory has points below and above the
-                    # interval then it must by definition intersect
-                    # the interval.
-                    if altitude < self.min_altitude:
-                        point_below = True
-                    if altitude > self.max_altitude:
-                        point_above = True
-
-                    if point_below and point_above:
-                        yield(trajectory)
+    def _add_stages(self, pipeline):
+        pipeline.add_property_filter('altitude', self.min_altitude, self.max_altitude)
 
 class FilterByPolygon(object):
 
@@ -37,8 +37,7 @@ import os.path
 from csv import DictReader
 from tracktable_data.data import retrieve
 
-from tracktable.core.geomath import intersects
-from tracktable.domain.terrestrial import TrajectoryPoint
+from tracktable.info.gazetteer import cached_gazetteer, source_key
 
 class Airport(object):
     """Information about a single airport
@@ -84,12 +83,13 @@ def build_airport_dict():
       Airport data will be loaded if not already in memory
     """
 
-    global AIRPORT_DICT
+    global AIRPORT_DICT, AIRPORT_LIST
 
     if len(AIRPORT_DICT) > 0:
         return # we've already built it
     else:
         AIRPORT_DICT = dict()
+        AIRPORT_LIST = []
 
         openflight_field_names = [ 'numeric_id',
                                    'name',
@@ -124,6 +124,7 @@ def build_airport_dict():
                                      float(row['altitude']) )
                 airport.utc_offset = float(row['utc_offset'])
                 airport.daylight_savings = row['daylight_savings']
+                AIRPORT_LIST.append(airport)
 
                 if len(airport.iata_code) == 0:
                     airport.iata_code = None
@@ -215,21 +216,76 @@ def all_airports_within_bounding_box(bounding_box):
     Dictionary of airports from the given bounding box.
   """
 
-  global AIRPORT_DICT
-
-  if len(AIRPORT_DICT) == 0:
-      build_airport_dict()
+  min_corner = bounding_box.min_corner
+  max_corner = bounding_box.max_corner
+  rows = airport_gazetteer().ids_in_box(min_corner[0], min_corner[1],
+                                        max_corner[0], max_corner[1])
 
   airports = {}
-  for airport_name, airport in AIRPORT_DICT.items():
-    if intersects(TrajectoryPoint(airport.position[0], airport.position[1]), bounding_box):
-      airports[airport_name] = airport
+  for row in rows:
+    airport = AIRPORT_LIST[row]
+    for code in (airport.iata_code, airport.icao_code):
+      if code is not None and AIRPORT_DICT.get(code) is airport:
+        airports[code] = airport
 
   return airports
 
 # ----------------------------------------------------------------------
 
+def airport_gazetteer():
+  """Return the spatial index over all airports
+
+  IDs in the index are positions in AIRPORT_LIST.  The index is
+  cached on disk; see tracktable.info.gazetteer.
+
+  Returns:
+    tracktable.info.gazetteer.Gazetteer
+  """
+
+  global AIRPORT_GAZETTEER
+
+  if len(AIRPORT_DICT) == 0:
+    build_airport_dict()
+
+  if AIRPORT_GAZETTEER is None:
+    AIRPORT_GAZETTEER = cached_gazetteer(
+      'airports',
+      source_key(retrieve('airports.csv')),
+      lambda: ([airport.position[0] for airport in AIRPORT_LIST],
+               [airport.position[1] for airport in AIRPORT_LIST])
+      )
+  return AIRPORT_GAZETTEER
+
+# ----------------------------------------------------------------------
+
+def nearest_airports(longitudes, latitudes, k=1, max_distance=float('inf')):
+  """Find the airports nearest to many positions at once
+
+  Args:
+    longitudes (array-like): Query longitudes
+    latitudes (array-like): Query latitudes
+
+  Keyword Args:
+    k (int): Airports to find per position (Default: 1)
+    max_distance (float): Ignore airports farther away than this many
+      km (Default: no limit)
+
+  Returns:
+    (airports, distances): airports is a list with one list of up to
+    k Airport objects per position, nearest first.  distances is a
+    NumPy array of shape (N, k) in km; unused entries are infinity.
+  """
+
+  ids, distances = airport_gazetteer().nearest(longitudes, latitudes, k, max_distance)
+  airports = [[AIRPORT_LIST[row] for row in query_ids if row >= 0]
+              for query_ids in ids]
+  return airports, distances
+
+# ----------------------------------------------------------------------
+
 AIRPORT_DICT = {}
+AIRPORT_LIST = []
+AIRPORT_GAZETTEER = None
 
 # This information comes from Wikipedia:
 #
@@ -35,6 +35,7 @@ from shapely.geometry import Polygon, shape
 from tracktable.core.conversions import km_to_radians
 from tracktable.core.geomath import intersects
 from tracktable.domain.terrestrial import BoundingBox
+from tracktable.info.polygon_layer import PolygonLayer
 from tracktable_data.data import retrieve
 
 logger = logging.getLogger(__name__)
@@ -284,4 +285,43 @@ def buffer(points, buffer=10):
 
 # ----------------------------------------------------------------------
 
+def border_layer(resolution="low", level="L1"):
+  """Return a PolygonLayer holding every border at a level and resolution
+
+  Borders are lines, so the layer answers distance-to-border and
+  border-crossing questions; nothing is ever inside it.  The layer
+  is built on first use and kept.
+
+  For example, to count how many times each trajectory crosses a
+  national border:
+
+    crossings = border_layer().trajectory_crossings(trajectories)
+
+  Keyword Arguments:
+    resolution (string): Resolution of the shapes to pull from the shapefile. (Default: "low")
+    level (string): See the docstring for build_border_dict() for more information about levels. (Default: "L1")
+
+  Returns:
+    PolygonLayer object
+
+  Raises:
+    ValueError: Unknown resolution or level
+  """
+
+  global BORDER_LAYER
+
+  key = (resolution.lower(), level.upper())
+  if key not in BORDER_LAYER:
+    layer = PolygonLayer()
+    borders = all_borders(resolution=resolution, level=level)
+    for border in borders:
+      layer.add_geometry(border.geojson)
+    layer.build()
+    BORDER_LAYER = { key: layer }
+
+  return BORDER_LAYER[key]
+
+# ----------------------------------------------------------------------
+
 BORDER_DICT = {}
+BORDER_LAYER = {}
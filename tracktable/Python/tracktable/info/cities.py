@@ -88,13 +88,17 @@ cities.py - Locations and population values for many cities of the world
 # IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 from __future__ import print_function, absolute_import, division
+import importlib.util
 import logging
 from math import inf
 
 from tracktable.core.geomath import latitude, longitude, distance
 from tracktable.domain.terrestrial import TrajectoryPoint, BasePoint
+from tracktable.info.gazetteer import cached_gazetteer, source_key
 CITY_TABLE = None
 CITY_HEADERS = None
+CITY_GAZETTEER = None
+CITY_TABLE_MODULE = 'tracktable_data.python_info_data.city_table'
 
 # ----------------------------------------------------------------------
 
@@ -132,12 +136,13 @@ def cities_in_bbox(bbox_min=(-180, -90),
 
     Returns:
       List of CityInfo objects.
-    """
 
-    global CITY_TABLE
-    if not CITY_TABLE:
-        from tracktable_data.python_info_data.city_table import city_table as cities
-        CITY_TABLE = cities
+    Note:
+      If the longitude of ``bbox_min`` is greater than the longitude of
+      ``bbox_max``, the box is taken to cross the antimeridian: it runs
+      east from ``bbox_min`` through 180 degrees to ``bbox_max``.
+      Earlier versions returned no cities at all for such a box.
+    """
 
     result = []
 
@@ -145,29 +150,16 @@ def cities_in_bbox(bbox_min=(-180, -90),
     logging.debug(logger, ("cities_in_bbox: bbox_min is {}, "
                            "bbox_max is {}".format(bbox_min, bbox_max)))
 
-    logging.debug(
-      logger,
-      ("DEBUG: min_longitude is {}, min_latitude is {}, "
-       "max_longitude is {}, max_latitude is {}").format(
-            longitude(bbox_min),
-            latitude(bbox_min),
-            longitude(bbox_max),
-            latitude(bbox_max)))
-
-    min_longitude = longitude(bbox_min)
-    max_longitude = longitude(bbox_max)
-    min_latitude = latitude(bbox_min)
-    max_latitude = latitude(bbox_max)
-
-    for row in CITY_TABLE:
-        lat = row[3]
-        lon = row[4]
-        if ( lon >= min_longitude and
-             lon <= max_longitude and
-             lat >= min_latitude and
-             lat <= max_latitude and
-             ((not minimum_population) or (row[2] >= minimum_population)) ):
+    # The index returns rows in no particular order.  Sort them so
+    # that results come back in table order as they always have.
+    rows = sorted(city_gazetteer().ids_in_box(longitude(bbox_min),
+                                              latitude(bbox_min),
+                                              longitude(bbox_max),
+                                              latitude(bbox_max)))
 
+    for row_index in rows:
+        row = CITY_TABLE[row_index]
+        if (not minimum_population) or (row[2] >= minimum_population):
             info = CityInfo()
             info.country_code = row[0]
             info.name = row[1]
@@ -178,6 +170,70 @@ def cities_in_bbox(bbox_min=(-180, -90),
 
     return result
 
+# ----------------------------------------------------------------------
+
+def city_gazetteer():
+    """Return the spatial index over all cities
+
+    IDs in the index are row numbers in the city table.  The index is
+    cached on disk; see tracktable.info.gazetteer.
+
+    Returns:
+      tracktable.info.gazetteer.Gazetteer
+    """
+
+    global CITY_TABLE, CITY_GAZETTEER
+    if not CITY_TABLE:
+        from tracktable_data.python_info_data.city_table import city_table as cities
+        CITY_TABLE = cities
+
+    if CITY_GAZETTEER is None:
+        CITY_GAZETTEER = cached_gazetteer(
+            'cities',
+            source_key(importlib.util.find_spec(CITY_TABLE_MODULE).origin),
+            lambda: ([row[4] for row in CITY_TABLE],
+                     [row[3] for row in CITY_TABLE])
+            )
+    return CITY_GAZETTEER
+
+# ----------------------------------------------------------------------
+
+def nearest_cities(longitudes, latitudes, k=1, max_distance=inf):
+    """Find the cities nearest to many positions at once
+
+    Args:
+      longitudes (array-like): Query longitudes
+      latitudes (array-like): Query latitudes
+
+    Keyword Args:
+      k (int): Cities to find per position (Default: 1)
+      max_distance (float): Ignore cities farther away than this many
+        km (Default: no limit)
+
+    Returns:
+      (cities, distances): cities is a list with one list of up to k
+      CityInfo objects per position, nearest first.  distances is a
+      NumPy array of shape (N, k) in km; unused entries are infinity.
+    """
+
+    ids, distances = city_gazetteer().nearest(longitudes, latitudes, k, max_distance)
+    cities = []
+    for query_ids in ids:
+        neighbors = []
+        for row_index in query_ids:
+            if row_index < 0:
+                continue
+            row = CITY_TABLE[row_index]
+            info = CityInfo()
+            info.country_code = row[0]
+            info.name = row[1]
+            info.population = row[2]
+            info.latitude = row[3]
+            info.longitude = row[4]
+            neighbors.append(info)
+        cities.append(neighbors)
+    return cities, distances
+
 
 # ----------------------------------------------------------------------
 
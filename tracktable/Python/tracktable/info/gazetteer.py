@@ -0,0 +1,241 @@
+#
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.info.gazetteer - Fast spatial lookups over airports, ports
+and cities
+
+The lookups in this package used to scan every record in a Python
+loop.  A Gazetteer keeps only the positions of the places in a
+native spatial index and answers nearest-neighbor, great-circle
+radius and bounding-box queries for whole NumPy arrays of positions
+at once, using several threads.  Queries return integer IDs; the
+airports, ports and cities modules use the row number of each place
+in their own tables.
+
+Building the index for a large table takes a moment, so indices are
+cached on disk.  The cache lives in ``$TRACKTABLE_CACHE_DIR`` or, if
+that is not set, in ``~/.cache/tracktable``.  A cached index is
+rebuilt automatically when the file it came from changes.
+"""
+
+import logging
+import os
+import os.path
+
+import numpy
+
+from tracktable.lib import _gazetteer
+
+logger = logging.getLogger(__name__)
+
+
+class Gazetteer(object):
+    """Spatial index over places on the Earth
+
+    Positions are (longitude, latitude) in degrees.  Distances are
+    great-circle distances in kilometers and agree with
+    ``tracktable.core.geomath.distance``.
+
+    Attributes:
+      num_threads (int): Threads to use for batch queries.  0 means
+         one per core.
+    """
+
+    def __init__(self, longitudes=None, latitudes=None, ids=None):
+        """Create a gazetteer, optionally indexing some places
+
+        Keyword Args:
+          longitudes (array-like): Longitude of each place
+          latitudes (array-like): Latitude of each place
+          ids (array-like): Integer ID of each place.  If omitted,
+             places are numbered from 0 in the order given.
+        """
+        self._index = _gazetteer.Gazetteer()
+        if longitudes is not None:
+            self.build(longitudes, latitudes, ids)
+
+    def build(self, longitudes, latitudes, ids=None):
+        """Index a set of places, replacing any that were there before"""
+        if ids is not None:
+            ids = _int64_array(ids)
+        self._index.build(_float64_array(longitudes), _float64_array(latitudes), ids)
+
+    def __len__(self):
+        return len(self._index)
+
+    @property
+    def num_threads(self):
+        return self._index.num_threads
+
+    @num_threads.setter
+    def num_threads(self, value):
+        self._index.num_threads = value
+
+    def nearest(self, longitudes, latitudes, k=1, max_distance=numpy.inf):
+        """Find the k nearest places to each of many positions
+
+        Args:
+          longitudes (array-like): Query longitudes
+          latitudes (array-like): Query latitudes
+
+        Keyword Args:
+          k (int): Places to find per position (Default: 1)
+          max_distance (float): Ignore places farther away than this
+             many km (Default: no limit)
+
+        Returns:
+          (ids, distances): Two arrays of shape (N, k) sorted by
+          distance along each row.  Missing neighbors have ID -1 and
+          distance infinity.
+        """
+        longitudes = _float64_array(longitudes)
+        latitudes = _float64_array(latitudes)
+        ids = numpy.empty((len(longitudes), k), dtype=numpy.int64)
+        distances = numpy.empty((len(longitudes), k), dtype=numpy.float64)
+        self._index.find_nearest_batch(longitudes, latitudes, k, ids, distances, max_distance)
+        return ids, distances
+
+    def within_radius(self, longitudes, latitudes, radius):
+        """Find every place within a distance of each of many positions
+
+        Args:
+          longitudes (array-like): Query longitudes
+          latitudes (array-like): Query latitudes
+          radius (float): Search radius in km
+
+        Returns:
+          (offsets, ids, distances): The matches for position i are
+          ``ids[offsets[i]:offsets[i+1]]`` and the corresponding
+          slice of ``distances``, sorted by distance.
+        """
+        offsets, ids, distances = self._index.find_within_radius_batch(
+            _float64_array(longitudes), _float64_array(latitudes), radius)
+        return (numpy.frombuffer(offsets, dtype=numpy.int64),
+                numpy.frombuffer(ids, dtype=numpy.int64),
+                numpy.frombuffer(distances, dtype=numpy.float64))
+
+    def within_box(self, boxes):
+        """Find the places inside each of many bounding boxes
+
+        Args:
+          boxes (array-like): Array of shape (N, 4) holding min
+             longitude, min latitude, max longitude and max latitude
+             for each box.  A box whose min longitude is greater than
+             its max longitude crosses the antimeridian.
+
+        Returns:
+          (offsets, ids): The places in box i are
+          ``ids[offsets[i]:offsets[i+1]]``, in no particular order.
+        """
+        boxes = _float64_array(boxes).reshape(-1, 4)
+        offsets, ids = self._index.find_within_box_batch(boxes)
+        return (numpy.frombuffer(offsets, dtype=numpy.int64),
+                numpy.frombuffer(ids, dtype=numpy.int64))
+
+    def nearest_one(self, longitude, latitude, k=1, max_distance=numpy.inf):
+        """Find the places nearest a single position
+
+        Returns:
+          List of (id, distance) tuples sorted by distance
+        """
+        return self._index.find_nearest(longitude, latitude, k, max_distance)
+
+    def ids_in_box(self, min_longitude, min_latitude, max_longitude, max_latitude):
+        """Find the places inside a single bounding box
+
+        Returns:
+          List of IDs in no particular order
+        """
+        return self._index.find_within_box(min_longitude, min_latitude,
+                                           max_longitude, max_latitude)
+
+    def save(self, filename, source_key):
+        """Write the index to a cache file.  Returns True on success."""
+        return self._index.save(filename, source_key)
+
+    def load(self, filename, source_key):
+        """Read an index written by save()
+
+        Returns:
+          False if the file is missing, damaged, or was built from
+          data with a different source key.
+        """
+        return self._index.load(filename, source_key)
+
+# ----------------------------------------------------------------------
+
+def cache_directory():
+    """Return the directory that holds cached gazetteer indices"""
+    directory = os.environ.get('TRACKTABLE_CACHE_DIR')
+    if not directory:
+        directory = os.path.join(os.path.expanduser('~'), '.cache', 'tracktable')
+    return directory
+
+def source_key(filename):
+    """Identify a data file by its path, size and modification time"""
+    info = os.stat(filename)
+    return '{}|{}|{}'.format(os.path.abspath(filename), info.st_size, int(info.st_mtime))
+
+def cached_gazetteer(name, key, positions):
+    """Load a gazetteer from the cache or build and cache it
+
+    Args:
+      name (str): Name of the cache file, without directory
+      key (str): Source key for the data (see source_key())
+      positions (callable): Function returning (longitudes,
+         latitudes) for the places.  Place IDs are row numbers.
+         Only called if the cache is missing or stale.
+
+    Returns:
+      Gazetteer object
+    """
+    gazetteer = Gazetteer()
+    cache_file = os.path.join(cache_directory(), name + '.gazetteer')
+    if gazetteer.load(cache_file, key):
+        return gazetteer
+
+    longitudes, latitudes = positions()
+    gazetteer.build(longitudes, latitudes)
+    try:
+        os.makedirs(cache_directory(), exist_ok=True)
+        temporary_file = '{}.{}'.format(cache_file, os.getpid())
+        if gazetteer.save(temporary_file, key):
+            os.replace(temporary_file, cache_file)
+        elif os.path.exists(temporary_file):
+            os.remove(temporary_file)
+    except OSError as e:
+        logger.info("Could not cache gazetteer index in {}: {}".format(cache_file, e))
+    return gazetteer
+
+def _float64_array(values):
+    return numpy.ascontiguousarray(values, dtype=numpy.float64)
+
+def _int64_array(values):
+    return numpy.ascontiguousarray(values, dtype=numpy.int64)
@@ -0,0 +1,203 @@
+#
+# Copyright (c) 2014-2023 National Technology and Engineering
+# Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+# with National Technology and Engineering Solutions of Sandia, LLC,
+# the U.S. Government retains certain rights in this software.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+#    notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+#    notice, this list of conditions and the following disclaimer in the
+#    documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+"""
+tracktable.info.polygon_layer - Fast point-in-polygon, distance to
+boundary and boundary crossing queries against shorelines, borders
+and other large sets of shapes
+
+Testing points one at a time against Shapely polygons is fine for a
+handful of points and a handful of shapes.  It is far too slow to
+ask which of ten million points are over land.  A PolygonLayer puts
+every edge of every shape into one native spatial index, precomputes
+a grid that answers most point-in-polygon questions outright, and
+answers whole NumPy arrays of points at once using several threads.
+
+Coordinates are (longitude, latitude) in degrees.  Areas follow the
+even-odd rule, so holes are just extra rings.
+"""
+
+import numpy
+
+from tracktable.lib import _polygon_layer
+
+
+class PolygonLayer(object):
+    """Spatial index over a fixed set of polygons and lines
+
+    Features are numbered from 0 in the order they are added.  Add
+    every feature, call build(), then query.  Adding a feature after
+    build() means calling build() again.
+
+    Attributes:
+      num_threads (int): Threads to use for batch queries.  0 means
+         one per core.
+    """
+
+    def __init__(self):
+        self._layer = _polygon_layer.PolygonLayer()
+
+    def add_area(self, rings):
+        """Add an area made of one or more rings
+
+        Args:
+          rings (list): Rings, each an array of shape (N, 2) or a
+             sequence of (longitude, latitude) pairs.  Later rings
+             are usually holes in the first.
+
+        Returns:
+          ID of the new feature
+        """
+        rings = list(rings)
+        area = self._layer.add_area(_vertices(rings[0]))
+        for ring in rings[1:]:
+            self._layer.add_ring(area, _vertices(ring))
+        return area
+
+    def add_line(self, vertices):
+        """Add an open polyline such as a border.  Returns its ID."""
+        return self._layer.add_line(_vertices(vertices))
+
+    def add_geometry(self, geometry):
+        """Add a GeoJSON-style geometry dictionary
+
+        Polygons and MultiPolygons become a single area each.
+        LineStrings become a single line; each part of a
+        MultiLineString becomes its own line.
+
+        Returns:
+          List of IDs of the new features
+        """
+        kind = geometry['type']
+        coordinates = geometry['coordinates']
+        if kind == 'Polygon':
+            return [self.add_area(coordinates)]
+        elif kind == 'MultiPolygon':
+            # Parts of a MultiPolygon don't overlap, so under the
+            # even-odd rule they can all be rings of one area
+            rings = [ring for polygon in coordinates for ring in polygon]
+            return [self.add_area(rings)]
+        elif kind == 'LineString':
+            return [self.add_line(coordinates)]
+        elif kind == 'MultiLineString':
+            return [self.add_line(line) for line in coordinates]
+        else:
+            raise ValueError("Unsupported geometry type {}".format(kind))
+
+    def build(self, grid_resolution=1024):
+        """Build the search structures
+
+        Keyword Args:
+          grid_resolution (int): Grid cells along the longer side of
+             the areas' bounding box.  0 disables the grid.
+             (Default: 1024)
+        """
+        self._layer.build(grid_resolution)
+
+    def __len__(self):
+        return self._layer.num_features
+
+    @property
+    def num_threads(self):
+        return self._layer.num_threads
+
+    @num_threads.setter
+    def num_threads(self, value):
+        self._layer.num_threads = value
+
+    def locate(self, longitudes, latitudes):
+        """Find the area containing each of many points
+
+        Returns:
+          Array of area IDs, -1 where a point is not in any area.
+          Where areas overlap, the lowest ID wins.
+        """
+        longitudes = _float64_array(longitudes)
+        latitudes = _float64_array(latitudes)
+        features = numpy.empty(len(longitudes), dtype=numpy.int64)
+        self._layer.locate_batch(longitudes, latitudes, features)
+        return features
+
+    def contains(self, longitudes, latitudes):
+        """Return a boolean array: is each point inside some area?"""
+        return self.locate(longitudes, latitudes) >= 0
+
+    def distance_to_boundary(self, longitudes, latitudes, max_distance=numpy.inf):
+        """Distance from each of many points to the nearest edge
+
+        Distances are in km, measured in a local equirectangular
+        projection around each point.  That is very close to the
+        great-circle distance out to a few hundred km.
+
+        Keyword Args:
+          max_distance (float): Don't look farther than this many km.
+             Points with nothing in range get infinity.
+
+        Returns:
+          Array of distances
+        """
+        longitudes = _float64_array(longitudes)
+        latitudes = _float64_array(latitudes)
+        distances = numpy.empty(len(longitudes), dtype=numpy.float64)
+        self._layer.distance_to_boundary_batch(longitudes, latitudes, distances, max_distance)
+        return distances
+
+    def count_crossings(self, longitude0, latitude0, longitude1, latitude1):
+        """Number of edges crossed by the segment between two points"""
+        return self._layer.count_crossings(longitude0, latitude0, longitude1, latitude1)
+
+    def fraction_inside(self, trajectories):
+        """Fraction of each trajectory's points that are inside some area
+
+        Args:
+          trajectories (iterable): Terrestrial or Cartesian 2D trajectories
+
+        Returns:
+          List with one fraction per trajectory
+        """
+        return self._layer.fraction_inside(trajectories)
+
+    def trajectory_crossings(self, trajectories):
+        """Number of edges each trajectory crosses
+
+        Args:
+          trajectories (iterable): Terrestrial or Cartesian 2D trajectories
+
+        Returns:
+          List with one count per trajectory
+        """
+        return self._layer.count_trajectory_crossings(trajectories)
+
+# ----------------------------------------------------------------------
+
+def _vertices(vertices):
+    return _float64_array(vertices).reshape(-1)
+
+def _float64_array(values):
+    return numpy.ascontiguousarray(values, dtype=numpy.float64)
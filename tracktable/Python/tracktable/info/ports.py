@@ -32,8 +32,7 @@ import operator
 import os
 from csv import DictReader
 
-from tracktable.core.geomath import intersects
-from tracktable.domain.terrestrial import TrajectoryPoint
+from tracktable.info.gazetteer import cached_gazetteer, source_key
 from tracktable_data.data import retrieve
 
 logger = logging.getLogger(__name__)
@@ -84,12 +83,13 @@ def build_port_dict():
     Port data will be loaded if not already in memory
   """
 
-  global PORT_DICT
+  global PORT_DICT, PORT_LIST
 
   if len(PORT_DICT) > 0:
     return # we've already built it
   else:
     PORT_DICT = dict()
+    PORT_LIST = []
 
     with open(retrieve('ports.csv'), mode='r', encoding='utf-8') as infile:
         csvreader = DictReader(infile, delimiter=',', quotechar='"')
@@ -107,6 +107,7 @@ def build_port_dict():
           port.attributes = row
 
           PORT_DICT[port.world_port_index_number] = port
+          PORT_LIST.append(port)
 
         # TODO: If we get decent port traffic stats
         # uncomment this code to sort ports by their traffic
@@ -282,18 +283,72 @@ def all_ports_within_bounding_box(bounding_box):
     Dictionary of ports from the given bounding box.
   """
 
-  global PORT_DICT
+  min_corner = bounding_box.min_corner
+  max_corner = bounding_box.max_corner
+  rows = port_gazetteer().ids_in_box(min_corner[0], min_corner[1],
+                                     max_corner[0], max_corner[1])
+
+  ports = {}
+  for row in rows:
+    port = PORT_LIST[row]
+    if PORT_DICT.get(port.world_port_index_number) is port:
+      ports[port.world_port_index_number] = port
+
+  return ports
+
+# ----------------------------------------------------------------------
+
+def port_gazetteer():
+  """Return the spatial index over all ports
+
+  IDs in the index are positions in PORT_LIST.  The index is cached
+  on disk; see tracktable.info.gazetteer.
+
+  Returns:
+    tracktable.info.gazetteer.Gazetteer
+  """
+
+  global PORT_GAZETTEER
 
   if len(PORT_DICT) == 0:
     build_port_dict()
 
-  ports = {}
-  for port_name, port in PORT_DICT.items():
-    if intersects(TrajectoryPoint(port.position), bounding_box):
-      ports[port_name] = port
+  if PORT_GAZETTEER is None:
+    PORT_GAZETTEER = cached_gazetteer(
+      'ports',
+      source_key(retrieve('ports.csv')),
+      lambda: ([port.position[0] for port in PORT_LIST],
+               [port.position[1] for port in PORT_LIST])
+      )
+  return PORT_GAZETTEER
 
-  return ports
+# ----------------------------------------------------------------------
+
+def nearest_ports(longitudes, latitudes, k=1, max_distance=float('inf')):
+  """Find the ports nearest to many positions at once
+
+  Args:
+    longitudes (array-like): Query longitudes
+    latitudes (array-like): Query latitudes
+
+  Keyword Args:
+    k (int): Ports to find per position (Default: 1)
+    max_distance (float): Ignore ports farther away than this many
+      km (Default: no limit)
+
+  Returns:
+    (ports, distances): ports is a list with one list of up to k Port
+    objects per position, nearest first.  distances is a NumPy array
+    of shape (N, k) in km; unused entries are infinity.
+  """
+
+  ids, distances = port_gazetteer().nearest(longitudes, latitudes, k, max_distance)
+  ports = [[PORT_LIST[row] for row in query_ids if row >= 0]
+           for query_ids in ids]
+  return ports, distances
 
 # ----------------------------------------------------------------------
 
 PORT_DICT = {}
+PORT_LIST = []
+PORT_GAZETTEER = None
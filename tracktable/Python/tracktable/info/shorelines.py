@@ -35,6 +35,7 @@ from shapely.geometry import Polygon, shape
 from tracktable.core.conversions import km_to_radians
 from tracktable.core.geomath import intersects
 from tracktable.domain.terrestrial import BoundingBox
+from tracktable.info.polygon_layer import PolygonLayer
 from tracktable_data.data import retrieve
 
 logger = logging.getLogger(__name__)
@@ -304,4 +305,47 @@ def buffer(points, buffer=10):
 
 # ----------------------------------------------------------------------
 
+def shoreline_layer(resolution="low", level="L1", grid_resolution=1024):
+  """Return a PolygonLayer holding every shoreline at a level and resolution
+
+  The layer answers point-in-polygon, distance-to-shore and
+  shoreline-crossing questions for whole arrays of points or
+  collections of trajectories at once.  Feature IDs in the layer are
+  the shoreline indices used by shoreline_information().  The layer
+  is built on first use and kept.
+
+  For example, to find the fraction of each trajectory's points that
+  are over land:
+
+    land = shoreline_layer()
+    over_land = land.fraction_inside(trajectories)
+
+  Keyword Arguments:
+    resolution (string): Resolution of the shapes to pull from the shapefile. (Default: "low")
+    level (string): See the docstring for build_shoreline_dict() for more information about levels. (Default: "L1")
+    grid_resolution (int): See PolygonLayer.build(). (Default: 1024)
+
+  Returns:
+    PolygonLayer object
+
+  Raises:
+    ValueError: Unknown resolution or level
+  """
+
+  global SHORELINE_LAYER
+
+  key = (resolution.lower(), level.upper(), grid_resolution)
+  if key not in SHORELINE_LAYER:
+    layer = PolygonLayer()
+    shorelines = all_shorelines(resolution=resolution, level=level)
+    for shoreline in shorelines:
+      layer.add_geometry(shoreline.geojson)
+    layer.build(grid_resolution)
+    SHORELINE_LAYER = { key: layer }
+
+  return SHORELINE_LAYER[key]
+
+# ----------------------------------------------------------------------
+
 SHORELINE_DICT = {}
+SHORELINE_LAYER = {}
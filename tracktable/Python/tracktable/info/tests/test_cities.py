@@ -121,8 +121,28 @@ def test_abq_name_only():
 
     return 0
 
+# A box whose minimum longitude is greater than its maximum crosses
+# the antimeridian.  This one covers Fiji.
+def test_bbox_across_antimeridian():
+    found = cities.cities_in_bbox(bbox_min=(170, -20),
+                                  bbox_max=(-170, -10),
+                                  minimum_population=50000)
+
+    if not any(city.name == "Suva" and city.country_code == "fj" for city in found):
+        print("Failed test_bbox_across_antimeridian: Suva not found")
+        return 1
+
+    for city in found:
+        if (-170 < city.longitude < 170) or not (-20 <= city.latitude <= -10):
+            print("Failed test_bbox_across_antimeridian: {} at ({}, {}) "
+                  "is outside the box".format(city.name, city.longitude, city.latitude))
+            return 1
+
+    return 0
+
 def main():
     error_count = 0
+    error_count += test_bbox_across_antimeridian()
     error_count += test_abq_name_only()
     error_count += test_abq_with_country()
     error_count += test_abq_with_tuple()
@@ -0,0 +1,105 @@
+# Copyright (c) 2014-2023, National Technology & Engineering Solutions of
+#   Sandia, LLC (NTESS).
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+import sys
+
+import os
+import sys
+import tempfile
+
+import numpy
+
+from tracktable.core.geomath import distance
+from tracktable.domain.terrestrial import BasePoint
+from tracktable.info import airports, gazetteer
+
+def brute_force_nearest(longitudes, latitudes, lon, lat, k):
+    query = BasePoint(lon, lat)
+    distances = [distance(BasePoint(x, y), query) for (x, y) in zip(longitudes, latitudes)]
+    return sorted(distances)[0:k]
+
+def test_queries():
+    rng = numpy.random.default_rng(42)
+    longitudes = rng.uniform(-180, 180, 2000)
+    latitudes = numpy.degrees(numpy.arcsin(rng.uniform(-1, 1, 2000)))
+    index = gazetteer.Gazetteer(longitudes, latitudes)
+    assert len(index) == 2000
+
+    query_lons = numpy.array([-106.6, 179.9, 0.0, -45.0])
+    query_lats = numpy.array([35.0, -16.5, 89.9, -60.0])
+    ids, distances = index.nearest(query_lons, query_lats, k=4)
+    assert ids.shape == (4, 4)
+    for i in range(len(query_lons)):
+        expected = brute_force_nearest(longitudes, latitudes, query_lons[i], query_lats[i], 4)
+        assert numpy.allclose(distances[i], expected, atol=1e-6)
+
+    offsets, within_ids, within_distances = index.within_radius(query_lons, query_lats, 500)
+    assert len(offsets) == len(query_lons) + 1
+    assert numpy.all(within_distances <= 500)
+
+    # A box that crosses the antimeridian
+    offsets, box_ids = index.within_box([[170, -30, -170, 30]])
+    for place in box_ids:
+        assert abs(latitudes[place]) <= 30
+        assert longitudes[place] >= 170 or longitudes[place] <= -170
+
+def test_cache():
+    rng = numpy.random.default_rng(7)
+    longitudes = rng.uniform(-180, 180, 500)
+    latitudes = rng.uniform(-80, 80, 500)
+    built = []
+
+    def positions():
+        built.append(True)
+        return longitudes, latitudes
+
+    with tempfile.TemporaryDirectory() as cache_dir:
+        os.environ['TRACKTABLE_CACHE_DIR'] = cache_dir
+        try:
+            first = gazetteer.cached_gazetteer('test', 'key 1', positions)
+            second = gazetteer.cached_gazetteer('test', 'key 1', positions)
+            third = gazetteer.cached_gazetteer('test', 'key 2', positions)
+        finally:
+            del os.environ['TRACKTABLE_CACHE_DIR']
+
+    assert len(built) == 2
+    assert first.nearest_one(10, 10, 5) == second.nearest_one(10, 10, 5)
+    assert len(third) == 500
+
+def test_airports():
+    nearest, distances = airports.nearest_airports([-106.609], [35.040], k=1)
+    assert nearest[0][0].iata_code == 'ABQ'
+    assert distances[0][0] < 5
+
+def main():
+    test_queries()
+    test_cache()
+    test_airports()
+
+if __name__ == '__main__':
+    sys.exit(main())
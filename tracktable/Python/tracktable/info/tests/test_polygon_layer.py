@@ -0,0 +1,83 @@
+# Copyright (c) 2014-2023, National Technology & Engineering Solutions of
+#   Sandia, LLC (NTESS).
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+# 1. Redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer.
+#
+# 2. Redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+# FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+# COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+# INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+# LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+# CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+# LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+# ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+
+import sys
+
+import numpy
+
+from tracktable.domain.terrestrial import Trajectory, TrajectoryPoint
+from tracktable.info.polygon_layer import PolygonLayer
+
+def make_layer():
+    # A 10x10 box with a 2x2 hole in the middle and a border along 30E
+    layer = PolygonLayer()
+    box = [(0, 0), (10, 0), (10, 10), (0, 10)]
+    hole = [(4, 4), (6, 4), (6, 6), (4, 6)]
+    assert layer.add_area([box, hole]) == 0
+    assert layer.add_geometry({'type': 'LineString', 'coordinates': [[30, -20], [30, 20]]}) == [1]
+    layer.build()
+    return layer
+
+def test_points():
+    layer = make_layer()
+    assert len(layer) == 2
+
+    rng = numpy.random.default_rng(3)
+    longitudes = rng.uniform(-5, 15, 5000)
+    latitudes = rng.uniform(-5, 15, 5000)
+    in_box = (longitudes > 0) & (longitudes < 10) & (latitudes > 0) & (latitudes < 10)
+    in_hole = (longitudes > 4) & (longitudes < 6) & (latitudes > 4) & (latitudes < 6)
+    expected = numpy.where(in_box & ~in_hole, 0, -1)
+    assert numpy.array_equal(layer.locate(longitudes, latitudes), expected)
+    assert numpy.array_equal(layer.contains(longitudes, latitudes), expected == 0)
+
+    distances = layer.distance_to_boundary([5, 20], [-1, 0], max_distance=500)
+    assert abs(distances[0] - 111.19) < 0.01
+    assert distances[1] == numpy.inf
+
+    assert layer.count_crossings(-5, 5, 35, 5) == 5
+
+def test_trajectories():
+    layer = make_layer()
+    points = []
+    for longitude in [2, 12, 22, 32]:
+        point = TrajectoryPoint(longitude, 5)
+        point.object_id = 'test'
+        points.append(point)
+    trajectory = Trajectory.from_position_list(points)
+    assert layer.fraction_inside([trajectory]) == [0.25]
+    # Box edge, both sides of the hole and the border
+    assert layer.trajectory_crossings([trajectory]) == [4]
+
+def main():
+    test_points()
+    test_trajectories()
+
+if __name__ == '__main__':
+    sys.exit(main())
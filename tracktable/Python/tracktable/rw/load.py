@@ -44,6 +44,7 @@ import os
 from tracktable.applications.assemble_trajectories import \
     AssembleTrajectoryFromPoints
 from tracktable.domain import domain_module_from_name
+from tracktable.lib import _trajectory_loader
 
 try:
     from tqdm import tqdm
@@ -53,6 +54,12 @@ except ImportError as e:
 
 logger = logging.getLogger(__name__)
 
+_NATIVE_LOADERS = {
+    'terrestrial': _trajectory_loader.TerrestrialTrajectoryLoader,
+    'cartesian2d': _trajectory_loader.Cartesian2DTrajectoryLoader,
+    'cartesian3d': _trajectory_loader.Cartesian3DTrajectoryLoader
+    }
+
 def load_trajectories(infile,
         comment_character="#",
         domain='terrestrial',
@@ -67,6 +74,8 @@ def load_trajectories(infile,
         real_fields = dict(), # {'altitude': 4}
         string_fields = dict(), # {'vessel-name': 7}
         time_fields = dict(), # {'eta': 17}
+        required_properties = None, # ['altitude']
+        lazy_properties = False,
         separation_distance = None, # km
         separation_time = 30, # minutes
         minimum_length=2, # points
@@ -117,6 +126,14 @@ def load_trajectories(infile,
             the point's properties. The timestamps must be in the same
             format as for the point as a whole, namely `YYYY-mm-dd HH:MM:SS`.
             (default: empty)
+        required_properties (list of str): Only attach these point
+            properties. Columns for other properties, including those
+            listed in a .traj file's header, are skipped without being
+            parsed. (default: None, meaning all of them)
+        lazy_properties (boolean): Keep real-valued and timestamp
+            properties as the text from the file and parse each one
+            the first time it is read. This saves time when most
+            values are never used. (default: False)
         separation_distance (int): Distance in KM between points signifying the need
             to generate a new trajectory. (default: 10)
         separation_time (int): Time in minutes between seperated points signifying the need
@@ -127,6 +144,11 @@ def load_trajectories(infile,
         return_list (boolean): When returning the reader or assembler object have the loader
             automatically pull all of the yielded trajectories into a list for further processing. (default: False)
 
+    When `return_list` is True, .csv and .tsv files are read, parsed and
+    assembled entirely in C++ without holding the GIL. Compressed files
+    (gzip, bgzip or zstd) are decompressed on the fly in that case.
+    The records in a .traj file are parsed on several threads.
+
     Returns:
         List of trajectory points or trajectories depending on input file and params.
 
@@ -144,12 +166,10 @@ def load_trajectories(infile,
         # Read in the trajectories from the traj file
         reader = domain_module.TrajectoryReader()
         reader.input = open(infile, 'r')
+        _configure_property_parsing(reader, required_properties, lazy_properties)
 
         if return_list:
-            if tqdm_installed:
-                trajectories = list(tqdm(reader, desc="Loading Trajectories", unit=" trajectory"))
-            else:
-                trajectories = list(reader)
+            trajectories = reader.read_all()
         else:
             trajectories = reader
 
@@ -171,12 +191,38 @@ def load_trajectories(infile,
         else:
             return trajectories
     elif infile.endswith('.csv') or infile.endswith('.tsv'):
+        if infile.endswith('.tsv') and field_delimiter != '\t':
+            field_delimiter = '\t'
+
+        if return_list:
+            loader = _configure_native_loader(
+                domain,
+                comment_character=comment_character,
+                field_delimiter=field_delimiter,
+                object_id_column=object_id_column,
+                timestamp_column=timestamp_column,
+                longitude_column=longitude_column,
+                latitude_column=latitude_column,
+                x_column=x_column,
+                y_column=y_column,
+                z_column=z_column,
+                real_fields=real_fields,
+                string_fields=string_fields,
+                time_fields=time_fields,
+                required_properties=required_properties,
+                lazy_properties=lazy_properties,
+                separation_distance=separation_distance,
+                separation_time=separation_time,
+                minimum_length=minimum_length)
+            if return_trajectory_points:
+                return loader.load_points(infile)
+            else:
+                return loader.load_trajectories(infile)
+
         # Read in the points from the CSV file
         reader = domain_module.TrajectoryPointReader()
         reader.input = open(infile, 'r')
         reader.comment_character = comment_character
-        if infile.endswith('.tsv') and field_delimiter != '\t':
-            field_delimiter = '\t'
         reader.field_delimiter = field_delimiter
         reader.object_id_column = object_id_column
         reader.timestamp_column = timestamp_column
@@ -200,6 +246,8 @@ def load_trajectories(infile,
         for name, column_num in time_fields.items():
             reader.set_time_field_column(name, column_num)
 
+        _configure_property_parsing(reader, required_properties, lazy_properties)
+
         if return_trajectory_points:
             if return_list:
                 if tqdm_installed:
@@ -228,3 +276,60 @@ def load_trajectories(infile,
         filename, file_extension = os.path.splitext(infile)
         logger.error("Unsupported file type: `{}`, supported file types are .csv, .tsv and .traj.".format(file_extension))
         raise IOError
+
+# ---------------------------------------------------------------------
+
+def _configure_native_loader(domain, **kwargs):
+    """Set up a C++ loader with the same settings as load_trajectories
+
+    This is a utility function. See load_trajectories for the
+    meaning of the keyword arguments.
+    """
+
+    if domain not in _NATIVE_LOADERS:
+        raise ValueError('Unsupported domain: `{}`, supported domains are terrestrial, cartesian2d and cartesian3d'.format(domain))
+
+    loader = _NATIVE_LOADERS[domain]()
+    loader.set_comment_character(kwargs['comment_character'])
+    loader.set_field_delimiter(kwargs['field_delimiter'])
+    loader.set_object_id_column(kwargs['object_id_column'])
+    loader.set_timestamp_column(kwargs['timestamp_column'])
+    if domain == 'terrestrial':
+        loader.set_coordinate_column(0, kwargs['longitude_column'])
+        loader.set_coordinate_column(1, kwargs['latitude_column'])
+    else:
+        loader.set_coordinate_column(0, kwargs['x_column'])
+        loader.set_coordinate_column(1, kwargs['y_column'])
+        if domain == 'cartesian3d':
+            loader.set_coordinate_column(2, kwargs['z_column'])
+
+    for name, column_num in kwargs['real_fields'].items():
+        loader.set_real_field_column(name, column_num)
+    for name, column_num in kwargs['string_fields'].items():
+        loader.set_string_field_column(name, column_num)
+    for name, column_num in kwargs['time_fields'].items():
+        loader.set_time_field_column(name, column_num)
+    if kwargs['required_properties'] is not None:
+        loader.set_required_properties(list(kwargs['required_properties']))
+    loader.set_lazy_properties(kwargs['lazy_properties'])
+
+    if kwargs['separation_distance'] is None:
+        loader.clear_separation_distance()
+    else:
+        loader.set_separation_distance(kwargs['separation_distance'])
+    loader.set_separation_time(timedelta(minutes=kwargs['separation_time']))
+    loader.set_minimum_length(kwargs['minimum_length'])
+    return loader
+
+# ---------------------------------------------------------------------
+
+def _configure_property_parsing(reader, required_properties, lazy_properties):
+    """Apply the required_properties and lazy_properties options to a reader
+
+    This is a utility function. See load_trajectories for the
+    meaning of the arguments.
+    """
+
+    if required_properties is not None:
+        reader.set_required_properties(list(required_properties))
+    reader.lazy_properties = lazy_properties
@@ -52,7 +52,8 @@ def trajectory_point_reader(
     z_column=4,
     string_fields=dict(),
     real_fields=dict(),
-    time_fields=dict()
+    time_fields=dict(),
+    decompression_threads=0
     ):
     """Instantiate and configure a trajectory point reader.
 
@@ -87,6 +88,11 @@ def trajectory_point_reader(
     documentation for the `string_fields`, `real_fields` and `time_fields`
     keyword arguments.
 
+    Input compressed with gzip or zstd is decompressed on the fly. The
+    format is recognized from the first few bytes of the file so you do
+    not need to say which you have. Open compressed files in binary mode
+    (``open(filename, 'rb')``).
+
     This function will probably move into the main library at some point
     soon. We will keep a binding here to avoid breaking existing code.
 
@@ -131,6 +137,10 @@ def trajectory_point_reader(
             the point's properties. The timestamps must be in the same
             format as for the point as a whole, namely `YYYY-mm-dd HH:MM:SS`.
             (default: empty)
+        decompression_threads (int): How many threads to use to
+            decompress blocked gzip (`bgzip`) input. Other compressed
+            formats are decompressed on a single background thread.
+            (default 0, meaning one per processor)
 
     Returns:
         Trajectory point reader from the appropriate domain with all fields
@@ -140,6 +150,7 @@ def trajectory_point_reader(
 
     domain_module = domain_module_from_name(domain)
     reader = domain_module.TrajectoryPointReader()
+    reader.decompression_threads = decompression_threads
     reader.input = infile
 
     _configure_reader_coordinates(
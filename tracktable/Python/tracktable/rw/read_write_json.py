@@ -31,10 +31,23 @@
 
 """
 tracktable.rw.read_write_json - Read/Write a trajectory from/to a JSON file
+
+Trajectories are converted to and from JSON in C++.  The text is the
+same as what ``json.dumps(dictionary_from_trajectory(t), sort_keys=True)``
+produces, including ``\\uXXXX`` escapes for non-ASCII characters and
+Python's formatting of floats, with one difference:
+``dictionary_from_trajectory`` takes the point property columns from
+the first point only, while the native writer writes one column for
+every property that appears on any point and puts ``null`` where a
+point does not have it.  Anything that ``trajectory_from_dictionary``
+accepts can be read.  Files can also hold many trajectories, either one per line
+(newline-delimited JSON) or as a GeoJSON FeatureCollection in which
+each trajectory is a LineString Feature.
 """
 
 import sys
 import json
+from tracktable.lib import _trajectory_json
 from tracktable.rw.read_write_dictionary import trajectory_from_dictionary
 from tracktable.rw.read_write_dictionary import dictionary_from_trajectory
 
@@ -74,34 +87,63 @@ def _byteify(data, ignore_dicts = False):
     # if it's anything else, return it in its original form
     return data
 
+def _as_text(json_string):
+    if isinstance(json_string, bytes):
+        return json_string.decode('utf-8')
+    return json_string
+
 def trajectory_from_json(json_string):
     """Constructes a trajectory from the given json string.
 
+    The string may hold either Tracktable's own layout or a GeoJSON
+    Feature.
+
     Args:
        json_string (json): the json to convert into a trajectory
 
     Returns:
         Returns a trajectory constructed from the given json string
 
+    Raises:
+        ValueError: the string is not valid JSON or does not describe
+           exactly one valid trajectory
+
     """
 
-    if sys.version_info[0] < 3:
-        return trajectory_from_dictionary(json_loads_byteified(json_string))
-    else:
-        return trajectory_from_dictionary(json.loads(json_string))
+    return _trajectory_json.trajectory_from_json(_as_text(json_string))
+
+def trajectories_from_json(json_string):
+    """Constructs every trajectory in the given json string.
+
+    The string may hold one trajectory, a list of them, a GeoJSON
+    FeatureCollection or newline-delimited JSON.
+
+    Args:
+       json_string (json): the json to convert into trajectories
+
+    Returns:
+        Returns a list of trajectories
 
-def json_from_trajectory(trajectory):
+    """
+
+    return _trajectory_json.trajectories_from_json(_as_text(json_string))
+
+def json_from_trajectory(trajectory, geojson=False):
     """Constructes a json string from the given trajectory
 
     Args:
        trajectory (Trajectory): the trajectory to convert into a json representation
 
+    Keyword Args:
+       geojson (bool): write a GeoJSON Feature with a LineString geometry
+          instead of Tracktable's own layout (Default: False)
+
     Returns:
         Returns a json string constructed from the given trajectory
 
     """
 
-    return json.dumps(dictionary_from_trajectory(trajectory), sort_keys=True)
+    return _trajectory_json.json_from_trajectory(trajectory, geojson)
 
 def trajectory_from_json_file(json_filename):
     """Constructes a trajectory from the given json file
@@ -114,8 +156,28 @@ def trajectory_from_json_file(json_filename):
 
     """
 
-    json_string = open(json_filename).read() #todo handle error
-    return trajectory_from_json(json_string)
+    with open(json_filename) as infile:
+        return trajectory_from_json(infile.read())
+
+def trajectories_from_json_file(json_filename, decompression_threads=0):
+    """Reads every trajectory in a json file
+
+    The file may hold anything that trajectories_from_json() accepts
+    and may be compressed with gzip, bgzip or zstd.
+
+    Args:
+       json_filename (str): the file to read
+
+    Keyword Args:
+       decompression_threads (int): threads to use for bgzip input;
+          0 picks a default (Default: 0)
+
+    Returns:
+        Returns a list of trajectories
+
+    """
+
+    return _trajectory_json.trajectories_from_json_file(json_filename, decompression_threads)
 
 def json_file_from_trajectory(trajectory, json_filename):
     """Constructes a json file from the given trajectory
@@ -131,4 +193,34 @@ def json_file_from_trajectory(trajectory, json_filename):
     with open(json_filename, 'w') as outfile: #todo handle error
         outfile.write(json_from_trajectory(trajectory))
 
-#todo can improve performance for large files by streaming
+def json_file_from_trajectories(trajectories, json_filename, geojson=False):
+    """Writes trajectories to a file as newline-delimited JSON
+
+    Each trajectory is written on its own line so that the file can be
+    read back with trajectories_from_json_file() or a line at a time
+    with trajectory_from_json().
+
+    Args:
+       trajectories (iterable): the trajectories to write
+       json_filename (str): the file to write
+
+    Keyword Args:
+       geojson (bool): write each trajectory as a GeoJSON Feature
+          (Default: False)
+
+    """
+    with open(json_filename, 'w') as outfile:
+        outfile.write(_trajectory_json.ndjson_from_trajectories(trajectories, geojson))
+
+def geojson_from_trajectories(trajectories):
+    """Constructs a GeoJSON FeatureCollection from trajectories
+
+    Args:
+       trajectories (iterable): the trajectories to include
+
+    Returns:
+        Returns the FeatureCollection as a string
+
+    """
+
+    return _trajectory_json.geojson_from_trajectories(trajectories)
@@ -41,6 +41,18 @@ def test_loader_csv(file):
     trajectories = load_trajectories(file)
     assert len(trajectories) > 0
 
+def test_native_loader_matches_python(file):
+    logger.info("Testing native CSV loader against Python reader and assembler")
+    native_points = load_trajectories(file, return_trajectory_points=True)
+    python_points = list(load_trajectories(file, return_trajectory_points=True, return_list=False))
+    assert len(native_points) == len(python_points)
+
+    native_trajectories = load_trajectories(file)
+    python_trajectories = list(load_trajectories(file, return_list=False).trajectories())
+    assert len(native_trajectories) == len(python_trajectories)
+    assert (sorted((t[0].object_id, len(t)) for t in native_trajectories) ==
+            sorted((t[0].object_id, len(t)) for t in python_trajectories))
+
 def test_loader_tsv(file):
     logger.info("Testing TSV Loader")
     trajectory_points = load_trajectories(file, return_trajectory_points=True)
@@ -55,10 +67,25 @@ def test_loader_traj(file):
     trajectories = load_trajectories(file)
     assert len(trajectories) > 0
 
+def test_loader_property_options(file):
+    logger.info("Testing required and lazy point properties")
+    trajectories = load_trajectories(file)
+    bare = load_trajectories(file, required_properties=[])
+    assert len(bare) == len(trajectories)
+    assert all(len(point.properties) == 0 for trajectory in bare for point in trajectory)
+    lazy = load_trajectories(file, lazy_properties=True)
+    assert [len(t) for t in lazy] == [len(t) for t in trajectories]
+    # Deferred values come back with the same types as eager ones
+    for (lazy_trajectory, trajectory) in zip(lazy, trajectories):
+        for (lazy_point, point) in zip(lazy_trajectory, trajectory):
+            assert sorted(lazy_point.properties.items()) == sorted(point.properties.items())
+
 def main():
     test_loader_csv(sys.argv[1])
+    test_native_loader_matches_python(sys.argv[1])
     test_loader_tsv(sys.argv[2])
     test_loader_traj(sys.argv[3])
+    test_loader_property_options(sys.argv[3])
 
 if __name__ == '__main__':
     sys.exit(main())
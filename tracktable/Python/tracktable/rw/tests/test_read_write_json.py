@@ -39,6 +39,10 @@ from tracktable.rw.read_write_json import trajectory_from_json
 from tracktable.rw.read_write_json import json_from_trajectory
 from tracktable.rw.read_write_json import json_file_from_trajectory
 from tracktable.rw.read_write_json import trajectory_from_json_file
+from tracktable.rw.read_write_json import trajectories_from_json
+from tracktable.rw.read_write_json import trajectories_from_json_file
+from tracktable.rw.read_write_json import json_file_from_trajectories
+from tracktable.rw.read_write_json import geojson_from_trajectories
 
 import tracktable.domain.terrestrial
 
@@ -124,11 +128,33 @@ class TestReadWriteDictionary(unittest.TestCase):
 
         self.assertEqual(trajectory, trajectoryExpected,
                          msg="Error: The trajectory read in from the file does not match the original trajectory written to the file")
+
+    def tst_geojson_and_collections(self):
+        print("Testing GeoJSON and files with several trajectories.")
+        unused, trajectoryExpected = self.gen_json_and_trajectory()
+        feature = json_from_trajectory(trajectoryExpected, geojson=True)
+        self.assertEqual(trajectory_from_json(feature), trajectoryExpected,
+                         msg="Error: The trajectory read from GeoJSON does not match the original")
+
+        collection = trajectories_from_json(geojson_from_trajectories([trajectoryExpected, trajectoryExpected]))
+        self.assertEqual(len(collection), 2)
+        self.assertEqual(collection[1], trajectoryExpected)
+
+        json_file_from_trajectories([trajectoryExpected] * 3, "_test-output.ndjson")
+        trajectories = trajectories_from_json_file("_test-output.ndjson")
+        os.remove("_test-output.ndjson")
+        self.assertEqual(len(trajectories), 3)
+        self.assertEqual(trajectories[2], trajectoryExpected)
+
+        with self.assertRaises(ValueError):
+            trajectory_from_json("{\"coordinates\": [[1, 2]], \"domain\": \"terrestrial\"")
+
     def test_json(self):
         self.maxDiff = 10240
         self.tst_trajectory_from_json()
         self.tst_json_from_trajectory()
         self.tst_trajectory_from_json_file_from_trajectory()
+        self.tst_geojson_and_collections()
 
 if __name__ == '__main__':
     unittest.main()
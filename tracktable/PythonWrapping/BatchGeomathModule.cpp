@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// Tracktable Trajectory Library
+//
+// BatchGeomathModule - Python bindings for the array kernels in
+// Analysis/BatchGeomath.h
+//
+// Coordinate arrays come in through the buffer protocol as contiguous
+// float64 arrays with one row per point.  Results go into arrays that
+// tracktable.core.geomath allocates, except for whole trajectories,
+// whose results come back as bytearrays that geomath views as NumPy
+// arrays.  The domain is named once per call.
+//
+// ecef_from_trajectories() returns the ECEF coordinates of every point
+// in a list of terrestrial trajectories as one bytearray of (x, y, z)
+// triples plus a bytearray of int64 trajectory indices.
+
+#include <tracktable/Analysis/BatchGeomath.h>
+#include <tracktable/Core/ParallelFor.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+using tracktable::python_wrapping::ArrayView;
+using tracktable::python_wrapping::FLOAT64_CODES;
+using tracktable::python_wrapping::to_bytearray;
+
+// ----------------------------------------------------------------------
+
+enum class Measure {
+  SEGMENT_LENGTHS,
+  SEGMENT_BEARINGS,
+  SEGMENT_SPEEDS,
+  SIGNED_TURN_ANGLES
+};
+
+enum class Domain {
+  TERRESTRIAL,
+  CARTESIAN2D,
+  CARTESIAN3D
+};
+
+Measure measure_from_name(std::string const& name)
+{
+  if (name == "segment_lengths")
+    {
+    return Measure::SEGMENT_LENGTHS;
+    }
+  if (name == "segment_bearings")
+    {
+    return Measure::SEGMENT_BEARINGS;
+    }
+  if (name == "segment_speeds")
+    {
+    return Measure::SEGMENT_SPEEDS;
+    }
+  if (name == "signed_turn_angles")
+    {
+    return Measure::SIGNED_TURN_ANGLES;
+    }
+  throw std::invalid_argument("Unknown path measure '" + name + "'");
+}
+
+Domain domain_from_name(std::string const& name)
+{
+  if (name == "terrestrial")
+    {
+    return Domain::TERRESTRIAL;
+    }
+  if (name == "cartesian2d")
+    {
+    return Domain::CARTESIAN2D;
+    }
+  if (name == "cartesian3d")
+    {
+    return Domain::CARTESIAN3D;
+    }
+  throw std::invalid_argument("Batch geomath is not available in domain '" + name + "'");
+}
+
+std::size_t dimension_of(Domain domain)
+{
+  return (domain == Domain::CARTESIAN3D ? 3 : 2);
+}
+
+bool is_angle(Measure which)
+{
+  return (which == Measure::SEGMENT_BEARINGS || which == Measure::SIGNED_TURN_ANGLES);
+}
+
+void check_angles_defined(Domain domain, bool angles)
+{
+  if (angles && domain == Domain::CARTESIAN3D)
+    {
+    throw std::invalid_argument("Bearings and turn angles are not defined in domain 'cartesian3d'");
+    }
+}
+
+std::size_t result_size(Measure which, std::size_t num_points)
+{
+  std::size_t points_per_result = (which == Measure::SIGNED_TURN_ANGLES ? 3 : 2);
+  return (num_points < points_per_result ? 0 : num_points - points_per_result + 1);
+}
+
+// ----------------------------------------------------------------------
+
+// Angle measures only exist in domains that define a bearing.  The
+// std::false_type overloads are never called because
+// check_angles_defined() has already turned those requests away.
+
+template<typename DomainT>
+void measure_angles(Measure which, std::size_t num_points, double const* points,
+                    double* result, std::true_type)
+{
+  if (which == Measure::SEGMENT_BEARINGS)
+    {
+    tracktable::batch::segment_bearings<DomainT>(num_points, points, result);
+    }
+  else
+    {
+    tracktable::batch::signed_turn_angles<DomainT>(num_points, points, result);
+    }
+}
+
+template<typename DomainT>
+void measure_angles(Measure, std::size_t, double const*, double*, std::false_type)
+{
+}
+
+template<typename DomainT>
+void measure_path(Measure which, std::size_t num_points, double const* points,
+                  double const* timestamps, double* result)
+{
+  typedef std::integral_constant<
+    bool, tracktable::batch::geomath_kernels<DomainT>::has_bearing> has_bearing;
+
+  if (which == Measure::SEGMENT_LENGTHS)
+    {
+    tracktable::batch::segment_lengths<DomainT>(num_points, points, result);
+    }
+  else if (which == Measure::SEGMENT_SPEEDS)
+    {
+    tracktable::batch::segment_speeds<DomainT>(num_points, points, timestamps, result);
+    }
+  else
+    {
+    measure_angles<DomainT>(which, num_points, points, result, has_bearing());
+    }
+}
+
+void measure_path(Domain domain, Measure which, std::size_t num_points, double const* points,
+                  double const* timestamps, double* result)
+{
+  switch (domain)
+    {
+    case Domain::TERRESTRIAL:
+      measure_path<tracktable::traits::domains::terrestrial>(which, num_points, points, timestamps, result);
+      break;
+    case Domain::CARTESIAN2D:
+      measure_path<tracktable::traits::domains::cartesian2d>(which, num_points, points, timestamps, result);
+      break;
+    case Domain::CARTESIAN3D:
+      measure_path<tracktable::traits::domains::cartesian3d>(which, num_points, points, timestamps, result);
+      break;
+    }
+}
+
+template<typename TrajectoryT>
+void measure_trajectory(TrajectoryT const& path, Measure which, std::vector<double>& result)
+{
+  typedef typename tracktable::traits::domain<typename TrajectoryT::point_type>::type domain_type;
+  typedef std::integral_constant<
+    bool, tracktable::batch::geomath_kernels<domain_type>::has_bearing> has_bearing;
+
+  std::vector<double> coordinates, timestamps;
+  tracktable::batch::flatten_coordinates(path.begin(), path.end(), coordinates);
+  if (which == Measure::SEGMENT_SPEEDS)
+    {
+    tracktable::batch::relative_timestamps(path.begin(), path.end(), timestamps);
+    }
+  result.assign(result_size(which, path.size()), 0.0);
+  measure_path<domain_type>(which, path.size(), coordinates.data(), timestamps.data(), result.data());
+}
+
+template<typename TrajectoryT>
+boost::python::list measure_trajectories(boost::python::object const& trajectories,
+                                         Measure which, std::size_t num_threads)
+{
+  std::vector<boost::python::object> owners;
+  std::vector<TrajectoryT const*> paths;
+  tracktable::python_wrapping::extract_trajectories(trajectories, owners, paths);
+
+  std::vector<std::vector<double> > results(paths.size());
+  {
+    ReleaseGIL unlock;
+    tracktable::parallel_for(
+      0, paths.size(),
+      [&](std::size_t i) { measure_trajectory(*paths[i], which, results[i]); },
+      num_threads, 1);
+  }
+
+  boost::python::list result;
+  for (std::size_t i = 0; i < results.size(); ++i)
+    {
+    result.append(to_bytearray(results[i]));
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+void pairwise(std::string const& domain_name, bool angles,
+              boost::python::object from, boost::python::object to,
+              boost::python::object result)
+{
+  Domain domain = domain_from_name(domain_name);
+  check_angles_defined(domain, angles);
+
+  ArrayView from_view(from, FLOAT64_CODES, "from");
+  ArrayView to_view(to, FLOAT64_CODES, "to");
+  ArrayView result_view(result, FLOAT64_CODES, "result", true);
+  std::size_t dimension = dimension_of(domain);
+  std::size_t num_points = from_view.size() / dimension;
+  if (from_view.size() % dimension != 0 || to_view.size() != from_view.size())
+    {
+    throw std::invalid_argument("Point arrays must have the same shape with "
+                                + std::to_string(dimension) + " coordinates per point");
+    }
+  if (result_view.size() != num_points)
+    {
+    throw std::invalid_argument("Result array must hold one value per point");
+    }
+
+  ReleaseGIL unlock;
+  switch (domain)
+    {
+    case Domain::TERRESTRIAL:
+      if (angles)
+        {
+        tracktable::batch::bearings<tracktable::traits::domains::terrestrial>(
+          num_points, from_view.data<double>(), to_view.data<double>(), result_view.data<double>());
+        }
+      else
+        {
+        tracktable::batch::distances<tracktable::traits::domains::terrestrial>(
+          num_points, from_view.data<double>(), to_view.data<double>(), result_view.data<double>());
+        }
+      break;
+    case Domain::CARTESIAN2D:
+      if (angles)
+        {
+        tracktable::batch::bearings<tracktable::traits::domains::cartesian2d>(
+          num_points, from_view.data<double>(), to_view.data<double>(), result_view.data<double>());
+        }
+      else
+        {
+        tracktable::batch::distances<tracktable::traits::domains::cartesian2d>(
+          num_points, from_view.data<double>(), to_view.data<double>(), result_view.data<double>());
+        }
+      break;
+    case Domain::CARTESIAN3D:
+      tracktable::batch::distances<tracktable::traits::domains::cartesian3d>(
+        num_points, from_view.data<double>(), to_view.data<double>(), result_view.data<double>());
+      break;
+    }
+}
+
+void distances(std::string const& domain, boost::python::object from,
+               boost::python::object to, boost::python::object result)
+{
+  pairwise(domain, false, from, to, result);
+}
+
+void bearings(std::string const& domain, boost::python::object from,
+              boost::python::object to, boost::python::object result)
+{
+  pairwise(domain, true, from, to, result);
+}
+
+void measure_points(std::string const& domain_name, std::string const& measure_name,
+                    boost::python::object points, boost::python::object timestamps,
+                    boost::python::object result)
+{
+  Domain domain = domain_from_name(domain_name);
+  Measure which = measure_from_name(measure_name);
+  check_angles_defined(domain, is_angle(which));
+
+  ArrayView point_view(points, FLOAT64_CODES, "points");
+  ArrayView result_view(result, FLOAT64_CODES, "result", true);
+  std::size_t dimension = dimension_of(domain);
+  std::size_t num_points = point_view.size() / dimension;
+  if (point_view.size() % dimension != 0)
+    {
+    throw std::invalid_argument("Point array must have "
+                                + std::to_string(dimension) + " coordinates per point");
+    }
+  if (result_view.size() != result_size(which, num_points))
+    {
+    throw std::invalid_argument("Result array has the wrong length for '" + measure_name + "'");
+    }
+
+  if (which == Measure::SEGMENT_SPEEDS)
+    {
+    ArrayView time_view(timestamps, FLOAT64_CODES, "timestamps");
+    if (time_view.size() != num_points)
+      {
+      throw std::invalid_argument("There must be one timestamp for every point");
+      }
+    ReleaseGIL unlock;
+    measure_path(domain, which, num_points, point_view.data<double>(), time_view.data<double>(), result_view.data<double>());
+    }
+  else
+    {
+    ReleaseGIL unlock;
+    measure_path(domain, which, num_points, point_view.data<double>(), nullptr, result_view.data<double>());
+    }
+}
+
+boost::python::list measure_trajectories(std::string const& domain_name,
+                                         boost::python::object trajectories,
+                                         std::string const& measure_name,
+                                         std::size_t num_threads)
+{
+  Domain domain = domain_from_name(domain_name);
+  Measure which = measure_from_name(measure_name);
+  check_angles_defined(domain, is_angle(which));
+
+  switch (domain)
+    {
+    case Domain::TERRESTRIAL:
+      return measure_trajectories<tracktable::domain::terrestrial::trajectory_type>(
+        trajectories, which, num_threads);
+    case Domain::CARTESIAN2D:
+      return measure_trajectories<tracktable::domain::cartesian2d::trajectory_type>(
+        trajectories, which, num_threads);
+    case Domain::CARTESIAN3D:
+    default:
+      return measure_trajectories<tracktable::domain::cartesian3d::trajectory_type>(
+        trajectories, which, num_threads);
+    }
+}
+
+tracktable::domain::terrestrial::AltitudeUnits units_from_name(std::string const& name)
+{
+  typedef tracktable::domain::terrestrial::AltitudeUnits units_type;
+  if (name == "feet")
+    {
+    return units_type::FEET;
+    }
+  if (name == "meters")
+    {
+    return units_type::METERS;
+    }
+  if (name == "kilometers")
+    {
+    return units_type::KILOMETERS;
+    }
+  throw std::invalid_argument("Altitude units must be 'feet', 'meters' or 'kilometers', not '" + name + "'");
+}
+
+boost::python::tuple ecef_from_trajectories(boost::python::object trajectories,
+                                            std::string const& altitude_property,
+                                            std::string const& altitude_units,
+                                            std::size_t num_threads)
+{
+  tracktable::domain::terrestrial::AltitudeUnits units = units_from_name(altitude_units);
+  std::vector<boost::python::object> owners;
+  std::vector<tracktable::domain::terrestrial::trajectory_type const*> paths;
+  tracktable::python_wrapping::extract_trajectories(trajectories, owners, paths);
+
+  std::vector<double> coordinates;
+  std::vector<std::size_t> trajectory_index;
+  {
+    ReleaseGIL unlock;
+    tracktable::batch::ecef_coordinates(paths, altitude_property, units,
+                                        coordinates, trajectory_index, num_threads);
+  }
+
+  std::vector<std::int64_t> index(trajectory_index.begin(), trajectory_index.end());
+  return boost::python::make_tuple(to_bytearray(coordinates), to_bytearray(index));
+}
+
+void translate_missing_property(tracktable::domain::terrestrial::PropertyDoesNotExist const& e)
+{
+  PyErr_SetString(PyExc_KeyError,
+                  (std::string("Point has no altitude property '") + e.what() + "'").c_str());
+}
+
+void translate_invalid_argument(std::invalid_argument const& e)
+{
+  PyErr_SetString(PyExc_ValueError, e.what());
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_batch_geomath) {
+  using namespace boost::python;
+
+  register_exception_translator<std::invalid_argument>(&translate_invalid_argument);
+  register_exception_translator<tracktable::domain::terrestrial::PropertyDoesNotExist>(
+    &translate_missing_property);
+
+  def("distances", &distances,
+      (arg("domain"), arg("from_points"), arg("to_points"), arg("result")));
+  def("bearings", &bearings,
+      (arg("domain"), arg("from_points"), arg("to_points"), arg("result")));
+  def("measure_points", &measure_points,
+      (arg("domain"), arg("measure"), arg("points"), arg("timestamps"), arg("result")));
+  def("measure_trajectories",
+      static_cast<list (*)(std::string const&, object, std::string const&, std::size_t)>(&measure_trajectories),
+      (arg("domain"), arg("trajectories"), arg("measure"), arg("num_threads")=0));
+  def("ecef_from_trajectories", &ecef_from_trajectories,
+      (arg("trajectories"), arg("altitude_property")="altitude", arg("altitude_units")="feet",
+       arg("num_threads")=0));
+}
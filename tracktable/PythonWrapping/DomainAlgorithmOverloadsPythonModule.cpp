@@ -34,10 +34,12 @@
 #include <tracktable/Core/GeometricMean.h>
 #include <tracktable/Core/GeometricMedian.h>
 #include <tracktable/Core/PointArithmetic.h>
+#include <tracktable/Analysis/StreamingSimplification.h>
 #include <tracktable/Domain/Terrestrial.h>
 #include <tracktable/Domain/Cartesian2D.h>
 #include <tracktable/Domain/Cartesian3D.h>
 
+#include <string>
 #include <vector>
 #include <typeinfo>
 
@@ -76,6 +78,32 @@ point_type wrap_geometric_mean(point_type const& /*first_point*/, boost::python:
     );
 }
 
+// The simplification metric comes in from Python as a string so
+// that we don't have to wrap the enum.
+
+template<
+    typename trajectory_type
+>
+trajectory_type wrap_simplify_in_time(trajectory_type const& trajectory,
+                                      double tolerance,
+                                      std::string const& metric,
+                                      std::size_t max_window)
+{
+    tracktable::SimplificationMetric native_metric =
+        tracktable::SimplificationMetric::SYNCHRONIZED_EUCLIDEAN_DISTANCE;
+    if (metric == "dead_reckoning")
+    {
+        native_metric = tracktable::SimplificationMetric::DEAD_RECKONING;
+    }
+    else if (metric != "synchronized")
+    {
+        PyErr_SetString(PyExc_ValueError, ("Unknown simplification metric: " + metric).c_str());
+        boost::python::throw_error_already_set();
+    }
+
+    return tracktable::simplify_in_time(trajectory, tolerance, native_metric, max_window);
+}
+
 template<
     typename base_point_type,
     typename trajectory_point_type
@@ -205,6 +233,7 @@ BOOST_PYTHON_MODULE(_domain_algorithm_overloads) {
     def("current_time_fraction", &(tracktable::current_time_fraction<TrajectoryPointTerrestrial>));
 
     def("simplify", &(tracktable::simplify<TrajectoryTerrestrial>));
+    def("simplify_in_time", &(wrap_simplify_in_time<TrajectoryTerrestrial>));
     def("point_at_time_fraction", &(tracktable::point_at_time_fraction<TrajectoryTerrestrial>));
     def("point_at_length_fraction", &(tracktable::point_at_length_fraction<TrajectoryTerrestrial>));
     def("point_at_time", &(tracktable::point_at_time<TrajectoryTerrestrial>));
@@ -270,6 +299,7 @@ BOOST_PYTHON_MODULE(_domain_algorithm_overloads) {
     def("current_time_fraction", &(tracktable::current_time_fraction<TrajectoryPointCartesian2D>));
 
     def("simplify", &(tracktable::simplify<TrajectoryCartesian2D>));
+    def("simplify_in_time", &(wrap_simplify_in_time<TrajectoryCartesian2D>));
     def("point_at_time_fraction", &(tracktable::point_at_time_fraction<TrajectoryCartesian2D>));
     def("point_at_length_fraction", &(tracktable::point_at_length_fraction<TrajectoryCartesian2D>));
     def("point_at_time", &(tracktable::point_at_time<TrajectoryCartesian2D>));
@@ -327,6 +357,7 @@ BOOST_PYTHON_MODULE(_domain_algorithm_overloads) {
     def("unsigned_turn_angle", &(tracktable::unsigned_turn_angle<TrajectoryPointCartesian3D>));
     def("speed_between", &(tracktable::speed_between<TrajectoryPointCartesian3D>));
     def("simplify", &(tracktable::simplify<TrajectoryCartesian3D>));
+    def("simplify_in_time", &(wrap_simplify_in_time<TrajectoryCartesian3D>));
     def("point_at_time_fraction", &(tracktable::point_at_time_fraction<TrajectoryCartesian3D>));
     def("point_at_length_fraction", &(tracktable::point_at_length_fraction<TrajectoryCartesian3D>));
     def("point_at_time", &(tracktable::point_at_time<TrajectoryCartesian3D>));
@@ -40,6 +40,10 @@
 #include <tracktable/Core/PropertyMap.h>
 #include <tracktable/PythonWrapping/PythonFileLikeObjectStreams.h>
 #include <tracktable/PythonWrapping/GenericSerializablePickleSuite.h>
+#include <tracktable/PythonWrapping/TrajectoryCodecPickleSuite.h>
+
+#include <iterator>
+#include <vector>
 
 namespace tracktable { namespace python_wrapping {
 
@@ -469,7 +473,7 @@ class trajectory_methods : public boost::python::def_visitor<trajectory_methods>
                   .def("clone", &wrapped_type::clone, return_value_policy<return_by_value>())
                   .def(self == self)
                   .def(self != self)
-                  .def_pickle(GenericSerializablePickleSuite<wrapped_type>())
+                  .def_pickle(TrajectoryCodecPickleSuite<wrapped_type>())
                   ;
 	}
 };
@@ -587,6 +591,52 @@ trajectory_from_position_list(boost::python::list const& position_list)
 
 // ----------------------------------------------------------------------
 
+template<typename reader_type>
+void set_required_properties_from_python(reader_type& reader, boost::python::object const& names)
+{
+  using namespace boost::python;
+
+  std::vector<std::string> required;
+  stl_input_iterator<std::string> iter(names), end;
+  for (; iter != end; ++iter)
+    {
+    required.push_back(*iter);
+    }
+  reader.set_required_properties(required);
+}
+
+template<typename reader_type>
+boost::python::list required_properties_as_python(reader_type const& reader)
+{
+  boost::python::list result;
+  std::vector<std::string> required(reader.required_properties());
+  for (std::size_t i = 0; i < required.size(); ++i)
+    {
+    result.append(required[i]);
+    }
+  return result;
+}
+
+// Parsing runs on worker threads but reading lines can call back into
+// a Python file object, so the GIL stays held.
+template<typename reader_type>
+boost::python::list read_all_trajectories_as_python(reader_type& reader, std::size_t num_threads)
+{
+  typedef typename reader_type::iterator::value_type trajectory_type;
+
+  std::vector<trajectory_type> trajectories;
+  reader.read_all(std::back_inserter(trajectories), num_threads);
+
+  boost::python::list result;
+  for (std::size_t i = 0; i < trajectories.size(); ++i)
+    {
+    result.append(trajectories[i]);
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
 class basic_point_reader_methods : public boost::python::def_visitor<basic_point_reader_methods>
 
  {
@@ -608,6 +658,8 @@ class basic_point_reader_methods : public boost::python::def_visitor<basic_point
          .def("clear_coordinate_assignments", &reader_type::clear_coordinate_assignments)
          .add_property("coordinates", make_function(&reader_type::__coordinate_assignments, return_internal_reference<>()), &reader_type::__set_coordinate_assignments)
          .add_property("input", &reader_type::input_as_python_object, &reader_type::set_input_from_python_object)
+         .add_property("decompression_threads", &reader_type::decompression_threads, &reader_type::set_decompression_threads)
+         .add_property("compression", &reader_type::compression)
          .def("__iter__", iterator<reader_type, return_value_policy<copy_const_reference> >())
          ;
     }
@@ -635,6 +687,10 @@ class trajectory_point_reader_methods : public boost::python::def_visitor<trajec
         .def("string_field_column", &reader_type::string_field_column)
         .def("set_time_field_column", &reader_type::set_time_field_column)
         .def("time_field_column", &reader_type::time_field_column)
+        .add_property("lazy_properties", &reader_type::lazy_properties, &reader_type::set_lazy_properties)
+        .def("set_required_properties", &set_required_properties_from_python<reader_type>)
+        .def("required_properties", &required_properties_as_python<reader_type>)
+        .def("clear_required_properties", &reader_type::clear_required_properties)
  	;
     }
 };
@@ -659,6 +715,13 @@ class trajectory_reader_methods : public boost::python::def_visitor<trajectory_r
          .add_property("null_value", &reader_type::null_value, &reader_type::set_null_value)
          .add_property("input", &reader_type::input_as_python_object, &reader_type::set_input_from_python_object)
          .add_property("warnings_enabled", &reader_type::warnings_enabled, &reader_type::set_warnings_enabled)
+         .add_property("lazy_properties", &reader_type::lazy_properties, &reader_type::set_lazy_properties)
+         .add_property("hoist_constant_properties", &reader_type::hoist_constant_properties, &reader_type::set_hoist_constant_properties)
+         .def("set_required_properties", &set_required_properties_from_python<reader_type>)
+         .def("required_properties", &required_properties_as_python<reader_type>)
+         .def("clear_required_properties", &reader_type::clear_required_properties)
+         .def("read_all", &read_all_trajectories_as_python<reader_type>,
+              (arg("num_threads")=0))
          .def("__iter__", iterator<reader_type, return_value_policy<copy_const_reference> >())
          ;
     }
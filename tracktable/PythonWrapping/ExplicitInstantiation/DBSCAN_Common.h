@@ -37,6 +37,7 @@
 #include <boost/geometry/geometry.hpp>
 
 #include <tracktable/Analysis/ComputeDBSCANClustering.h>
+#include <tracktable/Analysis/LSHBucketing.h>
 #include <tracktable/Domain/FeatureVectors.h>
 
 
@@ -46,12 +47,14 @@
 #define str(s) #s
 
 #define DBSCAN_FUNCTION_NAME(dim) "dbscan_learn_cluster_ids_" xstr(dim)
+#define LSH_DBSCAN_FUNCTION_NAME(dim) "dbscan_learn_cluster_ids_lsh_" xstr(dim)
 
 using namespace tracktable::domain::feature_vectors;
 using namespace boost::python;
 
 #define WRAP_DBSCAN(dim) \
-  def( DBSCAN_FUNCTION_NAME(dim), dbscan_learn_cluster_ids< FeatureVector<dim> > )
+  def( DBSCAN_FUNCTION_NAME(dim), dbscan_learn_cluster_ids< FeatureVector<dim> > ); \
+  def( LSH_DBSCAN_FUNCTION_NAME(dim), dbscan_learn_cluster_ids_lsh< FeatureVector<dim> > )
 
 
 /*
@@ -89,6 +92,52 @@ dbscan_learn_cluster_ids(boost::python::object points,
   return std::move(result);
 }
 
+/*
+ * Same as above but cluster one LSH bucket at a time.  See
+ * Analysis/LSHBucketing.h for the parameters.
+ */
+
+template<typename point_type>
+boost::python::object
+dbscan_learn_cluster_ids_lsh(boost::python::object points,
+                             boost::python::object _search_box_half_span,
+                             int min_cluster_size,
+                             std::size_t num_projections,
+                             double bucket_width,
+                             std::size_t num_probes,
+                             std::size_t num_threads,
+                             unsigned int random_seed)
+{
+  namespace bp = boost::python;
+
+  point_type search_box_half_span = boost::python::extract<point_type>(_search_box_half_span);
+  tracktable::LSHBucketing<point_type> bucketing(search_box_half_span,
+                                                 num_projections,
+                                                 bucket_width,
+                                                 num_probes,
+                                                 random_seed);
+
+  typedef std::pair<int, int> cluster_label_type;
+  std::vector<cluster_label_type> result_cluster_labels;
+
+  tracktable::cluster_with_bucketed_dbscan(bp::stl_input_iterator<point_type>(points),
+                                           bp::stl_input_iterator<point_type>(),
+                                           search_box_half_span,
+                                           min_cluster_size,
+                                           std::back_inserter(result_cluster_labels),
+                                           bucketing,
+                                           num_threads);
+
+  bp::list result;
+  for (typename std::vector<cluster_label_type>::const_iterator iter = result_cluster_labels.begin();
+       iter != result_cluster_labels.end();
+       ++iter)
+    {
+    result.append(*iter);
+    }
+  return std::move(result);
+}
+
 
 void install_dbscan_wrappers_1_3();
 void install_dbscan_wrappers_4_6();
@@ -40,11 +40,43 @@
 #include <tracktable/Domain/FeatureVectors.h>
 
 #include <tracktable/PythonWrapping/RTreePythonWrapper.h>
+#include <tracktable/PythonWrapping/HNSWIndexPythonWrapper.h>
 #include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
 #include <sstream>
 
 #define WRAP_RTREE(dimension) wrap_rtree<dimension>()
 
+// The approximate nearest-neighbor index lives in the same module as
+// the R-tree and is instantiated for the same feature vector sizes.
+template<std::size_t dim>
+void wrap_hnsw_index()
+{
+  std::ostringstream namebuf;
+  namebuf << "hnsw_index_" << dim;
+
+  using namespace boost::python;
+  typedef tracktable::domain::feature_vectors::FeatureVector<dim> point_type;
+  typedef HNSWIndexPythonWrapper<point_type> index_type;
+
+  class_< index_type, boost::noncopyable >(namebuf.str().c_str(),
+                                           init<std::size_t, std::size_t, unsigned int>(
+                                             (arg("max_neighbors")=16,
+                                              arg("ef_construction")=200,
+                                              arg("random_seed")=100)))
+    .def("insert_point", &index_type::insert_point)
+    .def("insert_points", &index_type::insert_points,
+         (arg("points"), arg("num_threads")=0))
+    .def("find_nearest_neighbors", &index_type::find_nearest_neighbors,
+         (arg("search_point"), arg("num_neighbors"), arg("ef")=0))
+    .def("batch_find_nearest_neighbors", &index_type::batch_find_nearest_neighbors,
+         (arg("search_points"), arg("num_neighbors"), arg("num_threads")=0, arg("ef")=0))
+    .add_property("ef_search", &index_type::ef_search, &index_type::set_ef_search)
+    .def("save", &index_type::save)
+    .def("load", &index_type::load)
+    .def("__len__", &index_type::size)
+    ;
+}
+
 template<std::size_t dim>
 void wrap_rtree()
 {
@@ -63,6 +95,8 @@ void wrap_rtree()
     .def("find_nearest_neighbors", &rtree_type::find_nearest_neighbors)
     .def("__len__", &rtree_type::size)
     ;
+
+  wrap_hnsw_index<dim>();
 }
 
 void install_rtree_wrappers_1_3();
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// Tracktable Trajectory Library
+//
+// GazetteerModule - Python bindings for tracktable::Gazetteer
+//
+// The batch queries take and fill contiguous arrays through the
+// buffer protocol so that NumPy arrays go straight to C++ without
+// copying.  Results whose length we cannot know in advance come back
+// as bytearrays that tracktable.info.gazetteer views as NumPy arrays.
+
+#include <tracktable/Analysis/Gazetteer.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+using tracktable::python_wrapping::ArrayView;
+using tracktable::python_wrapping::FLOAT64_CODES;
+using tracktable::python_wrapping::INT64_CODES;
+using tracktable::python_wrapping::to_bytearray;
+
+typedef tracktable::Gazetteer::id_type id_type;
+typedef tracktable::Gazetteer::match_type match_type;
+
+void check_same_length(ArrayView const& longitudes, ArrayView const& latitudes)
+{
+  if (longitudes.size() != latitudes.size())
+    {
+    PyErr_SetString(PyExc_ValueError, "Longitude and latitude arrays must have the same length");
+    boost::python::throw_error_already_set();
+    }
+}
+
+boost::python::list matches_to_list(std::vector<match_type> const& matches)
+{
+  boost::python::list result;
+  for (std::size_t i = 0; i < matches.size(); ++i)
+    {
+    result.append(boost::python::make_tuple(matches[i].first, matches[i].second));
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+void build(tracktable::Gazetteer& gazetteer,
+           boost::python::object longitudes,
+           boost::python::object latitudes,
+           boost::python::object ids)
+{
+  ArrayView lon_view(longitudes, FLOAT64_CODES, "longitudes");
+  ArrayView lat_view(latitudes, FLOAT64_CODES, "latitudes");
+  check_same_length(lon_view, lat_view);
+
+  if (ids.is_none())
+    {
+    ReleaseGIL unlocked;
+    gazetteer.build(lon_view.size(), lon_view.data<double>(), lat_view.data<double>());
+    }
+  else
+    {
+    ArrayView id_view(ids, INT64_CODES, "ids");
+    if (id_view.size() != lon_view.size())
+      {
+      PyErr_SetString(PyExc_ValueError, "There must be one ID for every place");
+      boost::python::throw_error_already_set();
+      }
+    ReleaseGIL unlocked;
+    gazetteer.build(lon_view.size(), lon_view.data<double>(), lat_view.data<double>(),
+                    id_view.data<id_type>());
+    }
+}
+
+boost::python::list find_nearest(tracktable::Gazetteer const& gazetteer,
+                                 double longitude, double latitude,
+                                 std::size_t k, double max_distance)
+{
+  return matches_to_list(gazetteer.find_nearest(longitude, latitude, k, max_distance));
+}
+
+boost::python::list find_within_radius(tracktable::Gazetteer const& gazetteer,
+                                       double longitude, double latitude, double radius)
+{
+  return matches_to_list(gazetteer.find_within_radius(longitude, latitude, radius));
+}
+
+boost::python::list find_within_box(tracktable::Gazetteer const& gazetteer,
+                                    double min_longitude, double min_latitude,
+                                    double max_longitude, double max_latitude)
+{
+  std::vector<id_type> ids(gazetteer.find_within_box(min_longitude, min_latitude,
+                                                     max_longitude, max_latitude));
+  boost::python::list result;
+  for (std::size_t i = 0; i < ids.size(); ++i)
+    {
+    result.append(ids[i]);
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+void find_nearest_batch(tracktable::Gazetteer const& gazetteer,
+                        boost::python::object longitudes,
+                        boost::python::object latitudes,
+                        std::size_t k,
+                        boost::python::object ids,
+                        boost::python::object distances,
+                        double max_distance)
+{
+  ArrayView lon_view(longitudes, FLOAT64_CODES, "longitudes");
+  ArrayView lat_view(latitudes, FLOAT64_CODES, "latitudes");
+  ArrayView id_view(ids, INT64_CODES, "ids", true);
+  ArrayView distance_view(distances, FLOAT64_CODES, "distances", true);
+  check_same_length(lon_view, lat_view);
+  if (id_view.size() != k * lon_view.size() || distance_view.size() != k * lon_view.size())
+    {
+    PyErr_SetString(PyExc_ValueError, "Output arrays must hold k results for every query");
+    boost::python::throw_error_already_set();
+    }
+
+  ReleaseGIL unlocked;
+  gazetteer.find_nearest(lon_view.size(), lon_view.data<double>(), lat_view.data<double>(), k,
+                         id_view.data<id_type>(), distance_view.data<double>(), max_distance);
+}
+
+boost::python::tuple find_within_radius_batch(tracktable::Gazetteer const& gazetteer,
+                                              boost::python::object longitudes,
+                                              boost::python::object latitudes,
+                                              double radius)
+{
+  ArrayView lon_view(longitudes, FLOAT64_CODES, "longitudes");
+  ArrayView lat_view(latitudes, FLOAT64_CODES, "latitudes");
+  check_same_length(lon_view, lat_view);
+
+  std::vector<std::size_t> offsets;
+  std::vector<match_type> matches;
+    {
+    ReleaseGIL unlocked;
+    gazetteer.find_within_radius(lon_view.size(), lon_view.data<double>(), lat_view.data<double>(),
+                                 radius, offsets, matches);
+    }
+
+  std::vector<id_type> row_offsets(offsets.begin(), offsets.end());
+  std::vector<id_type> ids(matches.size());
+  std::vector<double> distances(matches.size());
+  for (std::size_t i = 0; i < matches.size(); ++i)
+    {
+    ids[i] = matches[i].first;
+    distances[i] = matches[i].second;
+    }
+  return boost::python::make_tuple(to_bytearray(row_offsets), to_bytearray(ids), to_bytearray(distances));
+}
+
+boost::python::tuple find_within_box_batch(tracktable::Gazetteer const& gazetteer,
+                                           boost::python::object boxes)
+{
+  ArrayView box_view(boxes, FLOAT64_CODES, "boxes");
+  if (box_view.size() % 4 != 0)
+    {
+    PyErr_SetString(PyExc_ValueError, "Boxes must have 4 values each");
+    boost::python::throw_error_already_set();
+    }
+
+  std::vector<std::size_t> offsets;
+  std::vector<id_type> ids;
+    {
+    ReleaseGIL unlocked;
+    gazetteer.find_within_box(box_view.size() / 4, box_view.data<double>(), offsets, ids);
+    }
+
+  std::vector<id_type> row_offsets(offsets.begin(), offsets.end());
+  return boost::python::make_tuple(to_bytearray(row_offsets), to_bytearray(ids));
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_gazetteer) {
+  using namespace boost::python;
+
+  double infinity = std::numeric_limits<double>::infinity();
+
+  class_<tracktable::Gazetteer>("Gazetteer")
+    .def("build", &build,
+         (arg("longitudes"), arg("latitudes"), arg("ids")=object()))
+    .def("__len__", &tracktable::Gazetteer::size)
+    .def("clear", &tracktable::Gazetteer::clear)
+    .add_property("num_threads",
+                  &tracktable::Gazetteer::num_threads,
+                  &tracktable::Gazetteer::set_num_threads)
+    .def("find_nearest", &find_nearest,
+         (arg("longitude"), arg("latitude"), arg("k")=1, arg("max_distance")=infinity))
+    .def("find_within_radius", &find_within_radius,
+         (arg("longitude"), arg("latitude"), arg("radius")))
+    .def("find_within_box", &find_within_box,
+         (arg("min_longitude"), arg("min_latitude"), arg("max_longitude"), arg("max_latitude")))
+    .def("find_nearest_batch", &find_nearest_batch,
+         (arg("longitudes"), arg("latitudes"), arg("k"), arg("ids"), arg("distances"),
+          arg("max_distance")=infinity))
+    .def("find_within_radius_batch", &find_within_radius_batch,
+         (arg("longitudes"), arg("latitudes"), arg("radius")))
+    .def("find_within_box_batch", &find_within_box_batch, (arg("boxes")))
+    .def("save", &tracktable::Gazetteer::save, (arg("filename"), arg("source_key")))
+    .def("load", &tracktable::Gazetteer::load, (arg("filename"), arg("source_key")))
+    ;
+}
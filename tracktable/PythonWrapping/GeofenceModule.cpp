@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// Tracktable Trajectory Library
+//
+// GeofenceModule - Python bindings for tracktable::GeofenceMonitor
+//
+// Points go in as trajectory points from either the terrestrial or
+// the 2D Cartesian domain.  Events come back as dictionaries that
+// tracktable.applications.geofence turns into named tuples.
+
+#include <tracktable/Analysis/Geofence.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+
+typedef tracktable::GeofenceMonitor::region_id_type region_id_type;
+typedef tracktable::GeofenceMonitor::event_vector_type event_vector_type;
+
+char const* event_type_name(tracktable::GeofenceEventType type)
+{
+  switch (type)
+    {
+    case tracktable::GeofenceEventType::ENTER: return "enter";
+    case tracktable::GeofenceEventType::EXIT: return "exit";
+    case tracktable::GeofenceEventType::DWELL: return "dwell";
+    }
+  return "unknown";
+}
+
+boost::python::list events_to_list(event_vector_type const& events)
+{
+  boost::python::list result;
+  for (std::size_t i = 0; i < events.size(); ++i)
+    {
+    boost::python::dict event;
+    event["object_id"] = events[i].object_id;
+    event["region"] = events[i].region;
+    event["event_type"] = event_type_name(events[i].type);
+    event["timestamp"] = events[i].time;
+    event["longitude"] = events[i].longitude;
+    event["latitude"] = events[i].latitude;
+    event["point_index"] = events[i].point_index;
+    result.append(event);
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+void add_polygon(tracktable::GeofenceMonitor& monitor, region_id_type region,
+                 boost::python::object rings)
+{
+  std::vector<std::vector<double> > native_rings;
+  boost::python::stl_input_iterator<boost::python::object> ring_iter(rings), ring_end;
+  for (; ring_iter != ring_end; ++ring_iter)
+    {
+    std::vector<double> ring;
+    boost::python::stl_input_iterator<boost::python::object> vertex_iter(*ring_iter), vertex_end;
+    for (; vertex_iter != vertex_end; ++vertex_iter)
+      {
+      boost::python::object vertex(*vertex_iter);
+      ring.push_back(boost::python::extract<double>(vertex[0]));
+      ring.push_back(boost::python::extract<double>(vertex[1]));
+      }
+    native_rings.push_back(ring);
+    }
+  monitor.add_polygon(region, native_rings);
+}
+
+double get_dwell_time(tracktable::GeofenceMonitor const& monitor)
+{
+  return static_cast<double>(monitor.dwell_time().total_microseconds()) / 1e6;
+}
+
+void set_dwell_time(tracktable::GeofenceMonitor& monitor, double seconds)
+{
+  monitor.set_dwell_time(boost::posix_time::microseconds(static_cast<std::int64_t>(seconds * 1e6)));
+}
+
+boost::python::list regions_containing(tracktable::GeofenceMonitor const& monitor,
+                                       std::string const& object_id)
+{
+  std::vector<region_id_type> regions(monitor.regions_containing(object_id));
+  boost::python::list result;
+  for (std::size_t i = 0; i < regions.size(); ++i)
+    {
+    result.append(regions[i]);
+    }
+  return result;
+}
+
+boost::python::list update(tracktable::GeofenceMonitor& monitor,
+                           std::string const& object_id,
+                           double longitude, double latitude,
+                           tracktable::Timestamp const& time)
+{
+  event_vector_type events;
+  monitor.update(object_id, longitude, latitude, time, events);
+  return events_to_list(events);
+}
+
+// Copy what the monitor needs out of each point while we still hold
+// the GIL, then let it run without
+boost::python::list process(tracktable::GeofenceMonitor& monitor, boost::python::object points)
+{
+  typedef tracktable::domain::terrestrial::trajectory_point_type terrestrial_point_type;
+  typedef tracktable::domain::cartesian2d::trajectory_point_type cartesian_point_type;
+
+  std::vector<std::string> object_ids;
+  std::vector<double> longitudes, latitudes;
+  std::vector<tracktable::Timestamp> times;
+
+  boost::python::stl_input_iterator<boost::python::object> iter(points), end;
+  for (; iter != end; ++iter)
+    {
+    boost::python::object point(*iter);
+    boost::python::extract<terrestrial_point_type const&> terrestrial(point);
+    if (terrestrial.check())
+      {
+      terrestrial_point_type const& native = terrestrial();
+      object_ids.push_back(native.object_id());
+      longitudes.push_back(native[0]);
+      latitudes.push_back(native[1]);
+      times.push_back(native.timestamp());
+      }
+    else
+      {
+      cartesian_point_type const& native = boost::python::extract<cartesian_point_type const&>(point);
+      object_ids.push_back(native.object_id());
+      longitudes.push_back(native[0]);
+      latitudes.push_back(native[1]);
+      times.push_back(native.timestamp());
+      }
+    }
+
+  event_vector_type events;
+    {
+    ReleaseGIL unlocked;
+    monitor.process(object_ids.size(), object_ids.data(), longitudes.data(), latitudes.data(),
+                    times.data(), events);
+    }
+  return events_to_list(events);
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_geofence) {
+  using namespace boost::python;
+
+  class_<tracktable::GeofenceMonitor, boost::noncopyable>("GeofenceMonitor")
+    .def("add_box", &tracktable::GeofenceMonitor::add_box,
+         (arg("region"), arg("min_longitude"), arg("min_latitude"),
+          arg("max_longitude"), arg("max_latitude")))
+    .def("add_polygon", &add_polygon, (arg("region"), arg("rings")))
+    .def("remove_region", &tracktable::GeofenceMonitor::remove_region, (arg("region")))
+    .def("has_region", &tracktable::GeofenceMonitor::has_region, (arg("region")))
+    .add_property("num_regions", &tracktable::GeofenceMonitor::num_regions)
+    .def("clear_regions", &tracktable::GeofenceMonitor::clear_regions)
+    .add_property("dwell_time", &get_dwell_time, &set_dwell_time)
+    .add_property("num_threads",
+                  &tracktable::GeofenceMonitor::num_threads,
+                  &tracktable::GeofenceMonitor::set_num_threads)
+    .add_property("num_objects", &tracktable::GeofenceMonitor::num_objects)
+    .def("remove_object", &tracktable::GeofenceMonitor::remove_object, (arg("object_id")))
+    .def("clear_objects", &tracktable::GeofenceMonitor::clear_objects)
+    .def("regions_containing", &regions_containing, (arg("object_id")))
+    .def("update", &update,
+         (arg("object_id"), arg("longitude"), arg("latitude"), arg("timestamp")))
+    .def("process", &process, (arg("points")))
+    ;
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// Tracktable Trajectory Library
+//
+// GreatCircleFitModule - Python bindings for the best-fit great circle
+// functions in Analysis/GreatCircleFit.h
+//
+// Plane normals come back as (x, y, z) tuples in ECEF space.
+// tracktable.algorithms.great_circle_fit wraps these functions.
+
+#include <tracktable/Analysis/GreatCircleFit.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::domain::cartesian3d::base_point_type normal_type;
+typedef tracktable::domain::terrestrial::AltitudeUnits units_type;
+
+units_type units_from_name(std::string const& name)
+{
+  if (name == "feet")
+    {
+    return units_type::FEET;
+    }
+  if (name == "meters")
+    {
+    return units_type::METERS;
+    }
+  if (name == "kilometers")
+    {
+    return units_type::KILOMETERS;
+    }
+  throw std::invalid_argument("Altitude units must be 'feet', 'meters' or 'kilometers', not '" + name + "'");
+}
+
+boost::python::tuple normal_to_python(normal_type const& normal)
+{
+  return boost::python::make_tuple(normal[0], normal[1], normal[2]);
+}
+
+normal_type normal_from_python(boost::python::object const& normal)
+{
+  return normal_type(boost::python::extract<double>(normal[0]),
+                     boost::python::extract<double>(normal[1]),
+                     boost::python::extract<double>(normal[2]));
+}
+
+boost::python::tuple find_best_fit_plane(trajectory_type const& trajectory,
+                                         std::string const& altitude_property,
+                                         std::string const& altitude_units)
+{
+  return normal_to_python(
+    tracktable::find_best_fit_plane(trajectory, altitude_property, units_from_name(altitude_units)));
+}
+
+boost::python::list find_best_fit_planes(boost::python::object trajectories,
+                                         std::string const& altitude_property,
+                                         std::string const& altitude_units,
+                                         std::size_t num_threads)
+{
+  units_type units = units_from_name(altitude_units);
+  std::vector<boost::python::object> owners;
+  std::vector<trajectory_type const*> native;
+  tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+
+  std::vector<normal_type> normals;
+  {
+    ReleaseGIL unlock;
+    normals = tracktable::find_best_fit_planes(native, altitude_property, units, num_threads);
+  }
+
+  boost::python::list result;
+  for (std::size_t i = 0; i < normals.size(); ++i)
+    {
+    result.append(normal_to_python(normals[i]));
+    }
+  return result;
+}
+
+trajectory_type project_trajectory_onto_plane(trajectory_type const& trajectory,
+                                              boost::python::object const& normal,
+                                              std::string const& altitude_property,
+                                              std::string const& altitude_units)
+{
+  trajectory_type result(trajectory);
+  tracktable::project_trajectory_onto_plane(result, normal_from_python(normal),
+                                            altitude_property, units_from_name(altitude_units));
+  return result;
+}
+
+void translate_invalid_argument(std::invalid_argument const& e)
+{
+  PyErr_SetString(PyExc_ValueError, e.what());
+}
+
+void translate_runtime_error(std::runtime_error const& e)
+{
+  PyErr_SetString(PyExc_ValueError, e.what());
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_great_circle_fit) {
+  using namespace boost::python;
+
+  register_exception_translator<std::invalid_argument>(&translate_invalid_argument);
+  register_exception_translator<TooFewPoints>(&translate_runtime_error);
+  register_exception_translator<IdenticalPositions>(&translate_runtime_error);
+  register_exception_translator<ZeroNorm>(&translate_runtime_error);
+
+  def("find_best_fit_plane", &find_best_fit_plane,
+      (arg("trajectory"), arg("altitude_property")="altitude", arg("altitude_units")="feet"));
+  def("find_best_fit_planes", &find_best_fit_planes,
+      (arg("trajectories"), arg("altitude_property")="altitude", arg("altitude_units")="feet",
+       arg("num_threads")=0));
+  def("project_trajectory_onto_plane", &project_trajectory_onto_plane,
+      (arg("trajectory"), arg("normal"), arg("altitude_property")="altitude", arg("altitude_units")="feet"));
+}
@@ -0,0 +1,177 @@
+/* Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __tracktable_python_hnsw_index_wrapper_h
+#define __tracktable_python_hnsw_index_wrapper_h
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <tracktable/Analysis/HNSWIndex.h>
+#include <tracktable/Domain/FeatureVectors.h>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+template<typename PointT>
+class HNSWIndexPythonWrapper
+{
+public:
+  typedef PointT point_type;
+  typedef tracktable::HNSWIndex<point_type> index_type;
+
+  HNSWIndexPythonWrapper(std::size_t max_neighbors=16,
+                         std::size_t ef_construction=200,
+                         unsigned int random_seed=100)
+    : Index(max_neighbors, ef_construction, random_seed)
+    { }
+
+  ~HNSWIndexPythonWrapper() { }
+
+  std::size_t size() const
+    {
+      return this->Index.size();
+    }
+
+  std::size_t ef_search() const
+    {
+      return this->Index.ef_search();
+    }
+
+  void set_ef_search(std::size_t ef)
+    {
+      this->Index.set_ef_search(ef);
+    }
+
+  // ---------------------------------------------------------------------
+
+  void insert_point(boost::python::object const& new_point)
+    {
+      point_type native_point((boost::python::extract<point_type>(new_point)));
+      this->Index.insert(native_point);
+    }
+
+  // ---------------------------------------------------------------------
+
+  void insert_points(boost::python::object const& new_points,
+                     std::size_t num_threads)
+    {
+      boost::python::stl_input_iterator<point_type> point_begin(new_points),
+          point_end;
+      std::vector<point_type> native_points(point_begin, point_end);
+
+      tracktable::python_wrapping::ReleaseGIL unlock;
+      this->Index.insert(native_points.begin(), native_points.end(), num_threads);
+    }
+
+  // ----------------------------------------------------------------------
+
+  boost::python::object find_nearest_neighbors(boost::python::object const& search_point,
+                                               std::size_t num_neighbors,
+                                               std::size_t ef)
+    {
+      point_type query_location((boost::python::extract<point_type>(search_point)));
+      typename index_type::neighbor_vector_type neighbors;
+      this->Index.find_nearest_neighbors(query_location, num_neighbors,
+                                         std::back_inserter(neighbors), ef);
+      return neighbor_ids(neighbors);
+    }
+
+  // ----------------------------------------------------------------------
+
+  boost::python::object batch_find_nearest_neighbors(boost::python::object const& search_points,
+                                                     std::size_t num_neighbors,
+                                                     std::size_t num_threads,
+                                                     std::size_t ef)
+    {
+      boost::python::stl_input_iterator<point_type> query_begin(search_points),
+          query_end;
+      std::vector<point_type> queries(query_begin, query_end);
+      std::vector<typename index_type::neighbor_vector_type> neighbors;
+      {
+      tracktable::python_wrapping::ReleaseGIL unlock;
+      neighbors = this->Index.batch_find_nearest_neighbors(
+        queries.begin(), queries.end(), num_neighbors, num_threads, ef);
+      }
+
+      boost::python::list result;
+      for (std::size_t i = 0; i < neighbors.size(); ++i)
+        {
+        result.append(neighbor_ids(neighbors[i]));
+        }
+      return std::move(result);
+    }
+
+  // ----------------------------------------------------------------------
+
+  void save(std::string const& filename) const
+    {
+      std::ofstream outfile(filename.c_str(), std::ios::binary);
+      if (!outfile)
+        {
+        throw std::runtime_error("Could not open " + filename + " for writing");
+        }
+      boost::archive::binary_oarchive archive(outfile);
+      archive << this->Index;
+    }
+
+  // ----------------------------------------------------------------------
+
+  void load(std::string const& filename)
+    {
+      std::ifstream infile(filename.c_str(), std::ios::binary);
+      if (!infile)
+        {
+        throw std::runtime_error("Could not open " + filename + " for reading");
+        }
+      boost::archive::binary_iarchive archive(infile);
+      archive >> this->Index;
+    }
+
+private:
+  static boost::python::object neighbor_ids(
+    typename index_type::neighbor_vector_type const& neighbors)
+    {
+      boost::python::list result;
+      for (std::size_t i = 0; i < neighbors.size(); ++i)
+        {
+        result.append(neighbors[i].first);
+        }
+      return std::move(result);
+    }
+
+  index_type Index;
+};
+
+#endif
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// Tracktable Trajectory Library
+//
+// PolygonLayerModule - Python bindings for tracktable::PolygonLayer
+//
+// Vertices and query points come in through the buffer protocol so
+// that NumPy arrays reach C++ without copying.  Plain sequences of
+// (longitude, latitude) pairs also work for vertices, since that is
+// what shapefile readers hand back.
+
+#include <tracktable/Analysis/PolygonLayer.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+using tracktable::python_wrapping::ArrayView;
+using tracktable::python_wrapping::FLOAT64_CODES;
+using tracktable::python_wrapping::INT64_CODES;
+
+typedef tracktable::PolygonLayer::feature_id_type feature_id_type;
+
+void check_same_length(ArrayView const& longitudes, ArrayView const& latitudes)
+{
+  if (longitudes.size() != latitudes.size())
+    {
+    PyErr_SetString(PyExc_ValueError, "Longitude and latitude arrays must have the same length");
+    boost::python::throw_error_already_set();
+    }
+}
+
+// Flatten vertices into lon, lat, lon, lat, ...  The source is either
+// a float64 array with an even number of values or any sequence of
+// (longitude, latitude) pairs.
+std::vector<double> flatten_vertices(boost::python::object const& vertices)
+{
+  std::vector<double> coordinates;
+  if (PyObject_CheckBuffer(vertices.ptr()))
+    {
+    ArrayView view(vertices, FLOAT64_CODES, "vertices");
+    if (view.size() % 2 != 0)
+      {
+      PyErr_SetString(PyExc_ValueError, "Vertex arrays must hold (longitude, latitude) pairs");
+      boost::python::throw_error_already_set();
+      }
+    coordinates.assign(view.data<double>(), view.data<double>() + view.size());
+    }
+  else
+    {
+    boost::python::stl_input_iterator<boost::python::object> iter(vertices), end;
+    for (; iter != end; ++iter)
+      {
+      boost::python::object vertex(*iter);
+      coordinates.push_back(boost::python::extract<double>(vertex[0]));
+      coordinates.push_back(boost::python::extract<double>(vertex[1]));
+      }
+    }
+  return coordinates;
+}
+
+// ----------------------------------------------------------------------
+
+feature_id_type add_area(tracktable::PolygonLayer& layer, boost::python::object vertices)
+{
+  std::vector<double> coordinates(flatten_vertices(vertices));
+  return layer.add_area(coordinates.size() / 2, coordinates.data());
+}
+
+void add_ring(tracktable::PolygonLayer& layer, feature_id_type area, boost::python::object vertices)
+{
+  std::vector<double> coordinates(flatten_vertices(vertices));
+  layer.add_ring(area, coordinates.size() / 2, coordinates.data());
+}
+
+feature_id_type add_line(tracktable::PolygonLayer& layer, boost::python::object vertices)
+{
+  std::vector<double> coordinates(flatten_vertices(vertices));
+  return layer.add_line(coordinates.size() / 2, coordinates.data());
+}
+
+void build(tracktable::PolygonLayer& layer, std::size_t grid_resolution)
+{
+  ReleaseGIL unlocked;
+  layer.build(grid_resolution);
+}
+
+void locate_batch(tracktable::PolygonLayer const& layer,
+                  boost::python::object longitudes,
+                  boost::python::object latitudes,
+                  boost::python::object features)
+{
+  ArrayView lon_view(longitudes, FLOAT64_CODES, "longitudes");
+  ArrayView lat_view(latitudes, FLOAT64_CODES, "latitudes");
+  ArrayView feature_view(features, INT64_CODES, "features", true);
+  check_same_length(lon_view, lat_view);
+  if (feature_view.size() != lon_view.size())
+    {
+    PyErr_SetString(PyExc_ValueError, "Output array must hold one result for every point");
+    boost::python::throw_error_already_set();
+    }
+
+  ReleaseGIL unlocked;
+  layer.locate(lon_view.size(), lon_view.data<double>(), lat_view.data<double>(),
+               feature_view.data<feature_id_type>());
+}
+
+void distance_to_boundary_batch(tracktable::PolygonLayer const& layer,
+                                boost::python::object longitudes,
+                                boost::python::object latitudes,
+                                boost::python::object distances,
+                                double max_distance)
+{
+  ArrayView lon_view(longitudes, FLOAT64_CODES, "longitudes");
+  ArrayView lat_view(latitudes, FLOAT64_CODES, "latitudes");
+  ArrayView distance_view(distances, FLOAT64_CODES, "distances", true);
+  check_same_length(lon_view, lat_view);
+  if (distance_view.size() != lon_view.size())
+    {
+    PyErr_SetString(PyExc_ValueError, "Output array must hold one result for every point");
+    boost::python::throw_error_already_set();
+    }
+
+  ReleaseGIL unlocked;
+  layer.distance_to_boundary(lon_view.size(), lon_view.data<double>(), lat_view.data<double>(),
+                             distance_view.data<double>(), max_distance);
+}
+
+feature_id_type locate(tracktable::PolygonLayer const& layer, double longitude, double latitude)
+{
+  return layer.locate(longitude, latitude);
+}
+
+double distance_to_boundary(tracktable::PolygonLayer const& layer,
+                            double longitude, double latitude, double max_distance)
+{
+  return layer.distance_to_boundary(longitude, latitude, max_distance);
+}
+
+std::size_t count_crossings(tracktable::PolygonLayer const& layer,
+                            double longitude0, double latitude0,
+                            double longitude1, double latitude1)
+{
+  return layer.count_crossings(longitude0, latitude0, longitude1, latitude1);
+}
+
+// ----------------------------------------------------------------------
+
+template<typename trajectory_type>
+boost::python::list fraction_inside_native(tracktable::PolygonLayer const& layer,
+                                           boost::python::list const& trajectories)
+{
+  std::vector<boost::python::object> owners;
+  std::vector<trajectory_type const*> native;
+  tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+
+  std::vector<double> result;
+    {
+    ReleaseGIL unlocked;
+    result = layer.fraction_inside(native.begin(), native.end());
+    }
+  return tracktable::python_wrapping::to_python_list(result);
+}
+
+template<typename trajectory_type>
+boost::python::list count_crossings_native(tracktable::PolygonLayer const& layer,
+                                           boost::python::list const& trajectories)
+{
+  std::vector<boost::python::object> owners;
+  std::vector<trajectory_type const*> native;
+  tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+
+  std::vector<std::size_t> result;
+    {
+    ReleaseGIL unlocked;
+    result = layer.count_crossings(native.begin(), native.end());
+    }
+  return tracktable::python_wrapping::to_python_list(result);
+}
+
+// Both domains arrive as plain Python objects, so pick the native
+// type by looking at the first trajectory
+bool is_terrestrial(boost::python::list const& trajectories)
+{
+  return (boost::python::len(trajectories) == 0
+          || boost::python::extract<tracktable::domain::terrestrial::trajectory_type const&>(
+               trajectories[0]).check());
+}
+
+boost::python::list fraction_inside(tracktable::PolygonLayer const& layer,
+                                    boost::python::object trajectories)
+{
+  boost::python::list collected(trajectories);
+  if (is_terrestrial(collected))
+    {
+    return fraction_inside_native<tracktable::domain::terrestrial::trajectory_type>(layer, collected);
+    }
+  return fraction_inside_native<tracktable::domain::cartesian2d::trajectory_type>(layer, collected);
+}
+
+boost::python::list count_trajectory_crossings(tracktable::PolygonLayer const& layer,
+                                               boost::python::object trajectories)
+{
+  boost::python::list collected(trajectories);
+  if (is_terrestrial(collected))
+    {
+    return count_crossings_native<tracktable::domain::terrestrial::trajectory_type>(layer, collected);
+    }
+  return count_crossings_native<tracktable::domain::cartesian2d::trajectory_type>(layer, collected);
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_polygon_layer) {
+  using namespace boost::python;
+
+  double infinity = std::numeric_limits<double>::infinity();
+
+  class_<tracktable::PolygonLayer>("PolygonLayer")
+    .def("add_area", &add_area, (arg("vertices")))
+    .def("add_ring", &add_ring, (arg("area"), arg("vertices")))
+    .def("add_line", &add_line, (arg("vertices")))
+    .def("build", &build, (arg("grid_resolution")=1024))
+    .def("clear", &tracktable::PolygonLayer::clear)
+    .add_property("is_built", &tracktable::PolygonLayer::is_built)
+    .add_property("num_features", &tracktable::PolygonLayer::num_features)
+    .add_property("num_edges", &tracktable::PolygonLayer::num_edges)
+    .def("is_area", &tracktable::PolygonLayer::is_area, (arg("feature")))
+    .add_property("num_threads",
+                  &tracktable::PolygonLayer::num_threads,
+                  &tracktable::PolygonLayer::set_num_threads)
+    .def("locate", &locate, (arg("longitude"), arg("latitude")))
+    .def("distance_to_boundary", &distance_to_boundary,
+         (arg("longitude"), arg("latitude"), arg("max_distance")=infinity))
+    .def("count_crossings", &count_crossings,
+         (arg("longitude0"), arg("latitude0"), arg("longitude1"), arg("latitude1")))
+    .def("locate_batch", &locate_batch,
+         (arg("longitudes"), arg("latitudes"), arg("features")))
+    .def("distance_to_boundary_batch", &distance_to_boundary_batch,
+         (arg("longitudes"), arg("latitudes"), arg("distances"), arg("max_distance")=infinity))
+    .def("fraction_inside", &fraction_inside, (arg("trajectories")))
+    .def("count_trajectory_crossings", &count_trajectory_crossings, (arg("trajectories")))
+    ;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// PortalDiscoveryModule - Python bindings for PortalDiscovery
+//
+// The Python layer (tracktable.applications.portal_discovery) picks
+// the function for the trajectories' domain and turns the results
+// into named tuples.
+
+#include <tracktable/Analysis/PortalDiscovery.h>
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/Domain/Cartesian2D.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <vector>
+
+namespace {
+
+template<typename domain_box_type, typename portal_box_type>
+domain_box_type to_domain_box(portal_box_type const& portal)
+{
+  domain_box_type result;
+  for (std::size_t d = 0; d < 2; ++d)
+    {
+    result.min_corner()[d] = portal.min_corner()[d];
+    result.max_corner()[d] = portal.max_corner()[d];
+    }
+  return result;
+}
+
+template<typename trajectory_type, typename base_point_type, typename domain_box_type>
+boost::python::list find_portal_pairs(boost::python::object trajectories,
+                                      base_point_type const& min_corner,
+                                      base_point_type const& max_corner,
+                                      std::size_t x_divisions,
+                                      std::size_t y_divisions,
+                                      std::size_t depth,
+                                      std::size_t subdivisions,
+                                      std::size_t minimum_value,
+                                      double minimum_separation,
+                                      double straightness,
+                                      std::size_t maximum_pairs,
+                                      std::size_t num_threads)
+{
+  typedef tracktable::PortalDiscovery<trajectory_type> discovery_type;
+  typedef typename discovery_type::point_type point_type;
+  typedef typename discovery_type::portal_pair_type portal_pair_type;
+
+  std::vector<boost::python::object> owners;
+  std::vector<trajectory_type const*> native;
+  tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+
+  point_type search_min, search_max;
+  for (std::size_t d = 0; d < 2; ++d)
+    {
+    search_min[d] = min_corner[d];
+    search_max[d] = max_corner[d];
+    }
+
+  discovery_type discovery(search_min, search_max, x_divisions, y_divisions);
+  discovery.set_depth(depth);
+  discovery.set_subdivisions(subdivisions);
+  discovery.set_minimum_value(minimum_value);
+  discovery.set_minimum_separation(minimum_separation);
+  discovery.set_straightness(straightness);
+  discovery.set_maximum_pairs(maximum_pairs);
+  discovery.set_num_threads(num_threads);
+
+  std::vector<portal_pair_type> pairs;
+  {
+    tracktable::python_wrapping::ReleaseGIL unlock;
+    pairs = discovery.find_portal_pairs(native.begin(), native.end());
+  }
+
+  boost::python::list result;
+  for (std::size_t i = 0; i < pairs.size(); ++i)
+    {
+    boost::python::dict pair;
+    pair["first_portal"] = to_domain_box<domain_box_type>(pairs[i].first_portal);
+    pair["second_portal"] = to_domain_box<domain_box_type>(pairs[i].second_portal);
+    pair["value"] = pairs[i].value;
+    pair["separation"] = pairs[i].separation;
+    pair["contributors"] = tracktable::python_wrapping::to_python_list(pairs[i].contributors);
+    result.append(pair);
+    }
+  return result;
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_portal_discovery) {
+  using boost::python::def;
+
+  def("find_portal_pairs_terrestrial",
+      &find_portal_pairs<tracktable::domain::terrestrial::trajectory_type,
+                         tracktable::domain::terrestrial::base_point_type,
+                         tracktable::domain::terrestrial::box_type>);
+
+  def("find_portal_pairs_cartesian2d",
+      &find_portal_pairs<tracktable::domain::cartesian2d::trajectory_type,
+                         tracktable::domain::cartesian2d::base_point_type,
+                         tracktable::domain::cartesian2d::box_type>);
+}
@@ -70,6 +70,11 @@ struct property_value_to_python_object : public boost::static_visitor<PyObject *
       Py_RETURN_NONE;
     }
 
+  result_type operator()(tracktable::SharedString const& text) const
+    {
+      return bp::incref(bp::object(text.str()).ptr());
+    }
+
   template< typename T >
   result_type operator()(T const& t) const
     {
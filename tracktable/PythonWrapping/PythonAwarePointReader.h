@@ -41,6 +41,7 @@
 #define __tracktable_PythonAwarePointReader_h
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/RW/CompressedInputStream.h>
 #include <tracktable/RW/PointReader.h>
 #include <tracktable/PythonWrapping/PythonFileLikeObjectStreams.h>
 #include <boost/iostreams/stream.hpp>
@@ -58,11 +59,13 @@ private:
   typedef base_reader_type Superclass;
   typedef boost::iostreams::stream<PythonReadSource> WrappedPythonStream;
   typedef boost::shared_ptr<WrappedPythonStream> WrappedStreamSmartPointer;
+  typedef boost::shared_ptr<CompressedInputStream> DecompressedStreamSmartPointer;
 
 public:
   typedef typename base_reader_type::iterator iterator;
 
   PythonAwarePointReader()
+    : DecompressionThreads(0)
     { }
 
   virtual ~PythonAwarePointReader()
@@ -71,11 +74,13 @@ public:
 
 
   PythonAwarePointReader(std::istream& infile)
+    : DecompressionThreads(0)
     {
       this->set_input(infile);
     }
 
   PythonAwarePointReader(boost::python::object file_like_object)
+    : DecompressionThreads(0)
     {
       this->set_input_from_python_object(file_like_object);
     }
@@ -84,8 +89,40 @@ public:
   void set_input_from_python_object(boost::python::object& thing)
     {
       this->SourceObject = thing;
+      this->DecompressedInputStream.reset();
       this->WrappedInputStream = WrappedStreamSmartPointer(new WrappedPythonStream(PythonReadSource(thing)));
-      this->set_input(*(this->WrappedInputStream));
+      // gzip and zstd input is recognized by its magic number and
+      // decompressed on the fly.  Anything else passes straight through.
+      this->DecompressedInputStream = DecompressedStreamSmartPointer(
+        new CompressedInputStream(*(this->WrappedInputStream), this->DecompressionThreads));
+      if (!compression_format_supported(this->DecompressedInputStream->format()))
+        {
+        PyErr_SetString(PyExc_IOError, this->DecompressedInputStream->error_message().c_str());
+        boost::python::throw_error_already_set();
+        }
+      this->set_input(*(this->DecompressedInputStream));
+    }
+
+  /// Name of the compression format detected in the input ("none" if uncompressed)
+  std::string compression() const
+    {
+      if (!this->DecompressedInputStream)
+        {
+        return compression_format_name(CompressionFormat::NONE);
+        }
+      return compression_format_name(this->DecompressedInputStream->format());
+    }
+
+  /// Threads used to decompress blocked gzip input; 0 means one per processor
+  std::size_t decompression_threads() const
+    {
+      return this->DecompressionThreads;
+    }
+
+  /// Takes effect the next time the input is set
+  void set_decompression_threads(std::size_t num_threads)
+    {
+      this->DecompressionThreads = num_threads;
     }
 
   boost::python::object input_as_python_object()
@@ -105,6 +142,8 @@ private:
   boost::python::object SourceObject;
 
   WrappedStreamSmartPointer WrappedInputStream;
+  DecompressedStreamSmartPointer DecompressedInputStream;
+  std::size_t DecompressionThreads;
 
 
 public:
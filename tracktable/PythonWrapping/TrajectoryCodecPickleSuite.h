@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// TrajectoryCodecPickleSuite: Pickle trajectories with TrajectoryCodec
+//
+// Trajectories are pickled with the compact binary codec in
+// RW/TrajectoryCodec.h instead of a Boost binary archive.  The codec
+// is lossless and several times smaller, which matters when
+// multiprocessing moves trajectories between processes.
+//
+// Pickles written before the switch hold a Boost archive.  setstate()
+// recognizes them by the missing codec magic number and still loads
+// them.
+
+#ifndef __tracktable_TrajectoryCodecPickleSuite_h
+#define __tracktable_TrajectoryCodecPickleSuite_h
+
+#include <tracktable/PythonWrapping/GenericSerializablePickleSuite.h>
+#include <tracktable/RW/TrajectoryCodec.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace tracktable { namespace python_wrapping {
+
+template<class trajectory_type>
+class TrajectoryCodecPickleSuite : public GenericSerializablePickleSuite<trajectory_type>
+{
+public:
+  typedef GenericSerializablePickleSuite<trajectory_type> Superclass;
+  typedef TrajectoryCodec<trajectory_type> codec_type;
+
+  static boost::python::tuple getstate(boost::python::object object_to_pickle)
+  {
+    trajectory_type const& trajectory = boost::python::extract<trajectory_type const&>(object_to_pickle);
+    std::vector<std::uint8_t> encoded(codec_type().encode(trajectory));
+
+    boost::python::object encoded_bytes(
+      boost::python::handle<>(
+        PyBytes_FromStringAndSize(reinterpret_cast<const char*>(encoded.data()), encoded.size())
+      )
+    );
+
+    return boost::python::make_tuple(encoded_bytes,
+                                     object_to_pickle.attr("__dict__"));
+  }
+
+  static void setstate(boost::python::object& object_to_restore, boost::python::tuple state)
+  {
+    using boost::python::dict;
+    using boost::python::extract;
+
+    Superclass::check_tuple_size(state, 2);
+    Superclass::check_for_bytes(state[0]);
+    Superclass::check_for_dict(state[1]);
+
+    boost::python::object bytes_object = state[0];
+    PyObject* bytes = bytes_object.ptr();
+    const char* bytes_as_c_string = PyBytes_AsString(bytes);
+    Superclass::check_extracted_string(bytes_as_c_string);
+
+    std::uint8_t const* data = reinterpret_cast<std::uint8_t const*>(bytes_as_c_string);
+    std::size_t size = PyBytes_Size(bytes);
+    if (!codec_type::is_encoded(data, size))
+      {
+      Superclass::setstate(object_to_restore, state);
+      return;
+      }
+
+    dict object_dict = extract<dict>(object_to_restore.attr("__dict__"));
+    object_dict.update(state[1]);
+
+    trajectory_type& trajectory = extract<trajectory_type&>(object_to_restore);
+    codec_type().decode(data, size, trajectory);
+  }
+};
+
+} } // namespace tracktable::python_wrapping
+
+#endif
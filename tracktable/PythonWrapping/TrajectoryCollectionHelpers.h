@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// TrajectoryCollectionHelpers - Move collections of trajectories and
+// plain numbers between Python and the batch algorithms in Analysis
+// and RW.
+//
+// The batch algorithms work on random-access sequences of native
+// trajectories.  Copying every trajectory out of a Python list just
+// to look at it would cost more than the algorithms themselves, so
+// extract_trajectories() hands back pointers to the C++ objects held
+// inside the Python wrappers instead.
+//
+// It also holds the small pieces the batch modules all need: a guard
+// that releases the interpreter lock while native code runs, a view of
+// a NumPy-style buffer and a way to hand a vector back as a bytearray.
+
+#ifndef __tracktable_python_TrajectoryCollectionHelpers_h
+#define __tracktable_python_TrajectoryCollectionHelpers_h
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace tracktable { namespace python_wrapping {
+
+/** Release the GIL for as long as this object is in scope
+ *
+ * Nothing that touches a Python object may run while it is.
+ */
+class ReleaseGIL
+{
+public:
+  ReleaseGIL()
+    : State(PyEval_SaveThread())
+    { }
+
+  ~ReleaseGIL()
+    {
+      PyEval_RestoreThread(this->State);
+    }
+
+private:
+  ReleaseGIL(ReleaseGIL const&) = delete;
+  ReleaseGIL& operator=(ReleaseGIL const&) = delete;
+
+  PyThreadState* State;
+};
+
+/// Buffer format codes accepted for float64 arrays
+char const* const FLOAT64_CODES = "d";
+/// Buffer format codes accepted for int64 arrays
+char const* const INT64_CODES = (sizeof(long) == 8 ? "lq" : "q");
+
+/** A contiguous array of 8-byte values borrowed from a Python object
+ * that supports the buffer protocol
+ *
+ * The buffer is released when the view goes out of scope.
+ */
+class ArrayView
+{
+public:
+  /** Borrow the buffer of a Python object
+   *
+   * @param [in] source       Object that supports the buffer protocol
+   * @param [in] type_codes   Accepted buffer format codes (FLOAT64_CODES or INT64_CODES)
+   * @param [in] description  Name of the argument for error messages
+   * @param [in] writable     Whether the buffer must be writable
+   */
+  ArrayView(boost::python::object const& source, char const* type_codes,
+            char const* description, bool writable=false)
+    {
+      int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+      if (PyObject_GetBuffer(source.ptr(), &this->Buffer, flags) != 0)
+        {
+        boost::python::throw_error_already_set();
+        }
+
+      char const* format = (this->Buffer.format ? this->Buffer.format : "B");
+      if (format[0] == '<' || format[0] == '=' || format[0] == '@')
+        {
+        ++format;
+        }
+      if (this->Buffer.itemsize != 8 || std::strlen(format) != 1 || !std::strchr(type_codes, format[0]))
+        {
+        PyBuffer_Release(&this->Buffer);
+        PyErr_SetString(PyExc_TypeError,
+                        (std::string(description) + " must be a contiguous array of 8-byte values").c_str());
+        boost::python::throw_error_already_set();
+        }
+    }
+
+  ~ArrayView()
+    {
+      PyBuffer_Release(&this->Buffer);
+    }
+
+  std::size_t size() const
+    {
+      return static_cast<std::size_t>(this->Buffer.len / this->Buffer.itemsize);
+    }
+
+  template<typename T>
+  T* data() const
+    {
+      return static_cast<T*>(this->Buffer.buf);
+    }
+
+private:
+  ArrayView(ArrayView const&) = delete;
+  ArrayView& operator=(ArrayView const&) = delete;
+
+  Py_buffer Buffer;
+};
+
+/** Copy a std::vector of plain numbers into a new Python bytearray
+ *
+ * Wrap the result with numpy.frombuffer() to get an array without a
+ * further copy.
+ */
+template<typename T>
+boost::python::object to_bytearray(std::vector<T> const& values)
+{
+  PyObject* result = PyByteArray_FromStringAndSize(
+    reinterpret_cast<char const*>(values.data()),
+    static_cast<Py_ssize_t>(values.size() * sizeof(T)));
+  if (!result)
+    {
+    boost::python::throw_error_already_set();
+    }
+  return boost::python::object(boost::python::handle<>(result));
+}
+
+/** Collect pointers to the native trajectories in a Python iterable
+ *
+ * The Python objects are stored in `owners` so that the trajectories
+ * stay alive for as long as the pointers are in use.
+ *
+ * @param [in]  iterable      Any Python iterable of trajectories
+ * @param [out] owners        Python objects that own the trajectories
+ * @param [out] trajectories  Pointers to the native trajectories
+ */
+template<typename trajectory_type>
+void extract_trajectories(boost::python::object const& iterable,
+                          std::vector<boost::python::object>& owners,
+                          std::vector<trajectory_type const*>& trajectories)
+{
+  boost::python::stl_input_iterator<boost::python::object> iter(iterable), end;
+  for (; iter != end; ++iter)
+    {
+    owners.push_back(*iter);
+    trajectory_type const& trajectory = boost::python::extract<trajectory_type const&>(owners.back());
+    trajectories.push_back(&trajectory);
+    }
+}
+
+/// Copy a std::vector into a new Python list
+template<typename value_type>
+boost::python::list to_python_list(std::vector<value_type> const& values)
+{
+  boost::python::list result;
+  for (typename std::vector<value_type>::const_iterator iter = values.begin();
+       iter != values.end(); ++iter)
+    {
+    result.append(*iter);
+    }
+  return result;
+}
+
+} } // namespace tracktable::python_wrapping
+
+#endif
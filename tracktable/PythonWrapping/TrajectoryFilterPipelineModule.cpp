@@ -0,0 +1,290 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// TrajectoryFilterPipelineModule - Python bindings for
+// TrajectoryFilterPipeline
+//
+// Headings are not defined for 3D Cartesian points, so only the
+// terrestrial and 2D Cartesian domains are wrapped.
+//
+// Stages built from the named metrics in filter_metrics run entirely
+// in C++ and in parallel.  Stages that call back into Python run one
+// trajectory at a time because every call needs the interpreter
+// lock; put them after the native stages so that they only see
+// trajectories that survived those.  Without Python stages the
+// interpreter lock is released while the pipeline runs.
+//
+// Time-window stages change the trajectories they pass.  filter()
+// returns new trajectory objects for those; the inputs are never
+// modified.
+
+#include <tracktable/Analysis/TrajectoryFilterPipeline.h>
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/Domain/Cartesian2D.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+
+template<typename TrajectoryT, typename BoxT>
+class PythonTrajectoryFilterPipeline
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef BoxT box_type;
+  typedef tracktable::TrajectoryFilterPipeline<trajectory_type> pipeline_type;
+  typedef typename pipeline_type::feature_cache_type features_type;
+  typedef typename pipeline_type::metric_type metric_type;
+
+  PythonTrajectoryFilterPipeline()
+    : HasPythonStages(false)
+    { }
+
+  void add_range_filter(std::string const& name, std::string const& metric_name,
+                        double minimum, double maximum)
+    {
+      this->Pipeline.add_range_filter(name, this->named_metric(metric_name), minimum, maximum);
+    }
+
+  void add_time_window(std::string const& name,
+                       tracktable::Timestamp const& start,
+                       tracktable::Timestamp const& finish)
+    {
+      this->Pipeline.add_transform(
+        name, tracktable::filter_transforms::clip_to_time_window<trajectory_type>(start, finish));
+    }
+
+  void add_box_filter(std::string const& name,
+                      double min_x, double min_y, double max_x, double max_y)
+    {
+      typedef typename boost::geometry::point_type<box_type>::type corner_type;
+      corner_type min_corner;
+      corner_type max_corner;
+      min_corner.template set<0>(min_x);
+      min_corner.template set<1>(min_y);
+      max_corner.template set<0>(max_x);
+      max_corner.template set<1>(max_y);
+      this->Pipeline.add_predicate(
+        name, tracktable::filter_predicates::intersects_box<features_type>(box_type(min_corner, max_corner)));
+    }
+
+  void add_property_range_filter(std::string const& name, std::string const& property,
+                                 double minimum, double maximum)
+    {
+      this->Pipeline.add_predicate(
+        name, tracktable::filter_predicates::property_in_range<features_type>(property, minimum, maximum));
+    }
+
+  void add_predicate(std::string const& name, boost::python::object predicate)
+    {
+      this->Pipeline.add_predicate(
+        name,
+        [predicate](features_type& features) {
+          // The trajectory in `features` lives in a workspace that is
+          // reused or destroyed once the pipeline finishes, so the
+          // predicate gets its own copy in case it holds on to it.
+          return bool(boost::python::extract<bool>(predicate(boost::python::object(features.trajectory()))));
+        });
+      this->HasPythonStages = true;
+    }
+
+  std::size_t size() const
+    {
+      return this->Pipeline.size();
+    }
+
+  boost::python::list evaluate(boost::python::object trajectories, std::size_t num_threads)
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      std::vector<trajectory_type> changed;
+      return tracktable::python_wrapping::to_python_list(this->run(native, num_threads, changed));
+    }
+
+  boost::python::list filter(boost::python::object trajectories, std::size_t num_threads)
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      std::vector<trajectory_type> changed;
+      std::vector<int> outcome(this->run(native, num_threads, changed));
+
+      boost::python::list survivors;
+      this->RejectionCounts.assign(this->Pipeline.size(), 0);
+      for (std::size_t i = 0; i < outcome.size(); ++i)
+        {
+        if (outcome[i] == pipeline_type::PASSED_ALL_STAGES)
+          {
+          if (this->Pipeline.has_transforms())
+            {
+            survivors.append(boost::python::object(changed[i]));
+            }
+          else
+            {
+            survivors.append(owners[i]);
+            }
+          }
+        else
+          {
+          ++this->RejectionCounts[outcome[i]];
+          }
+        }
+      return survivors;
+    }
+
+  boost::python::list rejection_counts() const
+    {
+      return tracktable::python_wrapping::to_python_list(this->RejectionCounts);
+    }
+
+  bool has_transforms() const
+    {
+      return this->Pipeline.has_transforms();
+    }
+
+private:
+  // Evaluate every trajectory.  If the pipeline has transforms, the
+  // changed version of each survivor is left in `changed`.
+  std::vector<int> run(std::vector<trajectory_type const*> const& trajectories,
+                       std::size_t num_threads,
+                       std::vector<trajectory_type>& changed) const
+    {
+      // Python callbacks cannot run on worker threads while this
+      // thread holds the interpreter lock.
+      if (this->HasPythonStages)
+        {
+        num_threads = 1;
+        }
+      else if (num_threads == 0)
+        {
+        num_threads = tracktable::default_thread_count();
+        }
+
+      std::vector<int> outcome(trajectories.size(), pipeline_type::PASSED_ALL_STAGES);
+      std::vector<features_type> workspaces(num_threads);
+      bool keep_changes = this->Pipeline.has_transforms();
+      if (keep_changes)
+        {
+        changed.resize(trajectories.size());
+        }
+
+      auto evaluate_all = [&]() {
+        tracktable::parallel_for_with_worker(
+          0, trajectories.size(),
+          [&](std::size_t i, std::size_t worker) {
+            features_type& features(workspaces[worker]);
+            features.reset(*trajectories[i]);
+            outcome[i] = this->Pipeline.evaluate(features);
+            if (keep_changes && outcome[i] == pipeline_type::PASSED_ALL_STAGES)
+              {
+              if (features.using_scratch())
+                {
+                std::swap(changed[i], features.scratch());
+                }
+              else
+                {
+                changed[i] = *trajectories[i];
+                }
+              }
+          },
+          num_threads);
+      };
+
+      if (this->HasPythonStages)
+        {
+        evaluate_all();
+        }
+      else
+        {
+        ReleaseGIL unlocked;
+        evaluate_all();
+        }
+      return outcome;
+    }
+
+  metric_type named_metric(std::string const& metric_name) const
+    {
+      namespace metrics = tracktable::filter_metrics;
+      if (metric_name == "length")              return metrics::length<features_type>;
+      if (metric_name == "curvature")           return metrics::curvature<features_type>;
+      if (metric_name == "length_ratio")        return metrics::length_ratio<features_type>;
+      if (metric_name == "hull_gyration_ratio") return metrics::hull_gyration_ratio<features_type>;
+      if (metric_name == "hull_aspect_ratio")   return metrics::hull_aspect_ratio<features_type>;
+      if (metric_name == "straight_fraction")   return metrics::straight_fraction<features_type>;
+      if (metric_name == "turn_arounds")        return metrics::turn_arounds<features_type>;
+
+      PyErr_SetString(PyExc_ValueError, ("Unknown trajectory filter metric: " + metric_name).c_str());
+      boost::python::throw_error_already_set();
+      return metric_type();
+    }
+
+  pipeline_type Pipeline;
+  std::vector<std::size_t> RejectionCounts;
+  bool HasPythonStages;
+};
+
+template<typename trajectory_type, typename box_type>
+void install_filter_pipeline(const char* class_name)
+{
+  using namespace boost::python;
+  typedef PythonTrajectoryFilterPipeline<trajectory_type, box_type> wrapper_type;
+
+  class_<wrapper_type, boost::noncopyable>(class_name)
+    .def("add_range_filter", &wrapper_type::add_range_filter)
+    .def("add_time_window", &wrapper_type::add_time_window)
+    .def("add_box_filter", &wrapper_type::add_box_filter)
+    .def("add_property_range_filter", &wrapper_type::add_property_range_filter)
+    .def("add_predicate", &wrapper_type::add_predicate)
+    .def("evaluate", &wrapper_type::evaluate)
+    .def("filter", &wrapper_type::filter)
+    .def("rejection_counts", &wrapper_type::rejection_counts)
+    .def("has_transforms", &wrapper_type::has_transforms)
+    .def("__len__", &wrapper_type::size)
+    ;
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_trajectory_filter_pipeline) {
+  install_filter_pipeline<tracktable::domain::terrestrial::trajectory_type,
+                          tracktable::domain::terrestrial::box_type>("TerrestrialTrajectoryFilterPipeline");
+  install_filter_pipeline<tracktable::domain::cartesian2d::trajectory_type,
+                          tracktable::domain::cartesian2d::box_type>("Cartesian2DTrajectoryFilterPipeline");
+}
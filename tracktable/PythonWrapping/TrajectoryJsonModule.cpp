@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+// Tracktable Trajectory Library
+//
+// TrajectoryJsonModule - Native JSON and GeoJSON for trajectories
+//
+// tracktable.rw.read_write_json used to build a dictionary for every
+// trajectory and hand it to the json module.  These functions go
+// straight between trajectories and text with TrajectoryJson and
+// produce exactly the same output.
+
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Cartesian3D.h>
+#include <tracktable/RW/CompressedInputStream.h>
+#include <tracktable/RW/TrajectoryJson.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+
+typedef tracktable::domain::terrestrial::trajectory_type terrestrial_trajectory_type;
+typedef tracktable::domain::cartesian2d::trajectory_type cartesian2d_trajectory_type;
+typedef tracktable::domain::cartesian3d::trajectory_type cartesian3d_trajectory_type;
+typedef tracktable::rw::detail::JsonTrajectoryRecord record_type;
+
+void translate_parse_error(tracktable::ParseError const& e)
+{
+  PyErr_SetString(PyExc_ValueError, e.what());
+}
+
+template<typename TrajectoryT>
+boost::python::object trajectory_from_record(record_type const& record)
+{
+  typedef typename boost::python::manage_new_object::apply<TrajectoryT*>::type converter_type;
+  TrajectoryT* trajectory = new TrajectoryT;
+  try
+    {
+    tracktable::TrajectoryJson<TrajectoryT>::from_record(record, *trajectory);
+    }
+  catch (...)
+    {
+    delete trajectory;
+    throw;
+    }
+  converter_type converter;
+  return boost::python::object(boost::python::handle<>(converter(trajectory)));
+}
+
+// Records carry their domain, so we look at that before we decide
+// what kind of trajectory to build.
+boost::python::object trajectory_from_any_record(record_type const& record)
+{
+  if (record.Domain == "terrestrial")
+    {
+    return trajectory_from_record<terrestrial_trajectory_type>(record);
+    }
+  else if (record.Domain == "cartesian2d")
+    {
+    return trajectory_from_record<cartesian2d_trajectory_type>(record);
+    }
+  else if (record.Domain == "cartesian3d")
+    {
+    return trajectory_from_record<cartesian3d_trajectory_type>(record);
+    }
+  throw tracktable::ParseError("Error: invalid domain name: " + record.Domain);
+}
+
+std::vector<record_type> parse_records(char const* data, std::size_t size)
+{
+  std::vector<record_type> records;
+  ReleaseGIL unlocked;
+  tracktable::rw::detail::parse_json_trajectories(
+    data, data + size,
+    [&records](record_type& record) { records.push_back(std::move(record)); });
+  return records;
+}
+
+boost::python::list trajectories_from_records(std::vector<record_type> const& records)
+{
+  boost::python::list result;
+  for (std::vector<record_type>::const_iterator iter = records.begin(); iter != records.end(); ++iter)
+    {
+    result.append(trajectory_from_any_record(*iter));
+    }
+  return result;
+}
+
+// ----------------------------------------------------------------------
+
+boost::python::object trajectory_from_json(std::string const& text)
+{
+  std::vector<record_type> records(parse_records(text.data(), text.size()));
+  if (records.size() != 1)
+    {
+    PyErr_SetString(PyExc_ValueError, "Expected exactly one trajectory in JSON text");
+    boost::python::throw_error_already_set();
+    }
+  return trajectory_from_any_record(records[0]);
+}
+
+boost::python::list trajectories_from_json(std::string const& text)
+{
+  return trajectories_from_records(parse_records(text.data(), text.size()));
+}
+
+boost::python::list trajectories_from_json_file(std::string const& filename,
+                                                std::size_t decompression_threads)
+{
+  std::ifstream infile(filename.c_str(), std::ios::in | std::ios::binary);
+  if (!infile.is_open())
+    {
+    PyErr_SetString(PyExc_IOError, ("Cannot open file " + filename + " for input").c_str());
+    boost::python::throw_error_already_set();
+    }
+
+  std::string text;
+  std::string error_message;
+    {
+    ReleaseGIL unlocked;
+    tracktable::CompressedInputStream input(infile, decompression_threads);
+    text.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    if (input.bad())
+      {
+      error_message = input.error_message();
+      }
+    }
+  if (!error_message.empty())
+    {
+    PyErr_SetString(PyExc_IOError, error_message.c_str());
+    boost::python::throw_error_already_set();
+    }
+  return trajectories_from_json(text);
+}
+
+// ----------------------------------------------------------------------
+
+template<typename TrajectoryT>
+std::string json_from_trajectory(TrajectoryT const& trajectory, bool geojson)
+{
+  tracktable::TrajectoryJson<TrajectoryT> json;
+  json.set_geojson(geojson);
+  return json.encode(trajectory);
+}
+
+template<typename TrajectoryT>
+bool append_if_domain(boost::python::object const& trajectory, bool geojson, std::string& out)
+{
+  boost::python::extract<TrajectoryT const&> extractor(trajectory);
+  if (!extractor.check())
+    {
+    return false;
+    }
+  tracktable::TrajectoryJson<TrajectoryT> json;
+  json.set_geojson(geojson);
+  json.encode(extractor(), out);
+  return true;
+}
+
+void append_any_trajectory(boost::python::object const& trajectory, bool geojson, std::string& out)
+{
+  if (!(append_if_domain<terrestrial_trajectory_type>(trajectory, geojson, out)
+        || append_if_domain<cartesian2d_trajectory_type>(trajectory, geojson, out)
+        || append_if_domain<cartesian3d_trajectory_type>(trajectory, geojson, out)))
+    {
+    PyErr_SetString(PyExc_TypeError, "Expected a terrestrial, cartesian2d or cartesian3d trajectory");
+    boost::python::throw_error_already_set();
+    }
+}
+
+// One trajectory per line
+std::string ndjson_from_trajectories(boost::python::object const& trajectories, bool geojson)
+{
+  std::string out;
+  boost::python::stl_input_iterator<boost::python::object> begin(trajectories), end;
+  for (; begin != end; ++begin)
+    {
+    append_any_trajectory(*begin, geojson, out);
+    out.push_back('\n');
+    }
+  return out;
+}
+
+std::string geojson_from_trajectories(boost::python::object const& trajectories)
+{
+  std::string out("{\"features\": [");
+  boost::python::stl_input_iterator<boost::python::object> begin(trajectories), end;
+  for (bool first = true; begin != end; ++begin, first = false)
+    {
+    if (!first)
+      {
+      out.append(", ");
+      }
+    append_any_trajectory(*begin, true, out);
+    }
+  out.append("], \"type\": \"FeatureCollection\"}");
+  return out;
+}
+
+template<typename TrajectoryT>
+void install_domain_functions()
+{
+  using namespace boost::python;
+
+  def("json_from_trajectory", &json_from_trajectory<TrajectoryT>,
+      (arg("trajectory"), arg("geojson")=false));
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_trajectory_json) {
+  using namespace boost::python;
+
+  register_exception_translator<tracktable::ParseError>(&translate_parse_error);
+
+  install_domain_functions<terrestrial_trajectory_type>();
+  install_domain_functions<cartesian2d_trajectory_type>();
+  install_domain_functions<cartesian3d_trajectory_type>();
+
+  def("trajectory_from_json", &trajectory_from_json, (arg("text")));
+  def("trajectories_from_json", &trajectories_from_json, (arg("text")));
+  def("trajectories_from_json_file", &trajectories_from_json_file,
+      (arg("filename"), arg("decompression_threads")=0));
+  def("ndjson_from_trajectories", &ndjson_from_trajectories,
+      (arg("trajectories"), arg("geojson")=false));
+  def("geojson_from_trajectories", &geojson_from_trajectories, (arg("trajectories")));
+}
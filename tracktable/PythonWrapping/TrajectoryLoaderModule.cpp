@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// TrajectoryLoaderModule - Read, parse and assemble a whole file of
+// points in C++
+//
+// tracktable.rw.load.load_trajectories used to pull every point
+// through a Python iterator and assemble trajectories in Python.  The
+// loaders here run PointReader and AssembleTrajectories over the file
+// with the GIL released and only touch Python to hand back the
+// finished list.
+
+#include <tracktable/Analysis/AssembleTrajectories.h>
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Cartesian3D.h>
+#include <tracktable/RW/CompressedInputStream.h>
+#include <tracktable/RW/PointReader.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+using tracktable::python_wrapping::ReleaseGIL;
+
+// Hand a native object over to Python without copying it.  The
+// Python wrapper takes ownership.
+template<typename T>
+boost::python::object to_python_owned(T&& value)
+{
+  typedef typename std::decay<T>::type value_type;
+  typename boost::python::manage_new_object::apply<value_type*>::type converter;
+  return boost::python::object(boost::python::handle<>(converter(new value_type(std::move(value)))));
+}
+
+template<typename T>
+boost::python::list to_python_owned_list(std::vector<T>& values)
+{
+  boost::python::list result;
+  for (typename std::vector<T>::iterator iter = values.begin(); iter != values.end(); ++iter)
+    {
+    result.append(to_python_owned(std::move(*iter)));
+    }
+  values.clear();
+  return result;
+}
+
+template<typename TrajectoryT>
+class PythonTrajectoryLoader
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef tracktable::PointReader<point_type> reader_type;
+  typedef tracktable::AssembleTrajectories<trajectory_type, typename reader_type::iterator> assembler_type;
+
+  PythonTrajectoryLoader()
+    : DecompressionThreads(0)
+    { }
+
+  // Point reader configuration
+
+  void set_comment_character(std::string const& comment)
+    {
+      this->Reader.set_comment_character(comment);
+    }
+
+  void set_field_delimiter(std::string const& delimiter)
+    {
+      this->Reader.set_field_delimiter(delimiter);
+    }
+
+  void set_null_value(std::string const& value)
+    {
+      this->Reader.set_null_value(value);
+    }
+
+  void set_timestamp_format(std::string const& format)
+    {
+      this->Reader.set_timestamp_format(format);
+    }
+
+  void set_object_id_column(int column)
+    {
+      this->Reader.set_object_id_column(column);
+    }
+
+  void set_timestamp_column(int column)
+    {
+      this->Reader.set_timestamp_column(column);
+    }
+
+  void set_coordinate_column(int coordinate, int column)
+    {
+      this->Reader.set_coordinate_column(coordinate, column);
+    }
+
+  void set_real_field_column(std::string const& field, int column)
+    {
+      this->Reader.set_real_field_column(field, column);
+    }
+
+  void set_string_field_column(std::string const& field, int column)
+    {
+      this->Reader.set_string_field_column(field, column);
+    }
+
+  void set_time_field_column(std::string const& field, int column)
+    {
+      this->Reader.set_time_field_column(field, column);
+    }
+
+  void set_required_properties(boost::python::object const& names)
+    {
+      std::vector<std::string> required;
+      boost::python::stl_input_iterator<std::string> iter(names), end;
+      for (; iter != end; ++iter)
+        {
+        required.push_back(*iter);
+        }
+      this->Reader.set_required_properties(required);
+    }
+
+  void set_lazy_properties(bool onoff)
+    {
+      this->Reader.set_lazy_properties(onoff);
+    }
+
+  void set_decompression_threads(std::size_t num_threads)
+    {
+      this->DecompressionThreads = num_threads;
+    }
+
+  // Assembler configuration
+
+  void set_separation_distance(double distance)
+    {
+      this->Assembler.set_separation_distance(distance);
+    }
+
+  void clear_separation_distance()
+    {
+      this->Assembler.set_separation_distance(std::numeric_limits<double>::max());
+    }
+
+  void set_separation_time(tracktable::Duration const& duration)
+    {
+      this->Assembler.set_separation_time(duration);
+    }
+
+  void set_minimum_length(std::size_t length)
+    {
+      this->Assembler.set_minimum_trajectory_length(length);
+    }
+
+  // Loading
+
+  boost::python::list load_points(std::string const& filename)
+    {
+      std::vector<point_type> points;
+      std::ifstream infile;
+      this->open(filename, infile);
+        {
+        ReleaseGIL unlocked;
+        tracktable::CompressedInputStream input(infile, this->DecompressionThreads);
+        this->Reader.set_input(input);
+        for (typename reader_type::iterator iter = this->Reader.begin(); iter != this->Reader.end(); ++iter)
+          {
+          points.push_back(*iter);
+          }
+        this->check_stream(input);
+        }
+      this->raise_stream_error();
+      return to_python_owned_list(points);
+    }
+
+  boost::python::list load_trajectories(std::string const& filename)
+    {
+      std::vector<trajectory_type> trajectories;
+      std::ifstream infile;
+      this->open(filename, infile);
+        {
+        ReleaseGIL unlocked;
+        tracktable::CompressedInputStream input(infile, this->DecompressionThreads);
+        this->Reader.set_input(input);
+        this->Assembler.set_input(this->Reader.begin(), this->Reader.end());
+        for (typename assembler_type::iterator iter = this->Assembler.begin(); iter != this->Assembler.end(); ++iter)
+          {
+          trajectories.push_back(*iter);
+          }
+        this->check_stream(input);
+        }
+      this->raise_stream_error();
+      return to_python_owned_list(trajectories);
+    }
+
+private:
+  void open(std::string const& filename, std::ifstream& infile)
+    {
+      infile.open(filename.c_str(), std::ios::in | std::ios::binary);
+      if (!infile.is_open())
+        {
+        PyErr_SetString(PyExc_IOError, ("Cannot open file " + filename + " for input").c_str());
+        boost::python::throw_error_already_set();
+        }
+    }
+
+  // Runs without the GIL: just remember what went wrong
+  void check_stream(tracktable::CompressedInputStream const& input)
+    {
+      this->StreamError.clear();
+      if (input.bad())
+        {
+        this->StreamError = input.error_message();
+        }
+    }
+
+  void raise_stream_error()
+    {
+      if (!this->StreamError.empty())
+        {
+        PyErr_SetString(PyExc_IOError, this->StreamError.c_str());
+        boost::python::throw_error_already_set();
+        }
+    }
+
+  reader_type Reader;
+  assembler_type Assembler;
+  std::size_t DecompressionThreads;
+  std::string StreamError;
+};
+
+template<typename trajectory_type>
+void install_loader(const char* class_name)
+{
+  using namespace boost::python;
+  typedef PythonTrajectoryLoader<trajectory_type> wrapper_type;
+
+  class_<wrapper_type, boost::noncopyable>(class_name)
+    .def("set_comment_character", &wrapper_type::set_comment_character)
+    .def("set_field_delimiter", &wrapper_type::set_field_delimiter)
+    .def("set_null_value", &wrapper_type::set_null_value)
+    .def("set_timestamp_format", &wrapper_type::set_timestamp_format)
+    .def("set_object_id_column", &wrapper_type::set_object_id_column)
+    .def("set_timestamp_column", &wrapper_type::set_timestamp_column)
+    .def("set_coordinate_column", &wrapper_type::set_coordinate_column)
+    .def("set_real_field_column", &wrapper_type::set_real_field_column)
+    .def("set_string_field_column", &wrapper_type::set_string_field_column)
+    .def("set_time_field_column", &wrapper_type::set_time_field_column)
+    .def("set_required_properties", &wrapper_type::set_required_properties)
+    .def("set_lazy_properties", &wrapper_type::set_lazy_properties)
+    .def("set_decompression_threads", &wrapper_type::set_decompression_threads)
+    .def("set_separation_distance", &wrapper_type::set_separation_distance)
+    .def("clear_separation_distance", &wrapper_type::clear_separation_distance)
+    .def("set_separation_time", &wrapper_type::set_separation_time)
+    .def("set_minimum_length", &wrapper_type::set_minimum_length)
+    .def("load_points", &wrapper_type::load_points)
+    .def("load_trajectories", &wrapper_type::load_trajectories)
+    ;
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_trajectory_loader) {
+  install_loader<tracktable::domain::terrestrial::trajectory_type>("TerrestrialTrajectoryLoader");
+  install_loader<tracktable::domain::cartesian2d::trajectory_type>("Cartesian2DTrajectoryLoader");
+  install_loader<tracktable::domain::cartesian3d::trajectory_type>("Cartesian3DTrajectoryLoader");
+}
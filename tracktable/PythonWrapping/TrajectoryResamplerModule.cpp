@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// TrajectoryResamplerModule - Python bindings for TrajectoryResampler
+//
+// The resampler is wrapped once per domain.
+// tracktable.algorithms.resample picks the right one and turns column
+// output into NumPy arrays.
+
+#include <tracktable/Analysis/TrajectoryResampler.h>
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Cartesian3D.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+template<typename TrajectoryT>
+class PythonTrajectoryResampler
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef tracktable::TrajectoryResampler<trajectory_type> resampler_type;
+  typedef typename resampler_type::columns_type columns_type;
+
+  void interpolate_property(std::string const& name)
+    {
+      this->Resampler.interpolate_property(name);
+    }
+
+  void copy_property(std::string const& name)
+    {
+      this->Resampler.copy_property(name);
+    }
+
+  void set_num_threads(std::size_t num_threads)
+    {
+      this->Resampler.set_num_threads(num_threads);
+    }
+
+  trajectory_type resample_at_times(trajectory_type const& path,
+                                    boost::python::object times) const
+    {
+      return this->Resampler.resample(path, extract_times(times));
+    }
+
+  trajectory_type resample_at_interval(trajectory_type const& path,
+                                       tracktable::Duration const& interval) const
+    {
+      return this->Resampler.resample(path, interval);
+    }
+
+  boost::python::list resample_collection_at_times(boost::python::object trajectories,
+                                                   boost::python::object times) const
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      return tracktable::python_wrapping::to_python_list(
+        this->Resampler.resample(native.begin(), native.end(), extract_times(times)));
+    }
+
+  boost::python::list resample_collection_at_interval(boost::python::object trajectories,
+                                                      tracktable::Duration const& interval) const
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      return tracktable::python_wrapping::to_python_list(
+        this->Resampler.resample(native.begin(), native.end(), interval));
+    }
+
+  boost::python::dict columns_at_times(boost::python::object trajectories,
+                                       boost::python::object times) const
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      return to_python_dict(
+        this->Resampler.resample_columns(native.begin(), native.end(), extract_times(times)));
+    }
+
+  boost::python::dict columns_at_interval(boost::python::object trajectories,
+                                          tracktable::Duration const& interval) const
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      return to_python_dict(
+        this->Resampler.resample_columns(native.begin(), native.end(), interval));
+    }
+
+private:
+  static std::vector<tracktable::Timestamp> extract_times(boost::python::object times)
+    {
+      boost::python::stl_input_iterator<tracktable::Timestamp> begin(times), end;
+      return std::vector<tracktable::Timestamp>(begin, end);
+    }
+
+  static boost::python::dict to_python_dict(columns_type const& columns)
+    {
+      using tracktable::python_wrapping::to_python_list;
+
+      boost::python::list coordinates;
+      for (std::size_t d = 0; d < columns.coordinates.size(); ++d)
+        {
+        coordinates.append(to_python_list(columns.coordinates[d]));
+        }
+
+      boost::python::dict properties;
+      for (std::size_t i = 0; i < columns.property_names.size(); ++i)
+        {
+        properties[columns.property_names[i]] = to_python_list(columns.properties[i]);
+        }
+
+      boost::python::dict result;
+      result["offsets"] = to_python_list(columns.offsets);
+      result["object_ids"] = to_python_list(columns.object_ids);
+      result["timestamps"] = to_python_list(columns.timestamps);
+      result["coordinates"] = coordinates;
+      result["properties"] = properties;
+      return result;
+    }
+
+  resampler_type Resampler;
+};
+
+void translate_invalid_argument(std::invalid_argument const& e)
+{
+  PyErr_SetString(PyExc_ValueError, e.what());
+}
+
+template<typename trajectory_type>
+void install_resampler(const char* class_name)
+{
+  using namespace boost::python;
+  typedef PythonTrajectoryResampler<trajectory_type> wrapper_type;
+
+  class_<wrapper_type, boost::noncopyable>(class_name)
+    .def("interpolate_property", &wrapper_type::interpolate_property)
+    .def("copy_property", &wrapper_type::copy_property)
+    .def("set_num_threads", &wrapper_type::set_num_threads)
+    .def("resample_at_times", &wrapper_type::resample_at_times)
+    .def("resample_at_interval", &wrapper_type::resample_at_interval)
+    .def("resample_collection_at_times", &wrapper_type::resample_collection_at_times)
+    .def("resample_collection_at_interval", &wrapper_type::resample_collection_at_interval)
+    .def("columns_at_times", &wrapper_type::columns_at_times)
+    .def("columns_at_interval", &wrapper_type::columns_at_interval)
+    ;
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_trajectory_resampler) {
+  boost::python::register_exception_translator<std::invalid_argument>(&translate_invalid_argument);
+
+  install_resampler<tracktable::domain::terrestrial::trajectory_type>("TerrestrialTrajectoryResampler");
+  install_resampler<tracktable::domain::cartesian2d::trajectory_type>("Cartesian2DTrajectoryResampler");
+  install_resampler<tracktable::domain::cartesian3d::trajectory_type>("Cartesian3DTrajectoryResampler");
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Tracktable Trajectory Library
+//
+// TrajectorySimilarityModule - Python bindings for the trajectory
+// distances in TrajectorySimilarity and for
+// TrajectorySimilaritySearch
+//
+// The distances are overloaded for each domain.  The search index is
+// wrapped once per domain; tracktable.algorithms.similarity picks
+// the right one.
+
+#include <tracktable/Analysis/TrajectorySimilarity.h>
+#include <tracktable/Analysis/TrajectorySimilaritySearch.h>
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Cartesian3D.h>
+
+#include <tracktable/PythonWrapping/GuardedBoostPythonHeaders.h>
+#include <tracktable/PythonWrapping/TrajectoryCollectionHelpers.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+tracktable::SimilarityMeasure measure_from_name(std::string const& name)
+{
+  if (name == "frechet")   return tracktable::SimilarityMeasure::DISCRETE_FRECHET;
+  if (name == "dtw")       return tracktable::SimilarityMeasure::DYNAMIC_TIME_WARPING;
+  if (name == "hausdorff") return tracktable::SimilarityMeasure::HAUSDORFF;
+
+  PyErr_SetString(PyExc_ValueError, ("Unknown trajectory similarity measure: " + name).c_str());
+  boost::python::throw_error_already_set();
+  return tracktable::SimilarityMeasure::DISCRETE_FRECHET;
+}
+
+template<typename trajectory_type>
+double frechet_distance(trajectory_type const& first, trajectory_type const& second,
+                        std::size_t band, double cutoff)
+{
+  return tracktable::discrete_frechet_distance(first, second, band, cutoff);
+}
+
+template<typename trajectory_type>
+double dtw_distance(trajectory_type const& first, trajectory_type const& second,
+                    std::size_t band, double cutoff)
+{
+  return tracktable::dynamic_time_warping_distance(first, second, band, cutoff);
+}
+
+template<typename trajectory_type>
+double hausdorff_distance(trajectory_type const& first, trajectory_type const& second,
+                          double cutoff)
+{
+  return tracktable::hausdorff_distance(first, second, cutoff);
+}
+
+template<typename TrajectoryT>
+class PythonTrajectorySimilaritySearch
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef tracktable::TrajectorySimilaritySearch<trajectory_type> search_type;
+  typedef typename search_type::match_type match_type;
+
+  PythonTrajectorySimilaritySearch(std::string const& measure, std::size_t band,
+                                   std::size_t num_threads)
+    : Search(measure_from_name(measure), band)
+    {
+      this->Search.set_num_threads(num_threads);
+    }
+
+  void insert(boost::python::object trajectories)
+    {
+      std::vector<boost::python::object> owners;
+      std::vector<trajectory_type const*> native;
+      tracktable::python_wrapping::extract_trajectories(trajectories, owners, native);
+      for (std::size_t i = 0; i < native.size(); ++i)
+        {
+        this->Search.insert(*native[i]);
+        }
+    }
+
+  boost::python::list find_nearest(trajectory_type const& query, std::size_t k) const
+    {
+      std::vector<match_type> matches(this->Search.find_nearest(query, k));
+      boost::python::list result;
+      for (std::size_t i = 0; i < matches.size(); ++i)
+        {
+        result.append(boost::python::make_tuple(matches[i].first, matches[i].second));
+        }
+      return result;
+    }
+
+  std::size_t size() const
+    {
+      return this->Search.size();
+    }
+
+private:
+  search_type Search;
+};
+
+template<typename trajectory_type>
+void install_similarity(const char* search_class_name)
+{
+  using namespace boost::python;
+  typedef PythonTrajectorySimilaritySearch<trajectory_type> wrapper_type;
+
+  def("frechet_distance", &frechet_distance<trajectory_type>);
+  def("dtw_distance", &dtw_distance<trajectory_type>);
+  def("hausdorff_distance", &hausdorff_distance<trajectory_type>);
+
+  class_<wrapper_type, boost::noncopyable>(search_class_name,
+                                            init<std::string, std::size_t, std::size_t>())
+    .def("insert", &wrapper_type::insert)
+    .def("find_nearest", &wrapper_type::find_nearest)
+    .def("__len__", &wrapper_type::size)
+    ;
+}
+
+} // anonymous namespace
+
+BOOST_PYTHON_MODULE(_trajectory_similarity) {
+  install_similarity<tracktable::domain::terrestrial::trajectory_type>("TerrestrialTrajectorySimilaritySearch");
+  install_similarity<tracktable::domain::cartesian2d::trajectory_type>("Cartesian2DTrajectorySimilaritySearch");
+  install_similarity<tracktable::domain::cartesian3d::trajectory_type>("Cartesian3DTrajectorySimilaritySearch");
+}
@@ -0,0 +1,783 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "CompressedInputStream.h"
+
+#include <tracktable/Core/ParallelFor.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+# include <zlib.h>
+#endif
+
+#if defined(TRACKTABLE_HAVE_ZSTD)
+# include <zstd.h>
+#endif
+
+namespace tracktable {
+
+namespace {
+
+// Enough bytes to recognize every format, including the BGZF extra field
+const std::size_t MAGIC_NUMBER_SIZE = 18;
+
+// Compressed bytes handed to the streaming decompressor at once
+const std::size_t STREAM_CHUNK_SIZE = 256 * 1024;
+
+// Uncompressed bytes passed through per underflow() when there is
+// nothing to decompress
+const std::size_t PASSTHROUGH_CHUNK_SIZE = 64 * 1024;
+
+// How far ahead of the reader the decompression threads may get
+const std::size_t STREAM_CHUNKS_IN_FLIGHT = 4;
+const std::size_t BGZF_BLOCKS_PER_THREAD = 8;
+
+// No BGZF block inflates to more than this
+const std::uint32_t MAX_BGZF_BLOCK_SIZE = 65536;
+
+inline unsigned int byte_at(char const* data, std::size_t offset)
+{
+  return static_cast<unsigned char>(data[offset]);
+}
+
+inline unsigned int little_endian_16(char const* data, std::size_t offset)
+{
+  return byte_at(data, offset) | (byte_at(data, offset + 1) << 8);
+}
+
+inline std::uint32_t little_endian_32(char const* data, std::size_t offset)
+{
+  return static_cast<std::uint32_t>(little_endian_16(data, offset))
+    | (static_cast<std::uint32_t>(little_endian_16(data, offset + 2)) << 16);
+}
+
+} // anonymous namespace
+
+std::string compression_format_name(CompressionFormat format)
+{
+  switch (format)
+    {
+    case CompressionFormat::GZIP: return "gzip";
+    case CompressionFormat::BGZF: return "bgzf";
+    case CompressionFormat::ZSTD: return "zstd";
+    default: return "none";
+    }
+}
+
+CompressionFormat detect_compression(char const* data, std::size_t size)
+{
+  if (size >= 4
+      && byte_at(data, 0) == 0x28 && byte_at(data, 1) == 0xb5
+      && byte_at(data, 2) == 0x2f && byte_at(data, 3) == 0xfd)
+    {
+    return CompressionFormat::ZSTD;
+    }
+
+  if (size >= 3
+      && byte_at(data, 0) == 0x1f && byte_at(data, 1) == 0x8b
+      && byte_at(data, 2) == 0x08)
+    {
+    // BGZF is gzip with a 6-byte extra field holding the 'BC'
+    // subfield, which records the size of the block.
+    if (size >= MAGIC_NUMBER_SIZE
+        && (byte_at(data, 3) & 0x04) != 0
+        && little_endian_16(data, 10) == 6
+        && data[12] == 'B' && data[13] == 'C'
+        && little_endian_16(data, 14) == 2)
+      {
+      return CompressionFormat::BGZF;
+      }
+    return CompressionFormat::GZIP;
+    }
+
+  return CompressionFormat::NONE;
+}
+
+bool compression_format_supported(CompressionFormat format)
+{
+  switch (format)
+    {
+    case CompressionFormat::NONE:
+      return true;
+    case CompressionFormat::GZIP:
+    case CompressionFormat::BGZF:
+#if defined(TRACKTABLE_HAVE_ZLIB)
+      return true;
+#else
+      return false;
+#endif
+    case CompressionFormat::ZSTD:
+#if defined(TRACKTABLE_HAVE_ZSTD)
+      return true;
+#else
+      return false;
+#endif
+    }
+  return false;
+}
+
+// ----------------------------------------------------------------------
+
+namespace detail {
+
+/*
+ * Stream buffer that does the work for CompressedInputStream.
+ *
+ * The reading thread cuts the compressed source into jobs: one BGZF
+ * block each, or a fixed-size chunk for the other formats.  Jobs are
+ * queued in source order.  Worker threads inflate them and the
+ * reading thread hands out their output in the same order.  Before
+ * it waits for the oldest job, underflow() tops up the queue so that
+ * the workers always have something to do while the parser runs.
+ *
+ * BGZF blocks are independent and any worker may take any block.
+ * gzip and zstd streams carry state from one chunk to the next, so
+ * those get exactly one worker, which takes chunks in order.
+ */
+class DecompressingStreamBuffer : public std::streambuf
+{
+public:
+  DecompressingStreamBuffer(std::istream& source, std::size_t num_threads)
+    : Source(source)
+    , Format(CompressionFormat::NONE)
+    , PrefixSize(0)
+    , PrefixOffset(0)
+    , SourceExhausted(false)
+    , Failed(false)
+    , Stopping(false)
+    , MaxJobsInFlight(STREAM_CHUNKS_IN_FLIGHT)
+    , BlocksRead(0)
+    {
+      this->PrefixSize = this->read_source_directly(this->Prefix, MAGIC_NUMBER_SIZE);
+      this->Format = detect_compression(this->Prefix, this->PrefixSize);
+
+      if (this->Format == CompressionFormat::NONE)
+        {
+        return;
+        }
+
+      if (!compression_format_supported(this->Format))
+        {
+        this->fail("Input is compressed with "
+                   + compression_format_name(this->Format)
+                   + " but Tracktable was built without support for it");
+        return;
+        }
+
+      if (this->Format == CompressionFormat::BGZF)
+        {
+        if (num_threads == 0)
+          {
+          num_threads = default_thread_count();
+          }
+        this->MaxJobsInFlight = BGZF_BLOCKS_PER_THREAD * num_threads;
+        }
+      else
+        {
+        num_threads = 1;
+        }
+
+      // The destructor will not run if starting a thread throws, so
+      // the threads that did start have to be stopped here.
+      try
+        {
+        this->Workers.reserve(num_threads);
+        for (std::size_t i = 0; i < num_threads; ++i)
+          {
+          if (this->Format == CompressionFormat::BGZF)
+            {
+            this->Workers.push_back(std::thread(&DecompressingStreamBuffer::run_bgzf_worker, this));
+            }
+          else
+            {
+            this->Workers.push_back(std::thread(&DecompressingStreamBuffer::run_stream_worker, this));
+            }
+          }
+        }
+      catch (...)
+        {
+        this->stop_workers();
+        throw;
+        }
+    }
+
+  virtual ~DecompressingStreamBuffer()
+    {
+      this->stop_workers();
+    }
+
+  CompressionFormat format() const
+    {
+      return this->Format;
+    }
+
+  std::string error_message() const
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      return this->ErrorMessage;
+    }
+
+protected:
+  int_type underflow() override
+    {
+      if (this->gptr() < this->egptr())
+        {
+        return traits_type::to_int_type(*this->gptr());
+        }
+
+      if (this->Format == CompressionFormat::NONE)
+        {
+        return this->underflow_passthrough();
+        }
+
+      while (true)
+        {
+        this->check_failure();
+        this->queue_more_jobs();
+
+        std::unique_lock<std::mutex> lock(this->Mutex);
+        if (this->InFlight.empty())
+          {
+          return traits_type::eof();
+          }
+        std::shared_ptr<Job> next = this->InFlight.front();
+        this->JobFinished.wait(lock, [&next, this]() { return next->Finished || this->Failed; });
+        if (!next->Finished)
+          {
+          continue;
+          }
+        this->InFlight.pop_front();
+        lock.unlock();
+
+        if (!next->Error.empty())
+          {
+          this->fail(next->Error);
+          continue;
+          }
+        if (next->Output.empty())
+          {
+          continue;
+          }
+        this->Current.swap(next->Output);
+        char* begin = &this->Current[0];
+        this->setg(begin, begin, begin + this->Current.size());
+        return traits_type::to_int_type(*this->gptr());
+        }
+    }
+
+private:
+  struct Job
+  {
+    Job() : Last(false), Finished(false) { }
+
+    std::string Input;
+    std::string Output;
+    std::string Error;
+    bool Last;
+    bool Finished;
+  };
+
+  typedef std::shared_ptr<Job> JobPointer;
+
+  // Read from the source, starting with the bytes we used to detect
+  // the format.  Only ever called on the reading thread.
+  std::size_t read_source(char* destination, std::size_t count)
+    {
+      std::size_t from_prefix = std::min(count, this->PrefixSize - this->PrefixOffset);
+      std::memcpy(destination, this->Prefix + this->PrefixOffset, from_prefix);
+      this->PrefixOffset += from_prefix;
+      return from_prefix + this->read_source_directly(destination + from_prefix, count - from_prefix);
+    }
+
+  std::size_t read_source_directly(char* destination, std::size_t count)
+    {
+      if (count == 0 || this->SourceExhausted)
+        {
+        return 0;
+        }
+      this->Source.read(destination, static_cast<std::streamsize>(count));
+      std::size_t bytes_read = static_cast<std::size_t>(this->Source.gcount());
+      if (bytes_read < count)
+        {
+        this->SourceExhausted = true;
+        }
+      return bytes_read;
+    }
+
+  int_type underflow_passthrough()
+    {
+      this->Current.resize(PASSTHROUGH_CHUNK_SIZE);
+      std::size_t bytes_read = this->read_source(&this->Current[0], PASSTHROUGH_CHUNK_SIZE);
+      if (bytes_read == 0)
+        {
+        return traits_type::eof();
+        }
+      char* begin = &this->Current[0];
+      this->setg(begin, begin, begin + bytes_read);
+      return traits_type::to_int_type(*this->gptr());
+    }
+
+  // Cut more of the source into jobs until enough are in flight.
+  void queue_more_jobs()
+    {
+      while (true)
+        {
+          {
+          std::lock_guard<std::mutex> lock(this->Mutex);
+          if (this->InFlight.size() >= this->MaxJobsInFlight)
+            {
+            return;
+            }
+          }
+
+        JobPointer job(new Job);
+        bool have_job = (this->Format == CompressionFormat::BGZF)
+          ? this->read_bgzf_block(*job)
+          : this->read_stream_chunk(*job);
+        if (!have_job)
+          {
+          return;
+          }
+
+          {
+          std::lock_guard<std::mutex> lock(this->Mutex);
+          this->InFlight.push_back(job);
+          this->Pending.push_back(job);
+          }
+        this->WorkAvailable.notify_one();
+        }
+    }
+
+  bool read_stream_chunk(Job& job)
+    {
+      if (this->SourceExhausted && this->PrefixOffset == this->PrefixSize)
+        {
+        return false;
+        }
+      job.Input.resize(STREAM_CHUNK_SIZE);
+      job.Input.resize(this->read_source(&job.Input[0], STREAM_CHUNK_SIZE));
+      // An empty final chunk still gets queued so that the worker can
+      // check that the stream ended cleanly.
+      job.Last = (this->SourceExhausted && this->PrefixOffset == this->PrefixSize);
+      return true;
+    }
+
+  bool read_bgzf_block(Job& job)
+    {
+      char header[MAGIC_NUMBER_SIZE];
+      std::size_t header_size = this->read_source(header, MAGIC_NUMBER_SIZE);
+      if (header_size == 0)
+        {
+        return false;
+        }
+      ++this->BlocksRead;
+      if (header_size < MAGIC_NUMBER_SIZE
+          || detect_compression(header, header_size) != CompressionFormat::BGZF)
+        {
+        std::ostringstream message;
+        message << "BGZF block " << this->BlocksRead << " has a truncated or unrecognized header";
+        this->fail(message.str());
+        return false;
+        }
+
+      std::size_t block_size = little_endian_16(header, 16) + 1;
+      if (block_size < MAGIC_NUMBER_SIZE + 8)
+        {
+        std::ostringstream message;
+        message << "BGZF block " << this->BlocksRead << " claims an impossible size of " << block_size << " bytes";
+        this->fail(message.str());
+        return false;
+        }
+
+      job.Input.resize(block_size);
+      std::memcpy(&job.Input[0], header, MAGIC_NUMBER_SIZE);
+      std::size_t body_size = this->read_source(&job.Input[MAGIC_NUMBER_SIZE], block_size - MAGIC_NUMBER_SIZE);
+      if (body_size < block_size - MAGIC_NUMBER_SIZE)
+        {
+        std::ostringstream message;
+        message << "BGZF block " << this->BlocksRead << " is truncated";
+        this->fail(message.str());
+        return false;
+        }
+      return true;
+    }
+
+  // Tell the workers to exit and wait until they have
+  void stop_workers()
+    {
+      {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      this->Stopping = true;
+      }
+      this->WorkAvailable.notify_all();
+      for (std::size_t i = 0; i < this->Workers.size(); ++i)
+        {
+        this->Workers[i].join();
+        }
+      this->Workers.clear();
+    }
+
+  // Wait for a job to start.  Returns a null pointer when it is time
+  // for the worker to exit.
+  JobPointer take_job()
+    {
+      std::unique_lock<std::mutex> lock(this->Mutex);
+      this->WorkAvailable.wait(lock, [this]() { return this->Stopping || !this->Pending.empty(); });
+      if (this->Stopping)
+        {
+        return JobPointer();
+        }
+      JobPointer job = this->Pending.front();
+      this->Pending.pop_front();
+      return job;
+    }
+
+  void finish_job(JobPointer const& job)
+    {
+      job->Input.clear();
+      job->Input.shrink_to_fit();
+        {
+        std::lock_guard<std::mutex> lock(this->Mutex);
+        job->Finished = true;
+        }
+      this->JobFinished.notify_all();
+    }
+
+  void run_bgzf_worker()
+    {
+#if defined(TRACKTABLE_HAVE_ZLIB)
+      z_stream stream;
+      std::memset(&stream, 0, sizeof(stream));
+      bool ready = (inflateInit2(&stream, -MAX_WBITS) == Z_OK);
+
+      while (JobPointer job = this->take_job())
+        {
+        if (!ready)
+          {
+          job->Error = "Could not initialize zlib";
+          }
+        else
+          {
+          this->inflate_bgzf_block(stream, *job);
+          }
+        this->finish_job(job);
+        }
+
+      if (ready)
+        {
+        inflateEnd(&stream);
+        }
+#endif
+    }
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+  static void inflate_bgzf_block(z_stream& stream, Job& job)
+    {
+      std::string const& block = job.Input;
+      std::size_t data_begin = 12 + little_endian_16(block.data(), 10);
+      std::size_t data_end = block.size() - 8;
+      std::uint32_t expected_crc = little_endian_32(block.data(), data_end);
+      std::uint32_t expected_size = little_endian_32(block.data(), data_end + 4);
+      if (expected_size > MAX_BGZF_BLOCK_SIZE)
+        {
+        job.Error = "BGZF block claims to be larger than 64 KiB";
+        return;
+        }
+
+      // One spare byte lets zlib report the end of an empty block (the
+      // end-of-file marker) and catches blocks that inflate to more
+      // than their trailer claims.
+      job.Output.resize(expected_size + 1);
+      inflateReset(&stream);
+      stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(block.data() + data_begin));
+      stream.avail_in = static_cast<uInt>(data_end - data_begin);
+      stream.next_out = reinterpret_cast<Bytef*>(&job.Output[0]);
+      stream.avail_out = static_cast<uInt>(expected_size + 1);
+
+      int status = inflate(&stream, Z_FINISH);
+      job.Output.resize(expected_size);
+      if (status != Z_STREAM_END || stream.avail_out != 1)
+        {
+        job.Error = "BGZF block is corrupt";
+        return;
+        }
+
+      uLong crc = crc32(0L, Z_NULL, 0);
+      crc = crc32(crc, reinterpret_cast<Bytef const*>(job.Output.data()), static_cast<uInt>(job.Output.size()));
+      if (crc != expected_crc)
+        {
+        job.Error = "BGZF block failed its CRC check";
+        }
+    }
+#endif
+
+  void run_stream_worker()
+    {
+#if defined(TRACKTABLE_HAVE_ZLIB)
+      if (this->Format == CompressionFormat::GZIP)
+        {
+        this->run_gzip_worker();
+        }
+#endif
+#if defined(TRACKTABLE_HAVE_ZSTD)
+      if (this->Format == CompressionFormat::ZSTD)
+        {
+        this->run_zstd_worker();
+        }
+#endif
+    }
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+  void run_gzip_worker()
+    {
+      z_stream stream;
+      std::memset(&stream, 0, sizeof(stream));
+      // 16 + MAX_WBITS: expect a gzip header and trailer
+      bool ready = (inflateInit2(&stream, 16 + MAX_WBITS) == Z_OK);
+      bool member_complete = false;
+
+      while (JobPointer job = this->take_job())
+        {
+        if (!ready)
+          {
+          job->Error = "Could not initialize zlib";
+          this->finish_job(job);
+          continue;
+          }
+
+        stream.next_in = reinterpret_cast<Bytef*>(job->Input.empty() ? nullptr : &job->Input[0]);
+        stream.avail_in = static_cast<uInt>(job->Input.size());
+
+        while (stream.avail_in > 0 && job->Error.empty())
+          {
+          if (member_complete)
+            {
+            // Concatenated gzip files are one stream as far as gunzip
+            // is concerned, so they are for us too.
+            inflateReset(&stream);
+            member_complete = false;
+            }
+
+          std::size_t old_size = job->Output.size();
+          std::size_t room = std::max<std::size_t>(4 * stream.avail_in, 64 * 1024);
+          job->Output.resize(old_size + room);
+          stream.next_out = reinterpret_cast<Bytef*>(&job->Output[old_size]);
+          stream.avail_out = static_cast<uInt>(room);
+
+          int status = inflate(&stream, Z_NO_FLUSH);
+          job->Output.resize(old_size + room - stream.avail_out);
+
+          if (status == Z_STREAM_END)
+            {
+            member_complete = true;
+            }
+          else if (status != Z_OK && status != Z_BUF_ERROR)
+            {
+            job->Error = std::string("gzip data is corrupt")
+              + (stream.msg ? std::string(": ") + stream.msg : std::string());
+            }
+          }
+
+        // Drain anything zlib is still holding after the input runs out
+        while (job->Error.empty() && !member_complete)
+          {
+          std::size_t old_size = job->Output.size();
+          std::size_t room = 64 * 1024;
+          job->Output.resize(old_size + room);
+          stream.next_out = reinterpret_cast<Bytef*>(&job->Output[old_size]);
+          stream.avail_out = static_cast<uInt>(room);
+          int status = inflate(&stream, Z_NO_FLUSH);
+          job->Output.resize(old_size + room - stream.avail_out);
+          if (status == Z_STREAM_END)
+            {
+            member_complete = true;
+            }
+          else if (status != Z_OK || stream.avail_out != 0)
+            {
+            break;
+            }
+          }
+
+        if (job->Last && job->Error.empty() && !member_complete)
+          {
+          job->Error = "gzip data ends in the middle of a compressed stream";
+          }
+        this->finish_job(job);
+        }
+
+      if (ready)
+        {
+        inflateEnd(&stream);
+        }
+    }
+#endif
+
+#if defined(TRACKTABLE_HAVE_ZSTD)
+  void run_zstd_worker()
+    {
+      ZSTD_DStream* stream = ZSTD_createDStream();
+      if (stream != nullptr)
+        {
+        ZSTD_initDStream(stream);
+        }
+      std::size_t const output_chunk = ZSTD_DStreamOutSize();
+      bool frame_complete = false;
+
+      while (JobPointer job = this->take_job())
+        {
+        if (stream == nullptr)
+          {
+          job->Error = "Could not initialize zstd";
+          this->finish_job(job);
+          continue;
+          }
+
+        ZSTD_inBuffer input = { job->Input.data(), job->Input.size(), 0 };
+        bool output_full = true;
+        while ((input.pos < input.size || output_full) && job->Error.empty())
+          {
+          std::size_t old_size = job->Output.size();
+          job->Output.resize(old_size + output_chunk);
+          ZSTD_outBuffer output = { &job->Output[old_size], output_chunk, 0 };
+
+          std::size_t status = ZSTD_decompressStream(stream, &output, &input);
+          job->Output.resize(old_size + output.pos);
+          output_full = (output.pos == output.size);
+
+          if (ZSTD_isError(status))
+            {
+            job->Error = std::string("zstd data is corrupt: ") + ZSTD_getErrorName(status);
+            }
+          else
+            {
+            // 0 means a frame has been completely decoded and flushed
+            frame_complete = (status == 0);
+            }
+          }
+
+        if (job->Last && job->Error.empty() && !frame_complete)
+          {
+          job->Error = "zstd data ends in the middle of a frame";
+          }
+        this->finish_job(job);
+        }
+
+      if (stream != nullptr)
+        {
+        ZSTD_freeDStream(stream);
+        }
+    }
+#endif
+
+  void fail(std::string const& message)
+    {
+        {
+        std::lock_guard<std::mutex> lock(this->Mutex);
+        if (this->Failed)
+          {
+          return;
+          }
+        this->Failed = true;
+        this->ErrorMessage = message;
+        }
+      this->JobFinished.notify_all();
+    }
+
+  // std::istream catches exceptions thrown by its buffer and sets
+  // badbit, which is exactly what we want callers to see.
+  void check_failure()
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (this->Failed)
+        {
+        throw std::runtime_error(this->ErrorMessage);
+        }
+    }
+
+  std::istream& Source;
+  CompressionFormat Format;
+
+  char Prefix[MAGIC_NUMBER_SIZE];
+  std::size_t PrefixSize;
+  std::size_t PrefixOffset;
+  bool SourceExhausted;
+
+  std::string Current;
+
+  mutable std::mutex Mutex;
+  std::condition_variable WorkAvailable;
+  std::condition_variable JobFinished;
+  std::deque<JobPointer> InFlight;
+  std::deque<JobPointer> Pending;
+  std::string ErrorMessage;
+  bool Failed;
+  bool Stopping;
+
+  std::size_t MaxJobsInFlight;
+  std::size_t BlocksRead;
+  std::vector<std::thread> Workers;
+};
+
+} // namespace detail
+
+// ----------------------------------------------------------------------
+
+CompressedInputStream::CompressedInputStream(std::istream& source, std::size_t num_threads)
+  : std::istream(nullptr)
+  , Buffer(new detail::DecompressingStreamBuffer(source, num_threads))
+{
+  this->rdbuf(this->Buffer.get());
+}
+
+CompressedInputStream::~CompressedInputStream()
+{
+}
+
+CompressionFormat CompressedInputStream::format() const
+{
+  return this->Buffer->format();
+}
+
+std::string CompressedInputStream::error_message() const
+{
+  return this->Buffer->error_message();
+}
+
+} // namespace tracktable
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * CompressedInputStream - Read gzip- and zstd-compressed input as if
+ * it were plain text
+ *
+ * The readers in this directory all take a std::istream.  Wrap the
+ * stream you would have given them in a CompressedInputStream and
+ * compressed input will be decompressed on the fly.  Uncompressed
+ * input passes straight through, so there is no need to know ahead
+ * of time which you have.
+ */
+
+#ifndef __tracktable_rw_CompressedInputStream_h
+#define __tracktable_rw_CompressedInputStream_h
+
+#include <tracktable/RW/TracktableRWWindowsHeader.h>
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <string>
+
+namespace tracktable {
+
+/// Compression formats recognized by CompressedInputStream
+enum class CompressionFormat {
+  /// Not compressed, or not in a format we recognize
+  NONE,
+  /// gzip, including files made by concatenating several gzip files
+  GZIP,
+  /// Blocked gzip (BGZF) as written by `bgzip`; blocks are decompressed in parallel
+  BGZF,
+  /// Zstandard
+  ZSTD
+};
+
+/** Name of a compression format for messages
+ *
+ * @param [in] format  Format to describe
+ * @return "none", "gzip", "bgzf" or "zstd"
+ */
+TRACKTABLE_RW_EXPORT std::string compression_format_name(CompressionFormat format);
+
+/** Identify a compression format from the first bytes of a file
+ *
+ * 18 bytes are enough to tell all of the formats apart.  With fewer,
+ * blocked gzip is reported as plain gzip.
+ *
+ * @param [in] data  Start of the data
+ * @param [in] size  Number of bytes available
+ * @return Format whose magic number the data starts with, or NONE
+ */
+TRACKTABLE_RW_EXPORT CompressionFormat detect_compression(char const* data, std::size_t size);
+
+/** Check whether decompression for a format was compiled in
+ *
+ * gzip support needs zlib and zstd support needs libzstd when
+ * Tracktable is built.  NONE is always supported.
+ *
+ * @param [in] format  Format to check
+ */
+TRACKTABLE_RW_EXPORT bool compression_format_supported(CompressionFormat format);
+
+namespace detail {
+class DecompressingStreamBuffer;
+}
+
+/**
+ * @class CompressedInputStream
+ * @brief Input stream that decompresses another stream on the fly
+ *
+ * The format is detected from the magic number at the start of the
+ * source.  Input that is not compressed is passed through unchanged.
+ *
+ * Decompression never runs on the thread that reads from this stream.
+ * Blocked gzip files are split into their independent blocks and
+ * several blocks are decompressed at once.  Other formats are
+ * decompressed on one background thread that stays a few blocks
+ * ahead of the reader.  Either way, parsing does not wait for
+ * inflation unless the parser is faster than all of the
+ * decompression threads together.
+ *
+ * Compressed bytes are always read from the source on the reading
+ * thread, so the source does not need to be thread-safe.  This is
+ * what lets us wrap Python file-like objects.
+ *
+ * If the compressed data is corrupt or truncated, or the format was
+ * not compiled in, reading fails and the stream's badbit is set.
+ * error_message() says why.
+ *
+ * The source must stay alive as long as this stream does.
+ *
+ * Example:
+ *
+ * @code
+ * std::ifstream infile("points.csv.gz", std::ios::binary);
+ * tracktable::CompressedInputStream input(infile);
+ *
+ * tracktable::PointReader<point_type> reader(input);
+ * @endcode
+ */
+class TRACKTABLE_RW_EXPORT CompressedInputStream : public std::istream
+{
+public:
+  /** Wrap a source stream
+   *
+   * The first few bytes of the source are read right away to detect
+   * the format.
+   *
+   * @param [in] source       Stream to read (possibly compressed) bytes from
+   * @param [in] num_threads  Decompression threads for blocked gzip; 0 means one per processor
+   */
+  explicit CompressedInputStream(std::istream& source, std::size_t num_threads=0);
+
+  virtual ~CompressedInputStream();
+
+  /// Format detected at the start of the source
+  CompressionFormat format() const;
+
+  /// Why decompression failed, or an empty string if it has not
+  std::string error_message() const;
+
+private:
+  CompressedInputStream(CompressedInputStream const& other) = delete;
+  CompressedInputStream& operator=(CompressedInputStream const& other) = delete;
+
+  std::unique_ptr<detail::DecompressingStreamBuffer> Buffer;
+};
+
+} // namespace tracktable
+
+#endif
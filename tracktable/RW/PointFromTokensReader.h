@@ -46,6 +46,7 @@
 #include <string>
 #include <cassert>
 #include <map>
+#include <set>
 #include <sstream>
 #include <stdexcept>
 #include <vector>
@@ -70,6 +71,12 @@ namespace tracktable {
  * delimiter. PointFromTokensReader takes each of those lists of tokens, one
  * list at a time, and turns it into a point of some user-requested
  * type.
+ *
+ * Converting property columns is usually the most expensive part of
+ * reading a point.  If a job only needs a few of many columns, name
+ * them with set_required_properties() and the rest are skipped.
+ * With set_lazy_properties(), numeric and timestamp columns are
+ * kept as raw text and only converted when something reads them.
  */
 
 template<typename PointT, typename SourceIterT>
@@ -87,6 +94,9 @@ public:
     , IgnoreHeader(false)
     , WarningsEnabled(true)
     , PointCountLogEnabled(true)
+    , RestrictProperties(false)
+    , LazyProperties(false)
+    , PropertyPlanStale(true)
     , NumPoints(0)
     , NumParseErrors(0)
     {
@@ -106,6 +116,10 @@ public:
     , IgnoreHeader(other.IgnoreHeader)
     , WarningsEnabled(true)
     , PointCountLogEnabled(other.PointLogEnabled)
+    , RequiredProperties(other.RequiredProperties)
+    , RestrictProperties(other.RestrictProperties)
+    , LazyProperties(other.LazyProperties)
+    , PropertyPlanStale(true)
     , NumPoints(other.NumPoints)
     , NumParseErrors(other.NumParseErrors)
     { }
@@ -124,6 +138,9 @@ public:
     , IgnoreHeader(false)
     , WarningsEnabled(true)
     , PointCountLogEnabled(true)
+    , RestrictProperties(false)
+    , LazyProperties(false)
+    , PropertyPlanStale(true)
     , NumPoints(0)
     , NumParseErrors(0)
     { }
@@ -150,6 +167,10 @@ public:
       this->WarningsEnabled = other.WarningsEnabled;
       this->PointCountLogEnabled = other.PointCountLogEnabled;
       this->PropertyReadWrite = other.PropertyReadWrite;
+      this->RequiredProperties = other.RequiredProperties;
+      this->RestrictProperties = other.RestrictProperties;
+      this->LazyProperties  = other.LazyProperties;
+      this->PropertyPlanStale = true;
       this->NumPoints       = other.NumPoints;
       this->NumParseErrors = other.NumParseErrors;
 
@@ -176,6 +197,9 @@ public:
         && this->WarningsEnabled == other.WarningsEnabled
         && this->PointCountLogEnabled == other.PointCountLogEnabled
 	      && this->PropertyReadWrite == other.PropertyReadWrite
+        && this->RequiredProperties == other.RequiredProperties
+        && this->RestrictProperties == other.RestrictProperties
+        && this->LazyProperties == other.LazyProperties
         );
     }
 
@@ -295,12 +319,14 @@ public:
   void set_real_field_column(std::string const& field, int column)
   {
     this->FieldMap[field] = rw::detail::ColumnTypeAssignment::real(column);
+    this->PropertyPlanStale = true;
   }
 
 #if defined(PROPERTY_VALUE_INCLUDES_INTEGER)
   void set_integer_field_column(std::string const& field, int column)
   {
     this->FieldMap[field] = rw::detail::ColumnTypeAssignment::integer(column);
+    this->PropertyPlanStale = true;
   }
 #endif
 
@@ -328,6 +354,7 @@ public:
   void set_time_field_column(std::string const& field, int column)
   {
     this->FieldMap[field] = rw::detail::ColumnTypeAssignment::timestamp(column);
+    this->PropertyPlanStale = true;
   }
 
   /** Configure the mapping from columns to data fields
@@ -354,6 +381,7 @@ public:
   void set_string_field_column(std::string const& field, int column)
   {
     this->FieldMap[field] = rw::detail::ColumnTypeAssignment::string(column);
+    this->PropertyPlanStale = true;
   }
 
   /** Return which column has the given corrdinate
@@ -561,6 +589,7 @@ public:
   void set_timestamp_format(string_type const& format)
   {
     this->PropertyReadWrite.set_timestamp_input_format(format);
+    this->PropertyPlanStale = true;
   }
 
   /** Retrieve the format of the timestamp
@@ -579,6 +608,7 @@ public:
   void set_null_value(string_type const& value)
     {
       this->PropertyReadWrite.set_null_value(value);
+      this->PropertyPlanStale = true;
     }
 
   /** Retrieve the null value
@@ -590,6 +620,87 @@ public:
       return this->PropertyReadWrite.null_value();
     }
 
+  /** Only populate the named properties
+   *
+   * Columns for any other property are skipped without being
+   * converted.  Object ID, timestamp and coordinates are always read.
+   * Properties named here that have no column are ignored.  This
+   * also applies to columns configured from a header in the input.
+   *
+   * @param [in] names  Properties to read
+   */
+  void set_required_properties(std::vector<string_type> const& names)
+    {
+      this->RequiredProperties.clear();
+      this->RequiredProperties.insert(names.begin(), names.end());
+      this->RestrictProperties = true;
+      this->PropertyPlanStale = true;
+    }
+
+  /** Add one property to the set that will be populated
+   *
+   * The first call restricts the reader to the named property;
+   * see set_required_properties().
+   *
+   * @param [in] name  Property to read
+   */
+  void add_required_property(string_type const& name)
+    {
+      this->RequiredProperties.insert(name);
+      this->RestrictProperties = true;
+      this->PropertyPlanStale = true;
+    }
+
+  /// Go back to populating every configured property
+  void clear_required_properties()
+    {
+      this->RequiredProperties.clear();
+      this->RestrictProperties = false;
+      this->PropertyPlanStale = true;
+    }
+
+  /** Properties the reader is restricted to
+   *
+   * @return Names passed to set_required_properties(), or an empty
+   *         list if every property is read
+   */
+  std::vector<string_type> required_properties() const
+    {
+      return std::vector<string_type>(this->RequiredProperties.begin(),
+                                      this->RequiredProperties.end());
+    }
+
+  /** Defer conversion of property columns until they are used
+   *
+   * In lazy mode, each point keeps the raw text of its real-valued
+   * columns and converts a value the first time it is read, through
+   * property(), real_property() or anything else.  After that the
+   * value is stored as a double like any other.  Timestamp columns
+   * are deferred in the same way when the reader uses the default
+   * timestamp input format; with any other format they are still
+   * converted while reading.  Null values are stored as NullValue as
+   * usual.  See TrajectoryPoint::set_deferred_property().
+   *
+   * Lazy mode is meant for jobs that read a few values from many
+   * columns.  It is off by default.
+   *
+   * @param [in] onoff  Lazy mode on / off
+   */
+  void set_lazy_properties(bool onoff)
+    {
+      this->LazyProperties = onoff;
+      this->PropertyPlanStale = true;
+    }
+
+  /** Check whether property conversion is deferred
+   *
+   * @return Whether or not lazy mode is on
+   */
+  bool lazy_properties() const
+    {
+      return this->LazyProperties;
+    }
+
   /** This method is for the Python wrappers.
    *
    * In C++-land this explicitly breaks encapsulation. DON'T USE IT!
@@ -664,6 +775,17 @@ protected:
 
   PropertyConverter     PropertyReadWrite;
 
+  std::set<string_type> RequiredProperties;
+  bool                  RestrictProperties;
+  bool                  LazyProperties;
+
+  // Columns from FieldMap that will actually be read, split into
+  // those converted now and those deferred.  Rebuilt from
+  // FieldMap whenever PropertyPlanStale is set.
+  PropertyAssignmentMap EagerFieldMap;
+  PropertyAssignmentMap DeferredFieldMap;
+  bool                  PropertyPlanStale;
+
   int                   NumPoints;
   int                   NumParseErrors;
 
@@ -757,6 +879,10 @@ protected:
                   << _tokens.size() << " tokens ("
                   << required_num_tokens << " required) "
                   << "as point.";*/
+              if (this->PropertyPlanStale)
+                {
+                this->plan_property_columns();
+                }
               NextPoint = point_shared_ptr_type(new point_type);
               this->populate_coordinates_from_tokens(_tokens, NextPoint);
               this->populate_properties_from_tokens(_tokens, NextPoint);
@@ -900,7 +1026,44 @@ protected:
         this->FieldMap[property_name] = rw::detail::ColumnTypeAssignment(first_property_column + i, property_type);
         }
       TRACKTABLE_LOG(log::debug) << "Adjusted property map size = " << this->FieldMap.size() << ".";
+      this->PropertyPlanStale = true;
+
+    }
+
+  // ----------------------------------------------------------------------
+
+  /** Decide which property columns to read and how
+   *
+   * Applies the required-property set and lazy mode to FieldMap.
+   */
+  void plan_property_columns()
+    {
+      this->EagerFieldMap.clear();
+      this->DeferredFieldMap.clear();
+      bool defer_timestamps = (this->timestamp_format() == default_timestamp_input_format());
 
+      for (PropertyAssignmentMap::const_iterator iter = this->FieldMap.begin();
+           iter != this->FieldMap.end();
+           ++iter)
+        {
+        if (this->RestrictProperties
+            && this->RequiredProperties.find((*iter).first) == this->RequiredProperties.end())
+          {
+          continue;
+          }
+
+        PropertyUnderlyingType type((*iter).second.type);
+        if (this->LazyProperties
+            && (type == TYPE_REAL || (type == TYPE_TIMESTAMP && defer_timestamps)))
+          {
+          this->DeferredFieldMap.insert(*iter);
+          }
+        else
+          {
+          this->EagerFieldMap.insert(*iter);
+          }
+        }
+      this->PropertyPlanStale = false;
     }
 
   // ----------------------------------------------------------------------
@@ -971,7 +1134,15 @@ protected:
       rw::detail::set_properties<
         point_type,
         traits::has_properties<point_type>::value
-        >::apply(*point, tokens, this->FieldMap, this->PropertyReadWrite);
+        >::apply(*point, tokens, this->EagerFieldMap, this->PropertyReadWrite);
+
+      if (!this->DeferredFieldMap.empty())
+        {
+        rw::detail::set_deferred_properties<
+          point_type,
+          traits::has_properties<point_type>::value
+          >::apply(*point, tokens, this->DeferredFieldMap, this->PropertyReadWrite.null_value());
+        }
 
       if (this->ObjectIdColumn != -1)
         {
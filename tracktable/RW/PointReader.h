@@ -651,6 +651,62 @@ public:
       return this->PointTokenReader.null_value();
     }
 
+  /** Only populate the named point properties
+   *
+   * Columns for any other property are skipped without being
+   * converted.  See PointFromTokensReader::set_required_properties().
+   *
+   * @param [in] names  Properties to read
+   */
+  void set_required_properties(std::vector<string_type> const& names)
+    {
+      this->PointTokenReader.set_required_properties(names);
+    }
+
+  /** Add one property to the set that will be populated
+   *
+   * @param [in] name  Property to read
+   */
+  void add_required_property(string_type const& name)
+    {
+      this->PointTokenReader.add_required_property(name);
+    }
+
+  /// Go back to populating every point property
+  void clear_required_properties()
+    {
+      this->PointTokenReader.clear_required_properties();
+    }
+
+  /** Properties the reader is restricted to
+   *
+   * @return Required property names, or an empty list if every property is read
+   */
+  std::vector<string_type> required_properties() const
+    {
+      return this->PointTokenReader.required_properties();
+    }
+
+  /** Defer conversion of point properties until they are used
+   *
+   * See PointFromTokensReader::set_lazy_properties().
+   *
+   * @param [in] onoff  Lazy mode on / off
+   */
+  void set_lazy_properties(bool onoff)
+    {
+      this->PointTokenReader.set_lazy_properties(onoff);
+    }
+
+  /** Check whether property conversion is deferred
+   *
+   * @return Whether or not lazy mode is on
+   */
+  bool lazy_properties() const
+    {
+      return this->PointTokenReader.lazy_properties();
+    }
+
   /** This method is for the Python wrappers.
    *
    * In C++-land this explicitly breaks encapsulation. DON'T USE IT!
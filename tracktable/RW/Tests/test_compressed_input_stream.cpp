@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/RW/CompressedInputStream.h>
+#include <tracktable/RW/PointReader.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+# include <zlib.h>
+#endif
+
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+
+// ----------------------------------------------------------------------
+
+// A few thousand lines of point data: enough to span several BGZF
+// blocks and several streaming chunks.
+std::string build_points(std::size_t num_points)
+{
+  std::ostringstream points;
+  points << "# object_id,timestamp,longitude,latitude\n";
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    points << "FLIGHT" << (i % 17) << ","
+           << "2020-01-01 12:" << (10 + (i / 60) % 50) << ":" << (10 + i % 50) << ","
+           << (-100.0 + 0.001 * i) << "," << (35.0 + 0.0005 * i) << "\n";
+    }
+  return points.str();
+}
+
+std::string read_everything(std::istream& input)
+{
+  std::ostringstream contents;
+  std::string line;
+  while (std::getline(input, line))
+    {
+    contents << line << "\n";
+    }
+  return contents.str();
+}
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+
+// window_bits is 16 + MAX_WBITS for a gzip member or -MAX_WBITS for
+// the raw deflate data inside a BGZF block
+std::string deflate_string(std::string const& data, int window_bits)
+{
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY);
+  std::string result(deflateBound(&stream, static_cast<uLong>(data.size())) + 32, '\0');
+  stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+  stream.avail_in = static_cast<uInt>(data.size());
+  stream.next_out = reinterpret_cast<Bytef*>(&result[0]);
+  stream.avail_out = static_cast<uInt>(result.size());
+  deflate(&stream, Z_FINISH);
+  result.resize(stream.total_out);
+  deflateEnd(&stream);
+  return result;
+}
+
+void append_little_endian(std::string& out, std::uint32_t value, int num_bytes)
+{
+  for (int i = 0; i < num_bytes; ++i)
+    {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+// Same layout that bgzip writes, including the empty end-of-file block
+std::string bgzf_compress(std::string const& data, std::size_t block_size)
+{
+  std::string result;
+  for (std::size_t offset = 0; offset <= data.size(); offset += block_size)
+    {
+    std::string chunk = data.substr(offset, block_size);
+    std::string body = deflate_string(chunk, -MAX_WBITS);
+    result += std::string("\x1f\x8b\x08\x04\0\0\0\0\0\xff", 10);
+    append_little_endian(result, 6, 2);
+    result += "BC";
+    append_little_endian(result, 2, 2);
+    append_little_endian(result, static_cast<std::uint32_t>(18 + body.size() + 8 - 1), 2);
+    result += body;
+    uLong crc = crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<Bytef const*>(chunk.data()),
+                      static_cast<uInt>(chunk.size()));
+    append_little_endian(result, static_cast<std::uint32_t>(crc), 4);
+    append_little_endian(result, static_cast<std::uint32_t>(chunk.size()), 4);
+    }
+  return result;
+}
+
+#endif
+
+// ----------------------------------------------------------------------
+
+int test_detection()
+{
+  int error_count = 0;
+
+  struct Case
+  {
+    std::string Bytes;
+    tracktable::CompressionFormat Expected;
+  };
+
+  Case cases[] = {
+    { std::string("FLIGHT1,2020-01-01"), tracktable::CompressionFormat::NONE },
+    { std::string(""), tracktable::CompressionFormat::NONE },
+    { std::string("\x1f\x8b\x08\0\0\0\0\0\0\x03", 10), tracktable::CompressionFormat::GZIP },
+    { std::string("\x1f\x8b\x08\x04\0\0\0\0\0\xff\x06\0BC\x02\0\x1b\0", 18), tracktable::CompressionFormat::BGZF },
+    { std::string("\x28\xb5\x2f\xfd\x24\x00", 6), tracktable::CompressionFormat::ZSTD }
+  };
+
+  for (Case const& test_case : cases)
+    {
+    tracktable::CompressionFormat actual = tracktable::detect_compression(test_case.Bytes.data(), test_case.Bytes.size());
+    if (actual != test_case.Expected)
+      {
+      std::cerr << "ERROR: Expected format "
+                << tracktable::compression_format_name(test_case.Expected)
+                << " but detected "
+                << tracktable::compression_format_name(actual) << "\n";
+      ++error_count;
+      }
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int check_round_trip(std::string const& label, std::string const& stored,
+                     std::string const& expected, tracktable::CompressionFormat expected_format,
+                     std::size_t num_threads)
+{
+  std::istringstream source(stored, std::ios::in | std::ios::binary);
+  tracktable::CompressedInputStream input(source, num_threads);
+  if (input.format() != expected_format)
+    {
+    std::cerr << "ERROR: " << label << ": detected format "
+              << tracktable::compression_format_name(input.format()) << "\n";
+    return 1;
+    }
+
+  std::string actual = read_everything(input);
+  if (input.bad())
+    {
+    std::cerr << "ERROR: " << label << ": stream failed: " << input.error_message() << "\n";
+    return 1;
+    }
+  if (actual != expected)
+    {
+    std::cerr << "ERROR: " << label << ": expected " << expected.size()
+              << " bytes of output but got " << actual.size() << "\n";
+    return 1;
+    }
+  return 0;
+}
+
+int test_round_trips()
+{
+  int error_count = 0;
+  std::string points(build_points(5000));
+
+  error_count += check_round_trip("uncompressed", points, points, tracktable::CompressionFormat::NONE, 0);
+  error_count += check_round_trip("empty", "", "", tracktable::CompressionFormat::NONE, 0);
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+  std::string first_half(points.substr(0, points.size() / 2));
+  std::string second_half(points.substr(points.size() / 2));
+  error_count += check_round_trip(
+    "gzip", deflate_string(points, 16 + MAX_WBITS), points,
+    tracktable::CompressionFormat::GZIP, 0);
+  error_count += check_round_trip(
+    "concatenated gzip",
+    deflate_string(first_half, 16 + MAX_WBITS) + deflate_string(second_half, 16 + MAX_WBITS),
+    points, tracktable::CompressionFormat::GZIP, 0);
+
+  std::string blocked(bgzf_compress(points, 4096));
+  error_count += check_round_trip("bgzf, 1 thread", blocked, points, tracktable::CompressionFormat::BGZF, 1);
+  error_count += check_round_trip("bgzf, 4 threads", blocked, points, tracktable::CompressionFormat::BGZF, 4);
+#endif
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_corrupt_input()
+{
+  int error_count = 0;
+
+#if defined(TRACKTABLE_HAVE_ZLIB)
+  std::string points(build_points(5000));
+  std::string truncated_inputs[] = {
+    deflate_string(points, 16 + MAX_WBITS),
+    bgzf_compress(points, 4096)
+  };
+
+  for (std::string& stored : truncated_inputs)
+    {
+    stored.resize(stored.size() - 100);
+    std::istringstream source(stored, std::ios::in | std::ios::binary);
+    tracktable::CompressedInputStream input(source);
+    read_everything(input);
+    if (!input.bad() || input.error_message().empty())
+      {
+      std::cerr << "ERROR: Truncated "
+                << tracktable::compression_format_name(input.format())
+                << " input was not reported\n";
+      ++error_count;
+      }
+    }
+
+  // A block whose trailer claims 4 GB of output must fail the stream
+  // instead of trying to allocate it
+  std::string oversized(bgzf_compress(points, 4096));
+  std::size_t first_block_size = 1 + (static_cast<unsigned char>(oversized[16])
+                                      | (static_cast<unsigned char>(oversized[17]) << 8));
+  for (std::size_t i = first_block_size - 4; i < first_block_size; ++i)
+    {
+    oversized[i] = '\xff';
+    }
+  std::istringstream oversized_source(oversized, std::ios::in | std::ios::binary);
+  tracktable::CompressedInputStream oversized_input(oversized_source);
+  read_everything(oversized_input);
+  if (!oversized_input.bad() || oversized_input.error_message().empty())
+    {
+    std::cerr << "ERROR: BGZF block with an impossible size was not reported\n";
+    ++error_count;
+    }
+#endif
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_point_reader()
+{
+  int error_count = 0;
+  std::string points(build_points(5000));
+#if defined(TRACKTABLE_HAVE_ZLIB)
+  std::string stored(bgzf_compress(points, 4096));
+#else
+  std::string stored(points);
+#endif
+
+  std::istringstream source(stored, std::ios::in | std::ios::binary);
+  tracktable::CompressedInputStream input(source);
+  tracktable::PointReader<point_type> reader(input);
+  reader.set_field_delimiter(",");
+
+  std::size_t num_points = 0;
+  for (point_type const& point : reader)
+    {
+    if (point.object_id().compare(0, 6, "FLIGHT") != 0)
+      {
+      std::cerr << "ERROR: Point " << num_points << " has object ID " << point.object_id() << "\n";
+      ++error_count;
+      break;
+      }
+    ++num_points;
+    }
+
+  if (num_points != 5000)
+    {
+    std::cerr << "ERROR: Expected 5000 points through the compressed stream but got "
+              << num_points << "\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_detection();
+  error_count += test_round_trips();
+  error_count += test_corrupt_input();
+  error_count += test_point_reader();
+  return error_count;
+}
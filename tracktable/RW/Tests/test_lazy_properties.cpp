@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/RW/PointReader.h>
+#include <tracktable/RW/TrajectoryReader.h>
+#include <tracktable/RW/TrajectoryWriter.h>
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::PointReader<point_type> point_reader_type;
+
+// object_id, timestamp, lon, lat, speed, heading, last_seen, name
+const char* PointData =
+  "A,2020-01-01 00:00:00,10,20,100.5,90,2020-01-01 00:00:05,alpha\n"
+  "A,2020-01-01 00:01:00,11,21,,180,2020-01-01 00:01:05,beta\n"
+  "B,2020-01-01 00:02:00,12,22,300,270,2020-01-01 00:02:05,gamma\n";
+
+// ----------------------------------------------------------------------
+
+void configure(point_reader_type& reader)
+{
+  reader.set_field_delimiter(",");
+  reader.set_null_value("");
+  reader.set_object_id_column(0);
+  reader.set_timestamp_column(1);
+  reader.set_longitude_column(2);
+  reader.set_latitude_column(3);
+  reader.set_real_field_column("speed", 4);
+  reader.set_real_field_column("heading", 5);
+  reader.set_time_field_column("last_seen", 6);
+  reader.set_string_field_column("name", 7);
+}
+
+std::vector<point_type> read_points(bool lazy, std::vector<std::string> const& required)
+{
+  std::istringstream infile(PointData);
+  point_reader_type reader(infile);
+  configure(reader);
+  reader.set_lazy_properties(lazy);
+  if (!required.empty())
+    {
+    reader.set_required_properties(required);
+    }
+  return std::vector<point_type>(reader.begin(), reader.end());
+}
+
+// ----------------------------------------------------------------------
+
+int test_required_properties()
+{
+  int error_count = 0;
+  std::vector<point_type> points(read_points(false, {"speed", "no_such_column"}));
+
+  if (points.size() != 3)
+    {
+    std::cerr << "ERROR: Expected 3 points but got " << points.size() << "\n";
+    return 1;
+    }
+  for (auto const& point : points)
+    {
+    if (point.has_property("heading") || point.has_property("name")
+        || point.has_property("last_seen") || point.has_property("no_such_column"))
+      {
+      std::cerr << "ERROR: Point has a property that was not required: " << point << "\n";
+      ++error_count;
+      }
+    if (!point.has_property("speed"))
+      {
+      std::cerr << "ERROR: Required property 'speed' is missing: " << point << "\n";
+      ++error_count;
+      }
+    }
+  if (points[2].object_id() != "B" || points[2].longitude() != 12
+      || points[2].timestamp() != tracktable::time_from_string("2020-01-01 00:02:00"))
+    {
+    std::cerr << "ERROR: Required-property mode damaged the ID, timestamp or coordinates\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_lazy_properties()
+{
+  int error_count = 0;
+  std::vector<point_type> eager(read_points(false, {}));
+  std::vector<point_type> lazy(read_points(true, {}));
+
+  if (lazy.size() != eager.size())
+    {
+    std::cerr << "ERROR: Lazy reader produced " << lazy.size()
+              << " points; eager reader produced " << eager.size() << "\n";
+    return 1;
+    }
+
+  if (!lazy[0].has_deferred_properties() || eager[0].has_deferred_properties())
+    {
+    std::cerr << "ERROR: Lazy reader did not defer any properties\n";
+    ++error_count;
+    }
+
+  // A deferred value comes back typed, even through property()
+  tracktable::PropertyValueT speed(lazy[0].property("speed"));
+  if (tracktable::property_underlying_type(speed) != tracktable::TYPE_REAL
+      || tracktable::property_underlying_type(lazy[0].property("last_seen")) != tracktable::TYPE_TIMESTAMP)
+    {
+    std::cerr << "ERROR: Deferred properties were not converted by property()\n";
+    ++error_count;
+    }
+
+  // Reading one property converts all of them
+  if (lazy[0].has_deferred_properties()
+      || lazy[0].__properties() != eager[0].__properties())
+    {
+    std::cerr << "ERROR: Lazy property map does not match eager one: "
+              << lazy[0] << " vs " << eager[0] << "\n";
+    ++error_count;
+    }
+
+  for (std::size_t i = 0; i < lazy.size(); ++i)
+    {
+    bool eager_ok = false;
+    bool lazy_ok = false;
+    double eager_speed = eager[i].real_property("speed", &eager_ok);
+    double lazy_speed = lazy[i].real_property("speed", &lazy_ok);
+    if (eager_ok != lazy_ok || (eager_ok && eager_speed != lazy_speed))
+      {
+      std::cerr << "ERROR: Point " << i << ": lazy speed " << lazy_speed
+                << " does not match eager speed " << eager_speed << "\n";
+      ++error_count;
+      }
+    if (lazy[i].real_property_with_default("heading", -1) != eager[i].real_property("heading"))
+      {
+      std::cerr << "ERROR: Point " << i << ": lazy heading does not match\n";
+      ++error_count;
+      }
+    if (lazy[i].timestamp_property("last_seen") != eager[i].timestamp_property("last_seen"))
+      {
+      std::cerr << "ERROR: Point " << i << ": lazy timestamp does not match\n";
+      ++error_count;
+      }
+    if (lazy[i].string_property("name") != eager[i].string_property("name"))
+      {
+      std::cerr << "ERROR: Point " << i << ": lazy string property does not match\n";
+      ++error_count;
+      }
+    }
+
+  // Null values are still nulls of the right type
+  tracktable::PropertyValueT missing(lazy[1].property("speed"));
+  tracktable::NullValue const* null_speed = boost::get<tracktable::NullValue>(&missing);
+  if (null_speed == 0 || null_speed->ExpectedType != tracktable::TYPE_REAL)
+    {
+    std::cerr << "ERROR: Lazy reader did not store a real-valued null for an empty speed\n";
+    ++error_count;
+    }
+
+  // Copies carry their deferred values with them
+  std::vector<point_type> unread(read_points(true, {}));
+  point_type copy(unread[2]);
+  if (copy.real_property("heading") != 270 || !unread[2].has_deferred_properties())
+    {
+    std::cerr << "ERROR: Copy of a lazy point has the wrong heading\n";
+    ++error_count;
+    }
+
+  // Threads reading the same lazy point all see the converted values
+  std::vector<double> headings(4, -1);
+  std::vector<std::thread> readers;
+  for (std::size_t i = 0; i < headings.size(); ++i)
+    {
+    readers.push_back(std::thread([&unread, &headings, i]() {
+      point_type const& point(unread[2]);
+      headings[i] = point.real_property_with_default("heading", -1);
+      }));
+    }
+  for (std::size_t i = 0; i < readers.size(); ++i)
+    {
+    readers[i].join();
+    if (headings[i] != 270)
+      {
+      std::cerr << "ERROR: Thread " << i << " read heading " << headings[i]
+                << " from a shared lazy point\n";
+      ++error_count;
+      }
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_deferred_conversion()
+{
+  int error_count = 0;
+  point_type point;
+  point.set_property("callsign", "1234");
+  point.set_deferred_property("altitude", "10000.5", tracktable::TYPE_REAL);
+  point.set_deferred_property("garbled", "not a number", tracktable::TYPE_REAL);
+  point.set_deferred_property("replaced", "1", tracktable::TYPE_REAL);
+  point.set_property("replaced", 2.0);
+
+  // A string that happens to hold a number is still a string
+  bool ok = true;
+  point.real_property("callsign", &ok);
+  if (ok || point.real_property_with_default("callsign", -1) != -1)
+    {
+    std::cerr << "ERROR: String property was converted to a number\n";
+    ++error_count;
+    }
+
+  if (!point.has_property("altitude") || point.real_property("altitude") != 10000.5)
+    {
+    std::cerr << "ERROR: Deferred altitude did not convert\n";
+    ++error_count;
+    }
+  if (point.has_property("garbled"))
+    {
+    std::cerr << "ERROR: Text that does not convert left a property behind\n";
+    ++error_count;
+    }
+  if (point.real_property("replaced") != 2.0)
+    {
+    std::cerr << "ERROR: set_property() did not replace a deferred value\n";
+    ++error_count;
+    }
+  if (point.has_deferred_properties())
+    {
+    std::cerr << "ERROR: Point still has deferred properties after all were read\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_trajectory_reader()
+{
+  int error_count = 0;
+  trajectory_type original;
+  std::istringstream infile(PointData);
+  point_reader_type point_reader(infile);
+  configure(point_reader);
+  for (auto const& point : point_reader)
+    {
+    original.push_back(point);
+    }
+
+  std::ostringstream outbuf;
+  tracktable::TrajectoryWriter writer(outbuf);
+  writer.write(original);
+
+  std::istringstream inbuf(outbuf.str());
+  tracktable::TrajectoryReader<trajectory_type> reader(inbuf);
+  reader.set_lazy_properties(true);
+  reader.set_required_properties({"speed", "last_seen"});
+
+  std::vector<trajectory_type> trajectories(reader.begin(), reader.end());
+  if (trajectories.size() != 1 || trajectories[0].size() != original.size())
+    {
+    std::cerr << "ERROR: Lazy trajectory reader did not read the trajectory back\n";
+    return 1;
+    }
+  for (std::size_t i = 0; i < original.size(); ++i)
+    {
+    point_type const& point(trajectories[0][i]);
+    if (point.has_property("heading") || point.has_property("name"))
+      {
+      std::cerr << "ERROR: Trajectory reader read a property that was not required\n";
+      ++error_count;
+      }
+    if (point.real_property_with_default("speed", -1) != original[i].real_property_with_default("speed", -1)
+        || point.timestamp_property("last_seen") != original[i].timestamp_property("last_seen"))
+      {
+      std::cerr << "ERROR: Trajectory point " << i << " has wrong lazy values\n";
+      ++error_count;
+      }
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_required_properties();
+  error_count += test_lazy_properties();
+  error_count += test_deferred_conversion();
+  error_count += test_trajectory_reader();
+  return error_count;
+}
@@ -0,0 +1,396 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/RW/TrajectoryCodec.h>
+#include <tracktable/Core/MemoryResource.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/container/pmr/global_resource.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::TrajectoryCodec<trajectory_type> codec_type;
+
+// ----------------------------------------------------------------------
+
+// A flight sampled every 60 seconds with a few point properties of
+// every type.  Some points are missing some properties.
+trajectory_type build_flight(std::string const& object_id, std::size_t num_points)
+{
+  trajectory_type flight;
+  tracktable::Timestamp when = tracktable::time_from_string("2020-01-01 12:00:00");
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    point_type point;
+    point.set_object_id(object_id);
+    point.set_timestamp(when + tracktable::seconds(60 * static_cast<int>(i)));
+    point.set_longitude(-100.0 + 0.0123456789 * i + 0.001 * std::sin(0.1 * i));
+    point.set_latitude(35.0 + 0.0087654321 * i);
+    point.set_property("altitude", std::floor(30000 + 1000 * std::sin(0.05 * i)));
+    point.set_property("speed", 450.0 + 0.5 * (i % 7));
+    if (i % 10 != 3)
+      {
+      point.set_property("status", std::string(i < num_points / 2 ? "climbing" : "cruising"));
+      }
+    if (i % 25 == 0)
+      {
+      point.set_property("last_contact", when + tracktable::seconds(60 * static_cast<int>(i) - 7));
+      }
+    flight.push_back(point);
+    }
+  flight.set_property("origin", std::string("ABQ"));
+  flight.set_property("passengers", 143.0);
+  flight.set_property("scheduled", when);
+  return flight;
+}
+
+// ----------------------------------------------------------------------
+
+int test_lossless_round_trip()
+{
+  int error_count = 0;
+  codec_type codec;
+  trajectory_type original(build_flight("TT123", 500));
+  codec_type::buffer_type bytes(codec.encode(original));
+  trajectory_type copy(codec.decode(bytes));
+
+  if (copy != original)
+    {
+    std::cerr << "ERROR: Lossless round trip changed the trajectory\n";
+    ++error_count;
+    }
+  if (copy.uuid() != original.uuid())
+    {
+    std::cerr << "ERROR: Round trip did not preserve the UUID\n";
+    ++error_count;
+    }
+  for (std::size_t i = 0; i < original.size(); ++i)
+    {
+    if (copy[i].longitude() != original[i].longitude() || copy[i].latitude() != original[i].latitude())
+      {
+      std::cerr << "ERROR: Lossless coordinates differ at point " << i << "\n";
+      ++error_count;
+      break;
+      }
+    }
+  if (copy.back().current_length() != original.back().current_length())
+    {
+    std::cerr << "ERROR: Decoded trajectory did not recompute current length\n";
+    ++error_count;
+    }
+
+  // Null values and mixed object IDs
+  trajectory_type odd;
+  odd.push_back(original[0]);
+  odd.push_back(original[1]);
+  odd[1].set_object_id("someone else");
+  odd[1].set_property("status", tracktable::make_null(tracktable::TYPE_STRING));
+  trajectory_type odd_copy(codec.decode(codec.encode(odd)));
+  if (odd_copy[1].object_id() != "someone else" || odd_copy[0].object_id() != "TT123")
+    {
+    std::cerr << "ERROR: Object IDs did not survive round trip\n";
+    ++error_count;
+    }
+  bool ok = false;
+  tracktable::PropertyValueT status(odd_copy[1].property("status", &ok));
+  if (!ok || !tracktable::is_property_null(status)
+      || boost::get<tracktable::NullValue>(status).ExpectedType != tracktable::TYPE_STRING)
+    {
+    std::cerr << "ERROR: Null property did not survive round trip\n";
+    ++error_count;
+    }
+
+  trajectory_type empty;
+  trajectory_type empty_copy(codec.decode(codec.encode(empty)));
+  if (!empty_copy.empty() || empty_copy.uuid() != empty.uuid())
+    {
+    std::cerr << "ERROR: Empty trajectory did not survive round trip\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_quantized_round_trip()
+{
+  int error_count = 0;
+  double precision = 1e-6;
+  codec_type lossless, quantized;
+  quantized.set_coordinate_precision(precision);
+  trajectory_type original(build_flight("TT456", 2000));
+
+  codec_type::buffer_type exact_bytes(lossless.encode(original));
+  codec_type::buffer_type bytes(quantized.encode(original));
+  trajectory_type copy(quantized.decode(bytes));
+
+  for (std::size_t i = 0; i < original.size(); ++i)
+    {
+    if (std::fabs(copy[i].longitude() - original[i].longitude()) > 0.5 * precision * (1 + 1e-9)
+        || std::fabs(copy[i].latitude() - original[i].latitude()) > 0.5 * precision * (1 + 1e-9))
+      {
+      std::cerr << "ERROR: Quantized coordinate at point " << i << " is off by more than half the precision\n";
+      ++error_count;
+      break;
+      }
+    if (copy[i].timestamp() != original[i].timestamp()
+        || copy[i].__properties() != original[i].__properties())
+      {
+      std::cerr << "ERROR: Quantization changed something other than coordinates at point " << i << "\n";
+      ++error_count;
+      break;
+      }
+    }
+
+  std::ostringstream archive_buffer;
+  {
+    boost::archive::binary_oarchive archive(archive_buffer);
+    archive << original;
+  }
+  std::size_t archive_size = archive_buffer.str().size();
+
+  std::cout << "Boost binary archive: " << archive_size << " bytes\n"
+            << "Lossless encoding:    " << exact_bytes.size() << " bytes\n"
+            << "Quantized encoding:   " << bytes.size() << " bytes\n";
+
+  if (!(bytes.size() < exact_bytes.size() && exact_bytes.size() < archive_size / 2))
+    {
+    std::cerr << "ERROR: Encodings are not as compact as expected\n";
+    ++error_count;
+    }
+
+  // Rough throughput, measured against the size of the raw point data
+  std::size_t raw_size = original.size() * sizeof(point_type);
+  int repetitions = 20;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  codec_type::buffer_type scratch;
+  for (int i = 0; i < repetitions; ++i)
+    {
+    scratch.clear();
+    quantized.encode(original, scratch);
+    }
+  std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i)
+    {
+    copy = quantized.decode(scratch);
+    }
+  std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+  double encode_seconds = std::chrono::duration<double>(middle - start).count();
+  double decode_seconds = std::chrono::duration<double>(finish - middle).count();
+  std::cout << "Encode: " << (raw_size * repetitions) / (encode_seconds * 1e6) << " MB/s, "
+            << "decode: " << (raw_size * repetitions) / (decode_seconds * 1e6) << " MB/s\n";
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_streams()
+{
+  int error_count = 0;
+  codec_type codec;
+  codec.set_coordinate_precision(1e-7);
+
+  std::vector<trajectory_type> originals;
+  originals.push_back(build_flight("A", 10));
+  originals.push_back(trajectory_type());
+  originals.push_back(build_flight("B", 300));
+
+  std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+  for (std::size_t i = 0; i < originals.size(); ++i)
+    {
+    codec.write(buffer, originals[i]);
+    }
+
+  std::vector<trajectory_type> copies;
+  trajectory_type next;
+  while (codec.read(buffer, next))
+    {
+    copies.push_back(next);
+    }
+  if (copies.size() != originals.size())
+    {
+    std::cerr << "ERROR: Expected " << originals.size() << " trajectories from stream but got "
+              << copies.size() << "\n";
+    return error_count + 1;
+    }
+  for (std::size_t i = 0; i < copies.size(); ++i)
+    {
+    if (copies[i].size() != originals[i].size() || copies[i].uuid() != originals[i].uuid())
+      {
+      std::cerr << "ERROR: Trajectory " << i << " changed on its way through the stream\n";
+      ++error_count;
+      }
+    }
+
+  // Truncated data must be reported, not read past
+  codec_type::buffer_type bytes(codec.encode(originals[2]));
+  for (std::size_t size = 0; size < bytes.size(); size += 37)
+    {
+    try
+      {
+      codec.decode(bytes.data(), size, next);
+      std::cerr << "ERROR: Decoding " << size << " of " << bytes.size()
+                << " bytes should have failed\n";
+      ++error_count;
+      break;
+      }
+    catch (tracktable::ParseError&)
+      {
+      }
+    }
+
+  // A corrupt length prefix claiming far more than the stream holds
+  std::stringstream corrupt(std::ios::in | std::ios::out | std::ios::binary);
+  for (int i = 0; i < 9; ++i)
+    {
+    corrupt.put(static_cast<char>(0xff));
+    }
+  corrupt.put(static_cast<char>(0x01));
+  corrupt.write("TTC", 3);
+  try
+    {
+    codec.read(corrupt, next);
+    std::cerr << "ERROR: Reading a record with a corrupt length should have failed\n";
+    ++error_count;
+    }
+  catch (tracktable::ParseError&)
+    {
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+// Memory resource that remembers what it handed out so that it can
+// notice memory from somewhere else being returned to it
+class TrackingResource : public tracktable::memory_resource
+{
+public:
+  TrackingResource()
+    : ForeignDeallocations(0)
+    { }
+
+  std::size_t live_allocations() const
+    {
+      return this->Live.size();
+    }
+
+  std::size_t foreign_deallocations() const
+    {
+      return this->ForeignDeallocations;
+    }
+
+protected:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      void* memory = boost::container::pmr::new_delete_resource()->allocate(bytes, alignment);
+      this->Live.insert(memory);
+      return memory;
+    }
+
+  void do_deallocate(void* memory, std::size_t bytes, std::size_t alignment) override
+    {
+      if (this->Live.erase(memory) == 0)
+        {
+        ++this->ForeignDeallocations;
+        }
+      boost::container::pmr::new_delete_resource()->deallocate(memory, bytes, alignment);
+    }
+
+  bool do_is_equal(tracktable::memory_resource const& other) const noexcept override
+    {
+      return this == &other;
+    }
+
+private:
+  std::set<void*> Live;
+  std::size_t ForeignDeallocations;
+};
+
+// Decoding into a trajectory that draws from one memory resource
+// while another is current must not mix nodes from the two
+int test_memory_resources()
+{
+  int error_count = 0;
+  codec_type codec;
+  trajectory_type original(build_flight("TT789", 50));
+  codec_type::buffer_type bytes(codec.encode(original));
+
+  TrackingResource resource;
+  std::unique_ptr<trajectory_type> target;
+  {
+  tracktable::ScopedMemoryResource use_resource(&resource);
+  target.reset(new trajectory_type);
+  }
+  codec.decode(bytes.data(), bytes.size(), *target);
+
+  if (*target != original)
+    {
+    std::cerr << "ERROR: Decoding into a trajectory from another resource changed it\n";
+    ++error_count;
+    }
+  target.reset();
+
+  if (resource.foreign_deallocations() != 0 || resource.live_allocations() != 0)
+    {
+    std::cerr << "ERROR: Decoding mixed memory from two resources ("
+              << resource.foreign_deallocations() << " foreign deallocations, "
+              << resource.live_allocations() << " allocations never returned)\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_lossless_round_trip();
+  error_count += test_quantized_round_trip();
+  error_count += test_streams();
+  error_count += test_memory_resources();
+  return error_count;
+}
@@ -0,0 +1,373 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/RW/TrajectoryJson.h>
+#include <tracktable/Domain/Cartesian2D.h>
+#include <tracktable/Domain/Terrestrial.h>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::TrajectoryJson<trajectory_type> json_type;
+
+// ----------------------------------------------------------------------
+
+trajectory_type build_flight(std::string const& object_id, std::size_t num_points)
+{
+  trajectory_type flight;
+  tracktable::Timestamp when = tracktable::time_from_string("2020-01-01 12:00:00");
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    point_type point;
+    point.set_object_id(object_id);
+    point.set_timestamp(when + tracktable::seconds(60 * static_cast<int>(i)));
+    point.set_longitude(-100.0 + 0.0123456789 * i);
+    point.set_latitude(35.0 + 0.0087654321 * i);
+    point.set_property("altitude", std::floor(30000 + 1000 * std::sin(0.05 * i)));
+    point.set_property("status", std::string(i % 2 ? "climbing \"fast\"" : "cruising"));
+    point.set_property("last_contact", when + tracktable::seconds(60 * static_cast<int>(i) - 7));
+    flight.push_back(point);
+    }
+  flight.set_property("origin", std::string("ABQ"));
+  flight.set_property("passengers", 143.0);
+  flight.set_property("scheduled", when);
+  return flight;
+}
+
+// ----------------------------------------------------------------------
+
+int test_python_layout()
+{
+  int error_count = 0;
+
+  trajectory_type trajectory;
+  point_type point;
+  point.set_object_id("AAA001");
+  point.set_longitude(26.995);
+  point.set_latitude(-81.9731);
+  point.set_timestamp(tracktable::time_from_string("2004-12-07 11:36:18"));
+  point.set_property("altitude", 2700.0);
+  point.set_property("note", std::string("hello"));
+  trajectory.push_back(point);
+  trajectory.set_property("percent", 33.333);
+
+  std::string expected(
+    "{\"coordinates\": [[26.995, -81.9731]], \"domain\": \"terrestrial\", "
+    "\"object_id\": \"AAA001\", "
+    "\"point_properties\": {\"altitude\": {\"type\": \"float\", \"values\": [2700.0]}, "
+    "\"note\": {\"type\": \"str\", \"values\": [\"hello\"]}}, "
+    "\"timestamps\": [\"2004-12-07 11:36:18\"], "
+    "\"trajectory_properties\": {\"percent\": {\"type\": \"float\", \"value\": 33.333}}}");
+
+  json_type json;
+  std::string actual(json.encode(trajectory));
+  if (actual != expected)
+    {
+    std::cerr << "ERROR: JSON does not match the Python layout.\n"
+              << "Expected: " << expected << "\n"
+              << "Actual:   " << actual << "\n";
+    ++error_count;
+    }
+
+  // Keys in any order, extra whitespace, and keys we do not know about
+  std::string shuffled(
+    "{ \"timestamps\": [\"2004-12-07T11:36:18\"],\n \"extra\": {\"a\": [1, 2, {\"b\": null}]},"
+    " \"object_id\": \"AAA001\", \"trajectory_properties\": {\"percent\": {\"value\": 33.333, \"type\": \"float\"}},"
+    " \"point_properties\": {\"note\": {\"values\": [\"hello\"], \"type\": \"str\"},"
+    " \"altitude\": {\"type\": \"float\", \"values\": [2.7e3]}},"
+    " \"coordinates\": [[26.995, -81.9731]], \"domain\": \"terrestrial\" }");
+  if (json.decode(shuffled) != trajectory)
+    {
+    std::cerr << "ERROR: Reordered JSON did not decode to the same trajectory\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_round_trip()
+{
+  int error_count = 0;
+  json_type json;
+  trajectory_type original(build_flight("TT123", 200));
+
+  // Odd values that still have to survive
+  original[3].set_property("status", tracktable::make_null(tracktable::TYPE_STRING));
+  original[4].set_longitude(0.1 + 0.2);
+  original[5].set_latitude(-1e-300);
+
+  trajectory_type copy(json.decode(json.encode(original)));
+  if (copy != original)
+    {
+    std::cerr << "ERROR: JSON round trip changed the trajectory\n";
+    ++error_count;
+    }
+
+  json.set_geojson(true);
+  std::string geojson(json.encode(original));
+  if (geojson.find("\"type\": \"LineString\"") == std::string::npos
+      || geojson.find("\"type\": \"Feature\"") == std::string::npos)
+    {
+    std::cerr << "ERROR: GeoJSON output is not a LineString Feature\n";
+    ++error_count;
+    }
+  if (json.decode(geojson) != original)
+    {
+    std::cerr << "ERROR: GeoJSON round trip changed the trajectory\n";
+    ++error_count;
+    }
+
+  trajectory_type empty;
+  if (json.decode(json.encode(empty)) != empty)
+    {
+    std::cerr << "ERROR: Empty trajectory did not survive round trip\n";
+    ++error_count;
+    }
+
+  // Rough throughput, measured against the size of the JSON
+  int repetitions = 20;
+  trajectory_type big(build_flight("BIG", 5000));
+  json.set_geojson(false);
+  std::string text;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i)
+    {
+    text.clear();
+    json.encode(big, text);
+    }
+  std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+  for (int i = 0; i < repetitions; ++i)
+    {
+    copy = json.decode(text);
+    }
+  std::chrono::steady_clock::time_point finish = std::chrono::steady_clock::now();
+  double encode_seconds = std::chrono::duration<double>(middle - start).count();
+  double decode_seconds = std::chrono::duration<double>(finish - middle).count();
+  std::cout << "Encode: " << (text.size() * repetitions) / (encode_seconds * 1e6) << " MB/s, "
+            << "decode: " << (text.size() * repetitions) / (decode_seconds * 1e6) << " MB/s\n";
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_collections()
+{
+  int error_count = 0;
+  json_type json;
+
+  std::vector<trajectory_type> originals;
+  originals.push_back(build_flight("A", 10));
+  originals.push_back(trajectory_type());
+  originals.push_back(build_flight("B", 30));
+
+  std::stringstream ndjson;
+  json.write(ndjson, originals.begin(), originals.end());
+  ndjson << "\n   \n";
+
+  std::vector<trajectory_type> copies;
+  trajectory_type next;
+  while (json.read(ndjson, next))
+    {
+    copies.push_back(next);
+    }
+  if (copies != originals)
+    {
+    std::cerr << "ERROR: Newline-delimited JSON did not survive round trip ("
+              << copies.size() << " of " << originals.size() << " trajectories)\n";
+    ++error_count;
+    }
+
+  std::ostringstream features;
+  json.write_feature_collection(features, originals.begin(), originals.end());
+  if (json.decode_collection(features.str()) != originals)
+    {
+    std::cerr << "ERROR: FeatureCollection did not survive round trip\n";
+    ++error_count;
+    }
+
+  std::string array("[" + json.encode(originals[0]) + ", " + json.encode(originals[2]) + "]");
+  if (json.decode_collection(array).size() != 2)
+    {
+    std::cerr << "ERROR: Expected two trajectories from a JSON array\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int expect_parse_error(std::string const& label, std::string const& text)
+{
+  tracktable::TrajectoryJson<trajectory_type> json;
+  try
+    {
+    json.decode(text);
+    }
+  catch (tracktable::ParseError&)
+    {
+    return 0;
+    }
+  std::cerr << "ERROR: " << label << " should have failed to parse\n";
+  return 1;
+}
+
+int test_errors()
+{
+  int error_count = 0;
+  std::string good(json_type().encode(build_flight("C", 3)));
+
+  for (std::size_t size = 0; size < good.size(); size += 13)
+    {
+    std::ostringstream label;
+    label << "JSON truncated to " << size << " bytes";
+    error_count += expect_parse_error(label.str(), good.substr(0, size));
+    }
+
+  error_count += expect_parse_error(
+    "Three-dimensional coordinates",
+    "{\"coordinates\": [[1, 2, 3]], \"timestamps\": [\"2020-01-01 00:00:00\"]}");
+  error_count += expect_parse_error(
+    "Too few timestamps",
+    "{\"coordinates\": [[1, 2], [3, 4]], \"timestamps\": [\"2020-01-01 00:00:00\"]}");
+  error_count += expect_parse_error(
+    "Too few property values",
+    "{\"coordinates\": [[1, 2]], \"timestamps\": [\"2020-01-01 00:00:00\"],"
+    " \"point_properties\": {\"x\": {\"type\": \"float\", \"values\": []}}}");
+  error_count += expect_parse_error(
+    "Numeric object ID",
+    "{\"coordinates\": [], \"timestamps\": [], \"object_id\": 12}");
+  error_count += expect_parse_error(
+    "Wrong domain",
+    "{\"coordinates\": [], \"timestamps\": [], \"domain\": \"cartesian2d\"}");
+  error_count += expect_parse_error("Two trajectories", good + "\n" + good);
+  error_count += expect_parse_error("Trailing garbage", good + " x");
+
+  // The same text is fine in the domain it names
+  typedef tracktable::domain::cartesian2d::trajectory_type cartesian_trajectory_type;
+  tracktable::TrajectoryJson<cartesian_trajectory_type> cartesian_json;
+  cartesian_trajectory_type cartesian(cartesian_json.decode(
+    "{\"coordinates\": [[1, 2]], \"timestamps\": [\"2020-01-01 00:00:00\"], \"domain\": \"cartesian2d\"}"));
+  if (cartesian.size() != 1 || cartesian[0][1] != 2)
+    {
+    std::cerr << "ERROR: Cartesian trajectory did not decode\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+// Numbers and strings must come out exactly as Python's json.dumps()
+// writes them
+int test_python_formatting()
+{
+  int error_count = 0;
+
+  struct NumberCase
+  {
+    double Value;
+    char const* Expected;
+  };
+  NumberCase numbers[] = {
+    { 0.0, "0.0" },
+    { -0.0, "-0.0" },
+    { 0.1, "0.1" },
+    { 0.30000000000000004, "0.30000000000000004" },
+    { 1e15, "1000000000000000.0" },
+    { 1e16, "1e+16" },
+    { 123456789012345678.0, "1.2345678901234568e+17" },
+    { 1e-4, "0.0001" },
+    { 1.5e-5, "1.5e-05" },
+    { -2.5e-300, "-2.5e-300" },
+    { 5e-324, "5e-324" },
+    { 12345.678, "12345.678" }
+  };
+  for (NumberCase const& test : numbers)
+    {
+    std::string text;
+    tracktable::rw::detail::append_json_number(text, test.Value);
+    if (text != test.Expected)
+      {
+      std::cerr << "ERROR: Number written as " << text << " instead of " << test.Expected << "\n";
+      ++error_count;
+      }
+    }
+
+  struct StringCase
+  {
+    char const* Value;
+    char const* Expected;
+  };
+  StringCase strings[] = {
+    { "plain", "\"plain\"" },
+    { "caf\xc3\xa9", "\"caf\\u00e9\"" },
+    { "\xe6\x97\xa5", "\"\\u65e5\"" },
+    { "\xf0\x9f\x98\x80", "\"\\ud83d\\ude00\"" },
+    { "\x7f", "\"\\u007f\"" },
+    { "a\"b\\c\n\x01", "\"a\\\"b\\\\c\\n\\u0001\"" }
+  };
+  for (StringCase const& test : strings)
+    {
+    std::string text;
+    tracktable::rw::detail::append_json_string(text, test.Value);
+    if (text != test.Expected)
+      {
+      std::cerr << "ERROR: String written as " << text << " instead of " << test.Expected << "\n";
+      ++error_count;
+      }
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_python_layout();
+  error_count += test_round_trip();
+  error_count += test_collections();
+  error_count += test_errors();
+  error_count += test_python_formatting();
+  return error_count;
+}
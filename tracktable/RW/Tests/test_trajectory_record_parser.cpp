@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tracktable/Domain/Terrestrial.h>
+#include <tracktable/RW/TrajectoryReader.h>
+#include <tracktable/RW/TrajectoryWriter.h>
+
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef tracktable::domain::terrestrial::trajectory_point_type point_type;
+typedef tracktable::domain::terrestrial::trajectory_type trajectory_type;
+typedef tracktable::TrajectoryReader<trajectory_type> reader_type;
+
+// ----------------------------------------------------------------------
+
+trajectory_type make_trajectory(int which, std::size_t num_points)
+{
+  trajectory_type trajectory;
+  std::ostringstream namebuf;
+  namebuf << "flight " << which;
+  trajectory.set_property("name", namebuf.str());
+  trajectory.set_property("rank", 0.5 * which);
+
+  tracktable::Timestamp start(tracktable::time_from_string("2020-03-01 12:00:00"));
+  for (std::size_t i = 0; i < num_points; ++i)
+    {
+    point_type point;
+    point.set_object_id(namebuf.str());
+    point.set_timestamp(start + tracktable::minutes(static_cast<int>(i)));
+    point.set_longitude(-100 + 0.25 * which + 0.125 * static_cast<double>(i));
+    point.set_latitude(30 + 0.5 * static_cast<double>(i));
+    point.set_property("altitude", 1000.0 + 10 * static_cast<double>(i));
+    point.set_property("seen", start + tracktable::seconds(static_cast<int>(i)));
+    if (i % 3 == 1)
+      {
+      // Escaped delimiters and quotes force the general tokenizer
+      point.set_property("note", std::string("has, \"quotes\""));
+      point.set_property("speed", tracktable::make_null(tracktable::TYPE_REAL));
+      }
+    else
+      {
+      point.set_property("note", std::string("plain"));
+      point.set_property("speed", 200.0 + static_cast<double>(i));
+      }
+    trajectory.push_back(point);
+    }
+  return trajectory;
+}
+
+std::string write_trajectories(std::vector<trajectory_type> const& trajectories)
+{
+  std::ostringstream outbuf;
+  outbuf << "# a comment line\n";
+  outbuf << "this line is not a trajectory\n";
+  tracktable::TrajectoryWriter writer(outbuf);
+  for (auto const& trajectory : trajectories)
+    {
+    writer.write(trajectory);
+    }
+  return outbuf.str();
+}
+
+int compare_trajectories(std::vector<trajectory_type> const& expected,
+                         std::vector<trajectory_type> const& actual,
+                         std::string const& label)
+{
+  if (expected.size() != actual.size())
+    {
+    std::cerr << "ERROR: " << label << ": expected " << expected.size()
+              << " trajectories but got " << actual.size() << "\n";
+    return 1;
+    }
+  int error_count = 0;
+  for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+    if (expected[i] != actual[i])
+      {
+      std::cerr << "ERROR: " << label << ": trajectory " << i << " does not match.\n";
+      for (std::size_t j = 0; j < expected[i].size() && j < actual[i].size(); ++j)
+        {
+        if (expected[i][j] != actual[i][j])
+          {
+          std::cerr << "First different point: " << j << "\n"
+                    << "Expected: " << expected[i][j] << "\n"
+                    << "Actual:   " << actual[i][j] << "\n";
+          break;
+          }
+        }
+      ++error_count;
+      }
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_round_trip()
+{
+  std::vector<trajectory_type> originals;
+  for (int i = 0; i < 25; ++i)
+    {
+    originals.push_back(make_trajectory(i, 1 + static_cast<std::size_t>(i % 7)));
+    }
+  std::string text(write_trajectories(originals));
+
+  int error_count = 0;
+
+  std::istringstream sequential_input(text);
+  reader_type sequential_reader(sequential_input);
+  std::vector<trajectory_type> sequential(sequential_reader.begin(), sequential_reader.end());
+  error_count += compare_trajectories(originals, sequential, "sequential read");
+
+  // Batches smaller than the input so that read_all has to loop
+  std::istringstream parallel_input(text);
+  reader_type parallel_reader(parallel_input);
+  std::vector<trajectory_type> parallel;
+  std::size_t num_read = parallel_reader.read_all(std::back_inserter(parallel), 4, 6);
+  if (num_read != parallel.size())
+    {
+    std::cerr << "ERROR: read_all returned " << num_read << " but wrote "
+              << parallel.size() << " trajectories\n";
+    ++error_count;
+    }
+  error_count += compare_trajectories(originals, parallel, "parallel read");
+
+  // Same again with each worker building in its own arena
+  {
+  tracktable::ArenaSet arenas(4);
+  std::istringstream arena_input(text);
+  reader_type arena_reader(arena_input);
+  std::vector<trajectory_type> in_arenas;
+  arena_reader.read_all(std::back_inserter(in_arenas), 4, 6, &arenas);
+  error_count += compare_trajectories(originals, in_arenas, "parallel read into arenas");
+  }
+
+  // Trajectory 6 is the first one with 7 points
+  trajectory_type const& longest(parallel.size() > 6 ? parallel[6] : originals[6]);
+  if (longest.back().current_length() != originals[6].back().current_length()
+      || longest.back().current_length() <= 0)
+    {
+    std::cerr << "ERROR: Per-point features were not computed after parsing\n";
+    ++error_count;
+    }
+
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int test_bad_records()
+{
+  std::vector<trajectory_type> originals;
+  originals.push_back(make_trajectory(1, 4));
+  originals.push_back(make_trajectory(2, 4));
+  originals.push_back(make_trajectory(3, 4));
+  std::string text(write_trajectories(originals));
+
+  std::istringstream lines(text);
+  std::vector<std::string> records;
+  std::string line;
+  while (std::getline(lines, line))
+    {
+    records.push_back(line);
+    }
+
+  // The first record loses its last token so its point block is
+  // short.  The second gets an unparseable coordinate in one point.
+  std::string& truncated(records[2]);
+  truncated.erase(truncated.rfind(','));
+
+  std::string& damaged(records[3]);
+  std::string first_longitude(",-99.5,");
+  std::size_t where = damaged.find(first_longitude);
+  if (where == std::string::npos)
+    {
+    std::cerr << "ERROR: Test setup could not find the coordinate to damage in '"
+              << damaged << "'\n";
+    return 1;
+    }
+  damaged.replace(where, first_longitude.size(), ",not_a_number,");
+
+  std::ostringstream joined;
+  for (auto const& record : records)
+    {
+    joined << record << "\n";
+    }
+
+  std::istringstream input(joined.str());
+  reader_type reader(input);
+  std::vector<trajectory_type> result(reader.begin(), reader.end());
+
+  int error_count = 0;
+  if (result.size() != 2)
+    {
+    std::cerr << "ERROR: Expected 2 trajectories from damaged input but got "
+              << result.size() << "\n";
+    return 1;
+    }
+  if (result[0].size() != 3 || result[0].uuid() != originals[1].uuid())
+    {
+    std::cerr << "ERROR: Point with a bad coordinate was not skipped; trajectory has "
+              << result[0].size() << " points\n";
+    ++error_count;
+    }
+  if (result[1] != originals[2])
+    {
+    std::cerr << "ERROR: Undamaged record after damaged ones did not read back\n";
+    ++error_count;
+    }
+  return error_count;
+}
+
+// ----------------------------------------------------------------------
+
+int main(int /*argc*/, char* /*argv*/[])
+{
+  int error_count = 0;
+  error_count += test_round_trip();
+  error_count += test_bad_records();
+  return error_count;
+}
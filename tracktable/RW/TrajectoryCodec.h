@@ -0,0 +1,826 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// TrajectoryCodec - compact binary encoding for whole trajectories
+//
+// TrajectoryWriter and Boost archives store every coordinate as a
+// full double, every timestamp in full and the object ID once per
+// point.  This codec stores each trajectory column by column and
+// exploits the fact that consecutive points look alike:
+//
+// - Timestamps are stored as delta-of-delta microseconds, so regular
+//   sampling costs one byte per point.
+// - Coordinates are either quantized to a caller-chosen precision and
+//   delta-encoded, or (the default) XOR-compressed losslessly.
+// - Object IDs are run-length encoded.
+// - Point properties are stored per column: real values are
+//   XOR-compressed, strings are dictionary-coded and timestamps are
+//   delta-encoded.
+//
+// The result is a self-contained byte buffer suitable for files,
+// network transport, pickling or holding finished trajectories in
+// memory until they are needed again.
+
+#ifndef __tracktable_TrajectoryCodec_h
+#define __tracktable_TrajectoryCodec_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/PointTraits.h>
+#include <tracktable/Core/PropertyMap.h>
+#include <tracktable/Core/Timestamp.h>
+#include <tracktable/Core/UUID.h>
+
+#include <tracktable/RW/ParseExceptions.h>
+#include <tracktable/RW/detail/ByteCoding.h>
+
+#include <boost/unordered_map.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <utility>
+#include <string>
+#include <vector>
+
+namespace tracktable {
+
+namespace rw { namespace detail {
+
+// Property tags stored in the encoded stream.  Null values carry
+// their expected type in the low bits.
+enum codec_property_tag
+{
+  CODEC_ABSENT    = 0,
+  CODEC_REAL      = 1,
+  CODEC_STRING    = 2,
+  CODEC_TIMESTAMP = 3,
+  CODEC_NULL      = 8
+};
+
+inline std::int64_t timestamp_to_ticks(Timestamp const& when)
+{
+  if (when.is_not_a_date_time())
+    {
+    return std::numeric_limits<std::int64_t>::min();
+    }
+  else if (when.is_neg_infinity())
+    {
+    return std::numeric_limits<std::int64_t>::min() + 1;
+    }
+  else if (when.is_pos_infinity())
+    {
+    return std::numeric_limits<std::int64_t>::max();
+    }
+  return (when - BeginningOfTime).total_microseconds();
+}
+
+inline Timestamp ticks_to_timestamp(std::int64_t ticks)
+{
+  if (ticks == std::numeric_limits<std::int64_t>::min())
+    {
+    return Timestamp(boost::posix_time::not_a_date_time);
+    }
+  else if (ticks == std::numeric_limits<std::int64_t>::min() + 1)
+    {
+    return Timestamp(boost::posix_time::neg_infin);
+    }
+  else if (ticks == std::numeric_limits<std::int64_t>::max())
+    {
+    return Timestamp(boost::posix_time::pos_infin);
+    }
+  return BeginningOfTime + boost::posix_time::microseconds(ticks);
+}
+
+// Differences are taken modulo 2^64 so that sentinel values cannot
+// overflow; decoding applies the same wrapping arithmetic.
+inline std::int64_t wrapping_difference(std::int64_t a, std::int64_t b)
+{
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) - static_cast<std::uint64_t>(b));
+}
+
+inline std::int64_t wrapping_sum(std::int64_t a, std::int64_t b)
+{
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) + static_cast<std::uint64_t>(b));
+}
+
+inline std::uint8_t property_tag(PropertyValue const& value)
+{
+  switch (property_underlying_type(value))
+    {
+    case TYPE_REAL:      return CODEC_REAL;
+    case TYPE_STRING:    return CODEC_STRING;
+    case TYPE_TIMESTAMP: return CODEC_TIMESTAMP;
+    default:
+      return static_cast<std::uint8_t>(CODEC_NULL + boost::get<NullValue>(value).ExpectedType);
+    }
+}
+
+inline void encode_property_map(ByteWriter& out, PropertyMap const& properties)
+{
+  out.put_varint(properties.size());
+  for (PropertyMap::const_iterator iter = properties.begin(); iter != properties.end(); ++iter)
+    {
+    std::uint8_t tag = property_tag(iter->second);
+    out.put_string(iter->first);
+    out.put_byte(tag);
+    switch (tag)
+      {
+      case CODEC_REAL:
+        out.put_double(boost::get<double>(iter->second));
+        break;
+      case CODEC_STRING:
+        out.put_string(boost::get<SharedString>(iter->second));
+        break;
+      case CODEC_TIMESTAMP:
+        out.put_signed(timestamp_to_ticks(boost::get<Timestamp>(iter->second)));
+        break;
+      default:
+        break;
+      }
+    }
+}
+
+inline void decode_property_map(ByteReader& in, PropertyMap& properties)
+{
+  std::size_t count = static_cast<std::size_t>(in.get_varint());
+  for (std::size_t i = 0; i < count; ++i)
+    {
+    std::string name(in.get_string());
+    std::uint8_t tag = in.get_byte();
+    switch (tag)
+      {
+      case CODEC_REAL:
+        properties[name] = in.get_double();
+        break;
+      case CODEC_STRING:
+        properties[name] = in.get_string();
+        break;
+      case CODEC_TIMESTAMP:
+        properties[name] = ticks_to_timestamp(in.get_signed());
+        break;
+      default:
+        if (tag < CODEC_NULL)
+          {
+          throw ParseError("TrajectoryCodec: unknown property type");
+          }
+        properties[name] = make_null(static_cast<PropertyUnderlyingType>(tag - CODEC_NULL));
+        break;
+      }
+    }
+}
+
+// Run-length encoding for columns that rarely change (object IDs,
+// property type tags)
+template<typename value_type, typename write_function>
+void write_runs(ByteWriter& out, std::vector<value_type> const& values, write_function write_value)
+{
+  std::vector<std::size_t> run_starts;
+  for (std::size_t i = 0; i < values.size(); ++i)
+    {
+    if (i == 0 || !(values[i] == values[i-1]))
+      {
+      run_starts.push_back(i);
+      }
+    }
+  out.put_varint(run_starts.size());
+  for (std::size_t run = 0; run < run_starts.size(); ++run)
+    {
+    std::size_t finish = (run + 1 < run_starts.size()) ? run_starts[run+1] : values.size();
+    write_value(out, values[run_starts[run]]);
+    out.put_varint(finish - run_starts[run]);
+    }
+}
+
+template<typename value_type, typename read_function>
+void read_runs(ByteReader& in, std::size_t expected_size, std::vector<value_type>& values, read_function read_value)
+{
+  values.clear();
+  values.reserve(expected_size);
+  std::size_t num_runs = static_cast<std::size_t>(in.get_varint());
+  for (std::size_t run = 0; run < num_runs; ++run)
+    {
+    value_type value(read_value(in));
+    std::size_t length = static_cast<std::size_t>(in.get_varint());
+    if (length > expected_size - values.size())
+      {
+      throw ParseError("TrajectoryCodec: run extends past the end of the trajectory");
+      }
+    values.insert(values.end(), length, value);
+    }
+  if (values.size() != expected_size)
+    {
+    throw ParseError("TrajectoryCodec: run lengths do not match the number of points");
+    }
+}
+
+} } // close namespace tracktable::rw::detail
+
+/** Compact binary encoder/decoder for trajectories
+ *
+ * Encoding is lossless unless you ask for quantized coordinates with
+ * set_coordinate_precision().  With a precision of, say, 1e-6 degrees
+ * (about 10 cm), each decoded coordinate is within half that amount
+ * of the original.  Columns whose values cannot be quantized exactly
+ * (non-finite or out of range) automatically fall back to lossless
+ * encoding.
+ *
+ * Example:
+ *
+ * @code
+ * TrajectoryCodec<trajectory_type> codec;
+ * codec.set_coordinate_precision(1e-6);
+ *
+ * std::vector<std::uint8_t> bytes(codec.encode(trajectory));
+ * trajectory_type copy(codec.decode(bytes));
+ * @endcode
+ *
+ * Use write() and read() to store a sequence of encoded trajectories
+ * in a binary stream.
+ */
+
+template<typename TrajectoryT>
+class TrajectoryCodec
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef rw::detail::byte_buffer_type buffer_type;
+
+  static const std::size_t Dimension = traits::dimension<point_type>::value;
+
+  TrajectoryCodec()
+    : CoordinatePrecision(0)
+    { }
+
+  /** Quantize coordinates to this step size
+   *
+   * The default value of 0 stores coordinates losslessly.
+   *
+   * @param [in] precision Quantization step in coordinate units
+   */
+  void set_coordinate_precision(double precision)
+    {
+      this->CoordinatePrecision = (precision > 0) ? precision : 0;
+    }
+
+  double coordinate_precision() const
+    {
+      return this->CoordinatePrecision;
+    }
+
+  /** Encode a trajectory into a new buffer
+   *
+   * @param [in] trajectory Trajectory to encode
+   * @return Encoded bytes
+   */
+  buffer_type encode(trajectory_type const& trajectory) const
+    {
+      buffer_type result;
+      this->encode(trajectory, result);
+      return result;
+    }
+
+  /** Append an encoded trajectory to an existing buffer
+   *
+   * Reusing the same buffer for many trajectories avoids repeated
+   * allocation.
+   *
+   * @param [in] trajectory Trajectory to encode
+   * @param [in,out] buffer Bytes are appended here
+   */
+  void encode(trajectory_type const& trajectory, buffer_type& buffer) const
+    {
+      rw::detail::ByteWriter out(buffer);
+      std::size_t num_points = trajectory.size();
+
+      out.put_bytes(reinterpret_cast<std::uint8_t const*>(Magic), 3);
+      out.put_byte(FormatVersion);
+      out.put_byte(static_cast<std::uint8_t>(Dimension));
+      out.put_bytes(trajectory.uuid().data, 16);
+      rw::detail::encode_property_map(out, trajectory.__properties());
+      out.put_varint(num_points);
+      if (num_points == 0)
+        {
+        return;
+        }
+
+      this->encode_object_ids(out, trajectory);
+      this->encode_timestamps(out, trajectory);
+      this->encode_coordinates(out, trajectory);
+      this->encode_point_properties(out, trajectory);
+    }
+
+  /** Decode a trajectory from a buffer
+   *
+   * @param [in] buffer Bytes produced by encode()
+   * @return Decoded trajectory
+   * @throws ParseError if the buffer is truncated or malformed
+   */
+  trajectory_type decode(buffer_type const& buffer) const
+    {
+      trajectory_type result(false);
+      this->decode(buffer.data(), buffer.size(), result);
+      return result;
+    }
+
+  /** Check whether a block of memory starts with an encoded trajectory
+   *
+   * Only the leading magic number is checked.  Use this to tell
+   * encoded trajectories apart from other formats in the same place.
+   *
+   * @param [in] data Start of data
+   * @param [in] size Number of bytes available
+   */
+  static bool is_encoded(std::uint8_t const* data, std::size_t size)
+    {
+      return (size >= 3
+              && std::equal(data, data + 3, reinterpret_cast<std::uint8_t const*>(Magic)));
+    }
+
+  /** Decode one trajectory from the front of a block of memory
+   *
+   * @param [in] data Start of encoded data
+   * @param [in] size Number of bytes available
+   * @param [out] trajectory Decoded trajectory
+   * @return Number of bytes consumed
+   * @throws ParseError if the data is truncated or malformed
+   */
+  std::size_t decode(std::uint8_t const* data, std::size_t size, trajectory_type& trajectory) const
+    {
+      rw::detail::ByteReader in(data, size);
+      std::uint8_t const* magic = in.get_bytes(3);
+      if (!std::equal(magic, magic + 3, reinterpret_cast<std::uint8_t const*>(Magic)))
+        {
+        throw ParseError("TrajectoryCodec: data does not start with an encoded trajectory");
+        }
+      if (in.get_byte() != FormatVersion)
+        {
+        throw ParseError("TrajectoryCodec: unsupported format version");
+        }
+      if (in.get_byte() != Dimension)
+        {
+        throw ParseError("TrajectoryCodec: encoded points have a different dimension");
+        }
+
+      uuid_type uuid;
+      std::uint8_t const* uuid_bytes = in.get_bytes(16);
+      std::copy(uuid_bytes, uuid_bytes + 16, uuid.data);
+      PropertyMap trajectory_properties;
+      rw::detail::decode_property_map(in, trajectory_properties);
+
+      std::size_t num_points = static_cast<std::size_t>(in.get_varint());
+      // Every point costs at least one byte, so a larger count can
+      // only come from corrupt data
+      if (num_points > in.remaining())
+        {
+        throw ParseError("TrajectoryCodec: point count exceeds encoded data");
+        }
+      std::vector<point_type> points(num_points);
+      if (num_points > 0)
+        {
+        this->decode_object_ids(in, points);
+        this->decode_timestamps(in, points);
+        this->decode_coordinates(in, points);
+        this->decode_point_properties(in, points);
+        }
+
+      trajectory = trajectory_type(points.begin(), points.end(), false);
+      trajectory.set_uuid(uuid);
+      // Not swap(): the two maps may come from different memory resources
+      trajectory.__non_const_properties() = std::move(trajectory_properties);
+      return static_cast<std::size_t>(in.position() - data);
+    }
+
+  /** Write one length-prefixed encoded trajectory to a binary stream
+   *
+   * @param [in] out Stream opened in binary mode
+   * @param [in] trajectory Trajectory to write
+   */
+  void write(std::ostream& out, trajectory_type const& trajectory) const
+    {
+      buffer_type body;
+      this->encode(trajectory, body);
+      buffer_type prefix;
+      rw::detail::ByteWriter prefix_writer(prefix);
+      prefix_writer.put_varint(body.size());
+      out.write(reinterpret_cast<char const*>(prefix.data()), static_cast<std::streamsize>(prefix.size()));
+      out.write(reinterpret_cast<char const*>(body.data()), static_cast<std::streamsize>(body.size()));
+    }
+
+  /** Read one trajectory written by write()
+   *
+   * @param [in] in Stream opened in binary mode
+   * @param [out] trajectory Decoded trajectory
+   * @return False at a clean end of stream, true otherwise
+   * @throws ParseError if the stream ends in the middle of a record
+   */
+  bool read(std::istream& in, trajectory_type& trajectory) const
+    {
+      std::uint64_t size = 0;
+      for (int shift = 0; ; shift += 7)
+        {
+        int next = in.get();
+        if (next == std::char_traits<char>::eof())
+          {
+          if (shift == 0)
+            {
+            return false;
+            }
+          throw ParseError("TrajectoryCodec: stream ends inside a record length");
+          }
+        if (shift >= 64)
+          {
+          throw ParseError("TrajectoryCodec: malformed record length");
+          }
+        size |= static_cast<std::uint64_t>(next & 0x7f) << shift;
+        if ((next & 0x80) == 0)
+          {
+          break;
+          }
+        }
+
+      // Read the body a chunk at a time so that a corrupt length
+      // cannot make us allocate more than the stream actually holds.
+      const std::uint64_t chunk_size = 1 << 20;
+      buffer_type body;
+      while (body.size() < size)
+        {
+        std::size_t offset = body.size();
+        std::size_t chunk = static_cast<std::size_t>(std::min<std::uint64_t>(chunk_size, size - offset));
+        body.resize(offset + chunk);
+        in.read(reinterpret_cast<char*>(body.data() + offset), static_cast<std::streamsize>(chunk));
+        if (static_cast<std::size_t>(in.gcount()) != chunk)
+          {
+          throw ParseError("TrajectoryCodec: stream ends inside a record");
+          }
+        }
+      this->decode(body.data(), body.size(), trajectory);
+      return true;
+    }
+
+private:
+  static const std::uint8_t FormatVersion = 1;
+  static constexpr char const* Magic = "TTC";
+
+  enum coordinate_mode
+  {
+    QUANTIZED_DELTA = 0,
+    XOR_COMPRESSED  = 1
+  };
+
+  // ----------------------------------------------------------------------
+
+  void encode_object_ids(rw::detail::ByteWriter& out, trajectory_type const& trajectory) const
+    {
+      std::vector<std::string> ids;
+      ids.reserve(trajectory.size());
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        ids.push_back(trajectory[i].object_id());
+        }
+      rw::detail::write_runs(out, ids,
+                             [](rw::detail::ByteWriter& writer, std::string const& id) {
+                               writer.put_string(id);
+                             });
+    }
+
+  void decode_object_ids(rw::detail::ByteReader& in, std::vector<point_type>& points) const
+    {
+      std::vector<std::string> ids;
+      rw::detail::read_runs(in, points.size(), ids,
+                            [](rw::detail::ByteReader& reader) { return reader.get_string(); });
+      for (std::size_t i = 0; i < points.size(); ++i)
+        {
+        points[i].set_object_id(ids[i]);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  void encode_timestamps(rw::detail::ByteWriter& out, trajectory_type const& trajectory) const
+    {
+      std::int64_t previous = 0;
+      std::int64_t previous_delta = 0;
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        std::int64_t ticks = rw::detail::timestamp_to_ticks(trajectory[i].timestamp());
+        std::int64_t delta = rw::detail::wrapping_difference(ticks, previous);
+        out.put_signed(rw::detail::wrapping_difference(delta, previous_delta));
+        previous = ticks;
+        previous_delta = delta;
+        }
+    }
+
+  void decode_timestamps(rw::detail::ByteReader& in, std::vector<point_type>& points) const
+    {
+      std::int64_t previous = 0;
+      std::int64_t previous_delta = 0;
+      for (std::size_t i = 0; i < points.size(); ++i)
+        {
+        std::int64_t delta = rw::detail::wrapping_sum(previous_delta, in.get_signed());
+        std::int64_t ticks = rw::detail::wrapping_sum(previous, delta);
+        points[i].set_timestamp(rw::detail::ticks_to_timestamp(ticks));
+        previous = ticks;
+        previous_delta = delta;
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  bool can_quantize(trajectory_type const& trajectory, std::size_t d) const
+    {
+      if (this->CoordinatePrecision <= 0)
+        {
+        return false;
+        }
+      // Stay well inside the range where doubles hold integers exactly
+      double const limit = 4.0e15;
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        double scaled = trajectory[i][d] / this->CoordinatePrecision;
+        if (!(std::fabs(scaled) < limit))
+          {
+          return false;
+          }
+        }
+      return true;
+    }
+
+  void encode_coordinates(rw::detail::ByteWriter& out, trajectory_type const& trajectory) const
+    {
+      for (std::size_t d = 0; d < Dimension; ++d)
+        {
+        if (this->can_quantize(trajectory, d))
+          {
+          out.put_byte(QUANTIZED_DELTA);
+          out.put_double(this->CoordinatePrecision);
+          std::int64_t previous = 0;
+          for (std::size_t i = 0; i < trajectory.size(); ++i)
+            {
+            std::int64_t quantized = std::llround(trajectory[i][d] / this->CoordinatePrecision);
+            out.put_signed(quantized - previous);
+            previous = quantized;
+            }
+          }
+        else
+          {
+          out.put_byte(XOR_COMPRESSED);
+          rw::detail::XorEncoder encoder(out);
+          for (std::size_t i = 0; i < trajectory.size(); ++i)
+            {
+            encoder.put(trajectory[i][d]);
+            }
+          encoder.flush();
+          }
+        }
+    }
+
+  void decode_coordinates(rw::detail::ByteReader& in, std::vector<point_type>& points) const
+    {
+      for (std::size_t d = 0; d < Dimension; ++d)
+        {
+        std::uint8_t mode = in.get_byte();
+        if (mode == QUANTIZED_DELTA)
+          {
+          double precision = in.get_double();
+          std::int64_t quantized = 0;
+          for (std::size_t i = 0; i < points.size(); ++i)
+            {
+            quantized = rw::detail::wrapping_sum(quantized, in.get_signed());
+            points[i][d] = static_cast<double>(quantized) * precision;
+            }
+          }
+        else if (mode == XOR_COMPRESSED)
+          {
+          rw::detail::XorDecoder decoder(in);
+          for (std::size_t i = 0; i < points.size(); ++i)
+            {
+            points[i][d] = decoder.get();
+            }
+          }
+        else
+          {
+          throw ParseError("TrajectoryCodec: unknown coordinate encoding");
+          }
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  void encode_point_properties(rw::detail::ByteWriter& out, trajectory_type const& trajectory) const
+    {
+      // Properties hoisted into a shared block are written with every
+      // point just like the point's own properties.
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        if (trajectory[i].shared_properties())
+          {
+          trajectory_type flat(trajectory);
+          for (std::size_t j = 0; j < flat.size(); ++j)
+            {
+            flat[j].unshare_properties();
+            }
+          this->encode_point_properties(out, flat);
+          return;
+          }
+        }
+
+      std::map<std::string, std::size_t> columns;
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        PropertyMap const& properties(trajectory[i].__properties());
+        for (PropertyMap::const_iterator iter = properties.begin(); iter != properties.end(); ++iter)
+          {
+          columns.insert(std::make_pair(iter->first, columns.size()));
+          }
+        }
+
+      out.put_varint(columns.size());
+      std::vector<std::uint8_t> tags(trajectory.size());
+      for (std::map<std::string, std::size_t>::const_iterator column = columns.begin();
+           column != columns.end(); ++column)
+        {
+        std::string const& name(column->first);
+        for (std::size_t i = 0; i < trajectory.size(); ++i)
+          {
+          PropertyMap const& properties(trajectory[i].__properties());
+          PropertyMap::const_iterator value = properties.find(name);
+          tags[i] = (value == properties.end()) ? static_cast<std::uint8_t>(rw::detail::CODEC_ABSENT)
+                                                : rw::detail::property_tag(value->second);
+          }
+
+        out.put_string(name);
+        rw::detail::write_runs(out, tags,
+                               [](rw::detail::ByteWriter& writer, std::uint8_t tag) {
+                                 writer.put_byte(tag);
+                               });
+
+        // Real values
+        {
+          rw::detail::XorEncoder encoder(out);
+          for (std::size_t i = 0; i < trajectory.size(); ++i)
+            {
+            if (tags[i] == rw::detail::CODEC_REAL)
+              {
+              encoder.put(boost::get<double>(trajectory[i].__properties().find(name)->second));
+              }
+            }
+          encoder.flush();
+        }
+
+        // String values: index into a dictionary that grows as new
+        // strings appear.  An index equal to the dictionary size
+        // introduces a new string.
+        {
+          boost::unordered_map<std::string, std::size_t> dictionary;
+          for (std::size_t i = 0; i < trajectory.size(); ++i)
+            {
+            if (tags[i] == rw::detail::CODEC_STRING)
+              {
+              string_type const& value(boost::get<SharedString>(trajectory[i].__properties().find(name)->second));
+              std::pair<boost::unordered_map<std::string, std::size_t>::iterator, bool> inserted(
+                dictionary.insert(std::make_pair(value, dictionary.size())));
+              out.put_varint(inserted.first->second);
+              if (inserted.second)
+                {
+                out.put_string(value);
+                }
+              }
+            }
+        }
+
+        // Timestamp values
+        {
+          std::int64_t previous = 0;
+          for (std::size_t i = 0; i < trajectory.size(); ++i)
+            {
+            if (tags[i] == rw::detail::CODEC_TIMESTAMP)
+              {
+              std::int64_t ticks = rw::detail::timestamp_to_ticks(
+                boost::get<Timestamp>(trajectory[i].__properties().find(name)->second));
+              out.put_signed(rw::detail::wrapping_difference(ticks, previous));
+              previous = ticks;
+              }
+            }
+        }
+        }
+    }
+
+  void decode_point_properties(rw::detail::ByteReader& in, std::vector<point_type>& points) const
+    {
+      std::size_t num_columns = static_cast<std::size_t>(in.get_varint());
+      std::vector<std::uint8_t> tags;
+      for (std::size_t column = 0; column < num_columns; ++column)
+        {
+        std::string name(in.get_string());
+        rw::detail::read_runs(in, points.size(), tags,
+                              [](rw::detail::ByteReader& reader) { return reader.get_byte(); });
+
+        {
+          bool any_reals = std::find(tags.begin(), tags.end(),
+                                     static_cast<std::uint8_t>(rw::detail::CODEC_REAL)) != tags.end();
+          if (any_reals)
+            {
+            rw::detail::XorDecoder decoder(in);
+            for (std::size_t i = 0; i < points.size(); ++i)
+              {
+              if (tags[i] == rw::detail::CODEC_REAL)
+                {
+                points[i].set_property(name, decoder.get());
+                }
+              }
+            }
+        }
+
+        // Points that repeat a dictionary entry share its storage
+        {
+          std::vector<SharedString> dictionary;
+          for (std::size_t i = 0; i < points.size(); ++i)
+            {
+            if (tags[i] == rw::detail::CODEC_STRING)
+              {
+              std::size_t index = static_cast<std::size_t>(in.get_varint());
+              if (index == dictionary.size())
+                {
+                dictionary.push_back(in.get_string());
+                }
+              else if (index > dictionary.size())
+                {
+                throw ParseError("TrajectoryCodec: string dictionary index out of range");
+                }
+              points[i].set_property(name, dictionary[index]);
+              }
+            }
+        }
+
+        {
+          std::int64_t previous = 0;
+          for (std::size_t i = 0; i < points.size(); ++i)
+            {
+            if (tags[i] == rw::detail::CODEC_TIMESTAMP)
+              {
+              previous = rw::detail::wrapping_sum(previous, in.get_signed());
+              points[i].set_property(name, rw::detail::ticks_to_timestamp(previous));
+              }
+            }
+        }
+
+        for (std::size_t i = 0; i < points.size(); ++i)
+          {
+          if (tags[i] >= rw::detail::CODEC_NULL)
+            {
+            points[i].set_property(name, make_null(static_cast<PropertyUnderlyingType>(tags[i] - rw::detail::CODEC_NULL)));
+            }
+          else if (tags[i] > rw::detail::CODEC_TIMESTAMP)
+            {
+            throw ParseError("TrajectoryCodec: unknown property type");
+            }
+          }
+        }
+    }
+
+  double CoordinatePrecision;
+};
+
+template<typename TrajectoryT>
+const std::size_t TrajectoryCodec<TrajectoryT>::Dimension;
+
+template<typename TrajectoryT>
+const std::uint8_t TrajectoryCodec<TrajectoryT>::FormatVersion;
+
+template<typename TrajectoryT>
+constexpr char const* TrajectoryCodec<TrajectoryT>::Magic;
+
+} // close namespace tracktable
+
+#endif
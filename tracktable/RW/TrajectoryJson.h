@@ -0,0 +1,998 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// TrajectoryJson - read and write trajectories as JSON or GeoJSON
+//
+// The JSON layout is the one tracktable.rw.read_write_json has always
+// used, so files written by either side can be read by the other:
+//
+//   {"coordinates": [[x, y], ...], "domain": "terrestrial",
+//    "object_id": "...",
+//    "point_properties": {"name": {"type": "float", "values": [...]}},
+//    "timestamps": ["YYYY-MM-DD HH:MM:SS", ...],
+//    "trajectory_properties": {"name": {"type": "str", "value": ...}}}
+//
+// There is one point property column for every property that appears
+// on any point.  Points that do not have a property get null in its
+// column.  (The Python dictionary conversion only looks at the first
+// point's properties.)  Output is ASCII and numbers are formatted as
+// Python's json module formats them.
+//
+// In GeoJSON mode each trajectory becomes a Feature with a LineString
+// geometry and everything else under "properties".  The reader
+// accepts either layout without being told which one it has.
+//
+// Input is parsed with an event-driven parser straight into columns,
+// so there is no intermediate document tree.  Collections can be read
+// and written one trajectory per line (newline-delimited JSON) to keep
+// memory use flat, or as a GeoJSON FeatureCollection.
+
+#ifndef __tracktable_TrajectoryJson_h
+#define __tracktable_TrajectoryJson_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/PointTraits.h>
+#include <tracktable/Core/PropertyMap.h>
+#include <tracktable/Core/Timestamp.h>
+
+#include <tracktable/RW/ParseExceptions.h>
+#include <tracktable/RW/detail/JsonSax.h>
+
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace tracktable {
+
+namespace rw { namespace detail {
+
+/// One JSON scalar, kept until we know what type it is meant to be
+struct JsonScalar
+{
+  enum Kind { NUMBER, STRING, BOOLEAN, NULL_VALUE };
+
+  JsonScalar() : ValueKind(NULL_VALUE), Number(0) { }
+
+  Kind ValueKind;
+  double Number;
+  std::string String;
+};
+
+struct JsonPropertyColumn
+{
+  std::string TypeName;
+  std::vector<JsonScalar> Values;
+};
+
+/** A trajectory as it appears in JSON, before it is tied to a domain
+ *
+ * Coordinates are stored flat.  PointDimensions holds the number of
+ * coordinates each point had so that we can complain about the ones
+ * that do not match the domain.
+ */
+struct JsonTrajectoryRecord
+{
+  std::string Domain;
+  std::string ObjectId;
+  bool ObjectIdIsString;
+  std::vector<double> Coordinates;
+  std::vector<std::size_t> PointDimensions;
+  std::vector<Timestamp> Timestamps;
+  std::map<std::string, JsonPropertyColumn> PointProperties;
+  std::map<std::string, JsonPropertyColumn> TrajectoryProperties;
+
+  JsonTrajectoryRecord() : ObjectIdIsString(true) { }
+
+  void clear()
+    {
+      this->Domain.clear();
+      this->ObjectId.clear();
+      this->ObjectIdIsString = true;
+      this->Coordinates.clear();
+      this->PointDimensions.clear();
+      this->Timestamps.clear();
+      this->PointProperties.clear();
+      this->TrajectoryProperties.clear();
+    }
+};
+
+typedef std::function<void(JsonTrajectoryRecord&)> json_record_callback_type;
+
+/*
+ * SAX handler that routes values into a JsonTrajectoryRecord
+ * according to where they sit in the document.
+ *
+ * A record is any of:
+ * - the top-level object
+ * - each element of a top-level array
+ * - each element of the "features" array of a FeatureCollection
+ *
+ * Within a record, keys under "properties" are treated as if they
+ * were at the top level and "geometry"/"coordinates" is treated like
+ * "coordinates".  Keys we do not know about are skipped.
+ */
+class JsonTrajectoryHandler
+{
+public:
+  JsonTrajectoryHandler(json_record_callback_type callback)
+    : Callback(callback)
+    , RecordRoot(-1)
+    , SawNestedRecords(false)
+    , CurrentColumn(nullptr)
+    { }
+
+  void start_object()
+    {
+      std::size_t depth = this->Stack.size();
+      if (this->RecordRoot < 0 && (depth == 0 || (depth == 1 && this->Stack[0].IsArray)))
+        {
+        this->begin_record(static_cast<int>(depth));
+        }
+      else if (this->RecordRoot == 0 && depth == 2
+               && this->Stack[0].Key == "features" && this->Stack[1].IsArray)
+        {
+        this->SawNestedRecords = true;
+        this->begin_record(2);
+        }
+      this->Stack.push_back(Frame(false));
+    }
+
+  void end_object()
+    {
+      this->Stack.pop_back();
+      if (static_cast<int>(this->Stack.size()) == this->RecordRoot)
+        {
+        if (!(this->RecordRoot == 0 && this->SawNestedRecords))
+          {
+          this->Callback(this->Record);
+          }
+        this->RecordRoot = (this->RecordRoot == 2) ? 0 : -1;
+        this->Record.clear();
+        }
+    }
+
+  void start_array()
+    {
+      std::string name;
+      Target target = this->classify(name);
+      this->Stack.push_back(Frame(true));
+      if (target == POINT)
+        {
+        this->Record.PointDimensions.push_back(0);
+        }
+      else if (target == POINT_PROPERTY_VALUES)
+        {
+        this->CurrentColumn = &this->Record.PointProperties[name];
+        }
+    }
+
+  void end_array()
+    {
+      this->Stack.pop_back();
+      this->CurrentColumn = nullptr;
+    }
+
+  void key(std::string const& name)
+    {
+      this->Stack.back().Key = name;
+    }
+
+  void string_value(std::string const& value)
+    {
+      std::string name;
+      switch (this->classify(name))
+        {
+        case DOMAIN_NAME:
+          this->Record.Domain = value;
+          break;
+        case OBJECT_ID:
+          this->Record.ObjectId = value;
+          this->Record.ObjectIdIsString = true;
+          break;
+        case TIMESTAMP:
+          this->Record.Timestamps.push_back(parse_json_timestamp(value));
+          break;
+        case POINT_PROPERTY_TYPE:
+          this->Record.PointProperties[name].TypeName = value;
+          break;
+        case TRAJECTORY_PROPERTY_TYPE:
+          this->Record.TrajectoryProperties[name].TypeName = value;
+          break;
+        case POINT_PROPERTY_VALUE:
+        case TRAJECTORY_PROPERTY_VALUE:
+          {
+          JsonScalar scalar;
+          scalar.ValueKind = JsonScalar::STRING;
+          scalar.String = value;
+          this->store_property_value(name, scalar);
+          }
+          break;
+        case COORDINATE:
+          throw ParseError("Coordinates in JSON must be numbers");
+        default:
+          break;
+        }
+    }
+
+  void number_value(double value)
+    {
+      std::string name;
+      switch (this->classify(name))
+        {
+        case COORDINATE:
+          this->Record.Coordinates.push_back(value);
+          ++this->Record.PointDimensions.back();
+          break;
+        case POINT_PROPERTY_VALUE:
+        case TRAJECTORY_PROPERTY_VALUE:
+          {
+          JsonScalar scalar;
+          scalar.ValueKind = JsonScalar::NUMBER;
+          scalar.Number = value;
+          this->store_property_value(name, scalar);
+          }
+          break;
+        default:
+          this->non_string_value();
+          break;
+        }
+    }
+
+  void boolean_value(bool value)
+    {
+      std::string name;
+      Target target = this->classify(name);
+      if (target == POINT_PROPERTY_VALUE || target == TRAJECTORY_PROPERTY_VALUE)
+        {
+        JsonScalar scalar;
+        scalar.ValueKind = JsonScalar::BOOLEAN;
+        scalar.Number = value ? 1 : 0;
+        this->store_property_value(name, scalar);
+        }
+      else
+        {
+        this->non_string_value();
+        }
+    }
+
+  void null_value()
+    {
+      std::string name;
+      Target target = this->classify(name);
+      if (target == POINT_PROPERTY_VALUE || target == TRAJECTORY_PROPERTY_VALUE)
+        {
+        this->store_property_value(name, JsonScalar());
+        }
+      else
+        {
+        this->non_string_value();
+        }
+    }
+
+private:
+  struct Frame
+  {
+    Frame(bool is_array) : IsArray(is_array) { }
+
+    bool IsArray;
+    std::string Key;
+  };
+
+  enum Target
+  {
+    IGNORE,
+    DOMAIN_NAME,
+    OBJECT_ID,
+    POINT,
+    COORDINATE,
+    TIMESTAMP,
+    POINT_PROPERTY_TYPE,
+    POINT_PROPERTY_VALUES,
+    POINT_PROPERTY_VALUE,
+    TRAJECTORY_PROPERTY_TYPE,
+    TRAJECTORY_PROPERTY_VALUE
+  };
+
+  void begin_record(int root)
+    {
+      this->RecordRoot = root;
+      this->Record.clear();
+    }
+
+  // Work out what the next value (or array) is for from the keys
+  // between it and the root of the record.
+  Target classify(std::string& property_name) const
+    {
+      if (this->RecordRoot < 0)
+        {
+        return IGNORE;
+        }
+      std::size_t root = static_cast<std::size_t>(this->RecordRoot);
+      std::size_t depth = this->Stack.size();
+      if (depth <= root)
+        {
+        return IGNORE;
+        }
+
+      if (this->Stack[root].Key == "geometry")
+        {
+        if (depth >= root + 2 && this->Stack[root + 1].Key == "coordinates")
+          {
+          if (depth == root + 4) return COORDINATE;
+          if (depth == root + 3) return POINT;
+          }
+        return IGNORE;
+        }
+
+      if (this->Stack[root].Key == "properties" && depth > root + 1 && !this->Stack[root + 1].IsArray)
+        {
+        ++root;
+        }
+
+      std::string const& field = this->Stack[root].Key;
+      std::size_t level = depth - root;
+      if (field == "coordinates")
+        {
+        if (level == 3) return COORDINATE;
+        if (level == 2) return POINT;
+        }
+      else if (field == "timestamps")
+        {
+        if (level == 2) return TIMESTAMP;
+        }
+      else if (field == "point_properties")
+        {
+        if (level >= 3)
+          {
+          property_name = this->Stack[root + 1].Key;
+          std::string const& part = this->Stack[root + 2].Key;
+          if (level == 3 && part == "type") return POINT_PROPERTY_TYPE;
+          if (level == 3 && part == "values") return POINT_PROPERTY_VALUES;
+          if (level == 4 && part == "values") return POINT_PROPERTY_VALUE;
+          }
+        }
+      else if (field == "trajectory_properties")
+        {
+        if (level == 3)
+          {
+          property_name = this->Stack[root + 1].Key;
+          std::string const& part = this->Stack[root + 2].Key;
+          if (part == "type") return TRAJECTORY_PROPERTY_TYPE;
+          if (part == "value") return TRAJECTORY_PROPERTY_VALUE;
+          }
+        }
+      else if (level == 1)
+        {
+        if (field == "domain") return DOMAIN_NAME;
+        if (field == "object_id") return OBJECT_ID;
+        }
+      return IGNORE;
+    }
+
+  void store_property_value(std::string const& name, JsonScalar const& value)
+    {
+      if (this->CurrentColumn != nullptr)
+        {
+        this->CurrentColumn->Values.push_back(value);
+        }
+      else
+        {
+        // Trajectory properties have exactly one value
+        std::vector<JsonScalar>& values = this->Record.TrajectoryProperties[name].Values;
+        values.assign(1, value);
+        }
+    }
+
+  // Python only ever writes object IDs as strings and insists on
+  // reading them that way too.
+  void non_string_value()
+    {
+      std::string name;
+      if (this->classify(name) == OBJECT_ID)
+        {
+        this->Record.ObjectIdIsString = false;
+        }
+    }
+
+  json_record_callback_type Callback;
+  std::vector<Frame> Stack;
+  int RecordRoot;
+  bool SawNestedRecords;
+  JsonTrajectoryRecord Record;
+  JsonPropertyColumn* CurrentColumn;
+};
+
+/** Parse every JSON value in a buffer
+ *
+ * Values may be separated by any whitespace, which covers both a
+ * single document and newline-delimited JSON.
+ *
+ * @return Number of trajectory records found
+ */
+inline std::size_t parse_json_trajectories(char const* begin, char const* end,
+                                           json_record_callback_type callback)
+{
+  std::size_t num_records = 0;
+  JsonTrajectoryHandler handler([&num_records, &callback](JsonTrajectoryRecord& record) {
+      ++num_records;
+      callback(record);
+    });
+  JsonSaxParser<JsonTrajectoryHandler> parser(begin, end, handler);
+  while (parser.parse_value())
+    {
+    }
+  return num_records;
+}
+
+// ----------------------------------------------------------------------
+
+inline PropertyUnderlyingType json_type_name_to_property_type(std::string const& type_name)
+{
+  if (type_name == "float" || type_name == "int" || type_name == "bool")
+    {
+    return TYPE_REAL;
+    }
+  else if (type_name == "str")
+    {
+    return TYPE_STRING;
+    }
+  else if (type_name == "datetime" || type_name == "timestamp")
+    {
+    return TYPE_TIMESTAMP;
+    }
+  return TYPE_UNKNOWN;
+}
+
+inline std::string property_type_to_json_type_name(PropertyUnderlyingType type)
+{
+  switch (type)
+    {
+    case TYPE_REAL: return "float";
+    case TYPE_STRING: return "str";
+    case TYPE_TIMESTAMP: return "datetime";
+    default: return "NoneType";
+    }
+}
+
+inline PropertyValue json_scalar_to_property(std::string const& name,
+                                             JsonScalar const& value,
+                                             PropertyUnderlyingType type)
+{
+  if (value.ValueKind == JsonScalar::NULL_VALUE)
+    {
+    return make_null(type);
+    }
+
+  if (type == TYPE_UNKNOWN)
+    {
+    type = (value.ValueKind == JsonScalar::STRING) ? TYPE_STRING : TYPE_REAL;
+    }
+
+  bool is_number = (value.ValueKind != JsonScalar::STRING);
+  if (type == TYPE_REAL && is_number)
+    {
+    return PropertyValue(value.Number);
+    }
+  else if (type == TYPE_STRING && !is_number)
+    {
+    return PropertyValue(value.String);
+    }
+  else if (type == TYPE_TIMESTAMP && !is_number)
+    {
+    return PropertyValue(parse_json_timestamp(value.String));
+    }
+
+  throw ParseError("Error: property " + name + " has a value that does not match its type");
+}
+
+inline PropertyUnderlyingType json_property_type(PropertyValue const& value)
+{
+  PropertyUnderlyingType type = property_underlying_type(value);
+  if (type == TYPE_NULL)
+    {
+    return boost::get<NullValue>(value).ExpectedType;
+    }
+  return type;
+}
+
+inline void append_json_property_value(std::string& out, PropertyValue const& value)
+{
+  switch (property_underlying_type(value))
+    {
+    case TYPE_REAL:
+      append_json_number(out, boost::get<double>(value));
+      break;
+    case TYPE_STRING:
+      append_json_string(out, boost::get<SharedString>(value));
+      break;
+    case TYPE_TIMESTAMP:
+      append_json_timestamp(out, boost::get<Timestamp>(value));
+      break;
+    default:
+      out.append("null");
+      break;
+    }
+}
+
+} } // namespace rw::detail
+
+// ----------------------------------------------------------------------
+
+/**
+ * @class TrajectoryJson
+ * @brief Read and write trajectories as JSON or GeoJSON
+ *
+ * Writing:
+ *
+ * @code
+ * tracktable::TrajectoryJson<trajectory_type> json;
+ * std::string text = json.encode(trajectory);
+ *
+ * json.set_geojson(true);
+ * json.write_feature_collection(outfile, trajectories.begin(), trajectories.end());
+ * @endcode
+ *
+ * Reading:
+ *
+ * @code
+ * trajectory_type trajectory = json.decode(text);
+ *
+ * // One trajectory per line
+ * while (json.read(infile, trajectory))
+ *   {
+ *   ...
+ *   }
+ * @endcode
+ *
+ * Malformed input throws ParseError.  So do trajectories whose
+ * coordinates, timestamps or point properties disagree about how
+ * many points there are, and trajectories from another domain.
+ *
+ * Timestamps are written to the second, as in the Python
+ * implementation.  Point properties are written for every property
+ * that appears on any point; points that lack one get a null.
+ */
+template<typename TrajectoryT>
+class TrajectoryJson
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+  typedef rw::detail::JsonTrajectoryRecord record_type;
+
+  TrajectoryJson()
+    : GeoJson(false)
+    { }
+
+  /// Write GeoJSON Features instead of Tracktable's own layout
+  void set_geojson(bool onoff)
+    {
+      this->GeoJson = onoff;
+    }
+
+  bool geojson() const
+    {
+      return this->GeoJson;
+    }
+
+  // ---------------------------------------------------------------
+  // Writing
+
+  /** Append the JSON for one trajectory to a string
+   *
+   * @param [in]  trajectory  Trajectory to encode
+   * @param [out] out         String to append to
+   */
+  void encode(trajectory_type const& trajectory, std::string& out) const
+    {
+      using namespace rw::detail;
+
+      if (this->GeoJson)
+        {
+        out.append("{\"geometry\": {\"coordinates\": ");
+        this->append_coordinates(trajectory, out);
+        out.append(", \"type\": \"LineString\"}, \"properties\": {\"domain\": ");
+        }
+      else
+        {
+        out.append("{\"coordinates\": ");
+        this->append_coordinates(trajectory, out);
+        out.append(", \"domain\": ");
+        }
+
+      append_json_string(out, traits::point_domain_name<point_type>::apply());
+      out.append(", \"object_id\": ");
+      append_json_string(out, trajectory.object_id());
+
+      out.append(", \"point_properties\": {");
+      this->append_point_properties(trajectory, out);
+
+      out.append("}, \"timestamps\": [");
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        if (i > 0)
+          {
+          out.append(", ");
+          }
+        append_json_timestamp(out, trajectory[i].timestamp());
+        }
+
+      out.append("], \"trajectory_properties\": {");
+      bool first = true;
+      for (PropertyMap::const_iterator iter = trajectory.__properties().begin();
+           iter != trajectory.__properties().end(); ++iter)
+        {
+        if (!first)
+          {
+          out.append(", ");
+          }
+        first = false;
+        append_json_string(out, iter->first);
+        out.append(": {\"type\": ");
+        append_json_string(out, property_type_to_json_type_name(json_property_type(iter->second)));
+        out.append(", \"value\": ");
+        append_json_property_value(out, iter->second);
+        out.push_back('}');
+        }
+      out.append(this->GeoJson ? "}}, \"type\": \"Feature\"}" : "}}");
+    }
+
+  /// JSON for one trajectory
+  std::string encode(trajectory_type const& trajectory) const
+    {
+      std::string out;
+      out.reserve(64 + 48 * trajectory.size());
+      this->encode(trajectory, out);
+      return out;
+    }
+
+  /** Write one trajectory as a single line of newline-delimited JSON
+   *
+   * @param [in] out         Stream to write to
+   * @param [in] trajectory  Trajectory to write
+   */
+  void write(std::ostream& out, trajectory_type const& trajectory) const
+    {
+      this->Buffer.clear();
+      this->encode(trajectory, this->Buffer);
+      this->Buffer.push_back('\n');
+      out.write(this->Buffer.data(), static_cast<std::streamsize>(this->Buffer.size()));
+    }
+
+  /** Write many trajectories as newline-delimited JSON
+   *
+   * @param [in] out    Stream to write to
+   * @param [in] begin  First trajectory
+   * @param [in] end    Past the last trajectory
+   */
+  template<typename IteratorT>
+  void write(std::ostream& out, IteratorT begin, IteratorT end) const
+    {
+      for (; begin != end; ++begin)
+        {
+        this->write(out, *begin);
+        }
+    }
+
+  /** Write trajectories as a GeoJSON FeatureCollection
+   *
+   * Each trajectory is written as a Feature whether or not GeoJSON
+   * mode is on.
+   */
+  template<typename IteratorT>
+  void write_feature_collection(std::ostream& out, IteratorT begin, IteratorT end) const
+    {
+      TrajectoryJson features(*this);
+      features.set_geojson(true);
+
+      out << "{\"features\": [";
+      for (bool first = true; begin != end; ++begin, first = false)
+        {
+        features.Buffer.clear();
+        if (!first)
+          {
+          features.Buffer.append(", ");
+          }
+        features.encode(*begin, features.Buffer);
+        out.write(features.Buffer.data(), static_cast<std::streamsize>(features.Buffer.size()));
+        }
+      out << "], \"type\": \"FeatureCollection\"}";
+    }
+
+  // ---------------------------------------------------------------
+  // Reading
+
+  /** Decode exactly one trajectory
+   *
+   * @param [in]  data        JSON text
+   * @param [in]  size        Length of the text
+   * @param [out] trajectory  Decoded trajectory
+   * @throws ParseError if the text does not hold exactly one trajectory
+   */
+  void decode(char const* data, std::size_t size, trajectory_type& trajectory) const
+    {
+      std::size_t num_records = rw::detail::parse_json_trajectories(
+        data, data + size,
+        [&trajectory](record_type& record) { from_record(record, trajectory); });
+      if (num_records != 1)
+        {
+        std::ostringstream outbuf;
+        outbuf << "Expected one trajectory in JSON but found " << num_records;
+        throw ParseError(outbuf.str());
+        }
+    }
+
+  trajectory_type decode(std::string const& text) const
+    {
+      trajectory_type trajectory;
+      this->decode(text.data(), text.size(), trajectory);
+      return trajectory;
+    }
+
+  /** Decode every trajectory in a buffer
+   *
+   * The buffer may hold a single trajectory, an array of them, a
+   * GeoJSON FeatureCollection or newline-delimited JSON.
+   */
+  std::vector<trajectory_type> decode_collection(char const* data, std::size_t size) const
+    {
+      std::vector<trajectory_type> trajectories;
+      rw::detail::parse_json_trajectories(
+        data, data + size,
+        [&trajectories](record_type& record) {
+          trajectories.push_back(trajectory_type());
+          from_record(record, trajectories.back());
+        });
+      return trajectories;
+    }
+
+  std::vector<trajectory_type> decode_collection(std::string const& text) const
+    {
+      return this->decode_collection(text.data(), text.size());
+    }
+
+  /** Read the next trajectory from newline-delimited JSON
+   *
+   * Blank lines are skipped.
+   *
+   * @param [in]  in          Stream to read from
+   * @param [out] trajectory  Trajectory that was read
+   * @return False at end of input
+   */
+  bool read(std::istream& in, trajectory_type& trajectory) const
+    {
+      while (std::getline(in, this->Buffer))
+        {
+        if (this->Buffer.find_first_not_of(" \t\r") != std::string::npos)
+          {
+          this->decode(this->Buffer.data(), this->Buffer.size(), trajectory);
+          return true;
+          }
+        }
+      return false;
+    }
+
+  /** Build a trajectory from a parsed record
+   *
+   * This is the second half of decode() for callers that parse
+   * records themselves, for example to pick a domain by looking at
+   * the record first.
+   */
+  static void from_record(record_type const& record, trajectory_type& trajectory)
+    {
+      using namespace rw::detail;
+
+      std::string domain_name(traits::point_domain_name<point_type>::apply());
+      if (!record.Domain.empty() && record.Domain != domain_name)
+        {
+        throw ParseError("Error: trajectory is in domain " + record.Domain
+                         + " but we are reading into domain " + domain_name);
+        }
+      if (!record.ObjectIdIsString)
+        {
+        throw ParseError("Error: object_id must be a string");
+        }
+
+      std::size_t dimension = traits::dimension<point_type>::value;
+      std::size_t num_points = record.PointDimensions.size();
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        if (record.PointDimensions[i] != dimension)
+          {
+          std::ostringstream outbuf;
+          outbuf << "Error: point " << i << " has " << record.PointDimensions[i]
+                 << " coordinate(s), expected " << dimension << ".";
+          throw ParseError(outbuf.str());
+          }
+        }
+
+      for (std::map<std::string, JsonPropertyColumn>::const_iterator iter = record.PointProperties.begin();
+           iter != record.PointProperties.end(); ++iter)
+        {
+        if (iter->second.Values.size() != num_points)
+          {
+          std::ostringstream outbuf;
+          outbuf << "Error: property " << iter->first << " has only " << iter->second.Values.size()
+                 << " values but there are " << num_points << " points in the trajectory.";
+          throw ParseError(outbuf.str());
+          }
+        }
+
+      if (record.Timestamps.size() != num_points)
+        {
+        std::ostringstream outbuf;
+        outbuf << "Error: JSON contains only " << record.Timestamps.size()
+               << " timestamps but there are " << num_points << " points in the trajectory.";
+        throw ParseError(outbuf.str());
+        }
+
+      std::vector<point_type> points(num_points);
+      std::vector<double>::const_iterator coordinate = record.Coordinates.begin();
+      for (std::size_t i = 0; i < num_points; ++i)
+        {
+        point_type& point = points[i];
+        for (std::size_t d = 0; d < dimension; ++d, ++coordinate)
+          {
+          point[d] = *coordinate;
+          }
+        point.set_object_id(record.ObjectId);
+        point.set_timestamp(record.Timestamps[i]);
+        }
+
+      for (std::map<std::string, JsonPropertyColumn>::const_iterator iter = record.PointProperties.begin();
+           iter != record.PointProperties.end(); ++iter)
+        {
+        PropertyUnderlyingType type = json_type_name_to_property_type(iter->second.TypeName);
+        for (std::size_t i = 0; i < num_points; ++i)
+          {
+          points[i].set_property(iter->first, json_scalar_to_property(iter->first, iter->second.Values[i], type));
+          }
+        }
+
+      trajectory = trajectory_type(points.begin(), points.end());
+
+      for (std::map<std::string, JsonPropertyColumn>::const_iterator iter = record.TrajectoryProperties.begin();
+           iter != record.TrajectoryProperties.end(); ++iter)
+        {
+        if (iter->second.Values.empty())
+          {
+          continue;
+          }
+        PropertyUnderlyingType type = json_type_name_to_property_type(iter->second.TypeName);
+        trajectory.set_property(iter->first, json_scalar_to_property(iter->first, iter->second.Values[0], type));
+        }
+    }
+
+private:
+  void append_coordinates(trajectory_type const& trajectory, std::string& out) const
+    {
+      std::size_t dimension = traits::dimension<point_type>::value;
+      out.push_back('[');
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        out.append(i > 0 ? ", [" : "[");
+        for (std::size_t d = 0; d < dimension; ++d)
+          {
+          if (d > 0)
+            {
+            out.append(", ");
+            }
+          rw::detail::append_json_number(out, trajectory[i][d]);
+          }
+        out.push_back(']');
+        }
+      out.push_back(']');
+    }
+
+  void append_point_properties(trajectory_type const& trajectory, std::string& out) const
+    {
+      using namespace rw::detail;
+
+      // Properties hoisted into a shared block are written with every
+      // point just like the point's own properties.
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        if (trajectory[i].shared_properties())
+          {
+          trajectory_type flat(trajectory);
+          for (std::size_t j = 0; j < flat.size(); ++j)
+            {
+            flat[j].unshare_properties();
+            }
+          this->append_point_properties(flat, out);
+          return;
+          }
+        }
+
+      // The type of a column comes from its first non-null value
+      std::map<std::string, PropertyUnderlyingType> columns;
+      for (std::size_t i = 0; i < trajectory.size(); ++i)
+        {
+        PropertyMap const& properties = trajectory[i].__properties();
+        for (PropertyMap::const_iterator iter = properties.begin(); iter != properties.end(); ++iter)
+          {
+          PropertyUnderlyingType type = json_property_type(iter->second);
+          std::map<std::string, PropertyUnderlyingType>::iterator column = columns.find(iter->first);
+          if (column == columns.end())
+            {
+            columns[iter->first] = type;
+            }
+          else if (column->second == TYPE_UNKNOWN || column->second == TYPE_NULL)
+            {
+            column->second = type;
+            }
+          }
+        }
+
+      bool first = true;
+      for (std::map<std::string, PropertyUnderlyingType>::const_iterator column = columns.begin();
+           column != columns.end(); ++column)
+        {
+        if (!first)
+          {
+          out.append(", ");
+          }
+        first = false;
+        append_json_string(out, column->first);
+        out.append(": {\"type\": ");
+        append_json_string(out, property_type_to_json_type_name(column->second));
+        out.append(", \"values\": [");
+        for (std::size_t i = 0; i < trajectory.size(); ++i)
+          {
+          if (i > 0)
+            {
+            out.append(", ");
+            }
+          PropertyMap const& properties = trajectory[i].__properties();
+          PropertyMap::const_iterator value = properties.find(column->first);
+          if (value == properties.end())
+            {
+            out.append("null");
+            }
+          else
+            {
+            append_json_property_value(out, value->second);
+            }
+          }
+        out.append("]}");
+        }
+    }
+
+  bool GeoJson;
+  mutable std::string Buffer;
+};
+
+} // namespace tracktable
+
+#endif
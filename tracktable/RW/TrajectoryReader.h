@@ -32,22 +32,23 @@
 #define __tracktable_TrajectoryReader_h
 
 #include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/MemoryResource.h>
+#include <tracktable/Core/ParallelFor.h>
 
 #include <tracktable/RW/GenericReader.h>
 #include <tracktable/RW/LineReader.h>
 #include <tracktable/RW/SkipCommentsReader.h>
-#include <tracktable/RW/StringTokenizingReader.h>
-#include <tracktable/RW/PointFromTokensReader.h>
 
-#include <tracktable/RW/detail/TrajectoryHeader.h>
-#include <tracktable/RW/detail/PointHeader.h>
+#include <tracktable/RW/detail/TrajectoryRecordParser.h>
 
 #include <iterator>
 #include <iostream>
 #include <istream>
+#include <memory>
 #include <string>
 #include <cassert>
 #include <stdexcept>
+#include <vector>
 
 #include <boost/shared_ptr.hpp>
 
@@ -61,11 +62,15 @@ namespace tracktable {
  *
  * - Skip any lines that begin with a designated comment character ('#' by default)
  *
- * - Tokenize each line using specified delimiters (whitespace by default)
+ * - Tokenize each line using specified delimiters (comma by default)
  *
  * - Create a trajectory (user-specified type) from each tokenized line
  *
- * - Return the resulting points via a C++ iterator
+ * - Return the resulting trajectories via a C++ iterator
+ *
+ * The last three steps are done by rw::detail::TrajectoryRecordParser,
+ * which reads each record straight into a presized trajectory.
+ * read_all() parses many records at once on several threads.
  *
  * You will use set_input() to supply an input stream,
  * set_comment_character() to configure which lines to skip,
@@ -80,7 +85,7 @@ private:
   typedef typename trajectory_type::point_type point_type;
   typedef tracktable::LineReader<> line_reader_type;
   typedef tracktable::SkipCommentsReader<line_reader_type::iterator> skip_comments_reader_type;
-  typedef tracktable::StringTokenizingReader<skip_comments_reader_type::iterator> string_tokenizer_type;
+  typedef rw::detail::TrajectoryRecordParser<trajectory_type> record_parser_type;
 
 public:
   /** Instantiate TrajectoryReader using a default configuration
@@ -110,11 +115,8 @@ public:
    */
   TrajectoryReader(TrajectoryReader const& other)
     : LineReader(other.LineReader)
-    , PointReader(other.PointReader)
     , SkipCommentsReader(other.SkipCommentsReader)
-    , StringTokenizer(other.StringTokenizer)
-    , TimestampFormat(other.TimestampFormat)
-    , WarningsEnabled(other.WarningsEnabled)
+    , RecordParser(other.RecordParser)
     , TrajectoriesRead(other.TrajectoriesRead)
     {
     }
@@ -132,11 +134,8 @@ public:
   TrajectoryReader& operator=(TrajectoryReader const& other)
     {
       this->LineReader         = other.LineReader;
-      this->PointReader        = other.PointReader;
       this->SkipCommentsReader = other.SkipCommentsReader;
-      this->StringTokenizer    = other.StringTokenizer;
-      this->TimestampFormat    = other.TimestampFormat;
-      this->WarningsEnabled    = other.WarningsEnabled;
+      this->RecordParser       = other.RecordParser;
       this->TrajectoriesRead   = other.TrajectoriesRead;
       return *this;
     }
@@ -153,9 +152,7 @@ public:
       return (
         this->LineReader            == other.LineReader
         && this->SkipCommentsReader == other.SkipCommentsReader
-        && this->StringTokenizer    == other.StringTokenizer
-	&& this->TimestampFormat    == other.TimestampFormat
-        && this->WarningsEnabled    == other.WarningsEnabled
+        && this->RecordParser       == other.RecordParser
         && this->TrajectoriesRead   == other.TrajectoriesRead
         );
     }
@@ -191,7 +188,6 @@ public:
       this->set_comment_character("#");
       this->set_warnings_enabled(true);
       this->set_timestamp_format("%Y-%m-%d %H:%M:%S");
-      this->PointReader.set_point_count_log_enabled(false);
     }
 
 
@@ -221,14 +217,91 @@ public:
       return this->SkipCommentsReader.comment_character();
     }
 
+  /** Only populate the named point properties
+   *
+   * Columns for any other property are skipped without being
+   * converted.  See PointFromTokensReader::set_required_properties().
+   *
+   * @param [in] names  Properties to read
+   */
+  void set_required_properties(std::vector<string_type> const& names)
+    {
+      this->RecordParser.set_required_properties(names);
+    }
+
+  /** Add one property to the set that will be populated
+   *
+   * @param [in] name  Property to read
+   */
+  void add_required_property(string_type const& name)
+    {
+      this->RecordParser.add_required_property(name);
+    }
+
+  /// Go back to populating every point property
+  void clear_required_properties()
+    {
+      this->RecordParser.clear_required_properties();
+    }
+
+  /** Properties the reader is restricted to
+   *
+   * @return Required property names, or an empty list if every property is read
+   */
+  std::vector<string_type> required_properties() const
+    {
+      return this->RecordParser.required_properties();
+    }
+
+  /** Defer conversion of point properties until they are used
+   *
+   * See PointFromTokensReader::set_lazy_properties().
+   *
+   * @param [in] onoff  Lazy mode on / off
+   */
+  void set_lazy_properties(bool onoff)
+    {
+      this->RecordParser.set_lazy_properties(onoff);
+    }
+
+  /** Check whether property conversion is deferred
+   *
+   * @return Whether or not lazy mode is on
+   */
+  bool lazy_properties() const
+    {
+      return this->RecordParser.lazy_properties();
+    }
+
+  /** Share point properties that are the same on every point
+   *
+   * When this is on, each trajectory keeps one copy of the point
+   * properties that never change along it.  See
+   * Trajectory::hoist_constant_properties().
+   *
+   * @param [in] onoff  Hoisting on / off
+   */
+  void set_hoist_constant_properties(bool onoff)
+    {
+      this->RecordParser.set_hoist_constant_properties(onoff);
+    }
+
+  /** Check whether constant point properties are hoisted
+   *
+   * @return Whether or not hoisting is on
+   */
+  bool hoist_constant_properties() const
+    {
+      return this->RecordParser.hoist_constant_properties();
+    }
+
   /** Specify string value to be interpreted as null
    *
    * @param [in] _null_value String to interpret as null
    */
   void set_null_value(string_type const& _null_value)
     {
-      this->ParseTrajectoryHeader.set_null_value(_null_value);
-      this->PointReader.set_null_value(_null_value);
+      this->RecordParser.set_null_value(_null_value);
     }
 
   /** Get string value for nulls
@@ -238,7 +311,7 @@ public:
 
   string_type null_value() const
     {
-      return this->PointReader.null_value();
+      return this->RecordParser.null_value();
     }
 
   /** Supply input stream from delimited text source.
@@ -253,12 +326,8 @@ public:
       this->LineReader.set_input(_input);
       this->SkipCommentsReader.set_input_range(this->LineReader.begin(),
                                                this->LineReader.end());
-      this->StringTokenizer.set_input_range(this->SkipCommentsReader.begin(),
-                                            this->SkipCommentsReader.end());
-      this->TokenizedInputBegin = this->StringTokenizer.begin();
-      this->TokenizedInputEnd   = this->StringTokenizer.end();
-
-      this->ParseTrajectoryHeader.set_timestamp_input_format(this->TimestampFormat);
+      this->InputLinesBegin = this->SkipCommentsReader.begin();
+      this->InputLinesEnd   = this->SkipCommentsReader.end();
       this->TrajectoriesRead = 0;
     }
 
@@ -285,7 +354,7 @@ public:
 
   void set_warnings_enabled(bool onoff)
     {
-      this->WarningsEnabled = onoff;
+      this->RecordParser.set_warnings_enabled(onoff);
     }
 
   /** Check whether warnings are enable
@@ -295,7 +364,7 @@ public:
 
   bool warnings_enabled() const
     {
-      return this->WarningsEnabled;
+      return this->RecordParser.warnings_enabled();
     }
 
   /** Set one or more characters as field delimiters.
@@ -312,7 +381,7 @@ public:
 
   void set_field_delimiter(string_type const& delimiters)
     {
-      this->StringTokenizer.set_field_delimiter(delimiters);
+      this->RecordParser.set_field_delimiter(delimiters);
     }
 
   /** Retrieve the current set of delimiter characters.
@@ -321,7 +390,7 @@ public:
    */
   string_type field_delimiter() const
     {
-      return this->StringTokenizer.field_delimiter();
+      return this->RecordParser.field_delimiter();
     }
 
   /** Set the format of the timestamp
@@ -330,8 +399,7 @@ public:
    */
   void set_timestamp_format(string_type const& format)
   {
-    this->TimestampFormat = format;
-    this->PointReader.set_timestamp_format(this->TimestampFormat);
+    this->RecordParser.set_timestamp_format(format);
   }
 
   /** Retrieve the format of the timestamp
@@ -340,26 +408,103 @@ public:
    */
   string_type timestamp_format() const
   {
-    return this->TimestampFormat;
+    return this->RecordParser.timestamp_format();
   }
 
+  /** Read every remaining trajectory, parsing records in parallel
+   *
+   * Lines are read in batches of `batch_size`.  The records in each
+   * batch are parsed on `num_threads` threads and then written to
+   * `output` in file order.  Records that fail to parse are skipped
+   * exactly as they are during ordinary iteration.
+   *
+   * This consumes the input.  Any outstanding iterators are left at
+   * the end of the stream.
+   *
+   * If you supply `arenas`, each worker builds its trajectories,
+   * points and property maps in its own arena instead of on the
+   * shared heap.  The trajectories written to `output` are moved, not
+   * copied, so they may still use those arenas: keep `arenas` alive and do
+   * not release it until you are done with them.
+   *
+   * @param [out] output      Output iterator that accepts trajectory_type
+   * @param [in]  num_threads Number of parsing threads; 0 means default_thread_count()
+   * @param [in]  batch_size  Number of lines read between parallel passes
+   * @param [in]  arenas      Optional per-worker arenas, at least `num_threads` of them
+   * @return Number of trajectories written to `output`
+   */
+  template<typename OutputIteratorT>
+  std::size_t read_all(OutputIteratorT output,
+                       std::size_t num_threads=0,
+                       std::size_t batch_size=1024,
+                       ArenaSet* arenas=nullptr)
+    {
+      if (num_threads == 0)
+        {
+        num_threads = default_thread_count();
+        }
+      if (batch_size == 0)
+        {
+        batch_size = 1;
+        }
+      if (arenas && arenas->size() < num_threads)
+        {
+        throw std::invalid_argument("read_all: fewer arenas than threads");
+        }
+
+      std::vector<record_parser_type> parsers(num_threads, this->RecordParser);
+      std::vector<string_type> lines;
+      std::vector<std::unique_ptr<trajectory_type> > trajectories;
+      std::vector<char> parsed;
+      std::size_t num_written = 0;
+
+      while (this->InputLinesBegin != this->InputLinesEnd)
+        {
+        lines.clear();
+        for (; lines.size() < batch_size && this->InputLinesBegin != this->InputLinesEnd;
+             ++this->InputLinesBegin)
+          {
+          lines.push_back(*this->InputLinesBegin);
+          }
+
+        // Each trajectory is created on the worker that parses it so
+        // that its storage comes from that worker's arena.
+        trajectories.clear();
+        trajectories.resize(lines.size());
+        parsed.assign(lines.size(), 0);
+        parallel_for_with_worker(
+          0, lines.size(),
+          [&](std::size_t i, std::size_t worker) {
+            ScopedMemoryResource use_arena(arenas ? arenas->arena(worker) : nullptr);
+            trajectories[i].reset(new trajectory_type(false));
+            parsed[i] = parsers[worker].parse_record(lines[i], *trajectories[i]);
+          },
+          num_threads, 8);
+
+        for (std::size_t i = 0; i < lines.size(); ++i)
+          {
+          if (parsed[i])
+            {
+            *output = std::move(*trajectories[i]);
+            ++output;
+            ++num_written;
+            }
+          }
+        }
+
+      this->TrajectoriesRead += static_cast<int>(num_written);
+      return num_written;
+    }
+
 private:
   typedef boost::shared_ptr<trajectory_type> trajectory_shared_ptr_type;
-  typedef string_vector_type::const_iterator token_iter_type;
-  typedef std::pair<token_iter_type, token_iter_type> token_range_type;
-  typedef std::vector<token_range_type> token_range_vector_type;
-  typedef PointFromTokensReader<point_type, token_range_vector_type::iterator> point_reader_type;
 
   line_reader_type LineReader;
-  point_reader_type PointReader;
   skip_comments_reader_type SkipCommentsReader;
-  string_tokenizer_type StringTokenizer;
-  string_type TimestampFormat;
-  string_tokenizer_type::iterator TokenizedInputBegin;
-  string_tokenizer_type::iterator TokenizedInputEnd;
-  bool WarningsEnabled;
+  record_parser_type RecordParser;
+  skip_comments_reader_type::iterator InputLinesBegin;
+  skip_comments_reader_type::iterator InputLinesEnd;
   int TrajectoriesRead;
-  rw::detail::TrajectoryHeader ParseTrajectoryHeader;
 
   /** Increment the iterator the next item to be read in
    *
@@ -367,24 +512,23 @@ private:
    */
   trajectory_shared_ptr_type next_item()
     {
-      while (this->TokenizedInputBegin != this->TokenizedInputEnd)
+      trajectory_shared_ptr_type NextTrajectory;
+      while (this->InputLinesBegin != this->InputLinesEnd)
         {
-        string_vector_type tokens((*this->TokenizedInputBegin).first,
-                                  (*this->TokenizedInputBegin).second);
-
-        if (tokens[0] == rw::detail::TrajectoryFileMagicString)
+        if (!NextTrajectory)
           {
-          trajectory_shared_ptr_type NextTrajectory =
-            this->parse_trajectory(tokens);
+          // We won't spend time generating a uuid: the record has one
+          NextTrajectory.reset(new trajectory_type(false));
+          }
 
-          if (NextTrajectory)
-            {
-            ++ this->TokenizedInputBegin;
-            ++ this->TrajectoriesRead;
-            return NextTrajectory;
-            }
+        bool parsed = this->RecordParser.parse_record(*this->InputLinesBegin,
+                                                      *NextTrajectory);
+        ++ this->InputLinesBegin;
+        if (parsed)
+          {
+          ++ this->TrajectoriesRead;
+          return NextTrajectory;
           }
-        ++ this->TokenizedInputBegin;
         }
 
 
@@ -403,158 +547,6 @@ private:
 
       return trajectory_shared_ptr_type();
     }
-
-  /** Parse the read in trajectory
-   *
-   * @param tokens Tokens that are read in and parsed
-   */
-  trajectory_shared_ptr_type
-  parse_trajectory(string_vector_type const& tokens)
-    {
-      try
-        {
-        // Create a new trajectory object, but we won't spend time generating a uuid
-        trajectory_shared_ptr_type trajectory(new trajectory_type(false));
-
-        // rw::detail::TrajectoryHeader header(this->PropertyReadWrite);
-        this->ParseTrajectoryHeader.set_timestamp_input_format(this->TimestampFormat);
-
-        std::size_t tokens_consumed_by_header = this->ParseTrajectoryHeader.read_from_tokens(tokens.begin(), tokens.end());
-        trajectory->set_uuid(this->ParseTrajectoryHeader.UUID);
-        trajectory->__set_properties(this->ParseTrajectoryHeader.Properties);
-
-        string_vector_type::const_iterator points_begin = tokens.begin();
-        string_vector_type::const_iterator points_end = tokens.end();
-
-        // Advance past all the things in the header
-        std::advance(points_begin, tokens_consumed_by_header+1);
-
-        this->populate_trajectory_points(points_begin, points_end,
-                                         this->ParseTrajectoryHeader.NumPoints,
-                                         trajectory);
-        assert(trajectory != 0);
-        if (trajectory->size() == 0)
-          {
-          return trajectory_shared_ptr_type();
-          }
-        return trajectory;
-        }
-      catch (std::exception& e)
-        {
-          TRACKTABLE_LOG(log::warning)
-           << "Error parsing trajectory: " << e.what();
-           return trajectory_shared_ptr_type();
-        }
-    }
-
-  // ----------------------------------------------------------------------
-
-  /** Populate the trajectorie's points
-   *
-   * @param [in] token_begin Start of tokens read in
-   * @param [in] token_end End of tokens read in
-   * @param [in] num_points Num of points expected to be in trajectory
-   * @param [in] trajectory Trajectory to populate
-   */
-  void populate_trajectory_points(token_iter_type token_begin,
-                                  token_iter_type token_end,
-                                  std::size_t num_points,
-                                  trajectory_shared_ptr_type trajectory)
-    {
-      // We already have the parsed tokens so we can skip the first
-      // several stages of the point reader. However, the token
-      // reader expects its input one line at a time. In order to
-      // separate those out we need to read the point header.
-      rw::detail::PointHeader header;
-      header.read_from_tokens(token_begin, token_end);
-
-      TRACKTABLE_LOG(log::trace)
-        << "DEBUG: Point header says that we have "
-        << header.PropertyNames.size() << " properties per point";
-
-      typedef std::pair<token_iter_type, token_iter_type> token_range_type;
-      typedef std::vector<token_range_type> token_range_vector_type;
-
-      token_range_vector_type token_ranges;
-
-      // First token range is the header
-      token_iter_type header_end_token = token_begin;
-      std::advance(header_end_token,
-                   6 + 2 * header.PropertyNames.size());
-      token_range_type header_tokens(token_begin, header_end_token);
-      token_ranges.push_back(header_tokens);
-
-      token_iter_type point_range_begin = header_end_token;
-      std::size_t num_tokens_in_point_record = header.Dimension
-        + header.HasObjectId
-        + header.HasTimestamp
-        + header.PropertyNames.size();
-
-      while (point_range_begin != token_end)
-        {
-        token_iter_type point_range_end = point_range_begin;
-        auto d = std::distance(point_range_end, token_end);
-        assert(d>=0);//TODO: consider a nother warning in the event of too many tokens?
-        if (static_cast<std::make_unsigned<decltype(d)>::type>(std::abs(d)) < num_tokens_in_point_record)
-          {
-          TRACKTABLE_LOG(log::warning)
-             << "Trajectory reader fell off the end of tokens for points. "
-             << "There is probably a missing property value in one of the point records.\n";
-          std::ostringstream outbuf;
-          outbuf << "Trajectory tokens: ";
-          for (; point_range_begin != token_end; ++point_range_begin)
-            {
-            outbuf << *point_range_begin << " ||| ";
-            }
-          TRACKTABLE_LOG(log::debug) << outbuf.str();
-          trajectory->clear();
-          return;
-          }
-
-        std::advance(point_range_end, num_tokens_in_point_record);
-        token_range_type line_range(point_range_begin, point_range_end);
-        token_ranges.push_back(line_range);
-        point_range_begin = point_range_end;
-        }
-
-      this->populate_trajectory_points_from_token_ranges(token_ranges.begin(),
-                                                         token_ranges.end(),
-                                                         trajectory);
-      if (trajectory != 0 && trajectory->size() != num_points)
-        {
-        TRACKTABLE_LOG(log::error)
-                  << "Trajectory reader tried to populate a new trajectory from tokens but got "
-                  << trajectory->size()
-                  << " points. We were expecting "
-                  << num_points << ".\n";
-        }
-    }
-
-  // ----------------------------------------------------------------------
-
-  /** Populate the trajectories points from token ranges
-   *
-   * @param [in] input_range_begin Start of range to read in
-   * @param [in] input_range_end End of range to read in
-   * @param [in] trajectory Trajectory to populate
-   */
-  void populate_trajectory_points_from_token_ranges(
-    token_range_vector_type::iterator input_range_begin,
-    token_range_vector_type::iterator input_range_end,
-    trajectory_shared_ptr_type trajectory
-    )
-    {
-      this->PointReader.set_input_range(input_range_begin,
-                                        input_range_end);
-      trajectory->assign(this->PointReader.begin(), this->PointReader.end());
-      TRACKTABLE_LOG(log::trace)
-                << "populate_trajectory_points: Trajectory now contains "
-                << trajectory->size() << " points\n";
-    }
-
-
-
-
 };
 
 } // close namespace tracktable
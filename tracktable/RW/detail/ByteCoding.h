@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Low-level building blocks for TrajectoryCodec: LEB128 variable
+// length integers, zigzag mapping for signed values and a bit stream
+// that implements the XOR compression of floating-point values
+// described in Pelkonen et al., "Gorilla: A Fast, Scalable,
+// In-Memory Time Series Database" (VLDB 2015).
+
+#ifndef __tracktable_rw_ByteCoding_h
+#define __tracktable_rw_ByteCoding_h
+
+#include <tracktable/RW/ParseExceptions.h>
+
+#include <boost/core/bit.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace tracktable { namespace rw { namespace detail {
+
+typedef std::vector<std::uint8_t> byte_buffer_type;
+
+inline std::uint64_t zigzag_encode(std::int64_t value)
+{
+  return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+}
+
+inline std::int64_t zigzag_decode(std::uint64_t value)
+{
+  return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+}
+
+inline std::uint64_t double_to_bits(double value)
+{
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline double bits_to_double(std::uint64_t bits)
+{
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// ----------------------------------------------------------------------
+
+/** Append-only byte sink
+ *
+ * All multi-byte fixed-width values are little-endian regardless of
+ * the host byte order.
+ */
+class ByteWriter
+{
+public:
+  ByteWriter(byte_buffer_type& buffer)
+    : Buffer(buffer)
+    { }
+
+  void put_byte(std::uint8_t value)
+    {
+      this->Buffer.push_back(value);
+    }
+
+  void put_varint(std::uint64_t value)
+    {
+      while (value >= 0x80)
+        {
+        this->Buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+        }
+      this->Buffer.push_back(static_cast<std::uint8_t>(value));
+    }
+
+  void put_signed(std::int64_t value)
+    {
+      this->put_varint(zigzag_encode(value));
+    }
+
+  void put_fixed64(std::uint64_t value)
+    {
+      for (int i = 0; i < 8; ++i)
+        {
+        this->Buffer.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+        }
+    }
+
+  void put_double(double value)
+    {
+      this->put_fixed64(double_to_bits(value));
+    }
+
+  void put_bytes(std::uint8_t const* data, std::size_t size)
+    {
+      this->Buffer.insert(this->Buffer.end(), data, data + size);
+    }
+
+  void put_string(std::string const& value)
+    {
+      this->put_varint(value.size());
+      this->put_bytes(reinterpret_cast<std::uint8_t const*>(value.data()), value.size());
+    }
+
+  std::size_t size() const
+    {
+      return this->Buffer.size();
+    }
+
+  byte_buffer_type& buffer()
+    {
+      return this->Buffer;
+    }
+
+private:
+  byte_buffer_type& Buffer;
+};
+
+// ----------------------------------------------------------------------
+
+/** Bounds-checked byte source
+ *
+ * Reading past the end of the buffer throws ParseError instead of
+ * running off into memory we do not own.
+ */
+class ByteReader
+{
+public:
+  ByteReader(std::uint8_t const* data, std::size_t size)
+    : Current(data)
+    , End(data + size)
+    { }
+
+  std::uint8_t get_byte()
+    {
+      this->require(1);
+      return *this->Current++;
+    }
+
+  std::uint64_t get_varint()
+    {
+      std::uint64_t result = 0;
+      for (int shift = 0; shift < 64; shift += 7)
+        {
+        std::uint8_t byte = this->get_byte();
+        result |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+          {
+          return result;
+          }
+        }
+      throw ParseError("TrajectoryCodec: malformed variable-length integer");
+    }
+
+  std::int64_t get_signed()
+    {
+      return zigzag_decode(this->get_varint());
+    }
+
+  std::uint64_t get_fixed64()
+    {
+      this->require(8);
+      std::uint64_t result = 0;
+      for (int i = 0; i < 8; ++i)
+        {
+        result |= static_cast<std::uint64_t>(this->Current[i]) << (8 * i);
+        }
+      this->Current += 8;
+      return result;
+    }
+
+  double get_double()
+    {
+      return bits_to_double(this->get_fixed64());
+    }
+
+  std::uint8_t const* get_bytes(std::size_t size)
+    {
+      this->require(size);
+      std::uint8_t const* result = this->Current;
+      this->Current += size;
+      return result;
+    }
+
+  std::string get_string()
+    {
+      std::size_t size = static_cast<std::size_t>(this->get_varint());
+      std::uint8_t const* data = this->get_bytes(size);
+      return std::string(reinterpret_cast<char const*>(data), size);
+    }
+
+  std::uint8_t const* position() const
+    {
+      return this->Current;
+    }
+
+  std::size_t remaining() const
+    {
+      return static_cast<std::size_t>(this->End - this->Current);
+    }
+
+private:
+  void require(std::size_t size) const
+    {
+      if (this->remaining() < size)
+        {
+        throw ParseError("TrajectoryCodec: unexpected end of encoded data");
+        }
+    }
+
+  std::uint8_t const* Current;
+  std::uint8_t const* End;
+};
+
+// ----------------------------------------------------------------------
+
+/** XOR compression for a column of doubles
+ *
+ * Each value is XORed with its predecessor.  Identical values cost a
+ * single bit; values that share sign, exponent and high mantissa bits
+ * with their predecessor cost only their differing middle bits.  The
+ * column is padded to a whole number of bytes when finished.
+ */
+class XorEncoder
+{
+public:
+  XorEncoder(ByteWriter& writer)
+    : Writer(writer)
+    , Previous(0)
+    , PreviousLeading(0xff)
+    , PreviousTrailing(0)
+    , Accumulator(0)
+    , BitCount(0)
+    , First(true)
+    { }
+
+  ~XorEncoder()
+    {
+      this->flush();
+    }
+
+  void put(double value)
+    {
+      std::uint64_t bits = double_to_bits(value);
+      if (this->First)
+        {
+        this->put_bits(bits, 64);
+        this->First = false;
+        }
+      else
+        {
+        std::uint64_t delta = bits ^ this->Previous;
+        if (delta == 0)
+          {
+          this->put_bits(0, 1);
+          }
+        else
+          {
+          int leading = boost::core::countl_zero(delta);
+          int trailing = boost::core::countr_zero(delta);
+          if (leading > 31)
+            {
+            leading = 31;
+            }
+          if (this->PreviousLeading != 0xff
+              && leading >= this->PreviousLeading
+              && trailing >= this->PreviousTrailing)
+            {
+            int width = 64 - this->PreviousLeading - this->PreviousTrailing;
+            this->put_bits(2, 2);
+            this->put_bits(delta >> this->PreviousTrailing, width);
+            }
+          else
+            {
+            int width = 64 - leading - trailing;
+            this->put_bits(3, 2);
+            this->put_bits(static_cast<std::uint64_t>(leading), 5);
+            this->put_bits(static_cast<std::uint64_t>(width - 1), 6);
+            this->put_bits(delta >> trailing, width);
+            this->PreviousLeading = leading;
+            this->PreviousTrailing = trailing;
+            }
+          }
+        }
+      this->Previous = bits;
+    }
+
+  void flush()
+    {
+      if (this->BitCount > 0)
+        {
+        this->Writer.put_byte(static_cast<std::uint8_t>(this->Accumulator << (8 - this->BitCount)));
+        this->Accumulator = 0;
+        this->BitCount = 0;
+        }
+    }
+
+private:
+  void put_bits(std::uint64_t value, int width)
+    {
+      // Emit whole bytes as soon as they are complete so that the
+      // accumulator never needs more than 8 + 7 bits of state
+      while (width > 0)
+        {
+        int take = (width > 8 - this->BitCount) ? 8 - this->BitCount : width;
+        width -= take;
+        std::uint64_t chunk = (value >> width) & ((std::uint64_t(1) << take) - 1);
+        this->Accumulator = (this->Accumulator << take) | static_cast<unsigned>(chunk);
+        this->BitCount += take;
+        if (this->BitCount == 8)
+          {
+          this->Writer.put_byte(static_cast<std::uint8_t>(this->Accumulator));
+          this->Accumulator = 0;
+          this->BitCount = 0;
+          }
+        }
+    }
+
+  ByteWriter& Writer;
+  std::uint64_t Previous;
+  int PreviousLeading;
+  int PreviousTrailing;
+  unsigned Accumulator;
+  int BitCount;
+  bool First;
+};
+
+// ----------------------------------------------------------------------
+
+class XorDecoder
+{
+public:
+  XorDecoder(ByteReader& reader)
+    : Reader(reader)
+    , Previous(0)
+    , PreviousLeading(0)
+    , PreviousTrailing(0)
+    , Accumulator(0)
+    , BitCount(0)
+    , First(true)
+    { }
+
+  double get()
+    {
+      if (this->First)
+        {
+        this->Previous = this->get_bits(64);
+        this->First = false;
+        }
+      else if (this->get_bits(1) != 0)
+        {
+        if (this->get_bits(1) != 0)
+          {
+          this->PreviousLeading = static_cast<int>(this->get_bits(5));
+          int width = static_cast<int>(this->get_bits(6)) + 1;
+          this->PreviousTrailing = 64 - this->PreviousLeading - width;
+          if (this->PreviousTrailing < 0)
+            {
+            throw ParseError("TrajectoryCodec: malformed XOR-compressed value");
+            }
+          }
+        int width = 64 - this->PreviousLeading - this->PreviousTrailing;
+        this->Previous ^= this->get_bits(width) << this->PreviousTrailing;
+        }
+      return bits_to_double(this->Previous);
+    }
+
+private:
+  std::uint64_t get_bits(int width)
+    {
+      std::uint64_t result = 0;
+      while (width > 0)
+        {
+        if (this->BitCount == 0)
+          {
+          this->Accumulator = this->Reader.get_byte();
+          this->BitCount = 8;
+          }
+        int take = (width > this->BitCount) ? this->BitCount : width;
+        this->BitCount -= take;
+        width -= take;
+        result = (result << take) | ((this->Accumulator >> this->BitCount) & ((1u << take) - 1));
+        }
+      return result;
+    }
+
+  ByteReader& Reader;
+  std::uint64_t Previous;
+  int PreviousLeading;
+  int PreviousTrailing;
+  unsigned Accumulator;
+  int BitCount;
+  bool First;
+};
+
+} } } // close namespace tracktable::rw::detail
+
+#endif
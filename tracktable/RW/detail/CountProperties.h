@@ -31,6 +31,8 @@
 #ifndef __tracktable_rw_detail_CountProperties_h
 #define __tracktable_rw_detail_CountProperties_h
 
+#include <tracktable/Core/PropertyMap.h>
+
 namespace tracktable { namespace rw { namespace detail {
 
 template<bool point_has_properties>
@@ -49,7 +51,8 @@ struct count_properties<true>
   template<typename point_type>
   static inline std::size_t apply(point_type const& point)
     {
-      return point.__properties().size();
+      PropertyMap merged;
+      return point.__all_properties(merged).size();
     }
 };
 
@@ -0,0 +1,888 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Low-level JSON building blocks for TrajectoryJson: an event-driven
+// (SAX-style) parser that never builds a document tree, and writers
+// that append strings, numbers and timestamps straight to an output
+// buffer.
+//
+// Numbers are parsed with the exact fast path from Clinger, "How to
+// Read Floating Point Numbers Accurately" (PLDI 1990) and fall back to
+// strtod() only when that path does not apply.  They are written with
+// the fewest significant digits (15, 16 or 17) that read back to the
+// same double.
+
+#ifndef __tracktable_rw_JsonSax_h
+#define __tracktable_rw_JsonSax_h
+
+#include <tracktable/Core/Timestamp.h>
+#include <tracktable/RW/ParseExceptions.h>
+
+#include <clocale>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace tracktable { namespace rw { namespace detail {
+
+// Deeper nesting than this is rejected instead of overflowing the stack
+const std::size_t JSON_MAX_DEPTH = 256;
+
+/** Event-driven JSON parser
+ *
+ * HandlerT must provide these methods:
+ *
+ * @code
+ * void start_object();
+ * void end_object();
+ * void start_array();
+ * void end_array();
+ * void key(std::string const& name);
+ * void string_value(std::string const& value);
+ * void number_value(double value);
+ * void boolean_value(bool value);
+ * void null_value();
+ * @endcode
+ *
+ * Python's json module writes NaN, Infinity and -Infinity for
+ * non-finite numbers, so we accept those too.
+ *
+ * Errors are reported with ParseError.
+ */
+template<typename HandlerT>
+class JsonSaxParser
+{
+public:
+  JsonSaxParser(char const* begin, char const* end, HandlerT& handler)
+    : Begin(begin)
+    , Current(begin)
+    , End(end)
+    , Handler(handler)
+    { }
+
+  /// Parse one complete value.  Returns false if there is only whitespace left.
+  bool parse_value()
+    {
+      this->skip_whitespace();
+      if (this->Current == this->End)
+        {
+        return false;
+        }
+      this->parse_value(0);
+      this->skip_whitespace();
+      return true;
+    }
+
+  /// Everything after the last value parsed
+  char const* position() const
+    {
+      return this->Current;
+    }
+
+private:
+  void parse_value(std::size_t depth)
+    {
+      if (depth > JSON_MAX_DEPTH)
+        {
+        this->fail("values are nested too deeply");
+        }
+      this->skip_whitespace();
+      if (this->Current == this->End)
+        {
+        this->fail("unexpected end of input");
+        }
+
+      switch (*this->Current)
+        {
+        case '{':
+          this->parse_object(depth);
+          break;
+        case '[':
+          this->parse_array(depth);
+          break;
+        case '"':
+          this->parse_string(this->Scratch);
+          this->Handler.string_value(this->Scratch);
+          break;
+        case 't':
+          this->expect_literal("true");
+          this->Handler.boolean_value(true);
+          break;
+        case 'f':
+          this->expect_literal("false");
+          this->Handler.boolean_value(false);
+          break;
+        case 'n':
+          this->expect_literal("null");
+          this->Handler.null_value();
+          break;
+        case 'N':
+          this->expect_literal("NaN");
+          this->Handler.number_value(std::numeric_limits<double>::quiet_NaN());
+          break;
+        case 'I':
+          this->expect_literal("Infinity");
+          this->Handler.number_value(std::numeric_limits<double>::infinity());
+          break;
+        default:
+          this->Handler.number_value(this->parse_number());
+          break;
+        }
+    }
+
+  void parse_object(std::size_t depth)
+    {
+      ++this->Current;
+      this->Handler.start_object();
+      this->skip_whitespace();
+      if (this->peek() == '}')
+        {
+        ++this->Current;
+        this->Handler.end_object();
+        return;
+        }
+
+      while (true)
+        {
+        this->skip_whitespace();
+        if (this->peek() != '"')
+          {
+          this->fail("expected a string as an object key");
+          }
+        this->parse_string(this->Scratch);
+        this->Handler.key(this->Scratch);
+        this->skip_whitespace();
+        this->expect(':');
+        this->parse_value(depth + 1);
+        this->skip_whitespace();
+        char next = this->peek();
+        ++this->Current;
+        if (next == '}')
+          {
+          this->Handler.end_object();
+          return;
+          }
+        else if (next != ',')
+          {
+          --this->Current;
+          this->fail("expected ',' or '}' in object");
+          }
+        }
+    }
+
+  void parse_array(std::size_t depth)
+    {
+      ++this->Current;
+      this->Handler.start_array();
+      this->skip_whitespace();
+      if (this->peek() == ']')
+        {
+        ++this->Current;
+        this->Handler.end_array();
+        return;
+        }
+
+      while (true)
+        {
+        this->parse_value(depth + 1);
+        this->skip_whitespace();
+        char next = this->peek();
+        ++this->Current;
+        if (next == ']')
+          {
+          this->Handler.end_array();
+          return;
+          }
+        else if (next != ',')
+          {
+          --this->Current;
+          this->fail("expected ',' or ']' in array");
+          }
+        }
+    }
+
+  void parse_string(std::string& result)
+    {
+      ++this->Current;
+      result.clear();
+      while (true)
+        {
+        // Copy runs of ordinary characters in one go
+        char const* run_start = this->Current;
+        while (this->Current != this->End
+               && *this->Current != '"' && *this->Current != '\\'
+               && static_cast<unsigned char>(*this->Current) >= 0x20)
+          {
+          ++this->Current;
+          }
+        result.append(run_start, this->Current);
+
+        if (this->Current == this->End)
+          {
+          this->fail("unterminated string");
+          }
+        char c = *this->Current++;
+        if (c == '"')
+          {
+          return;
+          }
+        else if (c != '\\')
+          {
+          --this->Current;
+          this->fail("control character in string");
+          }
+
+        if (this->Current == this->End)
+          {
+          this->fail("unterminated string");
+          }
+        char escape = *this->Current++;
+        switch (escape)
+          {
+          case '"': result.push_back('"'); break;
+          case '\\': result.push_back('\\'); break;
+          case '/': result.push_back('/'); break;
+          case 'b': result.push_back('\b'); break;
+          case 'f': result.push_back('\f'); break;
+          case 'n': result.push_back('\n'); break;
+          case 'r': result.push_back('\r'); break;
+          case 't': result.push_back('\t'); break;
+          case 'u': this->parse_unicode_escape(result); break;
+          default:
+            this->fail("invalid escape sequence in string");
+          }
+        }
+    }
+
+  void parse_unicode_escape(std::string& result)
+    {
+      std::uint32_t code_point = this->parse_hex4();
+      if (code_point >= 0xd800 && code_point <= 0xdbff)
+        {
+        // High surrogate: a low surrogate must follow
+        if (this->End - this->Current < 6 || this->Current[0] != '\\' || this->Current[1] != 'u')
+          {
+          this->fail("unpaired surrogate in \\u escape");
+          }
+        this->Current += 2;
+        std::uint32_t low = this->parse_hex4();
+        if (low < 0xdc00 || low > 0xdfff)
+          {
+          this->fail("unpaired surrogate in \\u escape");
+          }
+        code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+        }
+
+      if (code_point < 0x80)
+        {
+        result.push_back(static_cast<char>(code_point));
+        }
+      else if (code_point < 0x800)
+        {
+        result.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+      else if (code_point < 0x10000)
+        {
+        result.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+      else
+        {
+        result.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+        result.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+        result.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+    }
+
+  std::uint32_t parse_hex4()
+    {
+      if (this->End - this->Current < 4)
+        {
+        this->fail("truncated \\u escape");
+        }
+      std::uint32_t value = 0;
+      for (int i = 0; i < 4; ++i)
+        {
+        char c = *this->Current++;
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<std::uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<std::uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value |= static_cast<std::uint32_t>(c - 'A' + 10);
+        else this->fail("invalid hex digit in \\u escape");
+        }
+      return value;
+    }
+
+  double parse_number()
+    {
+      char const* start = this->Current;
+      bool negative = false;
+      if (this->peek() == '-')
+        {
+        negative = true;
+        ++this->Current;
+        if (this->peek() == 'I')
+          {
+          this->expect_literal("Infinity");
+          return -std::numeric_limits<double>::infinity();
+          }
+        }
+
+      std::uint64_t mantissa = 0;
+      int significant_digits = 0;
+      int exponent = 0;
+
+      if (!is_digit(this->peek()))
+        {
+        this->fail("invalid number");
+        }
+      if (this->peek() == '0')
+        {
+        ++this->Current;
+        }
+      else
+        {
+        while (is_digit(this->peek()))
+          {
+          this->accumulate_digit(mantissa, significant_digits, exponent, false);
+          }
+        }
+
+      if (this->peek() == '.')
+        {
+        ++this->Current;
+        if (!is_digit(this->peek()))
+          {
+          this->fail("invalid number");
+          }
+        while (is_digit(this->peek()))
+          {
+          this->accumulate_digit(mantissa, significant_digits, exponent, true);
+          }
+        }
+
+      if (this->peek() == 'e' || this->peek() == 'E')
+        {
+        ++this->Current;
+        bool negative_exponent = false;
+        if (this->peek() == '+' || this->peek() == '-')
+          {
+          negative_exponent = (*this->Current == '-');
+          ++this->Current;
+          }
+        if (!is_digit(this->peek()))
+          {
+          this->fail("invalid number");
+          }
+        int written_exponent = 0;
+        while (is_digit(this->peek()))
+          {
+          if (written_exponent < 100000)
+            {
+            written_exponent = 10 * written_exponent + (*this->Current - '0');
+            }
+          ++this->Current;
+          }
+        exponent += (negative_exponent ? -written_exponent : written_exponent);
+        }
+
+      // Clinger's fast path: both the mantissa and the power of ten
+      // are exactly representable, so one multiply or divide rounds
+      // correctly.
+      if (significant_digits <= 15 && exponent >= -22 && exponent <= 22)
+        {
+        double value = static_cast<double>(mantissa);
+        if (exponent < 0)
+          {
+          value /= power_of_ten(-exponent);
+          }
+        else
+          {
+          value *= power_of_ten(exponent);
+          }
+        return negative ? -value : value;
+        }
+
+      return this->parse_number_slowly(start);
+    }
+
+  // Mantissa digits past the 19th cannot be held in 64 bits.  They
+  // only matter to the slow path, which reparses the text anyway.
+  void accumulate_digit(std::uint64_t& mantissa, int& significant_digits, int& exponent, bool fraction)
+    {
+      int digit = *this->Current - '0';
+      ++this->Current;
+      if (mantissa == 0 && digit == 0)
+        {
+        // Leading zeros are not significant
+        if (fraction)
+          {
+          --exponent;
+          }
+        return;
+        }
+      if (significant_digits < 19)
+        {
+        mantissa = 10 * mantissa + static_cast<std::uint64_t>(digit);
+        if (fraction)
+          {
+          --exponent;
+          }
+        }
+      else if (!fraction)
+        {
+        ++exponent;
+        }
+      ++significant_digits;
+    }
+
+  // strtod() needs a terminated string and honors the C locale's
+  // decimal point, so we give it a copy with '.' replaced as needed.
+  double parse_number_slowly(char const* start)
+    {
+      std::string text(start, this->Current);
+      char decimal_point = *std::localeconv()->decimal_point;
+      if (decimal_point != '.')
+        {
+        for (std::size_t i = 0; i < text.size(); ++i)
+          {
+          if (text[i] == '.')
+            {
+            text[i] = decimal_point;
+            }
+          }
+        }
+      return std::strtod(text.c_str(), nullptr);
+    }
+
+  static double power_of_ten(int exponent)
+    {
+      static const double powers[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+      };
+      return powers[exponent];
+    }
+
+  static bool is_digit(char c)
+    {
+      return c >= '0' && c <= '9';
+    }
+
+  char peek() const
+    {
+      return (this->Current == this->End) ? '\0' : *this->Current;
+    }
+
+  void skip_whitespace()
+    {
+      while (this->Current != this->End
+             && (*this->Current == ' ' || *this->Current == '\n'
+                 || *this->Current == '\r' || *this->Current == '\t'))
+        {
+        ++this->Current;
+        }
+    }
+
+  void expect(char c)
+    {
+      if (this->peek() != c)
+        {
+        this->fail(std::string("expected '") + c + "'");
+        }
+      ++this->Current;
+    }
+
+  void expect_literal(char const* literal)
+    {
+      std::size_t length = std::strlen(literal);
+      if (static_cast<std::size_t>(this->End - this->Current) < length
+          || std::strncmp(this->Current, literal, length) != 0)
+        {
+        this->fail("invalid literal");
+        }
+      this->Current += length;
+    }
+
+  void fail(std::string const& message) const
+    {
+      std::ostringstream outbuf;
+      outbuf << "JSON parse error at offset " << (this->Current - this->Begin) << ": " << message;
+      throw ParseError(outbuf.str());
+    }
+
+  char const* Begin;
+  char const* Current;
+  char const* End;
+  HandlerT& Handler;
+  std::string Scratch;
+};
+
+// ----------------------------------------------------------------------
+
+inline void append_json_unicode_escape(std::string& out, std::uint32_t code_unit)
+{
+  static const char hex_digits[] = "0123456789abcdef";
+  out.append("\\u");
+  out.push_back(hex_digits[(code_unit >> 12) & 0xf]);
+  out.push_back(hex_digits[(code_unit >> 8) & 0xf]);
+  out.push_back(hex_digits[(code_unit >> 4) & 0xf]);
+  out.push_back(hex_digits[code_unit & 0xf]);
+}
+
+/** Decode one UTF-8 sequence starting at value[i]
+ *
+ * @return Number of bytes in the sequence, or 0 if it is not valid UTF-8
+ */
+inline std::size_t decode_utf8(std::string const& value, std::size_t i, std::uint32_t& code_point)
+{
+  unsigned char lead = static_cast<unsigned char>(value[i]);
+  std::size_t length = 0;
+  std::uint32_t minimum = 0;
+  if (lead >= 0xc2 && lead <= 0xdf)
+    {
+    length = 2;
+    minimum = 0x80;
+    code_point = lead & 0x1f;
+    }
+  else if (lead >= 0xe0 && lead <= 0xef)
+    {
+    length = 3;
+    minimum = 0x800;
+    code_point = lead & 0x0f;
+    }
+  else if (lead >= 0xf0 && lead <= 0xf4)
+    {
+    length = 4;
+    minimum = 0x10000;
+    code_point = lead & 0x07;
+    }
+  else
+    {
+    return 0;
+    }
+
+  if (i + length > value.size())
+    {
+    return 0;
+    }
+  for (std::size_t j = 1; j < length; ++j)
+    {
+    unsigned char next = static_cast<unsigned char>(value[i + j]);
+    if ((next & 0xc0) != 0x80)
+      {
+      return 0;
+      }
+    code_point = (code_point << 6) | (next & 0x3f);
+    }
+  if (code_point < minimum || code_point > 0x10ffff
+      || (code_point >= 0xd800 && code_point <= 0xdfff))
+    {
+    return 0;
+    }
+  return length;
+}
+
+/** Append a string with JSON quoting and escapes
+ *
+ * The output is pure ASCII, as with Python's json.dumps() and its
+ * default ensure_ascii=True: every character outside ' ' to '~' is
+ * written as \uXXXX, and characters beyond the Basic Multilingual
+ * Plane as a surrogate pair.  A byte that is not part of valid UTF-8
+ * is escaped as the Latin-1 character with the same value.
+ */
+inline void append_json_string(std::string& out, std::string const& value)
+{
+  out.push_back('"');
+  std::size_t run_start = 0;
+  std::size_t i = 0;
+  while (i < value.size())
+    {
+    unsigned char c = static_cast<unsigned char>(value[i]);
+    if (c >= 0x20 && c < 0x7f && c != '"' && c != '\\')
+      {
+      ++i;
+      continue;
+      }
+    out.append(value, run_start, i - run_start);
+    switch (c)
+      {
+      case '"': out.append("\\\""); break;
+      case '\\': out.append("\\\\"); break;
+      case '\b': out.append("\\b"); break;
+      case '\f': out.append("\\f"); break;
+      case '\n': out.append("\\n"); break;
+      case '\r': out.append("\\r"); break;
+      case '\t': out.append("\\t"); break;
+      default:
+        if (c >= 0x80)
+          {
+          std::uint32_t code_point = 0;
+          std::size_t length = decode_utf8(value, i, code_point);
+          if (length == 0)
+            {
+            append_json_unicode_escape(out, c);
+            }
+          else if (code_point >= 0x10000)
+            {
+            code_point -= 0x10000;
+            append_json_unicode_escape(out, 0xd800 | (code_point >> 10));
+            append_json_unicode_escape(out, 0xdc00 | (code_point & 0x3ff));
+            i += length - 1;
+            }
+          else
+            {
+            append_json_unicode_escape(out, code_point);
+            i += length - 1;
+            }
+          }
+        else
+          {
+          append_json_unicode_escape(out, c);
+          }
+        break;
+      }
+    ++i;
+    run_start = i;
+    }
+  out.append(value, run_start, std::string::npos);
+  out.push_back('"');
+}
+
+/** Append a double the way Python's json module writes floats
+ *
+ * That is float.__repr__(): the shortest digits that read back as the
+ * same value, in positional notation when the decimal exponent is from
+ * -4 to 15 and in scientific notation otherwise.  Whole numbers get a
+ * trailing ".0".  Non-finite values are written as NaN, Infinity and
+ * -Infinity.
+ */
+inline void append_json_number(std::string& out, double value)
+{
+  if (std::isnan(value))
+    {
+    out.append("NaN");
+    return;
+    }
+  if (std::isinf(value))
+    {
+    out.append(value < 0 ? "-Infinity" : "Infinity");
+    return;
+    }
+
+  // Shortest of 15, 16 or 17 significant digits that round-trips.
+  // For normal numbers, trimming trailing zeros off a 15-digit result
+  // gives the shortest digits outright.  Subnormal numbers carry less
+  // precision, so for those we have to start from one digit.
+  char buffer[40];
+  int shortest = (std::fabs(value) < std::numeric_limits<double>::min() ? 1 : 15);
+  for (int precision = shortest; precision <= 17; ++precision)
+    {
+    std::snprintf(buffer, sizeof(buffer), "%.*e", precision - 1, value);
+    if (precision == 17 || std::strtod(buffer, nullptr) == value)
+      {
+      break;
+      }
+    }
+
+  // Pull the digits and exponent back out.  Anything between the
+  // first digit and the rest is the locale's decimal point.
+  char const* cursor = buffer;
+  bool negative = (*cursor == '-');
+  if (negative)
+    {
+    ++cursor;
+    }
+  char digits[20];
+  std::size_t num_digits = 0;
+  for (; *cursor != 'e' && *cursor != 'E'; ++cursor)
+    {
+    if (*cursor >= '0' && *cursor <= '9')
+      {
+      digits[num_digits++] = *cursor;
+      }
+    }
+  int exponent = std::atoi(cursor + 1);
+  while (num_digits > 1 && digits[num_digits - 1] == '0')
+    {
+    --num_digits;
+    }
+
+  if (negative)
+    {
+    out.push_back('-');
+    }
+  if (exponent < -4 || exponent >= 16)
+    {
+    out.push_back(digits[0]);
+    if (num_digits > 1)
+      {
+      out.push_back('.');
+      out.append(digits + 1, num_digits - 1);
+      }
+    int length = std::snprintf(buffer, sizeof(buffer), "e%c%02d", (exponent < 0 ? '-' : '+'), std::abs(exponent));
+    out.append(buffer, static_cast<std::size_t>(length));
+    }
+  else if (exponent < 0)
+    {
+    out.append("0.");
+    out.append(static_cast<std::size_t>(-exponent - 1), '0');
+    out.append(digits, num_digits);
+    }
+  else
+    {
+    std::size_t integer_digits = static_cast<std::size_t>(exponent) + 1;
+    if (num_digits <= integer_digits)
+      {
+      out.append(digits, num_digits);
+      out.append(integer_digits - num_digits, '0');
+      out.append(".0");
+      }
+    else
+      {
+      out.append(digits, integer_digits);
+      out.push_back('.');
+      out.append(digits + integer_digits, num_digits - integer_digits);
+      }
+    }
+}
+
+inline void append_two_digits(std::string& out, int value)
+{
+  out.push_back(static_cast<char>('0' + value / 10));
+  out.push_back(static_cast<char>('0' + value % 10));
+}
+
+/** Append a timestamp as "YYYY-MM-DD HH:MM:SS" in quotes
+ *
+ * This is the format Tracktable's Python dictionary conversion uses.
+ * Fractional seconds are dropped, as they are there.
+ */
+inline void append_json_timestamp(std::string& out, Timestamp const& when)
+{
+  if (when.is_special())
+    {
+    append_json_string(out, boost::posix_time::to_simple_string(when));
+    return;
+    }
+
+  boost::gregorian::date::ymd_type ymd = when.date().year_month_day();
+  boost::posix_time::time_duration time_of_day = when.time_of_day();
+  int year = static_cast<int>(ymd.year);
+
+  out.push_back('"');
+  append_two_digits(out, year / 100);
+  append_two_digits(out, year % 100);
+  out.push_back('-');
+  append_two_digits(out, static_cast<int>(ymd.month));
+  out.push_back('-');
+  append_two_digits(out, static_cast<int>(ymd.day));
+  out.push_back(' ');
+  append_two_digits(out, static_cast<int>(time_of_day.hours()));
+  out.push_back(':');
+  append_two_digits(out, static_cast<int>(time_of_day.minutes()));
+  out.push_back(':');
+  append_two_digits(out, static_cast<int>(time_of_day.seconds()));
+  out.push_back('"');
+}
+
+inline int two_digits_at(char const* s, std::size_t offset)
+{
+  return 10 * (s[offset] - '0') + (s[offset + 1] - '0');
+}
+
+/** Parse "YYYY-MM-DD HH:MM:SS" with optional fractional seconds
+ *
+ * A 'T' between the date and the time is also accepted.  Anything
+ * else goes to tracktable::time_from_string().
+ */
+inline Timestamp parse_json_timestamp(std::string const& text)
+{
+  char const* s = text.c_str();
+  std::size_t length = text.size();
+  bool fixed_format = (length >= 19
+                       && s[4] == '-' && s[7] == '-'
+                       && (s[10] == ' ' || s[10] == 'T')
+                       && s[13] == ':' && s[16] == ':');
+  static const int digit_positions[] = { 0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18 };
+  for (std::size_t i = 0; fixed_format && i < sizeof(digit_positions) / sizeof(int); ++i)
+    {
+    fixed_format = (s[digit_positions[i]] >= '0' && s[digit_positions[i]] <= '9');
+    }
+
+  long microseconds = 0;
+  if (fixed_format && length > 19)
+    {
+    fixed_format = (s[19] == '.' && length > 20 && length <= 26);
+    long scale = 100000;
+    for (std::size_t i = 20; fixed_format && i < length; ++i, scale /= 10)
+      {
+      fixed_format = (s[i] >= '0' && s[i] <= '9');
+      microseconds += scale * (s[i] - '0');
+      }
+    }
+
+  if (!fixed_format)
+    {
+    return time_from_string(text);
+    }
+
+  int year = 100 * two_digits_at(s, 0) + two_digits_at(s, 2);
+  int month = two_digits_at(s, 5);
+  int day = two_digits_at(s, 8);
+  int hour = two_digits_at(s, 11);
+  int minute = two_digits_at(s, 14);
+  int second = two_digits_at(s, 17);
+
+  try
+    {
+    return Timestamp(boost::gregorian::date(static_cast<unsigned short>(year),
+                                            static_cast<unsigned short>(month),
+                                            static_cast<unsigned short>(day)),
+                     boost::posix_time::time_duration(hour, minute, second)
+                     + boost::posix_time::microseconds(microseconds));
+    }
+  catch (std::out_of_range&)
+    {
+    throw ParseError("Invalid timestamp in JSON: " + text);
+    }
+}
+
+} } } // namespace tracktable::rw::detail
+
+#endif
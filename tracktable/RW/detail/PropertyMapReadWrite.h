@@ -101,13 +101,15 @@ struct write_property_map_values<true>
 			   out_iter_t where_to_write,
                std::size_t num_properties_expected)
     {
-      for (PropertyMap::const_iterator property_iter = thing.__properties().begin();
-           property_iter != thing.__properties().end();
+      PropertyMap merged;
+      PropertyMap const& properties(thing.__all_properties(merged));
+      for (PropertyMap::const_iterator property_iter = properties.begin();
+           property_iter != properties.end();
            ++property_iter)
         {
 	  (*where_to_write++) = formatter.property_to_string((*property_iter).second);
         }
-      for (std::size_t i = thing.__properties().size();
+      for (std::size_t i = properties.size();
            i < num_properties_expected;
            ++i)
         {
@@ -227,8 +229,10 @@ struct write_property_info_to_header<true>
                            out_iter_name_type names,
                            out_iter_type_type types)
     {
-      for (PropertyMap::const_iterator iter = point.__properties().begin();
-           iter != point.__properties().end();
+      PropertyMap merged;
+      PropertyMap const& properties(point.__all_properties(merged));
+      for (PropertyMap::const_iterator iter = properties.begin();
+           iter != properties.end();
            ++iter)
         {
         (*names++) = (*iter).first;
@@ -108,6 +108,54 @@ struct set_properties<PointT, true>
 
 // ----------------------------------------------------------------------
 
+// Hand property columns to the point as the raw text from the input.
+// The point converts each one the first time it is read.  Null values
+// still become NullValue with the column's declared type.
+
+template<typename PointT, bool HasProperties>
+struct set_deferred_properties
+{
+  typedef PointT point_type;
+
+  // set_properties has already warned about points without properties
+  inline static void apply(
+    point_type& /*point*/,
+    string_vector_type const& /*tokens*/,
+    PropertyAssignmentMap const& /*field_map*/,
+    string_type const& /*null_value*/
+    )
+    { }
+};
+
+template<typename PointT>
+struct set_deferred_properties<PointT, true>
+{
+  typedef PointT point_type;
+
+  inline static void apply(point_type& point,
+                           string_vector_type const& tokens,
+                           PropertyAssignmentMap const& field_map,
+                           string_type const& null_value)
+    {
+      for (PropertyAssignmentMap::const_iterator iter = field_map.begin();
+           iter != field_map.end();
+           ++iter)
+        {
+        string_type const& raw_value(tokens.at((*iter).second.column));
+        if (raw_value == null_value)
+          {
+          point.set_property((*iter).first, PropertyValueT(NullValue((*iter).second.type)));
+          }
+        else
+          {
+          point.set_deferred_property((*iter).first, raw_value, (*iter).second.type);
+          }
+        }
+    }
+};
+
+// ----------------------------------------------------------------------
+
 template<typename PointT, bool HasProperties>
 struct set_object_id
 {
@@ -0,0 +1,859 @@
+/*
+ * Copyright (c) 2014-2023 National Technology and Engineering
+ * Solutions of Sandia, LLC. Under the terms of Contract DE-NA0003525
+ * with National Technology and Engineering Solutions of Sandia, LLC,
+ * the U.S. Government retains certain rights in this software.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Fast path for records written by TrajectoryWriter.  A record is one
+// line holding a trajectory header, a point header and every point.
+// The parser reads both headers once, builds a column plan from the
+// point header and then fills a presized trajectory in place.
+// Per-point features are computed once at the end instead of after
+// every point.
+
+#ifndef __tracktable_rw_TrajectoryRecordParser_h
+#define __tracktable_rw_TrajectoryRecordParser_h
+
+#include <tracktable/Core/TracktableCommon.h>
+#include <tracktable/Core/PointTraits.h>
+#include <tracktable/Core/PropertyConverter.h>
+#include <tracktable/Core/SharedString.h>
+#include <tracktable/Core/Timestamp.h>
+#include <tracktable/Core/TimestampConverter.h>
+#include <tracktable/Core/Logging.h>
+
+#include <tracktable/RW/ParseExceptions.h>
+#include <tracktable/RW/detail/HeaderStrings.h>
+#include <tracktable/RW/detail/PointHeader.h>
+#include <tracktable/RW/detail/TrajectoryHeader.h>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/tokenizer.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace tracktable { namespace rw { namespace detail {
+
+/** Parse one trajectory record per line of text
+ *
+ * Tokens are split on the field delimiters exactly as
+ * StringTokenizingReader does.  Lines that contain no escape or
+ * quote character skip the general tokenizer and are split with a
+ * table lookup.
+ *
+ * Numbers go through strtod() when the token contains nothing but
+ * digits, signs, a decimal point and exponents; anything else falls
+ * back to boost::lexical_cast.  Timestamps in the default format
+ * "%Y-%m-%d %H:%M:%S" are decoded by hand.  Other formats use the
+ * regular TimestampConverter.
+ *
+ * A parser keeps scratch buffers and stream-based converters, so
+ * each thread needs its own copy.
+ */
+template<typename TrajectoryT>
+class TrajectoryRecordParser
+{
+public:
+  typedef TrajectoryT trajectory_type;
+  typedef typename trajectory_type::point_type point_type;
+
+  /// Instantiate a parser with the default configuration
+  TrajectoryRecordParser()
+    : FieldDelimiter(",")
+    , EscapeCharacter("\\")
+    , QuoteCharacter("\"")
+    , RestrictProperties(false)
+    , LazyProperties(false)
+    , HoistConstantProperties(false)
+    , WarningsEnabled(true)
+    {
+      this->set_null_value("");
+      this->set_timestamp_format(default_timestamp_input_format());
+      this->update_character_classes();
+    }
+
+  /** Copy contructor, create a parser with a copy of another
+   *
+   * Only the configuration is copied.
+   *
+   * @param [in] other TrajectoryRecordParser to copy from
+   */
+  TrajectoryRecordParser(TrajectoryRecordParser const& other)
+    : FieldDelimiter(other.FieldDelimiter)
+    , EscapeCharacter(other.EscapeCharacter)
+    , QuoteCharacter(other.QuoteCharacter)
+    , NullToken(other.NullToken)
+    , TimestampFormat(other.TimestampFormat)
+    , RequiredProperties(other.RequiredProperties)
+    , RestrictProperties(other.RestrictProperties)
+    , LazyProperties(other.LazyProperties)
+    , HoistConstantProperties(other.HoistConstantProperties)
+    , WarningsEnabled(other.WarningsEnabled)
+    , HeaderParser(other.HeaderParser)
+    , PropertyReadWrite(other.PropertyReadWrite)
+    {
+      this->update_character_classes();
+    }
+
+  /// Destructor
+  virtual ~TrajectoryRecordParser()
+    {
+    }
+
+  /** Assign a TrajectoryRecordParser to the value of another.
+   *
+   * @param [in] other TrajectoryRecordParser to assign value of
+   * @return Parser with the new assigned value
+   */
+  TrajectoryRecordParser& operator=(TrajectoryRecordParser const& other)
+    {
+      this->FieldDelimiter     = other.FieldDelimiter;
+      this->EscapeCharacter    = other.EscapeCharacter;
+      this->QuoteCharacter     = other.QuoteCharacter;
+      this->NullToken          = other.NullToken;
+      this->TimestampFormat    = other.TimestampFormat;
+      this->RequiredProperties = other.RequiredProperties;
+      this->RestrictProperties = other.RestrictProperties;
+      this->LazyProperties     = other.LazyProperties;
+      this->HoistConstantProperties = other.HoistConstantProperties;
+      this->WarningsEnabled    = other.WarningsEnabled;
+      this->HeaderParser       = other.HeaderParser;
+      this->PropertyReadWrite  = other.PropertyReadWrite;
+      this->update_character_classes();
+      return *this;
+    }
+
+  /** Check whether two parsers have the same configuration.
+   *
+   * @param [in] other TrajectoryRecordParser for comparison
+   * @return Boolean indicating equivalency
+   */
+  bool operator==(TrajectoryRecordParser const& other) const
+    {
+      return (
+        this->FieldDelimiter        == other.FieldDelimiter
+        && this->EscapeCharacter    == other.EscapeCharacter
+        && this->QuoteCharacter     == other.QuoteCharacter
+        && this->NullToken          == other.NullToken
+        && this->TimestampFormat    == other.TimestampFormat
+        && this->RequiredProperties == other.RequiredProperties
+        && this->RestrictProperties == other.RestrictProperties
+        && this->LazyProperties     == other.LazyProperties
+        && this->HoistConstantProperties == other.HoistConstantProperties
+        && this->WarningsEnabled    == other.WarningsEnabled
+        );
+    }
+
+  /** Check whether two parsers are unequal.
+   *
+   * @param [in] other TrajectoryRecordParser for comparison
+   * @return Boolean indicating equivalency
+   */
+  bool operator!=(TrajectoryRecordParser const& other) const
+    {
+      return !(*this == other);
+    }
+
+  /** Set one or more characters as field delimiters.
+   *
+   * @param [in] delimiters String containing all desired delimiter characters
+   */
+  void set_field_delimiter(string_type const& delimiters)
+    {
+      this->FieldDelimiter = delimiters;
+      this->update_character_classes();
+    }
+
+  /** Retrieve the current set of delimiter characters.
+   *
+   * @return String containing all delimiters
+   */
+  string_type field_delimiter() const
+    {
+      return this->FieldDelimiter;
+    }
+
+  /** Set the escape character (0 or 1 characters)
+   *
+   * @param [in] escape Escape character to be set
+   */
+  void set_escape_character(string_type const& escape)
+    {
+      this->EscapeCharacter = escape;
+      this->update_character_classes();
+    }
+
+  /** @return The escape character currently in use.
+   */
+  string_type escape_character() const
+    {
+      return this->EscapeCharacter;
+    }
+
+  /** Set the quote character (0 or 1 characters)
+   *
+   * @param [in] quote Quote character to be set
+   */
+  void set_quote_character(string_type const& quote)
+    {
+      this->QuoteCharacter = quote;
+      this->update_character_classes();
+    }
+
+  /** @return The quote character currently in use.
+   */
+  string_type quote_character() const
+    {
+      return this->QuoteCharacter;
+    }
+
+  /** Specify string value to be interpreted as null
+   *
+   * @param [in] value String to interpret as null
+   */
+  void set_null_value(string_type const& value)
+    {
+      this->HeaderParser.set_null_value(value);
+      this->PropertyReadWrite.set_null_value(value);
+      this->NullToken = value;
+    }
+
+  /** Get string value for nulls
+   *
+   * @return Current string that will be interpreted as null
+   */
+  string_type null_value() const
+    {
+      return this->NullToken;
+    }
+
+  /** Set the format of point timestamps and timestamp properties
+   *
+   * @param [in] format Input format for timestamps
+   */
+  void set_timestamp_format(string_type const& format)
+    {
+      this->TimestampFormat = format;
+      this->HeaderParser.set_timestamp_input_format(format);
+      this->PropertyReadWrite.set_timestamp_input_format(format);
+    }
+
+  /** Retrieve the format of the timestamp
+   *
+   * @return The timestamp format
+   */
+  string_type timestamp_format() const
+    {
+      return this->TimestampFormat;
+    }
+
+  /** Only populate the named point properties
+   *
+   * See PointFromTokensReader::set_required_properties().
+   *
+   * @param [in] names  Properties to read
+   */
+  void set_required_properties(std::vector<string_type> const& names)
+    {
+      this->RequiredProperties.clear();
+      this->RequiredProperties.insert(names.begin(), names.end());
+      this->RestrictProperties = true;
+    }
+
+  /** Add one property to the set that will be populated
+   *
+   * @param [in] name  Property to read
+   */
+  void add_required_property(string_type const& name)
+    {
+      this->RequiredProperties.insert(name);
+      this->RestrictProperties = true;
+    }
+
+  /// Go back to populating every point property
+  void clear_required_properties()
+    {
+      this->RequiredProperties.clear();
+      this->RestrictProperties = false;
+    }
+
+  /** Properties the parser is restricted to
+   *
+   * @return Required property names, or an empty list if every property is read
+   */
+  std::vector<string_type> required_properties() const
+    {
+      return std::vector<string_type>(this->RequiredProperties.begin(),
+                                      this->RequiredProperties.end());
+    }
+
+  /** Defer conversion of point properties until they are used
+   *
+   * See PointFromTokensReader::set_lazy_properties().
+   *
+   * @param [in] onoff  Lazy mode on / off
+   */
+  void set_lazy_properties(bool onoff)
+    {
+      this->LazyProperties = onoff;
+    }
+
+  /** Check whether property conversion is deferred
+   *
+   * @return Whether or not lazy mode is on
+   */
+  bool lazy_properties() const
+    {
+      return this->LazyProperties;
+    }
+
+  /** Share point properties that are the same on every point
+   *
+   * See Trajectory::hoist_constant_properties().
+   *
+   * @param [in] onoff  Hoisting on / off
+   */
+  void set_hoist_constant_properties(bool onoff)
+    {
+      this->HoistConstantProperties = onoff;
+    }
+
+  /** Check whether constant point properties are hoisted
+   *
+   * @return Whether or not hoisting is on
+   */
+  bool hoist_constant_properties() const
+    {
+      return this->HoistConstantProperties;
+    }
+
+  /** Enable/disable warnings during parsing.
+   *
+   * @param [in] onoff  Warnings are on / off
+   */
+  void set_warnings_enabled(bool onoff)
+    {
+      this->WarningsEnabled = onoff;
+    }
+
+  /** Check whether warnings are enabled
+   *
+   * @return Whether or not warnings are on
+   */
+  bool warnings_enabled() const
+    {
+      return this->WarningsEnabled;
+    }
+
+  /** Parse one line into a trajectory
+   *
+   * Lines that do not start with the trajectory magic string are
+   * ignored.  Records that cannot be parsed, or that contain no
+   * usable points, are logged and rejected.
+   *
+   * @param [in]  line        One line of text
+   * @param [out] trajectory  Trajectory to overwrite with the record
+   * @return Whether or not `trajectory` now holds a record
+   */
+  bool parse_record(string_type const& line, trajectory_type& trajectory)
+    {
+      try
+        {
+        this->tokenize(line);
+        if (this->Tokens.empty()
+            || this->Tokens[0] != TrajectoryFileMagicString)
+          {
+          return false;
+          }
+        if (!this->parse_tokens(trajectory))
+          {
+          return false;
+          }
+        if (this->HoistConstantProperties)
+          {
+          trajectory.hoist_constant_properties();
+          }
+        return true;
+        }
+      catch (std::exception& e)
+        {
+        TRACKTABLE_LOG(log::warning)
+          << "Error parsing trajectory: " << e.what();
+        return false;
+        }
+    }
+
+private:
+  struct PropertyColumn
+  {
+    std::size_t column;
+    string_type name;
+    PropertyUnderlyingType type;
+    bool deferred;
+  };
+
+  string_type FieldDelimiter;
+  string_type EscapeCharacter;
+  string_type QuoteCharacter;
+  string_type NullToken;
+  string_type TimestampFormat;
+  std::set<string_type> RequiredProperties;
+  bool RestrictProperties;
+  bool LazyProperties;
+  bool HoistConstantProperties;
+  bool WarningsEnabled;
+  TrajectoryHeader HeaderParser;
+  PropertyConverter PropertyReadWrite;
+
+  // Scratch space reused from one record to the next
+  bool IsDelimiter[256];
+  string_type SpecialCharacters;
+  string_vector_type Tokens;
+  std::vector<PropertyColumn> PropertyPlan;
+
+  // Repeated string values share storage.  Copies of the parser start
+  // with an empty pool so that each worker thread has its own.
+  StringPool Strings;
+
+  void update_character_classes()
+    {
+      std::fill(this->IsDelimiter, this->IsDelimiter + 256, false);
+      for (std::size_t i = 0; i < this->FieldDelimiter.size(); ++i)
+        {
+        this->IsDelimiter[static_cast<unsigned char>(this->FieldDelimiter[i])] = true;
+        }
+      this->SpecialCharacters = this->EscapeCharacter + this->QuoteCharacter;
+    }
+
+  // ----------------------------------------------------------------------
+
+  void tokenize(string_type const& line)
+    {
+      if (!this->SpecialCharacters.empty()
+          && line.find_first_of(this->SpecialCharacters) != string_type::npos)
+        {
+        typedef boost::escaped_list_separator<char> separator_type;
+        typedef boost::tokenizer<separator_type> tokenizer_type;
+        separator_type separator(this->EscapeCharacter,
+                                 this->FieldDelimiter,
+                                 this->QuoteCharacter);
+        tokenizer_type tokenizer(line, separator);
+        this->Tokens.assign(tokenizer.begin(), tokenizer.end());
+        return;
+        }
+
+      // Assign into existing strings so their buffers get reused
+      std::size_t num_tokens = 0;
+      std::size_t token_start = 0;
+      char const* text = line.data();
+      for (std::size_t i = 0; i <= line.size(); ++i)
+        {
+        if (i == line.size() || this->IsDelimiter[static_cast<unsigned char>(text[i])])
+          {
+          if (num_tokens == this->Tokens.size())
+            {
+            this->Tokens.push_back(string_type());
+            }
+          this->Tokens[num_tokens].assign(text + token_start, i - token_start);
+          ++num_tokens;
+          token_start = i + 1;
+          }
+        }
+      this->Tokens.resize(num_tokens);
+    }
+
+  // ----------------------------------------------------------------------
+
+  bool parse_tokens(trajectory_type& trajectory)
+    {
+      string_vector_type const& tokens(this->Tokens);
+
+      std::size_t header_size = this->HeaderParser.read_from_tokens(tokens.begin(), tokens.end());
+      std::size_t point_header_begin = header_size + 1;
+      if (point_header_begin + 6 > tokens.size())
+        {
+        throw ParseError("Trajectory record ends before its point header");
+        }
+
+      PointHeader point_header;
+      point_header.read_from_tokens(tokens.begin() + point_header_begin, tokens.end());
+      std::size_t num_point_properties = point_header.PropertyNames.size();
+      std::size_t first_point_token = point_header_begin + 6 + 2 * num_point_properties;
+      if (first_point_token > tokens.size())
+        {
+        throw ParseError("Trajectory record ends inside its point header");
+        }
+
+      if (point_header.Dimension != std::size_t(traits::dimension<point_type>::value)
+          && this->WarningsEnabled)
+        {
+        TRACKTABLE_LOG(log::warning)
+          << "TrajectoryRecordParser: Header indicates points with dimension "
+          << point_header.Dimension << " but reader's point type has dimension "
+          << traits::dimension<point_type>::value << ".";
+        }
+
+      std::size_t tokens_per_point = point_header.Dimension
+        + static_cast<std::size_t>(point_header.HasObjectId)
+        + static_cast<std::size_t>(point_header.HasTimestamp)
+        + num_point_properties;
+      std::size_t num_point_tokens = tokens.size() - first_point_token;
+      if (tokens_per_point == 0 || num_point_tokens % tokens_per_point != 0)
+        {
+        TRACKTABLE_LOG(log::warning)
+          << "Trajectory reader fell off the end of tokens for points. "
+          << "There is probably a missing property value in one of the point records.\n";
+        return false;
+        }
+
+      this->plan_property_columns(point_header);
+
+      std::size_t num_records = num_point_tokens / tokens_per_point;
+      std::size_t coordinate_column = static_cast<std::size_t>(point_header.HasObjectId)
+        + static_cast<std::size_t>(point_header.HasTimestamp);
+      std::size_t num_coordinates = std::min(point_header.Dimension,
+                                             std::size_t(traits::dimension<point_type>::value));
+
+      trajectory.clear();
+      trajectory.resize(num_records);
+
+      std::size_t num_points = 0;
+      for (std::size_t i = 0; i < num_records; ++i)
+        {
+        string_type* record = &(this->Tokens[first_point_token + i * tokens_per_point]);
+        for (std::size_t j = 0; j < tokens_per_point; ++j)
+          {
+          trim_in_place(record[j]);
+          }
+
+        point_type& point(trajectory[num_points]);
+        if (!this->populate_coordinates(record + coordinate_column, num_coordinates, point))
+          {
+          continue;
+          }
+        if (point_header.HasObjectId)
+          {
+          point.set_object_id(record[0]);
+          }
+        if (point_header.HasTimestamp)
+          {
+          this->populate_timestamp(record[point_header.HasObjectId ? 1 : 0], point);
+          }
+        this->populate_properties(record + coordinate_column + point_header.Dimension, point);
+        ++num_points;
+        }
+
+      trajectory.resize(num_points);
+      if (num_points == 0)
+        {
+        return false;
+        }
+      if (num_points != this->HeaderParser.NumPoints)
+        {
+        TRACKTABLE_LOG(log::error)
+          << "Trajectory reader tried to populate a new trajectory from tokens but got "
+          << num_points
+          << " points. We were expecting "
+          << this->HeaderParser.NumPoints << ".\n";
+        }
+
+      trajectory.set_uuid(this->HeaderParser.UUID);
+      trajectory.__set_properties(this->HeaderParser.Properties);
+      trajectory.compute_current_features(0);
+      return true;
+    }
+
+  // ----------------------------------------------------------------------
+
+  // Same selection rules as PointFromTokensReader::plan_property_columns().
+  // The plan is sorted by name so that properties can be appended to
+  // each point's map without searching it.
+  void plan_property_columns(PointHeader const& header)
+    {
+      bool defer_timestamps = (this->TimestampFormat == default_timestamp_input_format());
+
+      std::map<string_type, std::size_t> columns_by_name;
+      for (std::size_t i = 0; i < header.PropertyNames.size(); ++i)
+        {
+        columns_by_name[header.PropertyNames[i]] = i;
+        }
+
+      this->PropertyPlan.clear();
+      for (std::map<string_type, std::size_t>::const_iterator iter = columns_by_name.begin();
+           iter != columns_by_name.end();
+           ++iter)
+        {
+        if (this->RestrictProperties
+            && this->RequiredProperties.find((*iter).first) == this->RequiredProperties.end())
+          {
+          continue;
+          }
+
+        PropertyColumn column;
+        column.column = (*iter).second;
+        column.name = (*iter).first;
+        column.type = header.PropertyTypes[(*iter).second];
+        column.deferred = (this->LazyProperties
+                           && (column.type == TYPE_REAL
+                               || (column.type == TYPE_TIMESTAMP && defer_timestamps)));
+        this->PropertyPlan.push_back(column);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  bool populate_coordinates(string_type const* tokens,
+                            std::size_t num_coordinates,
+                            point_type& point)
+    {
+      for (std::size_t d = 0; d < num_coordinates; ++d)
+        {
+        double value = 0;
+        if (tokens[d].empty())
+          {
+          TRACKTABLE_LOG(log::debug) << EmptyCoordinateError(static_cast<int>(d)).what();
+          return false;
+          }
+        if (!parse_real(tokens[d], value))
+          {
+          TRACKTABLE_LOG(log::debug)
+            << "Cast error while parsing coordinate " << d
+            << " from '" << tokens[d] << "'";
+          return false;
+          }
+        point[d] = value;
+        }
+      return true;
+    }
+
+  // ----------------------------------------------------------------------
+
+  void populate_timestamp(string_type const& token, point_type& point)
+    {
+      try
+        {
+        point.set_timestamp(this->timestamp_from_string(token));
+        }
+      catch (std::exception& e)
+        {
+        TRACKTABLE_LOG(log::warning)
+          << "Error while setting timestamp: "
+          << e.what() << "\n"
+          << "Timestamp string was '"
+          << token
+          << "'.";
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  void populate_properties(string_type const* tokens, point_type& point)
+    {
+      PropertyMap& properties(point.__non_const_properties());
+      for (std::size_t i = 0; i < this->PropertyPlan.size(); ++i)
+        {
+        PropertyColumn const& column(this->PropertyPlan[i]);
+        string_type const& raw_value(tokens[column.column]);
+        if (column.deferred && raw_value != this->NullToken)
+          {
+          point.set_deferred_property(column.name, raw_value, column.type);
+          continue;
+          }
+        try
+          {
+          properties.emplace_hint(properties.end(),
+                                  column.name,
+                                  this->property_from_string(raw_value, column.type));
+          }
+        catch (std::exception& e)
+          {
+          TRACKTABLE_LOG(log::debug)
+            << "WARNING: Parse error while trying to set field '"
+            << column.name << "' from string '"
+            << raw_value << "': "
+            << e.what();
+          }
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  PropertyValueT property_from_string(string_type const& raw_value,
+                                      PropertyUnderlyingType type)
+    {
+      if (raw_value == this->NullToken)
+        {
+        return make_null(type);
+        }
+
+      switch (type)
+        {
+        case TYPE_STRING:
+          return PropertyValueT(this->Strings.intern(raw_value));
+        case TYPE_REAL:
+          {
+          double value = 0;
+          if (!parse_real(raw_value, value))
+            {
+            throw LexicalCastError("real property", raw_value, "double");
+            }
+          return PropertyValueT(value);
+          }
+        case TYPE_TIMESTAMP:
+          return PropertyValueT(this->timestamp_from_string(raw_value));
+        default:
+          return this->PropertyReadWrite.property_from_string(raw_value, type);
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  Timestamp timestamp_from_string(string_type const& text)
+    {
+      Timestamp result;
+      if (this->TimestampFormat == "%Y-%m-%d %H:%M:%S"
+          && parse_default_timestamp(text, result))
+        {
+        return result;
+        }
+      return this->PropertyReadWrite.timestamp_converter()->timestamp_from_string(text);
+    }
+
+  // ----------------------------------------------------------------------
+
+  static void trim_in_place(string_type& token)
+    {
+      if (token.empty()
+          || (!std::isspace(static_cast<unsigned char>(token.front()))
+              && !std::isspace(static_cast<unsigned char>(token.back()))))
+        {
+        return;
+        }
+      std::size_t first = 0;
+      std::size_t last = token.size();
+      while (first < last && std::isspace(static_cast<unsigned char>(token[first])))
+        {
+        ++first;
+        }
+      while (last > first && std::isspace(static_cast<unsigned char>(token[last - 1])))
+        {
+        --last;
+        }
+      token = token.substr(first, last - first);
+    }
+
+  // ----------------------------------------------------------------------
+
+  // strtod() is much faster than lexical_cast but also accepts hex
+  // and honors the C locale, so it only sees plain decimal tokens
+  // and has to consume all of them.
+  static bool parse_real(string_type const& token, double& value)
+    {
+      bool plain = !token.empty();
+      for (std::size_t i = 0; plain && i < token.size(); ++i)
+        {
+        char c = token[i];
+        plain = ((c >= '0' && c <= '9') || c == '.' || c == '-' || c == '+' || c == 'e' || c == 'E');
+        }
+      if (plain)
+        {
+        char* end = 0;
+        value = std::strtod(token.c_str(), &end);
+        if (end == token.c_str() + token.size())
+          {
+          return true;
+          }
+        }
+      try
+        {
+        value = boost::lexical_cast<double>(token);
+        return true;
+        }
+      catch (boost::bad_lexical_cast&)
+        {
+        return false;
+        }
+    }
+
+  // ----------------------------------------------------------------------
+
+  // Decode exactly "YYYY-mm-dd HH:MM:SS".  Returns false for anything
+  // else, including out-of-range fields, so the caller can hand the
+  // text to the regular converter and get its usual behavior.
+  static bool parse_default_timestamp(string_type const& text, Timestamp& result)
+    {
+      static const std::size_t digit_positions[] = { 0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18 };
+      char const* s = text.c_str();
+      if (text.size() != 19
+          || s[4] != '-' || s[7] != '-' || s[10] != ' ' || s[13] != ':' || s[16] != ':')
+        {
+        return false;
+        }
+      for (std::size_t i = 0; i < sizeof(digit_positions) / sizeof(std::size_t); ++i)
+        {
+        if (s[digit_positions[i]] < '0' || s[digit_positions[i]] > '9')
+          {
+          return false;
+          }
+        }
+
+      int year = 1000 * (s[0] - '0') + 100 * (s[1] - '0') + 10 * (s[2] - '0') + (s[3] - '0');
+      int month = 10 * (s[5] - '0') + (s[6] - '0');
+      int day = 10 * (s[8] - '0') + (s[9] - '0');
+      int hour = 10 * (s[11] - '0') + (s[12] - '0');
+      int minute = 10 * (s[14] - '0') + (s[15] - '0');
+      int second = 10 * (s[17] - '0') + (s[18] - '0');
+      if (hour > 23 || minute > 59 || second > 59)
+        {
+        return false;
+        }
+
+      try
+        {
+        result = Timestamp(boost::gregorian::date(static_cast<unsigned short>(year),
+                                                  static_cast<unsigned short>(month),
+                                                  static_cast<unsigned short>(day)),
+                           boost::posix_time::time_duration(hour, minute, second));
+        return true;
+        }
+      catch (std::out_of_range&)
+        {
+        return false;
+        }
+    }
+};
+
+} } } // namespace tracktable::rw::detail
+
+#endif